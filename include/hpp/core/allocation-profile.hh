@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_ALLOCATION_PROFILE_HH
+# define HPP_CORE_ALLOCATION_PROFILE_HH
+
+# include <cstddef>
+# include <iosfwd>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup path_planning
+    /// \{
+
+    /// Number of memory allocations and allocated bytes per subsystem
+    ///
+    /// Profiling is disabled by default. Once enabled, each allocation
+    /// passed to \ref record is counted in the subsystem of the innermost
+    /// scope marked by \ref HPP_CORE_ALLOCATION_SCOPE in the calling
+    /// thread, or in OTHER outside of any scope. The path planners, the
+    /// steering methods, the path validations, the configuration and path
+    /// projectors, the path optimizers run by ProblemSolver and the
+    /// insertions in roadmaps are marked.
+    ///
+    /// \ref record is the allocator hook. If hpp-core is built with the
+    /// CMake option HPP_CORE_PROFILE_ALLOCATIONS, the library replaces the
+    /// global operator new to call it. Otherwise, a program may call it
+    /// from its own operator new or allocator. Recording does not allocate
+    /// and does not lock.
+    ///
+    /// \note Eigen allocates the coefficients of dynamic size matrices with
+    ///       malloc: replacing operator new does not count them.
+    ///
+    /// The counters are shared by all the threads: they include the
+    /// allocations of other computations running meanwhile. See also
+    /// PlannerStatistics::allocations.
+    class HPP_CORE_DLLAPI AllocationProfile
+    {
+    public:
+      enum Subsystem {
+        /// Allocations outside of any scope
+        OTHER,
+        PLANNER,
+        STEERING,
+        VALIDATION,
+        PROJECTION,
+        OPTIMIZATION,
+        ROADMAP,
+        NUMBER_SUBSYSTEMS
+      };
+
+      struct Counters
+      {
+        size_type allocations;
+        size_type bytes;
+      }; // struct Counters
+
+      /// Counters of all the subsystems
+      struct Snapshot
+      {
+        Counters counters [NUMBER_SUBSYSTEMS];
+      }; // struct Snapshot
+
+      /// Count the enclosed allocations in a subsystem, if profiling is
+      /// enabled
+      class Scope
+      {
+      public:
+        explicit Scope (Subsystem subsystem) :
+          previous_ (enabled () ? enter (subsystem) : NUMBER_SUBSYSTEMS)
+        {
+        }
+        ~Scope ()
+        {
+          if (previous_ != NUMBER_SUBSYSTEMS) leave (previous_);
+        }
+      private:
+        Subsystem previous_;
+      }; // class Scope
+
+      /// Count an allocation, if profiling is enabled
+      /// \param bytes size of the allocated block.
+      static void record (std::size_t bytes)
+      {
+        if (enabled ()) count (bytes);
+      }
+
+      /// Enable profiling
+      static void enable ();
+      /// Disable profiling, the counters are kept
+      static void disable ();
+      static bool enabled ()
+      {
+        return enabled_;
+      }
+
+      /// Set the counters to zero
+      static void reset ();
+      /// Counters of a subsystem
+      static Counters counters (Subsystem subsystem);
+      /// Counters of all the subsystems
+      static Snapshot snapshot ();
+      /// Name of a subsystem
+      static const char* name (Subsystem subsystem);
+      /// Write the counters of the subsystems
+      static void print (std::ostream& os);
+
+    private:
+      /// Set the subsystem of the calling thread
+      /// \return the previous subsystem.
+      static Subsystem enter (Subsystem subsystem);
+      /// Restore the subsystem of the calling thread
+      static void leave (Subsystem previous);
+      static void count (std::size_t bytes);
+
+      static volatile bool enabled_;
+    }; // class AllocationProfile
+    /// \}
+  } // namespace core
+} // namespace hpp
+
+/// Count the allocations of the enclosing scope in a subsystem
+/// \sa hpp::core::AllocationProfile
+# define HPP_CORE_ALLOCATION_SCOPE(subsystem)                                  \
+  ::hpp::core::AllocationProfile::Scope hppCoreAllocationScope_               \
+  (::hpp::core::AllocationProfile::subsystem)
+
+#endif // HPP_CORE_ALLOCATION_PROFILE_HH
@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_ASYNC_SOLVE_HH
+# define HPP_CORE_ASYNC_SOLVE_HH
+
+# include <string>
+
+# include <boost/thread/condition_variable.hpp>
+# include <boost/thread/mutex.hpp>
+# include <boost/thread/thread.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+# include <hpp/core/path-planner.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup path_planning
+    /// \{
+
+    /// Run PathPlanner::solve in a background thread
+    ///
+    /// The handle records the progress of the resolution and the last
+    /// solution published by the planner, see
+    /// PathPlanner::progressCallback and PathPlanner::solutionCallback.
+    /// The callbacks set on the planner before the creation of the handle
+    /// are still called. The planner must not be used by another thread
+    /// until the resolution ends.
+    ///
+    /// The destructor interrupts the resolution and waits for its end.
+    class HPP_CORE_DLLAPI AsyncSolve
+    {
+    public:
+      /// Start the resolution
+      static AsyncSolvePtr_t create (const PathPlannerPtr_t& planner);
+
+      ~AsyncSolve ();
+
+      /// Whether the resolution ended
+      bool done () const;
+      /// Wait for the end of the resolution
+      void wait ();
+      /// Wait for the end of the resolution at most a given time
+      /// \param seconds maximal waiting time.
+      /// \return whether the resolution ended.
+      bool wait (value_type seconds);
+      /// Interrupt the resolution
+      void interrupt ();
+
+      /// Last state published by the planner
+      PathPlanner::Progress progress () const;
+      /// Last solution published by the planner or returned by
+      /// PathPlanner::solve
+      /// \return a null pointer if no solution was found yet.
+      PathVectorPtr_t latestSolution () const;
+      /// Wait for the end of the resolution and get its result
+      /// \throw std::runtime_error with the message of the exception
+      ///        thrown by PathPlanner::solve, if any.
+      PathVectorPtr_t result ();
+
+    protected:
+      AsyncSolve (const PathPlannerPtr_t& planner);
+
+    private:
+      void run ();
+      void storeProgress (const PathPlanner::Progress& progress);
+      void storeSolution (const PathVectorPtr_t& path);
+
+      PathPlannerPtr_t planner_;
+      /// Callbacks of the planner before the creation of the handle
+      PathPlanner::ProgressCallback_t progressCallback_;
+      PathPlanner::SolutionCallback_t solutionCallback_;
+
+      PathPlanner::Progress progress_;
+      PathVectorPtr_t solution_;
+      bool done_;
+      bool interrupted_;
+      /// Message of the exception thrown by PathPlanner::solve
+      std::string error_;
+      /// Protects the above members
+      mutable boost::mutex mutex_;
+      boost::condition_variable finished_;
+      boost::thread thread_;
+    }; // class AsyncSolve
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_ASYNC_SOLVE_HH
@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_BATCH_COLLISION_VALIDATION_HH
+# define HPP_CORE_BATCH_COLLISION_VALIDATION_HH
+
+# include <stdexcept>
+# include <vector>
+
+# include <hpp/core/collision-validation.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup validation
+    /// \{
+
+    /// Validate batches of configurations with respect to collision
+    ///
+    /// Configurations of a batch are distributed among threads, each
+    /// validating its configurations as
+    /// CollisionValidation::validateConfigurations does.
+    ///
+    /// Validation of single configurations is the same as
+    /// CollisionValidation.
+    /// \note the robot should have at least as many device data as
+    ///       threads, see pinocchio::Device::numberDeviceData.
+    class HPP_CORE_DLLAPI BatchCollisionValidation :
+      public CollisionValidation
+    {
+    public:
+      static BatchCollisionValidationPtr_t create (const DevicePtr_t& robot);
+
+      /// Compute whether several configurations are valid
+      /// \sa ConfigValidation::validateConfigurations
+      virtual bool validateConfigurations
+      (const matrix_t& configurations, std::vector <bool>& valid,
+       std::vector <ValidationReportPtr_t>& reports);
+
+      /// Set the number of threads
+      void numberThreads (size_type n)
+      {
+        if (n < 1)
+          throw std::invalid_argument ("number of threads should be positive.");
+        numberThreads_ = n;
+      }
+      /// Get the number of threads
+      size_type numberThreads () const
+      {
+        return numberThreads_;
+      }
+
+    protected:
+      BatchCollisionValidation (const DevicePtr_t& robot);
+
+    private:
+      size_type numberThreads_;
+    }; // class BatchCollisionValidation
+    /// \}
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_BATCH_COLLISION_VALIDATION_HH
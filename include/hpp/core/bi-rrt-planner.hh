@@ -29,6 +29,16 @@ namespace hpp {
     /// Implementation of directional bi-RRT algorithm
     /// maintaining only two connected components for
     /// respectively the start and goal configurations
+    ///
+    /// If parameter "BiRRTPlanner/extensionStepLength" is positive, the
+    /// extensions of the trees are truncated to a step length that adapts
+    /// online: it grows when the recent extensions are mostly valid and
+    /// shrinks when they are mostly in collision, see \ref stepLength.
+    ///
+    /// If parameter "BiRRTPlanner/greedyConnection" is true, a failing
+    /// connection between the trees keeps its valid part as a new node and
+    /// the connection goes on from that node, alternately from each tree,
+    /// instead of being discarded.
     class HPP_CORE_DLLAPI BiRRTPlanner : public PathPlanner
     {
     public:
@@ -37,10 +47,26 @@ namespace hpp {
 	(const Problem& problem, const RoadmapPtr_t& roadmap);
       /// Return shared pointer to new object.
       static BiRRTPlannerPtr_t create (const Problem& problem);
-      /// One step of extension.
+      /// Initialize the problem resolution
+      ///  \li call parent implementation
+      ///  \li set approximation factor of nearest neighbor searches from
+      ///      parameter "NearestNeighbor/approximationFactor",
+      ///  \li store connected components of init and goal configurations.
       virtual void startSolve();
       /// One step of extension.
       virtual void oneStep ();
+      /// Current length of the extensions
+      ///
+      /// Initialized by \ref startSolve from parameter
+      /// "BiRRTPlanner/extensionStepLength" and multiplied after each
+      /// extension by \f$ 0.5 + r \f$, where \f$ r \f$ is the moving
+      /// average of the ratio of valid length of the extensions. It stays
+      /// within a factor 16 of its initial value. Non-positive if the
+      /// extensions are not truncated.
+      value_type stepLength () const
+      {
+        return stepLength_;
+      }
     protected:
       /// Constructor
       BiRRTPlanner (const Problem& problem, const RoadmapPtr_t& roadmap);
@@ -55,7 +81,23 @@ namespace hpp {
       ConnectedComponentPtr_t startComponent_;
       std::vector<ConnectedComponentPtr_t> endComponents_;
     private:
+      /// Truncate a path to the step length
+      /// \param reverse whether the end of the path, instead of its
+      ///        beginning, is kept.
+      /// \retval reached whether the path was not truncated.
+      PathPtr_t truncate (const PathPtr_t& path, bool reverse,
+                          bool& reached) const;
+      /// Update the step length from the valid part of an extension
+      void adaptStepLength (const PathPtr_t& path, const PathPtr_t& validPart);
+      /// Connect a node of the start component to a node of an end component
+      /// \return whether the nodes are connected.
+      bool connect (NodePtr_t fromStart, NodePtr_t toEnd);
+
       mutable Configuration_t qProj_;
+      value_type stepLength_, minStepLength_, maxStepLength_;
+      /// Moving average of the ratio of valid length of the extensions
+      value_type validityRatio_;
+      bool greedyConnection_;
       BiRRTPlannerWkPtr_t weakPtr_;
     };
     /// \}
@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_BINARY_PATH_HH
+# define HPP_CORE_BINARY_PATH_HH
+
+# include <cstddef>
+# include <string>
+
+# include <boost/cstdint.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup path
+    /// \{
+
+    /// Compact binary format of path vectors
+    ///
+    /// A buffer stores, in native byte order and aligned on 8 bytes, a
+    /// header, a table of segments and the coefficients of all the segments
+    /// in one array. Each segment of the table has a type, a parameter
+    /// range and the position of its coefficients in the array:
+    /// \li StraightPath: the initial and end configurations,
+    /// \li path::Spline in Bernstein basis: the base configuration and the
+    ///     parameters, as given by path::Spline::rowParameters,
+    /// \li other paths: a sequence of waypoints, the times followed by the
+    ///     configurations, interpolated by straight paths when read.
+    ///
+    /// Unlike Boost serialization, neither the constraints nor the robot
+    /// are stored. Elements with constraints or a time parameterization are
+    /// thus written as waypoints, sampled in time.
+    class HPP_CORE_DLLAPI BinaryPath
+    {
+    public:
+      /// Version of the format
+      static const boost::uint32_t formatVersion = 1;
+
+      /// Type of the segments
+      enum SegmentType {
+        STRAIGHT = 1,
+        BERNSTEIN_SPLINE = 2,
+        WAYPOINTS = 3
+      }; // enum SegmentType
+
+      /// Write a path vector in a buffer
+      /// \param path the path, flattened,
+      /// \param step maximal time step between waypoints, for the elements
+      ///        that are written as waypoints,
+      /// \retval buffer the content is replaced.
+      /// \throw std::invalid_argument if step is not positive.
+      static void write (const PathVectorPtr_t& path, value_type step,
+                         std::string& buffer);
+
+      /// Read a buffer written by \ref write
+      /// \param data beginning of the buffer, aligned on 8 bytes,
+      /// \param size size of the buffer in bytes,
+      /// \param robot the robot the path belongs to.
+      /// \return a path vector with one element per segment, except for
+      ///         waypoints segments that give one straight path between
+      ///         each pair of successive waypoints. Straight paths are
+      ///         defined on the configuration space of the robot.
+      /// \throw std::runtime_error if the buffer is not a path of the
+      ///        current version or does not match the configuration size
+      ///        of the robot.
+      static PathVectorPtr_t read (const char* data, std::size_t size,
+                                   const DevicePtr_t& robot);
+    }; // class BinaryPath
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_BINARY_PATH_HH
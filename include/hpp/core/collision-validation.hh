@@ -19,6 +19,9 @@
 #ifndef HPP_CORE_COLLISION_VALIDATION_HH
 # define HPP_CORE_COLLISION_VALIDATION_HH
 
+# include <stdexcept>
+# include <vector>
+
 # include <hpp/core/collision-validation-report.hh>
 # include <hpp/core/config-validation.hh>
 # include <hpp/core/obstacle-user.hh>
@@ -48,9 +51,23 @@ namespace hpp {
       virtual bool validate (const Configuration_t& config,
 			     ValidationReportPtr_t& validationReport);
 
+      /// Compute whether several configurations are valid
+      ///
+      /// One device data is used for the whole batch. The configurations
+      /// are processed by blocks: the placements of the geometries of the
+      /// whole block are computed first, then the bounding spheres of each
+      /// collision pair are compared for all the configurations of the
+      /// block at once. Only the configurations for which the spheres of a
+      /// pair overlap are checked with the exact geometries.
+      /// \sa ConfigValidation::validateConfigurations
+      virtual bool validateConfigurations
+      (const matrix_t& configurations, std::vector <bool>& valid,
+       std::vector <ValidationReportPtr_t>& reports);
+
       void checkParameterized (bool active)
       {
         checkParameterized_ = active;
+        sceneChanged ();
       }
 
       void computeAllContacts (bool computeAllContacts)
@@ -63,13 +80,113 @@ namespace hpp {
         return checkParameterized_;
       }
 
+      bool computeAllContacts () const
+      {
+        return computeAllContacts_;
+      }
+
+      /// Set the number of threads scanning the pairs when all contacts
+      /// are computed
+      ///
+      /// The pairs are distributed among the threads. Contacts are reported
+      /// in the order of the pairs, active pairs first, whatever the number
+      /// of threads. By default, one thread is used.
+      void allContactsThreads (size_type n)
+      {
+        if (n < 1)
+          throw std::invalid_argument ("number of threads should be positive.");
+        allContactsThreads_ = n;
+      }
+
+      /// Get the number of threads scanning the pairs when all contacts
+      /// are computed
+      size_type allContactsThreads () const
+      {
+        return allContactsThreads_;
+      }
+
+      /// Set the cache of the collision free cells of the configuration
+      /// space
+      ///
+      /// Configurations in a cell of the cache are valid without collision
+      /// checking. The clearance of the other valid configurations is
+      /// computed and their cell stored in the cache. The cells are
+      /// relative to the key of the robot and of the collision pairs,
+      /// updated when obstacles, pairs or security margins are modified
+      /// through the methods of this class. Users modifying the pairs or
+      /// the requests directly should set the cache again.
+      /// \param cache if null, the cache is disabled, the default.
+      void occupancyCache (const OccupancyCachePtr_t& cache);
+
+      /// Get the cache of the collision free cells
+      const OccupancyCachePtr_t& occupancyCache () const
+      {
+        return occupancy_;
+      }
+
+      /// Hash of the kinematic chain, of the checked collision pairs, of
+      /// the placements of the obstacles and of the security margins
+      std::size_t sceneKey () const;
+
+      /// Lower bound of the distance between the objects of the checked
+      /// pairs, security margins deduced
+      /// \param data device data with updated geometry placements.
+      value_type clearance (const pinocchio::DeviceData& data) const;
+
+      /// \name ObstacleUser
+      /// Update the key of the scene of the occupancy cache.
+      /// \{
+      virtual void addObstacleToJoint (const CollisionObjectConstPtr_t& object,
+                                       const JointPtr_t& joint,
+                                       const bool includeChildren);
+      virtual void removeObstacleFromJoint
+      (const JointPtr_t& joint, const CollisionObjectConstPtr_t& object);
+      virtual void updateObstacle (const CollisionObjectConstPtr_t& object);
+      virtual void filterCollisionPairs
+      (const RelativeMotion::matrix_type& relMotion);
+      virtual void setSecurityMargins (const matrix_t& securityMatrix);
+      /// \}
+
     protected:
       CollisionValidation (const DevicePtr_t& robot);
+
+      /// Validate configurations begin, begin + step, ... of a batch
+      ///
+      /// \param configurations, valid, reports see validateConfigurations.
+      ///        valid and reports should already have the right size.
+      void validateRange (const matrix_t& configurations,
+                          std::vector <bool>& valid,
+                          std::vector <ValidationReportPtr_t>& reports,
+                          size_type begin, size_type step);
+
       DevicePtr_t robot_;
 
     private:
+      /// Validate the configurations of given indices, see validateRange
+      void validateBlock (const matrix_t& configurations,
+                          const std::vector <size_type>& block,
+                          std::vector <bool>& valid,
+                          std::vector <ValidationReportPtr_t>& reports);
+
+      /// Check collision pairs begin, begin + step, ...
+      ///
+      /// Active pairs come first, then parameterized pairs if they are
+      /// checked.
+      /// \retval reports report of each pair in collision, should already
+      ///         have the right size.
+      void scanPairs (const pinocchio::DeviceData& data,
+                      std::vector <CollisionValidationReportPtr_t>& reports,
+                      std::size_t begin, std::size_t step) const;
+
+      /// Compute the key of the scene if the occupancy cache is set
+      void sceneChanged ();
+
       bool checkParameterized_;
       bool computeAllContacts_;
+      size_type allContactsThreads_;
+      /// Null if disabled
+      OccupancyCachePtr_t occupancy_;
+      std::size_t scene_;
 
     }; // class ConfigValidation
     /// \}
@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_COMPACT_ROADMAP_HH
+# define HPP_CORE_COMPACT_ROADMAP_HH
+
+# include <vector>
+
+# include <boost/unordered_map.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup roadmap
+    /// \{
+
+    /// Frozen copy of the graph of a roadmap
+    ///
+    /// Nodes and edges are given integer ids. The out edges of the nodes
+    /// are stored in compressed sparse row format: the out edges of node
+    /// \c i have ids <c>edgeBegin (i)</c> to <c>edgeEnd (i) - 1</c>, and the
+    /// targets and costs of the edges are stored in contiguous arrays.
+    /// Edges that are not validated are not copied.
+    ///
+    /// The copy is not updated when the roadmap is modified. Nodes and
+    /// edges of the roadmap must not be deleted while the copy is used.
+    class HPP_CORE_DLLAPI CompactRoadmap
+    {
+    public:
+      /// Ids of edges along a path
+      typedef std::vector <size_type> EdgeIds_t;
+
+      /// Copy the graph of a roadmap
+      static CompactRoadmapPtr_t create (const RoadmapPtr_t& roadmap);
+
+      /// Number of nodes
+      size_type numberNodes () const
+      {
+        return (size_type) nodes_.size ();
+      }
+      /// Number of edges
+      size_type numberEdges () const
+      {
+        return (size_type) targets_.size ();
+      }
+      /// Id of a node
+      /// \return -1 if the node was not in the roadmap.
+      size_type id (const NodePtr_t& node) const;
+      /// Node of given id
+      NodePtr_t node (size_type id) const
+      {
+        return nodes_ [id];
+      }
+      /// Edge of given id
+      EdgePtr_t edge (size_type id) const
+      {
+        return edges_ [id];
+      }
+      /// Id of the first out edge of a node
+      size_type edgeBegin (size_type node) const
+      {
+        return offsets_ [node];
+      }
+      /// Id following the last out edge of a node
+      size_type edgeEnd (size_type node) const
+      {
+        return offsets_ [node + 1];
+      }
+      /// Id of the node an edge comes from
+      size_type source (size_type edge) const
+      {
+        return sources_ [edge];
+      }
+      /// Id of the node an edge goes to
+      size_type target (size_type edge) const
+      {
+        return targets_ [edge];
+      }
+      /// Cost of an edge, see Edge::cost
+      value_type cost (size_type edge) const
+      {
+        return costs_ [edge];
+      }
+      /// Id of the connected component of a node
+      size_type connectedComponent (size_type node) const
+      {
+        return components_ [node];
+      }
+      /// Whether a node can be reached from another one
+      bool canReach (size_type from, size_type to) const
+      {
+        return reachability_ [components_ [from] * numberComponents_ +
+                              components_ [to]];
+      }
+
+      /// Cost of the shortest paths from a node to all nodes
+      /// \param from id of the start node,
+      /// \retval costs cost to each node, infinity if the node cannot be
+      ///         reached,
+      /// \retval parents id of the last edge of the shortest path to each
+      ///         node, -1 for unreachable nodes and for the start node.
+      void shortestPaths (size_type from, std::vector <value_type>& costs,
+                          EdgeIds_t& parents) const;
+
+      /// Cost of the shortest paths from a set of nodes to all nodes
+      /// \param sources ids of the start nodes,
+      /// \param initialCosts cost of each start node,
+      /// \retval costs, parents see the single source version. Parents of
+      ///         start nodes reached at their initial cost are -1.
+      void shortestPaths (const std::vector <size_type>& sources,
+                          const std::vector <value_type>& initialCosts,
+                          std::vector <value_type>& costs,
+                          EdgeIds_t& parents) const;
+
+      /// Shortest path between two nodes
+      /// \param from, to ids of the start and end nodes,
+      /// \retval edges ids of the edges of the path.
+      /// \return false if there is no path between the nodes.
+      ///
+      /// The search stops as soon as the end node is reached.
+      bool shortestPath (size_type from, size_type to, EdgeIds_t& edges) const;
+
+      /// Concatenate the paths of a sequence of edges
+      /// \param edges ids of the edges, must not be empty.
+      PathVectorPtr_t pathVector (const EdgeIds_t& edges) const;
+
+    protected:
+      /// Constructor
+      CompactRoadmap (const RoadmapPtr_t& roadmap);
+
+    private:
+      /// Dijkstra search from a set of nodes
+      /// \param to id of the node where the search stops, -1 to explore
+      ///        all the reachable nodes.
+      void dijkstra (const std::vector <size_type>& sources,
+                     const std::vector <value_type>& initialCosts,
+                     size_type to,
+                     std::vector <value_type>& costs,
+                     EdgeIds_t& parents) const;
+
+      std::vector <NodePtr_t> nodes_;
+      boost::unordered_map <const Node*, size_type> ids_;
+      /// Id of the first out edge of each node, and number of edges
+      std::vector <size_type> offsets_;
+      std::vector <size_type> sources_;
+      std::vector <size_type> targets_;
+      std::vector <value_type> costs_;
+      std::vector <EdgePtr_t> edges_;
+      std::vector <size_type> components_;
+      size_type numberComponents_;
+      /// Whether component i can reach component j, stored at
+      /// i * numberComponents_ + j
+      std::vector <bool> reachability_;
+    }; // class CompactRoadmap
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_COMPACT_ROADMAP_HH
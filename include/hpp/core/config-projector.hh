@@ -206,6 +206,24 @@ namespace hpp {
       /// \retval normal uncompressed velocity vector.
       void uncompressVector (vectorIn_t small, vectorOut_t normal) const;
 
+      /// Compress Velocity vector into a workspace of the projector
+      ///
+      /// \param normal input velocity vector
+      /// \return the compressed vector, valid until the next call.
+      /// \note The workspace is allocated by the first call only. Each copy
+      ///       of the projector has its own workspace.
+      vectorIn_t compressVector (vectorIn_t normal) const;
+
+      /// Expand compressed velocity vector into a workspace of the projector
+      ///
+      /// \param small compressed velocity vector without output of explicit
+      ///              constraints
+      /// \return the uncompressed velocity vector, with zero output of
+      ///         explicit constraints, valid until the next call.
+      /// \note The workspace is allocated by the first call only. Each copy
+      ///       of the projector has its own workspace.
+      vectorIn_t uncompressVector (vectorIn_t small) const;
+
       /// Compress matrix
       ///
       /// \param normal input matrix
@@ -234,7 +252,10 @@ namespace hpp {
       /// Get errorimal number of threshold in config projector
       value_type errorThreshold () const;
 
-      value_type residualError() const;
+      /// Residual error of the last resolution of the solver
+      /// \note The residual is not updated if the configuration satisfied
+      ///       the constraint before the projection.
+      virtual value_type residualError() const;
 
       const value_type& sigma() const;
 
@@ -319,6 +340,80 @@ namespace hpp {
 
       static void defaultLineSearch (LineSearchType ls);
 
+      /// \name Early abort
+      /// \{
+
+      /// Abort the projection when the error decreases too slowly
+      ///
+      /// The projection fails as soon as, for a number of consecutive
+      /// iterations, the residual error after an iteration is more than
+      /// (1 - rate) times the error before. A stagnating step norm also
+      /// triggers it. The budget of iterations is thus not spent on
+      /// projections that diverge or converge to an infeasible point.
+      /// \param rate minimal rate of decrease of the error per iteration,
+      ///        in [0, 1). 0 disables the early abort (default).
+      /// \param iterations number of consecutive iterations.
+      /// \throw std::invalid_argument if the rate is not in [0, 1) or
+      ///        iterations is 0.
+      void earlyAbort (const value_type& rate, size_type iterations = 3);
+
+      /// Get the minimal rate of decrease of the error per iteration
+      const value_type& earlyAbortRate () const
+      {
+        return earlyAbortRate_;
+      }
+
+      /// Get the number of consecutive iterations of the early abort
+      size_type earlyAbortIterations () const
+      {
+        return earlyAbortIterations_;
+      }
+
+      /// Number of iterations of the last projection
+      /// \note Only counted when early abort is enabled.
+      size_type lastIterations () const
+      {
+        return lastIterations_;
+      }
+
+      /// \}
+
+      /// \name Warm start
+      /// \{
+
+      /// Set the radius of the warm start
+      ///
+      /// When the configuration to project is closer than the radius to the
+      /// last configuration successfully projected, with the same right hand
+      /// side, the solver starts from the last solution moved by the
+      /// difference between both configurations. Consecutive projections
+      /// along a path thus start close to the solution. If the warm start
+      /// fails, the configuration itself is projected.
+      /// \param radius norm of the difference between the configurations,
+      ///        0 disables the warm start (default).
+      void warmStartRadius (const value_type& radius);
+
+      /// Get the radius of the warm start
+      const value_type& warmStartRadius () const
+      {
+        return warmStartRadius_;
+      }
+
+      /// Number of projections that started from the last solution
+      size_type warmStarts () const
+      {
+        return warmStarts_;
+      }
+
+      /// Number of projections that started from the last solution and
+      /// succeeded
+      size_type warmStartSuccesses () const
+      {
+        return warmStartSuccesses_;
+      }
+
+      /// \}
+
     protected:
       /// Constructor
       /// \param robot robot the constraint applies to.
@@ -338,6 +433,9 @@ namespace hpp {
 	weak_ = self;
       }
       /// Numerically solve constraint
+      ///
+      /// If all the constraints are explicit, they are evaluated in order
+      /// and no jacobian is computed.
       virtual bool impl_compute (ConfigurationOut_t configuration);
 
     private:
@@ -350,11 +448,31 @@ namespace hpp {
 
       bool solverOneStep (ConfigurationOut_t config) const;
       int  solverSolve   (ConfigurationOut_t config) const;
+      /// Same as solverSolve, aborting when the error decreases too slowly
+      int  solverSolveWithEarlyAbort (ConfigurationOut_t config);
+      /// Project from the last solution if configuration is close enough
+      bool warmStart (ConfigurationOut_t configuration);
 
       ConfigProjectorWkPtr_t weak_;
       ::hpp::statistics::SuccessStatistics statistics_;
 
-      ConfigProjector() {}
+      value_type warmStartRadius_;
+      size_type warmStarts_, warmStartSuccesses_;
+      /// Last configuration successfully projected, its projection and the
+      /// right hand side of the projection
+      Configuration_t warmStartInput_, warmStartOutput_;
+      vector_t warmStartRhs_;
+
+      value_type earlyAbortRate_;
+      size_type earlyAbortIterations_, lastIterations_;
+
+      /// Workspaces of the projection and of the compression
+      mutable Configuration_t qWork_;
+      mutable vector_t dqWork_, compressed_, uncompressed_;
+
+      ConfigProjector() : warmStartRadius_ (0), warmStarts_ (0),
+        warmStartSuccesses_ (0), earlyAbortRate_ (0),
+        earlyAbortIterations_ (3), lastIterations_ (0) {}
       HPP_SERIALIZABLE();
     }; // class ConfigProjector
     /// \}
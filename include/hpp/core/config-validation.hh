@@ -19,6 +19,8 @@
 #ifndef HPP_CORE_CONFIG_VALIDATION_HH
 # define HPP_CORE_CONFIG_VALIDATION_HH
 
+# include <vector>
+
 # include <hpp/core/validation-report.hh>
 # include <hpp/core/relative-motion.hh>
 # include <hpp/core/deprecated.hh>
@@ -45,6 +47,42 @@ namespace hpp {
       virtual bool validate (const Configuration_t& config,
 			     ValidationReportPtr_t& validationReport) = 0;
 
+      /// Compute whether several configurations are valid
+      ///
+      /// \param configurations configurations to check, one per column,
+      /// \retval valid whether each configuration is valid,
+      /// \retval reports report of each configuration, allocated if the
+      ///         configuration is not valid.
+      /// \return whether all the configurations are valid.
+      ///
+      /// The default implementation validates the configurations one after
+      /// the other. Derived classes may process them faster in a batch.
+      virtual bool validateConfigurations
+      (const matrix_t& configurations, std::vector <bool>& valid,
+       std::vector <ValidationReportPtr_t>& reports)
+      {
+        valid.assign (configurations.cols (), false);
+        reports.assign (configurations.cols (), ValidationReportPtr_t ());
+        bool result (true);
+        for (size_type i = 0; i < configurations.cols (); ++i) {
+          valid [i] = validate (configurations.col (i), reports [i]);
+          result = result && valid [i];
+        }
+        return result;
+      }
+
+      /// Whether all the configurations of a path are known to be valid
+      ///
+      /// Path validations sampling configurations along a path skip the
+      /// configuration validations that certify the path. The default
+      /// implementation certifies no path.
+      /// \return true if every configuration of the path is valid, false if
+      ///         this is not known.
+      virtual bool certifies (const PathPtr_t&) const
+      {
+        return false;
+      }
+
       virtual ~ConfigValidation () {};
 
     protected:
@@ -24,6 +24,8 @@
 
 namespace hpp {
   namespace core {
+    class ValidationOrdering;
+
     /// \addtogroup validation
     /// \{
 
@@ -45,6 +47,20 @@ namespace hpp {
       /// \return whether the whole config is valid.
       virtual bool validate (const Configuration_t& config,
 			     ValidationReportPtr_t& validationReport);
+
+      /// Compute whether several configurations are valid
+      ///
+      /// Each configuration validation processes in a batch the
+      /// configurations that the previous ones found valid.
+      /// \sa ConfigValidation::validateConfigurations
+      virtual bool validateConfigurations
+      (const matrix_t& configurations, std::vector <bool>& valid,
+       std::vector <ValidationReportPtr_t>& reports);
+
+      /// Whether all the validations certify a path
+      /// \sa ConfigValidation::certifies
+      virtual bool certifies (const PathPtr_t& path) const;
+
       /// Add a configuration validation object
       void add (const ConfigValidationPtr_t& configValidation);
 
@@ -54,8 +70,112 @@ namespace hpp {
       // Clear the vector of config validations
       void clear ();
 
+      /// \name Cache of validation results
+      /// \{
+
+      /// Set the number of results stored by the cache
+      ///
+      /// Results of \ref validate are stored in a least recently used
+      /// cache, keyed by the configuration. When the cache is full, the
+      /// least recently used result is discarded. Value 0, the default,
+      /// disables the cache.
+      void cacheSize (size_type n);
+
+      /// Get the number of results stored by the cache
+      size_type cacheSize () const
+      {
+        return cacheSize_;
+      }
+
+      /// Set the resolution of the keys of the cache
+      ///
+      /// Configurations are rounded to a multiple of the resolution before
+      /// being looked up, so that configurations closer than the resolution
+      /// may share their result. Value 0, the default, looks up exact
+      /// configurations.
+      void cacheResolution (value_type resolution);
+
+      /// Get the resolution of the keys of the cache
+      value_type cacheResolution () const
+      {
+        return cacheResolution_;
+      }
+
+      /// Number of calls to \ref validate answered by the cache
+      size_type cacheHits () const
+      {
+        return cacheHits_;
+      }
+
+      /// Number of calls to \ref validate not answered by the cache
+      size_type cacheMisses () const
+      {
+        return cacheMisses_;
+      }
+
+      /// Discard the results stored in the cache
+      ///
+      /// The cache is cleared each time obstacles, collision pairs or
+      /// validations change. Users modifying a validation directly should
+      /// call this method.
+      void clearCache ();
+      /// \}
+
+      /// \name Adaptive ordering of the validations
+      /// \{
+
+      /// Enable or disable the adaptive ordering of the validations
+      ///
+      /// When enabled, the rejection rate and the average duration of each
+      /// validation are measured, and the validations are periodically
+      /// sorted by decreasing rejection rate per second, so that cheap
+      /// validations that often fail are evaluated first. The validity of
+      /// a configuration does not depend on the order, but the report of an
+      /// invalid configuration is the one of the first failing validation
+      /// in the current order. Measures are reset when validations are
+      /// added or cleared. Disabled by default.
+      void adaptiveOrdering (bool enable);
+
+      /// Whether validations are adaptively ordered
+      bool adaptiveOrdering () const
+      {
+        return (bool) ordering_;
+      }
+      /// \}
+
+      /// Add obstacle to each element and clear the cache
+      void addObstacle (const CollisionObjectConstPtr_t& object);
+
+      /// Remove obstacle from joint to each element and clear the cache
+      void removeObstacleFromJoint(const JointPtr_t& joint,
+          const CollisionObjectConstPtr_t& object);
+
+      /// Update obstacle in each element and clear the cache
+      void updateObstacle (const CollisionObjectConstPtr_t& object);
+
+      /// Filter collision pairs to each element and clear the cache
+      void filterCollisionPairs (const RelativeMotion::matrix_type& relMotion);
+
+      /// Set security margins to each element and clear the cache
+      void setSecurityMargins(const matrix_t& securityMatrix);
+
     protected:
       ConfigValidations ();
+
+    private:
+      struct Cache;
+
+      /// Apply the validations in the current order
+      bool evaluate (const Configuration_t& config,
+                     ValidationReportPtr_t& validationReport);
+
+      size_type cacheSize_;
+      value_type cacheResolution_;
+      size_type cacheHits_;
+      size_type cacheMisses_;
+      boost::shared_ptr <Cache> cache_;
+      /// Null when adaptive ordering is disabled
+      boost::shared_ptr <ValidationOrdering> ordering_;
     }; // class ConfigValidation
     /// \}
   } // namespace core
@@ -21,6 +21,7 @@
 
 # include <hpp/core/config.hh>
 # include <hpp/core/fwd.hh>
+# include <hpp/core/random-generator.hh>
 
 namespace hpp {
   namespace core {
@@ -50,9 +51,38 @@ namespace hpp {
       /// \ref impl_shoot so that both prototype of method shoot remain available.
       virtual void shoot (Configuration_t& q) const { impl_shoot(q); }
 
+      /// Shoot a block of random configurations
+      /// \param configurations matrix the columns of which are set to
+      ///        random configurations. Its number of columns is the number
+      ///        of configurations, its rows are resized if necessary.
+      ///
+      /// Shooting a block costs one virtual call and lets implementations
+      /// process the configurations together.
+      void shoot (matrix_t& configurations) const
+      {
+        impl_shoot (configurations);
+      }
+
+      /// Set the stream of random numbers the configurations are drawn from
+      ///
+      /// Shooters used in different threads must not share a stream, see
+      /// RandomGenerator::split.
+      void randomGenerator (const RandomGeneratorPtr_t& generator)
+      {
+        generator_ = generator;
+      }
+      /// Get the stream of random numbers
+      const RandomGeneratorPtr_t& randomGenerator () const
+      {
+        return generator_;
+      }
+
       virtual ~ConfigurationShooter () {};
     protected:
-      ConfigurationShooter ()
+      /// Constructor
+      ///
+      /// The stream of random numbers is seeded with 0.
+      ConfigurationShooter () : generator_ (RandomGenerator::create (0))
     {
     }
       /// Store weak pointer to itself
@@ -62,6 +92,22 @@ namespace hpp {
     }
 
       virtual void impl_shoot (Configuration_t& q) const = 0;
+
+      /// Shoot a block of random configurations
+      ///
+      /// The default implementation calls
+      /// impl_shoot (Configuration_t&) for each column.
+      virtual void impl_shoot (matrix_t& configurations) const
+      {
+        Configuration_t q;
+        for (size_type i = 0; i < configurations.cols (); ++i) {
+          impl_shoot (q);
+          if (i == 0) configurations.resize (q.size (), configurations.cols ());
+          configurations.col (i) = q;
+        }
+      }
+      /// Stream of random numbers
+      RandomGeneratorPtr_t generator_;
     private:
       ConfigurationShooterWkPtr_t weakPtr_;
     }; // class
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_CONFIGURATION_SHOOTER_BRIDGE_TEST_HH
+# define HPP_CORE_CONFIGURATION_SHOOTER_BRIDGE_TEST_HH
+
+# include <hpp/core/configuration-shooter.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      /// \addtogroup configuration_sampling
+      /// \{
+
+      /// Sample configurations in narrow passages with the bridge test
+      ///
+      /// A configuration \f$\mathbf{q}_1\f$ is drawn from another shooter
+      /// and a configuration \f$\mathbf{q}_2\f$ from a gaussian distribution
+      /// around it. If both are invalid and the middle of the straight
+      /// interpolation between them is valid, the middle is returned.
+      ///
+      /// Configurations are processed in blocks: the configurations of each
+      /// stage of the test are validated together with
+      /// ConfigValidations::validateConfigurations.
+      class HPP_CORE_DLLAPI BridgeTest : public ConfigurationShooter
+      {
+      public:
+        /// Create a shooter
+        /// \param robot the robot,
+        /// \param shooter the shooter the first configurations are drawn
+        ///        from,
+        /// \param configValidations the validation of the configurations.
+        static BridgeTestPtr_t create
+        (const DevicePtr_t& robot, const ConfigurationShooterPtr_t& shooter,
+         const ConfigValidationsPtr_t& configValidations);
+
+        /// Set the standard deviation of the second configuration
+        ///
+        /// It applies to each component of the velocity between the
+        /// configurations of the bridge.
+        void standardDeviation (value_type sigma)
+        {
+          sigma_ = sigma;
+        }
+        /// Get the standard deviation of the second configuration
+        value_type standardDeviation () const
+        {
+          return sigma_;
+        }
+        /// Set the maximal number of rounds of the test per shoot
+        ///
+        /// Each round tests as many bridges as configurations are still
+        /// missing. The configurations still missing after the last round
+        /// are drawn from the other shooter.
+        void maxAttempts (size_type n)
+        {
+          maxAttempts_ = n;
+        }
+
+      protected:
+        BridgeTest (const DevicePtr_t& robot,
+                    const ConfigurationShooterPtr_t& shooter,
+                    const ConfigValidationsPtr_t& configValidations);
+        void init (const BridgeTestPtr_t& self)
+        {
+          ConfigurationShooter::init (self);
+          weak_ = self;
+        }
+
+        virtual void impl_shoot (Configuration_t& q) const;
+        virtual void impl_shoot (matrix_t& configurations) const;
+
+      private:
+        /// Validate the columns of a matrix
+        void validate (const matrix_t& configurations,
+                       std::vector <bool>& valid) const;
+
+        DevicePtr_t robot_;
+        ConfigurationShooterPtr_t shooter_;
+        ConfigValidationsPtr_t configValidations_;
+        value_type sigma_;
+        size_type maxAttempts_;
+        BridgeTestWkPtr_t weak_;
+      }; // class BridgeTest
+      /// \}
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_CONFIGURATION_SHOOTER_BRIDGE_TEST_HH
@@ -92,7 +92,16 @@ namespace hpp {
           }
 
           virtual void impl_shoot (Configuration_t& q) const;
+          /// Shoot the configurations of a block
+          ///
+          /// The velocities of the block are drawn at once. When the
+          /// configuration space is a vector space, they are added to the
+          /// center at once as well.
+          virtual void impl_shoot (matrix_t& configurations) const;
         private:
+          /// Shoot a configuration around the center
+          void shootAround (vector_t& velocity, ConfigurationOut_t q) const;
+
           const DevicePtr_t& robot_;
           /// The mean value
           Configuration_t center_;
@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_CONFIGURATION_SHOOTER_GOAL_BIASED_HH
+# define HPP_CORE_CONFIGURATION_SHOOTER_GOAL_BIASED_HH
+
+# include <hpp/core/configuration-shooter.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      /// \addtogroup configuration_sampling
+      /// \{
+
+      /// Sample the goal configurations of a problem with some probability
+      ///
+      /// Each configuration is a goal configuration of the problem, chosen
+      /// uniformly, with probability \ref bias, and is drawn from another
+      /// shooter otherwise. Blocks of configurations are drawn from the
+      /// other shooter at once.
+      class HPP_CORE_DLLAPI GoalBiased : public ConfigurationShooter
+      {
+      public:
+        /// Create a shooter
+        /// \param shooter the shooter the configurations are drawn from,
+        /// \param problem the problem, the goal configurations of which are
+        ///        read at each shoot.
+        static GoalBiasedPtr_t create (const ConfigurationShooterPtr_t& shooter,
+                                       const Problem& problem);
+
+        /// Set the probability to return a goal configuration
+        void bias (value_type probability)
+        {
+          bias_ = probability;
+        }
+        /// Get the probability to return a goal configuration
+        value_type bias () const
+        {
+          return bias_;
+        }
+
+      protected:
+        GoalBiased (const ConfigurationShooterPtr_t& shooter,
+                    const Problem& problem);
+        void init (const GoalBiasedPtr_t& self)
+        {
+          ConfigurationShooter::init (self);
+          weak_ = self;
+        }
+
+        virtual void impl_shoot (Configuration_t& q) const;
+        virtual void impl_shoot (matrix_t& configurations) const;
+
+      private:
+        ConfigurationShooterPtr_t shooter_;
+        const Problem& problem_;
+        value_type bias_;
+        GoalBiasedWkPtr_t weak_;
+      }; // class GoalBiased
+      /// \}
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_CONFIGURATION_SHOOTER_GOAL_BIASED_HH
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_CONFIGURATION_SHOOTER_HALTON_HH
+# define HPP_CORE_CONFIGURATION_SHOOTER_HALTON_HH
+
+# include <vector>
+
+# include <hpp/core/configuration-shooter.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      /// \addtogroup configuration_sampling
+      /// \{
+
+      /// Sample configurations along the Halton sequence
+      ///
+      /// The \f$ k \f$-th configuration maps the \f$ k \f$-th point of the
+      /// Halton low discrepancy sequence of the unit cube with the
+      /// mappings of Uniform: bounded vector spaces are scaled to their
+      /// bounds, SO(2) to an angle and SO(3) to a unit quaternion with the
+      /// volume preserving mapping of Shoemake. The sequence is
+      /// deterministic and covers the configuration space more evenly than
+      /// pseudo-random samples, which lets roadmaps reach a given
+      /// connectivity with fewer nodes.
+      ///
+      /// As Uniform, translations must be bounded.
+      /// \note Points of the sequence are correlated in high dimension.
+      ///       For robots with many degrees of freedom, Uniform may be
+      ///       preferable.
+      class HPP_CORE_DLLAPI Halton : public ConfigurationShooter
+      {
+      public:
+        static HaltonPtr_t create (const DevicePtr_t& robot);
+
+        void sampleExtraDOF (bool sampleExtraDOF)
+        {
+          sampleExtraDOF_ = sampleExtraDOF;
+        }
+
+        /// Set the index in the sequence of the next configuration
+        ///
+        /// Index 0 maps the origin of the unit cube, the first
+        /// configuration has index 1 by default.
+        void index (size_type k)
+        {
+          index_ = k;
+        }
+        /// Get the index in the sequence of the next configuration
+        size_type index () const
+        {
+          return index_;
+        }
+
+      protected:
+        Halton (const DevicePtr_t& robot);
+        void init (const HaltonPtr_t& self)
+        {
+          ConfigurationShooter::init (self);
+          weak_ = self;
+        }
+
+        virtual void impl_shoot (Configuration_t& q) const;
+
+      private:
+        DevicePtr_t robot_;
+        bool sampleExtraDOF_;
+        /// Base of each dimension of the sequence
+        std::vector <size_type> primes_;
+        mutable size_type index_;
+        HaltonWkPtr_t weak_;
+      }; // class Halton
+      /// \}
+    } // namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_CONFIGURATION_SHOOTER_HALTON_HH
@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_CONFIGURATION_SHOOTER_INFORMED_HH
+# define HPP_CORE_CONFIGURATION_SHOOTER_INFORMED_HH
+
+# include <limits>
+
+# include <hpp/core/configuration-shooter.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      /// \addtogroup configuration_sampling
+      /// \{
+
+      /// Sample configurations that may improve a solution
+      ///
+      /// Configurations \f$\mathbf{q}\f$ are restricted to the informed set
+      /// \f$ d(\mathbf{q}_{start}, \mathbf{q}) + d(\mathbf{q},
+      /// \mathbf{q}_{goal}) < c_{max} \f$ where \f$ d \f$ is a distance
+      /// and \f$ c_{max} \f$ the cost of the best path found so far. If the
+      /// length of the paths between two configurations is at least their
+      /// distance, the informed set contains all the configurations of the
+      /// paths shorter than \f$ c_{max} \f$.
+      ///
+      /// Configurations are drawn from another shooter and rejected until
+      /// one belongs to the informed set, which keeps the distribution of
+      /// the other shooter on the informed set and supports any
+      /// configuration space and distance.
+      class HPP_CORE_DLLAPI Informed : public ConfigurationShooter
+      {
+      public:
+        /// Create a shooter without restriction
+        /// \param shooter the shooter the samples are drawn from,
+        /// \param distance the distance defining the informed set.
+        static InformedPtr_t create (const ConfigurationShooterPtr_t& shooter,
+                                     const DistancePtr_t& distance);
+
+        /// Set the start and goal configurations
+        void foci (ConfigurationIn_t start, ConfigurationIn_t goal)
+        {
+          start_ = start;
+          goal_ = goal;
+        }
+        /// Set the cost of the best path
+        ///
+        /// Infinity disables the restriction.
+        void maxCost (value_type cost)
+        {
+          maxCost_ = cost;
+        }
+        /// Get the cost of the best path
+        value_type maxCost () const
+        {
+          return maxCost_;
+        }
+        /// Set the maximal number of samples drawn per shoot
+        ///
+        /// If all of them are rejected, the last one is returned.
+        void maxAttempts (size_type n)
+        {
+          maxAttempts_ = n;
+        }
+
+      protected:
+        Informed (const ConfigurationShooterPtr_t& shooter,
+                  const DistancePtr_t& distance);
+        void init (const InformedPtr_t& self)
+        {
+          ConfigurationShooter::init (self);
+          weak_ = self;
+        }
+
+        virtual void impl_shoot (Configuration_t& q) const;
+
+      private:
+        ConfigurationShooterPtr_t shooter_;
+        DistancePtr_t distance_;
+        Configuration_t start_, goal_;
+        value_type maxCost_;
+        size_type maxAttempts_;
+        InformedWkPtr_t weak_;
+      }; // class Informed
+      /// \}
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_CONFIGURATION_SHOOTER_INFORMED_HH
@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_CONFIGURATION_SHOOTER_PROJECTED_HH
+# define HPP_CORE_CONFIGURATION_SHOOTER_PROJECTED_HH
+
+# include <vector>
+
+# include <hpp/core/configuration-shooter.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      /// \addtogroup configuration_sampling
+      /// \{
+
+      /// Sample configurations satisfying the constraints of a problem
+      ///
+      /// Projecting a random configuration on the constraints often fails
+      /// or takes many iterations when the configuration is far from the
+      /// constraint manifold. This shooter keeps a pool of the last
+      /// configurations it projected successfully. With probability
+      /// \ref seedProbability, the start of the projection is a
+      /// configuration of the pool moved toward a configuration drawn from
+      /// another shooter; otherwise it is the drawn configuration itself.
+      ///
+      /// Returned configurations are projected, so that planners projecting
+      /// them again converge at once. If no projection succeeds after
+      /// \ref maxAttempts trials, the last drawn configuration is returned
+      /// unprojected. Without constraints, the configurations of the other
+      /// shooter are returned.
+      class HPP_CORE_DLLAPI Projected : public ConfigurationShooter
+      {
+      public:
+        /// Create a shooter
+        /// \param shooter the shooter the configurations are drawn from,
+        /// \param problem the problem, the constraints of which are read at
+        ///        each shoot.
+        static ProjectedPtr_t create (const ConfigurationShooterPtr_t& shooter,
+                                      const Problem& problem);
+
+        /// Set the number of configurations of the pool
+        void poolSize (size_type n);
+        /// Get the number of configurations of the pool
+        size_type poolSize () const
+        {
+          return poolSize_;
+        }
+        /// Set the probability to start a projection from the pool
+        void seedProbability (value_type p)
+        {
+          seedProbability_ = p;
+        }
+        /// Set by how much configurations of the pool are moved
+        ///
+        /// The start of the projection is the interpolation at this
+        /// parameter between the configuration of the pool and the drawn
+        /// configuration.
+        void perturbation (value_type u)
+        {
+          perturbation_ = u;
+        }
+        /// Set the maximal number of projections per shoot
+        void maxAttempts (size_type n)
+        {
+          maxAttempts_ = n;
+        }
+        /// Empty the pool
+        void clear ()
+        {
+          pool_.clear ();
+          next_ = 0;
+        }
+
+      protected:
+        Projected (const ConfigurationShooterPtr_t& shooter,
+                   const Problem& problem);
+        void init (const ProjectedPtr_t& self)
+        {
+          ConfigurationShooter::init (self);
+          weak_ = self;
+        }
+
+        virtual void impl_shoot (Configuration_t& q) const;
+
+      private:
+        /// Store a projected configuration in the pool
+        void store (ConfigurationIn_t q) const;
+
+        ConfigurationShooterPtr_t shooter_;
+        const Problem& problem_;
+        size_type poolSize_;
+        value_type seedProbability_;
+        value_type perturbation_;
+        size_type maxAttempts_;
+        /// Last projected configurations
+        mutable std::vector <Configuration_t> pool_;
+        /// Index of the configuration of the pool replaced next
+        mutable std::size_t next_;
+        ProjectedWkPtr_t weak_;
+      }; // class Projected
+      /// \}
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_CONFIGURATION_SHOOTER_PROJECTED_HH
@@ -61,7 +61,11 @@ namespace hpp {
         }
 
         virtual void impl_shoot (Configuration_t& q) const;
+        /// Shoot the configurations of a block, each joint at once
+        virtual void impl_shoot (matrix_t& configurations) const;
       private:
+        void shootBlock (Eigen::Map<matrix_t>& configurations) const;
+
         DevicePtr_t robot_;
         bool sampleExtraDOF_;
         UniformWkPtr_t weak_;
@@ -46,7 +46,10 @@ namespace hpp {
       /// Merge two connected components.
       ///
       /// \param other connected component to merge into this one.
-      /// \note other will be empty after calling this method.
+      /// \note The nodes of other are not modified: they find out that
+      ///       they belong to this connected component the next time
+      ///       Node::connectedComponent is called. The cost of the merge is
+      ///       linear in the size of other only.
       virtual void merge (const ConnectedComponentPtr_t& other);
       
       virtual ~ConnectedComponent() {}
@@ -68,6 +71,9 @@ namespace hpp {
 
       /// Whether this connected component can reach cc
       /// \param cc a connected component
+      ///
+      /// The set of connected components reachable from this one is
+      /// maintained when edges are added, so that this test is a lookup.
       bool canReach (const ConnectedComponentPtr_t& cc);
 
       
@@ -98,7 +104,7 @@ namespace hpp {
 
     protected:
       /// Constructor
-      ConnectedComponent () : nodes_ (), explored_ (false), weak_ ()
+      ConnectedComponent () : nodes_ (), mergedInto_ (), weak_ ()
 	  {
             nodes_.reserve (1000);
 	  }
@@ -106,16 +112,30 @@ namespace hpp {
 	weak_ = shPtr;
       }
     private:
-      static void clean (RawPtrs_t& set);
+      /// Update transitive reachability after connecting from to to.
+      /// Ancestors of from get the descendants of to as reachable.
+      static void addReachability (RawPtr_t from, RawPtr_t to);
+      /// Connected component cc has been merged into, cc if not merged.
+      static ConnectedComponentPtr_t root (const ConnectedComponentPtr_t& cc);
+      /// Compute the transitive reachability of this connected component
+      /// from the direct reachability.
+      void computeAllReachableTo ();
 
       NodeVector_t nodes_;
       // List of CCs from which this connected component can be reached
       RawPtrs_t reachableFrom_;
       // List of CCs that can be reached from this connected component
       RawPtrs_t reachableTo_;
-      // status variable to indicate whether or not CC has been visited
-      mutable bool explored_;
+      // CCs from which this connected component can be reached through
+      // any number of edges
+      RawPtrs_t allReachableFrom_;
+      // CCs that can be reached from this connected component through
+      // any number of edges
+      RawPtrs_t allReachableTo_;
+      /// Connected component this one has been merged into, if any.
+      ConnectedComponentPtr_t mergedInto_;
       ConnectedComponentWkPtr_t weak_;
+      friend class Node;
       friend class Roadmap;
 
       HPP_SERIALIZABLE();
@@ -82,6 +82,9 @@ namespace hpp {
       /// \retval error concatenation of errors of each constraint.
       virtual bool isSatisfied (ConfigurationIn_t config, vector_t& error);
 
+      /// Residual error of the config projector, 0 if there is none
+      virtual value_type residualError () const;
+
       /// \name Compression of locked degrees of freedom
       ///
       /// Degrees of freedom related to locked joint are not taken into
@@ -108,6 +111,15 @@ namespace hpp {
       ///       to zero.
       void uncompressVector (vectorIn_t small, vectorOut_t normal) const;
 
+      /// Compress Velocity vector into a workspace of the config projector
+      /// \sa ConfigProjector::compressVector(vectorIn_t) const
+      vectorIn_t compressVector (vectorIn_t normal) const;
+
+      /// Expand compressed velocity vector into a workspace of the config
+      /// projector
+      /// \sa ConfigProjector::uncompressVector(vectorIn_t) const
+      vectorIn_t uncompressVector (vectorIn_t small) const;
+
       /// Compress matrix
       ///
       /// \param normal input matrix
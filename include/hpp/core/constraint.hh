@@ -42,6 +42,29 @@ namespace hpp {
       /// \param configuration initial configuration and result
       /// \return true if constraint applied successfully, false if failure.
       bool apply (ConfigurationOut_t configuration);
+
+      /// Apply the constraint to each column of a matrix
+      /// \param configurations each column is an initial configuration and
+      ///        is replaced by the result,
+      /// \retval success whether the constraint was applied successfully to
+      ///         each column,
+      /// \retval residuals residual error of the projection of each column,
+      ///         see residualError,
+      /// \param numberThreads number of threads. Each additional thread
+      ///        applies a copy of the constraint to its columns.
+      /// \return true if the constraint was applied successfully to all
+      ///         the columns.
+      bool apply (matrixOut_t configurations, ArrayXb& success,
+                  vector_t& residuals, size_type numberThreads = 1);
+
+      /// Residual error of the last application of the constraint
+      ///
+      /// The default implementation returns 0.
+      virtual value_type residualError () const
+      {
+        return 0;
+      }
+
       /// Get name of constraint
       const std::string& name () const
       {
@@ -52,9 +52,18 @@ namespace hpp {
     }
     /// @endcond
 
-    template <typename Types, typename Key = std::string > struct Container
+    /// Elements stored by key
+    ///
+    /// \tparam Map the associative container storing the elements.
+    ///         std::map, the default, iterates by increasing keys, so that
+    ///         getAllAs, getKeys and print are deterministic. Large
+    ///         containers mostly accessed by key may use
+    ///         boost::unordered_map <Key, Types>, which elements are
+    ///         found in constant time but iterated in an unspecified order.
+    template <typename Types, typename Key = std::string,
+              typename Map = std::map <Key, Types> > struct Container
     {
-      typedef std::map <Key, Types> Map_t;
+      typedef Map Map_t;
       typedef typename Map_t::value_type value_type;
       typedef typename Map_t::key_type key_type;
       typedef typename Map_t::mapped_type mapped_type;
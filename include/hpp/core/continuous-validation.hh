@@ -19,6 +19,9 @@
 #ifndef HPP_CORE_CONTINUOUS_VALIDATION_HH
 # define HPP_CORE_CONTINUOUS_VALIDATION_HH
 
+# include <stdexcept>
+# include <vector>
+
 # include <hpp/pinocchio/pool.hh>
 
 # include <hpp/core/fwd.hh>
@@ -137,6 +140,61 @@ namespace hpp {
       virtual bool validate (const PathPtr_t& path, bool reverse,
 			     PathPtr_t& validPart,
 			     PathValidationReportPtr_t& report);
+
+      /// Validate a path and estimate its clearance
+      ///
+      /// See \ref validate for the other parameters.
+      /// \retval clearance smallest distance lower bound computed by the
+      ///         interval validations, see IntervalValidation::clearance.
+      ///         If the path is not valid, the bounds computed beyond the
+      ///         valid part are included.
+      bool validateWithClearance (const PathPtr_t& path, bool reverse,
+                                  PathPtr_t& validPart,
+                                  PathValidationReportPtr_t& report,
+                                  value_type& clearance);
+
+      /// Validate several paths concurrently
+      ///
+      /// Paths are distributed among \ref numberThreads threads, each
+      /// using its own copy of the interval validations. If interval
+      /// validations are split, see \ref splitIntervalValidations, paths
+      /// are validated one after the other, each with all the threads.
+      /// See PathValidation::validatePaths for the parameters. When
+      /// stopping at the first invalid path, threads stop validating
+      /// their remaining paths.
+      virtual bool validatePaths
+      (const std::vector <PathPtr_t>& paths, bool reverse,
+       std::vector <PathPtr_t>& validParts,
+       std::vector <PathValidationReportPtr_t>& reports,
+       std::vector <bool>& valid, bool stopAtFirstInvalid = false);
+
+      /// Set the number of threads of parallel validations
+      void numberThreads (size_type n)
+      {
+        if (n < 1) throw std::invalid_argument
+                     ("The number of threads should be positive.");
+        numberThreads_ = n;
+      }
+      /// Get the number of threads of parallel validations
+      size_type numberThreads () const
+      {
+        return numberThreads_;
+      }
+      /// Whether validate splits the interval validations among threads
+      ///
+      /// If true and \ref numberThreads is more than one, each thread
+      /// validates straight paths against a subset of the interval
+      /// validations, and the shortest valid part is kept. This speeds up
+      /// the validation of single long paths with many body pairs.
+      void splitIntervalValidations (bool split)
+      {
+        splitIntervalValidations_ = split;
+      }
+      bool splitIntervalValidations () const
+      {
+        return splitIntervalValidations_;
+      }
+
       /// Iteratively call method doExecute of delegate classes AddObstacle
       /// \param object new obstacle.
       /// \sa ContinuousValidation::add, ContinuousValidation::AddObstacle.
@@ -151,6 +209,13 @@ namespace hpp {
       virtual void removeObstacleFromJoint
 	(const JointPtr_t& joint, const CollisionObjectConstPtr_t& obstacle);
 
+      /// Notify that the placement or the geometry of an obstacle changed
+      ///
+      /// Body pair collisions read the placement and the geometry of the
+      /// obstacle at each test. The copies used by the threads are
+      /// discarded.
+      virtual void updateObstacle (const CollisionObjectConstPtr_t& object);
+
       /// Filter collision pairs.
       ///
       /// Remove pairs of object that cannot be in collision.
@@ -211,8 +276,15 @@ namespace hpp {
     protected:
       typedef continuousValidation::IntervalValidations_t IntervalValidations_t;
 
+      /// Set the path of the interval validations
+      ///
+      /// The body pairs share the velocity bounds of the path, see
+      /// continuousValidation::VelocityBounds.
+      /// \param robot if not null, the norms of the velocity bounds of all
+      ///        its joints are computed at once.
       static void setPath(IntervalValidations_t& intervalValidations,
-          const PathPtr_t &path, bool reverse);
+          const PathPtr_t &path, bool reverse,
+          const DevicePtr_t& robot = DevicePtr_t ());
 
       /// Constructor
       /// \param robot the robot for which validation is performed,
@@ -230,6 +302,12 @@ namespace hpp {
       ///         value, false if the body pair is in collision.
       /// \note object should be in the positions defined by the configuration
       ///       of parameter t on the path.
+      /// \note forward kinematics is computed once for all the interval
+      ///       validations, and skipped if they all know from previous
+      ///       parameters that they are valid, see intervalsValidated.
+      /// \note the element that is not valid, or else the one that
+      ///       returned the smallest interval, is moved to the front of
+      ///       intervalValidations so that it is tested first next time.
       virtual bool validateConfiguration
         (IntervalValidations_t& intervalValidations,
           const Configuration_t& config,
@@ -237,6 +315,16 @@ namespace hpp {
           interval_t& interval,
           PathValidationReportPtr_t& report);
 
+      /// Whether all interval validations are known to be valid at a
+      /// parameter
+      ///
+      /// Interval validations are considered in the order of
+      /// validateIntervals.
+      /// \sa IntervalValidation::validated
+      bool intervalsValidated
+        (const IntervalValidations_t& intervalValidations,
+         const value_type& t) const;
+
       /// Validate a set of intervals for a given parameter along a path
       ///
       /// \tparam IntervalValidation type of container of validation elements
@@ -248,7 +336,8 @@ namespace hpp {
       /// \param t center of the interval to be validated,
       /// \retval interval interval validated for all objects,
       /// \retval smallestInterval iterator to the validation element that
-      ///         returned the smallest interval.
+      ///         returned the smallest interval, or to the element that
+      ///         is not valid if validation fails.
       bool validateIntervals
         (IntervalValidations_t& validations, const value_type &t,
          interval_t &interval, PathValidationReportPtr_t &pathReport,
@@ -265,6 +354,7 @@ namespace hpp {
           interval_t tmpInt = interval;
           if (!(*itVal)->validateConfiguration(t, tmpInt, report, data))
           {
+            smallestInterval = itVal;
             pathReport = PathValidationReportPtr_t(new PathValidationReport);
             pathReport->configurationReport = report;
             pathReport->parameter = t;
@@ -301,10 +391,44 @@ namespace hpp {
       pinocchio::Pool<IntervalValidations_t> bodyPairCollisionPool_;
 
       value_type stepSize_;
+
+      /// Copy of the interval validations from the pool
+      ///
+      /// A copy is added to the pool if none is available. It is given
+      /// back with bodyPairCollisionPool_.release.
+      IntervalValidations_t* acquireIntervalValidations ();
+
+      /// Number of threads available to validate a straight path
+      ///
+      /// \ref numberThreads, or one in the threads of validatePaths and of
+      /// split validations, that already use all the threads.
+      size_type straightPathThreads () const;
     private:
       // Weak pointer to itself
       ContinuousValidationWkPtr_t weak_;
 
+      /// Validate a straight path with interval validations split among
+      /// threads
+      bool validateStraightPathSplit (const PathPtr_t& path, bool reverse,
+                                      PathPtr_t& validPart,
+                                      PathValidationReportPtr_t& report,
+                                      value_type& clearance);
+
+      /// Paths and results shared by the threads of validatePaths
+      struct Batch;
+      /// Validate paths begin, begin + step, ... of validatePaths
+      void validateRange (Batch& batch, std::vector <bool>& valid,
+                          std::size_t begin, std::size_t step);
+      /// Validate a straight path with a subset of the interval validations
+      /// in a thread of validateStraightPathSplit
+      void validateSubset (IntervalValidations_t& intervalValidations,
+                           const PathPtr_t& path, bool reverse,
+                           PathPtr_t& validPart,
+                           PathValidationReportPtr_t& report);
+
+      size_type numberThreads_;
+      bool splitIntervalValidations_;
+
       virtual bool validateStraightPath
         (IntervalValidations_t& intervalValidations,
           const PathPtr_t& path, bool reverse, PathPtr_t& validPart,
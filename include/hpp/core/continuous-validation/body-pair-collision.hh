@@ -19,13 +19,15 @@
 #ifndef HPP_CORE_CONTINUOUS_VALIDATION_BODY_PAIR_COLLISION_HH
 # define HPP_CORE_CONTINUOUS_VALIDATION_BODY_PAIR_COLLISION_HH
 
-# include <boost/icl/continuous_interval.hpp>
-# include <boost/icl/interval_set.hpp>
+# include <limits>
+# include <utility>
+# include <vector>
 
 # include <hpp/fcl/collision_data.h>
 
 # include <hpp/core/collision-validation-report.hh>
 # include <hpp/core/continuous-validation/interval-validation.hh>
+# include <hpp/core/continuous-validation/velocity-bounds.hh>
 
 namespace hpp {
   namespace core {
@@ -87,6 +89,16 @@ namespace hpp {
           return maximalVelocity_;
         }
 
+        /// Share velocity bounds with other body pairs
+        ///
+        /// The bounds are computed for the next path if they are not
+        /// computed for it yet. ContinuousValidation gives the same
+        /// instance to the body pairs that validate a path.
+        void velocityBounds (const VelocityBoundsPtr_t& bounds)
+        {
+          velocityBounds_ = bounds;
+        }
+
         /// Returns joint A index or -1 if no such joint exists.
         virtual size_type indexJointA () const { return -1; }
         /// Returns joint B index or -1 if no such joint exists.
@@ -99,6 +111,18 @@ namespace hpp {
         virtual std::string name () const = 0;
         virtual std::ostream& print (std::ostream& os) const = 0;
 
+        /// Set the distance between bounding spheres above which it is used
+        /// as distance lower bound
+        ///
+        /// When the smallest distance between the bounding spheres of the
+        /// pairs is above this threshold, collision objects are not
+        /// checked. By default, the threshold is infinite.
+        /// \sa Hierarchical
+        void coarseThreshold (const value_type& threshold)
+        {
+          coarseThreshold_ = threshold;
+        }
+
         /// \name Security margin
         /// \{
 
@@ -119,7 +143,10 @@ namespace hpp {
         /// \param tolerance allowed penetration should be positive
         BodyPairCollision (value_type tolerance):
           IntervalValidation(tolerance), m_ (new Model),
-          collisionRequest_(fcl::DISTANCE_LOWER_BOUND, 1), maximalVelocity_(0)
+          collisionRequest_(fcl::DISTANCE_LOWER_BOUND, 1), maximalVelocity_(0),
+          angularVelocity_(0), leaves_(0),
+          coarseThreshold_(std::numeric_limits <value_type>::infinity ()),
+          wholePathDistance_(std::numeric_limits <value_type>::infinity ())
         {
           collisionRequest_.enable_cached_gjk_guess = true;
         }
@@ -128,7 +155,10 @@ namespace hpp {
         BodyPairCollision (const BodyPairCollision& other):
           IntervalValidation(other), m_(other.m_),
           collisionRequest_(other.collisionRequest_),
-          maximalVelocity_(other.maximalVelocity_)
+          maximalVelocity_(other.maximalVelocity_),
+          angularVelocity_(other.angularVelocity_), leaves_(0),
+          coarseThreshold_(other.coarseThreshold_),
+          wholePathDistance_(std::numeric_limits <value_type>::infinity ())
         {}
 
         virtual void setReport (ValidationReportPtr_t& report,
@@ -148,17 +178,98 @@ namespace hpp {
 
         mutable vector_t Vb_;
         value_type maximalVelocity_;
+        /// Rotation rate of the robot around a fixed center along the path
+        ///
+        /// Non zero if the path is an arc of circle along which the robot
+        /// moves rigidly, see
+        /// steeringMethod::ConstantCurvature::rigidAngularVelocity.
+        value_type angularVelocity_;
+        /// Velocity bounds of the path, possibly shared with other pairs
+        ///
+        /// Copies compute their own bounds, since they are used by other
+        /// threads.
+        VelocityBoundsPtr_t velocityBounds_;
+        /// Segment tree of the maximal velocity on the pieces of the path
+        ///
+        /// The pieces are the leaves, starting at rank \c leaves_, and each
+        /// node is the maximum of its two children.
+        std::vector <value_type> pieceVelocities_;
+        /// Number of leaves of pieceVelocities_, a power of two
+        std::size_t leaves_;
+        /// Distance covered at maximal velocity from the beginning of the
+        /// path to the beginning of each piece
+        std::vector <value_type> pieceDistances_;
+        /// GJK guess returned by the last distance query of each pair
+        ///
+        /// Successive queries of a pair are close configurations along a
+        /// path, so the previous guess warm starts GJK. Each copy of the
+        /// object has its own guesses.
+        std::vector <fcl::Vec3f> gjkGuesses_;
+        /// Distance between the bounding spheres of each pair, and index
+        /// of the pair, sorted by computeDistanceLowerBound
+        std::vector <std::pair <value_type, std::size_t> > sphereDistances_;
+        value_type coarseThreshold_;
+        /// Distance lower bound above which the collision free interval
+        /// around the parameter being validated covers the whole path
+        ///
+        /// Set by validateConfiguration. When the distance between the
+        /// bounding spheres of all the pairs, security margin deduced, is
+        /// above it, computeDistanceLowerBound returns it without checking
+        /// the collision objects.
+        value_type wholePathDistance_;
 
         /// Compute maximal velocity for a given velocity bound
         /// \param Vb velocity
         virtual value_type computeMaximalVelocity(vector_t& Vb) const = 0;
 
+        /// Compute maximal velocity for a velocity bound of the path
+        ///
+        /// Calls computeMaximalVelocity (vector_t&) by default. Derived
+        /// classes may use the norms of the bounds of the joints, shared by
+        /// the pairs.
+        /// \param i see VelocityBounds::bound.
+        virtual value_type computeMaximalVelocity (VelocityBounds& bounds,
+                                                   std::size_t i) const;
+
         /// Compute the maximal velocity along the path
         /// To be called after a new path has been set
         virtual void setupPath();
 
+        /// Compute the maximal velocity on pieces of the path
+        ///
+        /// Pieces are the intervals between interpolation points of an
+        /// InterpolatedPath, or uniform pieces for other paths, see
+        /// VelocityBounds.
+        void setupPieces ();
+
+        /// Maximal velocity on pieces of the path
+        /// \param first, last ranks of the first and last pieces.
+        value_type maximalVelocity (std::size_t first, std::size_t last) const;
+
+        /// Rank of the piece containing a time
+        std::size_t piece (const value_type& t) const;
+
+        /// Length of the collision free interval on one side of t, using
+        /// the maximal velocity on each piece
+        ///
+        /// The end of the interval is found by a binary search in the
+        /// distances covered from the beginning of the path.
+        /// \param forward whether the interval goes towards the path end,
+        /// \retval maxVelocity updated with the maximal velocity on the
+        ///         pieces traversed.
+        value_type piecewiseHalfLength (const value_type& t,
+                                        const value_type& distanceLowerBound,
+                                        bool forward,
+                                        value_type& maxVelocity) const;
+
         /// Compute a collision free interval around t given a lower bound of
         /// the distance to obstacle.
+        ///
+        /// Along an arc of circle, the points of the bodies move on circles
+        /// of radius at most \f$R = V / \omega\f$, where \f$V\f$ is the
+        /// maximal velocity and \f$\omega\f$ the rotation rate. Their
+        /// displacement over a duration \f$T\f$ is the chord
+        /// \f$2R\sin(\omega T/2)\f$, shorter than \f$VT\f$.
         /// \param t the time in the path to test for a collision free interval
         /// \return distanceLowerBound the interval half length
         /// \retval maxVelocity the maximum velocity reached during this interval
@@ -170,6 +281,13 @@ namespace hpp {
         /// \retval distanceLowerBound
         /// \retval report the collision validation report
         /// \return true if the bodies are not in collision, else false
+        /// \note GJK is warm started with the guess of the previous query of
+        ///       each collision pair.
+        /// \note pairs whose bounding spheres are farther than the lower bound
+        ///       are not checked.
+        /// \note the distance between the bounding spheres is returned if
+        ///       it is above coarseThreshold or above the distance that
+        ///       certifies the whole path.
         virtual bool computeDistanceLowerBound(value_type &distanceLowerBound,
           ValidationReportPtr_t& report,
           const pinocchio::DeviceData& data);
@@ -19,6 +19,8 @@
 #ifndef HPP_CORE_CONTINUOUS_VALIDATION_DICHOTOMY_HH
 # define HPP_CORE_CONTINUOUS_VALIDATION_DICHOTOMY_HH
 
+# include <vector>
+
 # include <hpp/core/continuous-validation.hh>
 
 namespace hpp {
@@ -35,8 +37,20 @@ namespace hpp {
       /// \li validating the beginning of the interval (or the end if paramater
       ///     reverse is set to true when calling
       ///     ContinuousValidation::validate),
-      /// \li validate intervals centered at the middle of the biggest non
-      ///     tested interval.
+      /// \li validating breadth first intervals centered at the middles of
+      ///     all the non tested intervals, so that the whole path is
+      ///     coarsely covered early and collisions far from the beginning
+      ///     are found soon,
+      /// \li once an invalid parameter is found, extending the valid part
+      ///     from the beginning by validating intervals centered at the
+      ///     middle of the first non tested interval before it.
+      ///
+      /// The parameters of a level of the breadth first search are
+      /// distributed among ContinuousValidation::numberThreads threads,
+      /// each with its own copy of the interval validations, unless the
+      /// threads are already used to validate several paths or to split
+      /// the interval validations. The clearance is then estimated by the
+      /// interval validations of the first thread only.
       /// See <a href="continuous-validation.pdf"> this document </a>
       /// for details.
       class HPP_CORE_DLLAPI Dichotomy : public ContinuousValidation
@@ -57,6 +71,7 @@ namespace hpp {
         /// Store weak pointer to itself
         void init(const DichotomyWkPtr_t weak);
       private:
+        struct Level;
         // Weak pointer to itself
         DichotomyWkPtr_t weak_;
         bool validateStraightPath (IntervalValidations_t& bodyPairCollisions,
@@ -68,6 +83,15 @@ namespace hpp {
             const PathPtr_t& path,
             PathPtr_t& validPart,
             PathValidationReportPtr_t& report);
+        /// Validate the parameters of a level, in parallel if possible
+        /// \param copies copies of the interval validations used by the
+        ///        other threads, acquired when first needed.
+        void validateLevel (IntervalValidations_t& bodyPairCollisions,
+            std::vector <IntervalValidations_t*>& copies,
+            const PathPtr_t& path, bool reverse, Level& level);
+        /// Validate parameters begin, begin + step, ... of a level
+        void validateParameters (IntervalValidations_t& bodyPairCollisions,
+            Level& level, std::size_t begin, std::size_t step);
       }; // class Dichotomy
     } // namespace continuousValidation
     /// \}
@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_CONTINUOUS_VALIDATION_DISTANCE_FIELD_COLLISION_HH
+# define HPP_CORE_CONTINUOUS_VALIDATION_DISTANCE_FIELD_COLLISION_HH
+
+# include <hpp/core/continuous-validation/solid-solid-collision.hh>
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      /// Computation of collision-free sub-intervals of a path with respect
+      /// to obstacles stored in a distance field
+      ///
+      /// The objects of the body of a joint are approximated by their
+      /// bounding spheres, as in DistanceFieldValidation. The lower bound
+      /// of the distance of the spheres to the obstacles, read in the
+      /// distance field, grows the collision-free interval with the
+      /// velocity bounds of SolidSolidCollision.
+      ///
+      /// Instances are added to a ContinuousValidation with
+      /// ContinuousValidation::addIntervalValidation, one per joint holding
+      /// a body.
+      class HPP_CORE_DLLAPI DistanceFieldCollision : public SolidSolidCollision
+      {
+      public:
+        /// Create instance and return shared pointer
+        ///
+        /// \param joint joint of the body to test for collision,
+        /// \param field distance to the obstacles,
+        /// \param tolerance allowed penetration should be positive.
+        static DistanceFieldCollisionPtr_t create
+        (const JointPtr_t& joint, const DistanceFieldPtr_t& field,
+         value_type tolerance);
+
+        /// Copy instance and return shared pointer.
+        static DistanceFieldCollisionPtr_t createCopy
+          (const DistanceFieldCollisionPtr_t& other);
+
+        std::string name () const;
+
+        std::ostream& print (std::ostream& os) const;
+
+        IntervalValidationPtr_t copy () const;
+
+      protected:
+        /// Constructor
+        /// \copydoc DistanceFieldCollision::create
+        DistanceFieldCollision (const JointPtr_t& joint,
+                                const DistanceFieldPtr_t& field,
+                                value_type tolerance);
+
+        /// Copy constructor
+        DistanceFieldCollision (const DistanceFieldCollision& other)
+          : SolidSolidCollision (other), field_ (other.field_),
+            objects_ (other.objects_)
+        {}
+
+        void init (const DistanceFieldCollisionWkPtr_t& weak);
+
+      private:
+        /// Lower bound of the distance of the bounding spheres of the
+        /// objects to the obstacles, minus the security margin
+        virtual bool computeDistanceLowerBound(value_type &distanceLowerBound,
+          ValidationReportPtr_t& report,
+          const pinocchio::DeviceData& data);
+
+        DistanceFieldPtr_t field_;
+        /// Objects of the body of the joint
+        ConstObjectStdVector_t objects_;
+        DistanceFieldCollisionWkPtr_t weak_;
+      }; // class DistanceFieldCollision
+    } // namespace continuousValidation
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_CONTINUOUS_VALIDATION_DISTANCE_FIELD_COLLISION_HH
@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_CONTINUOUS_VALIDATION_HIERARCHICAL_HH
+# define HPP_CORE_CONTINUOUS_VALIDATION_HIERARCHICAL_HH
+
+# include <hpp/core/continuous-validation/progressive.hh>
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      /// \addtogroup validation
+      /// \{
+
+      /// Coarse to fine continuous validation of a path
+      ///
+      /// This class is a specialization of Progressive. At each parameter
+      /// along the path, the distance between body pairs is first bounded
+      /// by the distance between the bounding spheres of their collision
+      /// objects. Exact geometries are only checked, at this parameter,
+      /// when this coarse bound is below \ref coarseThreshold.
+      ///
+      /// Far from obstacles, validation then never calls narrow phase
+      /// distance computation between meshes.
+      class HPP_CORE_DLLAPI Hierarchical : public Progressive
+      {
+      public:
+        /// Create instance and return shared pointer
+        /// \param robot the robot for which continuous validation is performed,
+        /// \param tolerance maximal penetration allowed.
+        static HierarchicalPtr_t
+          create (const DevicePtr_t& robot, const value_type& tolerance);
+        virtual ~Hierarchical ();
+
+        /// Set the distance between bounding spheres under which exact
+        /// geometries are checked
+        ///
+        /// Small values lead to many small steps along the path when it is
+        /// close to obstacles. The default value is the tolerance.
+        void coarseThreshold (const value_type& threshold)
+        {
+          if (threshold < 0)
+            throw std::invalid_argument ("threshold should be non-negative.");
+          coarseThreshold_ = threshold;
+        }
+        /// Get the distance between bounding spheres under which exact
+        /// geometries are checked
+        value_type coarseThreshold () const
+        {
+          return coarseThreshold_;
+        }
+
+      protected:
+        /// Constructor
+        /// \param robot the robot for which continuous validation is performed,
+        /// \param tolerance maximal penetration allowed.
+        Hierarchical (const DevicePtr_t& robot, const value_type& tolerance);
+        /// Store weak pointer to itself
+        void init (const HierarchicalWkPtr_t weak);
+
+      private:
+        // Weak pointer to itself
+        HierarchicalWkPtr_t weak_;
+        value_type coarseThreshold_;
+        bool validateStraightPath (IntervalValidations_t& bodyPairCollisions,
+            const PathPtr_t& path, bool reverse,
+            PathPtr_t& validPart,
+            PathValidationReportPtr_t& report);
+      }; // class Hierarchical
+    } // namespace continuousValidation
+    /// \}
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_CONTINUOUS_VALIDATION_HIERARCHICAL_HH
@@ -19,12 +19,10 @@
 #ifndef HPP_CORE_CONTINUOUS_VALIDATION_INTERVAL_VALIDATION_HH
 #define HPP_CORE_CONTINUOUS_VALIDATION_INTERVAL_VALIDATION_HH
 
+#include <deque>
 #include <limits>
 #include <iterator>
 
-#include <boost/icl/continuous_interval.hpp>
-#include <boost/icl/interval_set.hpp>
-
 #include <hpp/fcl/collision_data.h>
 #include <hpp/fcl/collision.h>
 #include <hpp/pinocchio/body.hh>
@@ -32,6 +30,8 @@
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/core/deprecated.hh>
 #include <hpp/core/fwd.hh>
+#include <hpp/core/path.hh>
+#include <hpp/core/continuous-validation/intervals.hh>
 
 namespace hpp {
   namespace core {
@@ -54,6 +54,12 @@ namespace hpp {
       /// considered as valid if the criterion is violated by less than the
       /// tolerance. This parameter interpretation is left to the
       /// specialization designers.
+      ///
+      /// The valid intervals of the last paths are kept when a new path is
+      /// set, and carried over to the parts of the new path that follow
+      /// the same geometric path: windows extracted from the same path, or
+      /// straight paths between the same configurations, as built again by
+      /// shortcut optimizers.
       class IntervalValidation
       {
       public:
@@ -69,16 +75,60 @@ namespace hpp {
                                   ValidationReportPtr_t &report,
                                   const pinocchio::DeviceData& data) = 0;
 
+        /// Whether an interval is known to be valid from previous calls
+        /// to validateConfiguration
+        /// \param interval interval over which the criterion should be
+        ///        checked,
+        /// \retval interval validated interval, see validateConfiguration.
+        /// \return true if validateConfiguration would return true over
+        ///         this interval without using the forward kinematics.
+        bool validated (interval_t& interval) const
+        {
+          if (valid_) {
+            interval = path_->timeRange ();
+            return true;
+          }
+          return validInterval_.contains (interval);
+        }
+
+        /// Whether a parameter is known to be valid from previous calls
+        /// to validateConfiguration
+        /// \param t parameter,
+        /// \param interval interval over which the criterion should be
+        ///        checked,
+        /// \retval interval interval over which the criterion is known to
+        ///         be valid: unchanged if it is included in the known valid
+        ///         intervals, the known valid interval containing t
+        ///         otherwise.
+        bool validated (const value_type& t, interval_t& interval) const
+        {
+          if (validated (interval)) return true;
+          return validInterval_.containing (t, interval);
+        }
+
         /// Set path to validate
+        ///
+        /// The valid intervals of the previous paths that follow the same
+        /// geometric path as parts of the new one are carried over.
         /// \param path path to validate,
         /// \param reverse whether path is validated from end to beginning.
-        void path(const PathPtr_t &path, bool reverse)
+        void path(const PathPtr_t &path, bool reverse);
+
+        /// Forget the valid intervals of the previous paths
+        void clearCertificates ()
         {
-          path_ = path;
-          reverse_ = reverse;
-          valid_ = false;
-          validInterval_ = interval_set();
-          setupPath();
+          certificates_.clear ();
+        }
+
+        /// Smallest distance lower bound computed since the path was set
+        ///
+        /// The bounds are computed at the configurations tested by
+        /// validateConfiguration: the clearance between them may be
+        /// smaller, down to minus the tolerance. Infinity if no bound was
+        /// computed.
+        value_type clearance () const
+        {
+          return clearance_;
         }
 
         /// Get path
@@ -97,19 +147,21 @@ namespace hpp {
         virtual IntervalValidationPtr_t copy () const = 0;
 
       protected:
-        typedef boost::icl::continuous_interval<value_type> continuous_interval;
-        typedef boost::icl::interval_set<value_type> interval_set;
         PathPtr_t path_;
         value_type tolerance_;
         bool reverse_;
         bool refine_;
         bool valid_;
-        interval_set validInterval_;
+        /// Union of the intervals validated along the path
+        Intervals validInterval_;
+        /// \copydoc clearance
+        value_type clearance_;
         /// Constructor of interval validation element
         ///
         /// \param tolerance allowed penetration should be positive
         IntervalValidation (value_type tolerance) : tolerance_(tolerance),
-          reverse_(false), refine_(true)
+          reverse_(false), refine_(true),
+          clearance_ (std::numeric_limits <value_type>::infinity ())
         {
           if (tolerance < 0) {
             throw std::runtime_error ("tolerance should be non-negative.");
@@ -117,7 +169,8 @@ namespace hpp {
         }
 
         IntervalValidation (const IntervalValidation& other) :
-          tolerance_(other.tolerance_), refine_(true)
+          tolerance_(other.tolerance_), refine_(true),
+          clearance_ (std::numeric_limits <value_type>::infinity ())
         {
           if (tolerance_ < 0) {
             throw std::runtime_error ("tolerance should be non-negative.");
@@ -125,7 +178,20 @@ namespace hpp {
         }
 
       private:
+        /// Valid intervals of a previous path
+        struct Certificate
+        {
+          PathPtr_t path;
+          Intervals intervals;
+          value_type clearance;
+        }; // struct Certificate
+        /// Number of previous paths whose valid intervals are kept
+        static const std::size_t numberCertificates = 4;
+
         virtual void setupPath() = 0;
+
+        /// Previous paths, the most recent first
+        std::deque <Certificate> certificates_;
       }; // class IntervalValidation
 
       inline std::ostream &operator<<(std::ostream &os,
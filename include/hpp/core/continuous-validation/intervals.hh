@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_CONTINUOUS_VALIDATION_INTERVALS_HH
+# define HPP_CORE_CONTINUOUS_VALIDATION_INTERVALS_HH
+
+# include <algorithm>
+# include <ostream>
+# include <sstream>
+# include <vector>
+# include <hpp/core/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      /// Union of closed intervals
+      ///
+      /// Intervals are stored sorted and disjoint in a vector. Overlapping
+      /// or touching intervals are merged.
+      class Intervals
+      {
+      public:
+        typedef std::vector <interval_t> Intervals_t;
+
+        /// Reset to empty set
+        void clear ()
+        {
+          intervals_.clear ();
+        }
+        /// Union of this with an interval
+        ///
+        /// Empty intervals are ignored.
+        void unionInterval (const interval_t& interval)
+        {
+          if (interval.first > interval.second) return;
+          // First interval that does not end before the new one
+          Intervals_t::iterator begin
+            (std::lower_bound (intervals_.begin (), intervals_.end (),
+                               interval.first, endsBefore));
+          // First interval that starts after the new one
+          Intervals_t::iterator end
+            (std::upper_bound (begin, intervals_.end (), interval.second,
+                               startsAfter));
+          if (begin == end) {
+            intervals_.insert (begin, interval);
+            return;
+          }
+          // Merge [begin, end) with the new interval into *begin.
+          begin->first = std::min (begin->first, interval.first);
+          begin->second = std::max ((end - 1)->second, interval.second);
+          intervals_.erase (begin + 1, end);
+        }
+
+        /// Whether an interval is included in the union
+        bool contains (const interval_t& interval) const
+        {
+          Intervals_t::const_iterator it (find (interval.first));
+          return it != intervals_.end () && interval.second <= it->second;
+        }
+
+        /// Whether a value belongs to the union
+        /// \param reverse kept for compatibility, has no effect.
+        bool contains (const value_type& value, bool reverse = false) const
+        {
+          (void) reverse;
+          return find (value) != intervals_.end ();
+        }
+
+        /// Interval of the union containing a value
+        /// \retval interval the interval, unchanged if there is none.
+        /// \return whether the value belongs to the union.
+        bool containing (const value_type& value, interval_t& interval) const
+        {
+          Intervals_t::const_iterator it (find (value));
+          if (it == intervals_.end ()) return false;
+          interval = *it;
+          return true;
+        }
+
+        /// Sorted disjoint intervals
+        const Intervals_t& list () const
+        {
+          return intervals_;
+        }
+
+        std::ostream& print (std::ostream& os) const
+        {
+          os << "Intervals: " << std::endl;
+          for (Intervals_t::const_iterator it = intervals_.begin ();
+               it != intervals_.end (); ++it) {
+            os << "[" << it->first << ", " << it->second << "]" << std::endl;
+          }
+          return os;
+        }
+
+        std::string toString () const
+        {
+          std::ostringstream oss;
+          print (oss);
+          return oss.str ();
+        }
+
+      private:
+        static bool endsBefore (const interval_t& interval,
+                                const value_type& value)
+        {
+          return interval.second < value;
+        }
+        static bool startsAfter (const value_type& value,
+                                 const interval_t& interval)
+        {
+          return value < interval.first;
+        }
+        /// Interval containing a value
+        /// \return end of the intervals if there is none.
+        Intervals_t::const_iterator find (const value_type& value) const
+        {
+          Intervals_t::const_iterator it
+            (std::lower_bound (intervals_.begin (), intervals_.end (), value,
+                               endsBefore));
+          if (it != intervals_.end () && it->first <= value) return it;
+          return intervals_.end ();
+        }
+
+        Intervals_t intervals_;
+      }; // class Intervals
+
+      inline std::ostream& operator<< (std::ostream& os, const Intervals& o)
+      {
+        return o.print (os);
+      }
+    } // namespace continuousValidation
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_CONTINUOUS_VALIDATION_INTERVALS_HH
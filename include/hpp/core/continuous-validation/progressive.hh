@@ -56,13 +56,13 @@ namespace hpp {
         Progressive (const DevicePtr_t& robot, const value_type& tolerance);
         /// Store weak pointer to itself
         void init(const ProgressiveWkPtr_t weak);
-      private:
-        // Weak pointer to itself
-        ProgressiveWkPtr_t weak_;
         bool validateStraightPath (IntervalValidations_t& bodyPairCollisions,
             const PathPtr_t& path, bool reverse,
             PathPtr_t& validPart,
             PathValidationReportPtr_t& report);
+      private:
+        // Weak pointer to itself
+        ProgressiveWkPtr_t weak_;
         template <bool reverse>
         bool validateStraightPath (IntervalValidations_t& bodyPairCollisions,
             const PathPtr_t& path,
@@ -71,6 +71,11 @@ namespace hpp {
 
         value_type computeMaximalVelocity(vector_t& Vb) const;
 
+        /// Sum the norms of the velocity bounds of the joints of the
+        /// kinematic chain, shared with the other pairs along the chain
+        value_type computeMaximalVelocity (VelocityBounds& bounds,
+                                           std::size_t i) const;
+
         bool removeObjectTo_b (const CollisionObjectConstPtr_t& object);
 
 	std::string name () const;
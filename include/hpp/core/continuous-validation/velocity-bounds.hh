@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2014,2015,2016,2018 CNRS
+// Authors: Florent Lamiraux, Joseph Mirabel, Diane Bury
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_CONTINUOUS_VALIDATION_VELOCITY_BOUNDS_HH
+# define HPP_CORE_CONTINUOUS_VALIDATION_VELOCITY_BOUNDS_HH
+
+# include <vector>
+
+# include <hpp/pinocchio/joint.hh>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      /// Velocity bounds of a path, over the whole path and over pieces
+      ///
+      /// Bounds are given by Path::velocityBound. The pieces are the
+      /// intervals between interpolation points of an InterpolatedPath,
+      /// or uniform pieces for other paths. They are computed when first
+      /// needed, see \ref setupPieces.
+      ///
+      /// ContinuousValidation gives the same instance to the body pairs
+      /// validating a path, so that the velocity bounds of the path and
+      /// the norms of the bounds of each joint are computed once for all
+      /// the pairs, see BodyPairCollision::computeMaximalVelocity. Each
+      /// pair then sums the norms of the joints of its kinematic chain.
+      class HPP_CORE_DLLAPI VelocityBounds
+      {
+      public:
+        /// Constructor
+        /// \param robot if not null, the norms of the bounds of all its
+        ///        joints are computed with the bounds. Otherwise, they are
+        ///        computed at the first call to \ref jointNorm for each
+        ///        joint.
+        explicit VelocityBounds (const DevicePtr_t& robot = DevicePtr_t ()) :
+          robot_ (robot), path_ (), pieces_ (false), pieceBounds_ (),
+          bounds_ (), jointNorms_ ()
+        {
+        }
+
+        /// Set the path and compute its velocity bound
+        ///
+        /// The bounds of the previous path are forgotten.
+        void path (const PathPtr_t& path);
+        /// Path the bounds of which are computed
+        const PathPtr_t& path () const
+        {
+          return path_;
+        }
+
+        /// Compute the pieces and their velocity bounds if not done yet
+        void setupPieces ();
+        /// Bounds of the pieces of the path, in increasing order
+        const std::vector <value_type>& pieceBounds () const
+        {
+          return pieceBounds_;
+        }
+        /// Number of pieces, zero until \ref setupPieces is called
+        std::size_t numberPieces () const
+        {
+          return pieces_ ? pieceBounds_.size () - 1 : 0;
+        }
+
+        /// Velocity bound of the degrees of freedom
+        /// \param i 0 for the whole path, k + 1 for piece k.
+        vectorIn_t bound (std::size_t i) const
+        {
+          return bounds_.col (i);
+        }
+        /// Norm of the velocity bound of the degrees of freedom of a joint
+        /// \param i see \ref bound.
+        value_type jointNorm (const JointPtr_t& joint, std::size_t i)
+        {
+          const size_type index ((size_type) joint->index ());
+          if (index < jointNorms_.rows ()) {
+            const value_type& norm (jointNorms_ (index, (size_type) i));
+            if (norm >= 0) return norm;
+          }
+          return computeJointNorm (joint, i);
+        }
+
+      private:
+        /// Compute the norms of the bounds of the joints of the robot
+        /// \param first rank of the first bound.
+        void computeJointNorms (size_type first);
+        /// Compute and store the norm of the bound of a joint
+        value_type computeJointNorm (const JointPtr_t& joint, std::size_t i);
+
+        DevicePtr_t robot_;
+        PathPtr_t path_;
+        bool pieces_;
+        std::vector <value_type> pieceBounds_;
+        /// Velocity bounds, one column per interval, see \ref bound
+        matrix_t bounds_;
+        /// Norms of the velocity bounds, one row per joint index, negative
+        /// if not computed yet
+        matrix_t jointNorms_;
+      }; // class VelocityBounds
+    } // namespace continuousValidation
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_CONTINUOUS_VALIDATION_VELOCITY_BOUNDS_HH
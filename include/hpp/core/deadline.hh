@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_DEADLINE_HH
+# define HPP_CORE_DEADLINE_HH
+
+# include <limits>
+
+# include <boost/chrono/system_clocks.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+# include <hpp/core/validation-report.hh>
+
+namespace hpp {
+  namespace core {
+    /// Time budget shared by the components of a resolution
+    ///
+    /// A deadline is started with a duration and expires when the duration
+    /// has elapsed, measured with a monotonic clock, or when it is
+    /// cancelled. Long inner loops, as path validation, path projection and
+    /// path optimization, check \ref expired to stop cooperatively, which
+    /// bounds the time by which a resolution overshoots its budget.
+    ///
+    /// There is one deadline per Problem, see Problem::deadline. It is
+    /// started by PathPlanner::solve and cancelled by
+    /// PathPlanner::interrupt.
+    class HPP_CORE_DLLAPI Deadline
+    {
+    public:
+      typedef boost::chrono::steady_clock Clock_t;
+
+      /// Run a deadline during the lifetime of an object
+      ///
+      /// The deadline is started by the constructor and stopped by the
+      /// destructor, unless it was already running: nested resolutions,
+      /// as the planners of a pathPlanner::Portfolio, share the deadline of
+      /// the outer one.
+      class Scope
+      {
+      public:
+        Scope (const DeadlinePtr_t& deadline, value_type duration) :
+          deadline_ (deadline), owner_ (!deadline->running ())
+        {
+          if (owner_) deadline_->start (duration);
+        }
+        ~Scope ()
+        {
+          if (owner_) deadline_->stop ();
+        }
+      private:
+        DeadlinePtr_t deadline_;
+        bool owner_;
+      }; // class Scope
+
+      /// Create a deadline that never expires
+      static DeadlinePtr_t create ()
+      {
+        return DeadlinePtr_t (new Deadline);
+      }
+
+      /// Start the deadline
+      /// \param duration time in seconds before the deadline expires,
+      ///        infinity for a deadline that only expires when cancelled.
+      void start (value_type duration)
+      {
+        cancelled_ = false;
+        running_ = true;
+        start_ = Clock_t::now ();
+        limited_ = duration < std::numeric_limits <value_type>::infinity ();
+        if (limited_)
+          end_ = start_ + boost::chrono::duration_cast <Clock_t::duration>
+            (boost::chrono::duration <value_type> (duration));
+      }
+      /// Stop the deadline, which does not expire any more
+      void stop ()
+      {
+        cancelled_ = false;
+        running_ = false;
+        limited_ = false;
+      }
+      /// Whether the deadline was started and not stopped
+      bool running () const
+      {
+        return running_;
+      }
+      /// Make the deadline expire now
+      ///
+      /// May be called from another thread.
+      void cancel ()
+      {
+        cancelled_ = true;
+      }
+      /// Whether the deadline was cancelled
+      bool cancelled () const
+      {
+        return cancelled_;
+      }
+      /// Whether the deadline is cancelled or the duration elapsed
+      bool expired () const
+      {
+        return cancelled_ || (limited_ && Clock_t::now () >= end_);
+      }
+      /// Time in seconds since the deadline was started
+      value_type elapsed () const
+      {
+        return boost::chrono::duration <value_type>
+          (Clock_t::now () - start_).count ();
+      }
+      /// Time in seconds before the deadline expires
+      value_type remaining () const
+      {
+        if (cancelled_) return 0;
+        if (!limited_) return std::numeric_limits <value_type>::infinity ();
+        const value_type r (boost::chrono::duration <value_type>
+                            (end_ - Clock_t::now ()).count ());
+        return r > 0 ? r : 0;
+      }
+
+    protected:
+      Deadline () : cancelled_ (false), running_ (false), limited_ (false),
+        start_ (Clock_t::now ()), end_ (start_)
+      {
+      }
+
+    private:
+      volatile bool cancelled_;
+      bool running_;
+      bool limited_;
+      Clock_t::time_point start_;
+      Clock_t::time_point end_;
+    }; // class Deadline
+
+    /// \addtogroup validation
+    /// \{
+
+    /// Validation stopped because a Deadline expired
+    ///
+    /// The validated object is considered invalid.
+    struct HPP_CORE_DLLAPI DeadlineExpired : public ValidationReport
+    {
+      virtual std::ostream& print (std::ostream& os) const
+      {
+        return os << "Deadline expired during validation";
+      }
+    }; // struct DeadlineExpired
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_DEADLINE_HH
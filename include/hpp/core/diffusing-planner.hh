@@ -19,6 +19,9 @@
 #ifndef HPP_CORE_DIFFUSING_PLANNER_HH
 # define HPP_CORE_DIFFUSING_PLANNER_HH
 
+# include <vector>
+
+# include <hpp/core/parameter.hh>
 # include <hpp/core/path-planner.hh>
 
 namespace hpp {
@@ -35,10 +38,40 @@ namespace hpp {
 	(const Problem& problem, const RoadmapPtr_t& roadmap);
       /// Return shared pointer to new object.
       static DiffusingPlannerPtr_t create (const Problem& problem);
+      /// Initialize the problem resolution
+      ///  \li call parent implementation
+      ///  \li set approximation factor of nearest neighbor searches from
+      ///      parameter "NearestNeighbor/approximationFactor".
+      virtual void startSolve ();
       /// One step of extension.
       virtual void oneStep ();
       /// Set configuration shooter.
       void configurationShooter (const ConfigurationShooterPtr_t& shooter);
+      /// Shoot several configurations per step
+      ///
+      /// Each step then
+      /// \li shoots \c numberSamples configurations and projects them on
+      ///     the constraints of the steering method, dropping the samples
+      ///     whose projection fails,
+      /// \li finds the nearest node of each connected component to each
+      ///     sample,
+      /// \li steers, projects and validates the extensions of these nodes
+      ///     toward the samples in \c numberThreads threads,
+      /// \li inserts the extensions in the roadmap and connects the new
+      ///     nodes of each sample as in the single sample step.
+      ///
+      /// Unlike the single sample step, samples are not projected on the
+      /// tangent space of the constraints at the nearest node. Parallel
+      /// extensions are not recorded in \ref statistics.
+      /// \param numberSamples number of samples per step, 1 restores the
+      ///        single sample step,
+      /// \param numberThreads number of threads of the extensions,
+      /// \param factory called once per thread in \ref startSolve, see
+      ///        PathPlanner::parallelConnections. Not used with one thread:
+      ///        the objects of the problem are used.
+      void batch (size_type numberSamples, size_type numberThreads = 1,
+                  const ConnectionToolsFactory_t& factory =
+                  ConnectionToolsFactory_t ());
     protected:
       /// Constructor
       DiffusingPlanner (const Problem& problem, const RoadmapPtr_t& roadmap);
@@ -52,9 +85,48 @@ namespace hpp {
       virtual PathPtr_t extend (const NodePtr_t& near,
 				const Configuration_t& target);
     private:
+      /// Extension of a node toward a sample, see \ref batch
+      struct Extension
+      {
+        Extension (std::size_t s, const NodePtr_t& n) :
+          sample (s), near (n), valid (false)
+        {
+        }
+        /// Index of the sample
+        std::size_t sample;
+        NodePtr_t near;
+        /// Path to the sample, null if steering or projection failed
+        PathPtr_t path;
+        PathPtr_t validPath;
+        bool valid;
+      }; // struct Extension
+      typedef std::vector <Extension> Extensions_t;
+
+      /// One step with several samples, see \ref batch
+      void batchedStep ();
+      /// Compute the extensions begin, begin + step, ...
+      static void extendRange (const ConnectionTools& tools,
+                               const std::vector <Configuration_t>& samples,
+                               value_type stepLength,
+                               Extensions_t& extensions,
+                               std::size_t begin, std::size_t step);
+      /// Connect new nodes together and to the nearest nodes of the other
+      /// connected components
+      void connectNewNodes (const Nodes_t& newNodes,
+                            const Nodes_t& nearestNeighbors);
+
       ConfigurationShooterPtr_t configurationShooter_;
       mutable Configuration_t qProj_;
+      /// \copydoc batch
+      size_type batchSize_;
+      size_type numberThreads_;
+      ConnectionToolsFactory_t factory_;
+      /// Tools of the threads of the batched extensions
+      std::vector <ConnectionTools> tools_;
       DiffusingPlannerWkPtr_t weakPtr_;
+      /// Parameters DiffusingPlanner/extensionStepLength and
+      /// DiffusingPlanner/extensionStepRatio
+      ParameterHandle <value_type> extensionStepLength_, extensionStepRatio_;
     };
     /// \}
   } // namespace core
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_DISTANCE_FIELD_VALIDATION_HH
+# define HPP_CORE_DISTANCE_FIELD_VALIDATION_HH
+
+# include <hpp/core/config-validation.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup validation
+    /// \{
+
+    /// Validate a configuration with respect to obstacles stored in a
+    /// distance field
+    ///
+    /// Each object of the robot bodies is approximated by its bounding
+    /// sphere. A configuration is valid if the lower bound of the distance
+    /// of each sphere to the obstacles, see DistanceField, is above the
+    /// security margin. The test is conservative: configurations where a
+    /// sphere overlaps an obstacle are invalid even if the object does not.
+    ///
+    /// This validation is meant to replace the collision checking of the
+    /// robot with many obstacles built from a voxel map. It is added to a
+    /// problem with Problem::addConfigValidation.
+    /// \sa continuousValidation::DistanceFieldCollision for path
+    ///     validation.
+    class HPP_CORE_DLLAPI DistanceFieldValidation : public ConfigValidation
+    {
+    public:
+      static DistanceFieldValidationPtr_t create
+      (const DevicePtr_t& robot, const DistanceFieldPtr_t& field);
+
+      /// Compute whether the configuration is valid
+      ///
+      /// \param config the config to check for validity,
+      /// \retval validationReport report on validation. If non valid,
+      ///         a CollisionValidationReport the second object of which is
+      ///         null is returned.
+      /// \return whether the whole config is valid.
+      virtual bool validate (const Configuration_t& config,
+			     ValidationReportPtr_t& validationReport);
+
+      /// Set the security margin
+      void securityMargin (value_type margin)
+      {
+        securityMargin_ = margin;
+      }
+      /// Get the security margin
+      value_type securityMargin () const
+      {
+        return securityMargin_;
+      }
+
+    protected:
+      DistanceFieldValidation (const DevicePtr_t& robot,
+                               const DistanceFieldPtr_t& field);
+
+    private:
+      DevicePtr_t robot_;
+      DistanceFieldPtr_t field_;
+      /// Objects of the robot bodies
+      ConstObjectStdVector_t objects_;
+      value_type securityMargin_;
+    }; // class DistanceFieldValidation
+    /// \}
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_DISTANCE_FIELD_VALIDATION_HH
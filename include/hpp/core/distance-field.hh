@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_DISTANCE_FIELD_HH
+# define HPP_CORE_DISTANCE_FIELD_HH
+
+# include <cassert>
+# include <string>
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup validation
+    /// \{
+
+    /// Signed distance to the obstacles sampled on a regular grid
+    ///
+    /// The grid has \c nx x \c ny x \c nz cubic voxels of side
+    /// \ref resolution, starting at \ref origin in the world frame. Each
+    /// voxel stores the signed distance from its center to the obstacles,
+    /// negative inside the obstacles. Space outside of the grid is
+    /// considered free of obstacles.
+    ///
+    /// Since the signed distance is 1-Lipschitz, the value of the voxel
+    /// containing a point minus the distance of the point to the voxel
+    /// center is a lower bound of the distance of the point to the
+    /// obstacles, computed in constant time.
+    class HPP_CORE_DLLAPI DistanceField
+    {
+    public:
+      /// Create a grid the voxels of which are at infinite distance
+      /// \param origin corner of the grid with the lowest coordinates,
+      /// \param resolution side of the voxels, should be positive,
+      /// \param nx, ny, nz number of voxels along each axis.
+      static DistanceFieldPtr_t create (const vector3_t& origin,
+                                        value_type resolution,
+                                        size_type nx, size_type ny,
+                                        size_type nz);
+
+      /// Read a grid written by \ref save
+      /// \throw std::runtime_error if the file cannot be read.
+      static DistanceFieldPtr_t load (const std::string& filename);
+
+      /// Write the grid in a binary file
+      void save (const std::string& filename) const;
+
+      /// Corner of the grid with the lowest coordinates
+      const vector3_t& origin () const
+      {
+        return origin_;
+      }
+      /// Side of the voxels
+      value_type resolution () const
+      {
+        return resolution_;
+      }
+      /// Number of voxels along an axis
+      size_type size (size_type axis) const
+      {
+        return size_ [axis];
+      }
+
+      /// Signed distance at the center of a voxel
+      float value (size_type i, size_type j, size_type k) const
+      {
+        return values_ [index (i, j, k)];
+      }
+      /// Set the signed distance at the center of a voxel
+      void value (size_type i, size_type j, size_type k, float d)
+      {
+        values_ [index (i, j, k)] = d;
+      }
+
+      /// Lower bound of the signed distance of a point to the obstacles
+      /// \param point point in the world frame.
+      value_type distanceLowerBound (const vector3_t& point) const;
+
+      /// Lower bound of the distance of an object to the obstacles
+      /// \param object collision object, approximated by its bounding
+      ///        sphere,
+      /// \param data data resulting from the forward kinematics of the
+      ///        robot holding the object.
+      value_type distanceLowerBound (const CollisionObjectConstPtr_t& object,
+                                     const pinocchio::DeviceData& data) const;
+
+    protected:
+      DistanceField (const vector3_t& origin, value_type resolution,
+                     size_type nx, size_type ny, size_type nz);
+
+    private:
+      std::size_t index (size_type i, size_type j, size_type k) const
+      {
+        assert (0 <= i && i < size_ [0]);
+        assert (0 <= j && j < size_ [1]);
+        assert (0 <= k && k < size_ [2]);
+        return (std::size_t) ((k * size_ [1] + j) * size_ [0] + i);
+      }
+
+      vector3_t origin_;
+      value_type resolution_;
+      size_type size_ [3];
+      /// Values of the voxels, x first
+      std::vector <float> values_;
+    }; // class DistanceField
+    /// \}
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_DISTANCE_FIELD_HH
@@ -56,6 +56,28 @@ namespace hpp {
 	return impl_distance (n1, n2);
       }
 
+      /// Compute the distances of several configurations to a configuration
+      /// \param configurations matrix the columns of which are
+      ///        configurations,
+      /// \param q a configuration,
+      /// \retval distances distances [i] is the distance from
+      ///         configurations.col (i) to q.
+      void compute (matrixIn_t configurations, ConfigurationIn_t q,
+                    vector_t& distances) const
+      {
+        impl_distances (configurations, q, distances);
+      }
+
+      /// Cheap lower bound of the distance between two configurations
+      ///
+      /// Nearest neighbor searches skip the computation of the distance to
+      /// the configurations the lower bound of which exceeds the distance
+      /// of the current best candidates.
+      value_type lowerBound (ConfigurationIn_t q1, ConfigurationIn_t q2) const
+      {
+        return impl_lowerBound (q1, q2);
+      }
+
       virtual DistancePtr_t clone () const = 0;
 
       virtual ~Distance () {};
@@ -71,6 +93,24 @@ namespace hpp {
       {
         return impl_distance (*n1->configuration(), *n2->configuration());
       }
+      /// Derived class may implement this function when the distance is
+      /// expensive. The default implementation returns 0.
+      virtual value_type impl_lowerBound (ConfigurationIn_t,
+                                          ConfigurationIn_t) const
+      {
+        return 0;
+      }
+      /// Derived class may implement this function to share computations
+      /// between configurations. The default implementation calls
+      /// impl_distance for each column.
+      virtual void impl_distances (matrixIn_t configurations,
+                                   ConfigurationIn_t q,
+                                   vector_t& distances) const
+      {
+        distances.resize (configurations.cols ());
+        for (size_type i = 0; i < configurations.cols (); ++i)
+          distances [i] = impl_distance (configurations.col (i), q);
+      }
 
       HPP_SERIALIZABLE();
     }; // class Distance
@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2017 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_DISTANCE_DUBINS_HH
+# define HPP_CORE_DISTANCE_DUBINS_HH
+
+# include <hpp/core/distance.hh>
+# include <hpp/core/steering-method/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    namespace distance {
+      /// \addtogroup steering_method
+      /// \{
+
+      /// Dubins distance
+      ///
+      /// Compute the length of the Dubins path between two configurations of
+      /// a nonholonomic cart-like mobile robot that only goes forward. The
+      /// distance is not symmetric. Paths are not built.
+      class HPP_CORE_DLLAPI Dubins : public Distance
+      {
+      public:
+	virtual DistancePtr_t clone () const;
+	static DubinsPtr_t create (const Problem& problem);
+	static DubinsPtr_t create (const Problem& problem,
+				   const value_type& turningRadius,
+				   JointPtr_t xyJoint, JointPtr_t rzJoint);
+
+	static DubinsPtr_t createCopy (const DubinsPtr_t& distance);
+      protected:
+	Dubins (const Problem& problem);
+	Dubins (const Problem& problem,
+		const value_type& turningRadius,
+		JointPtr_t xyJoint, JointPtr_t rzJoint);
+	Dubins (const Dubins& distance);
+
+	/// Length of the Dubins path from q1 to q2
+	virtual value_type impl_distance (ConfigurationIn_t q1,
+					  ConfigurationIn_t q2) const;
+	/// Distance between the positions of the car
+	virtual value_type impl_lowerBound (ConfigurationIn_t q1,
+					    ConfigurationIn_t q2) const;
+	/// Lengths of the Dubins paths from the columns of configurations
+	/// to q
+	virtual void impl_distances (matrixIn_t configurations,
+				     ConfigurationIn_t q,
+				     vector_t& distances) const;
+	void init (const DubinsWkPtr_t& weak);
+      private:
+	steeringMethod::DubinsPtr_t sm_;
+	DubinsWkPtr_t weak_;
+
+        Dubins() {};
+        HPP_SERIALIZABLE();
+      }; // class Dubins
+    /// \}
+    } // namespace distance
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_DISTANCE_DUBINS_HH
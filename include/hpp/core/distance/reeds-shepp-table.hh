@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2016 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_DISTANCE_REEDS_SHEPP_TABLE_HH
+# define HPP_CORE_DISTANCE_REEDS_SHEPP_TABLE_HH
+
+# include <string>
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    namespace distance {
+      /// \addtogroup steering_method
+      /// \{
+
+      /// Table of the lengths of Reeds and Shepp curves
+      ///
+      /// Lengths are tabulated for a turning radius of 1 on a regular grid
+      /// of the pose (x, y, theta) of the end of the curve in the frame of
+      /// its start, with x and y in [-extent, extent] and theta in
+      /// [-pi, pi]. \ref lowerBound interpolates the grid and subtracts a
+      /// margin: the largest error of the interpolation measured on
+      /// poses sampled between the nodes of the grid when building the
+      /// table. The bound is thus admissible on these samples, and
+      /// approximate elsewhere. Poses outside the grid are bounded by
+      /// their distance to the origin.
+      ///
+      /// Tables are saved to files once, and mapped in memory by
+      /// \ref load, so that processes share the pages of the file.
+      class HPP_CORE_DLLAPI ReedsSheppTable
+      {
+      public:
+        /// Compute the lengths of the nodes of a grid
+        /// \param numberXY number of nodes along x and along y,
+        /// \param numberTheta number of nodes along theta,
+        /// \param extent half width of the grid along x and y.
+        /// \throw std::invalid_argument if a number is smaller than 2 or
+        ///        extent is not positive.
+        static ReedsSheppTablePtr_t create (size_type numberXY,
+                                            size_type numberTheta,
+                                            value_type extent);
+
+        /// Map a table saved by \ref save in memory
+        /// \throw std::runtime_error if the file cannot be mapped or is not
+        ///        a table.
+        static ReedsSheppTablePtr_t load (const std::string& filename);
+
+        /// Save the table in a file
+        ///
+        /// The table is written in a temporary file and renamed, so that
+        /// concurrent processes load either nothing or a complete table.
+        /// \throw std::runtime_error if the file cannot be written.
+        void save (const std::string& filename) const;
+
+        /// Lower bound of the length of the curves to a pose
+        /// \param x, y, theta pose of the end of the curve in the frame of
+        ///        its start, for a turning radius of 1.
+        value_type lowerBound (value_type x, value_type y,
+                               value_type theta) const;
+
+        /// Lower bound of the length of the curves between the poses of
+        /// two configurations
+        /// \param rho turning radius,
+        /// \param xyId, rzId ranks of joints XY and RZ in the configurations.
+        value_type lowerBound (ConfigurationIn_t q1, ConfigurationIn_t q2,
+                               value_type rho, size_type xyId,
+                               size_type rzId) const;
+
+        /// Largest error of the interpolation measured when building
+        value_type margin () const;
+
+        size_type numberXY () const;
+        size_type numberTheta () const;
+        value_type extent () const;
+
+        ~ReedsSheppTable ();
+
+      protected:
+        ReedsSheppTable ();
+
+      private:
+        struct Header;
+
+        /// Node lengths, in the order theta, y, x
+        value_type length (size_type ix, size_type iy, size_type it) const
+        {
+          return lengths_ [(it * numberXY () + iy) * numberXY () + ix];
+        }
+        /// Interpolate the lengths of the nodes around a pose
+        value_type interpolate (value_type x, value_type y,
+                                value_type theta) const;
+
+        const Header* header_;
+        const float* lengths_;
+        /// Storage of tables built in memory
+        std::vector <char> data_;
+        /// Mapping of tables loaded from a file
+        void* map_;
+        std::size_t mapSize_;
+      }; // class ReedsSheppTable
+      /// \}
+    } // namespace distance
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_DISTANCE_REEDS_SHEPP_TABLE_HH
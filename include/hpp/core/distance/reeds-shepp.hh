@@ -42,6 +42,24 @@ namespace hpp {
 				     JointPtr_t xyJoint, JointPtr_t rzJoint);
 
 	static ReedsSheppPtr_t createCopy (const ReedsSheppPtr_t& distance);
+
+        /// Set the table of lengths used by the lower bound
+        ///
+        /// Nearest neighbor searches prune the nodes with the lower bound
+        /// and compute the distance of the remaining candidates only. The
+        /// lower bound tabulated by ReedsSheppTable is much closer to the
+        /// distance than the distance between the positions of the car.
+        /// \param table if null, the distance between the positions is
+        ///        used.
+        void lookupTable (const ReedsSheppTablePtr_t& table)
+        {
+          table_ = table;
+        }
+
+        const ReedsSheppTablePtr_t& lookupTable () const
+        {
+          return table_;
+        }
       protected:
 	ReedsShepp (const Problem& problem);
 	ReedsShepp (const Problem& problem,
@@ -52,9 +70,15 @@ namespace hpp {
 	/// Derived class should implement this function
 	virtual value_type impl_distance (ConfigurationIn_t q1,
 					  ConfigurationIn_t q2) const;
+	/// Interpolation of the lookup table if any, distance between the
+	/// positions of the car otherwise
+	virtual value_type impl_lowerBound (ConfigurationIn_t q1,
+					    ConfigurationIn_t q2) const;
 	void init (const ReedsSheppWkPtr_t& weak);
       private:
 	steeringMethod::ReedsSheppPtr_t sm_;
+        /// Not serialized
+        ReedsSheppTablePtr_t table_;
 	ReedsSheppWkPtr_t weak_;
 
         ReedsShepp() {};
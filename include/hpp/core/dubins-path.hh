@@ -86,6 +86,19 @@ namespace hpp {
                                      const std::vector<JointPtr_t> wheels,
 				     ConstraintSetPtr_t constraints);
 
+      /// Length of the shortest Dubins curve between two configurations,
+      /// without building the path
+      /// \param init, end Start and end configurations,
+      /// \param rho The radius of a turn,
+      /// \param xyId, rzId indices in configuration vector of translation
+      ///                   and rotation of the car.
+      /// \note the length of the motion of the other degrees of freedom is
+      ///       not included.
+      static value_type curveLength (ConfigurationIn_t init,
+                                     ConfigurationIn_t end,
+                                     const value_type& rho,
+                                     size_type xyId, size_type rzId);
+
       /// Create copy and return shared pointer
       /// \param path path to copy
       static DubinsPathPtr_t createCopy (const DubinsPathPtr_t& path)
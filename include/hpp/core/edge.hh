@@ -19,6 +19,8 @@
 #ifndef HPP_CORE_EDGE_HH
 # define HPP_CORE_EDGE_HH
 
+# include <hpp/fcl/BV/AABB.h>
+
 # include <hpp/core/config.hh>
 # include <hpp/core/fwd.hh>
 # include <hpp/util/serialization-fwd.hh>
@@ -32,11 +34,30 @@ namespace hpp {
     ///
     /// Links two nodes and stores a path linking the configurations stored in
     /// the nodes the edge links.
+    ///
+    /// Edges of lazy roadmaps are inserted before their path is validated.
+    /// Such edges do not connect the connected components of the roadmap
+    /// until Roadmap::validateEdge is called.
+    ///
+    /// The path of an edge may also be built on first access, by a steering
+    /// method between the configurations of the nodes: such edges only
+    /// store the steering method until \ref path is called.
     class HPP_CORE_DLLAPI Edge
     {
     public:
       Edge (NodePtr_t n1, NodePtr_t n2, const PathPtr_t& path) :
-	n1_ (n1), n2_ (n2), path_ (path)
+	n1_ (n1), n2_ (n2), path_ (path), cost_ (0), clearance_ (-1),
+        validated_ (true)
+      {
+      }
+      /// Edge the path of which is built on first access
+      /// \param steeringMethod builds the path from n1 to n2 or, if it
+      ///        fails, the reverse of the path from n2 to n1,
+      /// \param cost cost of the edge, see \ref cost.
+      Edge (NodePtr_t n1, NodePtr_t n2,
+            const SteeringMethodPtr_t& steeringMethod, value_type cost) :
+	n1_ (n1), n2_ (n2), steeringMethod_ (steeringMethod), cost_ (cost),
+        clearance_ (-1), validated_ (true)
       {
       }
       NodePtr_t from () const
@@ -47,17 +68,73 @@ namespace hpp {
       {
 	return n2_;
       }
+      /// Path of the edge
+      ///
+      /// Edges created with a steering method build their path at the
+      /// first call.
+      /// \throw std::runtime_error if the steering method fails in both
+      ///        directions.
       PathPtr_t path () const
       {
+        if (steeringMethod_) return steer ();
 	return path_;
       }
+      /// Whether the path of the edge is not built yet
+      bool deferred () const;
+      /// Cost of the edge used by graph searches
+      ///
+      /// The cost is computed once, when the edge is inserted in a roadmap.
+      /// It is the length of the path unless a cost is given to the
+      /// roadmap, see Roadmap::edgeCost. Edges the path of which is built
+      /// on first access keep the cost given at their creation, unless
+      /// the roadmap has a cost, which builds the path.
+      value_type cost () const
+      {
+        return cost_;
+      }
+      /// Clearance of the path of the edge
+      ///
+      /// Set by the planners that validate paths with
+      /// ContinuousValidation::validateWithClearance, see
+      /// Roadmap::clearance. Negative if unknown.
+      /// \note the clearance is not serialized.
+      value_type clearance () const
+      {
+        return clearance_;
+      }
+      /// Axis aligned box containing the robot along the path of the edge
+      ///
+      /// Computed by the ProblemSolver when obstacles change, see
+      /// ProblemSolver::warmStart, and stored with Roadmap::sweptVolume.
+      /// Empty, its lower corner above its upper corner, if unknown.
+      /// \note the swept volume is not serialized.
+      const fcl::AABB& sweptVolume () const
+      {
+        return sweptVolume_;
+      }
+      /// Whether the path of the edge is known to be valid
+      bool validated () const
+      {
+        return validated_;
+      }
 
     protected:
-      Edge() {}
+      Edge() : cost_ (0), clearance_ (-1), validated_ (true) {}
     private:
+      /// Build the path with the steering method if needed
+      PathPtr_t steer () const;
+
       NodePtr_t n1_;
       NodePtr_t n2_;
-      PathPtr_t path_;
+      mutable PathPtr_t path_;
+      /// Builds path_ on first access, null for edges created with a path
+      SteeringMethodPtr_t steeringMethod_;
+      value_type cost_;
+      value_type clearance_;
+      fcl::AABB sweptVolume_;
+      bool validated_;
+
+      friend class Roadmap;
 
       HPP_SERIALIZABLE();
     }; // class Edge
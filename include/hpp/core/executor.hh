@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_EXECUTOR_HH
+# define HPP_CORE_EXECUTOR_HH
+
+# include <vector>
+
+# include <boost/bind.hpp>
+# include <boost/function.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// Pool of threads that run the parallel tasks of a process
+    ///
+    /// Each thread has its own queue of tasks. A thread pops the last task
+    /// of its queue and, when the latter is empty, steals the first task of
+    /// the queue of another thread, trying the threads of its NUMA node
+    /// first. Parallel components submit their tasks to the same executor,
+    /// so that the number of running threads does not exceed the number of
+    /// threads of the executor, whatever the number of components. The
+    /// threads are started by the first call to \ref run.
+    ///
+    /// When threads are pinned, they are spread over the NUMA nodes of the
+    /// system, read in /sys/devices/system/node, and tasks may be queued to
+    /// the threads of one node. Data read by the tasks may be copied on
+    /// each node with NodeReplicas.
+    ///
+    /// \sa ProblemSolver::executor
+    class HPP_CORE_DLLAPI Executor
+    {
+    public:
+      typedef boost::function <void ()> Task_t;
+      typedef std::vector <Task_t> Tasks_t;
+
+      /// Create an executor
+      /// \param numberThreads number of threads of the pool,
+      /// \param pinning whether each thread runs on one processor only.
+      ///        Thread i runs on NUMA node i modulo the number of nodes.
+      ///        Ignored on systems other than Linux.
+      /// \throw std::invalid_argument if numberThreads is not positive.
+      static ExecutorPtr_t create (size_type numberThreads,
+                                   bool pinning = false);
+
+      /// Run tasks in an executor, if any
+      ///
+      /// Equivalent to executor->run (tasks) if executor is not null.
+      /// Otherwise, the tasks run in one thread each.
+      static void run (const ExecutorPtr_t& executor, const Tasks_t& tasks);
+
+      /// Run tasks and wait for their end
+      ///
+      /// Tasks are queued to the threads of the node of the calling thread
+      /// if the latter belongs to the pool, to all the threads otherwise.
+      /// While waiting, the calling thread runs tasks of the queues as
+      /// well. Tasks may thus call run themselves without blocking the
+      /// threads of the pool.
+      /// \throw std::runtime_error with the message of the first exception
+      ///        thrown by a task, once all the tasks are done.
+      void run (const Tasks_t& tasks);
+
+      /// Run tasks in the threads of a NUMA node and wait for their end
+      ///
+      /// Unless the calling thread belongs to the pool and runs some tasks
+      /// while waiting, the tasks run on the processors of the node, and so
+      /// allocate memory on the node.
+      /// \throw std::invalid_argument if node is not smaller than
+      ///        \ref numberNodes.
+      void run (const Tasks_t& tasks, size_type node);
+
+      size_type numberThreads () const
+      {
+        return numberThreads_;
+      }
+
+      bool pinning () const
+      {
+        return pinning_;
+      }
+
+      /// Number of NUMA nodes of the threads
+      ///
+      /// 1 if the threads are not pinned or the system has one node.
+      size_type numberNodes () const;
+
+      /// NUMA node of the processor that runs the calling thread
+      ///
+      /// \return the node, between 0 and \ref numberNodes - 1. 0 if the
+      ///         node of the processor is not known or has no thread.
+      size_type node () const;
+
+      /// Wait for the tasks in the queues and stop the threads
+      ~Executor ();
+
+    protected:
+      Executor (size_type numberThreads, bool pinning);
+
+    private:
+      struct Impl;
+      size_type numberThreads_;
+      bool pinning_;
+      boost::shared_ptr <Impl> impl_;
+    }; // class Executor
+
+    /// Copies of read-mostly data, one per NUMA node of an executor
+    ///
+    /// Each copy is made by a thread of its node, so that, with the first
+    /// touch policy of Linux, the memory allocated by the copy resides on
+    /// the node. \ref get returns the copy of the node of the calling
+    /// thread. T should be copy constructible. Copies are deep only if the
+    /// copy constructor of T is.
+    template <typename T> class NodeReplicas
+    {
+    public:
+      /// Copy a value on each node of an executor
+      /// \param executor if null, a single copy is made.
+      NodeReplicas (const ExecutorPtr_t& executor, const T& value) :
+        executor_ (executor),
+        copies_ (executor ? executor->numberNodes () : 1)
+      {
+        if (copies_.size () == 1) {
+          copies_ [0].reset (new T (value));
+          return;
+        }
+        for (std::size_t i = 0; i < copies_.size (); ++i) {
+          Executor::Tasks_t tasks (1, boost::bind (&NodeReplicas::copy,
+                                                   boost::cref (value),
+                                                   boost::ref (copies_ [i])));
+          executor_->run (tasks, (size_type) i);
+        }
+      }
+
+      /// Copy of the node of the calling thread
+      const T& get () const
+      {
+        if (copies_.size () == 1) return *copies_ [0];
+        return *copies_ [(std::size_t) executor_->node ()];
+      }
+
+      /// Copy of a node
+      const T& get (size_type node) const
+      {
+        return *copies_.at ((std::size_t) node);
+      }
+
+      std::size_t size () const
+      {
+        return copies_.size ();
+      }
+
+    private:
+      static void copy (const T& value, boost::shared_ptr <T>& result)
+      {
+        result.reset (new T (value));
+      }
+
+      ExecutorPtr_t executor_;
+      std::vector <boost::shared_ptr <T> > copies_;
+    }; // class NodeReplicas
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_EXECUTOR_HH
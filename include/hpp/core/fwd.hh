@@ -32,10 +32,13 @@
 
 namespace hpp {
   namespace core {
+    HPP_PREDEF_CLASS (AsyncSolve);
+    HPP_PREDEF_CLASS (BatchCollisionValidation);
     HPP_PREDEF_CLASS (BiRRTPlanner);
     HPP_PREDEF_CLASS (CollisionValidation);
     HPP_PREDEF_CLASS (CollisionValidationReport);
     HPP_PREDEF_CLASS (AllCollisionsValidationReport);
+    HPP_PREDEF_CLASS (CompactRoadmap);
     HPP_PREDEF_CLASS (ConfigurationShooter);
     HPP_PREDEF_CLASS (ConfigProjector);
     HPP_PREDEF_CLASS (ConfigValidation);
@@ -43,15 +46,23 @@ namespace hpp {
     HPP_PREDEF_CLASS (ConnectedComponent);
     HPP_PREDEF_CLASS (Constraint);
     HPP_PREDEF_CLASS (ConstraintSet);
+    HPP_PREDEF_CLASS (Deadline);
     HPP_PREDEF_CLASS (DiffusingPlanner);
     HPP_PREDEF_CLASS (Distance);
     HPP_PREDEF_CLASS (DistanceBetweenObjects);
+    HPP_PREDEF_CLASS (DistanceField);
+    HPP_PREDEF_CLASS (DistanceFieldValidation);
     class Edge;
+    HPP_PREDEF_CLASS (Executor);
     HPP_PREDEF_CLASS (ExtractedPath);
+    HPP_PREDEF_CLASS (HierarchicalRoadmap);
     HPP_PREDEF_CLASS (SubchainPath);
     HPP_PREDEF_CLASS (JointBoundValidation);
     struct JointBoundValidationReport;
+    HPP_PREDEF_CLASS (MappedRoadmap);
+    HPP_PREDEF_CLASS (MultiQuerySolver);
     class Node;
+    HPP_PREDEF_CLASS (OccupancyCache);
     HPP_PREDEF_CLASS (Path);
     HPP_PREDEF_CLASS (TimeParameterization);
     HPP_PREDEF_CLASS (PathOptimizer);
@@ -59,9 +70,15 @@ namespace hpp {
     HPP_PREDEF_CLASS (ProblemTarget);
     HPP_PREDEF_CLASS (PathVector);
     HPP_PREDEF_CLASS (PlanAndOptimize);
+    HPP_PREDEF_CLASS (PlanningService);
+    class PlannerStatistics;
     HPP_PREDEF_CLASS (Problem);
     class ProblemSolver;
+    HPP_PREDEF_CLASS (RandomGenerator);
     HPP_PREDEF_CLASS (Roadmap);
+    HPP_PREDEF_CLASS (RoadmapCheckpoint);
+    HPP_PREDEF_CLASS (SelfCollisionAnalysis);
+    HPP_PREDEF_CLASS (SharedRoadmap);
     HPP_PREDEF_CLASS (SteeringMethod);
     HPP_PREDEF_CLASS (StraightPath);
     HPP_PREDEF_CLASS (InterpolatedPath);
@@ -78,6 +95,8 @@ namespace hpp {
     typedef constraints::ComparisonTypes_t ComparisonTypes_t;
     typedef constraints::ComparisonType ComparisonType;
 
+    typedef boost::shared_ptr <BatchCollisionValidation>
+    BatchCollisionValidationPtr_t;
     typedef boost::shared_ptr <BiRRTPlanner> BiRRTPlannerPtr_t;
     typedef hpp::pinocchio::Body Body;
     typedef hpp::pinocchio::BodyPtr_t BodyPtr_t;
@@ -100,6 +119,8 @@ namespace hpp {
     typedef std::vector <ConfigurationPtr_t> Configurations_t;
     typedef Configurations_t::iterator ConfigIterator_t;
     typedef Configurations_t::const_iterator ConfigConstIterator_t;
+    typedef boost::shared_ptr <AsyncSolve> AsyncSolvePtr_t;
+    typedef boost::shared_ptr <CompactRoadmap> CompactRoadmapPtr_t;
     typedef boost::shared_ptr <ConfigurationShooter> ConfigurationShooterPtr_t;
     typedef boost::shared_ptr <ConfigProjector> ConfigProjectorPtr_t;
     typedef boost::shared_ptr <ConfigValidation> ConfigValidationPtr_t;
@@ -110,6 +131,7 @@ namespace hpp {
     typedef boost::shared_ptr <ConstraintSet> ConstraintSetPtr_t;
     typedef boost::shared_ptr <const ConstraintSet> ConstraintSetConstPtr_t;
     typedef std::vector<ConstraintPtr_t> Constraints_t;
+    typedef boost::shared_ptr <Deadline> DeadlinePtr_t;
     typedef pinocchio::Device Device_t;
     typedef pinocchio::DevicePtr_t DevicePtr_t;
     typedef pinocchio::DeviceWkPtr_t DeviceWkPtr_t;
@@ -122,10 +144,15 @@ namespace hpp {
     typedef boost::shared_ptr <Distance> DistancePtr_t;
     typedef boost::shared_ptr <DistanceBetweenObjects>
     DistanceBetweenObjectsPtr_t;
+    typedef boost::shared_ptr <DistanceField> DistanceFieldPtr_t;
+    typedef boost::shared_ptr <DistanceFieldValidation>
+    DistanceFieldValidationPtr_t;
     typedef pinocchio::DistanceResults_t DistanceResults_t;
     typedef Edge* EdgePtr_t;
     typedef std::list <Edge*> Edges_t;
+    typedef boost::shared_ptr <Executor> ExecutorPtr_t;
     typedef boost::shared_ptr <ExtractedPath> ExtractedPathPtr_t;
+    typedef boost::shared_ptr <HierarchicalRoadmap> HierarchicalRoadmapPtr_t;
     typedef boost::shared_ptr <SubchainPath> SubchainPathPtr_t;
     typedef pinocchio::JointJacobian_t JointJacobian_t;
     typedef pinocchio::Joint Joint;
@@ -160,7 +187,10 @@ namespace hpp {
     typedef Eigen::BlockIndex BlockIndex;
     typedef constraints::segment_t segment_t;
     typedef constraints::segments_t segments_t;
+    typedef boost::shared_ptr <MappedRoadmap> MappedRoadmapPtr_t;
+    typedef boost::shared_ptr <MultiQuerySolver> MultiQuerySolverPtr_t;
     typedef Node* NodePtr_t;
+    typedef boost::shared_ptr <OccupancyCache> OccupancyCachePtr_t;
     typedef std::list <NodePtr_t> Nodes_t;
     typedef std::vector <NodePtr_t> NodeVector_t;
     typedef pinocchio::ObjectVector_t ObjectVector_t;
@@ -176,9 +206,15 @@ namespace hpp {
     typedef boost::shared_ptr <PathVector> PathVectorPtr_t;
     typedef boost::shared_ptr <const PathVector> PathVectorConstPtr_t;
     typedef boost::shared_ptr <PlanAndOptimize> PlanAndOptimizePtr_t;
+    typedef boost::shared_ptr <PlanningService> PlanningServicePtr_t;
     typedef boost::shared_ptr <Problem> ProblemPtr_t;
     typedef ProblemSolver* ProblemSolverPtr_t;
+    typedef boost::shared_ptr <RandomGenerator> RandomGeneratorPtr_t;
     typedef boost::shared_ptr <Roadmap> RoadmapPtr_t;
+    typedef boost::shared_ptr <RoadmapCheckpoint> RoadmapCheckpointPtr_t;
+    typedef boost::shared_ptr <SelfCollisionAnalysis>
+    SelfCollisionAnalysisPtr_t;
+    typedef boost::shared_ptr <SharedRoadmap> SharedRoadmapPtr_t;
     typedef boost::shared_ptr <StraightPath> StraightPathPtr_t;
     typedef boost::shared_ptr <const StraightPath> StraightPathConstPtr_t;
     typedef boost::shared_ptr <ReedsSheppPath> ReedsSheppPathPtr_t;
@@ -202,6 +238,7 @@ namespace hpp {
     typedef pinocchio::vectorIn_t vectorIn_t;
     typedef pinocchio::vectorOut_t vectorOut_t;
     typedef Eigen::Matrix<value_type, 1, Eigen::Dynamic> rowvector_t;
+    typedef Eigen::Array<bool, Eigen::Dynamic, 1> ArrayXb;
     typedef boost::shared_ptr <VisibilityPrmPlanner> VisibilityPrmPlannerPtr_t;
     typedef boost::shared_ptr <ValidationReport> ValidationReportPtr_t;
     typedef boost::shared_ptr <WeighedDistance> WeighedDistancePtr_t;
@@ -233,22 +270,33 @@ namespace hpp {
     namespace continuousValidation {
       HPP_PREDEF_CLASS (Dichotomy);
       typedef boost::shared_ptr <Dichotomy> DichotomyPtr_t;
+      HPP_PREDEF_CLASS (Hierarchical);
+      typedef boost::shared_ptr <Hierarchical> HierarchicalPtr_t;
       HPP_PREDEF_CLASS (Progressive);
       typedef boost::shared_ptr <Progressive> ProgressivePtr_t;
       HPP_PREDEF_CLASS (BodyPairCollision);
       typedef boost::shared_ptr <BodyPairCollision> BodyPairCollisionPtr_t;
       typedef std::vector <BodyPairCollisionPtr_t> BodyPairCollisions_t;
+      HPP_PREDEF_CLASS (DistanceFieldCollision);
+      typedef boost::shared_ptr <DistanceFieldCollision>
+      DistanceFieldCollisionPtr_t;
       HPP_PREDEF_CLASS (IntervalValidation);
       typedef boost::shared_ptr <IntervalValidation> IntervalValidationPtr_t;
       typedef std::vector <IntervalValidationPtr_t> IntervalValidations_t;
       HPP_PREDEF_CLASS (SolidSolidCollision);
       typedef boost::shared_ptr <SolidSolidCollision> SolidSolidCollisionPtr_t;
+      HPP_PREDEF_CLASS (VelocityBounds);
+      typedef boost::shared_ptr <VelocityBounds> VelocityBoundsPtr_t;
     } // namespace continuousValidation
 
 
     namespace distance {
+      HPP_PREDEF_CLASS (Dubins);
+      typedef boost::shared_ptr <Dubins> DubinsPtr_t;
       HPP_PREDEF_CLASS (ReedsShepp);
       typedef boost::shared_ptr <ReedsShepp> ReedsSheppPtr_t;
+      HPP_PREDEF_CLASS (ReedsSheppTable);
+      typedef boost::shared_ptr <ReedsSheppTable> ReedsSheppTablePtr_t;
     } // namespace distance
 
     class NearestNeighbor;
@@ -275,6 +323,10 @@ namespace hpp {
       typedef boost::shared_ptr <PartialShortcut> PartialShortcutPtr_t;
       HPP_PREDEF_CLASS (SimpleTimeParameterization);
       typedef boost::shared_ptr <SimpleTimeParameterization> SimpleTimeParameterizationPtr_t;
+      HPP_PREDEF_CLASS (TOPPRA);
+      typedef boost::shared_ptr <TOPPRA> TOPPRAPtr_t;
+      HPP_PREDEF_CLASS (MultiStart);
+      typedef boost::shared_ptr <MultiStart> MultiStartPtr_t;
       HPP_PREDEF_CLASS (ConfigOptimization);
       typedef boost::shared_ptr <ConfigOptimization>
         ConfigOptimizationPtr_t;
@@ -283,6 +335,10 @@ namespace hpp {
     namespace pathPlanner {
       HPP_PREDEF_CLASS (kPrmStar);
       typedef boost::shared_ptr <kPrmStar> kPrmStarPtr_t;
+      HPP_PREDEF_CLASS (ParallelBiRRT);
+      typedef boost::shared_ptr <ParallelBiRRT> ParallelBiRRTPtr_t;
+      HPP_PREDEF_CLASS (Portfolio);
+      typedef boost::shared_ptr <Portfolio> PortfolioPtr_t;
     } // namespace pathPlanner
 
     HPP_PREDEF_CLASS (PathValidations);
@@ -290,8 +346,13 @@ namespace hpp {
     typedef boost::shared_ptr <PathValidation> PathValidationPtr_t;
     typedef boost::shared_ptr <PathValidations> PathValidationsPtr_t;
     namespace pathValidation {
+      HPP_PREDEF_CLASS (Cached);
+      typedef boost::shared_ptr <Cached> CachedPtr_t;
       HPP_PREDEF_CLASS (Discretized);
       typedef boost::shared_ptr <Discretized> DiscretizedPtr_t;
+      HPP_PREDEF_CLASS (AdaptiveDiscretized);
+      typedef boost::shared_ptr <AdaptiveDiscretized>
+      AdaptiveDiscretizedPtr_t;
     } // namespace pathValidation
     // Path validation reports
     struct PathValidationReport;
@@ -336,6 +397,16 @@ namespace hpp {
       typedef boost::shared_ptr < Uniform > UniformPtr_t;
       HPP_PREDEF_CLASS (Gaussian);
       typedef boost::shared_ptr < Gaussian > GaussianPtr_t;
+      HPP_PREDEF_CLASS (Informed);
+      typedef boost::shared_ptr < Informed > InformedPtr_t;
+      HPP_PREDEF_CLASS (BridgeTest);
+      typedef boost::shared_ptr < BridgeTest > BridgeTestPtr_t;
+      HPP_PREDEF_CLASS (GoalBiased);
+      typedef boost::shared_ptr < GoalBiased > GoalBiasedPtr_t;
+      HPP_PREDEF_CLASS (Halton);
+      typedef boost::shared_ptr < Halton > HaltonPtr_t;
+      HPP_PREDEF_CLASS (Projected);
+      typedef boost::shared_ptr < Projected > ProjectedPtr_t;
     } // namespace configurationShooter
 
     /// Plane polygon represented by its vertices
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_HIERARCHICAL_ROADMAP_HH
+# define HPP_CORE_HIERARCHICAL_ROADMAP_HH
+
+# include <map>
+# include <set>
+# include <utility>
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup roadmap
+    /// \{
+
+    /// Coarse to fine roadmap for robots moving in large workspaces
+    ///
+    /// The coarse level is a grid of square regions over the position of
+    /// the base of the robot, the first two configuration variables,
+    /// within their bounds. Regions are not stored until a query goes
+    /// through them.
+    ///
+    /// A query is first routed through the grid by an A* search between
+    /// the regions of its start and goal configurations. Only the regions
+    /// on the route are then refined: configurations with the base in the
+    /// region are sampled, validated and connected to their nearest nodes
+    /// in a fine Roadmap shared by all the regions refined so far, so that
+    /// neighbor regions are connected to each other. The query is solved
+    /// by an A* search in the fine roadmap if its start and goal nodes are
+    /// in connected components that reach each other. Otherwise, the first
+    /// move between two regions of the route that the fine roadmap does not
+    /// achieve is forbidden and the query is routed again.
+    ///
+    /// Query time thus depends on the length of the route, not on the size
+    /// of the workspace. Memory is bounded by \ref maxRegions: the fine
+    /// roadmap is cleared when refining a route would exceed it. The
+    /// forbidden moves are kept.
+    class HPP_CORE_DLLAPI HierarchicalRoadmap
+    {
+    public:
+      /// Region of the grid, as indices along the two base axes
+      typedef std::pair <size_type, size_type> Region_t;
+      typedef std::vector <Region_t> Regions_t;
+
+      /// Create a hierarchical roadmap
+      /// \param regionSize length of the side of the regions.
+      /// \throw std::invalid_argument if regionSize is not positive or if
+      ///        the robot has less than two configuration variables.
+      static HierarchicalRoadmapPtr_t create (const Problem& problem,
+                                              value_type regionSize);
+
+      /// Set the number of configurations sampled in each region
+      void samplesPerRegion (size_type n)
+      {
+        samplesPerRegion_ = n;
+      }
+      /// Set the number of nodes each new node is connected to
+      void numberNeighbors (size_type k)
+      {
+        numberNeighbors_ = k;
+      }
+      /// Set the maximal number of regions refined at once
+      void maxRegions (size_type n)
+      {
+        maxRegions_ = n;
+      }
+      /// Set the maximal number of routes tried by a query
+      void maxRoutes (size_type n)
+      {
+        maxRoutes_ = n;
+      }
+
+      /// Solve a query
+      /// \return a path from start to goal, or a null pointer if no route
+      ///         of the grid could be refined into a path.
+      PathVectorPtr_t solve (const Configuration_t& start,
+                             const Configuration_t& goal);
+
+      /// Region of a configuration
+      Region_t region (const Configuration_t& configuration) const;
+
+      /// Route through the grid between two regions
+      /// \return the regions from start to goal, empty if the moves
+      ///         forbidden so far disconnect them.
+      Regions_t route (const Region_t& start, const Region_t& goal) const;
+
+      /// Fine roadmap of the regions refined so far
+      const RoadmapPtr_t& roadmap () const
+      {
+        return roadmap_;
+      }
+      /// Number of regions refined in the fine roadmap
+      std::size_t numberRegions () const
+      {
+        return nodes_.size ();
+      }
+      /// Whether the move from a region to a neighbor one is forbidden
+      bool forbidden (const Region_t& from, const Region_t& to) const
+      {
+        return forbidden_.count (Move_t (from, to)) > 0;
+      }
+
+    protected:
+      HierarchicalRoadmap (const Problem& problem, value_type regionSize);
+
+    private:
+      typedef std::pair <Region_t, Region_t> Move_t;
+
+      /// Sample a region and connect the new nodes to the fine roadmap
+      void refine (const Region_t& region);
+      /// Add a node and connect it to its nearest nodes
+      NodePtr_t insert (const Configuration_t& configuration);
+      /// Project and validate a path
+      /// \return the projected path, or a null pointer if it is not valid.
+      PathPtr_t validate (const PathPtr_t& path) const;
+      /// Whether a region of the grid is within the bounds of the base
+      bool inBounds (const Region_t& region) const;
+      /// Position of the center of a region along an axis
+      value_type center (size_type index, std::size_t axis) const;
+
+      const Problem& problem_;
+      value_type regionSize_;
+      /// Bounds of the two base variables
+      value_type lower_ [2], upper_ [2];
+      size_type samplesPerRegion_;
+      size_type numberNeighbors_;
+      size_type maxRegions_;
+      size_type maxRoutes_;
+      RoadmapPtr_t roadmap_;
+      /// Nodes of each refined region
+      std::map <Region_t, NodeVector_t> nodes_;
+      /// Moves between neighbor regions the fine roadmap failed to achieve
+      std::set <Move_t> forbidden_;
+    }; // class HierarchicalRoadmap
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_HIERARCHICAL_ROADMAP_HH
@@ -163,26 +163,47 @@ namespace hpp {
       DevicePtr_t device () const;
 
       /// Insert interpolation point
-      void insert (const value_type& time, ConfigurationIn_t config)
-      {
-        configs_.insert (InterpolationPoint_t (time, config));
-      }
+      ///
+      /// Nothing is done if there is already a point at this time.
+      void insert (const value_type& time, ConfigurationIn_t config);
 
       /// Get the initial configuration
       Configuration_t initial () const
       {
-        return configs_.begin ()->second;
+        return interpolationConfig (0);
       }
 
       /// Get the final configuration
       Configuration_t end () const
       {
-        return configs_.rbegin ()->second;
+        return interpolationConfig (points_->times.size () - 1);
+      }
+
+      /// Get the interpolation points
+      /// \note the points are stored in contiguous arrays. This builds a
+      ///       map from them, prefer \ref interpolationTimes and
+      ///       \ref interpolationConfig.
+      InterpolationPoints_t interpolationPoints () const;
+
+      /// Number of interpolation points
+      std::size_t numberInterpolationPoints () const
+      {
+        return points_->times.size ();
       }
 
-      const InterpolationPoints_t& interpolationPoints () const
+      /// Sorted times of the interpolation points
+      const std::vector <value_type>& interpolationTimes () const
       {
-        return configs_;
+        return points_->times;
+      }
+
+      /// Configuration of an interpolation point
+      /// \param rank rank of the point, in increasing time order.
+      ConfigurationIn_t interpolationConfig (std::size_t rank) const
+      {
+        assert (rank < points_->times.size ());
+        return Eigen::Map <const Configuration_t>
+          (&points_->configs [rank * outputSize ()], outputSize ());
       }
 
     protected:
@@ -232,8 +253,22 @@ namespace hpp {
       /// See Path::extract
       PathPtr_t impl_extract (const interval_t& subInterval) const;
     private:
+      /// Rank i of the segment between interpolation points i and i+1
+      /// where the path is evaluated at param.
+      std::size_t segmentAtParam (const value_type& param) const;
+
+      /// Interpolation points
+      ///
+      /// They are shared by the copies of the path and copied on insertion.
+      struct Points {
+        /// Sorted times of the interpolation points
+        std::vector <value_type> times;
+        /// Configurations of the interpolation points, one after the other.
+        std::vector <value_type> configs;
+      };
+
       DevicePtr_t device_;
-      InterpolationPoints_t configs_;
+      boost::shared_ptr <Points> points_;
       InterpolatedPathWkPtr_t weak_;
     }; // class InterpolatedPath
     /// \}
@@ -82,9 +82,24 @@ namespace hpp {
       /// \return whether the whole config is valid.
       bool validate (const Configuration_t& config,
 		     ValidationReportPtr_t& validationReport);
+
+      /// Whether a path is within the joint bounds, computed without sampling
+      ///
+      /// Paths of robots whose configuration space is a vector space are
+      /// certified when they have no constraints and they are
+      /// \li straight paths with both ends within bounds,
+      /// \li splines in Bernstein basis with all their control points
+      ///     within bounds, since splines lie in the convex hull of their
+      ///     control points,
+      /// \li path vectors of such paths.
+      /// \sa ConfigValidation::certifies
+      virtual bool certifies (const PathPtr_t& path) const;
     protected:
       JointBoundValidation (const DevicePtr_t& robot);
     private:
+      /// Whether a configuration is within the joint bounds
+      bool withinBounds (ConfigurationIn_t config) const;
+
       DevicePtr_t robot_;
     }; // class ConfigValidation
     /// \}
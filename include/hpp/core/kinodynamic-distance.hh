@@ -57,14 +57,28 @@ protected:
     /// Derived class should implement this function
     virtual value_type impl_distance (ConfigurationIn_t q1,
                                       ConfigurationIn_t q2) const;
+    /// Time needed to change the positions at the maximal velocity and the
+    /// velocities at the maximal acceleration, the largest over the axes.
+    virtual value_type impl_lowerBound (ConfigurationIn_t q1,
+                                        ConfigurationIn_t q2) const;
+    /// Solve each axis for all the configurations at once
+    virtual void impl_distances (matrixIn_t configurations,
+                                 ConfigurationIn_t q,
+                                 vector_t& distances) const;
 
     double computeMinTime(double p1, double p2, double v1, double v2)const ;
 
 
 private:
+    typedef Eigen::Array<value_type, 3, 1> Array3;
+    /// Store the bounds of each axis and their inverses.
+    void computeBounds ();
+
     DevicePtr_t robot_;
     double aMax_;
     double vMax_;
+    /// Bounds of the three axes and their inverses, see computeBounds.
+    Array3 aMax3_, vMax3_, invAMax3_, invVMax3_;
     KinodynamicDistanceWkPtr_t weak_;
 }; // class KinodynamicDistance
 /// \}
@@ -125,7 +125,12 @@ namespace hpp {
       {
         return createCopy (weak_.lock (), constraints);
       }
-      
+
+      /// Kinodynamic paths cannot be run backward, return an empty path
+      virtual PathPtr_t reversedView () const
+      {
+        return reverse ();
+      }
       
       /// Extraction/Reversion of a sub-path
       /// \param subInterval interval of definition of the extract path
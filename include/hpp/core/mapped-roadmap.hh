@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_MAPPED_ROADMAP_HH
+# define HPP_CORE_MAPPED_ROADMAP_HH
+
+# include <string>
+# include <vector>
+
+# include <boost/cstdint.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup roadmap
+    /// \{
+
+    /// Read only roadmap mapped in memory from a binary file
+    ///
+    /// The file stores, in native byte order and aligned on 8 bytes:
+    /// \li the configurations of the nodes,
+    /// \li the validated edges in compressed sparse rows with their costs,
+    ///     as in CompactRoadmap,
+    /// \li the connected component of each node and the reachability
+    ///     between components,
+    /// \li a nearest neighbor index: the distances of each node to a few
+    ///     pivot nodes, chosen farthest from each other.
+    ///
+    /// Loading maps the file in memory without reading it, so that the
+    /// operating system reads pages on first access. The paths of the
+    /// edges are not stored: each is rebuilt by the steering method of the
+    /// problem the first time it is requested, and kept afterwards.
+    ///
+    /// \note the nearest neighbor search prunes nodes with the triangle
+    ///       inequality, so that it is exact only for symmetric distances
+    ///       satisfying it, like WeighedDistance. Save with no pivot to
+    ///       search all the nodes with other distances.
+    class HPP_CORE_DLLAPI MappedRoadmap
+    {
+    public:
+      /// Ids of edges along a path
+      typedef std::vector <size_type> EdgeIds_t;
+      typedef Eigen::Map <const Configuration_t> ConfigurationMap_t;
+
+      /// Version of the file format written by \ref save
+      static const boost::uint32_t fileVersion = 1;
+
+      /// Write a roadmap in a file
+      /// \param roadmap the roadmap. Edges that are not validated are not
+      ///        written.
+      /// \param filename name of the file,
+      /// \param numberPivots number of pivot nodes of the nearest neighbor
+      ///        index, computed with the distance of the roadmap.
+      /// \throw std::runtime_error if the file cannot be written.
+      static void save (const RoadmapPtr_t& roadmap,
+                        const std::string& filename,
+                        size_type numberPivots = 8);
+
+      /// Map a file written by \ref save
+      /// \param filename name of the file,
+      /// \param problem the steering method of the problem rebuilds the
+      ///        paths of the edges, its distance is used by
+      ///        \ref nearestNode. The problem must outlive the roadmap.
+      /// \throw std::runtime_error if the file cannot be mapped, is not a
+      ///        roadmap of the current version, or does not match the
+      ///        configuration size of the robot.
+      static MappedRoadmapPtr_t load (const std::string& filename,
+                                      const Problem& problem);
+
+      /// Number of nodes
+      size_type numberNodes () const
+      {
+        return numberNodes_;
+      }
+      /// Number of edges
+      size_type numberEdges () const
+      {
+        return numberEdges_;
+      }
+      /// Configuration of a node
+      ConfigurationMap_t configuration (size_type node) const
+      {
+        return ConfigurationMap_t (configurations_ + node * configSize_,
+                                   configSize_);
+      }
+      /// Id of the first out edge of a node
+      size_type edgeBegin (size_type node) const
+      {
+        return (size_type) offsets_ [node];
+      }
+      /// Id following the last out edge of a node
+      size_type edgeEnd (size_type node) const
+      {
+        return (size_type) offsets_ [node + 1];
+      }
+      /// Id of the node an edge comes from
+      size_type source (size_type edge) const
+      {
+        return (size_type) sources_ [edge];
+      }
+      /// Id of the node an edge goes to
+      size_type target (size_type edge) const
+      {
+        return (size_type) targets_ [edge];
+      }
+      /// Cost of an edge, see Edge::cost
+      value_type cost (size_type edge) const
+      {
+        return costs_ [edge];
+      }
+      /// Id of the connected component of a node
+      size_type connectedComponent (size_type node) const
+      {
+        return (size_type) components_ [node];
+      }
+      /// Whether a node can be reached from another one
+      bool canReach (size_type from, size_type to) const
+      {
+        return reachability_ [components_ [from] * numberComponents_ +
+                              components_ [to]] != 0;
+      }
+
+      /// Path of an edge
+      ///
+      /// The path is computed by the steering method at the first call and
+      /// kept for the next ones.
+      /// \throw std::runtime_error if the steering method fails.
+      PathPtr_t path (size_type edge) const;
+
+      /// Nearest node of a configuration
+      /// \retval distance distance to the nearest node,
+      /// \return id of the nearest node, -1 if the roadmap is empty.
+      size_type nearestNode (ConfigurationIn_t configuration,
+                             value_type& distance) const;
+
+      /// Shortest path between two nodes
+      /// \sa CompactRoadmap::shortestPath
+      bool shortestPath (size_type from, size_type to, EdgeIds_t& edges) const;
+
+      /// Concatenate the paths of a sequence of edges
+      /// \param edges ids of the edges, must not be empty.
+      PathVectorPtr_t pathVector (const EdgeIds_t& edges) const;
+
+    protected:
+      /// Constructor
+      MappedRoadmap (const std::string& filename, const Problem& problem);
+
+    private:
+      struct Storage;
+
+      boost::shared_ptr <Storage> storage_;
+      SteeringMethodPtr_t steeringMethod_;
+      DistancePtr_t distance_;
+
+      size_type configSize_;
+      size_type numberNodes_;
+      size_type numberEdges_;
+      size_type numberComponents_;
+      size_type numberPivots_;
+
+      // Arrays in the mapped file
+      const double* configurations_;
+      const boost::int64_t* offsets_;
+      const boost::int64_t* sources_;
+      const boost::int64_t* targets_;
+      const double* costs_;
+      const boost::int64_t* components_;
+      const boost::uint8_t* reachability_;
+      const boost::int64_t* pivots_;
+      /// Distances of each node to the pivots, by rows of numberPivots_
+      const double* pivotDistances_;
+    }; // class MappedRoadmap
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_MAPPED_ROADMAP_HH
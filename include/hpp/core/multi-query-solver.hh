@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_MULTI_QUERY_SOLVER_HH
+# define HPP_CORE_MULTI_QUERY_SOLVER_HH
+
+# include <utility>
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup roadmap
+    /// \{
+
+    /// Solve many path planning queries in a prebuilt roadmap
+    ///
+    /// Each start and goal configuration is connected to its nearest nodes
+    /// in the roadmap with the steering method, the path projector and the
+    /// path validation of the problem. The connections are not inserted in
+    /// the roadmap. Queries are then solved in a CompactRoadmap copy of the
+    /// roadmap: one Dijkstra search is run per distinct start
+    /// configuration and serves all the queries sharing it. The searches
+    /// run in parallel.
+    ///
+    /// Connections are weighed by the length of their path, roadmap edges
+    /// by Edge::cost.
+    ///
+    /// Solvers of different problems can share a SharedRoadmap, since the
+    /// connections of each solver are kept out of it.
+    /// \note The roadmap must not be modified after the creation of the
+    ///       solver.
+    class HPP_CORE_DLLAPI MultiQuerySolver
+    {
+    public:
+      /// Start and goal configurations
+      typedef std::pair <Configuration_t, Configuration_t> Query_t;
+      typedef std::vector <Query_t> Queries_t;
+
+      /// Create a solver and freeze the roadmap
+      static MultiQuerySolverPtr_t create (const Problem& problem,
+                                           const RoadmapPtr_t& roadmap);
+
+      /// Create a solver in a shared roadmap
+      static MultiQuerySolverPtr_t create (const Problem& problem,
+                                           const SharedRoadmapPtr_t& roadmap);
+
+      /// Set the number of roadmap nodes each configuration is connected to
+      void numberNeighbors (size_type k)
+      {
+        numberNeighbors_ = k;
+      }
+      /// Set the number of threads of the graph searches
+      void numberThreads (size_type n)
+      {
+        numberThreads_ = n;
+      }
+      /// Set the executor of the graph searches
+      ///
+      /// If null, which is the default, each thread of the graph searches
+      /// is created by \ref solve.
+      void executor (const ExecutorPtr_t& executor)
+      {
+        executor_ = executor;
+      }
+
+      /// Solve queries
+      /// \return the path of each query, or a null pointer if the query
+      ///         has no solution.
+      std::vector <PathVectorPtr_t> solve (const Queries_t& queries) const;
+
+    protected:
+      MultiQuerySolver (const Problem& problem,
+                        const SharedRoadmapPtr_t& roadmap);
+
+    private:
+      struct Connection;
+      struct Search;
+      typedef std::vector <Connection> Connections_t;
+
+      /// Connect each configuration to its nearest nodes in the roadmap
+      /// \param toRoadmap whether paths go from the configurations to the
+      ///        roadmap or from the roadmap to the configurations.
+      std::vector <Connections_t> connect
+      (const std::vector <Configuration_t>& configurations,
+       bool toRoadmap) const;
+
+      /// Project and validate a path
+      /// \return the projected path, or a null pointer if it is not valid.
+      PathPtr_t validate (const PathPtr_t& path) const;
+
+      const Problem& problem_;
+      SharedRoadmapPtr_t roadmap_;
+      size_type numberNeighbors_;
+      size_type numberThreads_;
+      ExecutorPtr_t executor_;
+    }; // class MultiQuerySolver
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_MULTI_QUERY_SOLVER_HH
@@ -19,7 +19,11 @@
 #ifndef HPP_CORE_NEAREST_NEIGHBOR_HH
 # define HPP_CORE_NEAREST_NEIGHBOR_HH
 
+# include <stdexcept>
+# include <vector>
+
 # include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
 # include <hpp/util/serialization-fwd.hh>
 
 namespace hpp {
@@ -31,6 +35,28 @@ namespace hpp {
       virtual void clear () = 0;
       virtual void addNode (const NodePtr_t& node) = 0;
 
+      /// Add several nodes
+      ///
+      /// The default implementation calls addNode for each node.
+      /// Implementations may index the nodes in one pass.
+      virtual void addNodes (const NodeVector_t& nodes)
+      {
+        for (NodeVector_t::const_iterator it = nodes.begin ();
+             it != nodes.end (); ++it)
+          addNode (*it);
+      }
+
+      /// Remove a node
+      ///
+      /// The connected component of the node should keep other nodes.
+      /// The default implementation throws: implementations that do not
+      /// support removal cannot be used with Roadmap::prune.
+      virtual void removeNode (const NodePtr_t& /*node*/)
+      {
+        throw std::logic_error ("This nearest neighbor structure does not "
+                                "support node removal.");
+      }
+
       /**
        * @brief search Return the closest node of the given configuration
        * @param configuration
@@ -51,6 +77,35 @@ namespace hpp {
 				connectedComponent,
 			       value_type& distance) = 0;
 
+      /// Return the nearest node of each connected component
+      /// \param configuration the configuration to which distances are
+      ///        computed,
+      /// \param connectedComponents the connected components,
+      /// \retval distances distances to the nearest node of each connected
+      ///         component,
+      /// \param reverse see search.
+      /// \return the nearest node of each connected component, in the
+      ///         order of \c connectedComponents.
+      ///
+      /// The default implementation calls search for each connected
+      /// component.
+      virtual NodeVector_t searchInConnectedComponents
+      (const Configuration_t& configuration,
+       const ConnectedComponents_t& connectedComponents,
+       vector_t& distances, bool reverse = false)
+      {
+        NodeVector_t result;
+        result.reserve (connectedComponents.size ());
+        distances.resize (connectedComponents.size ());
+        size_type i = 0;
+        for (ConnectedComponents_t::const_iterator itcc
+               (connectedComponents.begin ());
+             itcc != connectedComponents.end (); ++itcc, ++i)
+          result.push_back (search (configuration, *itcc, distances [i],
+                                    reverse));
+        return result;
+      }
+
       /// \param[out] distance to the Kth closest neighbor
       /// \return the K nearest neighbors
       virtual Nodes_t KnearestSearch (const Configuration_t& configuration,
@@ -77,12 +132,55 @@ namespace hpp {
                                       const std::size_t K,
 			              value_type& distance) = 0;
 
+      /// Return the K nearest nodes in the whole roadmap of several
+      /// configurations
+      /// \param configurations matrix the columns of which are the
+      ///        configurations to which distances are computed,
+      /// \param roadmap in which nodes are searched,
+      /// \param K the number of nearest neighbors to return
+      /// \retval distances distance to the Kth closest neighbor of each
+      ///         configuration,
+      /// \return the K nearest neighbors of each configuration.
+      ///
+      /// The default implementation calls KnearestSearch for each column.
+      virtual std::vector <Nodes_t> KnearestSearch
+      (const matrix_t& configurations, const RoadmapPtr_t& roadmap,
+       const std::size_t K, vector_t& distances)
+      {
+        std::vector <Nodes_t> result ((std::size_t) configurations.cols ());
+        distances.resize (configurations.cols ());
+        for (size_type i = 0; i < configurations.cols (); ++i) {
+          result [i] = KnearestSearch (Configuration_t (configurations.col (i)),
+                                       roadmap, K, distances [i]);
+        }
+        return result;
+      }
+
       /// \return all the nodes closer than \c maxDistance to \c configuration
       /// within \c connectedComponent.
       virtual NodeVector_t withinBall (const Configuration_t& configuration,
 			               const ConnectedComponentPtr_t& cc,
 			               value_type maxDistance) = 0;
 
+      /// \return the \c maxNodes nodes closest to \c configuration among
+      /// the nodes closer than \c maxDistance within \c connectedComponent,
+      /// sorted by increasing distance.
+      ///
+      /// The default implementation performs a k-nearest search when the
+      /// ball contains more than \c maxNodes nodes.
+      virtual NodeVector_t withinBall (const Configuration_t& configuration,
+			               const ConnectedComponentPtr_t& cc,
+			               value_type maxDistance,
+                                       size_type maxNodes)
+      {
+        NodeVector_t nodes (withinBall (configuration, cc, maxDistance));
+        if ((size_type) nodes.size () <= maxNodes) return nodes;
+        value_type distance;
+        Nodes_t nearest (KnearestSearch (configuration, cc,
+                                         (std::size_t) maxNodes, distance));
+        return NodeVector_t (nearest.begin (), nearest.end ());
+      }
+
       // merge two connected components in the whole tree
       virtual void merge (ConnectedComponentPtr_t cc1,
 			  ConnectedComponentPtr_t cc2) = 0;
@@ -90,11 +188,95 @@ namespace hpp {
       // Get distance function
       virtual DistancePtr_t distance () const = 0;
 
+      /// Set the approximation factor of the searches
+      /// \param factor a value greater than or equal to 1.
+      ///
+      /// Searches then return nodes the distance of which is at most
+      /// \c factor times the distance of the exact nearest nodes. 1 means
+      /// exact search. Structures that only perform exact searches
+      /// ignore the factor.
+      virtual void approximationFactor (value_type factor)
+      {
+        (void) factor;
+      }
+
+      /// Get the approximation factor of the searches
+      virtual value_type approximationFactor () const
+      {
+        return 1;
+      }
+
+      /// \name Statistics
+      /// \{
+
+      /// Maximal depth of the leaves, 0 if the structure is not a tree
+      virtual size_type depth () const
+      {
+        return 0;
+      }
+
+      /// Average depth of the points, 0 if the structure is not a tree
+      ///
+      /// Compared to \ref depth, it tells how balanced the tree is.
+      virtual value_type averageDepth () const
+      {
+        return 0;
+      }
+
+      /// Memory allocated by the structure (in bytes)
+      ///
+      /// The nodes and the configurations of the roadmap are not counted.
+      /// Structures that store nothing beyond the roadmap return 0.
+      virtual std::size_t memory () const
+      {
+        return 0;
+      }
+      /// \}
+
       virtual ~NearestNeighbor () {};
 
     private:
       HPP_SERIALIZABLE();
     }; // class NearestNeighbor
+
+    namespace nearestNeighbor {
+      /// Create a k-dimensional tree
+      /// \param robot the robot the configurations of which are stored,
+      /// \param distance distance used to compare configurations,
+      /// \param bucketSize maximal number of points in a leaf.
+      /// \note The caller owns the returned object. It is passed to
+      ///       Roadmap::nearestNeighbor, which deletes it.
+      NearestNeighborPtr_t HPP_CORE_DLLAPI createKDTree
+      (const DevicePtr_t& robot, const DistancePtr_t& distance,
+       size_type bucketSize = 32);
+
+      /// Share a nearest neighbor structure between threads
+      /// \param nearestNeighbor the wrapped structure, owned by the returned
+      ///        object.
+      /// \return a structure the searches of which may run concurrently,
+      ///         modifications being serialized with the searches.
+      /// \note KDTree can be wrapped. Basic cannot since it iterates over
+      ///       connected components that the roadmap modifies outside of
+      ///       the lock.
+      NearestNeighborPtr_t HPP_CORE_DLLAPI createConcurrent
+      (NearestNeighborPtr_t nearestNeighbor);
+
+      /// Search nodes in the free variables of a configuration projector
+      /// \param robot the robot the configurations of which are stored,
+      /// \param distance distance of the roadmap, the weights of which
+      ///        scale the coordinates if it is a WeighedDistance,
+      /// \param projector projector of the constraints of the problem.
+      /// \return a structure that compares the nodes by the distance of the
+      ///         free variables of their difference with the neutral
+      ///         configuration, ignoring the directions along which the
+      ///         projector moves configurations. Distances are measured in
+      ///         these coordinates.
+      /// \note The caller owns the returned object, see createKDTree.
+      /// \throw std::invalid_argument if the projector is null.
+      NearestNeighborPtr_t HPP_CORE_DLLAPI createReducedChart
+      (const DevicePtr_t& robot, const DistancePtr_t& distance,
+       const ConfigProjectorPtr_t& projector);
+    } // namespace nearestNeighbor
   } // namespace core
 } // namespace hpp
 
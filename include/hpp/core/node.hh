@@ -47,6 +47,10 @@ namespace hpp {
 	    ConnectedComponentPtr_t connectedComponent);
       void addOutEdge (EdgePtr_t edge);
       void addInEdge (EdgePtr_t edge);
+      /// Remove an edge from the outgoing edges. The edge is not deleted.
+      void removeOutEdge (EdgePtr_t edge);
+      /// Remove an edge from the ingoing edges. The edge is not deleted.
+      void removeInEdge (EdgePtr_t edge);
       /// Store the connected component the node belongs to
       void connectedComponent (const ConnectedComponentPtr_t& cc);
       ConnectedComponentPtr_t connectedComponent () const;
@@ -76,7 +80,8 @@ namespace hpp {
       ConfigurationPtr_t configuration_;
       Edges_t outEdges_;
       Edges_t inEdges_;
-      ConnectedComponentPtr_t connectedComponent_;
+      /// Connected component the node was last known to belong to.
+      mutable ConnectedComponentPtr_t connectedComponent_;
 
       HPP_SERIALIZABLE();
     }; // class Node
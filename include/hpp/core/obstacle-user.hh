@@ -47,6 +47,14 @@ namespace hpp {
         virtual void removeObstacleFromJoint(const JointPtr_t& joint,
             const CollisionObjectConstPtr_t& object) = 0;
 
+        /// Notify that the placement or the geometry of an obstacle changed
+        /// \param object obstacle previously added.
+        ///
+        /// The obstacle is modified in place in its geometry model and data,
+        /// so that the collision pairs are kept. Implementations update
+        /// what they computed from the obstacle.
+        virtual void updateObstacle (const CollisionObjectConstPtr_t& object) = 0;
+
         /// Filter collision pairs.
         ///
         /// Remove pairs of object that cannot be in collision.
@@ -114,6 +122,20 @@ namespace hpp {
           }
         }
 
+        /// Update obstacle in each element
+        ///
+        /// Dynamic cast into ObstacleUserInterface each element
+        /// of \link ObstacleUserVector::validations_ validations_
+        /// \endlink and call method updateObstacle of element.
+        void updateObstacle (const CollisionObjectConstPtr_t& object)
+        {
+          for (std::size_t i = 0; i < validations_.size(); ++i) {
+            boost::shared_ptr<ObstacleUserInterface> oui =
+              HPP_DYNAMIC_PTR_CAST(ObstacleUserInterface, validations_[i]);
+            if (oui) oui->updateObstacle (object);
+          }
+        }
+
         /// Filter collision pairs to each element
         ///
         /// Dynamic cast into ObstacleUserInterface each element
@@ -159,11 +181,23 @@ namespace hpp {
         typedef std::vector<CollisionPair_t> CollisionPairs_t;
         typedef std::vector<fcl::CollisionRequest> CollisionRequests_t;
 
+        /// Find the first pair in collision
+        /// \param useBoundingSpheres whether to skip pairs whose bounding
+        ///        spheres are further than the security margin of the
+        ///        request, without calling fcl::collide.
+        /// \retval i index of the pair in collision.
         static bool collide (const CollisionPairs_t& pairs,
             CollisionRequests_t& reqs,
             fcl::CollisionResult& res,
             std::size_t& i,
-            pinocchio::DeviceData& data);
+            pinocchio::DeviceData& data,
+            bool useBoundingSpheres = false);
+
+        /// Whether the bounding spheres of the objects of a pair are
+        /// further than the security margin of the request
+        static bool farApart (const CollisionPair_t& pair,
+            const fcl::CollisionRequest& request,
+            const pinocchio::DeviceData& data);
 
         // Get pairs checked for collision
         const CollisionPairs_t& pairs () const
@@ -196,6 +230,22 @@ namespace hpp {
 
         void setRequests (const fcl::CollisionRequest& r);
 
+        /// Set whether bounding spheres are tested before fcl::collide
+        ///
+        /// The bounding spheres are the ones computed by FCL with the
+        /// bounding box of the geometries. Pairs whose spheres are further
+        /// than the security margin cannot be in collision.
+        void useBoundingSpheres (bool use)
+        {
+          useBoundingSpheres_ = use;
+        }
+
+        /// Get whether bounding spheres are tested before fcl::collide
+        bool useBoundingSpheres () const
+        {
+          return useBoundingSpheres_;
+        }
+
         /// Add an obstacle
         /// \param object obstacle added
         virtual void addObstacle (const CollisionObjectConstPtr_t& object);
@@ -214,6 +264,14 @@ namespace hpp {
         virtual void removeObstacleFromJoint(const JointPtr_t& joint,
             const CollisionObjectConstPtr_t& object);
 
+        /// Notify that the placement or the geometry of an obstacle changed
+        ///
+        /// Collision pairs read the placement and the geometry of the
+        /// obstacle in its geometry data at each test: nothing to update.
+        virtual void updateObstacle (const CollisionObjectConstPtr_t&)
+        {
+        }
+
         /// Filter collision pairs.
         ///
         /// Remove pairs of object that cannot be in collision.
@@ -229,7 +287,8 @@ namespace hpp {
       protected:
         /// Constructor of body pair collision
         ObstacleUser (DevicePtr_t robot)
-          : robot_ (robot), defaultRequest_ (fcl::NO_REQUEST,1)
+          : robot_ (robot), defaultRequest_ (fcl::NO_REQUEST,1),
+            useBoundingSpheres_ (true)
         {
           defaultRequest_.enable_cached_gjk_guess = true;
         }
@@ -243,7 +302,8 @@ namespace hpp {
             dPairs_ (other.dPairs_),
             cRequests_ (other.cRequests_),
             pRequests_ (other.pRequests_),
-            dRequests_ (other.dRequests_)
+            dRequests_ (other.dRequests_),
+            useBoundingSpheres_ (other.useBoundingSpheres_)
         {}
 
         void addRobotCollisionPairs ();
@@ -257,6 +317,7 @@ namespace hpp {
         CollisionRequests_t cRequests_, /// Active collision requests
                             pRequests_, /// Parameterized collision requests
                             dRequests_; /// Disabled collision requests
+        bool useBoundingSpheres_;
     }; // class ObstacleUser
   } // namespace core
 } // namespace hpp
@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_OCCUPANCY_CACHE_HH
+# define HPP_CORE_OCCUPANCY_CACHE_HH
+
+# include <string>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup validation
+    /// \{
+
+    /// Cells of the configuration space certified collision free
+    ///
+    /// Configurations are mapped to their difference with the neutral
+    /// configuration, in the Lie group R^n x SO(n). Cells of level l are
+    /// the hypercubes of width resolution * 2^l of a regular grid in this
+    /// space, each cell of level l + 1 containing 2^n cells of level l.
+    ///
+    /// A configuration at distance d of the obstacles remains collision
+    /// free while no point of the bodies moves by d / 2 or more. \ref
+    /// insert stores the largest cell around the configuration over which
+    /// this holds, using for each joint an upper bound of the velocity of
+    /// the points of its subtree. \ref isFree tells whether a cell of any
+    /// level contains a configuration.
+    ///
+    /// Cells are relative to a scene, identified by a key given by the
+    /// collision validation: they are ignored when the key of the query is
+    /// another one, and discarded upon the first insertion with another
+    /// key. Caches saved to a file and loaded in another process are thus
+    /// used only for the same robot and obstacles.
+    ///
+    /// Methods are thread safe.
+    ///
+    /// \sa CollisionValidation::occupancyCache
+    class HPP_CORE_DLLAPI OccupancyCache
+    {
+    public:
+      /// Create an empty cache
+      /// \param resolution width of the cells of level 0,
+      /// \param numberLevels number of levels of cells.
+      /// \throw std::invalid_argument if resolution or numberLevels is not
+      ///        positive.
+      static OccupancyCachePtr_t create (const DevicePtr_t& robot,
+                                         value_type resolution,
+                                         size_type numberLevels);
+
+      /// Load a cache saved by \ref save
+      /// \throw std::runtime_error if the file cannot be read, or was not
+      ///        saved for a robot with the same number of degrees of
+      ///        freedom.
+      static OccupancyCachePtr_t load (const DevicePtr_t& robot,
+                                       const std::string& filename);
+
+      /// Save the cells in a file
+      ///
+      /// The cells are written in a temporary file and renamed, so that
+      /// concurrent processes load either the previous or the new cells.
+      /// \throw std::runtime_error if the file cannot be written.
+      void save (const std::string& filename) const;
+
+      /// Whether a cell of the scene contains a configuration
+      bool isFree (ConfigurationIn_t config, std::size_t scene) const;
+
+      /// Store the cell around a configuration over which the bodies move
+      /// by less than half the clearance
+      /// \param clearance lower bound of the distance between the objects
+      ///        of the pairs checked for collision, security margins
+      ///        deduced.
+      /// \param scene key of the collision pairs.
+      /// \return whether a cell of level 0 at least fits.
+      bool insert (ConfigurationIn_t config, value_type clearance,
+                   std::size_t scene);
+
+      /// Discard the cells
+      void clear ();
+
+      /// Number of cells stored
+      size_type numberCells () const;
+
+      /// Number of calls to \ref isFree that returned true
+      size_type hits () const;
+
+      /// Number of calls to \ref isFree that returned false
+      size_type misses () const;
+
+      value_type resolution () const
+      {
+        return resolution_;
+      }
+
+      size_type numberLevels () const
+      {
+        return numberLevels_;
+      }
+
+      /// Key of the scene of the cells
+      std::size_t scene () const;
+
+      /// Upper bound of the displacement of the points of the bodies per
+      /// unit of each velocity coordinate
+      const vector_t& coefficients () const
+      {
+        return coefficients_;
+      }
+
+    protected:
+      OccupancyCache (const DevicePtr_t& robot, value_type resolution,
+                      size_type numberLevels);
+
+    private:
+      struct Cells;
+
+      /// Difference between a configuration and the neutral configuration
+      void coordinates (ConfigurationIn_t config, vector_t& v) const;
+
+      DevicePtr_t robot_;
+      value_type resolution_;
+      size_type numberLevels_;
+      vector_t coefficients_;
+      boost::shared_ptr <Cells> cells_;
+    }; // class OccupancyCache
+    /// \}
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_OCCUPANCY_CACHE_HH
@@ -140,6 +140,71 @@ namespace hpp {
         Parameter::Type type_;
         Parameter defaultValue_;
     };
+
+    /// Non template part of ParameterHandle
+    class HPP_CORE_DLLAPI ParameterHandleBase
+    {
+      protected:
+        ParameterHandleBase (const Problem& problem, const std::string& name);
+
+        /// Whether the parameters of the problem changed since the last
+        /// call to lookup, or lookup was never called.
+        bool outdated () const
+        {
+          return revision_ != *problemRevision_;
+        }
+
+        /// Get the parameter from the problem and store its revision
+        const Parameter& lookup () const;
+
+        static void get (const Parameter& p, bool& v)
+        { v = p.boolValue (); }
+        static void get (const Parameter& p, size_type& v)
+        { v = p.intValue (); }
+        static void get (const Parameter& p, value_type& v)
+        { v = p.floatValue (); }
+        static void get (const Parameter& p, std::string& v)
+        { v = p.stringValue (); }
+        static void get (const Parameter& p, vector_t& v)
+        { v = p.vectorValue (); }
+        static void get (const Parameter& p, matrix_t& v)
+        { v = p.matrixValue (); }
+
+      private:
+        const Problem* problem_;
+        std::string name_;
+        const size_type* problemRevision_;
+        mutable size_type revision_;
+    };
+
+    /// Typed handle to a parameter of a problem
+    ///
+    /// The parameter is looked up by name at the first read and after each
+    /// change of the parameters of the problem, as counted by
+    /// Problem::parametersRevision. Other reads return a cached value, so
+    /// that parameters can be read in loops without string comparisons.
+    ///
+    /// \tparam T bool, size_type, value_type, std::string, vector_t or
+    ///         matrix_t, following the type of the parameter.
+    /// \note the handle should not outlive the problem.
+    template <typename T>
+    class ParameterHandle : public ParameterHandleBase
+    {
+      public:
+        ParameterHandle (const Problem& problem, const std::string& name) :
+          ParameterHandleBase (problem, name), value_ ()
+        {}
+
+        /// Value of the parameter
+        const T& value () const
+        {
+          if (outdated ()) get (lookup (), value_);
+          return value_;
+        }
+
+      private:
+        mutable T value_;
+    };
   } // namespace core
 } //namespace hpp
 
@@ -81,6 +81,26 @@ namespace hpp {
           } else return true;
         }
 
+        /// Same as \ref reduceConstraint, where only the rows of lc from
+        /// firstRow are reduced. The previous rows of lcr are kept, assuming
+        /// that neither lc nor this constraint changed since they were reduced.
+        bool reduceConstraint (const LinearConstraint& lc, LinearConstraint& lcr,
+                               size_type firstRow, bool computeRank) const
+        {
+          assert (firstRow <= lcr.J.rows() && firstRow <= lc.J.rows());
+          const size_type nbRows = lc.J.rows() - firstRow;
+          lcr.J.conservativeResize (lc.J.rows(), PK.cols());
+          lcr.b.conservativeResize (lc.b.rows());
+          lcr.J.bottomRows(nbRows).noalias() = lc.J.bottomRows(nbRows) * PK;
+          lcr.b.tail(nbRows).noalias() = lc.b.tail(nbRows) - lc.J.bottomRows(nbRows) * xStar;
+
+          // Decompose
+          if (computeRank) {
+            lcr.computeRank();
+            return lcr.rank == std::min(lcr.J.rows(), lcr.J.cols());
+          } else return true;
+        }
+
         /// Compute the unique solution derived from v into \ref xSol.
         /// \f$ xSol \gets x^* + PK \times v \f$
         /// \param v an element of the kernel of matrix \ref J.
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_PATH_OPTIMIZATION_MULTI_START_HH
+# define HPP_CORE_PATH_OPTIMIZATION_MULTI_START_HH
+
+# include <string>
+# include <vector>
+
+# include <boost/function.hpp>
+
+# include <hpp/core/path-optimizer.hh>
+# include <hpp/core/path-planner.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathOptimization {
+    /// \addtogroup path_optimization
+    /// \{
+
+    /// Run several instances of a randomized optimizer, keep the shortest
+    ///
+    /// Each call to \ref optimize builds one worker problem per start, with
+    /// the tools returned by the factory, and one optimizer per worker
+    /// problem. The optimizers run concurrently on the input path and the
+    /// result of lowest cost is returned. The cost of a path is the sum of
+    /// the distances, computed with the distance of the problem, between
+    /// the ends of its elements.
+    ///
+    /// The worker problems copy the parameters and the distance of the
+    /// problem. Their random generator is the one of the configuration
+    /// shooter of the tools, so that the instances draw from different
+    /// streams.
+    class HPP_CORE_DLLAPI MultiStart : public PathOptimizer
+    {
+    public:
+      typedef boost::function <PathOptimizerPtr_t (const Problem&)>
+        Builder_t;
+      typedef PathPlanner::ConnectionToolsFactory_t ConnectionToolsFactory_t;
+
+      /// Return shared pointer to new object.
+      /// \param problem the problem of the input paths,
+      /// \param builder creates an optimizer of a worker problem,
+      /// \param factory returns the tools of a worker, see
+      ///        ProblemSolver::connectionToolsFactory,
+      /// \param numberStarts number of instances run by \ref optimize.
+      /// \throw std::invalid_argument if numberStarts is not positive or if
+      ///        the builder or the factory is empty.
+      static MultiStartPtr_t create (const Problem& problem,
+                                     const Builder_t& builder,
+                                     const ConnectionToolsFactory_t& factory,
+                                     size_type numberStarts);
+
+      /// Optimize path
+      /// \throw std::runtime_error if all the instances fail. The message
+      ///        gathers their errors.
+      virtual PathVectorPtr_t optimize (const PathVectorPtr_t& path);
+
+      /// Cost of a path, see class documentation
+      value_type cost (const PathVectorPtr_t& path) const;
+
+    protected:
+      MultiStart (const Problem& problem, const Builder_t& builder,
+                  const ConnectionToolsFactory_t& factory,
+                  size_type numberStarts);
+
+    private:
+      /// Optimize path with optimizers [i] and store the result
+      void run (std::size_t i, const PathVectorPtr_t& path);
+
+      Builder_t builder_;
+      ConnectionToolsFactory_t factory_;
+      size_type numberStarts_;
+
+      /// State of the current call to optimize, one element per start
+      std::vector <PathOptimizerPtr_t> optimizers_;
+      std::vector <PathVectorPtr_t> results_;
+      std::vector <std::string> errors_;
+    }; // class MultiStart
+    /// \}
+    } // namespace pathOptimization
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_PATH_OPTIMIZATION_MULTI_START_HH
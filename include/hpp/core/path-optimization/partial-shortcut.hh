@@ -19,7 +19,10 @@
 #ifndef HPP_CORE_PATH_OPTIMIZATION_PARTIAL_SHORTCUT_HH
 # define HPP_CORE_PATH_OPTIMIZATION_PARTIAL_SHORTCUT_HH
 
+# include <vector>
+
 # include <hpp/core/path-optimizer.hh>
+# include <hpp/core/path-planner.hh>
 
 namespace hpp {
   namespace core {
@@ -56,6 +59,10 @@ namespace hpp {
       class HPP_CORE_DLLAPI PartialShortcut : public PathOptimizer
       {
         public:
+          typedef PathPlanner::ConnectionTools ConnectionTools;
+          typedef PathPlanner::ConnectionToolsFactory_t
+            ConnectionToolsFactory_t;
+
           /// Return shared pointer to new object.
           template < typename Traits > static
             PartialShortcutPtr_t createWithTraits (const Problem& problem);
@@ -66,6 +73,27 @@ namespace hpp {
           /// Optimize path
           virtual PathVectorPtr_t optimize (const PathVectorPtr_t& path);
 
+          /// Evaluate the shortcuts of several joints concurrently
+          ///
+          /// Step 2 builds and validates the direct path of every joint on
+          /// the input path in \c numberThreads threads. The valid direct
+          /// paths are then combined in the order of the joints: the
+          /// direct path of a joint is built again and validated on the
+          /// path shortened by the previous joints. Step 3 evaluates the
+          /// random shortcut of \c numberThreads consecutive joints between
+          /// the same times, and keeps the shortest resulting path.
+          ///
+          /// Paths with a config projector are optimized sequentially,
+          /// since projecting modifies the constraints of the path.
+          /// \param numberThreads number of threads, 1 restores the
+          ///        sequential optimization,
+          /// \param factory called once per thread at the beginning of
+          ///        \ref optimize, see PathPlanner::parallelConnections.
+          /// \throw std::invalid_argument if numberThreads is not positive
+          ///        or if several threads are requested without factory.
+          void parallelCandidates (size_type numberThreads,
+                                   const ConnectionToolsFactory_t& factory);
+
           struct Parameters {
             /// Whether of not the joint that are locked by the constraints
             /// in the path should not be optimized.
@@ -94,9 +122,18 @@ namespace hpp {
           PartialShortcut (const Problem& problem);
 
         private:
+          /// Partial shortcut of one joint, see \ref parallelCandidates
+          struct Candidate;
+          typedef std::vector <Candidate> Candidates_t;
+
+          /// Build the path where joint is interpolated between q1 and q2
+          /// \param tools objects of the calling thread. If null, the
+          ///        steering method and the path projector of the problem
+          ///        are used.
           PathVectorPtr_t generatePath (PathVectorPtr_t path, JointConstPtr_t joint,
               const value_type t1, ConfigurationIn_t q1,
-              const value_type t2, ConfigurationIn_t q2) const;
+              const value_type t2, ConfigurationIn_t q2,
+              const ConnectionTools* tools = 0x0) const;
 
           JointStdVector_t generateJointVector(const PathVectorPtr_t& pv) const;
 
@@ -115,6 +152,31 @@ namespace hpp {
           /// \return the optimized path
           PathVectorPtr_t optimizeRandom (const PathVectorPtr_t& pv,
               const JointStdVector_t &jv) const;
+
+          /// Step 2 with one candidate per joint evaluated in parallel
+          /// \sa optimizeFullPath
+          PathVectorPtr_t optimizeFullPathParallel (const PathVectorPtr_t& pv,
+              const JointStdVector_t &jvIn, JointStdVector_t &jvOut,
+              const std::vector <ConnectionTools>& tools) const;
+
+          /// Step 3 with candidates of several joints evaluated in parallel
+          /// \sa optimizeRandom
+          PathVectorPtr_t optimizeRandomParallel (const PathVectorPtr_t& pv,
+              const JointStdVector_t &jv,
+              const std::vector <ConnectionTools>& tools) const;
+
+          /// Build and validate candidates in threads
+          void evaluate (const std::vector <ConnectionTools>& tools,
+              const PathVectorPtr_t& path, Candidates_t& candidates) const;
+
+          /// Build and validate candidates begin, begin + step, ...
+          void evaluateRange (const ConnectionTools& tools,
+              const PathVectorPtr_t& path, Candidates_t& candidates,
+              std::size_t begin, std::size_t step) const;
+
+          /// \copydoc parallelCandidates
+          size_type numberThreads_;
+          ConnectionToolsFactory_t factory_;
       }; // class RandomShortcut
       /// \}
 
@@ -17,6 +17,8 @@
 #ifndef HPP_CORE_PATH_OPTIMIZATION_QUADRATIC_PROGRAM_HH
 # define HPP_CORE_PATH_OPTIMIZATION_QUADRATIC_PROGRAM_HH
 
+#include <Eigen/SparseCore>
+
 #include <hpp/core/fwd.hh>
 
 #include <hpp/core/path-optimization/linear-constraint.hh>
@@ -46,15 +48,24 @@ namespace hpp {
        *  \f}
        *  This is done via \ref computeLLT and \ref solve methods
        *  and uses quadprog
+       *
+       *  When the cost is sparse, \f$ H \f$ can be stored in \ref Hs
+       *  instead of \ref H. The program must then be reduced before being
+       *  solved.
        **/
       struct QuadraticProgram
       {
         typedef Eigen::JacobiSVD < matrix_t > Decomposition_t;
         typedef Eigen::LLT <matrix_t, Eigen::Lower> LLT_t;
-
-        QuadraticProgram (size_type inputSize) :
-          H (inputSize, inputSize), b (inputSize),
-          dec (inputSize, inputSize, Eigen::ComputeThinU | Eigen::ComputeThinV),
+        typedef Eigen::SparseMatrix <value_type> SparseMatrix_t;
+
+        /// \param sparse whether the cost is stored in \ref Hs.
+        QuadraticProgram (size_type inputSize, bool sparse = false) :
+          H (sparse ? 0 : inputSize, sparse ? 0 : inputSize), b (inputSize),
+          Hs (sparse ? inputSize : 0, sparse ? inputSize : 0),
+          isSparse (sparse),
+          dec (sparse ? 0 : inputSize, sparse ? 0 : inputSize,
+               Eigen::ComputeThinU | Eigen::ComputeThinV),
           xStar (inputSize)
         {
           H.setZero();
@@ -64,6 +75,7 @@ namespace hpp {
 
         QuadraticProgram (const QuadraticProgram& QP, const LinearConstraint& lc) :
           H (lc.PK.cols(), lc.PK.cols()), b (lc.PK.cols()), bIsZero (false),
+          isSparse (false),
           dec (lc.PK.cols(), lc.PK.cols(), Eigen::ComputeThinU | Eigen::ComputeThinV),
           xStar (lc.PK.cols())
         {
@@ -72,6 +84,7 @@ namespace hpp {
 
         QuadraticProgram (const QuadraticProgram& QP) :
           H (QP.H), b (QP.b), bIsZero (QP.bIsZero),
+          Hs (QP.Hs), isSparse (QP.isSparse),
           dec (QP.dec), xStar (QP.xStar)
         {}
 
@@ -94,9 +107,13 @@ namespace hpp {
          *      & lc.J * x = lc.b
          *  \f}
         **/
+        /// The reduced program is dense. When \ref isSparse, the product
+        /// with the kernel costs \f$ O(nnz(H_s) \times dim(PK)) \f$.
         void reduced (const LinearConstraint& lc, QuadraticProgram& QPr) const
         {
-          matrix_t H_PK (H * lc.PK);
+          matrix_t H_PK;
+          if (isSparse) H_PK = Hs * lc.PK;
+          else H_PK.noalias() = H * lc.PK;
           QPr.H.noalias() = lc.PK.transpose() * H_PK;
           QPr.b.noalias() = H_PK.transpose() * lc.xStar;
           if (!bIsZero) {
@@ -117,12 +134,16 @@ namespace hpp {
         /// \name Program subject to linear equality and inequality constraints.
         /// \{
 
+        /// Compute the Cholesky decomposition \f$ H = L L^T \f$ and
+        /// \f$ L^{-T} \f$, which are reused by each call to \ref solve.
         void computeLLT();
 
         /// Compute solution using quadprog
         /// \param ce equality constraints
         /// \param ci inequality constraints: \f$ ci.J * x \ge ci.b \f$
-        /// \note \ref computeLLT must have been called before.
+        /// \note \ref computeLLT must have been called before. Only the
+        ///       constraints change between two calls, so that adding rows to
+        ///       ce does not factorize \ref H again.
         double solve(const LinearConstraint& ce, const LinearConstraint& ci);
 
         /// \}
@@ -132,12 +153,18 @@ namespace hpp {
         matrix_t H;
         vector_t b;
         bool bIsZero;
+        /// Sparse storage of \f$ H \f$, used when \ref isSparse
+        SparseMatrix_t Hs;
+        bool isSparse;
         /// \}
 
         /// \name Data (for inequality constraints)
         /// \{
         LLT_t llt;
         value_type trace;
+        /// \f$ L^{-T} \f$ and its trace
+        matrix_t invLT;
+        value_type traceInvLT;
         Eigen::VectorXi activeConstraint;
         int activeSetSize;
         /// \}
@@ -19,7 +19,10 @@
 #ifndef HPP_CORE_PATH_OPTIMIZATION_RANDOM_SHORTCUT_HH
 # define HPP_CORE_PATH_OPTIMIZATION_RANDOM_SHORTCUT_HH
 
+# include <vector>
+# include <hpp/core/parameter.hh>
 # include <hpp/core/path-optimizer.hh>
+# include <hpp/core/path-planner.hh>
 
 namespace hpp {
   namespace core {
@@ -38,11 +41,34 @@ namespace hpp {
     class HPP_CORE_DLLAPI RandomShortcut : public PathOptimizer
     {
     public:
+      typedef PathPlanner::ConnectionTools ConnectionTools;
+      typedef PathPlanner::ConnectionToolsFactory_t ConnectionToolsFactory_t;
+
       /// Return shared pointer to new object.
       static RandomShortcutPtr_t create (const Problem& problem);
 
       /// Optimize path
       virtual PathVectorPtr_t optimize (const PathVectorPtr_t& path);
+
+      /// Try several shortcuts per iteration
+      ///
+      /// Each iteration samples several pairs of times along the current
+      /// path. The three sub-paths of each candidate are steered, projected
+      /// and validated in \c numberThreads threads. The shortest resulting
+      /// path replaces the current path if it is shorter. The sub-paths of
+      /// a candidate cover the whole path, so at most one candidate is kept
+      /// per iteration.
+      /// \param numberCandidates number of pairs of times per iteration,
+      ///        1 restores one shortcut per iteration,
+      /// \param numberThreads number of threads,
+      /// \param factory called once per thread at the beginning of
+      ///        \ref optimize, see PathPlanner::parallelConnections. Not
+      ///        used with one thread: the objects of the problem are used.
+      /// \throw std::invalid_argument if a number is not positive or if
+      ///        several threads are requested without factory.
+      void batch (size_type numberCandidates, size_type numberThreads = 1,
+                  const ConnectionToolsFactory_t& factory =
+                  ConnectionToolsFactory_t ());
     protected:
       RandomShortcut (const Problem& problem);
 
@@ -57,6 +83,35 @@ namespace hpp {
           value_type& t1,
           value_type& t2,
           const value_type& t3);
+
+    private:
+      /// Shortcut of the current path, see \ref batch
+      struct Candidate
+      {
+        value_type t [4];
+        Configuration_t q [4];
+        /// Sub-paths, null if steering or projection failed
+        PathPtr_t proj [3];
+        bool valid [3];
+        /// Whether the sub-path lies in one element of the current path,
+        /// which is kept without steering nor validation
+        bool unchanged [3];
+      }; // struct Candidate
+      typedef std::vector <Candidate> Candidates_t;
+
+      /// Optimize with several shortcuts per iteration, see \ref batch
+      PathVectorPtr_t batchedOptimize (const PathVectorPtr_t& path);
+      /// Steer, project and validate candidates begin, begin + step, ...
+      static void shortcutRange (const ConnectionTools& tools,
+                                 Candidates_t& candidates,
+                                 std::size_t begin, std::size_t step);
+
+      /// \copydoc batch
+      size_type batchSize_;
+      size_type numberThreads_;
+      ConnectionToolsFactory_t factory_;
+      /// Parameter PathOptimization/RandomShortcut/NumberOfLoops
+      ParameterHandle <size_type> numberOfLoops_;
     }; // class RandomShortcut
     /// \}
     } // namespace pathOptimization
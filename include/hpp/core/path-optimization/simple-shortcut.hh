@@ -19,7 +19,10 @@
 #ifndef HPP_CORE_PATH_OPTIMIZATION_SIMPLE_SHORTCUT_HH
 # define HPP_CORE_PATH_OPTIMIZATION_SIMPLE_SHORTCUT_HH
 
+# include <vector>
+
 # include <hpp/core/path-optimizer.hh>
+# include <hpp/core/path-planner.hh>
 
 namespace hpp {
   namespace core {
@@ -37,13 +40,59 @@ namespace hpp {
       class HPP_CORE_DLLAPI SimpleShortcut : public PathOptimizer
       {
       public:
+        typedef PathPlanner::ConnectionTools ConnectionTools;
+        typedef PathPlanner::ConnectionToolsFactory_t
+          ConnectionToolsFactory_t;
+
         /// Return shared pointer to new object.
         static SimpleShortcutPtr_t create (const Problem& problem);
 
         /// Optimize path
         virtual PathVectorPtr_t optimize (const PathVectorPtr_t& path);
+
+        /// Search the shortest path in a visibility graph of the waypoints
+        ///
+        /// Instead of a roadmap, the visible pairs of waypoints are stored
+        /// in a bitmap. Pairs are validated by decreasing number of
+        /// waypoints between them, each number in one batch shared by
+        /// \c numberThreads threads. A pair lying between the waypoints
+        /// of a visible pair of a previous batch is not validated: by the
+        /// triangle inequality, the longer shortcut is shorter than the
+        /// input path through the pair. The shortest path is then computed
+        /// once in the order of the waypoints, since edges go forward along
+        /// the input path.
+        /// \param numberThreads number of threads, 0 restores the roadmap,
+        /// \param factory called once per thread at the beginning of
+        ///        \ref optimize, see PathPlanner::parallelConnections. Not
+        ///        used with one thread: the objects of the problem are used.
+        /// \throw std::invalid_argument if several threads are requested
+        ///        without factory.
+        void visibilityGraph (size_type numberThreads,
+                              const ConnectionToolsFactory_t& factory =
+                              ConnectionToolsFactory_t ());
       protected:
         SimpleShortcut (const Problem& problem);
+
+      private:
+        /// Pair of waypoints, see \ref visibilityGraph
+        struct Pair
+        {
+          std::size_t i, j;
+          bool visible;
+        }; // struct Pair
+        typedef std::vector <Pair> Pairs_t;
+
+        /// Optimize with a visibility graph, see \ref visibilityGraph
+        PathVectorPtr_t visibilityOptimize (const PathVectorPtr_t& path);
+        /// Steer, project and validate pairs begin, begin + step, ...
+        static void validateRange (const ConnectionTools& tools,
+                                   const std::vector <Configuration_t>& q,
+                                   Pairs_t& pairs,
+                                   std::size_t begin, std::size_t step);
+
+        /// \copydoc visibilityGraph
+        size_type numberThreads_;
+        ConnectionToolsFactory_t factory_;
       }; // class SimpleShortcut
       /// \}
     } // namespace pathOptimization
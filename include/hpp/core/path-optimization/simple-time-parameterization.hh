@@ -17,6 +17,7 @@
 #ifndef HPP_CORE_PATH_OPTIMIZATION_SIMPLE_TIME_PARAMETERIZATION_HH
 # define HPP_CORE_PATH_OPTIMIZATION_SIMPLE_TIME_PARAMETERIZATION_HH
 
+# include <hpp/core/parameter.hh>
 # include <hpp/core/path-optimizer.hh>
 
 namespace hpp {
@@ -183,6 +184,13 @@ namespace hpp {
 
         protected:
           SimpleTimeParameterization (const Problem& problem);
+
+        private:
+          /// Parameters SimpleTimeParameterization/safety, order and
+          /// maxAcceleration
+          ParameterHandle <value_type> safety_;
+          ParameterHandle <size_type> order_;
+          ParameterHandle <value_type> maxAcceleration_;
       }; // class SimpleTimeParameterization
       /// \}
     } // namespace pathOptimization
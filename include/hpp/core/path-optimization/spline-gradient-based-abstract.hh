@@ -129,6 +129,9 @@ namespace hpp {
           typedef std::vector <std::pair <PathValidationReportPtr_t,
                   std::size_t> > Reports_t;
           /// Calls each validations_ on the corresponding spline.
+          /// The splines sharing the same path validation are validated
+          /// in one call to PathValidation::validatePaths, which may
+          /// validate them concurrently.
           /// \param reordering order in which the path validation is run.
           ///                   It is assumed that reordering is a permutation
           ///                   of [0, splines.size()[.
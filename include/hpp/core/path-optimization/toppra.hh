@@ -0,0 +1,79 @@
+// Copyright (c) 2018, Joseph Mirabel
+// Authors: Joseph Mirabel (joseph.mirabel@laas.fr)
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_PATH_OPTIMIZATION_TOPPRA_HH
+# define HPP_CORE_PATH_OPTIMIZATION_TOPPRA_HH
+
+# include <hpp/core/path-optimizer.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathOptimization {
+      /// \addtogroup path_optimization
+      /// \{
+
+      /** Time optimal parameterization by reachability analysis (TOPP-RA)
+       *
+       *  Each element of the path is parameterized so that the joint
+       *  velocities and accelerations are bounded, starting and ending at
+       *  rest.
+       *
+       *  Parameter TOPPRA/safety (value_type) rescales the velocity limits
+       *  of the robot. Parameter TOPPRA/maxAcceleration (value_type) is the
+       *  acceleration bound of each degree of freedom, not considered if
+       *  negative. Parameter TOPPRA/numberOfSamples (size_type) is the
+       *  number of intervals of the grid of each element.
+       *
+       *  Let \f$ q(s), s \in [s_0, s_N] \f$ be an element of the path and
+       *  \f$ s_0, ..., s_N \f$ a regular grid of step \f$ \Delta \f$.
+       *  With \f$ x = \dot s^2 \f$ and \f$ u = \ddot s \f$, the constraints
+       *  at \f$ s_i \f$ are linear in \f$ (x_i, u_i) \f$:
+       *  \f[ \begin{align*}
+       *    l_j \le & q'_j(s_i) \dot s \le u_j \\
+       *    |q'_j(s_i) u_i + q''_j(s_i) x_i| \le & a \\
+       *    x_{i+1} = & x_i + 2 \Delta u_i
+       *  \end{align*} \f]
+       *
+       *  A backward pass computes the controllable sets
+       *  \f$ K_i = [0, \bar x_i] \f$, the values of \f$ x_i \f$ from which
+       *  \f$ x_N = 0 \f$ is reachable, by projecting the constraints onto
+       *  \f$ x \f$. A forward pass then greedily picks from \f$ x_0 = 0 \f$
+       *  the maximal \f$ u_i \f$ keeping \f$ x_{i+1} \in K_{i+1} \f$.
+       *
+       *  As \f$ u \f$ is constant on \f$ [s_i, s_{i+1}] \f$, the resulting
+       *  timeParameterization::PiecewisePolynomial is quadratic on each
+       *  interval, of duration \f$ \frac{2 \Delta}
+       *  {\sqrt{x_i} + \sqrt{x_{i+1}}} \f$.
+       *
+       *  \note constraints are only enforced at the points of the grid.
+       */
+      class HPP_CORE_DLLAPI TOPPRA : public PathOptimizer
+      {
+        public:
+          /// Return shared pointer to new object.
+          static TOPPRAPtr_t create (const Problem& problem);
+
+          /// Optimize path
+          virtual PathVectorPtr_t optimize (const PathVectorPtr_t& path);
+
+        protected:
+          TOPPRA (const Problem& problem);
+      }; // class TOPPRA
+      /// \}
+    } // namespace pathOptimization
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_PATH_OPTIMIZATION_TOPPRA_HH
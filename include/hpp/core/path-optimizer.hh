@@ -19,10 +19,15 @@
 #ifndef HPP_CORE_PATH_OPTIMIZER_HH
 # define HPP_CORE_PATH_OPTIMIZER_HH
 
+# include <iosfwd>
+# include <utility>
+# include <vector>
+
 # include <hpp/core/config.hh>
 # include <hpp/core/fwd.hh>
 
-# include <boost/date_time/posix_time/ptime.hpp>
+# include <hpp/core/deadline.hh>
+# include <hpp/core/planner-statistics.hh>
 
 namespace hpp {
   namespace core {
@@ -34,6 +39,32 @@ namespace hpp {
     class HPP_CORE_DLLAPI PathOptimizer
     {
     public:
+      /// Counters of the last call to \ref optimize
+      ///
+      /// Reset by \ref monitorExecution and filled by the optimizers that
+      /// instrument their iterations. The stages of the calls made in
+      /// worker threads are not timed.
+      struct HPP_CORE_DLLAPI Statistics
+      {
+        /// Time spent steering, projecting and validating paths
+        PlannerStatistics stages;
+        /// Number of iterations
+        size_type iterations;
+        /// Number of candidate paths that replaced the current path
+        size_type accepted;
+        /// Number of candidate paths that were discarded
+        size_type rejected;
+        /// Length of the current path over time: pairs of time since
+        /// \ref monitorExecution (in seconds) and length
+        std::vector <std::pair <value_type, value_type> > lengths;
+        /// Duration of the optimization (in seconds)
+        value_type totalTime;
+
+        Statistics () { reset (); }
+        /// Set all the counters to zero
+        void reset ();
+      }; // struct Statistics
+
       virtual ~PathOptimizer () {};
 
       /// Get problem
@@ -52,6 +83,12 @@ namespace hpp {
       /// set time out (in seconds)
       void timeOut(const double& timeOut);
 
+      /// Get the counters of the last optimization
+      const Statistics& statistics () const
+      {
+        return statistics_;
+      }
+
     protected:
       /// Whether to interrupt computation
       /// Set to false at start of optimize method, set to true by method
@@ -64,13 +101,32 @@ namespace hpp {
 
       void monitorExecution();
 
-      void endIteration() { ++monitor_.iteration; }
+      void endIteration()
+      {
+        ++monitor_.iteration;
+        statistics_.iterations = monitor_.iteration;
+        statistics_.totalTime = elapsed ();
+      }
 
       bool shouldStop() const;
 
+      /// Counters updated by the optimizers, see \ref statistics
+      Statistics& mutableStatistics () const
+      {
+        return statistics_;
+      }
+      /// Count a candidate path
+      /// \param accepted whether the candidate replaced the current path
+      void recordCandidate (bool accepted) const;
+      /// Store the length of the current path, see Statistics::lengths
+      void recordLength (value_type length) const;
+
       void initFromParameters ();
 
     private:
+      /// Time since \ref monitorExecution (in seconds)
+      value_type elapsed () const;
+
       const Problem& problem_;
 
       /// Maximal number of iterations to solve a problem
@@ -84,12 +140,20 @@ namespace hpp {
       /// \li initialized by \ref monitorExecution
       /// \li updated by \ref endIteration
       /// \li read by \ref shouldStop
+      ///
+      /// \ref shouldStop also returns true when the deadline of the
+      /// problem expires, see Problem::deadline.
       struct {
         bool enabled;
         size_type iteration;
-        boost::posix_time::ptime timeStart;
+        Deadline::Clock_t::time_point timeStart;
       } monitor_;
+      /// Mutable since the steering method is timed in const methods.
+      mutable Statistics statistics_;
     }; // class PathOptimizer;
+
+    HPP_CORE_DLLAPI std::ostream& operator<< (std::ostream& os,
+        const PathOptimizer::Statistics& s);
     /// }
   } // namespace core
 } // namespace hpp
@@ -19,8 +19,11 @@
 #ifndef HPP_CORE_PATH_PLANNER_HH
 # define HPP_CORE_PATH_PLANNER_HH
 
+# include <boost/function.hpp>
+
 # include <hpp/core/fwd.hh>
 # include <hpp/core/config.hh>
+# include <hpp/core/planner-statistics.hh>
 
 namespace hpp {
   namespace core {
@@ -33,6 +36,38 @@ namespace hpp {
     /// set of goal configurations.
     class HPP_CORE_DLLAPI PathPlanner {
     public:
+      /// Objects used by one thread to steer, project and validate
+      /// connections, see \ref parallelConnections
+      struct ConnectionTools
+      {
+        SteeringMethodPtr_t steeringMethod;
+        /// May be null
+        PathProjectorPtr_t pathProjector;
+        PathValidationPtr_t pathValidation;
+        /// Shooter of the thread, may be null. Planners that shoot
+        /// configurations in several threads then share the shooter of
+        /// the problem under a lock. Shooters of different threads should
+        /// draw from different streams, see RandomGenerator::split.
+        ConfigurationShooterPtr_t configurationShooter;
+      }; // struct ConnectionTools
+      typedef boost::function <ConnectionTools ()> ConnectionToolsFactory_t;
+
+      /// State of the resolution, see \ref progressCallback
+      struct Progress
+      {
+        /// Number of calls to oneStep
+        unsigned long int iteration;
+        /// Time since the beginning of \ref solve (in seconds)
+        value_type time;
+        size_type numberNodes;
+        size_type numberConnectedComponents;
+        /// Whether the target of the problem is reached
+        bool solved;
+      }; // struct Progress
+      typedef boost::function <void (const Progress&)> ProgressCallback_t;
+      typedef boost::function <void (const PathVectorPtr_t&)>
+        SolutionCallback_t;
+
       virtual ~PathPlanner () {};
 
       /// Get roadmap
@@ -56,24 +91,113 @@ namespace hpp {
       /// configurations, in order to avoid a random shoot.
       virtual void tryDirectPath() HPP_CORE_DEPRECATED;
       /// Try to connect initial and goal configurations to existing roadmap
+      ///
+      /// The initial node is connected to the nearest node of every other
+      /// connected component, and the nearest node of every other connected
+      /// component to each goal node. Connections run in parallel if
+      /// \ref parallelConnections was called.
+      ///
+      /// If parameter "PathPlanner/lazyGoalConnection" is true, connections
+      /// are validated from the shortest, by batches of one connection per
+      /// thread, and the remaining ones are skipped as soon as the problem
+      /// is solved if \ref stopWhenProblemIsSolved is enabled.
       virtual void tryConnectInitAndGoals ();
+      /// Run the connections of \ref tryConnectInitAndGoals in parallel
+      ///
+      /// \param numberThreads number of threads. 1 restores sequential
+      ///        connections with the objects of the problem.
+      /// \param factory called once per thread in the calling thread. The
+      ///        tools of different threads must not share any mutable
+      ///        state, in particular the robot used by collision checking.
+      ///        Paths built by the tools are inserted in the roadmap.
+      void parallelConnections (size_type numberThreads,
+                                const ConnectionToolsFactory_t& factory);
+
+      /// Set the executor that runs the parallel tasks of the planner
+      ///
+      /// If null, which is the default, each parallel task runs in its own
+      /// thread.
+      void executor (const ExecutorPtr_t& executor)
+      {
+        executor_ = executor;
+      }
+
+      /// Executor that runs the parallel tasks of the planner
+      const ExecutorPtr_t& executor () const
+      {
+        return executor_;
+      }
 
       /// User implementation of one step of resolution
       virtual void oneStep () = 0;
       /// Post processing of the resulting path
       virtual PathVectorPtr_t finishSolve (const PathVectorPtr_t& path);
       /// Interrupt path planning
-      void interrupt ();
+      virtual void interrupt ();
       /// Set maximal number of iterations
       void maxIterations (const unsigned long int& n);
+      /// Get maximal number of iterations
+      unsigned long int maxIterations () const
+      {
+        return maxIterations_;
+      }
       /// set time out (in seconds)
       void timeOut(const double& timeOut);
+      /// Get time out (in seconds)
+      double timeOut () const
+      {
+        return timeOut_;
+      }
       /// Make the resolution stop when the problem is solved.
       /// If set to \c false, the algorithm stops when \ref maxIterations
       /// or \ref timeOut are reached and it is a success if the
       /// \ref Problem::target is achieved.
       void stopWhenProblemIsSolved(bool enable);
 
+      /// Set the function called by \ref solve after each step
+      ///
+      /// The function is called in the thread running \ref solve and
+      /// must return quickly. An empty function disables the calls.
+      void progressCallback (const ProgressCallback_t& callback)
+      {
+        progressCallback_ = callback;
+      }
+      /// Get the function called by \ref solve after each step
+      const ProgressCallback_t& progressCallback () const
+      {
+        return progressCallback_;
+      }
+      /// Set the function called with the intermediate solutions
+      ///
+      /// When \ref stopWhenProblemIsSolved is disabled, \ref solve
+      /// publishes the path found when the target is first reached.
+      /// Planners that improve their solution, like
+      /// pathPlanner::BiRrtStar, publish each improvement. The function is
+      /// called in the thread running \ref solve, and the path returned by
+      /// \ref solve is not published.
+      void solutionCallback (const SolutionCallback_t& callback)
+      {
+        solutionCallback_ = callback;
+      }
+      /// Get the function called with the intermediate solutions
+      const SolutionCallback_t& solutionCallback () const
+      {
+        return solutionCallback_;
+      }
+
+      /// Time spent in each stage by the last call to \ref solve
+      ///
+      /// The number of iterations and the total time are always filled.
+      /// The stages are filled by the planners that instrument their
+      /// steps: DiffusingPlanner and BiRRTPlanner. Sampled configurations
+      /// and the causes of their rejection are counted by
+      /// DiffusingPlanner, BiRRTPlanner, VisibilityPrmPlanner and
+      /// pathPlanner::kPrmStar.
+      const PlannerStatistics& statistics () const
+      {
+        return statistics_;
+      }
+
       /// Find a path in the roadmap and transform it in trajectory
       PathVectorPtr_t computePath () const;
     protected:
@@ -87,7 +211,31 @@ namespace hpp {
       PathPlanner (const Problem& problem, const RoadmapPtr_t& roadmap);
       /// Store weak pointer to itself
       void init (const PathPlannerWkPtr_t& weak);
+      /// Prune the roadmap if it exceeds the node budget
+      ///
+      /// The budget is given by parameter "PathPlanner/maxRoadmapNodes",
+      /// read in \ref startSolve. Negative values disable pruning. Leaves
+      /// are removed until the roadmap is shrunk to 90% of the budget, see
+      /// Roadmap::prune.
+      /// \warning planners that store pointers to nodes must not call
+      ///          this method.
+      void pruneRoadmap ();
+      /// Whether intermediate solutions are published
+      bool publishesSolutions () const
+      {
+        return !solutionCallback_.empty ();
+      }
+      /// Call the function set by \ref solutionCallback, if any
+      void publishSolution (const PathVectorPtr_t& path);
+      /// Statistics to be filled by the steps of derived classes
+      PlannerStatistics& mutableStatistics ()
+      {
+        return statistics_;
+      }
     private:
+      /// Sort nodes by increasing distance to a node
+      void sortByDistance (const NodePtr_t& node, NodeVector_t& nodes) const;
+
       /// Reference to the problem
       const Problem& problem_;
       /// Pointer to the roadmap.
@@ -100,6 +248,16 @@ namespace hpp {
       double timeOut_;
       /// \copydoc PathPlanner::stopWhenProblemIsSolved
       bool stopWhenProblemIsSolved_;
+      /// Maximal number of nodes of the roadmap, see \ref pruneRoadmap
+      size_type maxRoadmapNodes_;
+      /// \copydoc parallelConnections
+      size_type numberThreads_;
+      ConnectionToolsFactory_t connectionToolsFactory_;
+      /// \copydoc executor
+      ExecutorPtr_t executor_;
+      ProgressCallback_t progressCallback_;
+      SolutionCallback_t solutionCallback_;
+      PlannerStatistics statistics_;
 
       /// Store weak pointer to itself
       PathPlannerWkPtr_t weakPtr_;
@@ -19,6 +19,8 @@
 #ifndef HPP_CORE_PATH_PLANNER_BI_RRT_STAR_HH
 # define HPP_CORE_PATH_PLANNER_BI_RRT_STAR_HH
 
+# include <boost/unordered_map.hpp>
+
 # include <hpp/core/path-planner.hh>
 
 namespace hpp {
@@ -61,7 +63,9 @@ namespace hpp {
         void init (const BiRrtStarWkPtr_t& weak);
 
       private:
-        typedef std::map<NodePtr_t, EdgePtr_t> ParentMap_t;
+        /// Edge from the parent of a node and cost to reach the node
+        typedef std::pair<EdgePtr_t, value_type> Parent_t;
+        typedef boost::unordered_map<NodePtr_t, Parent_t> ParentMap_t;
 
         Configuration_t sample ();
 
@@ -75,8 +79,11 @@ namespace hpp {
         /// It returns an empty path on failure.
         /// If \c validatePath is true, it returns only the valid part.
         /// If \c maxLength is positive, the returned path will be at most of this length.
+        /// \retval clearance clearance of the returned path, computed by the
+        ///         path validation when it is a ContinuousValidation.
+        ///         Negative if unknown.
         PathPtr_t buildPath(const Configuration_t& q0, const Configuration_t& q1,
-            value_type maxLength, bool validatePath);
+            value_type maxLength, bool validatePath, value_type& clearance);
 
         bool extend (NodePtr_t target, ParentMap_t& parentMap, Configuration_t& q);
 
@@ -84,13 +91,31 @@ namespace hpp {
 
         bool improve (const Configuration_t& q);
 
+        /// Publish the path between the roots if it is shorter than the
+        /// previous one, see PathPlanner::solutionCallback.
+        void publishImprovement ();
+
+        /// Nodes of \c cc considered for rewiring around \c q.
+        NodeVector_t nodesWithinBall (const Configuration_t& q,
+            const ConnectedComponentPtr_t& cc);
+
         value_type gamma_;
         /// Maximal path length with using function \ref extend.
         value_type extendMaxLength_;
+        /// Maximal number of nodes returned by \ref nodesWithinBall.
+        /// Negative means unbounded.
+        size_type maxNearNodes_;
 
         NodePtr_t roots_[2];
-
-        /// store relation <child, parent> that brings to node \c roots_[i]
+        /// Length of the last published path
+        value_type bestCost_;
+        /// Shooter restricted to the configurations that may shorten the
+        /// best path, null if informed sampling is disabled.
+        configurationShooter::InformedPtr_t informed_;
+
+        /// store relation <child, parent> that brings to node \c roots_[i],
+        /// with the cost of the child. Costs of subtrees are updated when
+        /// a node is rewired.
         std::vector<ParentMap_t> toRoot_;
 
         /// Weak pointer to itself
@@ -26,6 +26,17 @@ namespace hpp {
     namespace pathPlanner {
       /// k-PRM* path planning algorithm
       /// as described in https://arxiv.org/pdf/1105.1186.pdf.
+      ///
+      /// If parameter "kPRM*/lazy" is true, edges are inserted in the
+      /// roadmap without validation. Once the initial and goal nodes are
+      /// connected, the edges of the shortest path are validated and the
+      /// invalid ones removed until a valid path is found.
+      ///
+      /// If parameter "kPRM*/densification" is positive, the planner does
+      /// not fail when the initial and goal nodes cannot be connected: it
+      /// adds this number of nodes to the roadmap, links the new nodes to
+      /// their neighbors, the number of which is computed from the new
+      /// number of nodes, and connects the initial and goal nodes again.
       class HPP_CORE_DLLAPI kPrmStar : public PathPlanner
       {
       public:
@@ -34,8 +45,19 @@ namespace hpp {
           BUILD_ROADMAP,
           LINK_NODES,
           CONNECT_INIT_GOAL,
+          VALIDATE_PATH,
           FAILURE
         }; // enum STATE
+        /// Objects used by one thread to shoot and validate configurations,
+        /// see \ref parallelSampling
+        struct SamplingTools
+        {
+          ConfigurationShooterPtr_t shooter;
+          /// May be null
+          ConstraintSetPtr_t constraints;
+          ConfigValidationsPtr_t configValidations;
+        }; // struct SamplingTools
+        typedef boost::function <SamplingTools ()> SamplingToolsFactory_t;
         /// Constant kPRM = 2 e
         static const double kPRM;
         typedef PathPlanner Parent_t;
@@ -55,6 +77,30 @@ namespace hpp {
       virtual void oneStep ();
       /// get the computationnal state of the algorithm
       STATE getComputationState () const;
+      /// Link the nodes of the roadmap in parallel
+      ///
+      /// The LINK_NODES state then runs in one step: the edges between
+      /// each node and its neighbors are steered, projected and validated
+      /// in \c numberThreads threads, then inserted in the roadmap in the
+      /// calling thread.
+      /// \param numberThreads number of threads. 1 restores the sequential
+      ///        linking, one neighbor per step.
+      /// \param factory called once per thread in \ref startSolve, see
+      ///        PathPlanner::parallelConnections.
+      void parallelLinking (size_type numberThreads,
+                            const ConnectionToolsFactory_t& factory);
+      /// Build the roadmap nodes in parallel
+      ///
+      /// The BUILD_ROADMAP state then shoots, projects and validates the
+      /// missing configurations in \c numberThreads threads and inserts
+      /// them in the roadmap at once, see Roadmap::addNodes.
+      /// \param numberThreads number of threads. 1 restores the sequential
+      ///        sampling, one block of configurations per step.
+      /// \param factory called once per thread in \ref startSolve. The
+      ///        tools of different threads must not share any mutable
+      ///        state.
+      void parallelSampling (size_type numberThreads,
+                             const SamplingToolsFactory_t& factory);
 
       protected:
         /// Protected constructor
@@ -68,21 +114,81 @@ namespace hpp {
         void init (const kPrmStarWkPtr_t& weak);
 
       private:
+        /// Candidate edge of the parallel linking
+        struct Link
+        {
+          Link (const NodePtr_t& f, const NodePtr_t& t) :
+            from (f), to (t), valid (false)
+          {
+          }
+          NodePtr_t from, to;
+          /// Path of the edge, null if steering failed
+          PathPtr_t path;
+          bool valid;
+        }; // struct Link
+        typedef std::vector <Link> Links_t;
+
         STATE state_;
         /// Generate random free configurations 10 by 10
         void generateRandomConfig ();
+        /// Shoot the missing configurations at once, see
+        /// \ref parallelSampling
+        void generateRandomConfigsInParallel ();
+        /// Shoot until \c count valid configurations are found or
+        /// \c maxTrials configurations are rejected in a row
+        /// \retval configurations the valid configurations.
+        /// \retval statistics samples and rejections of the thread.
+        static void sampleRange (const SamplingTools& tools,
+                                 size_type configSize, std::size_t count,
+                                 size_type maxTrials,
+                                 std::vector <Configuration_t>& configurations,
+                                 PlannerStatistics& statistics);
         /// Link each node with closest neighbors
         void linkNodes ();
+        /// Link all the nodes at once, see \ref parallelLinking
+        void linkNodesInParallel ();
+        /// Steer and validate links begin, begin + step, ...
+        ///
+        /// Links are only steered if \c lazy is true.
+        static void linkRange (const ConnectionTools& tools, bool lazy,
+                               Links_t& links, std::size_t begin,
+                               std::size_t step);
         /// Connect initial and goal configurations to roadmap
         void connectInitAndGoal ();
+        /// Add nodes to the roadmap after a failure, see parameter
+        /// "kPRM*/densification"
+        /// \return false if densification is disabled.
+        bool densify ();
+        /// Validate the edges of the shortest path in the roadmap
+        ///
+        /// Edges are validated in one batch that stops at the first invalid
+        /// one, see PathValidation::validatePaths. Invalid edges and their
+        /// reverse are removed from the roadmap.
+        void validateShortestPath ();
+        /// Edge going in the opposite direction and not validated yet
+        /// \return 0x0 if there is none.
+        EdgePtr_t reverseEdge (const EdgePtr_t& edge) const;
+        /// Project and validate the path of an edge
+        bool validate (const PathPtr_t& path) const;
         /// Connect node to k closest neighbors in the roadmap
         /// \param node node to connect to nearest neighbors,
         /// \return whether iterator on neighbors reached the end.
         bool connectNodeToClosestNeighbors (const NodePtr_t& node);
         /// Number of nodes to create
         std::size_t numberNodes_;
+        /// Number of nodes added by each densification
+        std::size_t densification_;
+        /// Rank of the first node to link, the previous ones being linked
+        /// before the last densification
+        std::size_t firstNewNode_;
+        /// Compute the neighbors of the nodes to link at once
+        void computeNeighbors ();
         /// Iterator on nodes
         Nodes_t::const_iterator linkingNodeIt_;
+        /// Rank of *linkingNodeIt_ in the list of nodes
+        std::size_t linkingNodeRank_;
+        /// Neighbors of each node to link, from rank \c firstNewNode_
+        std::vector <Nodes_t> neighborsOfNodes_;
         /// Iterator on neighbors
         Nodes_t::iterator itNeighbor_;
         /// Number of closest neighbors to connect to each node
@@ -91,6 +197,18 @@ namespace hpp {
         Nodes_t neighbors_;
         /// whether iterator reached last neighbor
         bool reachedLastNeighbor_;
+        /// Whether edges are validated lazily
+        bool lazy_;
+        /// \copydoc parallelLinking
+        size_type numberThreads_;
+        ConnectionToolsFactory_t factory_;
+        /// Tools of the threads of the parallel linking
+        std::vector <ConnectionTools> tools_;
+        /// \copydoc parallelSampling
+        size_type numberSamplingThreads_;
+        SamplingToolsFactory_t samplingFactory_;
+        /// Tools of the threads of the parallel sampling
+        std::vector <SamplingTools> samplingTools_;
         /// Weak pointer to itself
         kPrmStarWkPtr_t weak_;
       }; // class kPrmStar
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_PATH_PLANNER_PARALLEL_BI_RRT_HH
+# define HPP_CORE_PATH_PLANNER_PARALLEL_BI_RRT_HH
+
+# include <vector>
+
+# include <boost/thread/mutex.hpp>
+
+# include <hpp/core/bi-rrt-planner.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathPlanner {
+      /// Bi-RRT with several threads extending the same roadmap
+      ///
+      /// Each step, every worker thread performs one iteration of
+      /// BiRRTPlanner::oneStep: it shoots a random configuration, extends
+      /// the start component toward it, then each goal component, and
+      /// tries to connect the new nodes. Steering and path validation, the
+      /// expensive parts, use the tools of the worker and run concurrently.
+      /// Random shoots and roadmap insertions are serialized by a mutex.
+      ///
+      /// Nearest neighbor searches run concurrently if the nearest neighbor
+      /// structure of the roadmap was created by
+      /// nearestNeighbor::createConcurrent, and under the mutex otherwise.
+      ///
+      /// Without \ref workers, the planner runs one worker with the
+      /// steering method and the path validation of the problem.
+      /// \note Nodes are not removed from the roadmap during planning:
+      ///       parameter "PathPlanner/maxRoadmapNodes" is ignored.
+      class HPP_CORE_DLLAPI ParallelBiRRT : public BiRRTPlanner
+      {
+      public:
+        typedef BiRRTPlanner Parent_t;
+
+        /// Return shared pointer to new instance
+        /// \param problem the path planning problem
+        static ParallelBiRRTPtr_t create (const Problem& problem);
+        /// Return shared pointer to new instance
+        /// \param problem the path planning problem
+        /// \param roadmap previously built roadmap
+        static ParallelBiRRTPtr_t createWithRoadmap
+        (const Problem& problem, const RoadmapPtr_t& roadmap);
+
+        /// Set the worker threads
+        ///
+        /// \param numberThreads number of workers. 1 restores a single
+        ///        worker with the objects of the problem.
+        /// \param factory called once per worker in \ref startSolve. The
+        ///        tools of different workers must not share any mutable
+        ///        state, see PathPlanner::parallelConnections. The path
+        ///        projector of the tools is not used.
+        void workers (size_type numberThreads,
+                      const ConnectionToolsFactory_t& factory);
+
+        /// Get the number of worker threads
+        size_type numberWorkers () const
+        {
+          return numberWorkers_;
+        }
+
+        /// Initialize the problem resolution
+        ///  \li call parent implementation,
+        ///  \li build the tools of the workers.
+        virtual void startSolve ();
+        /// One iteration of each worker
+        virtual void oneStep ();
+
+      protected:
+        /// Protected constructor
+        ParallelBiRRT (const Problem& problem);
+        /// Protected constructor
+        ParallelBiRRT (const Problem& problem, const RoadmapPtr_t& roadmap);
+        /// Store weak pointer to itself
+        void init (const ParallelBiRRTWkPtr_t& weak);
+
+      private:
+        /// One iteration of a worker
+        void extend (const ConnectionTools& tools);
+        /// Nearest node in a connected component, see Roadmap::nearestNode
+        NodePtr_t nearestNode (const Configuration_t& configuration,
+                               const ConnectedComponentPtr_t& component,
+                               bool reverse);
+
+        size_type numberWorkers_;
+        ConnectionToolsFactory_t factory_;
+        std::vector <ConnectionTools> tools_;
+        /// Whether nearest neighbor searches may run without the mutex
+        bool concurrentSearches_;
+        /// Serializes random shoots and roadmap accesses
+        boost::mutex mutex_;
+        ParallelBiRRTWkPtr_t weak_;
+      }; // class ParallelBiRRT
+    } // namespace pathPlanner
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_PATH_PLANNER_PARALLEL_BI_RRT_HH
@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_PATH_PLANNER_PORTFOLIO_HH
+# define HPP_CORE_PATH_PLANNER_PORTFOLIO_HH
+
+# include <string>
+# include <vector>
+
+# include <boost/thread/mutex.hpp>
+
+# include <hpp/core/path-planner.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathPlanner {
+      /// Run several path planners concurrently, keep the first solution
+      ///
+      /// Each planner runs PathPlanner::solve in its own thread. The first
+      /// path found is returned and the other planners are interrupted.
+      /// The planners should be built with their own roadmap: the roadmap
+      /// of the portfolio is not filled.
+      ///
+      /// The maximal number of iterations and the time out of the
+      /// portfolio are applied to each planner.
+      ///
+      /// \warning the planners share the steering method, the path
+      ///          validation and the configuration shooter of the problem.
+      ///          Collision checking is thread safe if the robot has one
+      ///          pinocchio::DeviceData per planner. Problems with
+      ///          numerical constraints are not supported since
+      ///          projections are not thread safe.
+      class HPP_CORE_DLLAPI Portfolio : public PathPlanner
+      {
+      public:
+        typedef std::vector <PathPlannerPtr_t> PathPlanners_t;
+
+        /// Return shared pointer to new instance
+        /// \param problem the path planning problem
+        static PortfolioPtr_t create (const Problem& problem);
+        /// Return shared pointer to new instance
+        /// \param problem the path planning problem
+        /// \param roadmap previously built roadmap
+        static PortfolioPtr_t createWithRoadmap
+        (const Problem& problem, const RoadmapPtr_t& roadmap);
+
+        /// Add a planner to the portfolio
+        /// \param planner a planner of the same problem.
+        void addPlanner (const PathPlannerPtr_t& planner);
+
+        /// Get the planners of the portfolio
+        const PathPlanners_t& planners () const
+        {
+          return planners_;
+        }
+
+        /// Run the planners concurrently
+        /// \return the first path found.
+        /// \throw std::runtime_error if the portfolio is interrupted or if
+        ///        no planner finds a solution. In the latter case, the
+        ///        message gathers the errors of the planners.
+        virtual PathVectorPtr_t solve ();
+        /// Not available: planners are run by \ref solve
+        /// \throw std::logic_error
+        virtual void oneStep ();
+        /// Interrupt all the planners
+        virtual void interrupt ();
+
+      protected:
+        /// Protected constructor
+        Portfolio (const Problem& problem);
+        /// Protected constructor
+        Portfolio (const Problem& problem, const RoadmapPtr_t& roadmap);
+        /// Store weak pointer to itself
+        void init (const PortfolioWkPtr_t& weak);
+
+      private:
+        /// Run the solve method of a planner and store its result
+        void run (std::size_t i);
+
+        PathPlanners_t planners_;
+        /// First path found
+        PathVectorPtr_t result_;
+        /// Error message of each planner
+        std::vector <std::string> errors_;
+        bool interrupted_;
+        /// Protects the result and the errors
+        boost::mutex mutex_;
+        PortfolioWkPtr_t weak_;
+      }; // class Portfolio
+    } // namespace pathPlanner
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_PATH_PLANNER_PORTFOLIO_HH
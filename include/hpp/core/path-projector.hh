@@ -19,10 +19,16 @@
 
 # include <hpp/core/config.hh>
 # include <hpp/core/fwd.hh>
+# include <hpp/core/deadline.hh>
+
+# include <list>
 
 namespace hpp {
   namespace core {
     /// This class projects a path using constraints.
+    ///
+    /// Instances are not thread safe: each thread should use its own
+    /// instance, see ProblemSolver::connectionTools.
     class HPP_CORE_DLLAPI PathProjector
     {
       public:
@@ -40,6 +46,42 @@ namespace hpp {
         /// \return True if projection succeded
         bool apply (const PathPtr_t& path, PathPtr_t& projection) const;
 
+        /// Set the deadline checked by long projections
+        ///
+        /// When the deadline expires, projection stops and fails, returning
+        /// the part of the path projected so far.
+        /// Problem::pathProjector sets the deadline of the problem.
+        void deadline (const DeadlinePtr_t& deadline)
+        {
+          deadline_ = deadline;
+        }
+        /// Get the deadline checked by long projections
+        const DeadlinePtr_t& deadline () const
+        {
+          return deadline_;
+        }
+
+        /// Set the number of projections kept in memory
+        ///
+        /// Path optimizers project straight paths between the same
+        /// configurations several times. When n is positive, the results
+        /// of the last n projections of straight paths are kept. A straight
+        /// path between the same configurations as a previous one, with the
+        /// same length, numerical constraints and right hand side, gets a
+        /// copy of the previous projection. The sub-paths of a PathVector
+        /// are looked up separately. By default, nothing is kept.
+        void memorySize (size_type n)
+        {
+          memorySize_ = n;
+          while ((size_type) memory_.size () > memorySize_)
+            memory_.pop_back ();
+        }
+        /// Get the number of projections kept in memory
+        size_type memorySize () const
+        {
+          return memorySize_;
+        }
+
       protected:
         /// Constructor
 	///
@@ -58,9 +100,32 @@ namespace hpp {
 
         value_type d (ConfigurationIn_t q1, ConfigurationIn_t q2) const;
 	PathPtr_t steer (ConfigurationIn_t q1, ConfigurationIn_t q2) const;
+        /// Whether the deadline, if any, expired
+        bool expired () const
+        {
+          return deadline_ && deadline_->expired ();
+        }
 	SteeringMethodPtr_t steeringMethod_;
       private:
+        /// Projection of a straight path
+        struct Memo {
+          Configuration_t initial, end;
+          value_type length;
+          NumericalConstraints_t constraints;
+          vector_t rightHandSide;
+          bool success;
+          PathPtr_t projection;
+        };
+
+        /// Fill the fields of memo that identify a path
+        /// \return false if the path cannot be looked up in memory.
+        bool memoKey (const PathPtr_t& path, Memo& memo) const;
+
         DistancePtr_t distance_;
+        DeadlinePtr_t deadline_;
+        size_type memorySize_;
+        /// Last projections, the most recent first
+        mutable std::list <Memo> memory_;
     };
   } // namespace core
 } // namespace hpp
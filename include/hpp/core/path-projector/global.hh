@@ -18,6 +18,9 @@
 #ifndef HPP_CORE_PATHPROJECTOR_GLOBAL_HH
 # define HPP_CORE_PATHPROJECTOR_GLOBAL_HH
 
+# include <stdexcept>
+# include <vector>
+
 // lineSearch::FixedSequence
 # include <hpp/constraints/solver/hierarchical-iterative.hh>
 
@@ -44,6 +47,27 @@ namespace hpp {
           static GlobalPtr_t create (const Problem& problem,
               const value_type& step);
 
+          /// Set the number of threads updating the configurations
+          ///
+          /// If more than one, the Newton steps of the configurations of an
+          /// iteration are computed in parallel, each thread using its copy
+          /// of the ConfigProjector of the path. The reinterpolation remains
+          /// sequential and the projection is the same as with one thread.
+          /// The constraints must be thread safe, which requires as many
+          /// pinocchio::DeviceData as threads, see
+          /// pinocchio::Device::numberDeviceData.
+          void numberThreads (size_type n)
+          {
+            if (n < 1) throw std::invalid_argument
+                         ("The number of threads should be positive.");
+            numberThreads_ = n;
+          }
+          /// Get the number of threads updating the configurations
+          size_type numberThreads () const
+          {
+            return numberThreads_;
+          }
+
         protected:
           bool impl_apply (const PathPtr_t& path,
 			   PathPtr_t& projection) const;
@@ -73,12 +97,39 @@ namespace hpp {
           typedef std::list <LineSearch_t> Alphas_t;
           typedef std::vector <bool> Bools_t;
           typedef std::list<Data> Datas_t;
+          typedef std::vector<ConfigProjectorPtr_t> ConfigProjectors_t;
+
+          /// Newton step of one configuration
+          struct Step {
+            Configuration_t q;
+            LineSearch_t alpha;
+            vector_t dq;
+            value_type sigma;
+            bool satisfied;
+          };
+          typedef std::vector<Step> Steps_t;
+
+          /// Copies of p for the threads other than the calling one
+          ConfigProjectors_t threadProjectors (const ConfigProjector& p) const;
+
+          /// Apply one Newton step to each configuration of steps
+          ///
+          /// \param projectors copies of p used by the other threads.
+          void oneStep (ConfigProjector& p, const ConfigProjectors_t& projectors,
+              Steps_t& steps) const;
+
+          /// Apply one Newton step to the configurations of steps of index
+          /// begin + k * stride
+          void oneStepRange (ConfigProjector& p, Steps_t& steps,
+              size_type begin, size_type stride) const;
 
           bool projectOneStep (ConfigProjector& p,
+              const ConfigProjectors_t& projectors,
               Configs_t& q, Configs_t::iterator& last,
               Bools_t& b, Lengths_t& l, Alphas_t& alpha) const;
 
           bool projectOneStep (ConfigProjector& p,
+              const ConfigProjectors_t& projectors,
               Datas_t& ds, const Datas_t::iterator& last) const;
 
           /// Returns the number of new points
@@ -119,6 +170,7 @@ namespace hpp {
 
           mutable Configuration_t q_;
           mutable vector_t dq_;
+          size_type numberThreads_;
       };
     } // namespace pathProjector
   } // namespace core
@@ -35,6 +35,25 @@ namespace hpp {
           static ProgressivePtr_t create (const Problem& problem,
               const value_type& step);
 
+          /// Set the maximal step of the adaptive mode
+          ///
+          /// When larger than the step given at construction and no Hessian
+          /// bound is given, the step varies between both values. It doubles
+          /// after a configuration projected in one Newton iteration, and is
+          /// halved otherwise. The projection then has fewer waypoints where
+          /// the constraints are nearly linear. Not considered if negative,
+          /// which is the default value of parameter
+          /// "PathProjection/Progressive/MaxStep".
+          void maxStep (const value_type& maxStep)
+          {
+            maxStep_ = maxStep;
+          }
+          /// Get the maximal step of the adaptive mode
+          const value_type& maxStep () const
+          {
+            return maxStep_;
+          }
+
         protected:
           bool impl_apply (const PathPtr_t& path,
 			   PathPtr_t& projection) const;
@@ -50,6 +69,7 @@ namespace hpp {
           const value_type thresholdMin_;
           const value_type hessianBound_;
           const bool withHessianBound_;
+          value_type maxStep_;
       };
     } // namespace pathProjector
   } // namespace core
@@ -50,7 +50,13 @@ namespace hpp {
           bool project (const PathPtr_t& path, PathPtr_t& proj) const;
 
         private:
-          bool recurse (const HermitePtr_t& path, PathVectorPtr_t& proj, const value_type& thr) const;
+          /// Subdivide a path until the pieces are shorter than thr
+          ///
+          /// The pieces are appended to proj in order. The subdivision is
+          /// depth first, with an explicit stack of the pieces to process.
+          /// \return false if the subdivision stopped before the end.
+          bool subdivide (const HermitePtr_t& path, const PathVectorPtr_t& proj,
+              const value_type& thr) const;
           value_type M_, beta_;
       };
     } // namespace pathProjector
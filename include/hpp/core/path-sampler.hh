@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_PATH_SAMPLER_HH
+# define HPP_CORE_PATH_SAMPLER_HH
+
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup path
+    /// \{
+
+    /// Evaluation of a timed path at increasing times
+    ///
+    /// The constructor bakes the path into a table of knots. The path is
+    /// flattened into its elements, and the time parameterization of each
+    /// element, a timeParameterization::Polynomial, a
+    /// timeParameterization::PiecewisePolynomial or none, is split into
+    /// polynomials. Each knot stores the time at which a polynomial starts,
+    /// the element it applies to, and its coefficients.
+    ///
+    /// Sampling at increasing times, as a controller does, moves a cursor
+    /// forward in the table: the knot of a time is found in constant time on
+    /// average. The parameter is then evaluated by the Horner scheme and the
+    /// configuration by the element, without going through
+    /// Path::operator(), PathVector::rankAtParam and the time
+    /// parameterization. Sampling does not allocate memory provided the
+    /// elements evaluate without allocating.
+    ///
+    /// \note The constraints of the elements are not applied: paths should
+    ///       be projected before being sampled. Times outside of the time
+    ///       range of the path are clamped.
+    class HPP_CORE_DLLAPI PathSampler
+    {
+    public:
+      /// Bake a path
+      /// \throw std::invalid_argument if an element of the path has a
+      ///        configuration projector, or a time parameterization that is
+      ///        neither polynomial nor piecewise polynomial.
+      explicit PathSampler (const PathPtr_t& path);
+
+      /// Time range of the path
+      const interval_t& timeRange () const
+      {
+        return timeRange_;
+      }
+
+      /// Number of polynomials in the table
+      std::size_t numberKnots () const
+      {
+        return knots_.size ();
+      }
+
+      /// Compute the configuration at a time
+      /// \retval result configuration, of size Path::outputSize.
+      /// \return whether the element succeeded.
+      bool operator() (const value_type& time, ConfigurationOut_t result);
+
+      /// Compute the velocity at a time
+      /// \retval result velocity, of size Path::outputDerivativeSize.
+      void velocity (const value_type& time, vectorOut_t result);
+
+      /// Move the cursor back to the beginning of the path
+      void reset ()
+      {
+        cursor_ = 0;
+      }
+
+    private:
+      struct Knot
+      {
+        /// Time at which the polynomial starts.
+        value_type start;
+        /// Time at which the variable of the polynomial is zero.
+        value_type origin;
+        /// Rank of the element in elements_.
+        std::size_t element;
+        /// Rank of the first coefficient in coefficients_.
+        std::size_t begin;
+        /// Number of coefficients.
+        std::size_t size;
+      }; // struct Knot
+
+      /// Add the knots of an element starting at a time
+      void bake (const PathPtr_t& element, const value_type& start);
+      /// Rank of the knot of a time
+      std::size_t knot (const value_type& time);
+      /// Parameter of the element at a time, and its derivative
+      value_type parameter (const Knot& knot, const value_type& time,
+                            value_type& derivative) const;
+
+      interval_t timeRange_;
+      std::vector <PathPtr_t> elements_;
+      std::vector <Knot> knots_;
+      std::vector <value_type> coefficients_;
+      std::size_t cursor_;
+    }; // class PathSampler
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_PATH_SAMPLER_HH
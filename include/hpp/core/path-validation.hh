@@ -19,8 +19,12 @@
 #ifndef HPP_CORE_PATH_VALIDATION_HH
 # define HPP_CORE_PATH_VALIDATION_HH
 
+# include <vector>
+
 # include <hpp/core/fwd.hh>
 # include <hpp/core/config.hh>
+# include <hpp/core/deadline.hh>
+# include <hpp/core/path.hh>
 # include <hpp/core/relative-motion.hh>
 
 namespace hpp {
@@ -32,6 +36,9 @@ namespace hpp {
     ///
     /// Instances of this class compute the latest valid configuration along
     /// a path.
+    ///
+    /// Instances are not thread safe: each thread should use its own
+    /// instance, see ProblemSolver::connectionTools.
     class HPP_CORE_DLLAPI PathValidation
     {
     public:
@@ -48,12 +55,91 @@ namespace hpp {
 			     PathPtr_t& validPart,
 			     PathValidationReportPtr_t& report) = 0;
 
+      /// Compute whether a path is valid, without valid part nor report
+      ///
+      /// \param path, reverse see validate,
+      /// \retval lastValidTime end of the largest valid interval starting
+      ///         from the path beginning, its beginning if reverse.
+      /// \return whether the whole path is valid.
+      ///
+      /// For callers that only need to know whether a path is valid. The
+      /// default implementation calls validate. Derived classes may skip
+      /// the construction of the valid part and of the report.
+      virtual bool isValid (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime)
+      {
+        PathPtr_t validPart;
+        PathValidationReportPtr_t report;
+        const bool valid (validate (path, reverse, validPart, report));
+        const interval_t& tr (path->timeRange ());
+        lastValidTime = reverse ? tr.second - validPart->length () :
+          tr.first + validPart->length ();
+        return valid;
+      }
+
+      /// Validate several paths
+      ///
+      /// \param paths, reverse see validate,
+      /// \retval validParts, reports valid part and report of each path,
+      /// \retval valid whether each path is valid,
+      /// \param stopAtFirstInvalid if true, validation stops as soon as a
+      ///        path is found invalid. Paths that are not validated are
+      ///        considered invalid and get no valid part.
+      /// \return whether all the paths are valid.
+      ///
+      /// The default implementation validates the paths one after the other.
+      /// Derived classes may validate them concurrently.
+      virtual bool validatePaths
+      (const std::vector <PathPtr_t>& paths, bool reverse,
+       std::vector <PathPtr_t>& validParts,
+       std::vector <PathValidationReportPtr_t>& reports,
+       std::vector <bool>& valid, bool stopAtFirstInvalid = false)
+      {
+        validParts.assign (paths.size (), PathPtr_t ());
+        reports.assign (paths.size (), PathValidationReportPtr_t ());
+        valid.assign (paths.size (), false);
+        bool result (true);
+        for (std::size_t i = 0; i < paths.size (); ++i) {
+          valid [i] = validate (paths [i], reverse, validParts [i],
+                                reports [i]);
+          if (!valid [i]) {
+            result = false;
+            if (stopAtFirstInvalid) break;
+          }
+        }
+        return result;
+      }
+
       virtual ~PathValidation () {};
 
+      /// Set the deadline checked by long validations
+      ///
+      /// When the deadline expires, validation stops and the remaining part
+      /// of the path is considered invalid, with a DeadlineExpired report.
+      /// Problem::pathValidation sets the deadline of the problem.
+      virtual void deadline (const DeadlinePtr_t& deadline)
+      {
+        deadline_ = deadline;
+      }
+      /// Get the deadline checked by long validations
+      const DeadlinePtr_t& deadline () const
+      {
+        return deadline_;
+      }
+
     protected:
       PathValidation ()
       {
       }
+
+      /// Whether the deadline, if any, expired
+      bool expired () const
+      {
+        return deadline_ && deadline_->expired ();
+      }
+
+    private:
+      DeadlinePtr_t deadline_;
     }; // class PathValidation
     /// \}
   } // namespace core
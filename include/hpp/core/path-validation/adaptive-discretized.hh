@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_PATH_VALIDATION_ADAPTIVE_DISCRETIZED_HH
+# define HPP_CORE_PATH_VALIDATION_ADAPTIVE_DISCRETIZED_HH
+
+# include <hpp/core/path-validation/discretized.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathValidation {
+    /// \addtogroup validation
+    /// \{
+
+    /// Discretized validation of a path in bisection order
+    ///
+    /// The path is sampled at the same parameter values as Discretized,
+    /// but the samples are tested in van der Corput order: both ends, then
+    /// the middle, then the quarters... Collisions are thus detected
+    /// after a few samples whatever their position along the path. After
+    /// a collision, the samples preceding it that were not tested yet are
+    /// tested in increasing order to compute the valid part of the path,
+    /// which is the same as the one computed by Discretized.
+    /// \note Samples are validated by the calling thread only, whatever
+    ///       Discretized::numberThreads.
+    class HPP_CORE_DLLAPI AdaptiveDiscretized : public Discretized
+    {
+    public:
+      static AdaptiveDiscretizedPtr_t create (const value_type& stepSize);
+
+      /// Compute the largest valid interval starting from the path beginning
+      ///
+      /// \param path the path to check for validity,
+      /// \param reverse if true check from the end,
+      /// \retval the extracted valid part of the path, pointer to path if
+      ///         path is valid.
+      /// \retval report information about the validation process. A report
+      ///         is allocated if the path is not valid.
+      /// \return whether the whole path is valid.
+      virtual bool validate (const PathPtr_t& path, bool reverse,
+			     PathPtr_t& validPart,
+			     PathValidationReportPtr_t& report);
+
+      /// Compute whether a path is valid, without extracting the valid part
+      /// \sa PathValidation::isValid
+      virtual bool isValid (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime);
+
+      virtual ~AdaptiveDiscretized () {};
+    protected:
+      AdaptiveDiscretized (const value_type& stepSize);
+
+    private:
+      /// Validate the samples in bisection order
+      /// \retval lastValidTime parameter of the last sample before the
+      ///         first invalid one, end of the path (beginning if reverse)
+      ///         if the path is valid.
+      /// \retval report allocated if the path is not valid.
+      bool validateOrdered (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime,
+                            PathValidationReportPtr_t& report);
+      /// Validate the configuration of the path at a given parameter
+      /// \param skip, validations see Discretized::validateConfiguration,
+      /// \retval report allocated if the configuration is not valid.
+      bool validateSample (const PathPtr_t& path, const value_type& t,
+                           bool skip,
+                           const std::vector <ConfigValidationPtr_t>&
+                           validations, Configuration_t& q,
+                           PathValidationReportPtr_t& report);
+    }; // class AdaptiveDiscretized
+    /// \}
+    } // namespace pathValidation
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_PATH_VALIDATION_ADAPTIVE_DISCRETIZED_HH
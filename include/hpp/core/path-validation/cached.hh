@@ -0,0 +1,159 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_PATH_VALIDATION_CACHED_HH
+# define HPP_CORE_PATH_VALIDATION_CACHED_HH
+
+# include <vector>
+
+# include <hpp/core/obstacle-user.hh>
+# include <hpp/core/path-validation.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathValidation {
+    /// \addtogroup validation
+    /// \{
+
+    /// Cache of the results of another path validation
+    ///
+    /// The least recently used results are kept, keyed by the type of the
+    /// path, its time range, its constraints, the direction of the
+    /// validation and
+    /// \li the initial and end configurations for straight paths, which
+    ///     they determine,
+    /// \li the path object itself for other paths.
+    ///
+    /// Straight paths built again between the same configurations, as
+    /// shortcut optimizers do, are thus validated once. The valid part of a
+    /// straight path found in the cache is extracted from the path given
+    /// to \ref validate. Results of validations interrupted by the deadline
+    /// are not stored.
+    ///
+    /// The cache is cleared each time obstacles, collision pairs or
+    /// security margins change, see ObstacleUserInterface.
+    class HPP_CORE_DLLAPI Cached :
+      public PathValidation,
+      public ObstacleUserInterface
+    {
+    public:
+      /// Create a cache
+      /// \param validation the validation computing the results,
+      /// \param cacheSize maximal number of results stored.
+      /// \throw std::invalid_argument if cacheSize is not positive.
+      static CachedPtr_t create (const PathValidationPtr_t& validation,
+                                 size_type cacheSize);
+
+      /// Validate a path, unless the result is in the cache
+      /// \sa PathValidation::validate
+      virtual bool validate (const PathPtr_t& path, bool reverse,
+			     PathPtr_t& validPart,
+			     PathValidationReportPtr_t& report);
+
+      /// \sa PathValidation::isValid
+      virtual bool isValid (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime);
+
+      /// Validate the paths missing in the cache in one call to the
+      /// validatePaths method of the validation
+      /// \sa PathValidation::validatePaths
+      virtual bool validatePaths
+      (const std::vector <PathPtr_t>& paths, bool reverse,
+       std::vector <PathPtr_t>& validParts,
+       std::vector <PathValidationReportPtr_t>& reports,
+       std::vector <bool>& valid, bool stopAtFirstInvalid = false);
+
+      /// Set the deadline of this object and of the validation
+      virtual void deadline (const DeadlinePtr_t& deadline);
+      using PathValidation::deadline;
+
+      /// Validation computing the results
+      const PathValidationPtr_t& validation () const
+      {
+        return validation_;
+      }
+
+      /// Maximal number of results stored
+      size_type cacheSize () const
+      {
+        return cacheSize_;
+      }
+
+      /// Number of validations answered by the cache
+      size_type cacheHits () const
+      {
+        return cacheHits_;
+      }
+
+      /// Number of validations not answered by the cache
+      size_type cacheMisses () const
+      {
+        return cacheMisses_;
+      }
+
+      /// Discard the results stored in the cache
+      void clearCache ();
+
+      /// \name ObstacleUserInterface
+      /// Forwarded to the validation. Each method clears the cache.
+      /// \{
+      virtual void addObstacle (const CollisionObjectConstPtr_t& object);
+      virtual void removeObstacleFromJoint
+      (const JointPtr_t& joint, const CollisionObjectConstPtr_t& obstacle);
+      virtual void updateObstacle (const CollisionObjectConstPtr_t& object);
+      virtual void filterCollisionPairs
+      (const RelativeMotion::matrix_type& relMotion);
+      virtual void setSecurityMargins (const matrix_t& securityMatrix);
+      /// \}
+
+      virtual ~Cached () {}
+
+    protected:
+      Cached (const PathValidationPtr_t& validation, size_type cacheSize);
+
+    private:
+      struct Cache;
+      struct Result
+      {
+        bool valid;
+        value_type lastValidTime;
+        PathValidationReportPtr_t report;
+      }; // struct Result
+
+      /// Find the result of a path in the cache
+      bool find (const PathPtr_t& path, bool reverse, Result& result);
+      /// Store the result of a path in the cache
+      void insert (const PathPtr_t& path, bool reverse, const Result& result);
+      /// Build the valid part of a path from its result
+      static PathPtr_t validPart (const PathPtr_t& path, bool reverse,
+                                  const Result& result);
+      /// The validation interface of the validation, if any
+      ObstacleUserInterface* obstacleUser () const;
+
+      PathValidationPtr_t validation_;
+      size_type cacheSize_;
+      size_type cacheHits_;
+      size_type cacheMisses_;
+      boost::shared_ptr <Cache> cache_;
+    }; // class Cached
+    /// \}
+    } // namespace pathValidation
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_PATH_VALIDATION_CACHED_HH
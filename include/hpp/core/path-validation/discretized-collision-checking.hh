@@ -31,6 +31,12 @@ namespace hpp {
       DiscretizedPtr_t createDiscretizedCollisionChecking (
           const DevicePtr_t& robot, const value_type& stepSize);
 
+      /// Validation of path by collision checking at discretized parameter
+      /// values tested in bisection order
+      /// \sa AdaptiveDiscretized
+      DiscretizedPtr_t createAdaptiveDiscretizedCollisionChecking (
+          const DevicePtr_t& robot, const value_type& stepSize);
+
       /// \}
     } // namespace pathValidation
   } // namespace core
@@ -19,6 +19,9 @@
 #ifndef HPP_CORE_PATH_VALIDATION_DISCRETIZED_HH
 # define HPP_CORE_PATH_VALIDATION_DISCRETIZED_HH
 
+# include <stdexcept>
+# include <vector>
+
 # include <hpp/core/config-validations.hh>
 # include <hpp/core/path-validation.hh>
 
@@ -52,11 +55,85 @@ namespace hpp {
 			     PathPtr_t& validPart,
 			     PathValidationReportPtr_t& report);
 
+      /// Compute whether a path is valid, without extracting the valid part
+      /// \sa PathValidation::isValid
+      virtual bool isValid (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime);
+
+      /// Set the number of threads validating the samples
+      ///
+      /// If more than one, the configurations are computed along the path
+      /// by the calling thread, then validated in parallel chunks of
+      /// consecutive samples. The valid part is the same as with one
+      /// thread. The configuration validations must be thread safe, which
+      /// is the case of CollisionValidation when the robot has several
+      /// DeviceData, see pinocchio::Device::numberDeviceData.
+      void numberThreads (size_type n)
+      {
+        if (n < 1) throw std::invalid_argument
+                     ("The number of threads should be positive.");
+        numberThreads_ = n;
+      }
+      /// Get the number of threads validating the samples
+      size_type numberThreads () const
+      {
+        return numberThreads_;
+      }
+
       virtual ~Discretized () {};
     protected:
       Discretized (const value_type& stepSize);
 
       value_type stepSize_;
+
+      /// Configuration validations to apply to the samples of a path
+      ///
+      /// Configuration validations that certify the path, see
+      /// ConfigValidation::certifies, are skipped.
+      /// \retval validations the validations that do not certify the path.
+      /// \return whether some validations certify the path.
+      bool sampleValidations
+      (const PathPtr_t& path,
+       std::vector <ConfigValidationPtr_t>& validations) const;
+
+      /// Validate a sample of a path
+      /// \param skip, validations values returned by sampleValidations.
+      ///        If skip is false, all the validations are applied by
+      ///        ConfigValidations::validate.
+      bool validateConfiguration
+      (const Configuration_t& q, bool skip,
+       const std::vector <ConfigValidationPtr_t>& validations,
+       ValidationReportPtr_t& report);
+
+    private:
+      struct FirstFailure;
+
+      /// Validate the samples until the first invalid one
+      /// \retval lastValidTime parameter of the last valid sample, end of
+      ///         the path (beginning if reverse) if the path is valid.
+      /// \retval report allocated if the path is not valid.
+      bool validateSamples (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime,
+                            PathValidationReportPtr_t& report);
+      /// Validate the samples with several threads
+      /// \sa validateSamples
+      /// \param skip, validations see validateConfiguration.
+      bool validateParallel (const PathPtr_t& path, bool reverse, bool skip,
+                             const std::vector <ConfigValidationPtr_t>&
+                             validations, value_type& lastValidTime,
+                             PathValidationReportPtr_t& report);
+      /// Validate chunks begin, begin + step... of consecutive samples
+      ///
+      /// Stops when the samples follow the first failure found so far.
+      void validateChunks (const matrix_t& configurations,
+                           const std::vector <value_type>& times,
+                           bool skip,
+                           const std::vector <ConfigValidationPtr_t>&
+                           validations,
+                           size_type chunkSize, size_type begin,
+                           size_type step, FirstFailure& failure);
+
+      size_type numberThreads_;
     }; // class Discretized
     /// \}
     } // namespace pathValidation
@@ -24,6 +24,8 @@
 
 namespace hpp {
   namespace core {
+    class ValidationOrdering;
+
     /// \addtogroup validation
     /// \{
 
@@ -50,12 +52,45 @@ namespace hpp {
 			     PathPtr_t& validPart,
 			     PathValidationReportPtr_t& report);
 
+      /// Compute whether a path is valid for all the path validations
+      /// \sa PathValidation::isValid
+      virtual bool isValid (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime);
+
       /// Add a path validation object
+      ///
+      /// It gets the deadline of this object.
       virtual void addPathValidation (const PathValidationPtr_t& pathValidation);
 
+      /// Set the deadline of this object and of the path validations
+      virtual void deadline (const DeadlinePtr_t& deadline);
+      using PathValidation::deadline;
+
+      /// Enable or disable the adaptive ordering of the path validations
+      ///
+      /// When enabled, the rejection rate and the average duration of each
+      /// path validation are measured, and the path validations are
+      /// periodically sorted by decreasing rejection rate per second. Each
+      /// path validation checks the valid part found by the previous ones,
+      /// so that evaluating first the cheap validations that often fail
+      /// shortens the path checked by the expensive ones. Measures are
+      /// reset when a path validation is added. Disabled by default.
+      /// \sa ConfigValidations::adaptiveOrdering
+      void adaptiveOrdering (bool enable);
+
+      /// Whether path validations are adaptively ordered
+      bool adaptiveOrdering () const
+      {
+        return (bool) ordering_;
+      }
+
       virtual ~PathValidations () {};
     protected:
       PathValidations ();
+
+    private:
+      /// Null when adaptive ordering is disabled
+      boost::shared_ptr <ValidationOrdering> ordering_;
     }; // class PathValidations
     /// \}
   } // namespace core
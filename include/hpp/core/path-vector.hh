@@ -22,6 +22,7 @@
 # include <hpp/pinocchio/device.hh>
 # include <hpp/core/fwd.hh>
 # include <hpp/core/path.hh>
+# include <hpp/core/pooled-allocation.hh>
 
 namespace hpp {
   namespace core {
@@ -33,6 +34,9 @@ namespace hpp {
     {
     public:
       typedef Path parent_t;
+
+      HPP_CORE_POOLED_ALLOCATION (PathVector)
+
       /// \name Construction, destruction, copy
       /// \{
 
@@ -104,9 +108,18 @@ namespace hpp {
       /// \param param parameter in interval of definition,
       /// \retval localParam parameter on sub-path
       /// \return rank of direct path in vector
+      ///
+      /// The rank is found by a binary search in the cumulative lengths of
+      /// the sub-paths. The rank found by the previous call is tried first,
+      /// so that monotone sweeps along the path take constant time.
       std::size_t rankAtParam (const value_type& param, value_type& localParam) const;
 
       /// Append a path at the end of the vector
+      ///
+      /// If path is a PathVector, neither constrained nor time
+      /// parameterized, its sub-paths are appended instead so that the
+      /// evaluation does not descend nested path vectors. Classes deriving
+      /// from PathVector are appended as such.
       void appendPath (const PathPtr_t& path);
 
       /// Concatenate two vectors of path
@@ -142,12 +155,12 @@ namespace hpp {
       /// Constructor
       PathVector (std::size_t outputSize, std::size_t outputDerivativeSize) :
 	parent_t (std::make_pair (0, 0), outputSize, outputDerivativeSize),
-	paths_ ()
+	paths_ (), ends_ (), lastRank_ (0)
 	  {
 	  }
       ///Copy constructor
       PathVector (const PathVector& path) : parent_t (path),
-	paths_ ()
+	paths_ (), ends_ (path.ends_), lastRank_ (0)
 	  {
 	    assert (timeRange() == path.timeRange());
 	    for (Paths_t::const_iterator it = path.paths_.begin ();
@@ -159,7 +172,8 @@ namespace hpp {
       ///Copy constructor with constraints
       PathVector (const PathVector& path,
 		  const ConstraintSetPtr_t& constraints) :
-	parent_t (path, constraints), paths_ ()
+	parent_t (path, constraints), paths_ (), ends_ (path.ends_),
+	lastRank_ (0)
 	  {
 	    assert (timeRange() == path.timeRange());
 	    for (Paths_t::const_iterator it = path.paths_.begin ();
@@ -174,19 +188,48 @@ namespace hpp {
 	weak_ = self;
       }
       virtual bool impl_compute (ConfigurationOut_t result, value_type t) const;
+      /// Evaluate each sub-path at the consecutive parameters lying on it.
+      virtual size_type impl_compute (matrixOut_t result, vectorIn_t params)
+        const;
       /// Virtual implementation of derivative
       virtual void impl_derivative (vectorOut_t result, const value_type& t,
 				    size_type order) const;
+      /// Derivative of each sub-path at the consecutive parameters lying on it.
+      virtual void impl_derivative (matrixOut_t result, vectorIn_t params,
+				    size_type order) const;
       /// Extraction of a sub-path
       /// \param subInterval interval of definition of the extract path
       virtual PathPtr_t impl_extract (const interval_t& subInterval) const;
 
     private:
+      /// Split parameters into runs of consecutive parameters on the same
+      /// sub-path.
+      /// \param params parameters along the path vector,
+      /// \param begin rank in params of the first parameter of the run,
+      /// \retval localParams parameters of the run on the sub-path.
+      /// \return the rank of the sub-path.
+      std::size_t run (vectorIn_t params, size_type begin,
+                       std::vector <value_type>& localParams) const;
+
+      /// Whether a parameter lies on a sub-path, as defined by rankAtParam
+      bool onPath (std::size_t rank, value_type param) const
+      {
+        return param <= ends_ [rank] && (rank == 0 || param > ends_ [rank-1]);
+      }
+
       Paths_t paths_;
+      /// Cumulative lengths of the sub-paths: ends_ [i] is the sum of the
+      /// lengths of the sub-paths of rank 0 to i.
+      std::vector <value_type> ends_;
+      /// Rank found by the last call to rankAtParam
+      ///
+      /// Only used as a hint: concurrent evaluations of the path may
+      /// overwrite it.
+      mutable std::size_t lastRank_;
       PathVectorWkPtr_t weak_;
 
     protected:
-      PathVector() {}
+      PathVector() : lastRank_ (0) {}
     private:
       HPP_SERIALIZABLE();
     }; // class PathVector
@@ -113,6 +113,16 @@ namespace hpp {
       /// \return a new path that is this one reversed.
       virtual PathPtr_t reverse () const;
 
+      /// Reversion of a path sharing the data of this one
+      ///
+      /// Unlike \ref reverse, the result is a window that runs this path
+      /// backward, whatever the type of this path, and reversing a
+      /// reversed view gives back this path. Roadmaps store the reverse of
+      /// bidirectional edges this way.
+      /// \note Paths with a time parameterization are reversed by
+      ///       \ref reverse.
+      virtual PathPtr_t reversedView () const;
+
       /// \}
 
       /// \name Evalutation of the path
@@ -151,6 +161,18 @@ namespace hpp {
         return this->operator() (result, time);
       }
 
+      /// Evaluate the path at several times.
+      /// \param times times in the definition interval,
+      /// \retval result configurations: column i is the configuration at
+      ///         times [i]. Should be allocated and of size
+      ///         outputSize () x times.size ().
+      /// \return the number of configurations successfully computed before
+      ///         the first failure, times.size () if all succeeded.
+      ///
+      /// The constraints are applied. Child classes may evaluate all the
+      /// configurations at once, see \ref impl_compute(matrixOut_t, vectorIn_t) const.
+      size_type eval (vectorIn_t times, matrixOut_t result) const;
+
       /// Get the configuration at a parameter without applying the constraints.
       bool at (const value_type& time, ConfigurationOut_t result) const
       {
@@ -169,6 +191,15 @@ namespace hpp {
       void derivative (vectorOut_t result, const value_type& time,
           size_type order) const;
 
+      /// Get derivatives with respect to parameter at several times
+      /// \param times times in the definition interval,
+      /// \param order order of the derivative
+      /// \retval result derivatives: column i is the derivative at
+      ///         times [i]. Should be allocated and of size
+      ///         outputDerivativeSize () x times.size ().
+      void derivative (vectorIn_t times, matrixOut_t result,
+          size_type order) const;
+
       /// Get an upper bound of the velocity on a sub-interval.
       /// The result is a coefficient-wise.
       ///               
@@ -254,6 +285,12 @@ namespace hpp {
         timeRange (tr);
       }
 
+      /// Get the time parameterization function, null for identity
+      const TimeParameterizationPtr_t& timeParameterization() const
+      {
+        return timeParam_;
+      }
+
       /// \}
 
     protected:
@@ -317,11 +354,6 @@ namespace hpp {
           paramRange_ = timeRange_;
       }
 
-      const TimeParameterizationPtr_t& timeParameterization() const
-      {
-        return timeParam_;
-      }
-
       value_type paramLength() const
       {
         return paramRange_.second - paramRange_.first;
@@ -342,6 +374,19 @@ namespace hpp {
       virtual bool impl_compute (ConfigurationOut_t configuration,
 				 value_type param) const = 0;
 
+      /// \brief Function evaluation at several parameters without applying
+      ///        constraints
+      /// \param params parameters within \ref paramRange
+      /// \retval configurations column i is the configuration at params [i].
+      /// \return the number of configurations successfully computed before
+      ///         the first failure.
+      ///
+      /// The default implementation calls
+      /// \ref impl_compute(ConfigurationOut_t, value_type) const for each
+      /// parameter.
+      virtual size_type impl_compute (matrixOut_t configurations,
+                                      vectorIn_t params) const;
+
       /// Virtual implementation of \ref derivative
       /// \param param parameter within \ref paramRange
       /// \param order order of derivation.
@@ -356,6 +401,18 @@ namespace hpp {
 	HPP_THROW_EXCEPTION (hpp::Exception, "not implemented");
       }
 
+      /// Virtual implementation of \ref derivative at several parameters
+      /// \param params parameters within \ref paramRange
+      /// \param order order of derivation.
+      /// \retval derivatives column i is the derivative at params [i].
+      ///
+      /// The default implementation calls
+      /// \ref impl_derivative(vectorOut_t, const value_type&, size_type) const
+      /// for each parameter.
+      virtual void impl_derivative (matrixOut_t derivatives,
+                                    vectorIn_t params,
+                                    size_type order) const;
+
       /// Virtual implementation of \ref velocityBound
       /// \param param0, param1 interval of parameter
       /// \retval bound
@@ -398,6 +455,7 @@ namespace hpp {
       PathWkPtr_t weak_;
       friend std::ostream& operator<< (std::ostream& os, const Path& path);
       friend class ExtractedPath;
+      friend class PathSampler;
 
     protected:
       Path() {}
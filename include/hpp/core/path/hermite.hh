@@ -126,13 +126,33 @@ namespace hpp {
           return end_;
         }
 
+        /// Length of the control polygon, negative if it was not computed
+        /// since the velocities were set
         const value_type& hermiteLength () const
         {
           return hermiteLength_;
         }
 
+        /// Length of a leg of the control polygon
+        /// \param i rank of the leg, 0, 1 or 2.
+        /// \pre \ref hermiteLength is not negative.
+        const value_type& legLength (std::size_t i) const
+        {
+          assert (i < 3 && hermiteLength_ >= 0);
+          return legLengths_ [i];
+        }
+
         void computeHermiteLength ();
 
+        /// Compute the length of the control polygon knowing the length of
+        /// the first and the last legs
+        ///
+        /// When a path is subdivided, the first leg of the first half is half
+        /// the first leg of the path, and the last leg of the first half is
+        /// the first leg of the second half. Only the middle leg is computed.
+        void computeHermiteLength (const value_type& firstLeg,
+                                   const value_type& lastLeg);
+
         vector_t velocity (const value_type& t) const;
 
       protected:
@@ -170,6 +190,7 @@ namespace hpp {
         DevicePtr_t device_;
         Configuration_t init_, end_;
         value_type hermiteLength_;
+        value_type legLengths_ [3];
 
         HermiteWkPtr_t weak_;
       }; // class Hermite
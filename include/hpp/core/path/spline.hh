@@ -303,8 +303,14 @@ namespace hpp {
 
           bool impl_compute (ConfigurationOut_t configuration, value_type t) const;
 
+          /// The velocities at all the parameters are computed by a single
+          /// product of the parameters with the matrix of basis functions.
+          size_type impl_compute (matrixOut_t configurations, vectorIn_t params) const;
+
           void impl_derivative (vectorOut_t res, const value_type& t, size_type order) const;
 
+          void impl_derivative (matrixOut_t res, vectorIn_t params, size_type order) const;
+
           void impl_paramDerivative (vectorOut_t res, const value_type& t) const;
 
           void impl_paramIntegrate (vectorIn_t dParam);
@@ -20,6 +20,8 @@
 # define HPP_CORE_PLAN_AND_OPTIMIZE_HH
 
 # include <vector>
+# include <boost/function.hpp>
+# include <boost/scoped_ptr.hpp>
 # include <hpp/core/config.hh>
 # include <hpp/core/path-planner.hh>
 
@@ -32,9 +34,16 @@ namespace hpp {
     ///
     /// Plans a path and iteratively applies a series of optimizer on
     /// the result.
+    ///
+    /// In pipelined mode (see \ref pipeline), the solutions found while
+    /// planning continues are optimized in separate threads and the
+    /// shortest optimized path is returned.
     class HPP_CORE_DLLAPI PlanAndOptimize : public PathPlanner
     {
     public:
+      typedef std::vector <PathOptimizerPtr_t> Optimizers_t;
+      typedef boost::function <Optimizers_t ()> OptimizersFactory_t;
+
       /// Return shared pointer to new object.
       static PlanAndOptimizePtr_t create (const PathPlannerPtr_t& pathPlanner);
       /// Call internal path planner implementation
@@ -44,12 +53,35 @@ namespace hpp {
       /// Optimize planned path
       virtual PathVectorPtr_t finishSolve (const PathVectorPtr_t& path);
       void addPathOptimizer (const PathOptimizerPtr_t& optimizer);
+
+      /// Optimize the intermediate solutions while planning continues
+      ///
+      /// The first solution of the planner, and the solutions it publishes
+      /// afterwards (see \ref solutionCallback), are optimized by at most
+      /// maxThreads threads. When all the threads are busy, only the latest
+      /// solution is kept for the next free thread. \ref finishSolve
+      /// optimizes the final path with the optimizers added by
+      /// \ref addPathOptimizer, waits for the threads and returns the
+      /// shortest result.
+      ///
+      /// \param factory returns the chain of optimizers of a thread. It is
+      ///        called in the thread of \ref solve. The optimizers must not
+      ///        share a steering method or a path validation with the
+      ///        planner: build them on a Problem using the tools of
+      ///        ProblemSolver::connectionTools. An empty factory disables
+      ///        the pipeline.
+      /// \throw std::invalid_argument if maxThreads is 0.
+      void pipeline (const OptimizersFactory_t& factory,
+                     size_type maxThreads = 1);
+
+      ~PlanAndOptimize ();
     protected:
       PlanAndOptimize (const PathPlannerPtr_t& pathPlanner);
     private:
-      typedef std::vector <PathOptimizerPtr_t> Optimizers_t;
+      struct Pipeline;
       const PathPlannerPtr_t pathPlanner_;
       Optimizers_t optimizers_;
+      boost::scoped_ptr <Pipeline> pipeline_;
     }; // class PlanAndOptimize
     /// \}
   } // namespace core
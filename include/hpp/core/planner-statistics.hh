@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_PLANNER_STATISTICS_HH
+# define HPP_CORE_PLANNER_STATISTICS_HH
+
+# include <iosfwd>
+
+# include <boost/chrono/system_clocks.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+# include <hpp/core/allocation-profile.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup path_planning
+    /// \{
+
+    /// Time spent by a path planner in each stage of the resolution
+    ///
+    /// Filled by PathPlanner::solve and by the planners that instrument
+    /// their steps, see PathPlanner::statistics.
+    ///
+    /// The planners also count the configurations they sample and the
+    /// causes of their rejection.
+    ///
+    /// If AllocationProfile is enabled, PathPlanner::solve also records the
+    /// allocations of each subsystem during the resolution.
+    class HPP_CORE_DLLAPI PlannerStatistics
+    {
+    public:
+      enum Stage {
+        /// Random configuration shoots
+        SAMPLING,
+        /// Nearest neighbor searches
+        NEAREST_NEIGHBOR,
+        /// Steering method calls
+        STEERING,
+        /// Projections of configurations and paths on the constraints
+        PROJECTION,
+        /// Path validations
+        VALIDATION,
+        /// Insertion of nodes and edges in the roadmap
+        INSERTION,
+        NUMBER_STAGES
+      };
+
+      /// Cause of the rejection of a sampled configuration
+      enum Rejection {
+        /// Projection on the constraints failed
+        PROJECTION_FAILURE,
+        /// Joint bounds violated, see JointBoundValidation
+        JOINT_BOUNDS,
+        /// Collision, see CollisionValidation
+        COLLISION,
+        /// Another configuration validation failed
+        OTHER_VALIDATION,
+        NUMBER_REJECTIONS
+      };
+
+      /// Measure the time spent in a scope
+      class ScopedTimer
+      {
+      public:
+        ScopedTimer (PlannerStatistics& statistics, Stage stage);
+        ~ScopedTimer ();
+      private:
+        PlannerStatistics& statistics_;
+        Stage stage_;
+        boost::chrono::steady_clock::time_point start_;
+      }; // class ScopedTimer
+
+      PlannerStatistics ();
+
+      /// Set all the counters to zero
+      void reset ();
+      /// Record a call to a stage
+      /// \param time duration of the call (in seconds)
+      void add (Stage stage, value_type time)
+      {
+        times_ [stage] += time;
+        ++counts_ [stage];
+      }
+      /// Total time spent in a stage (in seconds)
+      value_type time (Stage stage) const
+      {
+        return times_ [stage];
+      }
+      /// Number of calls to a stage
+      size_type count (Stage stage) const
+      {
+        return counts_ [stage];
+      }
+      /// Name of a stage
+      static const char* name (Stage stage);
+
+      /// Record sampled configurations
+      void sampled (size_type n = 1)
+      {
+        samples_ += n;
+      }
+      /// Number of sampled configurations
+      size_type samples () const
+      {
+        return samples_;
+      }
+      /// Record the rejection of a sampled configuration
+      void reject (Rejection cause)
+      {
+        ++rejections_ [cause];
+      }
+      /// Record the rejection of a sampled configuration by a
+      /// configuration validation
+      /// \param report the validation report, the type of which gives the
+      ///        cause of the rejection.
+      void reject (const ValidationReportPtr_t& report);
+      /// Number of sampled configurations rejected for a cause
+      size_type rejections (Rejection cause) const
+      {
+        return rejections_ [cause];
+      }
+      /// Name of a cause of rejection
+      static const char* name (Rejection cause);
+      /// Add the sampling counters of another instance, filled by a thread
+      void addSampling (const PlannerStatistics& other);
+
+      /// Record the allocations counted by AllocationProfile since a
+      /// snapshot
+      /// \note the counters of AllocationProfile are shared by all the
+      ///       threads, the allocations of other computations running
+      ///       meanwhile are included.
+      void allocationsSince (const AllocationProfile::Snapshot& start);
+      /// Allocations of a subsystem
+      const AllocationProfile::Counters& allocations
+      (AllocationProfile::Subsystem subsystem) const
+      {
+        return allocations_ [subsystem];
+      }
+
+      /// Number of calls to PathPlanner::oneStep
+      unsigned long int iterations;
+      /// Duration of PathPlanner::solve (in seconds)
+      value_type totalTime;
+
+    private:
+      value_type times_ [NUMBER_STAGES];
+      size_type counts_ [NUMBER_STAGES];
+      size_type samples_;
+      size_type rejections_ [NUMBER_REJECTIONS];
+      AllocationProfile::Counters allocations_
+      [AllocationProfile::NUMBER_SUBSYSTEMS];
+    }; // class PlannerStatistics
+
+    HPP_CORE_DLLAPI std::ostream& operator<< (std::ostream& os,
+                                              const PlannerStatistics& s);
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_PLANNER_STATISTICS_HH
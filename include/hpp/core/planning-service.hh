@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_PLANNING_SERVICE_HH
+# define HPP_CORE_PLANNING_SERVICE_HH
+
+# include <deque>
+# include <map>
+# include <string>
+# include <vector>
+
+# include <boost/chrono/system_clocks.hpp>
+# include <boost/thread/condition_variable.hpp>
+# include <boost/thread/mutex.hpp>
+# include <boost/thread/thread.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+# include <hpp/core/path-planner.hh>
+# include <hpp/core/problem-solver.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup path_planning
+    /// \{
+
+    /// Solve queued path planning requests with a pool of workers
+    ///
+    /// Each worker thread owns a Problem built from the problem of a
+    /// ProblemSolver as MultiStart does: a copy of the parameters, of the
+    /// distance and of the numerical constraints, the connection tools
+    /// ProblemSolver::connectionTools and a roadmap. The robot and the
+    /// configuration validations, with the obstacles, are shared. Requests
+    /// are served in the order of their submission by the first idle
+    /// worker, which clears its roadmap and runs a path planner of the
+    /// type of the request. If the solver has a
+    /// ProblemSolver::sharedRoadmap, requests are solved in it by a
+    /// MultiQuerySolver instead, and the shortest path to a goal is kept.
+    ///
+    /// The result of each request records the time it spent in the queue
+    /// and the time its resolution took.
+    ///
+    /// \warning Collision checking is thread safe if the robot has one
+    ///          pinocchio::DeviceData per worker, see
+    ///          pinocchio::Device::numberDeviceData. The solver must
+    ///          outlive the service and its problem must not be modified
+    ///          while the service runs. Paths are not optimized.
+    class HPP_CORE_DLLAPI PlanningService
+    {
+    public:
+      typedef std::size_t Ticket_t;
+
+      /// Path planning request
+      struct Request
+      {
+        Configuration_t init;
+        Configurations_t goals;
+        /// Type of path planner, see ProblemSolver::pathPlanners. If
+        /// empty, the type of the solver is used.
+        std::string pathPlannerType;
+        /// Maximal number of iterations. If 0, the value of the solver is
+        /// used.
+        unsigned long int maxIterations;
+        /// Time out in seconds. If not positive, the value of the solver
+        /// is used.
+        value_type timeOut;
+
+        Request () : maxIterations (0), timeOut (0) {}
+      }; // struct Request
+
+      /// Result of a request
+      struct Result
+      {
+        /// Path found, null if the resolution failed.
+        PathVectorPtr_t path;
+        /// Message of the exception thrown by the resolution, if any.
+        std::string error;
+        /// Time spent in the queue, in seconds.
+        value_type queueTime;
+        /// Time of the resolution, in seconds.
+        value_type solveTime;
+        /// Index of the worker that solved the request.
+        std::size_t worker;
+      }; // struct Result
+
+      /// Statistics of the requests solved so far
+      struct Statistics
+      {
+        std::size_t requests;
+        /// Number of requests without a path
+        std::size_t failures;
+        /// Sum of the times spent in the queue, in seconds
+        value_type queueTime;
+        /// Sum of the times of the resolutions, in seconds
+        value_type solveTime;
+        /// Maximal sum of the queue and resolution times of a request
+        value_type maxLatency;
+      }; // struct Statistics
+
+      /// Create the workers
+      /// \param solver provides the problem and the connection tools of
+      ///        the workers.
+      /// \param numberWorkers number of worker threads.
+      /// \throw std::invalid_argument if numberWorkers is not positive.
+      /// \throw std::runtime_error or std::logic_error if the solver has
+      ///        no problem or no steering method.
+      static PlanningServicePtr_t create (ProblemSolver& solver,
+                                          size_type numberWorkers);
+
+      /// Interrupt the running resolutions, drop the queued requests and
+      /// wait for the workers.
+      ~PlanningService ();
+
+      /// Queue a request
+      /// \return the ticket of the request.
+      /// \throw std::invalid_argument if the request has no goal or if its
+      ///        path planner type is not registered.
+      Ticket_t submit (const Request& request);
+
+      /// Whether a request is solved
+      /// \throw std::invalid_argument if the ticket is unknown.
+      bool done (Ticket_t ticket) const;
+      /// Wait for a request at most a given time
+      /// \param seconds maximal waiting time.
+      /// \return whether the request is solved.
+      /// \throw std::invalid_argument if the ticket is unknown.
+      bool wait (Ticket_t ticket, value_type seconds) const;
+      /// Wait for a request and get its result
+      ///
+      /// The ticket is released: it is unknown afterwards.
+      /// \throw std::invalid_argument if the ticket is unknown.
+      Result result (Ticket_t ticket);
+
+      /// Number of requests waiting for a worker
+      std::size_t pending () const;
+      /// Statistics of the requests solved so far
+      Statistics statistics () const;
+      /// Number of worker threads
+      std::size_t numberWorkers () const
+      {
+        return problems_.size ();
+      }
+
+    protected:
+      PlanningService (ProblemSolver& solver, size_type numberWorkers);
+
+    private:
+      typedef boost::chrono::steady_clock Clock_t;
+
+      struct Job
+      {
+        Request request;
+        /// Builder of the path planner of the request
+        PathPlannerBuilder_t builder;
+        Clock_t::time_point submitted;
+        Result result;
+        bool done;
+      }; // struct Job
+      typedef std::map <Ticket_t, Job> Jobs_t;
+
+      /// Loop of a worker thread
+      void run (std::size_t worker);
+      /// Solve a request in the problem of a worker
+      PathVectorPtr_t solve (std::size_t worker, const Job& job);
+      /// Interrupt the planner of a worker if the service is stopped
+      void checkStop (std::size_t worker,
+                      const PathPlanner::Progress& progress);
+      /// Job of a ticket
+      /// \throw std::invalid_argument if the ticket is unknown.
+      const Job& job (Ticket_t ticket) const;
+
+      ProblemSolver& solver_;
+      std::vector <ProblemPtr_t> problems_;
+      std::vector <RoadmapPtr_t> roadmaps_;
+      /// Planner running in each worker, if any
+      std::vector <PathPlannerPtr_t> planners_;
+
+      Jobs_t jobs_;
+      std::deque <Ticket_t> queue_;
+      Ticket_t nextTicket_;
+      Statistics statistics_;
+      bool stopped_;
+      /// Protects the above members
+      mutable boost::mutex mutex_;
+      /// Notified when a request is queued or the service is stopped
+      boost::condition_variable queued_;
+      /// Notified when a request is solved
+      mutable boost::condition_variable solved_;
+      boost::thread_group threads_;
+    }; // class PlanningService
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_PLANNING_SERVICE_HH
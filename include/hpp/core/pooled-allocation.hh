@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_POOLED_ALLOCATION_HH
+# define HPP_CORE_POOLED_ALLOCATION_HH
+
+# include <cstddef>
+# include <new>
+
+# include <boost/pool/singleton_pool.hpp>
+
+/// Allocate the instances of a class in a memory pool
+///
+/// To be put in the public part of the class definition. Objects of the
+/// exact class are allocated in a thread safe pool of blocks of the size of
+/// the class, shared by all the instances. Classes deriving from it are
+/// allocated with the global operator new.
+///
+/// Memory freed by destroyed objects is kept in the pool to be reused by
+/// the next ones: this avoids the cost of the general purpose allocator
+/// when many short-lived objects are created, like paths in the path
+/// optimizers.
+# define HPP_CORE_POOLED_ALLOCATION(Class)                                     \
+  static void* operator new (std::size_t size)                                \
+  {                                                                           \
+    if (size != sizeof (Class)) return ::operator new (size);                 \
+    void* p = boost::singleton_pool <Class, sizeof (Class)>::malloc ();       \
+    if (!p) throw std::bad_alloc ();                                          \
+    return p;                                                                 \
+  }                                                                           \
+  static void operator delete (void* p, std::size_t size)                     \
+  {                                                                           \
+    if (!p) return;                                                           \
+    if (size != sizeof (Class)) ::operator delete (p);                        \
+    else boost::singleton_pool <Class, sizeof (Class)>::free (p);             \
+  }
+
+#endif // HPP_CORE_POOLED_ALLOCATION_HH
@@ -19,8 +19,13 @@
 #ifndef HPP_CORE_PROBLEM_SOLVER_HH
 # define HPP_CORE_PROBLEM_SOLVER_HH
 
+# include <limits>
 # include <stdexcept>
+# include <vector>
 # include <boost/function.hpp>
+# include <boost/unordered_map.hpp>
+
+# include <hpp/fcl/BV/AABB.h>
 
 # include <hpp/pinocchio/fwd.hh>
 
@@ -28,6 +33,8 @@
 # include <hpp/core/config.hh>
 # include <hpp/core/deprecated.hh>
 # include <hpp/core/container.hh>
+# include <hpp/core/path-planner.hh>
+# include <hpp/core/path-optimizer.hh>
 
 namespace hpp {
   namespace core {
@@ -176,6 +183,13 @@ namespace hpp {
       /// \note each intermediate optimization output is stored in this object.
       void optimizePath (PathVectorPtr_t path);
 
+      /// Get the counters of the last call to optimizePath by the
+      /// optimizer at given rank
+      /// \throw std::out_of_range if there is no optimizer at this rank.
+      /// \sa PathOptimizer::statistics
+      const PathOptimizer::Statistics& optimizerStatistics
+      (std::size_t rank) const;
+
       /// Set path validation method
       /// \param type name of new path validation method
       /// \param tolerance acceptable penetration for path validation
@@ -223,6 +237,55 @@ namespace hpp {
 	return roadmap_;
       }
 
+      /// Set a roadmap shared with other solvers
+      ///
+      /// When a shared roadmap is set, \ref solve connects the initial and
+      /// goal configurations to it with a MultiQuerySolver instead of
+      /// running the path planner. The connections are not inserted in the
+      /// shared roadmap, so that several solvers may use it concurrently.
+      /// Set a null pointer to plan again.
+      void sharedRoadmap (const SharedRoadmapPtr_t& roadmap)
+      {
+        sharedRoadmap_ = roadmap;
+      }
+
+      const SharedRoadmapPtr_t& sharedRoadmap () const
+      {
+        return sharedRoadmap_;
+      }
+
+      /// Set the executor of the parallel tasks
+      ///
+      /// The executor is given to the path planner, to the MultiQuerySolver
+      /// of \ref sharedRoadmap and runs the parallel construction of
+      /// obstacles. Plugins should submit their parallel tasks to it as
+      /// well, so that several parallel components do not run more threads
+      /// than the executor. By default, the executor has one thread per
+      /// processor. If null, each parallel task runs in its own thread.
+      void executor (const ExecutorPtr_t& executor)
+      {
+        executor_ = executor;
+      }
+
+      const ExecutorPtr_t& executor () const
+      {
+        return executor_;
+      }
+
+      /// Cache of the collision free cells of the collision validations
+      ///
+      /// If parameter "CollisionValidation/occupancyCache" names a file,
+      /// the cache is loaded from the file, or created if the file does not
+      /// exist, by the first call to initConfigValidation after the robot
+      /// is set. The cache is given to the CollisionValidation instances of
+      /// the problem and saved in the file when the robot changes and by
+      /// the destructor.
+      /// \sa OccupancyCache
+      const OccupancyCachePtr_t& occupancyCache () const
+      {
+        return occupancyCache_;
+      }
+
       /// \name Constraints
       /// \{
 
@@ -341,11 +404,57 @@ namespace hpp {
       /// Create new problem.
       virtual void resetProblem ();
 
+      /// Prepare a new query in the current problem
+      ///
+      /// The initial and goal configurations are removed, the target is
+      /// reset to goal configurations and the roadmap is cleared. Unlike
+      /// \ref resetProblem, the problem is kept with its validations,
+      /// collision pairs and distance. If a path was planned since the
+      /// problem was created, the next call to \ref solve keeps also the
+      /// steering method, the configuration shooter and the path projector
+      /// and only builds a new path planner.
+      /// \note With a \ref sharedRoadmap, the connections of the queries
+      ///       are not stored and the shared roadmap is left unchanged.
+      /// \note The kept objects do not see later changes of the
+      ///        constraints. Call \ref resetProblem in that case.
+      virtual void resetQuery ();
+
       /// Reset the roadmap.
       /// \note When joints bounds are changed, the roadmap must be reset
       ///       because the kd tree must be resized.
       virtual void resetRoadmap ();
 
+      /// Keep the roadmap when obstacles are added or moved
+      ///
+      /// If true, adding or updating an obstacle checked for collision
+      /// does not reset the roadmap. Instead, the edges of the roadmap are
+      /// validated again in one batch at the beginning of the next call to
+      /// \ref solve or \ref prepareSolveStepByStep. If some edges are
+      /// found invalid, the roadmap is rebuilt without them, and the
+      /// connected components are split accordingly. Successive queries
+      /// in the same environment thus reuse the exploration of the
+      /// previous ones. The new initial and goal configurations are
+      /// connected to the roadmap by PathPlanner::tryConnectInitAndGoals.
+      ///
+      /// Only the edges that the changes may affect are validated again.
+      /// The box bounding each changed obstacle, before and after a move,
+      /// is recorded and compared to the swept volume of the edges, see
+      /// Edge::sweptVolume, computed at the first change from the bounding
+      /// spheres of the robot geometries at configurations sampled along
+      /// the path every \c WarmStart/sweptVolumeStep and inflated by
+      /// \c WarmStart/sweptVolumeMargin. An edge the clearance of which
+      /// is larger than the displacement of a moved obstacle is not
+      /// affected by the move. Removing an obstacle keeps the roadmap.
+      void warmStart (bool warmStart)
+      {
+        warmStart_ = warmStart;
+      }
+      /// Whether the roadmap is kept when obstacles are added or moved
+      bool warmStart () const
+      {
+        return warmStart_;
+      }
+
       /// \name Solve problem and get paths
       /// \{
 
@@ -373,6 +482,37 @@ namespace hpp {
       /// Set and solve the problem
       virtual void solve ();
 
+      /// Time spent in each stage of the last path planning
+      /// \throw std::logic_error if no path planner was created.
+      /// \sa PathPlanner::statistics
+      const PlannerStatistics& plannerStatistics () const;
+
+      /// Create the tools of a worker thread
+      ///
+      /// The tools do not share any mutable state with those of the problem
+      /// nor with those of other workers:
+      /// \li the steering method is a copy of the one of the problem,
+      /// \li the path validation and the path projector are new instances
+      ///     of the selected types, set up as those of the problem,
+      /// \li the configuration shooter is a new instance of the selected
+      ///     type that draws from stream index of the random generator of
+      ///     the problem.
+      ///
+      /// \param index index of the worker, should be different from 0 and
+      ///        from the indices of the other workers.
+      /// \note The robot is shared. Collision checking uses one
+      ///       pinocchio::DeviceData per thread, see
+      ///       pinocchio::Device::numberDeviceData.
+      PathPlanner::ConnectionTools connectionTools (size_type index) const;
+
+      /// Factory of tools for worker threads
+      ///
+      /// The n-th call to the returned factory returns connectionTools (n),
+      /// starting from 1. It can be given to
+      /// PathPlanner::parallelConnections and to the planners that run
+      /// several workers.
+      PathPlanner::ConnectionToolsFactory_t connectionToolsFactory () const;
+
       /// Make direct connection between two configurations
       /// \param start, end: the configurations to link.
       /// \param validate whether path should be validated. If true, path
@@ -464,6 +604,28 @@ namespace hpp {
           bool collision,
           bool distance);
 
+      /// Add several obstacles to the list
+      ///
+      /// Same as calling addObstacle for each object, with the names
+      /// checked before any object is added and the roadmap reset once.
+      /// The bounding boxes of the geometries, computed by the FCL objects
+      /// of the geometry data, are computed by several threads.
+      /// \param names names of the obstacles,
+      /// \param objects new objects, in the same order as names,
+      /// \param collision whether collision checking should be performed
+      ///        for these objects,
+      /// \param distance whether distance computation should be performed
+      ///        for these objects,
+      /// \param numberThreads number of threads computing the bounding
+      ///        boxes. Objects sharing a geometry are handled by the same
+      ///        thread.
+      /// \throw std::runtime_error if a name is already used, in which case
+      ///        no object is added.
+      virtual void addObstacles (const std::vector <std::string>& names,
+                                 const std::vector <FclCollisionObject>& objects,
+                                 bool collision, bool distance,
+                                 size_type numberThreads = 1);
+
       /// Remove collision pair between a joint and an obstacle
       /// \param jointName name of the joint,
       /// \param obstacleName name of the obstacle
@@ -474,6 +636,24 @@ namespace hpp {
       /// \warning the obstacle is removed if there are not possible collision.
       void cutObstacle (const std::string& name, const fcl::AABB& aabb);
 
+      /// Move an obstacle
+      /// \param name name of the obstacle,
+      /// \param placement new placement of the obstacle in the world frame.
+      ///
+      /// The obstacle is updated in place: the collision pairs and the
+      /// validation methods are kept, and the roadmap is reset if the
+      /// obstacle is checked for collision.
+      /// \sa ObstacleUserInterface::updateObstacle
+      void moveObstacle (const std::string& name, const Transform3f& placement);
+
+      /// Replace the geometry of an obstacle
+      /// \param name name of the obstacle,
+      /// \param geometry new geometry, expressed in the frame of the obstacle.
+      ///
+      /// The obstacle is updated in place, as in \ref moveObstacle.
+      void replaceObstacleGeometry (const std::string& name,
+                                    const fcl::CollisionGeometryPtr_t& geometry);
+
       /// Build matrix of relative motions between joints
       ///
       /// Call Problem::filterCollisionPairs.
@@ -617,6 +797,8 @@ namespace hpp {
       PathPlannerPtr_t pathPlanner_;
       /// Store roadmap
       RoadmapPtr_t roadmap_;
+      /// Roadmap shared with other solvers, see sharedRoadmap
+      SharedRoadmapPtr_t sharedRoadmap_;
       /// Paths
       PathVectors_t paths_;
       /// Path projector method
@@ -630,6 +812,45 @@ namespace hpp {
       /// Shared pointer to the problem target
       ProblemTargetPtr_t target_;
     private:
+      /// Notify the problem that an obstacle was modified in place and
+      /// reset the roadmap if the obstacle is checked for collision
+      /// \param before box containing the obstacle before the update,
+      /// \param displacement see \ref obstacleChanged.
+      void obstacleUpdated (const pinocchio::GeomIndex& id,
+                            const fcl::AABB& before, value_type displacement =
+                            std::numeric_limits <value_type>::infinity ());
+
+      /// Find the index of an obstacle in \ref obstacleGeomModel
+      ///
+      /// The index is looked up in obstacleIndices_, which is rebuilt
+      /// if it does not match the model.
+      /// \return whether an obstacle is named name.
+      bool obstacleIndex (const std::string& name,
+                          pinocchio::GeomIndex& id) const;
+
+      /// Reset the roadmap, or mark its edges to be validated again if
+      /// \ref warmStart is true
+      /// \param box box containing the obstacle before and after the change,
+      /// \param displacement upper bound of the displacement of the points
+      ///        of the obstacle, infinite if its geometry changed.
+      void obstacleChanged (const fcl::AABB& box, value_type displacement =
+                            std::numeric_limits <value_type>::infinity ());
+      /// Validate again the edges of the roadmap after obstacles changed,
+      /// see \ref warmStart
+      void revalidateRoadmap ();
+      /// Whether the changes of the obstacles may invalidate an edge
+      ///
+      /// Computes the swept volume of the edge if unknown.
+      bool affected (const EdgePtr_t& edge);
+      /// Box containing the robot along a path
+      fcl::AABB sweptVolume (const PathPtr_t& path) const;
+      /// Box containing an obstacle at its current placement
+      fcl::AABB obstacleBox (const pinocchio::GeomIndex& id) const;
+      /// Solve the initial and goal configurations in \ref sharedRoadmap
+      /// \return the shortest path to a goal configuration.
+      /// \throw std::runtime_error if no goal configuration can be reached.
+      PathVectorPtr_t solveInSharedRoadmap () const;
+
       /// Shared pointer to initial configuration.
       ConfigurationPtr_t initConf_;
       /// Shared pointer to goal configuration.
@@ -658,6 +879,12 @@ namespace hpp {
       pinocchio::DataPtr_t  obstacleRData_;  // Contains the frames
       pinocchio::GeomModelPtr_t obstacleModel_;
       pinocchio::GeomDataPtr_t  obstacleData_;
+      /// Indices of the obstacles in obstacleModel_ by name
+      typedef Container <pinocchio::GeomIndex, std::string,
+                         boost::unordered_map <std::string,
+                                               pinocchio::GeomIndex> >
+        ObstacleIndices_t;
+      mutable ObstacleIndices_t obstacleIndices_;
       // Tolerance for numerical constraint resolution
       value_type errorThreshold_;
       // Maximal number of iterations for numerical constraint resolution
@@ -672,8 +899,33 @@ namespace hpp {
       CenterOfMassComputationMap_t comcMap_;
       /// Computation of distances to obstacles
       DistanceBetweenObjectsPtr_t distanceBetweenObjects_;
+      /// \copydoc warmStart
+      bool warmStart_;
+      /// Whether obstacles changed since the edges were validated
+      bool roadmapOutdated_;
+      /// Change of an obstacle checked for collision, see \ref warmStart
+      struct SceneChange
+      {
+        /// Box containing the obstacle before and after the change.
+        fcl::AABB box;
+        /// Upper bound of the displacement of the points of the obstacle.
+        value_type displacement;
+      }; // struct SceneChange
+      /// Changes of the obstacles since the edges were validated
+      std::vector <SceneChange> sceneChanges_;
+      /// Whether the next call to initProblem keeps the steering method,
+      /// configuration shooter and path projector, see \ref resetQuery
+      bool keepSetup_;
+      /// \copydoc executor
+      ExecutorPtr_t executor_;
+      /// \copydoc occupancyCache
+      OccupancyCachePtr_t occupancyCache_;
+      /// File of occupancyCache_
+      std::string occupancyFile_;
 
       void initProblem ();
+      /// Save the occupancy cache in its file, if any, and discard it
+      void resetOccupancyCache ();
     }; // class ProblemSolver
   } // namespace core
 } // namespace hpp
@@ -45,6 +45,19 @@ namespace hpp {
       /// Should be called when reached() returns true.
       virtual PathVectorPtr_t computePath(const RoadmapPtr_t& roadmap) const = 0;
 
+      /// Tag goal nodes found by the target itself
+      ///
+      /// Called by PathPlanner::startSolve, after the goal nodes of the
+      /// problem are tagged, and then after each step of PathPlanner::solve.
+      /// Does nothing by default.
+      /// \param newOnly whether only the goals found since the previous
+      ///        call should be tagged, false after the goal nodes of the
+      ///        roadmap were reset.
+      virtual void addGoalNodes (const RoadmapPtr_t& /*roadmap*/,
+                                 bool /*newOnly*/)
+      {
+      }
+
       /// Set the problem
       void problem (const ProblemPtr_t& problem)
       {
@@ -26,6 +26,8 @@
 
 namespace hpp {
   namespace core {
+    class GoalDistanceField;
+
     namespace problemTarget {
       /// \addtogroup path_planning
       /// \{
@@ -45,6 +47,11 @@ namespace hpp {
           /// in the same connected component.
           bool reached (const RoadmapPtr_t& roadmap) const;
 
+          /// Compute the shortest path to the goal nodes with A*
+          ///
+          /// If parameter "GoalConfigurations/distanceField" is true, the
+          /// cost to the goal nodes of every node is computed and reused by
+          /// the next calls as long as the roadmap is not modified.
           PathVectorPtr_t computePath(const RoadmapPtr_t& roadmap) const;
 
         protected:
@@ -52,6 +59,10 @@ namespace hpp {
           GoalConfigurations (const ProblemPtr_t& problem)
             : ProblemTarget (problem)
           {}
+
+        private:
+          /// Cost to the goal nodes, used as A* heuristic
+          mutable boost::shared_ptr <GoalDistanceField> distanceField_;
       }; // class GoalConfigurations
       /// \}
     } // namespace problemTarget
@@ -21,6 +21,7 @@
 
 # include <hpp/core/fwd.hh>
 # include <hpp/core/config.hh>
+# include <hpp/core/path-planner.hh>
 # include <hpp/core/problem-target.hh>
 
 namespace hpp {
@@ -33,34 +34,72 @@ namespace hpp {
       ///
       /// This class defines a goal using constraints. The set of goal
       /// configurations is a submanifold of the full configuration space.
+      /// Goal configurations can be sampled in background threads while
+      /// the planner runs, see \ref sampleGoals.
       /// \warning So far, this feature is not taken into account by
       /// most planners. The supported planners are:
       /// - DiffusingPlanner
       class HPP_CORE_DLLAPI TaskTarget : public ProblemTarget {
         public:
+          typedef PathPlanner::ConnectionTools ConnectionTools;
+          typedef PathPlanner::ConnectionToolsFactory_t
+            ConnectionToolsFactory_t;
+
           static TaskTargetPtr_t create (const ProblemPtr_t& problem);
 
           /// Check if the problem target is well specified.
           void check (const RoadmapPtr_t& roadmap) const;
 
-          /// Check whether the problem is solved.
+          /// Check whether a goal node is reachable from the initial node.
           bool reached (const RoadmapPtr_t& roadmap) const;
 
           PathVectorPtr_t computePath(const RoadmapPtr_t& roadmap) const;
 
+          /// Tag the goals sampled by \ref sampleGoals
+          virtual void addGoalNodes (const RoadmapPtr_t& roadmap, bool newOnly);
+
           void constraints (const ConstraintSetPtr_t& c)
           {
             constraints_ = c;
           }
 
+          /// Sample goal configurations in background threads
+          ///
+          /// Each thread projects the configurations of its shooter onto a
+          /// copy of the constraints and keeps the valid ones. The goals
+          /// are tagged in the roadmap by \ref addGoalNodes, after each
+          /// step of the planner, so that planning does not wait for the
+          /// goals. The threads stop after \c numberGoals goals, when
+          /// \ref stopSampling is called or when this object is destroyed.
+          /// \param factory called once per thread. Its steering method and
+          ///        path validation validate the goals.
+          /// \throw std::invalid_argument if a number is not positive or if
+          ///        the tools have no configuration shooter,
+          /// \throw std::runtime_error if the constraints are not set.
+          void sampleGoals (size_type numberThreads, size_type numberGoals,
+                            const ConnectionToolsFactory_t& factory);
+
+          /// Stop the threads of \ref sampleGoals and wait for them
+          ///
+          /// The goals already sampled are kept.
+          void stopSampling ();
+
+          /// Goals sampled by \ref sampleGoals so far
+          Configurations_t goals () const;
+
+          ~TaskTarget ();
+
         protected:
           /// Constructor
-          TaskTarget (const ProblemPtr_t& problem)
-            : ProblemTarget (problem)
-          {}
+          TaskTarget (const ProblemPtr_t& problem);
 
         private:
+          struct Sampler;
+
           ConstraintSetPtr_t constraints_;
+          boost::shared_ptr <Sampler> sampler_;
+          /// Number of goals tagged by the last call to \ref addGoalNodes
+          std::size_t added_;
       }; // class TaskTarget
       /// \}
     } // namespace problemTarget
@@ -29,6 +29,7 @@
 # include <hpp/core/steering-method.hh>
 # include <hpp/core/container.hh>
 # include <hpp/core/parameter.hh>
+# include <hpp/core/relative-motion.hh>
 
 namespace hpp {
   namespace core {
@@ -152,6 +153,8 @@ namespace hpp {
       /// \name Path validation
       /// \{
       /// Set path validation method
+      ///
+      /// The deadline of the problem is given to the path validation.
       virtual void pathValidation (const PathValidationPtr_t& pathValidation);
 
       /// Get path validation method
@@ -159,6 +162,15 @@ namespace hpp {
       {
 	return pathValidation_;
       }
+
+      /// Set up a path validation as the path validation of the problem
+      ///
+      /// Give the path validation the deadline, the obstacles and the
+      /// collision pairs filtered by the last call to filterCollisionPairs.
+      /// Path validations are not thread safe: each worker thread needs its
+      /// own instance, set up by this method.
+      void setupPathValidation (const PathValidationPtr_t& pathValidation)
+        const;
       /// \}
 
 
@@ -174,14 +186,49 @@ namespace hpp {
       }
       /// \}
 
-      /// \name Path projector
+      /// \name Random numbers
       /// \{
-      /// Set path projector method
-      void pathProjector (const PathProjectorPtr_t& pathProjector)
+
+      /// Get the stream of random numbers of the problem
+      ///
+      /// The default configuration shooter, the path planners and the path
+      /// optimizers draw from this stream. Objects used in other threads
+      /// should draw from streams obtained with RandomGenerator::split.
+      const RandomGeneratorPtr_t& randomGenerator () const
       {
-        pathProjector_ = pathProjector;
+        return randomGenerator_;
+      }
+      /// Set the stream of random numbers of the problem
+      ///
+      /// The configuration shooter of the problem keeps its own stream.
+      void randomGenerator (const RandomGeneratorPtr_t& generator)
+      {
+        randomGenerator_ = generator;
+      }
+      /// Restart the stream of random numbers of the problem from a seed
+      ///
+      /// Since planning is reproducible from the seed, this can be used to
+      /// run a planner several times with different random numbers.
+      void seed (size_type seed);
+      /// \}
+
+      /// Get the time budget of the resolution
+      ///
+      /// It is started by PathPlanner::solve and checked by the path
+      /// validation, the path projector and the path optimizers of the
+      /// problem, so that they stop cooperatively when it expires.
+      const DeadlinePtr_t& deadline () const
+      {
+        return deadline_;
       }
 
+      /// \name Path projector
+      /// \{
+      /// Set path projector method
+      ///
+      /// The deadline of the problem is given to the path projector.
+      void pathProjector (const PathProjectorPtr_t& pathProjector);
+
       /// Get path projector method
       PathProjectorPtr_t pathProjector () const
       {
@@ -223,6 +270,9 @@ namespace hpp {
       /// \param obstacle to remove.
       void removeObstacleFromJoint (const JointPtr_t& joint,
 				    const CollisionObjectConstPtr_t& obstacle);
+      /// Notify the validation methods that an obstacle was modified
+      /// \sa ObstacleUserInterface::updateObstacle
+      void updateObstacle (const CollisionObjectConstPtr_t& obstacle);
 
       /// Build matrix of relative motions between joints
       ///
@@ -241,8 +291,26 @@ namespace hpp {
       /// \note the matrix is passed to the current configuration validation
       ///    instance (Problem::configValidation) and to the current
       /// path validation instance (Problem::pathValidation).
+      /// If a self-collision analysis is set, pairs of joints that never or
+      /// always collide are also set as RelativeMotionType::Constrained.
+      ///
+      /// The matrix is kept between calls. If the numerical constraints of
+      /// the previous call are the first ones of the current constraints,
+      /// only the new constraints are processed.
       void filterCollisionPairs ();
 
+      /// Set the self-collision analysis used by filterCollisionPairs
+      void selfCollisionAnalysis (const SelfCollisionAnalysisPtr_t& analysis)
+      {
+        selfCollisionAnalysis_ = analysis;
+      }
+
+      /// Get the self-collision analysis used by filterCollisionPairs
+      const SelfCollisionAnalysisPtr_t& selfCollisionAnalysis () const
+      {
+        return selfCollisionAnalysis_;
+      }
+
       /// \copydoc ObstacleUserInterface::setSecurityMargins
       void setSecurityMargins(const matrix_t& securityMatrix);
 
@@ -257,8 +325,9 @@ namespace hpp {
       /// \param name of the parameter.
       const Parameter& getParameter (const std::string& name) const
       {
-        if (parameters.has(name))
-          return parameters.get(name);
+        Container<Parameter>::const_iterator it (parameters.map.find (name));
+        if (it != parameters.map.end ())
+          return it->second;
         else
           return parameterDescription(name).defaultValue();
       }
@@ -271,6 +340,15 @@ namespace hpp {
       ///        type.
       void setParameter (const std::string& name, const Parameter& value);
 
+      /// Number of calls to setParameter
+      ///
+      /// ParameterHandle objects compare it to the value of their last
+      /// lookup to detect changes.
+      const size_type& parametersRevision () const
+      {
+        return parametersRevision_;
+      }
+
       /// Declare a parameter
       /// In shared library, use the following snippet in your cc file:
       /// \code{.cpp}
@@ -290,6 +368,10 @@ namespace hpp {
       /// Access one parameter description
       static const ParameterDescription& parameterDescription (const std::string& name);
 
+      /// Values of the parameters set by the user
+      ///
+      /// Modify them with setParameter, so that ParameterHandle objects are
+      /// notified.
       Container < Parameter > parameters;
 
     protected:
@@ -324,6 +406,17 @@ namespace hpp {
       ConstraintSetPtr_t constraints_;
       /// Configuration shooter
       ConfigurationShooterPtr_t configurationShooter_;
+      /// Stream of random numbers
+      RandomGeneratorPtr_t randomGenerator_;
+      DeadlinePtr_t deadline_;
+      /// Analysis of the self-collision pairs
+      SelfCollisionAnalysisPtr_t selfCollisionAnalysis_;
+      /// Relative motion matrix of the last call to filterCollisionPairs
+      RelativeMotion::matrix_type relativeMotion_;
+      /// Numerical constraints taken into account in relativeMotion_
+      NumericalConstraints_t relativeMotionConstraints_;
+      /// Number of calls to setParameter
+      size_type parametersRevision_;
     }; // class Problem
     /// \}
   } // namespace core
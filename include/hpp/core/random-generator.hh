@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_RANDOM_GENERATOR_HH
+# define HPP_CORE_RANDOM_GENERATOR_HH
+
+# include <boost/cstdint.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup configuration_sampling
+    /// \{
+
+    /// Seedable and splittable stream of random numbers
+    ///
+    /// The n-th number of a stream is a hash of its key and of n, so that
+    /// streams are cheap to create and do not share any state. Streams
+    /// drawn in different threads are obtained with \ref split: a stream
+    /// only depends on the key of its parent and on its index, not on the
+    /// numbers already drawn. A run that draws all its random numbers from
+    /// streams derived from the same seed is thus reproducible, whatever
+    /// the interleaving of its threads.
+    ///
+    /// The class models the Boost.Random UniformRandomNumberGenerator
+    /// concept and can be used with Boost.Random distributions.
+    /// \note A stream must not be used by several threads at once.
+    class HPP_CORE_DLLAPI RandomGenerator
+    {
+    public:
+      typedef boost::uint64_t result_type;
+
+      /// Create a stream
+      static RandomGeneratorPtr_t create (result_type seed);
+
+      /// Create an independent stream
+      /// \param index index of the stream. Streams of different indices
+      ///        are independent of each other and of this stream.
+      RandomGeneratorPtr_t split (result_type index) const;
+
+      /// Restart the stream from a seed
+      void seed (result_type seed);
+
+      /// Draw an integer in [min (), max ()]
+      result_type operator() ();
+
+      static result_type min ()
+      {
+        return 0;
+      }
+      static result_type max ()
+      {
+        return ~(result_type) 0;
+      }
+
+      /// Draw a real number uniformly in [0, 1)
+      value_type uniform ()
+      {
+        return (value_type) ((*this) () >> 11) * (1. / 9007199254740992.);
+      }
+      /// Draw a real number uniformly in [lower, upper)
+      value_type uniform (value_type lower, value_type upper)
+      {
+        return lower + (upper - lower) * uniform ();
+      }
+      /// Draw an integer uniformly in [0, n)
+      size_type index (size_type n)
+      {
+        return (size_type) ((*this) () % (result_type) n);
+      }
+
+    protected:
+      RandomGenerator (result_type key);
+
+    private:
+      result_type key_;
+      result_type counter_;
+    }; // class RandomGenerator
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_RANDOM_GENERATOR_HH
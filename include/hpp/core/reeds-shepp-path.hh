@@ -79,6 +79,19 @@ namespace hpp {
                                    const std::vector<JointPtr_t> wheels,
 				   ConstraintSetPtr_t constraints);
 
+      /// Length of the shortest Reeds and Shepp curve between two
+      /// configurations, without building the path
+      /// \param init, end Start and end configurations,
+      /// \param rho The radius of a turn,
+      /// \param xyId, rzId ranks of the position and orientation of the
+      ///        robot in the configurations.
+      /// \note the length of the motion of the other degrees of freedom is
+      ///       not included.
+      static value_type curveLength (ConfigurationIn_t init,
+                                     ConfigurationIn_t end,
+                                     const value_type& rho,
+                                     size_type xyId, size_type rzId);
+
       /// Create copy and return shared pointer
       /// \param path path to copy
       static ReedsSheppPathPtr_t createCopy (const ReedsSheppPathPtr_t& path)
@@ -170,16 +183,6 @@ namespace hpp {
       // Compute path
       void buildReedsShepp (const JointPtr_t rz,
                             const std::vector<JointPtr_t> wheels);
-      // Setup path
-      void setupPath (const std::size_t& typeId, double t, double u=0.,
-                      double v=0., double w=0., double x=0.);
-
-      void CSC  (const vector2_t& xy, const vector2_t& csPhi, const double& phi);
-      void CCC  (const vector2_t& xy, const vector2_t& csPhi, const double& phi);
-      void CCCC (const vector2_t& xy, const vector2_t& csPhi, const double& phi);
-      void CCSC (const vector2_t& xy, const vector2_t& csPhi, const double& phi);
-      void CCSCC(const vector2_t& xy, const vector2_t& csPhi, const double& phi);
-
 
       DevicePtr_t device_;
       Configuration_t initial_;
@@ -71,6 +71,17 @@ namespace hpp {
           const DevicePtr_t& robot,
           const ConstraintSetPtr_t& constraint);
 
+      /// Fill the relative motion matrix with information extracted from
+      /// one constraint
+      ///
+      /// The matrix is updated incrementally: calling this method for each
+      /// numerical constraint of a ConstraintSet gives the same matrix as
+      /// the ConstraintSet version.
+      static void fromConstraint (
+          matrix_type& matrix,
+          const DevicePtr_t& robot,
+          const constraints::ImplicitConstPtr_t& constraint);
+
       /// Set the relative motion between two joints
       ///
       /// This does nothing if type is Unconstrained.
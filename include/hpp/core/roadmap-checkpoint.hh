@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_ROADMAP_CHECKPOINT_HH
+# define HPP_CORE_ROADMAP_CHECKPOINT_HH
+
+# include <string>
+# include <vector>
+
+# include <boost/cstdint.hpp>
+# include <boost/unordered_map.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup roadmap
+    /// \{
+
+    /// Append only stream of the modifications of a roadmap
+    ///
+    /// Each call to \ref checkpoint appends to the file the nodes and edges
+    /// added since the previous call, the edges validated since then, the
+    /// nodes and edges removed, and the initial and goal nodes if they
+    /// changed. The modifications are computed by the calling thread, which
+    /// must be the one that modifies the roadmap, while a background thread
+    /// writes them, so that planning goes on during the writing.
+    ///
+    /// Paths are not written: \ref load rebuilds the edges with
+    /// Roadmap::addEdge (n1, n2, steeringMethod, cost) so that the paths are
+    /// built on first access. A checkpoint interrupted by a crash is
+    /// ignored by \ref load.
+    ///
+    /// Periodic checkpoints can be written from PathPlanner::progressCallback.
+    ///
+    /// \note nodes and edges are identified by their address: the roadmap
+    ///       must not be cleared while checkpoints are written to the
+    ///       stream.
+    class HPP_CORE_DLLAPI RoadmapCheckpoint
+    {
+    public:
+      /// Version of the file format
+      static const boost::uint32_t fileVersion = 1;
+
+      /// Create a stream
+      /// \param roadmap the roadmap,
+      /// \param robot the robot the configurations of the roadmap belong
+      ///        to,
+      /// \param filename name of the file, truncated.
+      /// \throw std::runtime_error if the file cannot be written.
+      static RoadmapCheckpointPtr_t create (const RoadmapPtr_t& roadmap,
+                                            const DevicePtr_t& robot,
+                                            const std::string& filename);
+
+      /// Wait for the pending checkpoints to be written
+      ~RoadmapCheckpoint ();
+
+      /// Append the modifications of the roadmap since the last checkpoint
+      ///
+      /// Returns once the modifications are copied, before they are written.
+      /// \throw std::runtime_error if writing a previous checkpoint failed.
+      void checkpoint ();
+
+      /// Wait for the pending checkpoints to be written
+      /// \throw std::runtime_error if writing failed.
+      void wait ();
+
+      /// Number of checkpoints appended to the stream
+      size_type numberCheckpoints () const
+      {
+        return numberCheckpoints_;
+      }
+
+      /// Replay a stream
+      /// \param filename name of the file,
+      /// \param problem the distance and the robot of the problem are those
+      ///        of the roadmap, its steering method builds the paths of the
+      ///        edges.
+      /// \return a roadmap with the nodes and edges of the last complete
+      ///         checkpoint.
+      /// \throw std::runtime_error if the file cannot be read, is not a
+      ///        stream of the current version, or does not match the
+      ///        configuration size of the robot.
+      static RoadmapPtr_t load (const std::string& filename,
+                                const Problem& problem);
+
+    protected:
+      /// Constructor
+      RoadmapCheckpoint (const RoadmapPtr_t& roadmap,
+                         const DevicePtr_t& robot,
+                         const std::string& filename);
+
+    private:
+      struct Writer;
+      /// Node already written
+      struct NodeRecord
+      {
+        size_type index;
+        /// Detects nodes created at the address of a removed one
+        const Configuration_t* configuration;
+        bool alive;
+      }; // struct NodeRecord
+      /// Edge already written
+      struct EdgeRecord
+      {
+        size_type index;
+        size_type from, to;
+        bool validated, alive;
+      }; // struct EdgeRecord
+      typedef boost::unordered_map <const Node*, NodeRecord> NodeRecords_t;
+      typedef boost::unordered_map <const Edge*, EdgeRecord> EdgeRecords_t;
+
+      RoadmapPtr_t roadmap_;
+      boost::shared_ptr <Writer> writer_;
+      NodeRecords_t nodes_;
+      EdgeRecords_t edges_;
+      size_type numberNodes_, numberEdges_, numberCheckpoints_;
+      /// Index of the initial node followed by those of the goal nodes
+      std::vector <size_type> terminals_;
+    }; // class RoadmapCheckpoint
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_ROADMAP_CHECKPOINT_HH
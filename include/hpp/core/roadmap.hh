@@ -20,6 +20,12 @@
 # define HPP_CORE_ROADMAP_HH
 
 # include <iostream>
+# include <set>
+# include <utility>
+# include <vector>
+
+# include <boost/function.hpp>
+# include <boost/unordered_map.hpp>
 
 # include <hpp/core/fwd.hh>
 # include <hpp/core/config.hh>
@@ -29,6 +35,8 @@
 
 namespace hpp {
   namespace core {
+    class ConfigurationArena;
+
     /// \addtogroup roadmap
     /// \{
 
@@ -50,10 +58,22 @@ namespace hpp {
       /// connected component with this node.
       NodePtr_t addNode (const ConfigurationPtr_t& config);
 
-      NodePtr_t addNode (const Configuration_t& config)
-      {
-        return addNode (ConfigurationPtr_t (new Configuration_t(config)));
-      }
+      /// Add a node with given configuration
+      /// \param config configuration
+      ///
+      /// The configuration is copied in a storage owned by the roadmap.
+      /// \sa addNode (const ConfigurationPtr_t&)
+      NodePtr_t addNode (const Configuration_t& config);
+
+      /// Add nodes with given configurations
+      /// \param configurations matrix the columns of which are the
+      ///        configurations,
+      /// \return the new nodes, each one in a new connected component.
+      ///
+      /// The configurations are copied in a storage owned by the roadmap and
+      /// indexed by the nearest neighbor structure in one pass. Unlike
+      /// addNode, configurations are not compared to those of the roadmap.
+      NodeVector_t addNodes (const matrix_t& configurations);
 
       /// Get nearest node to a configuration in the roadmap.
       /// \param configuration configuration
@@ -69,6 +89,14 @@ namespace hpp {
         return nearestNode (*configuration, minDistance, reverse);
       }
 
+      /// Get nearest nodes to several configurations in the roadmap.
+      /// \param configurations matrix the columns of which are the
+      ///        configurations,
+      /// \param k number of nearest nodes to return for each configuration
+      /// \return k nearest nodes of each configuration
+      std::vector <Nodes_t> nearestNodes (const matrix_t& configurations,
+                                          size_type k);
+
       /// Get nearest node to a configuration in a connected component.
       /// \param configuration configuration
       /// \param connectedComponent the connected component
@@ -125,6 +153,13 @@ namespace hpp {
                                     const ConnectedComponentPtr_t& connectedComponent,
                                     value_type maxDistance);
 
+      /// Neighbor search with a maximal number of nodes.
+      /// \copydoc NearestNeighbor::withinBall(const Configuration_t&,const ConnectedComponentPtr_t&,value_type,size_type)
+      NodeVector_t nodesWithinBall (const Configuration_t& configuration,
+                                    const ConnectedComponentPtr_t& connectedComponent,
+                                    value_type maxDistance,
+                                    size_type maxNodes);
+
       /// Add a node and two edges
       /// \param from node from which the edge starts,
       /// \param to configuration to which the edge stops
@@ -165,17 +200,128 @@ namespace hpp {
                       const PathPtr_t path);
 
 
+      /// Nodes and edges inserted at once by addNodesAndEdges
+      ///
+      /// Nodes of the batch are referred to by their rank in the batch,
+      /// nodes of the roadmap by pointer. Edges are validated.
+      class HPP_CORE_DLLAPI Batch
+      {
+      public:
+        /// Node of the roadmap or rank of a node of the batch
+        struct NodeRef
+        {
+          NodeRef (const NodePtr_t& n) : node (n), rank (0) {}
+          NodeRef (std::size_t r) : node (0x0), rank (r) {}
+          NodePtr_t node;
+          std::size_t rank;
+        }; // struct NodeRef
+
+        /// Add a node
+        /// \return the rank of the node in the batch.
+        std::size_t addNode (const ConfigurationPtr_t& configuration)
+        {
+          configurations_.push_back (configuration);
+          return configurations_.size () - 1;
+        }
+        /// Add an oriented edge
+        /// \sa Roadmap::addEdge
+        void addEdge (const NodeRef& from, const NodeRef& to,
+                      const PathPtr_t& path)
+        {
+          edges_.push_back (Edge_t (from, to, path, false));
+        }
+        /// Add an edge and its reverse
+        /// \sa Roadmap::addEdges
+        void addEdges (const NodeRef& from, const NodeRef& to,
+                       const PathPtr_t& path)
+        {
+          edges_.push_back (Edge_t (from, to, path, true));
+        }
+        std::size_t numberNodes () const
+        {
+          return configurations_.size ();
+        }
+        const ConfigurationPtr_t& configuration (std::size_t rank) const
+        {
+          return configurations_ [rank];
+        }
+        bool empty () const
+        {
+          return configurations_.empty () && edges_.empty ();
+        }
+        void clear ()
+        {
+          configurations_.clear ();
+          edges_.clear ();
+        }
+      private:
+        struct Edge_t
+        {
+          Edge_t (const NodeRef& f, const NodeRef& t, const PathPtr_t& p,
+                  bool b) : from (f), to (t), path (p), bothWays (b) {}
+          NodeRef from, to;
+          PathPtr_t path;
+          bool bothWays;
+        }; // struct Edge_t
+        std::vector <ConfigurationPtr_t> configurations_;
+        std::vector <Edge_t> edges_;
+        friend class Roadmap;
+      }; // class Batch
+
+      /// Insert the nodes and edges of a batch
+      /// \return the new nodes, in the order of the batch.
+      ///
+      /// The result is the same as inserting the nodes and edges one by one
+      /// with addNodeAndEdge(s) and addEdge(s): a node of the batch joins
+      /// the connected component of the first node an edge of the batch
+      /// connects it to, and edges in both directions merge the connected
+      /// components of their nodes. Unlike one by one insertions, the
+      /// connected components are computed in one union-find pass, each
+      /// merge of connected components of the roadmap is done once and the
+      /// nodes are indexed by the nearest neighbor structure in one pass.
+      /// Configurations are not compared to those of the roadmap.
+      /// \throw std::invalid_argument if an edge refers to a rank out of
+      ///        the batch. The roadmap is not modified then.
+      NodeVector_t addNodesAndEdges (const Batch& batch);
+
       /// Add an edge between two nodes.
+      /// \param validated whether the path is known to be valid. Edges that
+      ///        are not validated do not connect connected components,
+      ///        see validateEdge.
+      EdgePtr_t addEdge (const NodePtr_t& n1, const NodePtr_t& n2,
+			 const PathPtr_t& path, bool validated = true);
+
+      /// Add an edge the path of which is built on first access
+      ///
+      /// The path is built by the steering method the first time
+      /// Edge::path is called, so that roadmaps loaded from files do not
+      /// build the paths of the edges no query uses.
+      /// \param steeringMethod builds the path, see Edge,
+      /// \param cost cost of the edge until a cost is given to the
+      ///        roadmap, see edgeCost,
+      /// \param validated see addEdge.
       EdgePtr_t addEdge (const NodePtr_t& n1, const NodePtr_t& n2,
-			 const PathPtr_t& path);
+			 const SteeringMethodPtr_t& steeringMethod,
+                         value_type cost, bool validated = true);
 
       /// Add two edges between two nodes
       /// \param from first node
       /// \param to second node
       /// \param path path going from <c>from</c> to <c>to</c>.
       /// the reverse edge is added with the reverse path.
+      /// \param validated whether the path is known to be valid.
       void addEdges (const NodePtr_t from, const NodePtr_t& to,
-		     const PathPtr_t& path);
+		     const PathPtr_t& path, bool validated = true);
+
+      /// Mark an edge as validated and connect the connected components
+      /// of its nodes.
+      void validateEdge (const EdgePtr_t& edge);
+
+      /// Remove and delete an edge that has not been validated
+      ///
+      /// \throw std::logic_error if the edge is validated, since removing
+      ///        it might split a connected component.
+      void removeEdge (const EdgePtr_t& edge);
 
       /// Add a goal configuration
       /// \param config configuration
@@ -186,6 +332,7 @@ namespace hpp {
       void resetGoalNodes ()
       {
 	goalNodes_.clear ();
+        ++revision_;
       }
 
       void initNode (const ConfigurationPtr_t& config)
@@ -196,6 +343,15 @@ namespace hpp {
       virtual ~Roadmap ();
       /// Check that a path exists between the initial node and one goal node.
       bool pathExists () const;
+      /// Remove nodes until the roadmap has at most maxNodes nodes
+      ///
+      /// Only leaves are removed, farthest from the initial and goal nodes
+      /// first. A leaf is a node, other than the initial and goal nodes,
+      /// the edges of which all connect it to a single node of its
+      /// connected component. Connected components are thus not modified.
+      /// \return the number of removed nodes.
+      /// \warning removed nodes and their edges are deleted.
+      size_type prune (size_type maxNodes);
       const Nodes_t& nodes () const
       {
 	return nodes_;
@@ -212,9 +368,64 @@ namespace hpp {
       {
 	return goalNodes_;
       }
+      /// Number of modifications of the roadmap
+      ///
+      /// The revision changes each time a node, an edge or a goal node is
+      /// added, when nodes or edges are removed or validated, when the cost
+      /// of edges changes, when goal nodes are reset and when the roadmap is
+      /// cleared.
+      /// It can be used to invalidate data computed on the roadmap.
+      size_type revision () const
+      {
+        return revision_;
+      }
       /// Get list of connected component of the roadmap
       const ConnectedComponents_t& connectedComponents () const;
 
+      /// \name Cost of edges used by graph searches
+      /// \{
+      typedef boost::function <value_type (const Edge&)> EdgeCost_t;
+      /// Set cost of edges
+      ///
+      /// The costs of the edges of the roadmap are recomputed. Costs of
+      /// edges inserted later are computed on insertion.
+      /// \param cost cost functor. If empty, the cost is the path length.
+      /// \note the functor is not serialized.
+      void edgeCost (const EdgeCost_t& cost);
+      /// Get cost of edges
+      const EdgeCost_t& edgeCost () const
+      {
+        return edgeCost_;
+      }
+      /// Cost that an edge holding path would have
+      /// \param clearance clearance of the path, negative if unknown.
+      value_type cost (const PathPtr_t& path, value_type clearance) const;
+      /// Store the clearance of an edge and recompute its cost
+      /// \sa Edge::clearance
+      void clearance (const EdgePtr_t& edge, value_type clearance);
+      /// Store the swept volume of an edge
+      /// \sa Edge::sweptVolume
+      void sweptVolume (const EdgePtr_t& edge, const fcl::AABB& volume);
+
+      /// Edge cost penalizing the paths close to obstacles
+      ///
+      /// The cost of an edge of length \f$ l \f$ and clearance \f$ c \f$ is
+      /// \f$ l (1 + w / \max (c, c_{min})) \f$. The cost of an edge of
+      /// unknown clearance is its length, a lower bound of its cost.
+      struct HPP_CORE_DLLAPI ClearanceCost
+      {
+        /// \param weight weight \f$ w \f$ of the clearance,
+        /// \param minClearance \f$ c_{min} \f$, should be positive.
+        ClearanceCost (value_type weight, value_type minClearance) :
+          weight_ (weight), minClearance_ (minClearance)
+        {
+        }
+        value_type operator() (const Edge& edge) const;
+      private:
+        value_type weight_, minClearance_;
+      }; // struct ClearanceCost
+      /// \}
+
       /// Get nearestNeighbor object
       NearestNeighborPtr_t nearestNeighbor();
 
@@ -225,7 +436,74 @@ namespace hpp {
       /// \{
       /// Get distance function
       const DistancePtr_t& distance () const;
+      /// Distance between the configurations of two nodes
+      ///
+      /// When the distance cache is enabled, distances are stored for each
+      /// ordered pair of nodes, so that they are computed once.
+      /// \sa distanceCacheSize
+      value_type distance (const NodePtr_t& n1, const NodePtr_t& n2);
+      /// Set the maximal number of node pairs in the distance cache
+      ///
+      /// The cache is emptied when it is full, when nodes are removed and
+      /// when the roadmap is cleared.
+      /// \param size 0, the default, disables the cache.
+      void distanceCacheSize (size_type size);
+      /// Get the maximal number of node pairs in the distance cache
+      size_type distanceCacheSize () const
+      {
+        return distanceCacheSize_;
+      }
+      /// \}
+
+      /// \name Statistics
+      /// \{
+
+      /// Sizes and estimated memory of a roadmap
+      struct HPP_CORE_DLLAPI Statistics
+      {
+        Statistics ();
+        /// Total estimated memory (in bytes)
+        std::size_t bytes () const;
+
+        size_type nodes, edges, connectedComponents;
+        /// Number of edges the path of which is not built yet
+        /// \sa Edge::deferred
+        size_type deferredEdges;
+        /// Average number of edges leaving a node
+        value_type averageDegree;
+        /// Nodes, their configurations and their lists of edges (in bytes)
+        std::size_t nodeBytes;
+        /// Edges (in bytes)
+        std::size_t edgeBytes;
+        /// Paths of the edges (in bytes)
+        std::size_t pathBytes;
+        /// Nearest neighbor structure (in bytes)
+        /// \sa NearestNeighbor::memory
+        std::size_t nearestNeighborBytes;
+        /// Connected components and their reachability sets (in bytes)
+        std::size_t connectedComponentBytes;
+        /// Distance cache (in bytes), see distanceCacheSize
+        std::size_t distanceCacheBytes;
+        /// Maximal depth of the nearest neighbor tree
+        /// \sa NearestNeighbor::depth
+        size_type treeDepth;
+        /// Average depth of the nodes in the nearest neighbor tree
+        /// \sa NearestNeighbor::averageDepth
+        value_type treeAverageDepth;
+      }; // struct Statistics
+
+      /// Compute the sizes and the memory of the roadmap
+      ///
+      /// Memory is estimated from the size of the objects and of the
+      /// elements of their containers, without the overhead of the
+      /// allocator. A path accounts for class Path and its initial and end
+      /// configurations, path vectors for their elementary paths. Paths
+      /// shared by several edges are counted once, deferred edges hold no
+      /// path.
+      /// \note the cost is linear in the number of nodes and edges.
+      Statistics statistics () const;
       /// \}
+
       /// Print roadmap in a stream
       std::ostream& print (std::ostream& os) const;
 
@@ -234,7 +512,7 @@ namespace hpp {
       /// \param distance distance function for nearest neighbor computations
       Roadmap (const DistancePtr_t& distance, const DevicePtr_t& robot);
 
-      Roadmap () {};
+      Roadmap () : revision_ (0), distanceCacheSize_ (0) {};
 
       /// Add a new connected component in the roadmap.
       /// \param node node pointing to the connected component.
@@ -279,15 +557,27 @@ namespace hpp {
       NodePtr_t addNode (const ConfigurationPtr_t& config,
 			 ConnectedComponentPtr_t connectedComponent);
 
+      /// Create a node in a new connected component without checking
+      /// whether the configuration is already in the roadmap.
+      NodePtr_t addNewNode (const ConfigurationPtr_t& config);
+
+      /// Compute and store the cost of an edge
+      void computeCost (const EdgePtr_t& edge) const;
+
+      /// Remove and delete leaves and their edges
+      void removeLeaves (const std::set <NodePtr_t>& leaves);
+
       /// Update the graph of connected components after new connection
       /// \param cc1, cc2 the two connected components that have just been
       /// connected.
       void connect (const ConnectedComponentPtr_t& cc1,
 		    const ConnectedComponentPtr_t& cc2);
 
-      /// Merge two connected components
-      /// \param cc1 the connected component to merge into
-      /// \param the connected components to merge into cc1.
+      /// Merge connected components
+      /// \param cc1, ccs the connected components to merge.
+      ///
+      /// The connected components are merged into the one with the most
+      /// nodes.
       void merge (const ConnectedComponentPtr_t& cc1,
 		  ConnectedComponent::RawPtrs_t& ccs);
 
@@ -298,11 +588,22 @@ namespace hpp {
       NodePtr_t initNode_;
       NodeVector_t goalNodes_;
       NearestNeighborPtr_t nearestNeighbor_;
+      /// Storage of configurations copied by addNode (const Configuration_t&)
+      boost::shared_ptr <ConfigurationArena> configurationArena_;
+      EdgeCost_t edgeCost_;
+      size_type revision_;
+      typedef boost::unordered_map <std::pair <const Node*, const Node*>,
+                                    value_type> DistanceCache_t;
+      /// Distances between pairs of nodes, see distance (NodePtr_t, NodePtr_t)
+      DistanceCache_t distanceCache_;
+      size_type distanceCacheSize_;
       RoadmapWkPtr_t weak_;
 
       HPP_SERIALIZABLE();
     }; // class Roadmap
     std::ostream& operator<< (std::ostream& os, const Roadmap& r);
+    HPP_CORE_DLLAPI std::ostream& operator<< (std::ostream& os,
+                                              const Roadmap::Statistics& s);
     /// \}
   } //   namespace core
 } // namespace hpp
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_SELF_COLLISION_ANALYSIS_HH
+# define HPP_CORE_SELF_COLLISION_ANALYSIS_HH
+
+# include <iosfwd>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+# include <hpp/core/relative-motion.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup validation
+    /// \{
+
+    /// Offline analysis of the self-collision pairs of a robot
+    ///
+    /// Random configurations are shot and the number of configurations
+    /// in which each pair of joints is in collision is counted. The pairs
+    /// of joints tested are the ones holding the active collision pairs
+    /// of the robot geometry model. Pairs that never or always collide
+    /// over the samples can be disabled in the collision validation
+    /// methods with \ref filter and ObstacleUserInterface::filterCollisionPairs,
+    /// see Problem::selfCollisionAnalysis.
+    ///
+    /// The result can be saved to and loaded from a text stream to avoid
+    /// running the analysis each time the robot is loaded.
+    /// \note a small number of samples may disable pairs that collide in
+    ///       rare configurations.
+    class HPP_CORE_DLLAPI SelfCollisionAnalysis
+    {
+    public:
+      enum PairStatus {
+        /// The pair is not checked for collision by the robot
+        NotTested,
+        /// The pair was in collision in none of the samples
+        NeverCollide,
+        /// The pair was in collision in some of the samples
+        SometimesCollide,
+        /// The pair was in collision in all of the samples
+        AlwaysCollide
+      };
+
+      static SelfCollisionAnalysisPtr_t create (const DevicePtr_t& robot);
+
+      /// Shoot configurations and count collisions of each pair of joints
+      /// \param shooter configuration shooter,
+      /// \param nbSamples number of configurations, should be positive.
+      ///
+      /// Previous results are discarded.
+      void run (const ConfigurationShooterPtr_t& shooter, size_type nbSamples);
+
+      /// Number of samples of the analysis
+      size_type numberSamples () const
+      {
+        return numberSamples_;
+      }
+
+      /// Status of a pair of joints
+      /// \param jointA, jointB indices of the joints in the robot model.
+      PairStatus status (size_type jointA, size_type jointB) const;
+
+      /// Set pairs that never or always collide as Constrained
+      /// \param matrix relative motion matrix, see RelativeMotion::matrix.
+      void filter (RelativeMotion::matrix_type& matrix) const;
+
+      /// Write the result of the analysis
+      ///
+      /// The number of samples is written on the first line, followed by
+      /// one line per tested pair of joints with the names of the joints and
+      /// the number of samples in collision.
+      void save (std::ostream& os) const;
+
+      /// Read the result of an analysis written by \ref save
+      /// \throw std::runtime_error if the stream is not well formed or if a
+      ///        joint name is not in the robot model.
+      void load (std::istream& is);
+
+    protected:
+      SelfCollisionAnalysis (const DevicePtr_t& robot);
+
+    private:
+      typedef Eigen::Matrix <size_type, Eigen::Dynamic, Eigen::Dynamic>
+      Counts_t;
+
+      DevicePtr_t robot_;
+      size_type numberSamples_;
+      /// Number of samples in collision of each pair of joints, -1 for
+      /// pairs that are not tested
+      Counts_t collisions_;
+    }; // class SelfCollisionAnalysis
+    /// \}
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_SELF_COLLISION_ANALYSIS_HH
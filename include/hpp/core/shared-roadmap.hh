@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_SHARED_ROADMAP_HH
+# define HPP_CORE_SHARED_ROADMAP_HH
+
+# include <vector>
+
+# include <boost/thread/mutex.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup roadmap
+    /// \{
+
+    /// Read only roadmap shared between solvers
+    ///
+    /// The roadmap is frozen at creation: its graph is copied in a
+    /// CompactRoadmap, and it must not be modified afterwards. The methods
+    /// are const and may be called concurrently, so that one instance
+    /// serves the MultiQuerySolver of several problems, each keeping its
+    /// own connections of the start and goal configurations.
+    ///
+    /// \sa ProblemSolver::sharedRoadmap
+    class HPP_CORE_DLLAPI SharedRoadmap
+    {
+    public:
+      /// Freeze a roadmap
+      static SharedRoadmapPtr_t create (const RoadmapPtr_t& roadmap);
+
+      /// The frozen roadmap
+      /// \note do not modify it.
+      const RoadmapPtr_t& roadmap () const
+      {
+        return roadmap_;
+      }
+
+      /// Copy of the graph of the roadmap
+      const CompactRoadmapPtr_t& compact () const
+      {
+        return compact_;
+      }
+
+      /// Nearest nodes of several configurations
+      /// \sa Roadmap::nearestNodes (const matrix_t&, size_type)
+      ///
+      /// Searches of concurrent calls are serialized, since the nearest
+      /// neighbor structures of roadmaps are not all safe for concurrent
+      /// searches.
+      std::vector <Nodes_t> nearestNodes (const matrix_t& configurations,
+                                          size_type k) const;
+
+    protected:
+      /// Constructor
+      SharedRoadmap (const RoadmapPtr_t& roadmap);
+
+    private:
+      RoadmapPtr_t roadmap_;
+      CompactRoadmapPtr_t compact_;
+      mutable boost::mutex mutex_;
+    }; // class SharedRoadmap
+    /// \}
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_SHARED_ROADMAP_HH
@@ -21,9 +21,11 @@
 
 # include <hpp/util/debug.hh>
 
+# include <hpp/core/allocation-profile.hh>
 # include <hpp/core/fwd.hh>
 # include <hpp/core/path.hh>
 # include <hpp/core/projection-error.hh>
+# include <hpp/core/trace.hh>
 
 namespace hpp {
   namespace core {
@@ -46,6 +48,8 @@ namespace hpp {
       PathPtr_t operator() (ConfigurationIn_t q1,
 			    ConfigurationIn_t q2) const
       {
+        HPP_CORE_TRACE_SPAN ("SteeringMethod");
+        HPP_CORE_ALLOCATION_SCOPE (STEERING);
         PathPtr_t path;
         try {
           path = impl_compute (q1, q2);
@@ -62,9 +66,26 @@ namespace hpp {
         return this->operator() (q1, q2);
       }
 
+      /// Create paths from a configuration to several configurations
+      /// \param q1 initial configuration,
+      /// \param targets matrix the columns of which are the final
+      ///        configurations,
+      /// \retval paths paths [i] goes from q1 to targets.col (i). It is
+      ///         empty if the path could not be built.
+      void steer (ConfigurationIn_t q1, matrixIn_t targets,
+                  std::vector <PathPtr_t>& paths) const
+      {
+        HPP_CORE_ALLOCATION_SCOPE (STEERING);
+        paths.assign (targets.cols (), PathPtr_t ());
+        impl_compute (q1, targets, paths);
+      }
+
       virtual ~SteeringMethod () {};
 
       /// Copy instance and return shared pointer
+      ///
+      /// The copy does not share any mutable state with this instance and
+      /// can be used in another thread.
       virtual SteeringMethodPtr_t copy () const = 0;
 
       const Problem& problem() const
@@ -110,6 +131,21 @@ namespace hpp {
       /// create a path between two configurations
       virtual PathPtr_t impl_compute (ConfigurationIn_t q1,
 				      ConfigurationIn_t q2) const = 0;
+      /// Create paths from a configuration to several configurations
+      ///
+      /// Derived class may implement this function to share computations
+      /// between the paths. The default implementation calls
+      /// SteeringMethod::operator() for each column. paths has the right
+      /// size and is filled with empty pointers.
+      /// \note a class that overrides this function should be overriden
+      ///       again by derived classes that override
+      ///       impl_compute (ConfigurationIn_t, ConfigurationIn_t).
+      virtual void impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+                                 std::vector <PathPtr_t>& paths) const
+      {
+        for (size_type i = 0; i < targets.cols (); ++i)
+          paths [i] = this->operator() (q1, targets.col (i));
+      }
       /// Store weak pointer to itself.
       void init (SteeringMethodWkPtr_t weak)
       {
@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_STEERING_METHOD_CACHED_HH
+# define HPP_CORE_STEERING_METHOD_CACHED_HH
+
+# include <boost/thread/mutex.hpp>
+
+# include <hpp/core/config.hh>
+# include <hpp/core/fwd.hh>
+# include <hpp/core/steering-method/fwd.hh>
+# include <hpp/core/steering-method.hh>
+
+namespace hpp {
+  namespace core {
+    namespace steeringMethod {
+      /// \addtogroup steering_method
+      /// \{
+
+      /// Cache of the paths built by another steering method
+      ///
+      /// The least recently used paths are kept, keyed by their initial and
+      /// end configurations, the constraints of this steering method and
+      /// the right hand side of their configuration projector. A path
+      /// found in the cache is copied, so that callers never share a path.
+      /// Steering twice between the same configurations, as
+      /// PathPlanner::tryDirectPath and PathPlanner::tryConnectInitAndGoals
+      /// or shortcut optimizers do, thus builds the path once. This pays
+      /// off for expensive steering methods, for instance ReedsShepp or
+      /// Spline with constraints.
+      ///
+      /// The constraints of this steering method are passed to the
+      /// steering method computing the paths before each computation.
+      /// The numbers of hits and misses are recorded as Trace counters.
+      ///
+      /// \note Code that casts the steering method of the problem to its
+      ///       type, for instance to access a
+      ///       steeringMethod::ReedsShepp, does not see through the cache.
+      class HPP_CORE_DLLAPI Cached : public SteeringMethod
+      {
+      public:
+        /// Create a cache
+        /// \param steeringMethod the steering method computing the paths,
+        /// \param cacheSize maximal number of paths stored.
+        /// \throw std::invalid_argument if cacheSize is not positive.
+        static CachedPtr_t create (const SteeringMethodPtr_t& steeringMethod,
+                                   size_type cacheSize);
+        /// Copy instance and return shared pointer
+        ///
+        /// The steering method computing the paths is copied, the cache is
+        /// not.
+        static CachedPtr_t createCopy (const CachedPtr_t& other);
+        /// Copy instance and return shared pointer
+        virtual SteeringMethodPtr_t copy () const
+        {
+          return createCopy (weak_.lock ());
+        }
+
+        /// Steering method computing the paths
+        const SteeringMethodPtr_t& steeringMethod () const
+        {
+          return steeringMethod_;
+        }
+
+        /// Maximal number of paths stored
+        size_type cacheSize () const
+        {
+          return cacheSize_;
+        }
+
+        /// Number of paths found in the cache
+        size_type cacheHits () const;
+
+        /// Number of paths computed by the steering method
+        size_type cacheMisses () const;
+
+        /// Discard the paths stored in the cache
+        void clearCache ();
+
+      protected:
+        Cached (const SteeringMethodPtr_t& steeringMethod,
+                size_type cacheSize);
+        Cached (const Cached& other);
+
+        /// Build a path, unless it is in the cache
+        virtual PathPtr_t impl_compute (ConfigurationIn_t q1,
+                                        ConfigurationIn_t q2) const;
+
+        /// Build the paths missing in the cache in one call to
+        /// SteeringMethod::steer of the steering method
+        virtual void impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+                                   std::vector <PathPtr_t>& paths) const;
+
+        /// Store weak pointer to itself
+        void init (CachedWkPtr_t weak)
+        {
+          SteeringMethod::init (weak);
+          weak_ = weak;
+        }
+
+      private:
+        struct Cache;
+
+        /// Find a path in the cache
+        /// \return a copy of the path, or a null pointer.
+        PathPtr_t find (ConfigurationIn_t q1, ConfigurationIn_t q2,
+                        const vector_t& rhs) const;
+        /// Store a path in the cache
+        void insert (ConfigurationIn_t q1, ConfigurationIn_t q2,
+                     const vector_t& rhs, const PathPtr_t& path) const;
+        /// Right hand side of the configuration projector, if any
+        vector_t rightHandSide () const;
+
+        SteeringMethodPtr_t steeringMethod_;
+        size_type cacheSize_;
+        mutable size_type cacheHits_;
+        mutable size_type cacheMisses_;
+        boost::shared_ptr <Cache> cache_;
+        /// Protects the cache and the counters
+        mutable boost::mutex mutex_;
+        CachedWkPtr_t weak_;
+      }; // class Cached
+      /// \}
+    } // namespace steeringMethod
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_STEERING_METHOD_CACHED_HH
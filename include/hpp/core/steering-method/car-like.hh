@@ -58,6 +58,32 @@ namespace hpp {
           /// - the bounds of the joint wheel are saturated.
           void computeRadius ();
 
+          /// Turning radius
+          value_type turningRadius () const
+          {
+            return rho_;
+          }
+
+          /// Rank of joint XY in the configurations
+          size_type xyRank () const
+          {
+            return xyId_;
+          }
+
+          /// Rank of joint RZ in the configurations
+          size_type rzRank () const
+          {
+            return rzId_;
+          }
+
+          /// Lower bound of the length of the paths between two
+          /// configurations: the distance between the positions of joint XY.
+          value_type lengthLowerBound (ConfigurationIn_t q1,
+                                       ConfigurationIn_t q2) const
+          {
+            return (q2.segment<2> (xyId_) - q1.segment<2> (xyId_)).norm ();
+          }
+
         protected:
           /// Constructor
           CarLike (const Problem& problem);
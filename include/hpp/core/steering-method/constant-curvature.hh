@@ -86,6 +86,17 @@ namespace hpp {
           return end_;
         }
 
+        /// Rotation rate of the robot around the center of the arc
+        ///
+        /// \return the derivative of the orientation with respect to the
+        ///         parameter if the robot moves rigidly, i.e. if the degrees
+        ///         of freedom other than the position, the orientation and
+        ///         the wheels are constant, 0 otherwise or if the path is
+        ///         straight.
+        /// \note Every point of a robot moving rigidly along an arc moves on
+        ///       a circle at this rate.
+        value_type rigidAngularVelocity () const;
+
       protected:
         /// Print path in a stream
         virtual std::ostream& print (std::ostream &os) const;
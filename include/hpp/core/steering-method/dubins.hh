@@ -85,6 +85,22 @@ namespace hpp {
             return createCopy (weak_.lock ());
           }
 
+          /// Length of the path between two configurations
+          ///
+          /// Same as the length of the path returned by impl_compute, but
+          /// the path is not built.
+          value_type length (ConfigurationIn_t q1, ConfigurationIn_t q2) const;
+
+          /// Lengths of the paths from several configurations to a
+          /// configuration
+          /// \param q1s matrix the columns of which are initial
+          ///        configurations,
+          /// \param q2 final configuration,
+          /// \retval lengths lengths [i] is the length of the path from
+          ///         q1s.col (i) to q2.
+          void lengths (matrixIn_t q1s, ConfigurationIn_t q2,
+                        vector_t& lengths) const;
+
           /// create a path between two configurations
           virtual PathPtr_t impl_compute (ConfigurationIn_t q1,
               ConfigurationIn_t q2) const;
@@ -110,6 +126,12 @@ namespace hpp {
           }
 
         private:
+          /// Length due to the motion of the degrees of freedom that are
+          /// not steered by the Dubins curve.
+          /// \param qEnd buffer of the size of q2.
+          value_type extraLength (ConfigurationIn_t q1, ConfigurationIn_t q2,
+                                  Configuration_t& qEnd) const;
+
           DubinsWkPtr_t weak_;
       }; // Dubins
       /// \}
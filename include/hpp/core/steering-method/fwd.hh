@@ -39,6 +39,8 @@ namespace hpp {
       template <int _PolynomeBasis, int _Order> class Spline;
       HPP_PREDEF_CLASS (Hermite);
       typedef boost::shared_ptr <Hermite> HermitePtr_t;
+      HPP_PREDEF_CLASS (Cached);
+      typedef boost::shared_ptr <Cached> CachedPtr_t;
     } // namespace steeringMethod
 
     /// \deprecated use steeringMethod::Straight instead
@@ -84,6 +84,12 @@ namespace hpp {
             return createCopy (weak_.lock ());
           }
 
+          /// Length of the path between two configurations
+          ///
+          /// Same as the length of the path returned by impl_compute, but
+          /// the path is not built.
+          value_type length (ConfigurationIn_t q1, ConfigurationIn_t q2) const;
+
           /// create a path between two configurations
           virtual PathPtr_t impl_compute (ConfigurationIn_t q1,
               ConfigurationIn_t q2) const;
@@ -109,6 +115,11 @@ namespace hpp {
           }
 
         private:
+          /// Length due to the motion of the degrees of freedom that are
+          /// not steered by the Reeds and Shepp curve.
+          value_type extraLength (ConfigurationIn_t q1,
+              ConfigurationIn_t q2) const;
+
           ReedsSheppWkPtr_t weak_;
       }; // ReedsShepp
       /// \}
@@ -19,6 +19,9 @@
 #ifndef HPP_CORE_STEERING_METHOD_SPLINE_HH
 # define HPP_CORE_STEERING_METHOD_SPLINE_HH
 
+# include <map>
+# include <vector>
+
 # include <hpp/util/debug.hh>
 # include <hpp/util/pointer.hh>
 
@@ -75,7 +78,26 @@ namespace hpp {
           virtual PathPtr_t impl_compute (ConfigurationIn_t q1,
               ConfigurationIn_t q2) const;
 
+          /// create paths from a configuration to several configurations
+          ///
+          /// The constraint matrix of the interpolation problem does not
+          /// depend on the configurations. Its pseudo-inverse is computed
+          /// once, see \ref steer.
+          virtual void impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+              std::vector <PathPtr_t>& paths) const;
+
+          using SteeringMethod::steer;
+
           /// create a path between two configurations
+          ///
+          /// The interpolation problem is written in the time free basis,
+          /// so its matrix only depends on the derivative orders. Its
+          /// pseudo-inverse is computed at the first call for given orders
+          /// and reused by the next ones, so that steering is a matrix
+          /// product.
+          /// \note The pseudo-inverse for the default orders is computed at
+          ///       construction. Other orders modify the instance: use a
+          ///       copy per thread.
           PathPtr_t steer (ConfigurationIn_t q1, std::vector<int> order1, matrixIn_t derivatives1,
                            ConfigurationIn_t q2, std::vector<int> order2, matrixIn_t derivatives2) const;
 
@@ -100,7 +122,19 @@ namespace hpp {
               ConfigurationIn_t q1, std::vector<int> order1,  const Eigen::MatrixBase<Derived>& derivatives1,
               ConfigurationIn_t q2, std::vector<int> order2,  const Eigen::MatrixBase<Derived>& derivatives2) const;
 
+          typedef Eigen::Matrix<value_type, SplineOrder+1, Eigen::Dynamic>
+            Inverse_t;
+          typedef std::pair<std::vector<int>, std::vector<int> > Orders_t;
+
+          /// Pseudo-inverse of the matrix of the interpolation problem
+          /// \param order1, order2 orders of the derivatives constrained at
+          ///        the beginning and at the end of the path.
+          const Inverse_t& inverse (const std::vector<int>& order1,
+                                    const std::vector<int>& order2) const;
+
           DeviceWkPtr_t device_;
+          /// Pseudo-inverses computed so far, indexed by derivative orders
+          mutable std::map<Orders_t, Inverse_t> inverses_;
           WkPtr_t weak_;
       }; // Spline
       /// \}
@@ -74,6 +74,13 @@ namespace hpp {
         /// create a path between two configurations
         virtual PathPtr_t impl_compute (ConfigurationIn_t q1,
                                         ConfigurationIn_t q2) const;
+
+        /// create paths from a configuration to several configurations
+        ///
+        /// The minimal times of each axis are computed for all the targets
+        /// at once.
+        virtual void impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+                                   std::vector <PathPtr_t>& paths) const;
         
         /**
          * @brief computeMinTime compute the minimum time required to go from state (p1,v1) to (p2,v2)
@@ -131,6 +138,19 @@ namespace hpp {
         bool orientedPath_;
         bool orientationIgnoreZValue_;
       private:
+        /// Whether each of the first three configuration parameters is
+        /// steered
+        Eigen::Array<bool, 3, 1> steeredAxes () const;
+
+        /// Create the path given the minimal time of each axis
+        /// \param minimalTimes, sigma, twoSegment as computed by
+        ///        bangBang::minimalTimes.
+        PathPtr_t createPath (ConfigurationIn_t q1, ConfigurationIn_t q2,
+                              const Eigen::Array<bool, 3, 1>& steered,
+                              const Eigen::Array<value_type, 3, 1>& minimalTimes,
+                              const Eigen::Array<value_type, 3, 1>& sigma,
+                              const Eigen::Array<bool, 3, 1>& twoSegment) const;
+
         DeviceWkPtr_t device_;
         KinodynamicWkPtr_t weak_;
       }; // Kinodynamic
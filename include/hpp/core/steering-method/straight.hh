@@ -62,6 +62,12 @@ namespace hpp {
           virtual PathPtr_t impl_compute (ConfigurationIn_t q1,
               ConfigurationIn_t q2) const;
 
+          /// create paths from a configuration to several configurations
+          ///
+          /// The right hand side of the constraints is computed once.
+          virtual void impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+              std::vector <PathPtr_t>& paths) const;
+
         protected:
           /// Constructor with robot
           /// Weighed distance is created from robot
@@ -24,6 +24,7 @@
 # include <hpp/core/fwd.hh>
 # include <hpp/core/config.hh>
 # include <hpp/core/path.hh>
+# include <hpp/core/pooled-allocation.hh>
 
 namespace hpp {
   namespace core {
@@ -43,6 +44,9 @@ namespace hpp {
     {
     public:
       typedef Path parent_t;
+
+      HPP_CORE_POOLED_ALLOCATION (StraightPath)
+
       /// Destructor
       virtual ~StraightPath () {}
 
@@ -206,9 +210,15 @@ namespace hpp {
 
       virtual bool impl_compute (ConfigurationOut_t result,
 				 value_type param) const;
+      /// Integrate the velocity of the path, computed once, from the initial
+      /// configuration.
+      virtual size_type impl_compute (matrixOut_t result,
+                                      vectorIn_t params) const;
       /// Virtual implementation of derivative
       virtual void impl_derivative (vectorOut_t result, const value_type& t,
 				    size_type order) const;
+      virtual void impl_derivative (matrixOut_t result, vectorIn_t params,
+				    size_type order) const;
 
       virtual void impl_velocityBound (vectorOut_t result, const value_type&, const value_type&) const;
 
@@ -224,9 +234,12 @@ namespace hpp {
       Configuration_t end_;
     private:
       StraightPathWkPtr_t weak_;
+      /// Whether space_ is a vector space, in which case configurations
+      /// are interpolated linearly without going through the Lie group.
+      bool vectorSpace_;
 
     protected:
-      StraightPath() {}
+      StraightPath() : vectorSpace_ (false) {}
     private:
       HPP_SERIALIZABLE();
     }; // class StraightPath
@@ -53,10 +53,21 @@ namespace hpp {
       }
 
       /// \copydoc SubchainPath::SubchainPath
+      ///
+      /// The selection of a subchain path is composed with the selection
+      /// of the latter, so that evaluation goes through one decorator only.
       static SubchainPathPtr_t
       create (const PathPtr_t& original, const segments_t& confIntervals,
           const segments_t& velIntervals)
       {
+        SubchainPathPtr_t subchain (HPP_DYNAMIC_PTR_CAST (SubchainPath,
+                                                          original));
+        if (subchain && !subchain->constraints ())
+          return create (subchain->original_,
+                         compose (subchain->configView_.indices (),
+                                  confIntervals),
+                         compose (subchain->velView_.indices (),
+                                  velIntervals));
         SubchainPath* ptr = new SubchainPath (original, confIntervals, velIntervals);
         SubchainPathPtr_t shPtr (ptr);
         ptr->init (shPtr);
@@ -85,6 +96,8 @@ namespace hpp {
       virtual bool impl_compute (ConfigurationOut_t result,
 				 value_type param) const
       {
+        // All the parameters selected in order: result is the output.
+        if (identity_) return (*original_) (result, param);
         bool success = (*original_) (q_, param);
         if (success) dofExtract (q_, result);
         return success;
@@ -133,12 +146,18 @@ namespace hpp {
 	Path (original->timeRange(), Eigen::BlockIndex::cardinal(confIntervals),
             Eigen::BlockIndex::cardinal(velIntervals)),
 	original_ (original), configView_ (confIntervals),
+        velView_ (velIntervals),
+        identity_ (confIntervals.size () == 1 &&
+                   confIntervals [0].first == 0 &&
+                   confIntervals [0].second == original->outputSize ()),
         q_ (Configuration_t::Zero(original->outputSize()))
       {}
 
       SubchainPath (const SubchainPath& path) : Path (path),
 						  original_ (path.original_),
                                                   configView_ (path.configView_),
+                                                  velView_ (path.velView_),
+                                                  identity_ (path.identity_),
                                                   q_ (path.q_),
 						  weak_ ()
       {
@@ -147,7 +166,8 @@ namespace hpp {
       SubchainPath (const SubchainPath& path,
 		     const ConstraintSetPtr_t& constraints) :
 	Path (path, constraints), original_ (path.original_),
-	configView_ (path.configView_), weak_ ()
+	configView_ (path.configView_), velView_ (path.velView_),
+        identity_ (path.identity_), q_ (path.q_), weak_ ()
       {
       }
 
@@ -158,8 +178,33 @@ namespace hpp {
       }
 
     private:
+      /// Indices of the parameters selected by inner among the parameters
+      /// selected by outer
+      static segments_t compose (const segments_t& outer,
+                                 const segments_t& inner)
+      {
+        std::vector <size_type> indices;
+        for (std::size_t i = 0; i < outer.size (); ++i)
+          for (size_type k = 0; k < outer [i].second; ++k)
+            indices.push_back (outer [i].first + k);
+        segments_t result;
+        for (std::size_t i = 0; i < inner.size (); ++i) {
+          for (size_type k = 0; k < inner [i].second; ++k) {
+            const size_type index (indices [inner [i].first + k]);
+            if (!result.empty () &&
+                result.back ().first + result.back ().second == index)
+              ++result.back ().second;
+            else
+              result.push_back (segment_t (index, 1));
+          }
+        }
+        return result;
+      }
+
       PathPtr_t original_;
       Eigen::RowBlockIndices configView_, velView_;
+      /// Whether all the configuration parameters are selected in order
+      bool identity_;
       mutable Configuration_t q_;
       SubchainPathWkPtr_t weak_;
     }; // SubchainPath
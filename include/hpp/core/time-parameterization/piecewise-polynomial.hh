@@ -0,0 +1,134 @@
+// Copyright (c) 2018, Joseph Mirabel
+// Authors: Joseph Mirabel (joseph.mirabel@laas.fr)
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_TIME_PARAMETERIZATION_PIECEWISE_POLYNOMIAL_HH
+# define HPP_CORE_TIME_PARAMETERIZATION_PIECEWISE_POLYNOMIAL_HH
+
+# include <algorithm>
+# include <stdexcept>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/config.hh>
+# include <hpp/core/time-parameterization.hh>
+# include <hpp/core/time-parameterization/polynomial.hh>
+
+namespace hpp {
+  namespace core {
+    namespace timeParameterization {
+      /// Piecewise polynomial time parameterization
+      ///
+      /// On \f$ [t_i, t_{i+1}] \f$, the parameterization is
+      /// \f$ \sum_{j=0}^n a_{j,i} (t - t_i)^j \f$ where \f$ a_{j,i} \f$ are
+      /// the coefficients of the parameters and \f$ t_i \f$ the breakpoints.
+      /// Outside \f$ [t_0, t_N] \f$, the first and the last polynomials are
+      /// extrapolated. The piece at a given time is found by binary search
+      /// over the breakpoints.
+      ///
+      /// \note PathVector does not accept a time parameterization. To time a
+      ///       path vector, set one on each of its elements.
+      class HPP_CORE_DLLAPI PiecewisePolynomial : public TimeParameterization
+      {
+        public:
+          /// \param param column \f$ i \f$ contains the coefficients of the
+          ///        polynomial on \f$ [t_i, t_{i+1}] \f$, by increasing
+          ///        degree.
+          /// \param breakpoints increasing times \f$ t_0, ..., t_N \f$
+          ///        where N is the number of columns of param.
+          PiecewisePolynomial (const matrix_t& param,
+                               const vector_t& breakpoints) :
+            a (param), t (breakpoints)
+          {
+            if (a.cols() == 0 || t.size() != a.cols() + 1)
+              throw std::invalid_argument ("PiecewisePolynomial expects N "
+                  "polynomials and N+1 breakpoints, with N > 0.");
+            for (size_type i = 0; i < a.cols(); ++i)
+              assert (t[i] <= t[i+1]);
+            assert (a.allFinite());
+          }
+
+          const matrix_t& parameters () const
+          {
+            return a;
+          }
+
+          const vector_t& breakpoints () const
+          {
+            return t;
+          }
+
+          TimeParameterizationPtr_t copy () const
+          {
+            return TimeParameterizationPtr_t (new PiecewisePolynomial (*this));
+          }
+
+          value_type value (const value_type& time) const
+          {
+            return derivative (time, 0);
+          }
+
+          value_type derivative (const value_type& time, const size_type& order) const
+          {
+            const size_type i = segment (time);
+            return derivative (i, time - t[i], order);
+          }
+
+          /// Compute the bound of the derivative on \f$ [ low, up ] \f$.
+          /// The maximum of Polynomial::derivativeBound over the pieces
+          /// intersecting the interval, so that the same degrees are
+          /// handled.
+          value_type derivativeBound (const value_type& low, const value_type& up) const
+          {
+            const size_type i0 = segment (low), i1 = segment (up);
+            value_type B = 0;
+            for (size_type i = i0; i <= i1; ++i) {
+              const value_type l = (i == i0 ? low : t[i]  ) - t[i],
+                               u = (i == i1 ? up  : t[i+1]) - t[i];
+              B = std::max (B, Polynomial (a.col(i)).derivativeBound (l, u));
+            }
+            return B;
+          }
+
+        private:
+          /// Index of the polynomial defined at time
+          size_type segment (const value_type& time) const
+          {
+            const value_type* begin = t.data() + 1;
+            const value_type* end   = t.data() + t.size() - 1;
+            return std::upper_bound (begin, end, time) - begin;
+          }
+
+          value_type derivative (const size_type& i, const value_type& dt,
+                                 const size_type& order) const
+          {
+            value_type res = 0;
+            value_type tn = 1;
+            for (size_type j = order; j < a.rows(); ++j)
+            {
+              value_type factor = 1;
+              for (size_type k = j - order + 1; k <= j; ++k) factor *= value_type(k);
+              res += factor * a(j, i) * tn;
+              tn *= dt;
+            }
+            return res;
+          }
+
+          matrix_t a;
+          vector_t t;
+      }; // class PiecewisePolynomial
+    } // namespace timeParameterization
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_TIME_PARAMETERIZATION_PIECEWISE_POLYNOMIAL_HH
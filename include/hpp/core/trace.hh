@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_TRACE_HH
+# define HPP_CORE_TRACE_HH
+
+# include <iosfwd>
+# include <string>
+
+# include <boost/cstdint.hpp>
+
+# include <hpp/core/config.hh>
+
+namespace hpp {
+  namespace core {
+    /// \addtogroup path_planning
+    /// \{
+
+    /// Timeline of the computations of the threads
+    ///
+    /// Tracing is disabled by default. Once enabled, the scopes marked by
+    /// \ref HPP_CORE_TRACE_SPAN are recorded as spans, with their start
+    /// and end times, in a ring buffer of the thread that executes them:
+    /// the oldest spans of a thread are overwritten when its buffer is
+    /// full. Values of counters, see \ref counter, are recorded in the same
+    /// buffers. Threads write their buffer without lock, and \ref dump may be
+    /// called while they run: spans being overwritten are skipped.
+    ///
+    /// \ref dump writes the spans in the JSON trace event format read by
+    /// chrome://tracing and by Perfetto.
+    ///
+    /// The path planners, path validations, path projectors, steering
+    /// methods, configuration projectors and path optimizers are traced.
+    /// The path planners also record the size of their roadmap as
+    /// counters, see Roadmap::statistics.
+    /// \sa ProblemSolver::solve, parameter "Trace/file".
+    class HPP_CORE_DLLAPI Trace
+    {
+    public:
+      /// Record the execution of the enclosing scope, if tracing is enabled
+      class Span
+      {
+      public:
+        /// \param name name of the span, with static storage duration since
+        ///        it is stored as is.
+        explicit Span (const char* name) :
+          name_ (enabled () ? name : 0x0), start_ (0)
+        {
+          if (name_) start_ = now ();
+        }
+        ~Span ()
+        {
+          if (name_) record (name_, start_, now ());
+        }
+      private:
+        const char* name_;
+        boost::int64_t start_;
+      }; // class Span
+
+      /// Record the value of a counter, if tracing is enabled
+      /// \param name name of the counter, with static storage duration.
+      ///
+      /// Counters are displayed as tracks of their successive values.
+      static void counter (const char* name, double value)
+      {
+        if (enabled ()) record (name, now (), value);
+      }
+
+      /// Enable tracing
+      /// \param capacity number of spans kept by each thread. The buffers
+      ///        of the threads that already recorded spans keep their
+      ///        capacity.
+      /// \throw std::invalid_argument if capacity is zero.
+      static void enable (std::size_t capacity);
+
+      /// Disable tracing, the spans recorded are kept
+      static void disable ();
+
+      static bool enabled ()
+      {
+        return enabled_;
+      }
+
+      /// Discard the spans recorded so far
+      static void clear ();
+
+      /// Write the spans recorded since the last call to \ref clear
+      static void dump (std::ostream& os);
+
+      /// Write the spans recorded in a file
+      /// \throw std::runtime_error if the file cannot be written.
+      static void dump (const std::string& filename);
+
+    private:
+      /// Monotonic time in nanoseconds
+      static boost::int64_t now ();
+      static void record (const char* name, boost::int64_t start,
+                          boost::int64_t end);
+      static void record (const char* name, boost::int64_t time,
+                          double value);
+
+      static volatile bool enabled_;
+    }; // class Trace
+    /// \}
+  } // namespace core
+} // namespace hpp
+
+/// Trace the enclosing scope under a given name
+/// \sa hpp::core::Trace
+# define HPP_CORE_TRACE_SPAN(name) \
+  ::hpp::core::Trace::Span hppCoreTraceSpan_ (name)
+
+#endif // HPP_CORE_TRACE_HH
@@ -19,6 +19,8 @@
 #ifndef HPP_CORE_VISIBILITY_PRM_PLANNER_HH
 # define HPP_CORE_VISIBILITY_PRM_PLANNER_HH
 
+# include <deque>
+
 # include <boost/tuple/tuple.hpp>
 # include <hpp/core/path-planner.hh>
 
@@ -38,8 +40,24 @@ namespace hpp {
 	(const Problem& problem, const RoadmapPtr_t& roadmap);
       /// Return shared pointer to new object.
       static VisibilityPrmPlannerPtr_t create (const Problem& problem);
+      /// Initialize the problem resolution
+      ///  \li call parent implementation
+      ///  \li build the tools of the visibility threads
+      virtual void startSolve ();
       /// One step of extension.
       virtual void oneStep ();
+      /// Test the visibility of the samples in parallel
+      ///
+      /// The visibility of a sample from each connected component is then
+      /// tested in \c numberThreads threads. Whether the sample is a guard
+      /// or a connection node is decided once all the tests are done.
+      /// \param numberThreads number of threads. 1 restores the sequential
+      ///        tests with the objects of the problem.
+      /// \param factory called once per thread in \ref startSolve, see
+      ///        PathPlanner::parallelConnections. As in the sequential
+      ///        tests, the path projector is not used.
+      void parallelVisibility (size_type numberThreads,
+                               const ConnectionToolsFactory_t& factory);
     protected:
       /// Constructor
       VisibilityPrmPlanner (const Problem& problem, 
@@ -52,14 +70,30 @@ namespace hpp {
       typedef boost::tuple <NodePtr_t, ConfigurationPtr_t, PathPtr_t>
 	DelayedEdge_t;
       typedef std::vector <DelayedEdge_t> DelayedEdges_t;
+      /// Visibility of a sample from a connected component
+      struct Visibility
+      {
+        Visibility () : visible (false)
+        {
+        }
+        /// Guard nodes of the connected component
+        NodeVector_t guards;
+        /// Shortest edge between the sample and a guard
+        DelayedEdge_t edge;
+        bool visible;
+      }; // struct Visibility
+      typedef std::vector <Visibility> Visibilities_t;
+
       VisibilityPrmPlannerWkPtr_t weakPtr_;
       DelayedEdges_t delayedEdges_;
       std::map <NodePtr_t, bool> nodeStatus_; // true for guard node
 
-      /// Return true if the configuration is visible from the given 
-      /// connected component.
-      bool visibleFromCC (const Configuration_t q, 
-			  const ConnectedComponentPtr_t cc);
+      /// Compute whether the configuration is visible from the connected
+      /// components begin, begin + step, ...
+      static void visibleFromCCs (const ConnectionTools& tools,
+                                  const Configuration_t& q,
+                                  Visibilities_t& visibilities,
+                                  std::size_t begin, std::size_t step);
       
       /// Apply the problem constraints on a given configuration qTo by 
       /// projecting it on the tangent space of qFrom.
@@ -68,7 +102,21 @@ namespace hpp {
           const Configuration_t& qTo,
           Configuration_t& qOut);
 
+      /// Shoot a block of random configurations, apply the constraints
+      /// and store the valid ones in validSamples_
+      ///
+      /// The configurations of the block are validated in one call, see
+      /// ConfigValidation::validateConfigurations.
+      void shootValidConfigurations (const Configuration_t& qFrom);
+
       bool constrApply_; // True if applyConstraints has successed
+      /// \copydoc parallelVisibility
+      size_type numberThreads_;
+      ConnectionToolsFactory_t factory_;
+      /// Tools of the visibility threads
+      std::vector <ConnectionTools> tools_;
+      /// Valid random configurations not used yet
+      std::deque <Configuration_t> validSamples_;
     };
     /// \}
   } // namespace core
@@ -19,6 +19,9 @@
 #ifndef HPP_CORE_WEIGHED_DISTANCE_HH
 # define HPP_CORE_WEIGHED_DISTANCE_HH
 
+# include <string>
+# include <vector>
+
 # include <hpp/core/distance.hh>
 
 namespace hpp {
@@ -30,11 +33,39 @@ namespace hpp {
     ///
     /// Euclidean distance between configurations seen as vectors.
     /// Each degree of freedom is weighed by a positive value.
+    ///
+    /// Coordinates of joints that are vector spaces are evaluated together
+    /// as one weighted squared norm, and so are the translation parts of
+    /// free-flyer and planar joints. Their rotation parts, as well as SO(2)
+    /// and SO(3) joints, are evaluated in a loop over a list of rotations
+    /// computed when the weights are set. Other joints are evaluated one by
+    /// one through the Lie group of the joint.
+    ///
+    /// The default weight of a joint is the largest velocity of the points
+    /// of the bodies it moves, per unit of joint velocity, at the current
+    /// configuration of the robot. See createFromSamples for weights
+    /// estimated over several configurations.
+    ///
+    /// Parameter WeighedDistance/cacheDirectory (std::string) is a directory
+    /// where createFromProblem stores the default weights, so that other
+    /// processes with the same robot at the same configuration read them
+    /// instead of computing them again.
     class HPP_CORE_DLLAPI WeighedDistance : public Distance {
     public:
       static WeighedDistancePtr_t createFromProblem
 	(const Problem& problem);
       static WeighedDistancePtr_t create (const DevicePtr_t& robot);
+      /// Compute the weights over configurations sampled by the
+      /// configuration shooter of the problem.
+      ///
+      /// The weight of a joint is a percentile over the samples of the
+      /// weight the joint has at each of them, so that the distance bounds
+      /// the displacement of the bodies wherever the robot is.
+      /// Parameter WeighedDistance/numberOfSamples (size_type) is the number
+      /// of sampled configurations. Parameter WeighedDistance/percentile
+      /// (value_type) in [0, 1] selects the weight: 1 for the maximum,
+      /// 0.5 for the median.
+      static WeighedDistancePtr_t createFromSamples (const Problem& problem);
       static WeighedDistancePtr_t
         createWithWeight (const DevicePtr_t& robot, const vector_t& weights);
       static WeighedDistancePtr_t createCopy
@@ -65,15 +96,55 @@ namespace hpp {
       WeighedDistance (const Problem& problem);
       WeighedDistance (const DevicePtr_t& robot);
       WeighedDistance (const DevicePtr_t& robot, const vector_t& weights);
+      /// \sa createFromSamples
+      WeighedDistance (const Problem& problem, size_type numberSamples,
+                       value_type percentile);
       WeighedDistance (const WeighedDistance& distance);
       void init (WeighedDistanceWkPtr_t self);
       /// Derived class should implement this function
       virtual value_type impl_distance (ConfigurationIn_t q1,
 				    ConfigurationIn_t q2) const;
+      /// Vector space coordinates of all the configurations are evaluated
+      /// at once.
+      virtual void impl_distances (matrixIn_t configurations,
+                                   ConfigurationIn_t q,
+                                   vector_t& distances) const;
     private:
       void computeWeights ();
+      /// Compute the weights as a percentile of the weights at sampled
+      /// configurations.
+      void computeWeights (const ConfigurationShooterPtr_t& shooter,
+                           size_type numberSamples, value_type percentile);
+      /// Compute the weights at the current configuration of the robot.
+      void jacobianWeights (vector_t& weights) const;
+      /// Read the weights from a file written by saveWeights
+      /// \return false if the file does not exist or does not match the
+      ///         robot.
+      bool loadWeights (const std::string& filename);
+      void saveWeights (const std::string& filename) const;
+      /// Sort joints into vector spaces, rotations and other joints.
+      /// Called each time weights are modified.
+      void computeDistancePlan ();
+      /// Sum of squared distances of the joints that are not vector spaces
+      value_type otherJointsSquaredDistance (ConfigurationIn_t q1,
+                                             ConfigurationIn_t q2) const;
       DevicePtr_t robot_;
       vector_t weights_;
+      /// Squared weights of the coordinates of joints that are vector
+      /// spaces and of the extra configuration space, 0 for the others.
+      vector_t euclideanWeights_;
+      /// Rotation part of a joint
+      struct Rotation {
+        enum Type { SO2, SO3 } type;
+        /// Index of the first coordinate of the rotation
+        size_type idx_q;
+        /// Squared weight of the joint
+        value_type squaredWeight;
+      };
+      /// Rotations of the joints, see computeDistancePlan.
+      std::vector <Rotation> rotations_;
+      /// Indices of joints that are neither vector spaces nor in rotations_.
+      std::vector <size_type> otherJoints_;
       WeighedDistanceWkPtr_t weak_;
 
       WeighedDistance() {}
@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/allocation-profile.hh>
+
+#include <ostream>
+
+#include <boost/atomic.hpp>
+
+#ifdef HPP_CORE_PROFILE_ALLOCATIONS
+# include <cstdlib>
+# include <new>
+#endif
+
+namespace hpp {
+  namespace core {
+    namespace {
+      /// Counters of the subsystems
+      ///
+      /// Objects with static storage are zero initialized before any
+      /// constructor runs, so that allocations made during static
+      /// initialization are counted correctly.
+      boost::atomic <boost::uint64_t> allocations
+      [AllocationProfile::NUMBER_SUBSYSTEMS];
+      boost::atomic <boost::uint64_t> bytes
+      [AllocationProfile::NUMBER_SUBSYSTEMS];
+
+      /// Subsystem of the calling thread
+      ///
+      /// boost::thread_specific_ptr allocates the value on first access,
+      /// which would recurse into the profiled operator new.
+      __thread int current = AllocationProfile::OTHER;
+
+      const char* names [AllocationProfile::NUMBER_SUBSYSTEMS] = {
+        "other",
+        "planner",
+        "steering",
+        "validation",
+        "projection",
+        "optimization",
+        "roadmap"
+      };
+    } // namespace
+
+    volatile bool AllocationProfile::enabled_ (false);
+
+    void AllocationProfile::enable ()
+    {
+      enabled_ = true;
+    }
+
+    void AllocationProfile::disable ()
+    {
+      enabled_ = false;
+    }
+
+    void AllocationProfile::reset ()
+    {
+      for (std::size_t i = 0; i < NUMBER_SUBSYSTEMS; ++i) {
+        allocations [i].store (0, boost::memory_order_relaxed);
+        bytes [i].store (0, boost::memory_order_relaxed);
+      }
+    }
+
+    AllocationProfile::Counters AllocationProfile::counters
+    (Subsystem subsystem)
+    {
+      Counters result;
+      result.allocations = (size_type)
+        allocations [subsystem].load (boost::memory_order_relaxed);
+      result.bytes = (size_type)
+        bytes [subsystem].load (boost::memory_order_relaxed);
+      return result;
+    }
+
+    AllocationProfile::Snapshot AllocationProfile::snapshot ()
+    {
+      Snapshot result;
+      for (std::size_t i = 0; i < NUMBER_SUBSYSTEMS; ++i)
+        result.counters [i] = counters ((Subsystem) i);
+      return result;
+    }
+
+    const char* AllocationProfile::name (Subsystem subsystem)
+    {
+      return names [subsystem];
+    }
+
+    void AllocationProfile::print (std::ostream& os)
+    {
+      for (std::size_t i = 0; i < NUMBER_SUBSYSTEMS; ++i) {
+        const Counters c (counters ((Subsystem) i));
+        os << names [i] << ": " << c.allocations << " allocations, "
+           << c.bytes << " bytes" << std::endl;
+      }
+    }
+
+    AllocationProfile::Subsystem AllocationProfile::enter
+    (Subsystem subsystem)
+    {
+      const Subsystem previous ((Subsystem) current);
+      current = subsystem;
+      return previous;
+    }
+
+    void AllocationProfile::leave (Subsystem previous)
+    {
+      current = previous;
+    }
+
+    void AllocationProfile::count (std::size_t size)
+    {
+      allocations [current].fetch_add (1, boost::memory_order_relaxed);
+      bytes [current].fetch_add (size, boost::memory_order_relaxed);
+    }
+  } // namespace core
+} // namespace hpp
+
+#ifdef HPP_CORE_PROFILE_ALLOCATIONS
+// Dynamic exception specifications are not allowed since C++17.
+# if __cplusplus >= 201103L
+#  define THROWS_BAD_ALLOC
+#  define THROWS_NOTHING noexcept
+# else
+#  define THROWS_BAD_ALLOC throw (std::bad_alloc)
+#  define THROWS_NOTHING throw ()
+# endif
+
+namespace {
+  void* allocate (std::size_t size)
+  {
+    hpp::core::AllocationProfile::record (size);
+    // malloc (0) may return a null pointer.
+    void* ptr = std::malloc (size ? size : 1);
+    if (!ptr) throw std::bad_alloc ();
+    return ptr;
+  }
+} // namespace
+
+void* operator new (std::size_t size) THROWS_BAD_ALLOC
+{
+  return allocate (size);
+}
+
+void* operator new [] (std::size_t size) THROWS_BAD_ALLOC
+{
+  return allocate (size);
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) THROWS_NOTHING
+{
+  hpp::core::AllocationProfile::record (size);
+  return std::malloc (size ? size : 1);
+}
+
+void* operator new [] (std::size_t size, const std::nothrow_t&) THROWS_NOTHING
+{
+  hpp::core::AllocationProfile::record (size);
+  return std::malloc (size ? size : 1);
+}
+
+void operator delete (void* ptr) THROWS_NOTHING
+{
+  std::free (ptr);
+}
+
+void operator delete [] (void* ptr) THROWS_NOTHING
+{
+  std::free (ptr);
+}
+
+void operator delete (void* ptr, const std::nothrow_t&) THROWS_NOTHING
+{
+  std::free (ptr);
+}
+
+void operator delete [] (void* ptr, const std::nothrow_t&) THROWS_NOTHING
+{
+  std::free (ptr);
+}
+
+# ifdef __cpp_sized_deallocation
+void operator delete (void* ptr, std::size_t) THROWS_NOTHING
+{
+  std::free (ptr);
+}
+
+void operator delete [] (void* ptr, std::size_t) THROWS_NOTHING
+{
+  std::free (ptr);
+}
+# endif
+#endif // HPP_CORE_PROFILE_ALLOCATIONS
@@ -19,49 +19,179 @@
 #ifndef HPP_CORE_ASTAR_HH
 # define HPP_CORE_ASTAR_HH
 
+# include <functional>
 # include <limits>
+# include <queue>
+# include <vector>
+# include <boost/unordered_map.hpp>
 # include <hpp/core/fwd.hh>
 # include <hpp/core/config.hh>
 # include <hpp/core/distance.hh>
 # include <hpp/core/edge.hh>
 # include <hpp/core/node.hh>
 # include <hpp/core/path-vector.hh>
+# include <hpp/core/roadmap.hh>
 
 namespace hpp {
   namespace core {
+    /// Cost of the shortest path from each node of a roadmap to the closest
+    /// goal node
+    ///
+    /// The field is computed by a Dijkstra search from the goal nodes
+    /// along reversed validated edges. It stays valid as long as the roadmap
+    /// is not modified and can be reused by several A* searches.
+    class HPP_CORE_LOCAL GoalDistanceField
+    {
+      typedef std::pair <value_type, size_type> CostAndId_t;
+
+    public:
+      GoalDistanceField () : roadmap_ (0x0), revision_ (-1)
+      {
+      }
+
+      /// Whether the field was computed on the current state of roadmap.
+      bool valid (const RoadmapPtr_t& roadmap) const
+      {
+        return roadmap.get () == roadmap_ &&
+          roadmap->revision () == revision_;
+      }
+
+      void compute (const RoadmapPtr_t& roadmap)
+      {
+        const Nodes_t& nodes (roadmap->nodes ());
+        // Ids are the ranks of the nodes in the roadmap, as in Astar.
+        boost::unordered_map <const Node*, size_type> ids;
+        ids.rehash (nodes.size ());
+        std::vector <NodePtr_t> idToNode (nodes.begin (), nodes.end ());
+        for (std::size_t i = 0; i < idToNode.size (); ++i)
+          ids [idToNode [i]] = (size_type) i;
+
+        costs_.assign (idToNode.size (),
+                       std::numeric_limits <value_type>::infinity ());
+        std::priority_queue <CostAndId_t, std::vector <CostAndId_t>,
+                             std::greater <CostAndId_t> > queue;
+	for (NodeVector_t::const_iterator itGoal = roadmap->goalNodes ().begin ();
+	     itGoal != roadmap->goalNodes ().end (); ++itGoal) {
+          const size_type id (ids [*itGoal]);
+          costs_ [id] = 0;
+          queue.push (CostAndId_t (0, id));
+        }
+        while (!queue.empty ()) {
+          const CostAndId_t top (queue.top ());
+          queue.pop ();
+          // Outdated entry
+          if (top.first > costs_ [top.second]) continue;
+          const NodePtr_t node (idToNode [top.second]);
+          for (Node::Edges_t::const_iterator itEdge = node->inEdges ().begin ();
+               itEdge != node->inEdges ().end (); ++itEdge) {
+            if (!(*itEdge)->validated ()) continue;
+            const size_type from (ids [(*itEdge)->from ()]);
+            const value_type cost (top.first + (*itEdge)->cost ());
+            if (cost < costs_ [from]) {
+              costs_ [from] = cost;
+              queue.push (CostAndId_t (cost, from));
+            }
+          }
+        }
+        roadmap_ = roadmap.get ();
+        revision_ = roadmap->revision ();
+      }
+
+      /// Cost from a node to the closest goal
+      /// \param id rank of the node in the roadmap.
+      /// \return infinity if no goal can be reached from the node.
+      value_type operator() (size_type id) const
+      {
+        return costs_ [id];
+      }
+
+    private:
+      std::vector <value_type> costs_;
+      const Roadmap* roadmap_;
+      size_type revision_;
+    }; // class GoalDistanceField
+
+    /// A* search in a roadmap
+    ///
+    /// Nodes are given integer ids when the search starts. Costs, parents
+    /// and states of the nodes are stored in arrays indexed by the ids and
+    /// the open set is an indexed binary heap with decrease-key.
+    ///
+    /// Edges that are not validated are ignored unless
+    /// acceptUnvalidatedEdges is called, as done by lazy planners to select
+    /// the edges to validate.
     class HPP_CORE_LOCAL Astar
     {
-      typedef std::list < NodePtr_t > Nodes_t;
+    public:
       typedef std::list <EdgePtr_t> Edges_t;
-      typedef std::map <NodePtr_t, EdgePtr_t> Parent_t;
-      Nodes_t closed_;
-      Nodes_t open_;
-      std::map <NodePtr_t, value_type> costFromStart_;
-      std::map <NodePtr_t, value_type> estimatedCostToGoal_;
-      Parent_t parent_;
+
+    private:
+      typedef boost::unordered_map <const Node*, size_type> Ids_t;
+      enum State {
+        UNVISITED,
+        OPEN,
+        CLOSED
+      };
+
+      /// Id of each node
+      Ids_t ids_;
+      /// Node of each id
+      std::vector <NodePtr_t> nodes_;
+      std::vector <State> state_;
+      std::vector <bool> isGoal_;
+      std::vector <value_type> costFromStart_;
+      std::vector <value_type> estimatedCostToGoal_;
+      /// Heuristic of each node, negative if not computed yet
+      std::vector <value_type> heuristic_;
+      std::vector <EdgePtr_t> parent_;
+      /// Binary heap of open node ids sorted by estimatedCostToGoal_
+      std::vector <size_type> open_;
+      /// Position of each node in open_, -1 if not in open_
+      std::vector <size_type> heapIndex_;
       RoadmapPtr_t roadmap_;
       DistancePtr_t distance_;
+      const GoalDistanceField* distanceField_;
+      bool acceptUnvalidatedEdges_;
 
     public:
-      Astar (const RoadmapPtr_t& roadmap, const DistancePtr_t distance) :
-	roadmap_ (roadmap), distance_ (distance)
+      /// Constructor
+      /// \param distance distance used by the heuristic,
+      /// \param distanceField if not null, the field is used as heuristic
+      ///        instead of the distance to the goal nodes. It must be valid
+      ///        for the roadmap.
+      Astar (const RoadmapPtr_t& roadmap, const DistancePtr_t distance,
+             const GoalDistanceField* distanceField = 0x0) :
+	roadmap_ (roadmap), distance_ (distance),
+        distanceField_ (distanceField), acceptUnvalidatedEdges_ (false)
       {
+        assert (!distanceField_ || distanceField_->valid (roadmap_));
       }
 
-      void solution (PathVectorPtr_t sol)
+      /// Whether the search may go through edges that are not validated
+      /// \note the goal distance field, if any, ignores such edges.
+      void acceptUnvalidatedEdges (bool accept)
+      {
+        acceptUnvalidatedEdges_ = accept;
+      }
+
+      /// Edges of the shortest path from the initial node to a goal node
+      /// \throw std::runtime_error if no goal node can be reached.
+      Edges_t shortestPath ()
       {
-	NodePtr_t node = findPath ();
+	size_type node = findPath ();
 	Edges_t edges;
 
-	while (node) {
-	  Parent_t::const_iterator itEdge = parent_.find (node);
-	  if (itEdge != parent_.end ()) {
-	    EdgePtr_t edge = itEdge->second;
-	    edges.push_front (edge);
-	    node = edge->from ();
-	  }
-	  else node = NodePtr_t (0x0);
+	while (parent_ [node]) {
+	  EdgePtr_t edge = parent_ [node];
+	  edges.push_front (edge);
+	  node = id (edge->from ());
 	}
+        return edges;
+      }
+
+      void solution (PathVectorPtr_t sol)
+      {
+	const Edges_t edges (shortestPath ());
         for (Edges_t::const_iterator itEdge = edges.begin ();
              itEdge != edges.end (); ++itEdge) {
           const PathPtr_t& path ((*itEdge)->path ());
@@ -70,77 +200,152 @@ namespace hpp {
       }
 
     private:
-      struct SortFunctor {
-	std::map <NodePtr_t, value_type>& cost_;
-	SortFunctor (std::map <NodePtr_t, value_type>& cost) :
-	  cost_ (cost) {}
-	bool operator () (const NodePtr_t& n1, const NodePtr_t& n2)
-	{
-	  return cost_ [n1] < cost_ [n2];
-	}
-      }; // struc SortFunctor
+      size_type id (const NodePtr_t& node) const
+      {
+        Ids_t::const_iterator it (ids_.find (node));
+        assert (it != ids_.end ());
+        return it->second;
+      }
 
-      bool isGoal (const NodePtr_t node)
+      void initialize ()
       {
+        const Nodes_t& nodes (roadmap_->nodes ());
+        const std::size_t n (nodes.size ());
+        ids_.clear ();
+        ids_.rehash (n);
+        nodes_.assign (nodes.begin (), nodes.end ());
+        for (std::size_t i = 0; i < n; ++i)
+          ids_ [nodes_ [i]] = (size_type) i;
+        state_.assign (n, UNVISITED);
+        isGoal_.assign (n, false);
+        costFromStart_.assign (n, 0);
+        estimatedCostToGoal_.assign (n, 0);
+        heuristic_.assign (n, -1);
+        parent_.assign (n, EdgePtr_t (0x0));
+        heapIndex_.assign (n, -1);
+        open_.clear ();
 	for (NodeVector_t::const_iterator itGoal = roadmap_->goalNodes ().begin ();
 	     itGoal != roadmap_->goalNodes ().end (); ++itGoal) {
-	  if (*itGoal == node) {
-	    return true;
-	  }
+          isGoal_ [id (*itGoal)] = true;
 	}
-	return false;
       }
 
-      NodePtr_t findPath ()
+      bool less (size_type i, size_type j) const
+      {
+        return estimatedCostToGoal_ [open_ [i]] <
+          estimatedCostToGoal_ [open_ [j]];
+      }
+
+      void swap (size_type i, size_type j)
+      {
+        std::swap (open_ [i], open_ [j]);
+        heapIndex_ [open_ [i]] = i;
+        heapIndex_ [open_ [j]] = j;
+      }
+
+      void siftUp (size_type i)
+      {
+        while (i > 0) {
+          size_type parent ((i - 1) / 2);
+          if (!less (i, parent)) return;
+          swap (i, parent);
+          i = parent;
+        }
+      }
+
+      void siftDown (size_type i)
+      {
+        const size_type n ((size_type) open_.size ());
+        while (true) {
+          size_type smallest (i), left (2 * i + 1), right (2 * i + 2);
+          if (left < n && less (left, smallest)) smallest = left;
+          if (right < n && less (right, smallest)) smallest = right;
+          if (smallest == i) return;
+          swap (i, smallest);
+          i = smallest;
+        }
+      }
+
+      void push (size_type node)
       {
-	closed_.clear ();
-	open_.clear ();
-	parent_.clear ();
-	estimatedCostToGoal_.clear ();
-	costFromStart_.clear ();
+        heapIndex_ [node] = (size_type) open_.size ();
+        open_.push_back (node);
+        siftUp (heapIndex_ [node]);
+      }
 
-	open_.push_back (roadmap_->initNode ());
+      size_type pop ()
+      {
+        size_type top (open_.front ());
+        swap (0, (size_type) open_.size () - 1);
+        open_.pop_back ();
+        heapIndex_ [top] = -1;
+        if (!open_.empty ()) siftDown (0);
+        return top;
+      }
+
+      size_type findPath ()
+      {
+        initialize ();
+
+        const size_type init (id (roadmap_->initNode ()));
+        state_ [init] = OPEN;
+	push (init);
 	while (!open_.empty ()) {
-	  open_.sort (SortFunctor (estimatedCostToGoal_));
-	  Nodes_t::iterator itv = open_.begin ();
-	  NodePtr_t current (*itv);
-	  if (isGoal (current)) {
+	  const size_type current (pop ());
+	  if (isGoal_ [current]) {
 	    return current;
 	  }
-	  open_.erase (itv);
-	  closed_.push_back (current);
-	  for (Edges_t::const_iterator itEdge = current->outEdges ().begin ();
-	       itEdge != current->outEdges ().end (); ++itEdge) {
-	    value_type transitionCost = edgeCost (*itEdge);
-	    NodePtr_t child ((*itEdge)->to ());
-	    if (std::find (closed_.begin (), closed_.end (), child) ==
-		closed_.end ()) {
-	      // node is not in closed set
-	      value_type tmpCost = costFromStart_ [current] + transitionCost;
-	      bool childNotInOpenSet = (std::find (open_.begin (),
-						   open_.end (),
-						   child) == open_.end ());
-	      if ((childNotInOpenSet) || (tmpCost < costFromStart_ [child])) {
-		parent_ [child] = *itEdge;
-		costFromStart_ [child] = tmpCost;
-		estimatedCostToGoal_ [child] = costFromStart_ [child] +
-		  heuristic (child);
-		if (childNotInOpenSet) open_.push_back (child);
-	      }
-	    }
+	  state_ [current] = CLOSED;
+          const NodePtr_t node (nodes_ [current]);
+	  for (Edges_t::const_iterator itEdge = node->outEdges ().begin ();
+	       itEdge != node->outEdges ().end (); ++itEdge) {
+            if (!acceptUnvalidatedEdges_ && !(*itEdge)->validated ()) continue;
+	    const size_type child (id ((*itEdge)->to ()));
+	    if (state_ [child] == CLOSED) continue;
+            const value_type h (heuristic (child));
+            // No goal can be reached from child.
+            if (h == std::numeric_limits <value_type>::infinity ()) continue;
+            value_type tmpCost = costFromStart_ [current] +
+              edgeCost (*itEdge);
+	    if (state_ [child] == UNVISITED || tmpCost < costFromStart_ [child])
+              {
+                parent_ [child] = *itEdge;
+                costFromStart_ [child] = tmpCost;
+                estimatedCostToGoal_ [child] = tmpCost + h;
+                if (state_ [child] == UNVISITED) {
+                  state_ [child] = OPEN;
+                  push (child);
+                } else {
+                  siftUp (heapIndex_ [child]);
+                }
+              }
 	  }
 	}
 	throw std::runtime_error ("A* failed to find a solution to the goal.");
       }
 
-      value_type heuristic (const NodePtr_t node) const
+      /// Heuristic of a node, computed once per search.
+      value_type heuristic (size_type node)
+      {
+        if (heuristic_ [node] < 0) {
+          if (distanceField_) heuristic_ [node] = (*distanceField_) (node);
+          else heuristic_ [node] = distanceToGoals (nodes_ [node]);
+        }
+        return heuristic_ [node];
+      }
+
+      value_type distanceToGoals (const NodePtr_t node) const
       {
 	const ConfigurationPtr_t config = node->configuration ();
 	value_type res = std::numeric_limits <value_type>::infinity ();
+        // Distances of the roadmap may be cached, see
+        // Roadmap::distanceCacheSize.
+        const bool cached (distance_ == roadmap_->distance ());
 	for (NodeVector_t::const_iterator itGoal = roadmap_->goalNodes ().begin ();
 	     itGoal != roadmap_->goalNodes ().end (); ++itGoal) {
 	  ConfigurationPtr_t goal = (*itGoal)->configuration ();
-	  value_type dist = (*distance_) (*config, *goal);
+	  value_type dist = cached ? roadmap_->distance (node, *itGoal) :
+            (*distance_) (*config, *goal);
 	  if (dist < res) {
 	    res = dist;
 	  }
@@ -150,7 +355,7 @@ namespace hpp {
 
       value_type edgeCost (const EdgePtr_t& edge)
       {
-	return edge->path ()->length ();
+	return edge->cost ();
       }
     }; // class Astar
   } //   namespace core
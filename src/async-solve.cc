@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/async-solve.hh>
+
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace hpp {
+  namespace core {
+    AsyncSolvePtr_t AsyncSolve::create (const PathPlannerPtr_t& planner)
+    {
+      return AsyncSolvePtr_t (new AsyncSolve (planner));
+    }
+
+    AsyncSolve::AsyncSolve (const PathPlannerPtr_t& planner) :
+      planner_ (planner),
+      progressCallback_ (planner->progressCallback ()),
+      solutionCallback_ (planner->solutionCallback ()),
+      done_ (false), interrupted_ (false)
+    {
+      progress_.iteration = 0;
+      progress_.time = 0;
+      progress_.numberNodes = 0;
+      progress_.numberConnectedComponents = 0;
+      progress_.solved = false;
+      planner_->progressCallback
+        (boost::bind (&AsyncSolve::storeProgress, this, _1));
+      planner_->solutionCallback
+        (boost::bind (&AsyncSolve::storeSolution, this, _1));
+      boost::thread (boost::bind (&AsyncSolve::run, this)).swap (thread_);
+    }
+
+    AsyncSolve::~AsyncSolve ()
+    {
+      interrupt ();
+      thread_.join ();
+    }
+
+    bool AsyncSolve::done () const
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      return done_;
+    }
+
+    void AsyncSolve::wait ()
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      while (!done_) finished_.wait (lock);
+    }
+
+    bool AsyncSolve::wait (value_type seconds)
+    {
+      const boost::system_time timeout
+        (boost::get_system_time () + boost::posix_time::microseconds
+         ((long) (1e6 * seconds)));
+      boost::mutex::scoped_lock lock (mutex_);
+      while (!done_) {
+        if (!finished_.timed_wait (lock, timeout)) return done_;
+      }
+      return true;
+    }
+
+    void AsyncSolve::interrupt ()
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      interrupted_ = true;
+      if (!done_) planner_->interrupt ();
+    }
+
+    PathPlanner::Progress AsyncSolve::progress () const
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      return progress_;
+    }
+
+    PathVectorPtr_t AsyncSolve::latestSolution () const
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      return solution_;
+    }
+
+    PathVectorPtr_t AsyncSolve::result ()
+    {
+      wait ();
+      boost::mutex::scoped_lock lock (mutex_);
+      if (!error_.empty ()) throw std::runtime_error (error_.c_str ());
+      return solution_;
+    }
+
+    void AsyncSolve::run ()
+    {
+      PathVectorPtr_t path;
+      std::string error;
+      try {
+        path = planner_->solve ();
+      } catch (const std::exception& exc) {
+        error = exc.what ();
+      }
+      planner_->progressCallback (progressCallback_);
+      planner_->solutionCallback (solutionCallback_);
+
+      boost::mutex::scoped_lock lock (mutex_);
+      if (path) solution_ = path;
+      error_ = error;
+      done_ = true;
+      finished_.notify_all ();
+    }
+
+    void AsyncSolve::storeProgress (const PathPlanner::Progress& progress)
+    {
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        progress_ = progress;
+        // PathPlanner::solve clears the interruption flag when it starts.
+        if (interrupted_) planner_->interrupt ();
+      }
+      if (progressCallback_) progressCallback_ (progress);
+    }
+
+    void AsyncSolve::storeSolution (const PathVectorPtr_t& path)
+    {
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        solution_ = path;
+      }
+      if (solutionCallback_) solutionCallback_ (path);
+    }
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_BANG_BANG_HH
+# define HPP_CORE_BANG_BANG_HH
+
+# include <cmath>
+# include <limits>
+# include <iostream>
+
+# include <hpp/core/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    /// Minimal time bang-bang trajectories of double integrators
+    ///
+    /// Equations refer to the article
+    /// https://ieeexplore.ieee.org/document/6943083
+    namespace bangBang {
+      /// Minimal times of several one dimensional double integrators
+      ///
+      /// Same as minimalTimes, with the inverses invAMax and invVMax of the
+      /// bounds precomputed by the caller, so that no division by the
+      /// bounds is performed.
+      template <int N>
+      inline Eigen::Array <value_type, N, 1> minimalTimes
+      (const Eigen::Array <value_type, N, 1>& p1,
+       const Eigen::Array <value_type, N, 1>& p2,
+       const Eigen::Array <value_type, N, 1>& v1,
+       const Eigen::Array <value_type, N, 1>& v2,
+       const Eigen::Array <value_type, N, 1>& aMax,
+       const Eigen::Array <value_type, N, 1>& vMax,
+       const Eigen::Array <value_type, N, 1>& invAMax,
+       const Eigen::Array <value_type, N, 1>& invVMax,
+       Eigen::Array <value_type, N, 1>& sigma,
+       Eigen::Array <bool, N, 1>& twoSegment)
+      {
+        typedef Eigen::Array <value_type, N, 1> Array_t;
+        const value_type eps (std::numeric_limits<value_type>::epsilon()*100.);
+        const Array_t one (Array_t::Ones (p1.size ()));
+        const Array_t zero (Array_t::Zero (p1.size ()));
+        const Array_t dp (p2 - p1), dv (v2 - v1);
+
+        // compute the sign of each acceleration
+        const Array_t deltaPacc (0.5*(v1+v2)*(dv.abs()*invAMax));
+        const Array_t s (dp - deltaPacc);
+        sigma = (s > 0).select (one, (s < 0).select (-one,
+                                               (dp >= 0).select (one, -one)));
+        const Array_t a1 (sigma * aMax);
+        const Array_t vLim (sigma * vMax);
+        // Inverses of a1, a2 = -a1 and vLim
+        const Array_t invA1 (sigma * invAMax);
+        const Array_t invA2 (-invA1);
+        const Array_t invVLim (sigma * invVMax);
+
+        // solve quadratic equation (cf eq 13 article)
+        const Array_t& a (a1);
+        const Array_t b (2. * v1);
+        const Array_t c ((0.5*(v1+v2)*dv*invA2) - dp);
+        const Array_t q (-0.5*(b + (b >= 0).select (one, -one) *
+                               (b*b - 4.*a*c).sqrt()));
+        const Array_t x1 ((a != 0).select (q*invA1, zero));
+        const Array_t x2 ((q != 0).select (c/q, zero));
+        const Array_t x (x1.max (x2));
+        //lower bound for valid t1 value (cf eq 14)
+        const Array_t minT1 (zero.max (-dv*invA2));
+        // check if max velocity is respected
+        twoSegment = (x >= minT1) && ((v1 + x*a1).abs() <= vMax);
+
+        // eq 14
+        const Array_t T2 (x + dv*invA2 + x);
+        // eq 15, 16, 17
+        const Array_t T3 ((vLim - v1)*invA1 +
+                          (v1*v1 + v2*v2 - 2.*vLim*vLim)*(0.5*invVLim*invA1) +
+                          dp*invVLim + (v2 - vLim)*invA2);
+        return ((dp.abs() < eps) && (dv.abs() < eps)).select
+          (zero, twoSegment.select (T2, T3));
+      }
+
+      /// Minimal times of several one dimensional double integrators
+      ///
+      /// For each coefficient i, compute the minimal time to go from state
+      /// (p1 [i], v1 [i]) to state (p2 [i], v2 [i]) with a velocity bounded
+      /// by vMax [i] and an acceleration bounded by aMax [i]. All the
+      /// coefficients are solved at once, without branching.
+      /// \retval sigma sign of the acceleration during the first phase,
+      /// \retval twoSegment whether the trajectory has no constant velocity
+      ///         phase.
+      /// \return the minimal times, 0 for the integrators that do not move.
+      template <int N>
+      inline Eigen::Array <value_type, N, 1> minimalTimes
+      (const Eigen::Array <value_type, N, 1>& p1,
+       const Eigen::Array <value_type, N, 1>& p2,
+       const Eigen::Array <value_type, N, 1>& v1,
+       const Eigen::Array <value_type, N, 1>& v2,
+       const Eigen::Array <value_type, N, 1>& aMax,
+       const Eigen::Array <value_type, N, 1>& vMax,
+       Eigen::Array <value_type, N, 1>& sigma,
+       Eigen::Array <bool, N, 1>& twoSegment)
+      {
+        typedef Eigen::Array <value_type, N, 1> Array_t;
+        return minimalTimes<N> (p1, p2, v1, v2, aMax, vMax,
+                                Array_t (aMax.inverse ()),
+                                Array_t (vMax.inverse ()), sigma, twoSegment);
+      }
+
+      /// Interval of final times that cannot be reached
+      ///
+      /// \param sigma, twoSegment as returned by minimalTimes for the same
+      ///        integrator.
+      /// \return the infeasible interval, or [inf, 0] if all the times
+      ///         greater than the minimal time can be reached.
+      inline interval_t infeasibleInterval (value_type p1, value_type p2,
+                                            value_type v1, value_type v2,
+                                            value_type aMax, value_type vMax,
+                                            value_type sigma, bool twoSegment)
+      {
+        interval_t none (std::numeric_limits<value_type>::infinity(), 0);
+        const value_type eps (std::numeric_limits<value_type>::epsilon()*100.);
+        if (fabs(p2-p1) < eps && fabs(v2-v1) < eps) return none;
+        if (v1 * v2 <= 0.0 || sigma * v1 < 0.0) {
+          // If minimum-time solution goes through zero-velocity, there is no
+          // infeasible time interval, because we can stop and wait at
+          // zero-velocity
+          return none;
+        }
+        double zeroTime1 = std::abs(v1) / aMax;
+        double zeroTime2 = std::abs(v2) / aMax;
+        double zeroDistance = zeroTime1 * v1 / 2.0 + zeroTime2 * v2 / 2.0;
+        if (std::abs(zeroDistance) < std::abs(p2-p1)) return none;
+
+        // "region I", infeasible interval exist
+        interval_t res;
+        double minT1 = std::max(0., (v2-v1)/(sigma*aMax));
+        const double a1 = -sigma*aMax;
+        const double a2 = -a1;
+        const double vLim = -sigma*vMax;
+        // solve eq 13 with new a1/a2 :
+        const double ai = a1;
+        const double bi = 2. * v1;
+        const double ci = (0.5*(v1+v2)*(v2-v1)/a2) - (p2-p1);
+        const double deltai = bi*bi - 4.0*ai*ci;
+        if(deltai < 0 )
+          std::cout<<"Error : determinant of quadratic function negative"<<std::endl;
+
+        const double x1i = (-bi + sqrt(deltai))/(2*ai);
+        const double x2i = (-bi - sqrt(deltai))/(2*ai);
+        const double xi = std::max(x1i,x2i);
+        // min bound of infeasible interval is given by lesser solution
+        double t1 = std::min(x1i,x2i), tv, t2;
+        res.first = (((v2-v1)/a2) + (t1)) + t1; // eq 14 (T = t2+t1)
+        //check if greater solution violate velocity limits :
+        minT1 = -minT1;
+        if(xi > minT1){
+          twoSegment = true;
+          t1 = xi;
+        }
+        if(twoSegment){ // check if max velocity is respected
+          if(std::abs(v1+(t1)*a1) > vMax)
+            twoSegment = false;
+        }
+        if(twoSegment){ // compute t2 for two segment trajectory
+          tv = 0.;
+          t2 = ((v2-v1)/a2) + (t1);// eq 14
+        }else{// compute 3 segment trajectory, with constant velocity phase :
+          t1 = (vLim - v1)/a1;  //eq 15
+          tv = ((v1*v1+v2*v2 - 2*vLim*vLim)/(2*vLim*a1)) + (p2-p1)/vLim ; //eq 16
+          t2 = (v2-vLim)/a2;  //eq 17
+        }
+        res.second = t1+tv+t2;
+        return res;
+      }
+    } // namespace bangBang
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_BANG_BANG_HH
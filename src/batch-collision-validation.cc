@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/batch-collision-validation.hh>
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace hpp {
+  namespace core {
+    BatchCollisionValidationPtr_t BatchCollisionValidation::create
+    (const DevicePtr_t& robot)
+    {
+      BatchCollisionValidation* ptr = new BatchCollisionValidation (robot);
+      return BatchCollisionValidationPtr_t (ptr);
+    }
+
+    bool BatchCollisionValidation::validateConfigurations
+    (const matrix_t& configurations, std::vector <bool>& valid,
+     std::vector <ValidationReportPtr_t>& reports)
+    {
+      const size_type n (configurations.cols ());
+      valid.assign (n, false);
+      reports.assign (n, ValidationReportPtr_t ());
+      const size_type nThreads (std::min (numberThreads_, n));
+      if (nThreads <= 1 || computeAllContacts ()) {
+        return CollisionValidation::validateConfigurations (configurations,
+                                                            valid, reports);
+      } else {
+        // std::vector <bool> packs its elements: threads write to a vector
+        // of their own.
+        std::vector <std::vector <bool> > threadValid
+          (nThreads, std::vector <bool> (n, false));
+        boost::thread_group threads;
+        for (size_type t = 0; t < nThreads; ++t) {
+          threads.create_thread
+            (boost::bind (&BatchCollisionValidation::validateRange, this,
+                          boost::cref (configurations),
+                          boost::ref (threadValid [t]), boost::ref (reports),
+                          t, nThreads));
+        }
+        threads.join_all ();
+        for (size_type i = 0; i < n; ++i)
+          valid [i] = threadValid [i % nThreads] [i];
+      }
+      return std::find (valid.begin (), valid.end (), false) == valid.end ();
+    }
+
+    BatchCollisionValidation::BatchCollisionValidation
+    (const DevicePtr_t& robot) :
+      CollisionValidation (robot),
+      numberThreads_ (std::max (1u, boost::thread::hardware_concurrency ()))
+    {
+    }
+  } // namespace core
+} // namespace hpp
@@ -16,6 +16,9 @@
 // hpp-core  If not, see
 // <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <limits>
+
 #include <boost/tuple/tuple.hpp>
 #include <hpp/util/debug.hh>
 #include <hpp/pinocchio/configuration.hh>
@@ -25,7 +28,9 @@
 #include <hpp/core/node.hh>
 #include <hpp/core/edge.hh>
 #include <hpp/core/path.hh>
+#include <hpp/core/nearest-neighbor.hh>
 #include <hpp/core/path-validation.hh>
+#include <hpp/core/planner-statistics.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/roadmap.hh>
 #include <hpp/core/steering-method.hh>
@@ -51,14 +56,18 @@ namespace hpp {
     BiRRTPlanner::BiRRTPlanner (const Problem& problem):
       PathPlanner (problem),
       configurationShooter_ (problem.configurationShooter()),
-      qProj_ (problem.robot ()->configSize ())
+      qProj_ (problem.robot ()->configSize ()), stepLength_ (-1),
+      minStepLength_ (0), maxStepLength_ (0), validityRatio_ (1),
+      greedyConnection_ (false)
     {
     }
 
     BiRRTPlanner::BiRRTPlanner (const Problem& problem, const RoadmapPtr_t& roadmap):
       PathPlanner (problem, roadmap),
       configurationShooter_ (problem.configurationShooter()),
-      qProj_ (problem.robot ()->configSize ())
+      qProj_ (problem.robot ()->configSize ()), stepLength_ (-1),
+      minStepLength_ (0), maxStepLength_ (0), validityRatio_ (1),
+      greedyConnection_ (false)
     {
     }
 
@@ -96,12 +105,100 @@ namespace hpp {
         return reverse ? (*sm) (target, *(near->configuration ())) : (*sm) (*(near->configuration ()), target);
     }
 
+    PathPtr_t BiRRTPlanner::truncate (const PathPtr_t& path, bool reverse,
+                                      bool& reached) const
+    {
+      reached = !(stepLength_ > 0 && path->length () > stepLength_);
+      if (reached) return path;
+      const interval_t& range (path->timeRange ());
+      return reverse ?
+        path->extract (range.second - stepLength_, range.second) :
+        path->extract (range.first, range.first + stepLength_);
+    }
+
+    void BiRRTPlanner::adaptStepLength (const PathPtr_t& path,
+                                        const PathPtr_t& validPart)
+    {
+      if (stepLength_ <= 0 || path->length () <= 0) return;
+      const value_type ratio (validPart ?
+                              validPart->length () / path->length () : 0);
+      validityRatio_ = .7 * validityRatio_ + .3 * ratio;
+      stepLength_ = std::min (maxStepLength_, std::max
+                              (minStepLength_,
+                               stepLength_ * (.5 + validityRatio_)));
+    }
+
+    bool BiRRTPlanner::connect (NodePtr_t fromStart, NodePtr_t toEnd)
+    {
+      typedef PlannerStatistics::ScopedTimer Timer_t;
+      PlannerStatistics& stats (mutableStatistics ());
+      PathValidationPtr_t pathValidation (problem ().pathValidation ());
+      // Whether the last step from each tree was in collision
+      bool blocked [2] = { false, false };
+      bool reverse (false);
+      value_type remaining (std::numeric_limits <value_type>::infinity ());
+      while (true) {
+        PathPtr_t path;
+        {
+          Timer_t timer (stats, PlannerStatistics::STEERING);
+          path = (*(problem().steeringMethod())) (*fromStart->configuration (),
+                                                  *toEnd->configuration ());
+        }
+        // Stop if the trees do not get closer
+        if (!path || path->length () >= remaining) return false;
+        remaining = path->length ();
+        bool reached;
+        PathPtr_t step (greedyConnection_ ? truncate (path, reverse, reached)
+                        : path);
+        if (!greedyConnection_) reached = true;
+        PathPtr_t validPath;
+        PathValidationReportPtr_t report;
+        bool valid;
+        {
+          Timer_t timer (stats, PlannerStatistics::VALIDATION);
+          valid = pathValidation->validate (step, reverse, validPath, report);
+        }
+        if (valid && reached) {
+          Timer_t timer (stats, PlannerStatistics::INSERTION);
+          roadmap()->addEdge (fromStart, toEnd, path);
+          return true;
+        }
+        if (!greedyConnection_) return false;
+        adaptStepLength (step, validPath);
+        if (validPath && validPath->length () > 0) {
+          Timer_t timer (stats, PlannerStatistics::INSERTION);
+          if (reverse) {
+            ConfigurationPtr_t q (new Configuration_t
+                                  (validPath->initial ()));
+            toEnd = roadmap()->addNodeAndEdge (q, toEnd, validPath);
+          } else {
+            ConfigurationPtr_t q (new Configuration_t (validPath->end ()));
+            fromStart = roadmap()->addNodeAndEdge (fromStart, q, validPath);
+          }
+        }
+        blocked [reverse] = !valid;
+        if (blocked [0] && blocked [1]) return false;
+        // Go on from the other tree after a collision
+        if (!valid) reverse = !reverse;
+      }
+    }
+
 
     /// One step of extension.
     void BiRRTPlanner::startSolve()
     {
         PathPlanner::startSolve();
+        roadmap()->nearestNeighbor()->approximationFactor
+          (problem().getParameter ("NearestNeighbor/approximationFactor").
+           floatValue());
         startComponent_ = roadmap()->initNode()->connectedComponent();
+        stepLength_ = problem().getParameter
+          ("BiRRTPlanner/extensionStepLength").floatValue();
+        minStepLength_ = stepLength_ / 16;
+        maxStepLength_ = stepLength_ * 16;
+        validityRatio_ = 1;
+        greedyConnection_ = problem().getParameter
+          ("BiRRTPlanner/greedyConnection").boolValue();
         for(NodeVector_t::const_iterator cit = roadmap()->goalNodes().begin();
             cit != roadmap()->goalNodes().end(); ++cit)
         {
@@ -111,26 +208,48 @@ namespace hpp {
 
     void BiRRTPlanner::oneStep ()
     {
+        typedef PlannerStatistics::ScopedTimer Timer_t;
+        PlannerStatistics& stats (mutableStatistics ());
         PathPtr_t validPath, path;
         PathValidationPtr_t pathValidation (problem ().pathValidation ());
         value_type distance;
         NodePtr_t near, reachedNodeFromStart;
         bool startComponentConnected(false), pathValidFromStart(false);
+        bool reached;
         ConfigurationPtr_t q_new;
         // first try to connect to start component
         Configuration_t q_rand;
-        configurationShooter_->shoot (q_rand);
-        near = roadmap()->nearestNode (q_rand, startComponent_, distance);
-        path = extendInternal (problem().steeringMethod(), qProj_, near, q_rand);
+        {
+            Timer_t timer (stats, PlannerStatistics::SAMPLING);
+            configurationShooter_->shoot (q_rand);
+            stats.sampled ();
+        }
+        {
+            Timer_t timer (stats, PlannerStatistics::NEAREST_NEIGHBOR);
+            near = roadmap()->nearestNode (q_rand, startComponent_, distance);
+        }
+        {
+            // Includes the projection on the constraints
+            Timer_t timer (stats, PlannerStatistics::STEERING);
+            path = extendInternal (problem().steeringMethod(), qProj_, near, q_rand);
+        }
         if (path)
         {
+            path = truncate (path, false, reached);
             PathValidationReportPtr_t report;
-            pathValidFromStart = pathValidation->validate (path, false, validPath, report);
+            {
+                Timer_t timer (stats, PlannerStatistics::VALIDATION);
+                pathValidFromStart = pathValidation->validate (path, false, validPath, report);
+            }
+            adaptStepLength (path, validPath);
+            // q_rand is reached only if the path was not truncated
+            pathValidFromStart = pathValidFromStart && reached;
             if(validPath){
               // Insert new path to q_near in roadmap
               value_type t_final = validPath->timeRange ().second;
               if (t_final != path->timeRange ().first)
               {
+                  Timer_t timer (stats, PlannerStatistics::INSERTION);
                   startComponentConnected = true;
                   q_new = ConfigurationPtr_t (new Configuration_t(validPath->end ()));
                   reachedNodeFromStart = roadmap()->addNodeAndEdge(near, q_new, validPath);
@@ -143,14 +262,28 @@ namespace hpp {
            endComponents_.begin ();
          itcc != endComponents_.end (); ++itcc)
         {
-            near = roadmap()->nearestNode (q_rand, *itcc, distance,true);
-            path = extendInternal (problem().steeringMethod(), qProj_, near, q_rand, true);
+            {
+                Timer_t timer (stats, PlannerStatistics::NEAREST_NEIGHBOR);
+                near = roadmap()->nearestNode (q_rand, *itcc, distance,true);
+            }
+            {
+                Timer_t timer (stats, PlannerStatistics::STEERING);
+                path = extendInternal (problem().steeringMethod(), qProj_, near, q_rand, true);
+            }
             if (path)
             {
+                path = truncate (path, true, reached);
                 PathValidationReportPtr_t report;
-                if(pathValidation->validate (path, true, validPath, report) && pathValidFromStart)
+                bool pathValid;
+                {
+                    Timer_t timer (stats, PlannerStatistics::VALIDATION);
+                    pathValid = pathValidation->validate (path, true, validPath, report);
+                }
+                adaptStepLength (path, validPath);
+                if(pathValid && reached && pathValidFromStart)
                 {
                     // we won, a path is found
+                    Timer_t timer (stats, PlannerStatistics::INSERTION);
                     roadmap()->addEdge(reachedNodeFromStart, near, validPath);
                     return;
                 }
@@ -160,21 +293,37 @@ namespace hpp {
                     if (t_final != path->timeRange ().first)
                     {
                         ConfigurationPtr_t q_newEnd = ConfigurationPtr_t (new Configuration_t(validPath->initial()));
-                        NodePtr_t newNode = roadmap()->addNodeAndEdge (q_newEnd,near,validPath);
-                        // now try to connect both nodes
-                        if(startComponentConnected)
+                        NodePtr_t newNode;
                         {
-                            path = (*(problem().steeringMethod())) (*q_new, *q_newEnd);
-                            if(path && pathValidation->validate (path, false, validPath, report))
-                            {
-                                roadmap()->addEdge (reachedNodeFromStart, newNode, path);
-                                return;
-                            }
+                            Timer_t timer (stats, PlannerStatistics::INSERTION);
+                            newNode = roadmap()->addNodeAndEdge (q_newEnd,near,validPath);
                         }
+                        // now try to connect both nodes
+                        if(startComponentConnected &&
+                           connect (reachedNodeFromStart, newNode))
+                            return;
                     }
                 }
             }
         }
+        pruneRoadmap ();
     }
+
+    // ----------- Declare parameters ------------------------------------- //
+
+    HPP_START_PARAMETER_DECLARATION(BiRRTPlanner)
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "BiRRTPlanner/extensionStepLength",
+          "Initial length of the extensions of the trees, adapted online "
+          "within a factor 16 from the ratio of valid length of the recent "
+          "extensions. "
+          "Extensions are not truncated if negative.",
+          Parameter(-1.)));
+    Problem::declareParameter(ParameterDescription (Parameter::BOOL,
+          "BiRRTPlanner/greedyConnection",
+          "Whether a failing connection between the trees keeps its valid "
+          "part and goes on from it, alternately from each tree.",
+          Parameter(false)));
+    HPP_END_PARAMETER_DECLARATION(BiRRTPlanner)
   } // namespace core
 } // namespace hpp
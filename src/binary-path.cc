@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/binary-path.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <hpp/util/exception-factory.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/path/spline.hh>
+#include <hpp/core/straight-path.hh>
+
+namespace hpp {
+  namespace core {
+    namespace {
+      const char formatMagic [8] = {'H', 'P', 'P', 'P', 'A', 'T', 'H', '\0'};
+      /// Read in another value if the buffer has another byte order
+      const boost::uint32_t byteOrderMark = 0x01020304;
+
+      struct Header
+      {
+        char magic [8];
+        boost::uint32_t version;
+        boost::uint32_t byteOrder;
+        boost::int64_t configSize;
+        boost::int64_t numberDof;
+        boost::int64_t numberSegments;
+      }; // struct Header
+
+      struct Segment
+      {
+        boost::int32_t type;
+        /// Degree of splines
+        boost::int32_t order;
+        double begin, end;
+        /// Position and number of the coefficients in the array
+        boost::int64_t offset, size;
+      }; // struct Segment
+
+      typedef std::vector <Segment> Segments_t;
+      typedef Eigen::Map <const vector_t> ConstMap_t;
+
+      void append (std::vector <double>& data, vectorIn_t v)
+      {
+        data.insert (data.end (), v.data (), v.data () + v.size ());
+      }
+
+      template <int Order>
+      bool writeSpline (const PathPtr_t& path, Segment& segment,
+                        std::vector <double>& data)
+      {
+        typedef path::Spline <path::BernsteinBasis, Order> Spline_t;
+        const boost::shared_ptr <Spline_t> spline
+          (HPP_DYNAMIC_PTR_CAST (Spline_t, path));
+        if (!spline) return false;
+        segment.type = BinaryPath::BERNSTEIN_SPLINE;
+        segment.order = Order;
+        append (data, spline->base ());
+        append (data, spline->rowParameters ());
+        return true;
+      }
+
+      template <int Order>
+      PathPtr_t readSpline (const DevicePtr_t& robot, const interval_t& range,
+                            const double* data)
+      {
+        typedef path::Spline <path::BernsteinBasis, Order> Spline_t;
+        const typename Spline_t::Ptr_t spline
+          (Spline_t::create (robot, range, ConstraintSetPtr_t ()));
+        spline->base (ConstMap_t (data, robot->configSize ()));
+        spline->rowParameters (ConstMap_t (data + robot->configSize (),
+                                           Spline_t::NbCoeffs *
+                                           robot->numberDof ()));
+        return spline;
+      }
+
+      /// Number of coefficients of a spline, -1 for unsupported degrees
+      size_type splineSize (int order, size_type configSize,
+                            size_type numberDof)
+      {
+        switch (order) {
+        case 1: case 3: case 5:
+          return configSize + (order + 1) * numberDof;
+        default:
+          return -1;
+        }
+      }
+    } // namespace
+
+    void BinaryPath::write (const PathVectorPtr_t& path, value_type step,
+                            std::string& buffer)
+    {
+      if (!(step > 0))
+        throw std::invalid_argument ("BinaryPath::write: step should be "
+                                     "positive.");
+      PathVectorPtr_t flat (PathVector::create (path->outputSize (),
+                                                path->outputDerivativeSize ()));
+      path->flatten (flat);
+
+      Segments_t segments (flat->numberPaths ());
+      std::vector <double> data;
+      Configuration_t q (path->outputSize ());
+      for (std::size_t i = 0; i < segments.size (); ++i) {
+        const PathPtr_t& element (flat->pathAtRank (i));
+        Segment& segment (segments [i]);
+        segment.order = 0;
+        segment.begin = element->timeRange ().first;
+        segment.end = element->timeRange ().second;
+        segment.offset = (boost::int64_t) data.size ();
+        bool exact (!element->constraints () &&
+                    !element->timeParameterization ());
+        if (exact) {
+          const StraightPathPtr_t straight
+            (HPP_DYNAMIC_PTR_CAST (StraightPath, element));
+          if (straight) {
+            segment.type = STRAIGHT;
+            append (data, straight->initial ());
+            append (data, straight->end ());
+          } else {
+            exact = writeSpline <1> (element, segment, data) ||
+              writeSpline <3> (element, segment, data) ||
+              writeSpline <5> (element, segment, data);
+          }
+        }
+        if (!exact) {
+          segment.type = WAYPOINTS;
+          const value_type length (element->length ());
+          const size_type n (std::max ((size_type) 1, (size_type)
+                                       std::ceil (length / step)));
+          for (size_type k = 0; k <= n; ++k)
+            data.push_back (k == n ? segment.end : segment.begin +
+                            length * value_type (k) / value_type (n));
+          for (size_type k = 0; k <= n; ++k) {
+            const value_type t (data [(std::size_t) (segment.offset + k)]);
+            if (!(*element) (q, t)) {
+              HPP_THROW (std::runtime_error, "BinaryPath::write: failed to "
+                         "evaluate element " << i << " at time " << t << ".");
+            }
+            append (data, q);
+          }
+        }
+        segment.size = (boost::int64_t) data.size () - segment.offset;
+      }
+
+      Header header;
+      std::memcpy (header.magic, formatMagic, sizeof (formatMagic));
+      header.version = formatVersion;
+      header.byteOrder = byteOrderMark;
+      header.configSize = path->outputSize ();
+      header.numberDof = path->outputDerivativeSize ();
+      header.numberSegments = (boost::int64_t) segments.size ();
+
+      buffer.clear ();
+      buffer.reserve (sizeof (Header) + sizeof (Segment) * segments.size () +
+                      sizeof (double) * data.size ());
+      buffer.append ((const char*) &header, sizeof (Header));
+      if (!segments.empty ())
+        buffer.append ((const char*) &segments [0],
+                       sizeof (Segment) * segments.size ());
+      if (!data.empty ())
+        buffer.append ((const char*) &data [0], sizeof (double) * data.size ());
+    }
+
+    PathVectorPtr_t BinaryPath::read (const char* data, std::size_t size,
+                                      const DevicePtr_t& robot)
+    {
+      Header header;
+      if (size < sizeof (Header))
+        throw std::runtime_error ("Buffer is too small to be a path.");
+      std::memcpy (&header, data, sizeof (Header));
+      if (std::memcmp (header.magic, formatMagic, sizeof (formatMagic)) != 0)
+        throw std::runtime_error ("Buffer is not a path.");
+      if (header.byteOrder != byteOrderMark)
+        throw std::runtime_error ("Path was written with another byte order.");
+      if (header.version != formatVersion) {
+        HPP_THROW (std::runtime_error, "Path has version " << header.version
+                   << " instead of " << formatVersion << ".");
+      }
+      const size_type nq (robot->configSize ()), nv (robot->numberDof ());
+      if (header.configSize != nq || header.numberDof != nv) {
+        HPP_THROW (std::runtime_error, "Path has configurations of size "
+                   << header.configSize << " and velocities of size "
+                   << header.numberDof << " instead of " << nq << " and "
+                   << nv << ".");
+      }
+      const std::size_t numberSegments ((std::size_t) header.numberSegments),
+        begin (sizeof (Header) + sizeof (Segment) * numberSegments);
+      if (header.numberSegments < 0 || size < begin)
+        throw std::runtime_error ("Path is truncated.");
+      const double* coefficients ((const double*) (data + begin));
+      const boost::int64_t numberCoefficients
+        ((boost::int64_t) ((size - begin) / sizeof (double)));
+
+      PathVectorPtr_t result (PathVector::create (nq, nv));
+      for (std::size_t i = 0; i < numberSegments; ++i) {
+        Segment segment;
+        std::memcpy (&segment, data + sizeof (Header) + sizeof (Segment) * i,
+                     sizeof (Segment));
+        if (segment.offset < 0 || segment.size < 0 ||
+            segment.offset + segment.size > numberCoefficients)
+          throw std::runtime_error ("Path is truncated.");
+        const double* c (coefficients + segment.offset);
+        const interval_t range (segment.begin, segment.end);
+        size_type expected (-1);
+        switch (segment.type) {
+        case STRAIGHT:
+          expected = 2 * nq;
+          break;
+        case BERNSTEIN_SPLINE:
+          expected = splineSize (segment.order, nq, nv);
+          break;
+        case WAYPOINTS:
+          if (segment.size % (nq + 1) == 0 && segment.size >= 2 * (nq + 1))
+            expected = segment.size;
+          break;
+        }
+        if (expected < 0 || expected != segment.size) {
+          HPP_THROW (std::runtime_error, "Segment " << i << " of the path "
+                     "is invalid.");
+        }
+
+        switch (segment.type) {
+        case STRAIGHT:
+          result->appendPath (StraightPath::create
+                              (robot, ConstMap_t (c, nq),
+                               ConstMap_t (c + nq, nq), range));
+          break;
+        case BERNSTEIN_SPLINE:
+          switch (segment.order) {
+          case 1: result->appendPath (readSpline <1> (robot, range, c)); break;
+          case 3: result->appendPath (readSpline <3> (robot, range, c)); break;
+          case 5: result->appendPath (readSpline <5> (robot, range, c)); break;
+          }
+          break;
+        case WAYPOINTS:
+          {
+            const size_type n (segment.size / (nq + 1));
+            const double* q (c + n);
+            for (size_type k = 0; k + 1 < n; ++k)
+              result->appendPath (StraightPath::create
+                                  (robot, ConstMap_t (q + k * nq, nq),
+                                   ConstMap_t (q + (k + 1) * nq, nq),
+                                   interval_t (c [k], c [k + 1])));
+          }
+          break;
+        }
+      }
+      return result;
+    }
+  } //   namespace core
+} // namespace hpp
@@ -18,9 +18,20 @@
 
 #include <hpp/core/collision-validation.hh>
 
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <hpp/fcl/collision.h>
+#include <hpp/fcl/distance.h>
 
+#include <pinocchio/container/aligned-vector.hpp>
 #include <pinocchio/multibody/geometry.hpp>
+#include <pinocchio/spatial/fcl-pinocchio-conversions.hpp>
 
 #include <hpp/pinocchio/body.hh>
 #include <hpp/pinocchio/device.hh>
@@ -29,10 +40,24 @@
 
 #include <hpp/core/relative-motion.hh>
 #include <hpp/core/collision-validation-report.hh>
+#include <hpp/core/occupancy-cache.hh>
 #include <hpp/core/relative-motion.hh>
 
+#include "forward-kinematics.hh"
+
 namespace hpp {
   namespace core {
+    using ::pinocchio::toFclTransform3f;
+
+    namespace {
+      /// Number of configurations the geometry placements of which are
+      /// computed before checking collisions
+      const std::size_t blockSize = 16;
+
+      typedef ::pinocchio::container::aligned_vector < ::pinocchio::SE3>
+      Placements_t;
+    } // namespace
+
     CollisionValidationPtr_t CollisionValidation::create
     (const DevicePtr_t& robot)
     {
@@ -43,57 +68,357 @@ namespace hpp {
     bool CollisionValidation::validate (const Configuration_t& config,
                                         ValidationReportPtr_t& validationReport)
     {
+      if (occupancy_ && occupancy_->isFree (config, scene_)) return true;
       pinocchio::DeviceSync device (robot_);
-      device.currentConfiguration (config);
-      device.computeForwardKinematics ();
-      device.updateGeometryPlacements ();
+      computeGeometryPlacements (device, config);
+
+      if (computeAllContacts_) {
+        const std::size_t n (cPairs_.size () +
+                             (checkParameterized_ ? pPairs_.size () : 0));
+        std::vector <CollisionValidationReportPtr_t> reports (n);
+        const std::size_t nThreads
+          (std::min ((std::size_t) allContactsThreads_, n));
+        if (nThreads <= 1) {
+          scanPairs (device.d (), reports, 0, 1);
+        } else {
+          boost::thread_group threads;
+          for (std::size_t t = 0; t < nThreads; ++t) {
+            threads.create_thread
+              (boost::bind (&CollisionValidation::scanPairs, this,
+                            boost::cref (device.d ()), boost::ref (reports),
+                            t, nThreads));
+          }
+          threads.join_all ();
+        }
+        AllCollisionsValidationReportPtr_t allReport;
+        for (std::size_t i = 0; i < n; ++i) {
+          if (!reports [i]) continue;
+          if (!allReport) {
+            allReport = AllCollisionsValidationReportPtr_t
+              (new AllCollisionsValidationReport
+               (reports [i]->object1, reports [i]->object2,
+                reports [i]->result));
+          }
+          allReport->collisionReports.push_back (reports [i]);
+        }
+        if (!allReport) {
+          if (occupancy_)
+            occupancy_->insert (config, clearance (device.d ()), scene_);
+          return true;
+        }
+        validationReport = allReport;
+        return false;
+      }
 
       fcl::CollisionResult collisionResult;
       std::size_t iPair = 0;
       const ObstacleUser::CollisionPairs_t* pairs (&cPairs_);
       bool collide = ObstacleUser::collide (cPairs_, cRequests_,
-          collisionResult, iPair, device.d());
+          collisionResult, iPair, device.d(), useBoundingSpheres_);
       if (!collide && checkParameterized_) {
         collide = ObstacleUser::collide (pPairs_, pRequests_,
-            collisionResult, iPair, device.d());
+            collisionResult, iPair, device.d(), useBoundingSpheres_);
         pairs = &pPairs_;
       }
       if (collide) {
-        CollisionValidationReportPtr_t report (
-            new CollisionValidationReport ((*pairs)[iPair], collisionResult));
-
-        if(computeAllContacts_){
-          // create report with the first collision
-          AllCollisionsValidationReportPtr_t allReport(
-              new AllCollisionsValidationReport ((*pairs)[iPair], collisionResult));
-          allReport->collisionReports.push_back(report);
-          // then loop over all the remaining pairs :
-          ++iPair;
-          for (;iPair < cPairs_.size(); ++iPair) {
-            collisionResult.clear();
-            if (fcl::collide (
-                  cPairs_[iPair].first ->fcl (device.d()),
-                  cPairs_[iPair].second->fcl (device.d()),
-                  cRequests_[iPair], collisionResult) != 0) {
-              CollisionValidationReportPtr_t report (
-                  new CollisionValidationReport ((*pairs)[iPair], collisionResult));
-              allReport->collisionReports.push_back(report);
-            }
-          }
-          validationReport=allReport;
-        }else{
-          validationReport = report;
-        }
+        validationReport = CollisionValidationReportPtr_t
+          (new CollisionValidationReport ((*pairs)[iPair], collisionResult));
         return false;
       }
+      if (occupancy_)
+        occupancy_->insert (config, clearance (device.d ()), scene_);
       return true;
     }
 
+    void CollisionValidation::scanPairs
+    (const pinocchio::DeviceData& data,
+     std::vector <CollisionValidationReportPtr_t>& reports,
+     std::size_t begin, std::size_t step) const
+    {
+      fcl::CollisionResult collisionResult;
+      for (std::size_t i = begin; i < reports.size (); i += step) {
+        const bool active (i < cPairs_.size ());
+        const CollisionPair_t& pair
+          (active ? cPairs_ [i] : pPairs_ [i - cPairs_.size ()]);
+        const fcl::CollisionRequest& request
+          (active ? cRequests_ [i] : pRequests_ [i - cPairs_.size ()]);
+        if (useBoundingSpheres_ && farApart (pair, request, data)) continue;
+        collisionResult.clear ();
+        if (fcl::collide (pair.first ->fcl (data), pair.second->fcl (data),
+                          request, collisionResult) != 0) {
+          reports [i] = CollisionValidationReportPtr_t
+            (new CollisionValidationReport (pair, collisionResult));
+        }
+      }
+    }
+
+    bool CollisionValidation::validateConfigurations
+    (const matrix_t& configurations, std::vector <bool>& valid,
+     std::vector <ValidationReportPtr_t>& reports)
+    {
+      // Reports of all contacts come from validate.
+      if (computeAllContacts_)
+        return ConfigValidation::validateConfigurations (configurations,
+                                                         valid, reports);
+      valid.assign (configurations.cols (), false);
+      reports.assign (configurations.cols (), ValidationReportPtr_t ());
+      validateRange (configurations, valid, reports, 0, 1);
+      return std::find (valid.begin (), valid.end (), false) == valid.end ();
+    }
+
+    void CollisionValidation::validateRange
+    (const matrix_t& configurations, std::vector <bool>& valid,
+     std::vector <ValidationReportPtr_t>& reports, size_type begin,
+     size_type step)
+    {
+      std::vector <size_type> block;
+      block.reserve (blockSize);
+      for (size_type i = begin; i < configurations.cols (); i += step) {
+        if (occupancy_ && occupancy_->isFree (configurations.col (i),
+                                              scene_)) {
+          valid [i] = true;
+          continue;
+        }
+        block.push_back (i);
+        if (block.size () < blockSize) continue;
+        validateBlock (configurations, block, valid, reports);
+        block.clear ();
+      }
+      if (!block.empty ())
+        validateBlock (configurations, block, valid, reports);
+    }
+
+    void CollisionValidation::validateBlock
+    (const matrix_t& configurations, const std::vector <size_type>& block,
+     std::vector <bool>& valid, std::vector <ValidationReportPtr_t>& reports)
+    {
+      const std::size_t n (block.size ());
+      const std::size_t nPairs (cPairs_.size () +
+                                (checkParameterized_ ? pPairs_.size () : 0));
+      // Objects of the checked pairs, the world centers of the bounding
+      // spheres of which are stored column-wise per configuration.
+      std::map <const pinocchio::CollisionObject*, size_type> objects;
+      std::vector <std::pair <size_type, size_type> > pairObjects (nPairs);
+      if (useBoundingSpheres_) {
+        for (std::size_t i = 0; i < nPairs; ++i) {
+          const CollisionPair_t& pair (i < cPairs_.size () ? cPairs_ [i] :
+                                       pPairs_ [i - cPairs_.size ()]);
+          pairObjects [i].first = objects.insert
+            (std::make_pair (pair.first.get (),
+                             (size_type) objects.size ())).first->second;
+          pairObjects [i].second = objects.insert
+            (std::make_pair (pair.second.get (),
+                             (size_type) objects.size ())).first->second;
+        }
+      }
+      pinocchio::DeviceSync device (robot_);
+      std::vector <Placements_t> placements (n);
+      matrix_t centers (3 * objects.size (), n);
+      for (std::size_t j = 0; j < n; ++j) {
+        computeGeometryPlacements (device, configurations.col (block [j]));
+        placements [j] = device.geomData ().oMg;
+        for (std::map <const pinocchio::CollisionObject*, size_type>
+               ::const_iterator it (objects.begin ()); it != objects.end ();
+             ++it) {
+          centers.block <3, 1> (3 * it->second, (size_type) j) =
+            toFclTransform3f (it->first->getTransform (device.d ()))
+            .transform (it->first->geometry ()->aabb_center);
+        }
+      }
+
+      // Compare the bounding spheres of each pair for all the
+      // configurations at once.
+      Eigen::Array <bool, 1, Eigen::Dynamic> close
+        (Eigen::Array <bool, 1, Eigen::Dynamic>::Constant
+         ((size_type) n, !useBoundingSpheres_));
+      for (std::size_t i = 0; useBoundingSpheres_ && i < nPairs; ++i) {
+        const bool active (i < cPairs_.size ());
+        const CollisionPair_t& pair
+          (active ? cPairs_ [i] : pPairs_ [i - cPairs_.size ()]);
+        const value_type r (pair.first->geometry ()->aabb_radius +
+                            pair.second->geometry ()->aabb_radius +
+                            (active ? cRequests_ [i] :
+                             pRequests_ [i - cPairs_.size ()])
+                            .security_margin);
+        if (r < 0) continue;
+        close = close ||
+          ((centers.middleRows (3 * pairObjects [i].first, 3) -
+            centers.middleRows (3 * pairObjects [i].second, 3))
+           .colwise ().squaredNorm ().array () <= r * r);
+      }
+
+      // Check the exact geometries of the configurations that need it.
+      fcl::CollisionResult collisionResult;
+      std::size_t current (n - 1);
+      for (std::size_t j = 0; j < n; ++j) {
+        const size_type i (block [j]);
+        if (!close [(size_type) j] && !occupancy_) {
+          valid [i] = true;
+          continue;
+        }
+        if (current != j) {
+          device.geomData ().oMg = placements [j];
+          current = j;
+        }
+        bool collide (false);
+        std::size_t iPair = 0;
+        const ObstacleUser::CollisionPairs_t* pairs (&cPairs_);
+        if (close [(size_type) j]) {
+          collide = ObstacleUser::collide (cPairs_, cRequests_,
+              collisionResult, iPair, device.d(), useBoundingSpheres_);
+          if (!collide && checkParameterized_) {
+            collide = ObstacleUser::collide (pPairs_, pRequests_,
+                collisionResult, iPair, device.d(), useBoundingSpheres_);
+            pairs = &pPairs_;
+          }
+        }
+        valid [i] = !collide;
+        if (collide) {
+          reports [i] = CollisionValidationReportPtr_t
+            (new CollisionValidationReport ((*pairs)[iPair], collisionResult));
+        } else if (occupancy_) {
+          occupancy_->insert (configurations.col (i), clearance (device.d ()),
+                              scene_);
+        }
+      }
+      // The joint placements of the device data are those of the last
+      // configuration.
+      if (current != n - 1) device.geomData ().oMg = placements [n - 1];
+    }
+
+    void CollisionValidation::occupancyCache (const OccupancyCachePtr_t& cache)
+    {
+      occupancy_ = cache;
+      sceneChanged ();
+    }
+
+    std::size_t CollisionValidation::sceneKey () const
+    {
+      const pinocchio::Model& model (robot_->model ());
+      std::size_t seed (0);
+      boost::hash_combine (seed, model.nq);
+      boost::hash_combine (seed, model.nv);
+      for (pinocchio::JointIndex i = 1; i < model.joints.size (); ++i) {
+        boost::hash_combine (seed, model.names [i]);
+        boost::hash_combine (seed, model.parents [i]);
+        const ::pinocchio::SE3& M (model.jointPlacements [i]);
+        boost::hash_range (seed, M.translation ().data (),
+                           M.translation ().data () + 3);
+        boost::hash_range (seed, M.rotation ().data (),
+                           M.rotation ().data () + 9);
+      }
+      pinocchio::DeviceSync device (robot_);
+      const std::size_t n (cPairs_.size () +
+                           (checkParameterized_ ? pPairs_.size () : 0));
+      for (std::size_t i = 0; i < n; ++i) {
+        const bool active (i < cPairs_.size ());
+        const CollisionPair_t& pair
+          (active ? cPairs_ [i] : pPairs_ [i - cPairs_.size ()]);
+        const fcl::CollisionRequest& request
+          (active ? cRequests_ [i] : pRequests_ [i - cPairs_.size ()]);
+        boost::hash_combine (seed, pair.first ->name ());
+        boost::hash_combine (seed, pair.second->name ());
+        boost::hash_combine (seed, request.security_margin);
+        // Obstacles do not move with the configuration.
+        const CollisionObjectConstPtr_t objects [2] =
+          { pair.first, pair.second };
+        for (int k = 0; k < 2; ++k) {
+          boost::hash_combine (seed, objects [k]->geometry ()->aabb_radius);
+          if (objects [k]->joint ()) continue;
+          const fcl::Transform3f M (toFclTransform3f
+                                    (objects [k]->getTransform (device.d ())));
+          for (int r = 0; r < 3; ++r) {
+            boost::hash_combine (seed, M.getTranslation () [r]);
+            for (int c = 0; c < 3; ++c)
+              boost::hash_combine (seed, M.getRotation () (r, c));
+          }
+        }
+      }
+      return seed;
+    }
+
+    value_type CollisionValidation::clearance
+    (const pinocchio::DeviceData& data) const
+    {
+      value_type result (std::numeric_limits <value_type>::infinity ());
+      const std::size_t n (cPairs_.size () +
+                           (checkParameterized_ ? pPairs_.size () : 0));
+      fcl::DistanceRequest distanceRequest (false, 0, 0);
+      fcl::DistanceResult distanceResult;
+      for (std::size_t i = 0; i < n; ++i) {
+        const bool active (i < cPairs_.size ());
+        const CollisionPair_t& pair
+          (active ? cPairs_ [i] : pPairs_ [i - cPairs_.size ()]);
+        const value_type margin
+          ((active ? cRequests_ [i] : pRequests_ [i - cPairs_.size ()])
+           .security_margin);
+        // The distance between the bounding spheres is a lower bound of
+        // the distance between the objects.
+        const fcl::CollisionGeometry& ga (*pair.first ->geometry ());
+        const fcl::CollisionGeometry& gb (*pair.second->geometry ());
+        const fcl::Vec3f d
+          (toFclTransform3f (pair.first ->getTransform (data)).transform
+           (ga.aabb_center) -
+           toFclTransform3f (pair.second->getTransform (data)).transform
+           (gb.aabb_center));
+        if (d.norm () - ga.aabb_radius - gb.aabb_radius - margin >= result)
+          continue;
+        distanceResult.clear ();
+        fcl::distance (pair.first ->fcl (data), pair.second->fcl (data),
+                       distanceRequest, distanceResult);
+        result = std::min (result, distanceResult.min_distance - margin);
+      }
+      return result;
+    }
+
+    void CollisionValidation::addObstacleToJoint
+    (const CollisionObjectConstPtr_t& object, const JointPtr_t& joint,
+     const bool includeChildren)
+    {
+      ObstacleUser::addObstacleToJoint (object, joint, includeChildren);
+      sceneChanged ();
+    }
+
+    void CollisionValidation::removeObstacleFromJoint
+    (const JointPtr_t& joint, const CollisionObjectConstPtr_t& object)
+    {
+      ObstacleUser::removeObstacleFromJoint (joint, object);
+      sceneChanged ();
+    }
+
+    void CollisionValidation::updateObstacle
+    (const CollisionObjectConstPtr_t& object)
+    {
+      ObstacleUser::updateObstacle (object);
+      sceneChanged ();
+    }
+
+    void CollisionValidation::filterCollisionPairs
+    (const RelativeMotion::matrix_type& relMotion)
+    {
+      ObstacleUser::filterCollisionPairs (relMotion);
+      sceneChanged ();
+    }
+
+    void CollisionValidation::setSecurityMargins
+    (const matrix_t& securityMatrix)
+    {
+      ObstacleUser::setSecurityMargins (securityMatrix);
+      sceneChanged ();
+    }
+
+    void CollisionValidation::sceneChanged ()
+    {
+      if (occupancy_) scene_ = sceneKey ();
+    }
+
     CollisionValidation::CollisionValidation (const DevicePtr_t& robot) :
       ObstacleUser (robot),
       robot_ (robot),
       checkParameterized_(false),
-      computeAllContacts_(false)
+      computeAllContacts_(false),
+      allContactsThreads_(1),
+      scene_ (0)
     {
       fcl::CollisionRequest req (fcl::NO_REQUEST,1); 
       req.enable_cached_gjk_guess = true;
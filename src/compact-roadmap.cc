@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/compact-roadmap.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#include <hpp/core/connected-component.hh>
+#include <hpp/core/edge.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/roadmap.hh>
+
+#include "dijkstra.hh"
+
+namespace hpp {
+  namespace core {
+    CompactRoadmapPtr_t CompactRoadmap::create (const RoadmapPtr_t& roadmap)
+    {
+      return CompactRoadmapPtr_t (new CompactRoadmap (roadmap));
+    }
+
+    CompactRoadmap::CompactRoadmap (const RoadmapPtr_t& roadmap) :
+      nodes_ (roadmap->nodes ().begin (), roadmap->nodes ().end ()),
+      numberComponents_ (0)
+    {
+      const std::size_t n (nodes_.size ());
+      ids_.rehash (n);
+      for (std::size_t i = 0; i < n; ++i)
+        ids_ [nodes_ [i]] = (size_type) i;
+
+      // Number connected components and store their reachability.
+      std::map <ConnectedComponent::RawPtr_t, size_type> ccIds;
+      std::vector <ConnectedComponentPtr_t> ccs;
+      for (ConnectedComponents_t::const_iterator it =
+             roadmap->connectedComponents ().begin ();
+           it != roadmap->connectedComponents ().end (); ++it) {
+        ccIds [it->get ()] = (size_type) ccs.size ();
+        ccs.push_back (*it);
+      }
+      numberComponents_ = (size_type) ccs.size ();
+      reachability_.assign (ccs.size () * ccs.size (), false);
+      for (std::size_t i = 0; i < ccs.size (); ++i) {
+        for (std::size_t j = 0; j < ccs.size (); ++j) {
+          reachability_ [i * ccs.size () + j] = ccs [i]->canReach (ccs [j]);
+        }
+      }
+      components_.resize (n);
+      for (std::size_t i = 0; i < n; ++i) {
+        components_ [i] = ccIds [nodes_ [i]->connectedComponent ().get ()];
+      }
+
+      // Store out edges in compressed sparse rows.
+      offsets_.reserve (n + 1);
+      sources_.reserve (roadmap->edges ().size ());
+      targets_.reserve (roadmap->edges ().size ());
+      costs_.reserve (roadmap->edges ().size ());
+      edges_.reserve (roadmap->edges ().size ());
+      for (std::size_t i = 0; i < n; ++i) {
+        offsets_.push_back ((size_type) targets_.size ());
+        const Edges_t& outEdges (nodes_ [i]->outEdges ());
+        for (Edges_t::const_iterator it = outEdges.begin ();
+             it != outEdges.end (); ++it) {
+          if (!(*it)->validated ()) continue;
+          sources_.push_back ((size_type) i);
+          targets_.push_back (ids_ [(*it)->to ()]);
+          costs_.push_back ((*it)->cost ());
+          edges_.push_back (*it);
+        }
+      }
+      offsets_.push_back ((size_type) targets_.size ());
+    }
+
+    size_type CompactRoadmap::id (const NodePtr_t& node) const
+    {
+      boost::unordered_map <const Node*, size_type>::const_iterator it
+        (ids_.find (node));
+      if (it == ids_.end ()) return -1;
+      return it->second;
+    }
+
+    void CompactRoadmap::shortestPaths (size_type from,
+                                        std::vector <value_type>& costs,
+                                        EdgeIds_t& parents) const
+    {
+      dijkstra (std::vector <size_type> (1, from),
+                std::vector <value_type> (1, 0), -1, costs, parents);
+    }
+
+    void CompactRoadmap::shortestPaths
+    (const std::vector <size_type>& sources,
+     const std::vector <value_type>& initialCosts,
+     std::vector <value_type>& costs, EdgeIds_t& parents) const
+    {
+      assert (sources.size () == initialCosts.size ());
+      dijkstra (sources, initialCosts, -1, costs, parents);
+    }
+
+    bool CompactRoadmap::shortestPath (size_type from, size_type to,
+                                       EdgeIds_t& edges) const
+    {
+      std::vector <value_type> costs;
+      EdgeIds_t parents;
+      edges.clear ();
+      if (!canReach (from, to)) return false;
+      dijkstra (std::vector <size_type> (1, from),
+                std::vector <value_type> (1, 0), to, costs, parents);
+      if (costs [to] == std::numeric_limits <value_type>::infinity ())
+        return false;
+      for (size_type node = to; node != from;) {
+        const size_type edge (parents [node]);
+        edges.push_back (edge);
+        node = sources_ [edge];
+      }
+      std::reverse (edges.begin (), edges.end ());
+      return true;
+    }
+
+    PathVectorPtr_t CompactRoadmap::pathVector (const EdgeIds_t& edges) const
+    {
+      if (edges.empty ())
+        throw std::invalid_argument ("Cannot build a path from no edge.");
+      const PathPtr_t& first (edges_ [edges.front ()]->path ());
+      PathVectorPtr_t result (PathVector::create
+                              (first->outputSize (),
+                               first->outputDerivativeSize ()));
+      for (EdgeIds_t::const_iterator it = edges.begin (); it != edges.end ();
+           ++it) {
+        result->appendPath (edges_ [*it]->path ());
+      }
+      return result;
+    }
+
+    void CompactRoadmap::dijkstra
+    (const std::vector <size_type>& sources,
+     const std::vector <value_type>& initialCosts, size_type to,
+     std::vector <value_type>& costs, EdgeIds_t& parents) const
+    {
+      core::dijkstra ((size_type) nodes_.size (), offsets_, targets_, costs_,
+                      sources, initialCosts, to, costs, parents);
+    }
+  } //   namespace core
+} // namespace hpp
@@ -19,6 +19,7 @@
 #include <hpp/core/config-projector.hh>
 
 #include <limits>
+#include <stdexcept>
 #include <boost/serialization/weak_ptr.hpp>
 
 #include <boost/bind.hpp>
@@ -27,6 +28,9 @@
 #include <hpp/util/timer.hh>
 #include <hpp/util/serialization.hh>
 
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/trace.hh>
+
 #include <pinocchio/multibody/model.hpp>
 
 #include <hpp/pinocchio/configuration.hh>
@@ -57,6 +61,11 @@ namespace hpp {
     HPP_DEFINE_REASON_FAILURE (REASON_MAX_ITER, "Max Iterations reached");
     HPP_DEFINE_REASON_FAILURE (REASON_ERROR_INCREASED, "Error increased");
     HPP_DEFINE_REASON_FAILURE (REASON_INFEASIBLE, "Problem infeasible");
+    HPP_DEFINE_REASON_FAILURE (REASON_EARLY_ABORT,
+                               "Error decreased too slowly");
+
+    /// Status returned by solverSolveWithEarlyAbort when aborting
+    static const int EARLY_ABORT = -1;
 
     ConfigProjectorPtr_t ConfigProjector::create (const DevicePtr_t& robot,
 						  const std::string& name,
@@ -87,7 +96,10 @@ namespace hpp {
       lineSearchType_ (defaultLineSearch_),
       solver_ (new BySubstitution (robot->configSpace()->vectorSpacesMerged())),
       weak_ (),
-      statistics_ ("ConfigProjector " + name)
+      statistics_ ("ConfigProjector " + name),
+      warmStartRadius_ (0), warmStarts_ (0), warmStartSuccesses_ (0),
+      earlyAbortRate_ (0), earlyAbortIterations_ (3), lastIterations_ (0),
+      qWork_ (robot->configSize ()), dqWork_ (robot->numberDof ())
     {
       errorThreshold (_errorThreshold);
       maxIterations  (_maxIterations);
@@ -100,7 +112,11 @@ namespace hpp {
       lineSearchType_ (cp.lineSearchType_),
       solver_ (new BySubstitution(*cp.solver_)),
       weak_ (),
-      statistics_ (cp.statistics_)
+      statistics_ (cp.statistics_),
+      warmStartRadius_ (cp.warmStartRadius_), warmStarts_ (0),
+      warmStartSuccesses_ (0), earlyAbortRate_ (cp.earlyAbortRate_),
+      earlyAbortIterations_ (cp.earlyAbortIterations_), lastIterations_ (0),
+      qWork_ (cp.qWork_.size ()), dqWork_ (cp.dqWork_.size ())
     {
     }
 
@@ -124,6 +140,7 @@ namespace hpp {
 			       const segments_t& passiveDofs,
 			       const std::size_t priority)
     {
+      warmStartInput_.resize (0);
       return solver_->add (nm, passiveDofs, priority);
     }
 
@@ -131,11 +148,11 @@ namespace hpp {
     (ConfigurationIn_t configuration, vectorOut_t value,
      matrixOut_t reducedJacobian)
     {
-      Configuration_t q (configuration);
+      qWork_ = configuration;
       // q_{out} = f (q_{in})
-      solver_->explicitConstraintSet().solve(q);
-      solver_->computeValue<true>(q);
-      solver_->updateJacobian(q); // includes the jacobian of the explicit system
+      solver_->explicitConstraintSet().solve(qWork_);
+      solver_->computeValue<true>(qWork_);
+      solver_->updateJacobian(qWork_); // includes the jacobian of the explicit system
       solver_->getValue(value);
       solver_->getReducedJacobian(reducedJacobian);
     }
@@ -156,6 +173,21 @@ namespace hpp {
         (normal);
     }
 
+    vectorIn_t ConfigProjector::compressVector (vectorIn_t normal) const
+    {
+      compressed_.resize (numberFreeVariables ());
+      compressVector (normal, compressed_);
+      return compressed_;
+    }
+
+    vectorIn_t ConfigProjector::uncompressVector (vectorIn_t small) const
+    {
+      uncompressed_.resize (robot_->numberDof ());
+      uncompressed_.setZero ();
+      uncompressVector (small, uncompressed_);
+      return uncompressed_;
+    }
+
     void ConfigProjector::compressMatrix (matrixIn_t normal,
 					  matrixOut_t small, bool rows) const
     {
@@ -184,13 +216,36 @@ namespace hpp {
 
     bool ConfigProjector::impl_compute (ConfigurationOut_t configuration)
     {
+      HPP_CORE_TRACE_SPAN ("ConfigProjector::apply");
+      HPP_CORE_ALLOCATION_SCOPE (PROJECTION);
+      // Explicit constraints only: evaluate the explicit functions in order,
+      // without Newton iterations.
+      if (solver_->dimension () == 0) {
+        if (!solver_->explicitConstraintSet ().solve (configuration)) {
+          statistics_.addFailure (REASON_INFEASIBLE);
+          return false;
+        }
+        statistics_.addSuccess();
+        return true;
+      }
       // If configuration satisfies the constraint, do not modify it
       if (isSatisfied (configuration)) return true;
       if (!(robot_->computationFlag() & pinocchio::JACOBIAN))
         throw std::runtime_error("In ConfigProjector::apply: can't project a configuration if JACOBIAN computation flag is not enabled.");
-      BySubstitution::Status status = (BySubstitution::Status)
-        solverSolve (configuration);
+      if (warmStart (configuration)) {
+        statistics_.addSuccess();
+        return true;
+      }
+      // Store the input configuration for the next warm start.
+      if (warmStartRadius_ > 0) qWork_ = configuration;
+      const int status (earlyAbortRate_ > 0 ?
+                        solverSolveWithEarlyAbort (configuration) :
+                        solverSolve (configuration));
       switch (status) {
+        case EARLY_ABORT:
+          statistics_.addFailure (REASON_EARLY_ABORT);
+          return false;
+          break;
         case BySubstitution::ERROR_INCREASED:
           statistics_.addFailure (REASON_ERROR_INCREASED);
           return false;
@@ -205,12 +260,77 @@ namespace hpp {
           break;
         case BySubstitution::SUCCESS:
           statistics_.addSuccess();
+          if (warmStartRadius_ > 0) {
+            warmStartInput_ = qWork_;
+            warmStartOutput_ = configuration;
+            warmStartRhs_ = solver_->rightHandSide ();
+          }
           return true;
           break;
       }
       return false;
     }
 
+    void ConfigProjector::earlyAbort (const value_type& rate,
+                                      size_type iterations)
+    {
+      if (rate < 0 || rate >= 1)
+        throw std::invalid_argument ("Early abort rate should be in [0, 1)");
+      if (iterations < 1)
+        throw std::invalid_argument
+          ("Number of iterations of early abort should be at least 1");
+      earlyAbortRate_ = rate;
+      earlyAbortIterations_ = iterations;
+    }
+
+    int ConfigProjector::solverSolveWithEarlyAbort (ConfigurationOut_t config)
+    {
+      value_type previous (std::numeric_limits <value_type>::infinity ());
+      size_type slow (0);
+      for (lastIterations_ = 0; lastIterations_ < maxIterations ();
+           ++lastIterations_) {
+        if (solverOneStep (config) && isSatisfied (config))
+          return BySubstitution::SUCCESS;
+        const value_type error (residualError ());
+        if (error > (1 - earlyAbortRate_) * previous) {
+          if (++slow >= earlyAbortIterations_) return EARLY_ABORT;
+        } else
+          slow = 0;
+        previous = error;
+      }
+      if (isSatisfied (config)) return BySubstitution::SUCCESS;
+      return BySubstitution::MAX_ITERATION_REACHED;
+    }
+
+    void ConfigProjector::warmStartRadius (const value_type& radius)
+    {
+      warmStartRadius_ = radius;
+      warmStartInput_.resize (0);
+    }
+
+    bool ConfigProjector::warmStart (ConfigurationOut_t configuration)
+    {
+      if (warmStartRadius_ <= 0 ||
+          warmStartInput_.size () != configuration.size ())
+        return false;
+      const vector_t rhs (solver_->rightHandSide ());
+      if (rhs.size () != warmStartRhs_.size () || rhs != warmStartRhs_)
+        return false;
+      pinocchio::difference (robot_, configuration, warmStartInput_, dqWork_);
+      if (dqWork_.norm () > warmStartRadius_) return false;
+
+      ++warmStarts_;
+      pinocchio::integrate (robot_, warmStartOutput_, dqWork_, qWork_);
+      if ((BySubstitution::Status) solverSolve (qWork_) !=
+          BySubstitution::SUCCESS)
+        return false;
+      ++warmStartSuccesses_;
+      warmStartInput_ = configuration;
+      warmStartOutput_ = qWork_;
+      configuration = qWork_;
+      return true;
+    }
+
     bool ConfigProjector::oneStep (ConfigurationOut_t configuration,
         vectorOut_t dq, const value_type&)
     {
@@ -18,10 +18,57 @@
 
 
 #include <hpp/core/config-validations.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
 #include <hpp/core/validation-report.hh>
 
+#include "validation-ordering.hh"
+
 namespace hpp {
   namespace core {
+    /// Least recently used results of validate
+    struct ConfigValidations::Cache
+    {
+      struct Entry
+      {
+        Configuration_t key;
+        bool valid;
+        ValidationReportPtr_t report;
+      }; // struct Entry
+      struct Hash
+      {
+        std::size_t operator() (const Configuration_t& q) const
+        {
+          return boost::hash_range (q.data (), q.data () + q.size ());
+        }
+      }; // struct Hash
+      struct Equal
+      {
+        bool operator() (const Configuration_t& a,
+                         const Configuration_t& b) const
+        {
+          return a.size () == b.size () && a == b;
+        }
+      }; // struct Equal
+      /// Entries from the most to the least recently used
+      typedef std::list <Entry> Entries_t;
+      typedef boost::unordered_map <Configuration_t, Entries_t::iterator,
+                                    Hash, Equal> Map_t;
+
+      Entries_t entries;
+      Map_t map;
+      boost::mutex mutex;
+    }; // struct Cache
+
     ConfigValidationsPtr_t ConfigValidations::create ()
     {
       ConfigValidations* ptr = new ConfigValidations;
@@ -31,19 +78,130 @@ namespace hpp {
     bool ConfigValidations::validate (const Configuration_t& config,
 				      ValidationReportPtr_t& validationReport)
     {
-      for (std::vector <ConfigValidationPtr_t>::iterator
-       it = validations_.begin (); it != validations_.end (); ++it) {
-	if ((*it)->validate (config, validationReport)
-	    == false) {
-	  return false;
-	}
+      if (cacheSize_ == 0) return evaluate (config, validationReport);
+      Configuration_t key (config);
+      if (cacheResolution_ > 0) {
+        // Adding 0 gives the same key to -0 and 0.
+        for (size_type i = 0; i < key.size (); ++i)
+          key [i] = std::floor (key [i] / cacheResolution_ + .5)
+            * cacheResolution_ + 0.;
+      }
+      {
+        boost::mutex::scoped_lock lock (cache_->mutex);
+        Cache::Map_t::iterator found (cache_->map.find (key));
+        if (found != cache_->map.end ()) {
+          ++cacheHits_;
+          cache_->entries.splice (cache_->entries.begin (), cache_->entries,
+                                  found->second);
+          validationReport = found->second->report;
+          return found->second->valid;
+        }
+        ++cacheMisses_;
+      }
+      Cache::Entry entry;
+      entry.key = key;
+      entry.valid = evaluate (config, entry.report);
+      validationReport = entry.report;
+      boost::mutex::scoped_lock lock (cache_->mutex);
+      if (cache_->map.find (key) == cache_->map.end ()) {
+        cache_->entries.push_front (entry);
+        cache_->map [key] = cache_->entries.begin ();
+        while ((size_type) cache_->map.size () > cacheSize_) {
+          cache_->map.erase (cache_->entries.back ().key);
+          cache_->entries.pop_back ();
+        }
+      }
+      return entry.valid;
+    }
+
+    bool ConfigValidations::evaluate (const Configuration_t& config,
+                                      ValidationReportPtr_t& validationReport)
+    {
+      if (!ordering_) {
+        for (std::vector <ConfigValidationPtr_t>::iterator
+               it = validations_.begin (); it != validations_.end (); ++it) {
+          if (!(*it)->validate (config, validationReport)) return false;
+        }
+        return true;
+      }
+      typedef ValidationOrdering::Clock_t Clock_t;
+      ValidationOrdering::OrderPtr_t order (ordering_->order ());
+      ValidationOrdering::Samples_t samples;
+      samples.reserve (order->size ());
+      bool valid = true;
+      for (std::size_t k = 0; valid && k < order->size (); ++k) {
+        const std::size_t i ((*order) [k]);
+        const Clock_t::time_point start (Clock_t::now ());
+        valid = validations_ [i]->validate (config, validationReport);
+        samples.push_back (ValidationOrdering::Sample
+                           (i, 1, valid ? 0 : 1,
+                            ValidationOrdering::elapsed (start)));
+      }
+      ordering_->record (samples);
+      return valid;
+    }
+
+    bool ConfigValidations::certifies (const PathPtr_t& path) const
+    {
+      for (std::vector <ConfigValidationPtr_t>::const_iterator
+             it = validations_.begin (); it != validations_.end (); ++it) {
+        if (!(*it)->certifies (path)) return false;
       }
       return true;
     }
 
+    bool ConfigValidations::validateConfigurations
+    (const matrix_t& configurations, std::vector <bool>& valid,
+     std::vector <ValidationReportPtr_t>& reports)
+    {
+      valid.assign (configurations.cols (), true);
+      reports.assign (configurations.cols (), ValidationReportPtr_t ());
+      // Columns of configurations that are still valid
+      std::vector <size_type> indices (configurations.cols ());
+      for (size_type i = 0; i < configurations.cols (); ++i) indices [i] = i;
+      std::vector <bool> subValid;
+      std::vector <ValidationReportPtr_t> subReports;
+      typedef ValidationOrdering::Clock_t Clock_t;
+      ValidationOrdering::OrderPtr_t order;
+      ValidationOrdering::Samples_t samples;
+      if (ordering_) order = ordering_->order ();
+      for (std::size_t k = 0; k < validations_.size (); ++k) {
+        if (indices.empty ()) break;
+        const std::size_t i (order ? (*order) [k] : k);
+        matrix_t subset (configurations.rows (), indices.size ());
+        for (std::size_t j = 0; j < indices.size (); ++j)
+          subset.col (j) = configurations.col (indices [j]);
+        const Clock_t::time_point start (Clock_t::now ());
+        const bool allValid (validations_ [i]->validateConfigurations
+                             (subset, subValid, subReports));
+        if (order) {
+          samples.push_back (ValidationOrdering::Sample
+                             (i, (size_type) indices.size (),
+                              (size_type) std::count (subValid.begin (),
+                                                      subValid.end (), false),
+                              ValidationOrdering::elapsed (start)));
+        }
+        if (allValid) continue;
+        std::vector <size_type> remaining;
+        for (std::size_t j = 0; j < indices.size (); ++j) {
+          if (subValid [j]) {
+            remaining.push_back (indices [j]);
+          } else {
+            valid [indices [j]] = false;
+            reports [indices [j]] = subReports [j];
+          }
+        }
+        indices.swap (remaining);
+      }
+      if (order) ordering_->record (samples);
+      return indices.size () == (std::size_t) configurations.cols ();
+    }
+
     void ConfigValidations::add (const ConfigValidationPtr_t& configValidation)
     {
       validations_.push_back (configValidation);
+      if (ordering_) adaptiveOrdering (true);
+      clearCache ();
     }
 
     size_type ConfigValidations::numberConfigValidations () const
@@ -54,9 +212,83 @@ namespace hpp {
     void ConfigValidations::clear ()
     {
       validations_.clear ();
+      if (ordering_) adaptiveOrdering (true);
+      clearCache ();
+    }
+
+    void ConfigValidations::adaptiveOrdering (bool enable)
+    {
+      if (enable)
+        ordering_.reset (new ValidationOrdering (validations_.size ()));
+      else
+        ordering_.reset ();
+    }
+
+    void ConfigValidations::cacheSize (size_type n)
+    {
+      if (n < 0)
+        throw std::invalid_argument ("cache size should be non negative.");
+      cacheSize_ = n;
+      clearCache ();
+    }
+
+    void ConfigValidations::cacheResolution (value_type resolution)
+    {
+      if (resolution < 0)
+        throw std::invalid_argument ("cache resolution should be non "
+                                     "negative.");
+      cacheResolution_ = resolution;
+      clearCache ();
+    }
+
+    void ConfigValidations::clearCache ()
+    {
+      boost::mutex::scoped_lock lock (cache_->mutex);
+      cache_->entries.clear ();
+      cache_->map.clear ();
+    }
+
+    void ConfigValidations::addObstacle
+    (const CollisionObjectConstPtr_t& object)
+    {
+      ObstacleUserVector <ConfigValidationPtr_t>::addObstacle (object);
+      clearCache ();
+    }
+
+    void ConfigValidations::removeObstacleFromJoint
+    (const JointPtr_t& joint, const CollisionObjectConstPtr_t& object)
+    {
+      ObstacleUserVector <ConfigValidationPtr_t>::removeObstacleFromJoint
+        (joint, object);
+      clearCache ();
+    }
+
+    void ConfigValidations::updateObstacle
+    (const CollisionObjectConstPtr_t& object)
+    {
+      ObstacleUserVector <ConfigValidationPtr_t>::updateObstacle (object);
+      clearCache ();
+    }
+
+    void ConfigValidations::filterCollisionPairs
+    (const RelativeMotion::matrix_type& relMotion)
+    {
+      ObstacleUserVector <ConfigValidationPtr_t>::filterCollisionPairs
+        (relMotion);
+      clearCache ();
+    }
+
+    void ConfigValidations::setSecurityMargins
+    (const matrix_t& securityMatrix)
+    {
+      ObstacleUserVector <ConfigValidationPtr_t>::setSecurityMargins
+        (securityMatrix);
+      clearCache ();
     }
 
-    ConfigValidations::ConfigValidations ()
+    ConfigValidations::ConfigValidations () :
+      cacheSize_ (0), cacheResolution_ (0), cacheHits_ (0), cacheMisses_ (0),
+      cache_ (new Cache)
     {
     }
 
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include "configuration-arena.hh"
+
+#include <stdexcept>
+
+namespace hpp {
+  namespace core {
+    ConfigurationArena::ConfigurationArena (size_type chunkSize) :
+      chunkSize_ (chunkSize), chunk_ (), used_ (0)
+    {
+      if (chunkSize_ <= 0)
+        throw std::invalid_argument
+          ("ConfigurationArena: chunk size should be positive");
+    }
+
+    ConfigurationPtr_t ConfigurationArena::allocate
+    (ConfigurationIn_t configuration)
+    {
+      if (!chunk_ || used_ == chunkSize_) {
+        chunk_.reset (new Chunk_t ((std::size_t) chunkSize_));
+        used_ = 0;
+      }
+      Configuration_t& q ((*chunk_) [(std::size_t) used_]);
+      q = configuration;
+      ++used_;
+      // Aliasing constructor: share the reference counter of the chunk.
+      return ConfigurationPtr_t (chunk_, &q);
+    }
+
+    void ConfigurationArena::clear ()
+    {
+      chunk_.reset ();
+      used_ = 0;
+    }
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_CONFIGURATION_ARENA_HH
+# define HPP_CORE_CONFIGURATION_ARENA_HH
+
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    /// Storage of the configurations of the nodes of a roadmap
+    ///
+    /// Configurations are allocated by chunks. The pointers returned by
+    /// \ref allocate share the reference counter of their chunk, so that
+    /// storing a configuration does not allocate a reference counter and
+    /// a vector object per configuration. A chunk is freed when no pointer
+    /// to any of its configurations remains.
+    class ConfigurationArena
+    {
+    public:
+      /// Constructor
+      /// \param chunkSize number of configurations per chunk.
+      ConfigurationArena (size_type chunkSize = 1024);
+
+      /// Store a copy of a configuration
+      ConfigurationPtr_t allocate (ConfigurationIn_t configuration);
+
+      /// Release the current chunk.
+      /// Configurations already allocated remain valid.
+      void clear ();
+
+    private:
+      typedef std::vector <Configuration_t> Chunk_t;
+      typedef boost::shared_ptr <Chunk_t> ChunkPtr_t;
+
+      size_type chunkSize_;
+      ChunkPtr_t chunk_;
+      /// Number of configurations allocated in chunk_
+      size_type used_;
+    }; // class ConfigurationArena
+  } //   namespace core
+} // namespace hpp
+#endif // HPP_CORE_CONFIGURATION_ARENA_HH
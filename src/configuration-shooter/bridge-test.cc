@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/configuration-shooter/bridge-test.hh>
+
+#include <boost/random/normal_distribution.hpp>
+
+#include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/core/config-validations.hh>
+#include <hpp/core/random-generator.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      BridgeTestPtr_t BridgeTest::create
+      (const DevicePtr_t& robot, const ConfigurationShooterPtr_t& shooter,
+       const ConfigValidationsPtr_t& configValidations)
+      {
+        BridgeTest* ptr = new BridgeTest (robot, shooter, configValidations);
+        BridgeTestPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      BridgeTest::BridgeTest (const DevicePtr_t& robot,
+                              const ConfigurationShooterPtr_t& shooter,
+                              const ConfigValidationsPtr_t& configValidations)
+        : robot_ (robot), shooter_ (shooter),
+        configValidations_ (configValidations), sigma_ (0.1),
+        maxAttempts_ (100)
+      {
+      }
+
+      void BridgeTest::validate (const matrix_t& configurations,
+                                 std::vector <bool>& valid) const
+      {
+        std::vector <ValidationReportPtr_t> reports;
+        configValidations_->validateConfigurations (configurations, valid,
+                                                    reports);
+      }
+
+      void BridgeTest::impl_shoot (Configuration_t& q) const
+      {
+        matrix_t configurations (robot_->configSize (), 1);
+        impl_shoot (configurations);
+        q = configurations.col (0);
+      }
+
+      void BridgeTest::impl_shoot (matrix_t& configurations) const
+      {
+        const size_type nq (robot_->configSize ()),
+          n (configurations.cols ());
+        configurations.resize (nq, n);
+        boost::random::normal_distribution <value_type> distrib (0, sigma_);
+        vector_t velocity (robot_->numberDof ());
+        matrix_t q1, q2, middles;
+        std::vector <bool> valid;
+        std::vector <size_type> bridges;
+        size_type found (0);
+        for (size_type attempt = 0; attempt < maxAttempts_ && found < n;
+             ++attempt) {
+          // First ends of the bridges, kept if invalid
+          q1.resize (nq, n - found);
+          shooter_->shoot (q1);
+          validate (q1, valid);
+          bridges.clear ();
+          for (size_type i = 0; i < q1.cols (); ++i)
+            if (!valid [i]) bridges.push_back (i);
+          if (bridges.empty ()) continue;
+
+          // Second ends of the bridges, kept if invalid
+          q2.resize (nq, (size_type) bridges.size ());
+          for (std::size_t i = 0; i < bridges.size (); ++i) {
+            for (size_type k = 0; k < velocity.size (); ++k)
+              velocity [k] = distrib (*generator_);
+            ::hpp::pinocchio::integrate (robot_, q1.col (bridges [i]),
+                                         velocity, q2.col (i));
+            ::hpp::pinocchio::saturate (robot_, q2.col (i));
+          }
+          validate (q2, valid);
+          std::size_t m (0);
+          for (std::size_t i = 0; i < bridges.size (); ++i) {
+            if (valid [i]) continue;
+            q2.col (m) = q2.col (i);
+            bridges [m] = bridges [i];
+            ++m;
+          }
+          if (m == 0) continue;
+
+          // Middles of the bridges, returned if valid
+          middles.resize (nq, (size_type) m);
+          for (std::size_t i = 0; i < m; ++i)
+            ::hpp::pinocchio::interpolate (robot_, q1.col (bridges [i]),
+                                           q2.col (i), .5, middles.col (i));
+          validate (middles, valid);
+          for (std::size_t i = 0; i < m; ++i)
+            if (valid [i]) configurations.col (found++) = middles.col (i);
+        }
+        if (found < n) {
+          q1.resize (nq, n - found);
+          shooter_->shoot (q1);
+          configurations.rightCols (n - found) = q1;
+        }
+      }
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
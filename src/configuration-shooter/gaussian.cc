@@ -18,7 +18,6 @@
 
 #include <math.h>
 
-#include <boost/random/mersenne_twister.hpp>
 #include <boost/random/normal_distribution.hpp>
 
 #include <pinocchio/algorithm/joint-configuration.hpp>
@@ -27,8 +26,11 @@
 
 #include <hpp/pinocchio/configuration.hh>
 #include <hpp/pinocchio/liegroup.hh>
+#include <hpp/pinocchio/liegroup-space.hh>
 # include <hpp/pinocchio/joint-collection.hh>
 
+#include <hpp/core/random-generator.hh>
+
 namespace hpp {
   namespace core {
     namespace configurationShooter {
@@ -108,23 +110,54 @@ namespace hpp {
 
       void Gaussian::impl_shoot (Configuration_t& config) const
       {
-        static boost::random::mt19937 eng;
         vector_t velocity (robot_->numberDof());
+        config.resize(robot_->configSize ());
+        shootAround (velocity, config);
+      }
+
+      void Gaussian::impl_shoot (matrix_t& configurations) const
+      {
+        const size_type n (configurations.cols ());
+        configurations.resize(robot_->configSize (), n);
+        // Draw all the velocities from one standard normal distribution.
+        boost::random::normal_distribution<value_type> distrib;
+        matrix_t velocities (robot_->numberDof(), n);
+        for (size_type j = 0; j < n; ++j)
+          for (size_type i = 0; i < velocities.rows (); ++i)
+            velocities (i, j) = distrib (*generator_);
+        velocities = sigmas_.asDiagonal () * velocities;
+
+        const Configuration_t& center (center_.size() == 0 ?
+            robot_->neutralConfiguration() : center_);
+        if (robot_->configSpace ()->isVectorSpace ()) {
+          configurations = velocities.colwise () + center;
+        } else {
+          for (size_type j = 0; j < n; ++j)
+            ::hpp::pinocchio::integrate (robot_, center, velocities.col (j),
+                configurations.col (j));
+        }
+        for (size_type j = 0; j < n; ++j)
+          ::hpp::pinocchio::saturate (robot_, configurations.col (j));
+      }
+
+      void Gaussian::shootAround (vector_t& velocity, ConfigurationOut_t q)
+        const
+      {
         for (size_type i = 0; i < velocity.size(); ++i)
         {
           boost::random::normal_distribution<value_type> distrib(0, sigmas_[i]);
-          velocity[i] = distrib (eng);
+          velocity[i] = distrib (*generator_);
         }
 
-        config.resize(robot_->configSize ());
-	vector_t center (center_);
-	if (center.size() == 0)
+	if (center_.size() == 0)
 	{
 	  // center has not been initialized, use robot neutral configuration
-	  center = robot_->neutralConfiguration();
+	  ::hpp::pinocchio::integrate (robot_, robot_->neutralConfiguration(),
+              velocity, q);
 	}
-        ::hpp::pinocchio::integrate (robot_, center_, velocity, config);
-        ::hpp::pinocchio::saturate  (robot_, config);
+        else
+          ::hpp::pinocchio::integrate (robot_, center_, velocity, q);
+        ::hpp::pinocchio::saturate  (robot_, q);
       }
 
       void Gaussian::sigma(const value_type& factor)
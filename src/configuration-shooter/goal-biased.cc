@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/configuration-shooter/goal-biased.hh>
+
+#include <hpp/core/problem.hh>
+#include <hpp/core/random-generator.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      GoalBiasedPtr_t GoalBiased::create
+      (const ConfigurationShooterPtr_t& shooter, const Problem& problem)
+      {
+        GoalBiased* ptr = new GoalBiased (shooter, problem);
+        GoalBiasedPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      GoalBiased::GoalBiased (const ConfigurationShooterPtr_t& shooter,
+                              const Problem& problem)
+        : shooter_ (shooter), problem_ (problem), bias_ (0.05)
+      {
+      }
+
+      void GoalBiased::impl_shoot (Configuration_t& q) const
+      {
+        const Configurations_t& goals (problem_.goalConfigs ());
+        if (!goals.empty () && generator_->uniform () < bias_) {
+          q = *goals [generator_->index ((size_type) goals.size ())];
+          return;
+        }
+        shooter_->shoot (q);
+      }
+
+      void GoalBiased::impl_shoot (matrix_t& configurations) const
+      {
+        shooter_->shoot (configurations);
+        const Configurations_t& goals (problem_.goalConfigs ());
+        if (goals.empty ()) return;
+        for (size_type i = 0; i < configurations.cols (); ++i) {
+          if (generator_->uniform () < bias_)
+            configurations.col (i) =
+              *goals [generator_->index ((size_type) goals.size ())];
+        }
+      }
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/configuration-shooter/halton.hh>
+
+#include <cassert>
+#include <limits>
+
+#include <hpp/pinocchio/device.hh>
+
+#include "uniform-step.hh"
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      namespace {
+        /// Radical inverse of an integer in a base
+        value_type radicalInverse (size_type k, size_type base)
+        {
+          const value_type inverse (1. / (value_type) base);
+          value_type result (0), factor (inverse);
+          while (k > 0) {
+            result += factor * (value_type) (k % base);
+            k /= base;
+            factor *= inverse;
+          }
+          return result;
+        }
+
+        /// Point of the Halton sequence
+        ///
+        /// Successive calls to uniform return the successive coordinates
+        /// of the point.
+        struct HaltonPoint
+        {
+          HaltonPoint (const std::vector <size_type>& p, size_type k) :
+            primes (p), index (k), dimension (0)
+          {
+          }
+          value_type uniform ()
+          {
+            assert (dimension < primes.size ());
+            return radicalInverse (index, primes [dimension++]);
+          }
+          value_type uniform (value_type lower, value_type upper)
+          {
+            return lower + (upper - lower) * uniform ();
+          }
+          const std::vector <size_type>& primes;
+          size_type index;
+          std::size_t dimension;
+        }; // struct HaltonPoint
+      } // namespace
+
+      HaltonPtr_t Halton::create (const DevicePtr_t& robot)
+      {
+        Halton* ptr = new Halton (robot);
+        HaltonPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      Halton::Halton (const DevicePtr_t& robot) : robot_ (robot),
+        sampleExtraDOF_ (true), index_ (1)
+      {
+        // No joint consumes more coordinates than its configuration size.
+        const std::size_t n ((std::size_t) robot->configSize ());
+        for (size_type p = 2; primes_.size () < n; ++p) {
+          bool prime (true);
+          for (std::size_t i = 0; i < primes_.size () &&
+                 primes_ [i] * primes_ [i] <= p; ++i) {
+            if (p % primes_ [i] == 0) {
+              prime = false;
+              break;
+            }
+          }
+          if (prime) primes_.push_back (p);
+        }
+      }
+
+      void Halton::impl_shoot (Configuration_t& config) const
+      {
+        size_type extraDim = robot_->extraConfigSpace ().dimension ();
+        size_type offset = robot_->configSize () - extraDim;
+
+        config.resize (robot_->configSize ());
+        Block_t block (config.data (), config.size (), 1);
+        HaltonPoint point (primes_, index_++);
+        uniformConfigurations (robot_->model (), point, block);
+
+        if (sampleExtraDOF_) {
+          for (size_type i = 0; i < extraDim; ++i) {
+            value_type lower = robot_->extraConfigSpace ().lower (i);
+            value_type upper = robot_->extraConfigSpace ().upper (i);
+            value_type range = upper - lower;
+            if ((range < 0) ||
+                (range == std::numeric_limits<double>::infinity())) {
+              std::ostringstream oss
+                ("Cannot uniformy sample extra config variable ");
+              oss << i << ". min = " << lower << ", max = " << upper;
+              throw std::runtime_error (oss.str ());
+            }
+            config [offset + i] = point.uniform (lower, upper);
+          }
+        } else {
+          config.tail (extraDim).setZero ();
+        }
+      }
+    } // namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/configuration-shooter/informed.hh>
+
+#include <hpp/core/distance.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      InformedPtr_t Informed::create (const ConfigurationShooterPtr_t& shooter,
+                                      const DistancePtr_t& distance)
+      {
+        Informed* ptr = new Informed (shooter, distance);
+        InformedPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      Informed::Informed (const ConfigurationShooterPtr_t& shooter,
+                          const DistancePtr_t& distance) :
+        shooter_ (shooter), distance_ (distance),
+        maxCost_ (std::numeric_limits <value_type>::infinity ()),
+        maxAttempts_ (100)
+      {
+      }
+
+      void Informed::impl_shoot (Configuration_t& q) const
+      {
+        shooter_->shoot (q);
+        if (maxCost_ == std::numeric_limits <value_type>::infinity ()) return;
+        const Distance& d (*distance_);
+        for (size_type i = 1; i < maxAttempts_; ++i) {
+          if (d (start_, q) + d (q, goal_) < maxCost_) return;
+          shooter_->shoot (q);
+        }
+      }
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
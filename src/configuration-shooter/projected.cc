@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/configuration-shooter/projected.hh>
+
+#include <stdexcept>
+
+#include <hpp/pinocchio/configuration.hh>
+
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/random-generator.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      ProjectedPtr_t Projected::create
+      (const ConfigurationShooterPtr_t& shooter, const Problem& problem)
+      {
+        Projected* ptr = new Projected (shooter, problem);
+        ProjectedPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      Projected::Projected (const ConfigurationShooterPtr_t& shooter,
+                            const Problem& problem)
+        : shooter_ (shooter), problem_ (problem), poolSize_ (100),
+        seedProbability_ (.5), perturbation_ (.1), maxAttempts_ (10),
+        next_ (0)
+      {
+      }
+
+      void Projected::poolSize (size_type n)
+      {
+        if (n < 0)
+          throw std::invalid_argument ("The size of the pool must be "
+                                       "non negative.");
+        poolSize_ = n;
+        clear ();
+      }
+
+      void Projected::store (ConfigurationIn_t q) const
+      {
+        if (poolSize_ == 0) return;
+        if ((size_type) pool_.size () < poolSize_) {
+          pool_.push_back (q);
+        } else {
+          pool_ [next_] = q;
+          next_ = (next_ + 1) % pool_.size ();
+        }
+      }
+
+      void Projected::impl_shoot (Configuration_t& q) const
+      {
+        const ConstraintSetPtr_t& constraints (problem_.constraints ());
+        shooter_->shoot (q);
+        if (!constraints) return;
+        Configuration_t start (q.size ());
+        for (size_type i = 0; i < maxAttempts_; ++i) {
+          if (i > 0) shooter_->shoot (q);
+          if (!pool_.empty () && generator_->uniform () < seedProbability_) {
+            const Configuration_t& seed
+              (pool_ [generator_->index ((size_type) pool_.size ())]);
+            ::hpp::pinocchio::interpolate (problem_.robot (), seed, q,
+                                           perturbation_, start);
+          } else {
+            start = q;
+          }
+          if (constraints->apply (start)) {
+            store (start);
+            q = start;
+            return;
+          }
+        }
+      }
+    } //   namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#ifndef HPP_CORE_CONFIGURATION_SHOOTER_UNIFORM_STEP_HH
+# define HPP_CORE_CONFIGURATION_SHOOTER_UNIFORM_STEP_HH
+
+# include <cmath>
+# include <sstream>
+# include <stdexcept>
+
+# include <pinocchio/multibody/model.hpp>
+
+# include <hpp/pinocchio/joint-collection.hh>
+# include <hpp/pinocchio/liegroup.hh>
+
+# include <hpp/core/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    namespace configurationShooter {
+      namespace liegroup = pinocchio::liegroup;
+
+      /// Map on the configurations of a block, stored column-wise
+      typedef Eigen::Map<matrix_t> Block_t;
+
+      // Sampling is implemented per Lie group, as ::pinocchio::
+      // randomConfiguration, but maps numbers drawn from a generator. The
+      // generator provides uniform () in [0,1) and uniform (lower, upper),
+      // so that both pseudo-random streams and low discrepancy sequences
+      // share the mappings.
+      template <typename Generator_t, int N, bool rot>
+      void uniformAlgo (liegroup::VectorSpaceOperation<N, rot>,
+          Generator_t& generator, vectorOut_t q, vectorIn_t upper,
+          vectorIn_t lower)
+      {
+        for (size_type i = 0; i < q.size(); ++i) {
+          if (!Eigen::numext::isfinite (upper(i) - lower(i))) {
+            std::ostringstream oss ("Cannot uniformy sample unbounded "
+                                    "configuration variable ");
+            oss << i << ". min = " << lower(i) << ", max = " << upper(i);
+            throw std::runtime_error (oss.str ());
+          }
+          q(i) = generator.uniform (lower(i), upper(i));
+        }
+      }
+
+      template <typename Generator_t>
+      void uniformAlgo (liegroup::SpecialOrthogonalOperation<2>,
+          Generator_t& generator, vectorOut_t q, vectorIn_t, vectorIn_t)
+      {
+        const value_type theta (generator.uniform (-M_PI, M_PI));
+        q(0) = std::cos (theta);
+        q(1) = std::sin (theta);
+      }
+
+      template <typename Generator_t>
+      void uniformAlgo (liegroup::SpecialOrthogonalOperation<3>,
+          Generator_t& generator, vectorOut_t q, vectorIn_t, vectorIn_t)
+      {
+        // Uniform sampling of unit quaternions (Shoemake). The mapping
+        // preserves volumes, hence also the uniformity of a low
+        // discrepancy sequence of the unit cube.
+        const value_type u1 (generator.uniform ()),
+          u2 (2 * M_PI * generator.uniform ()),
+          u3 (2 * M_PI * generator.uniform ());
+        const value_type a (std::sqrt (1 - u1)), b (std::sqrt (u1));
+        q(0) = a * std::sin (u2);
+        q(1) = a * std::cos (u2);
+        q(2) = b * std::sin (u3);
+        q(3) = b * std::cos (u3);
+      }
+
+      template <typename Generator_t, typename LG1, typename LG2>
+      void uniformAlgo (liegroup::CartesianProductOperation<LG1, LG2>,
+          Generator_t& generator, vectorOut_t q, vectorIn_t upper,
+          vectorIn_t lower)
+      {
+        uniformAlgo (LG1(), generator, q.head(LG1::NQ), upper.head(LG1::NQ),
+            lower.head(LG1::NQ));
+        uniformAlgo (LG2(), generator, q.tail(LG2::NQ), upper.tail(LG2::NQ),
+            lower.tail(LG2::NQ));
+      }
+
+      template <typename Generator_t, int N>
+      void uniformAlgo (liegroup::SpecialEuclideanOperation<N>,
+          Generator_t& generator, vectorOut_t q, vectorIn_t upper,
+          vectorIn_t lower)
+      {
+        typedef liegroup::CartesianProductOperation<
+          liegroup::VectorSpaceOperation<N,false>,
+          liegroup::SpecialOrthogonalOperation<N>
+            > LG_t;
+        uniformAlgo (LG_t(), generator, q, upper, lower);
+      }
+
+      template <typename Generator_t>
+      struct UniformStep : public ::pinocchio::fusion::JointUnaryVisitorBase<UniformStep<Generator_t> >
+      {
+        typedef boost::fusion::vector<const pinocchio::Model&,
+                Generator_t&, Block_t&> ArgsType;
+
+        template<typename JointModel>
+          static void apply(const ::pinocchio::JointModelBase<JointModel> & jmodel,
+              const pinocchio::Model& model,
+              Generator_t& generator,
+              Block_t& q)
+          {
+            typedef typename pinocchio::DefaultLieGroupMap::operation<JointModel>::type LG_t;
+            for (size_type j = 0; j < q.cols(); ++j)
+              uniformAlgo (LG_t(), generator,
+                  q.col(j).segment (jmodel.idx_q(), jmodel.nq()),
+                  jmodel.jointConfigSelector (model.upperPositionLimit),
+                  jmodel.jointConfigSelector (model.lowerPositionLimit));
+          }
+
+        static void apply(const ::pinocchio::JointModelBase< pinocchio::JointModelComposite> & jmodel,
+              const pinocchio::Model& model,
+              Generator_t& generator,
+              Block_t& q)
+        {
+          ::pinocchio::details::Dispatch<UniformStep>::run(jmodel.derived(), ArgsType(model, generator, q));
+        }
+
+        // Each joint is dispatched once per block.
+        template<typename JointModel>
+          static void algo(const ::pinocchio::JointModelBase<JointModel> & jmodel,
+              const pinocchio::Model& model,
+              Generator_t& generator,
+              Block_t& q)
+          {
+            apply (jmodel, model, generator, q);
+          }
+      };
+
+      /// Sample the configurations of the joints of a robot
+      template <typename Generator_t>
+      void uniformConfigurations (const pinocchio::Model& model,
+          Generator_t& generator, Block_t& configurations)
+      {
+        typename UniformStep<Generator_t>::ArgsType args
+          (model, generator, configurations);
+        for(std::size_t i = 1; i < model.joints.size(); ++i)
+          UniformStep<Generator_t>::run (model.joints[i], args);
+      }
+    } // namespace configurationShooter
+  } //   namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_CONFIGURATION_SHOOTER_UNIFORM_STEP_HH
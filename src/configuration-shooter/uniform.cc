@@ -18,21 +18,34 @@
 
 # include <hpp/core/configuration-shooter/uniform.hh>
 
-# include <pinocchio/algorithm/joint-configuration.hpp>
+# include <hpp/core/random-generator.hh>
 
-# include <hpp/pinocchio/joint-collection.hh>
+# include "uniform-step.hh"
 
 namespace hpp {
   namespace core {
     namespace configurationShooter {
-
       void Uniform::impl_shoot (Configuration_t& config) const
+      {
+        config.resize(robot_->configSize ());
+        Block_t block (config.data (), config.size (), 1);
+        shootBlock (block);
+      }
+
+      void Uniform::impl_shoot (matrix_t& configurations) const
+      {
+        configurations.resize(robot_->configSize (), configurations.cols ());
+        Block_t block (configurations.data (), configurations.rows (),
+                       configurations.cols ());
+        shootBlock (block);
+      }
+
+      void Uniform::shootBlock (Eigen::Map<matrix_t>& configurations) const
       {
         size_type extraDim = robot_->extraConfigSpace ().dimension ();
         size_type offset = robot_->configSize () - extraDim;
 
-        config.resize(robot_->configSize ());
-        config.head (offset) = ::pinocchio::randomConfiguration(robot_->model());
+        uniformConfigurations (robot_->model(), *generator_, configurations);
 
         if(sampleExtraDOF_){
             // Shoot extra configuration variables
@@ -47,10 +60,12 @@ namespace hpp {
                 oss << i << ". min = " <<lower<< ", max = " << upper << std::endl;
                 throw std::runtime_error (oss.str ());
               }
-              config [offset + i] = lower + (upper - lower) * rand ()/RAND_MAX;
+              for (size_type j = 0; j < configurations.cols (); ++j)
+                configurations (offset + i, j) =
+                  generator_->uniform (lower, upper);
             }
         }else{
-            config.tail(extraDim).setZero();
+            configurations.bottomRows(extraDim).setZero();
         }
       }
 
@@ -17,30 +17,20 @@
 // <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <deque>
 #include <hpp/core/connected-component.hh>
 #include <hpp/core/edge.hh>
 
 namespace hpp {
   namespace core {
-    // Mark connected components of a list as unexplored.
-    void ConnectedComponent::clean (RawPtrs_t& set)
-    {
-      for (RawPtrs_t::iterator it = set.begin ();
-	   it != set.end (); ++it) {
-	(*it)->explored_ = false;
-      }
-    }
-
     void ConnectedComponent::merge (const ConnectedComponentPtr_t& other)
     {
       assert(other);
       assert(weak_.lock().get() == this);
 
-      // Tell other's nodes that they now belong to this connected component
-      for (NodeVector_t::iterator itNode = other->nodes_.begin ();
-	   itNode != other->nodes_.end (); ++itNode) {
-	(*itNode)->connectedComponent (weak_.lock ());
-      }
+      // Other's nodes resolve their connected component lazily, see
+      // Node::connectedComponent.
+      other->mergedInto_ = weak_.lock ();
       // Add other's nodes to this list.
       nodes_.insert (nodes_.end (), other->nodes_.begin(), other->nodes_.end());
 
@@ -58,113 +48,105 @@ namespace hpp {
 	(*itcc)->reachableTo_.insert (this);
       }
       
-      RawPtrs_t tmp;
-      std::set_union (reachableTo_.begin (), reachableTo_.end (),
-		      other->reachableTo_.begin (), other->reachableTo_.end (),
-		      std::inserter (tmp, tmp.begin ()));
-      reachableTo_ = tmp; tmp.clear ();
+      reachableTo_.insert (other->reachableTo_.begin (),
+			   other->reachableTo_.end ());
       reachableTo_.erase (other.get());
       reachableTo_.erase (this);
-      std::set_union (reachableFrom_.begin (), reachableFrom_.end (),
-		      other->reachableFrom_.begin (),
-		      other->reachableFrom_.end (),
-		      std::inserter (tmp, tmp.begin()));
-      reachableFrom_ = tmp; tmp.clear ();
+      reachableFrom_.insert (other->reachableFrom_.begin (),
+			     other->reachableFrom_.end ());
       reachableFrom_.erase (other.get());
       reachableFrom_.erase (this);
+
+      // Same for transitive reachability
+      for (RawPtrs_t::iterator itcc = other->allReachableTo_.begin ();
+	   itcc != other->allReachableTo_.end (); ++itcc) {
+	(*itcc)->allReachableFrom_.erase (other.get());
+	(*itcc)->allReachableFrom_.insert (this);
+      }
+      for (RawPtrs_t::iterator itcc = other->allReachableFrom_.begin ();
+	   itcc != other->allReachableFrom_.end (); ++itcc) {
+	(*itcc)->allReachableTo_.erase (other.get());
+	(*itcc)->allReachableTo_.insert (this);
+      }
+      allReachableTo_.insert (other->allReachableTo_.begin (),
+			      other->allReachableTo_.end ());
+      allReachableTo_.erase (other.get());
+      allReachableTo_.erase (this);
+      allReachableFrom_.insert (other->allReachableFrom_.begin (),
+				other->allReachableFrom_.end ());
+      allReachableFrom_.erase (other.get());
+      allReachableFrom_.erase (this);
     }
 
-    bool ConnectedComponent::canReach (const ConnectedComponentPtr_t& cc)
+    ConnectedComponentPtr_t ConnectedComponent::root
+    (const ConnectedComponentPtr_t& cc)
+    {
+      ConnectedComponentPtr_t result (cc);
+      while (result->mergedInto_) result = result->mergedInto_;
+      // Path compression
+      ConnectedComponentPtr_t current (cc);
+      while (current->mergedInto_ && current->mergedInto_ != result) {
+	ConnectedComponentPtr_t next (current->mergedInto_);
+	current->mergedInto_ = result;
+	current = next;
+      }
+      return result;
+    }
+
+    void ConnectedComponent::addReachability (RawPtr_t from, RawPtr_t to)
+    {
+      RawPtrs_t ancestors (from->allReachableFrom_);
+      ancestors.insert (from);
+      RawPtrs_t descendants (to->allReachableTo_);
+      descendants.insert (to);
+      for (RawPtrs_t::iterator it = ancestors.begin ();
+	   it != ancestors.end (); ++it) {
+	(*it)->allReachableTo_.insert (descendants.begin (), descendants.end ());
+	(*it)->allReachableTo_.erase (*it);
+      }
+      for (RawPtrs_t::iterator it = descendants.begin ();
+	   it != descendants.end (); ++it) {
+	(*it)->allReachableFrom_.insert (ancestors.begin (), ancestors.end ());
+	(*it)->allReachableFrom_.erase (*it);
+      }
+    }
+
+    void ConnectedComponent::computeAllReachableTo ()
     {
-      // Store visited connected components for further cleaning.
-      RawPtrs_t explored;
       std::deque <RawPtr_t> queue;
       queue.push_back (this);
-      explored_ = true;
-      explored.insert (this);
       while (!queue.empty ()) {
 	RawPtr_t current = queue.front ();
 	queue.pop_front ();
-	if (current == cc.get()) {
-	  clean (explored);
-	  return true;
-	}
-	for (RawPtrs_t::iterator itChild =
-	       current->reachableTo_.begin ();
+	for (RawPtrs_t::iterator itChild = current->reachableTo_.begin ();
 	     itChild != current->reachableTo_.end (); ++itChild) {
-	  RawPtr_t child = *itChild;
-	  if (!child->explored_) {
-	    child->explored_ = true;
-	    explored.insert (child);
-	    queue.push_back (child);
+	  if (*itChild != this && allReachableTo_.insert (*itChild).second) {
+	    (*itChild)->allReachableFrom_.insert (this);
+	    queue.push_back (*itChild);
 	  }
 	}
       }
-      clean (explored);
-      return false;
+    }
+
+    bool ConnectedComponent::canReach (const ConnectedComponentPtr_t& cc)
+    {
+      return cc.get () == this ||
+	allReachableTo_.find (cc.get ()) != allReachableTo_.end ();
     }
 
     bool ConnectedComponent::canReach
     (const ConnectedComponentPtr_t& cc, RawPtrs_t& ccToThis)
     {
-      bool reachable = false;
-      // Store visited connected components
-      RawPtrs_t exploredForward;
-      std::deque <RawPtr_t> queue;
-      queue.push_back (this);
-      explored_ = true;
-      exploredForward.insert (this);
-      while (!queue.empty ()) {
-	RawPtr_t current = queue.front ();
-	queue.pop_front ();
-	if (current == cc.get()) {
-	  reachable = true;
-	  exploredForward.insert (current);
-	} else {
-	  for (RawPtrs_t::iterator itChild =
-		 current->reachableTo_.begin ();
-	       itChild != current->reachableTo_.end (); ++itChild) {
-	    RawPtr_t child = *itChild;
-	    if (!child->explored_) {
-	      child->explored_ = true;
-	      exploredForward.insert (child);
-	      queue.push_back (child);
-	    }
-	  }
-	}
-      }
-      // Set visited connected components to unexplored
-      clean (exploredForward);
-      if (!reachable) return false;
-
-      // Store visited connected components
-      RawPtrs_t exploredBackward;
-      queue.push_back (cc.get());
-      cc->explored_ = true;
-      exploredBackward.insert (cc.get());
-      while (!queue.empty ()) {
-	RawPtr_t current = queue.front ();
-	queue.pop_front ();
-	if (current == this) {
-	  exploredBackward.insert (current);
-	} else {
-	  for (RawPtrs_t::iterator itChild =
-		 current->reachableFrom_.begin ();
-	       itChild != current->reachableFrom_.end (); ++itChild) {
-	    RawPtr_t child = *itChild;
-	    if (!child->explored_) {
-	      child->explored_ = true;
-	      exploredBackward.insert (child);
-	      queue.push_back (child);
-	    }
-	  }
-	}
+      if (!canReach (cc)) return false;
+      // Connected components reachable from this that can reach cc.
+      ccToThis.insert (this);
+      ccToThis.insert (cc.get ());
+      for (RawPtrs_t::iterator it = allReachableTo_.begin ();
+	   it != allReachableTo_.end (); ++it) {
+	if ((*it)->allReachableTo_.find (cc.get ()) !=
+	    (*it)->allReachableTo_.end ())
+	  ccToThis.insert (*it);
       }
-      // Set visited connected components to unexplored
-      clean (exploredBackward);
-      std::set_intersection (exploredForward.begin (), exploredForward.end (),
-			     exploredBackward.begin (), exploredBackward.end (),
-			     std::inserter (ccToThis, ccToThis.begin ()));
       return true;
     }
 
@@ -110,6 +110,12 @@ namespace hpp {
       return result;
     }
 
+    value_type ConstraintSet::residualError () const
+    {
+      ConfigProjectorPtr_t cp (configProjector ());
+      return cp ? cp->residualError () : 0;
+    }
+
     size_type ConstraintSet::numberNonLockedDof () const
     {
       return _configProj()->numberFreeVariables ();
@@ -127,6 +133,16 @@ namespace hpp {
       _configProj()->uncompressVector (small, normal);
     }
 
+    vectorIn_t ConstraintSet::compressVector (vectorIn_t normal) const
+    {
+      return _configProj()->compressVector (normal);
+    }
+
+    vectorIn_t ConstraintSet::uncompressVector (vectorIn_t small) const
+    {
+      return _configProj()->uncompressVector (small);
+    }
+
     void ConstraintSet::compressMatrix (matrixIn_t normal, matrixOut_t small,
 					bool rows) const
     {
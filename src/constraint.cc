@@ -18,7 +18,13 @@
 
 #include <hpp/core/constraint-set.hh>
 
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/bind.hpp>
 #include <boost/serialization/weak_ptr.hpp>
+#include <boost/thread/thread.hpp>
 #include <hpp/util/serialization.hh>
 
 namespace hpp {
@@ -28,6 +34,45 @@ namespace hpp {
       return impl_compute (configuration);
     }
 
+    namespace {
+      void applyColumns (Constraint& constraint, matrixOut_t configurations,
+                         ArrayXb& success, vector_t& residuals,
+                         size_type begin, size_type stride)
+      {
+        for (size_type i = begin; i < configurations.cols (); i += stride) {
+          success [i] = constraint.apply (configurations.col (i));
+          residuals [i] = constraint.residualError ();
+        }
+      }
+    } // namespace
+
+    bool Constraint::apply (matrixOut_t configurations, ArrayXb& success,
+                            vector_t& residuals, size_type numberThreads)
+    {
+      if (numberThreads < 1)
+        throw std::invalid_argument ("Number of threads should be at least 1");
+      const size_type n (configurations.cols ());
+      success.resize (n);
+      residuals.resize (n);
+      const size_type nThreads (std::min (numberThreads, n));
+      if (nThreads <= 1) {
+        applyColumns (*this, configurations, success, residuals, 0, 1);
+        return success.all ();
+      }
+      std::vector <ConstraintPtr_t> copies;
+      boost::thread_group threads;
+      for (size_type t = 1; t < nThreads; ++t) {
+        copies.push_back (copy ());
+        threads.create_thread
+          (boost::bind (&applyColumns, boost::ref (*copies.back ()),
+                        configurations, boost::ref (success),
+                        boost::ref (residuals), t, nThreads));
+      }
+      applyColumns (*this, configurations, success, residuals, 0, nThreads);
+      threads.join_all ();
+      return success.all ();
+    }
+
     template<class Archive>
     void Constraint::serialize(Archive & ar, const unsigned int version)
     {
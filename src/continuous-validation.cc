@@ -18,14 +18,25 @@
 
 #include <hpp/core/continuous-validation.hh>
 
+#include <algorithm>
 #include <limits>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+
 #include <pinocchio/multibody/geometry.hpp>
 #include <hpp/util/debug.hh>
 #include <hpp/core/collision-path-validation-report.hh>
 #include <hpp/core/straight-path.hh>
 #include <hpp/core/path-vector.hh>
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/trace.hh>
 #include <hpp/core/continuous-validation/solid-solid-collision.hh>
 
+#include "forward-kinematics.hh"
+
 #include <iterator>
 namespace hpp {
   namespace core {
@@ -129,6 +140,24 @@ namespace hpp {
     /// \retval report reason why the interval is not valid,
     /// \return true if the configuration is collision free for this parameter
     ///         value, false otherwise.
+    bool ContinuousValidation::intervalsValidated
+    (const IntervalValidations_t& intervalValidations,
+     const value_type& t) const
+    {
+      // Same reduction of the interval as in validateIntervals
+      interval_t interval (-std::numeric_limits <value_type>::infinity (),
+                           std::numeric_limits <value_type>::infinity ());
+      for (IntervalValidations_t::const_iterator itVal
+             (intervalValidations.begin ());
+           itVal != intervalValidations.end (); ++itVal) {
+        interval_t tmpInt (interval);
+        if (!(*itVal)->validated (t, tmpInt)) return false;
+        interval.first = std::max (interval.first, tmpInt.first);
+        interval.second = std::min (interval.second, tmpInt.second);
+      }
+      return true;
+    }
+
     bool ContinuousValidation::validateConfiguration
     (IntervalValidations_t& intervalValidations,
         const Configuration_t &config, const value_type &t,
@@ -137,15 +166,23 @@ namespace hpp {
       interval.first = -std::numeric_limits <value_type>::infinity ();
       interval.second = std::numeric_limits <value_type>::infinity ();
       hpp::pinocchio::DeviceSync robot (robot_);
-      robot.currentConfiguration (config);
-      robot.computeForwardKinematics();
-      robot.updateGeometryPlacements();
+      // Forward kinematics is computed at most once per parameter, and not
+      // at all if the interval validations already know they are valid.
+      if (!intervalsValidated (intervalValidations, t)) {
+        computeGeometryPlacements (robot, config);
+      }
       IntervalValidations_t::iterator smallestInterval
         (intervalValidations.begin());
       if (!validateIntervals
             (intervalValidations, t, interval, report,
-             smallestInterval, robot.d()))
+             smallestInterval, robot.d())) {
+        // Move the colliding element to the front, keeping the order of the
+        // others: elements that collided recently are tested first on the
+        // next paths, which are then rejected sooner.
+        std::rotate (intervalValidations.begin(), smallestInterval,
+                     smallestInterval + 1);
         return false;
+      }
       // Put the smallest interval first so that, at next iteration,
       // collision pairs with large interval are not computed.
       if (intervalValidations.size() > 1 &&
@@ -154,38 +191,66 @@ namespace hpp {
       return true;
     }
 
+    namespace {
+      value_type minimalClearance
+      (const IntervalValidations_t& intervalValidations)
+      {
+        value_type clearance (std::numeric_limits <value_type>::infinity ());
+        for (IntervalValidations_t::const_iterator it
+               (intervalValidations.begin ());
+             it != intervalValidations.end (); ++it)
+          clearance = std::min (clearance, (*it)->clearance ());
+        return clearance;
+      }
+    } // namespace
+
     bool ContinuousValidation::validate(const PathPtr_t &path, bool reverse, PathPtr_t &validPart,
                                               PathValidationReportPtr_t &report)
     {
+      value_type clearance;
+      return validateWithClearance (path, reverse, validPart, report,
+                                    clearance);
+    }
+
+    bool ContinuousValidation::validateWithClearance
+    (const PathPtr_t &path, bool reverse, PathPtr_t &validPart,
+     PathValidationReportPtr_t &report, value_type& clearance)
+    {
+      HPP_CORE_TRACE_SPAN ("PathValidation::validate");
+      HPP_CORE_ALLOCATION_SCOPE (VALIDATION);
+      clearance = std::numeric_limits <value_type>::infinity ();
+      value_type localClearance;
       if (PathVectorPtr_t pv = HPP_DYNAMIC_PTR_CAST(PathVector, path))
       {
-        PathVectorPtr_t validPathVector = PathVector::create(path->outputSize(), path->outputDerivativeSize());
-        validPart = validPathVector;
+        // The valid part is only built if a sub path is not valid.
         PathPtr_t localValidPart;
         if (reverse)
         {
           value_type param = path->length();
-          std::deque<PathPtr_t> paths;
-          for (std::size_t i = pv->numberPaths() + 1; i != 0; --i)
+          for (std::size_t i = pv->numberPaths(); i != 0; --i)
           {
             PathPtr_t localPath(pv->pathAtRank(i - 1));
-            if (validate(localPath, reverse, localValidPart, report))
+            const bool valid (validateWithClearance
+                              (localPath, reverse, localValidPart, report,
+                               localClearance));
+            clearance = std::min (clearance, localClearance);
+            if (valid)
             {
-              paths.push_front(localPath->copy());
               param -= localPath->length();
             }
             else
             {
               report->parameter += param - localPath->length();
-              paths.push_front(localValidPart->copy());
-              for (std::deque<PathPtr_t>::const_iterator it = paths.begin();
-                  it != paths.end(); ++it)
-              {
-                validPathVector->appendPath(*it);
-              }
+              PathVectorPtr_t validPathVector = PathVector::create
+                (path->outputSize(), path->outputDerivativeSize());
+              validPathVector->appendPath(localValidPart->copy());
+              for (std::size_t j = i; j < pv->numberPaths(); ++j)
+                validPathVector->appendPath(pv->pathAtRank(j)->copy());
+              validPart = validPathVector;
               return false;
             }
           }
+          validPart = path;
           return true;
         }
         else
@@ -194,34 +259,219 @@ namespace hpp {
           for (std::size_t i = 0; i < pv->numberPaths(); ++i)
           {
             PathPtr_t localPath(pv->pathAtRank(i));
-            if (validate(localPath, reverse, localValidPart, report))
+            const bool valid (validateWithClearance
+                              (localPath, reverse, localValidPart, report,
+                               localClearance));
+            clearance = std::min (clearance, localClearance);
+            if (valid)
             {
-              validPathVector->appendPath(localPath->copy());
               param += localPath->length();
             }
             else
             {
               report->parameter += param;
+              PathVectorPtr_t validPathVector = PathVector::create
+                (path->outputSize(), path->outputDerivativeSize());
+              for (std::size_t j = 0; j < i; ++j)
+                validPathVector->appendPath(pv->pathAtRank(j)->copy());
               validPathVector->appendPath(localValidPart->copy());
+              validPart = validPathVector;
               return false;
             }
           }
+          validPart = path;
           return true;
         }
       }
+      if (splitIntervalValidations_ && numberThreads_ > 1 &&
+          intervalValidations_.size () > 1)
+        return validateStraightPathSplit (path, reverse, validPart, report,
+                                          clearance);
+      IntervalValidations_t* bpc = acquireIntervalValidations ();
+      bool ret = validateStraightPath(*bpc, path, reverse, validPart, report);
+      clearance = minimalClearance (*bpc);
+      bodyPairCollisionPool_.release (bpc);
+      return ret;
+    }
+
+    IntervalValidations_t* ContinuousValidation::acquireIntervalValidations ()
+    {
       // Copy list of BodyPairCollision instances in a pool for thread safety.
-      IntervalValidations_t* bpc;
       if (!bodyPairCollisionPool_.available()) {
         // Add an element
-        bpc = new IntervalValidations_t(intervalValidations_.size());
+        IntervalValidations_t* bpc =
+          new IntervalValidations_t(intervalValidations_.size());
         for (std::size_t i = 0; i < bpc->size(); ++i)
           (*bpc)[i] = intervalValidations_[i]->copy();
         bodyPairCollisionPool_.push_back (bpc);
       }
-      bpc = bodyPairCollisionPool_.acquire();
-      bool ret = validateStraightPath(*bpc, path, reverse, validPart, report);
-      bodyPairCollisionPool_.release (bpc);
-      return ret;
+      return bodyPairCollisionPool_.acquire();
+    }
+
+    namespace {
+      /// Set in the threads created by validatePaths and
+      /// validateStraightPathSplit
+      boost::thread_specific_ptr <bool> workerThread;
+
+      /// Mark the current thread as a worker thread while in scope
+      struct WorkerScope
+      {
+        explicit WorkerScope (bool worker) : worker (worker)
+        {
+          if (worker) workerThread.reset (new bool (true));
+        }
+        ~WorkerScope ()
+        {
+          if (worker) workerThread.reset ();
+        }
+        bool worker;
+      }; // struct WorkerScope
+    } // namespace
+
+    size_type ContinuousValidation::straightPathThreads () const
+    {
+      return workerThread.get () ? 1 : numberThreads_;
+    }
+
+    void ContinuousValidation::validateSubset
+    (IntervalValidations_t& intervalValidations, const PathPtr_t& path,
+     bool reverse, PathPtr_t& validPart, PathValidationReportPtr_t& report)
+    {
+      WorkerScope scope (true);
+      validateStraightPath (intervalValidations, path, reverse, validPart,
+                            report);
+    }
+
+    namespace {
+      /// Result of the validation of a straight path by one thread
+      struct SplitResult
+      {
+        PathPtr_t validPart;
+        PathValidationReportPtr_t report;
+      }; // struct SplitResult
+    } // namespace
+
+    bool ContinuousValidation::validateStraightPathSplit
+    (const PathPtr_t& path, bool reverse, PathPtr_t& validPart,
+     PathValidationReportPtr_t& report, value_type& clearance)
+    {
+      const std::size_t nThreads (std::min ((std::size_t) numberThreads_,
+                                            intervalValidations_.size ()));
+      // Each thread validates every nThreads-th element of its own copy.
+      std::vector <IntervalValidations_t*> copies (nThreads);
+      std::vector <IntervalValidations_t> subsets (nThreads);
+      for (std::size_t t = 0; t < nThreads; ++t) {
+        copies [t] = acquireIntervalValidations ();
+        for (std::size_t i = t; i < copies [t]->size (); i += nThreads)
+          subsets [t].push_back ((*copies [t]) [i]);
+      }
+      std::vector <SplitResult> results (nThreads);
+      boost::thread_group threads;
+      for (std::size_t t = 0; t < nThreads; ++t) {
+        threads.create_thread
+          (boost::bind (&ContinuousValidation::validateSubset, this,
+                        boost::ref (subsets [t]), boost::cref (path), reverse,
+                        boost::ref (results [t].validPart),
+                        boost::ref (results [t].report)));
+      }
+      threads.join_all ();
+      clearance = std::numeric_limits <value_type>::infinity ();
+      for (std::size_t t = 0; t < nThreads; ++t) {
+        clearance = std::min (clearance, minimalClearance (subsets [t]));
+        bodyPairCollisionPool_.release (copies [t]);
+      }
+
+      // Threads set the valid part to the path itself when it is valid.
+      // Otherwise, the path is valid up to the shortest valid part.
+      validPart = path;
+      bool valid = true;
+      for (std::size_t t = 0; t < nThreads; ++t) {
+        if (results [t].validPart == path) continue;
+        if (valid || results [t].validPart->length () < validPart->length ()) {
+          valid = false;
+          validPart = results [t].validPart;
+          report = results [t].report;
+        }
+      }
+      return valid;
+    }
+
+    struct ContinuousValidation::Batch
+    {
+      Batch (const std::vector <PathPtr_t>& p, bool r,
+             std::vector <PathPtr_t>& vp,
+             std::vector <PathValidationReportPtr_t>& rs, bool s) :
+        paths (p), reverse (r), validParts (vp), reports (rs),
+        stopAtFirstInvalid (s), stop (false)
+      {
+      }
+      const std::vector <PathPtr_t>& paths;
+      bool reverse;
+      std::vector <PathPtr_t>& validParts;
+      std::vector <PathValidationReportPtr_t>& reports;
+      bool stopAtFirstInvalid;
+      /// Set when a path is invalid and stopAtFirstInvalid is true
+      bool stop;
+      boost::mutex mutex;
+    }; // struct Batch
+
+    bool ContinuousValidation::validatePaths
+    (const std::vector <PathPtr_t>& paths, bool reverse,
+     std::vector <PathPtr_t>& validParts,
+     std::vector <PathValidationReportPtr_t>& reports,
+     std::vector <bool>& valid, bool stopAtFirstInvalid)
+    {
+      validParts.assign (paths.size (), PathPtr_t ());
+      reports.assign (paths.size (), PathValidationReportPtr_t ());
+      valid.assign (paths.size (), false);
+      Batch batch (paths, reverse, validParts, reports, stopAtFirstInvalid);
+      const std::size_t nThreads (std::min ((std::size_t) numberThreads_,
+                                            paths.size ()));
+      if (nThreads <= 1 || splitIntervalValidations_) {
+        validateRange (batch, valid, 0, 1);
+      } else {
+        // std::vector <bool> packs its elements: threads write to a vector
+        // of their own.
+        std::vector <std::vector <bool> > threadValid
+          (nThreads, std::vector <bool> (paths.size (), false));
+        boost::thread_group threads;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          threads.create_thread
+            (boost::bind (&ContinuousValidation::validateRange, this,
+                          boost::ref (batch), boost::ref (threadValid [t]),
+                          t, nThreads));
+        }
+        threads.join_all ();
+        for (std::size_t i = 0; i < paths.size (); ++i)
+          valid [i] = threadValid [i % nThreads] [i];
+      }
+      return std::find (valid.begin (), valid.end (), false) == valid.end ();
+    }
+
+    void ContinuousValidation::validateRange
+    (Batch& batch, std::vector <bool>& valid, std::size_t begin,
+     std::size_t step)
+    {
+      // Paths are validated by several threads, unless step is one.
+      WorkerScope scope (step > 1);
+      for (std::size_t i = begin; i < batch.paths.size (); i += step) {
+        if (batch.stopAtFirstInvalid) {
+          boost::mutex::scoped_lock lock (batch.mutex);
+          if (batch.stop) return;
+        }
+        PathPtr_t validPart;
+        PathValidationReportPtr_t report;
+        valid [i] = validate (batch.paths [i], batch.reverse, validPart,
+                              report);
+        // Threads write to distinct elements.
+        batch.validParts [i] = validPart;
+        batch.reports [i] = report;
+        if (!valid [i] && batch.stopAtFirstInvalid) {
+          boost::mutex::scoped_lock lock (batch.mutex);
+          batch.stop = true;
+          return;
+        }
+      }
     }
 
     void ContinuousValidation::addObstacle(const CollisionObjectConstPtr_t &object)
@@ -234,10 +484,15 @@ namespace hpp {
 
     void ContinuousValidation::setPath
     (IntervalValidations_t& intervalValidations,
-        const PathPtr_t &path, bool reverse)
+        const PathPtr_t &path, bool reverse, const DevicePtr_t& robot)
     {
+      // The body pairs share the velocity bounds of the path.
+      VelocityBoundsPtr_t bounds (new VelocityBounds (robot));
       for (IntervalValidations_t::iterator itPair(intervalValidations.begin ());
       itPair != intervalValidations.end (); ++itPair) {
+        BodyPairCollisionPtr_t bpc (HPP_DYNAMIC_PTR_CAST (BodyPairCollision,
+                                                          *itPair));
+        if (bpc) bpc->velocityBounds (bounds);
         (*itPair)->path (path, reverse);
       }
     }
@@ -277,6 +532,12 @@ namespace hpp {
       }
     }
 
+    void ContinuousValidation::updateObstacle
+    (const CollisionObjectConstPtr_t&)
+    {
+      bodyPairCollisionPool_.clear();
+    }
+
     void ContinuousValidation::filterCollisionPairs(const RelativeMotion::matrix_type &relMotion)
     {
       // Loop over collision pairs and remove disabled ones.
@@ -396,7 +657,7 @@ namespace hpp {
 
     ContinuousValidation::ContinuousValidation(const DevicePtr_t &robot, const value_type &tolerance):
       robot_(robot), tolerance_(tolerance), intervalValidations_(),
-      weak_()
+      weak_(), numberThreads_ (1), splitIntervalValidations_ (false)
     {
       if (tolerance < 0) {
         throw std::runtime_error ("tolerance should be non-negative.");
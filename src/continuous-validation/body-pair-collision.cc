@@ -19,6 +19,8 @@
 
 #include <hpp/core/continuous-validation/body-pair-collision.hh>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include <hpp/fcl/collision_data.h>
@@ -28,6 +30,7 @@
 
 #include <hpp/core/path.hh>
 #include <hpp/core/straight-path.hh> // To enable dynamic casting (needs inheritance).
+#include <hpp/core/steering-method/constant-curvature.hh>
 
 namespace hpp {
   namespace core {
@@ -37,29 +40,24 @@ namespace hpp {
                 ValidationReportPtr_t& report,
                 const pinocchio::DeviceData& data)
       {
-        namespace icl = boost::icl;
         using std::numeric_limits;
 
-        if (valid_) {
-          interval = path_->timeRange ();
-          assert (interval.second > interval.first);
-          return true;
-        }
-        continuous_interval iclInterval (interval.first, interval.second,
-          icl::interval_bounds::closed());
-        if (icl::contains (validInterval_, iclInterval))
-        {
-          // TODO interval could probably be enlarge using validInterval_
-          // interval = validInterval_;
-          assert (interval.second > interval.first);
-          return true;
-        }
+        // Intervals carried over from a previous path may contain t only.
+        if (validated (t, interval)) return true;
+
+        // Distance over which the bodies may move until the end of the
+        // path farthest from t: the collision free interval of a larger
+        // distance lower bound covers the whole path.
+        const interval_t& tr (path_->timeRange ());
+        const value_type span (std::max (t - tr.first, tr.second - t));
+        wholePathDistance_ = span > 0 ? maximalVelocity_ * span : 0;
 
         value_type distanceLowerBound;
         if (!computeDistanceLowerBound(distanceLowerBound, report, data))
         {
           return false;
         }
+        clearance_ = std::min (clearance_, distanceLowerBound);
 
         value_type halfLengthDist, halfLengthTol;
         /// \todo A finer bound could be computed when path is an
@@ -81,12 +79,9 @@ namespace hpp {
         assert (!std::isnan (halfLengthTol));
         interval.first = t - (halfLengthDist + halfLengthTol);
         interval.second = t + (halfLengthDist + halfLengthTol);
-        validInterval_.insert (continuous_interval(interval.first,
-          interval.second, icl::interval_bounds::closed()));
+        validInterval_.unionInterval (interval);
         // Check if the whole path is valid.
-        iclInterval = continuous_interval (path_->timeRange ().first,
-          path_->timeRange ().second, icl::interval_bounds::closed());
-        if (icl::contains (validInterval_, iclInterval))
+        if (validInterval_.contains (path_->timeRange ()))
           valid_ = true;
         assert (interval.second > interval.first || path()->length() == 0);
         return true;
@@ -94,52 +89,160 @@ namespace hpp {
 
       void BodyPairCollision::setupPath()
       {
-        if (HPP_DYNAMIC_PTR_CAST(StraightPath, path_)) refine_ = false;
+        refine_ = !HPP_DYNAMIC_PTR_CAST(StraightPath, path_);
+        angularVelocity_ = 0;
+        steeringMethod::ConstantCurvaturePtr_t arc
+          (HPP_DYNAMIC_PTR_CAST(steeringMethod::ConstantCurvature, path_));
+        if (arc && !path_->timeParameterization ()) {
+          // The velocity is constant along the path: pieces do not give
+          // a better bound.
+          refine_ = false;
+          angularVelocity_ = arc->rigidAngularVelocity ();
+        }
         Vb_ = vector_t (path_->outputDerivativeSize());
         value_type t0 = path_->timeRange ().first;
         value_type t1 = path_->timeRange ().second;
         assert (t1 >= t0);
+        pieceVelocities_.clear ();
+        pieceDistances_.clear ();
+        leaves_ = 0;
         if (t1 - t0 == 0) {
           maximalVelocity_ = std::numeric_limits<value_type>::infinity();
           refine_ = false;
         } else {
-          path_->velocityBound (Vb_, t0, t1);
-          maximalVelocity_ = computeMaximalVelocity (Vb_);
+          if (!velocityBounds_) velocityBounds_.reset (new VelocityBounds);
+          if (velocityBounds_->path () != path_)
+            velocityBounds_->path (path_);
+          maximalVelocity_ = computeMaximalVelocity (*velocityBounds_, 0);
+          if (refine_) setupPieces ();
+        }
+      }
+
+      value_type BodyPairCollision::computeMaximalVelocity
+      (VelocityBounds& bounds, std::size_t i) const
+      {
+        Vb_ = bounds.bound (i);
+        return computeMaximalVelocity (Vb_);
+      }
+
+      void BodyPairCollision::setupPieces ()
+      {
+        velocityBounds_->setupPieces ();
+        const std::vector <value_type>& bounds
+          (velocityBounds_->pieceBounds ());
+        const std::size_t n (velocityBounds_->numberPieces ());
+        leaves_ = 1;
+        while (leaves_ < n) leaves_ *= 2;
+        pieceVelocities_.assign (2 * leaves_, 0);
+        pieceDistances_.resize (n + 1);
+        pieceDistances_ [0] = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+          const value_type V
+            (std::min (maximalVelocity_,
+                       computeMaximalVelocity (*velocityBounds_, i + 1)));
+          pieceVelocities_ [leaves_ + i] = V;
+          pieceDistances_ [i + 1] = pieceDistances_ [i] +
+            V * (bounds [i + 1] - bounds [i]);
+        }
+        for (std::size_t i = leaves_; i-- > 1;)
+          pieceVelocities_ [i] = std::max (pieceVelocities_ [2 * i],
+                                           pieceVelocities_ [2 * i + 1]);
+      }
+
+      value_type BodyPairCollision::maximalVelocity (std::size_t first,
+                                                     std::size_t last) const
+      {
+        value_type V (0);
+        for (std::size_t l = first + leaves_, r = last + leaves_ + 1; l < r;
+             l /= 2, r /= 2) {
+          if (l & 1) V = std::max (V, pieceVelocities_ [l++]);
+          if (r & 1) V = std::max (V, pieceVelocities_ [--r]);
         }
+        return V;
+      }
+
+      std::size_t BodyPairCollision::piece (const value_type& t) const
+      {
+        const std::vector <value_type>& bounds
+          (velocityBounds_->pieceBounds ());
+        const std::size_t n (pieceDistances_.size () - 1);
+        const std::size_t k (std::upper_bound (bounds.begin (), bounds.end (),
+                                               t) - bounds.begin ());
+        return std::min (k > 0 ? k - 1 : 0, n - 1);
+      }
+
+      value_type BodyPairCollision::piecewiseHalfLength
+      (const value_type &t, const value_type &distanceLowerBound,
+       bool forward, value_type &maxVelocity) const
+      {
+        const std::vector <value_type>& bounds
+          (velocityBounds_->pieceBounds ());
+        const std::size_t n (pieceDistances_.size () - 1);
+        const std::size_t k (piece (t));
+        const value_type tk (std::min (std::max (t, bounds [k]),
+                                       bounds [k + 1]));
+        // Distance covered at maximal velocity from the beginning of the
+        // path to t
+        const value_type d (pieceDistances_ [k] +
+                            pieceVelocities_ [leaves_ + k] * (tk - bounds [k]));
+        if (forward) {
+          const value_type target (d + distanceLowerBound);
+          if (target > pieceDistances_ [n]) {
+            // The distance bound is not reached before the end of the path.
+            maxVelocity = std::max (maxVelocity, maximalVelocity (k, n - 1));
+            return std::numeric_limits <value_type>::infinity ();
+          }
+          // First piece at the end of which the target is reached
+          const std::size_t j
+            (std::lower_bound (pieceDistances_.begin () + k + 1,
+                               pieceDistances_.end (), target) -
+             pieceDistances_.begin () - 1);
+          maxVelocity = std::max (maxVelocity, maximalVelocity (k, j));
+          const value_type V (pieceVelocities_ [leaves_ + j]);
+          return bounds [j] + (target - pieceDistances_ [j]) / V - t;
+        }
+        const value_type target (d - distanceLowerBound);
+        if (target < 0) {
+          maxVelocity = std::max (maxVelocity, maximalVelocity (0, k));
+          return std::numeric_limits <value_type>::infinity ();
+        }
+        // Last piece at the beginning of which the target is passed
+        const std::size_t j
+          (std::upper_bound (pieceDistances_.begin (),
+                             pieceDistances_.begin () + k + 1, target) -
+           pieceDistances_.begin () - 1);
+        maxVelocity = std::max (maxVelocity, maximalVelocity (j, k));
+        const value_type V (pieceVelocities_ [leaves_ + j]);
+        return t - (bounds [j] + (target - pieceDistances_ [j]) / V);
       }
 
       value_type BodyPairCollision::collisionFreeInterval(const value_type &t,
                                       const value_type &distanceLowerBound,
                                       value_type &maxVelocity) const
       {
-        value_type T[3], Vm[2];
-        value_type tm, tM;
         maxVelocity = maximalVelocity_;
-        T[0] = distanceLowerBound / maxVelocity;
-        if (!refine_)
-          return T[0];
-        else
-        {
-          tm = t - T[0];
-          tM = t + T[0];
-          bool  leftIsValid = (tm < path_->timeRange().first );
-          bool rightIsValid = (tM > path_->timeRange().second);
-          if (leftIsValid && rightIsValid)
-            return T[0];
-
-          for (int i = 0; i < 2; ++i)
-          {
-            tm = t - (leftIsValid ? 0 : T[i]);
-            tM = t + (rightIsValid ? 0 : T[i]);
-            path_->velocityBound(Vb_, tm, tM);
-            Vm[i] = computeMaximalVelocity(Vb_);
-            T[i + 1] = distanceLowerBound / Vm[i];
-          }
-          assert(maximalVelocity_ >= Vm[1] && Vm[1] >= Vm[0] && T[1] >= T[2] && T[2] >= T[0]);
-          // hppDout (info, "Refine changed the interval length of " << T[0] / T[2] << ", from " << T[0] << " to " << T[2]);
-          maxVelocity = Vm[1];
-          return T[2];
+        const value_type T (distanceLowerBound / maxVelocity);
+        if (angularVelocity_ > 0) {
+          // Largest T such that 2 R sin (omega T / 2) <= distanceLowerBound
+          const value_type x (distanceLowerBound * angularVelocity_ /
+                              (2 * maxVelocity));
+          if (x >= 1) return std::numeric_limits <value_type>::infinity ();
+          return std::max (T, 2 * std::asin (x) / angularVelocity_);
         }
+        if (!refine_ || pieceDistances_.empty ())
+          return T;
+        // Bound with the maximal velocity on the pieces of the path. The
+        // bound with the maximal velocity on the pieces the interval
+        // covers is always shorter.
+        value_type Vp (0);
+        const value_type Tp
+          (std::min (piecewiseHalfLength (t, distanceLowerBound, true, Vp),
+                     piecewiseHalfLength (t, distanceLowerBound, false, Vp)));
+        if (Tp > T) {
+          maxVelocity = Vp;
+          return Tp;
+        }
+        return T;
       }
 
       bool BodyPairCollision::computeDistanceLowerBound(value_type &distanceLowerBound,
@@ -150,15 +253,48 @@ namespace hpp {
         distanceLowerBound = numeric_limits <value_type>::infinity ();
         assert (collisionRequest_.enable_distance_lower_bound == true);
         const CollisionPairs_t& prs (pairs());
-        for (CollisionPairs_t::const_iterator _pair = prs.begin();
-            _pair != prs.end(); ++_pair) {
-          pinocchio::FclConstCollisionObjectPtr_t object_a = _pair->first ->fcl (data);
-          pinocchio::FclConstCollisionObjectPtr_t object_b = _pair->second->fcl (data);
+        // Pairs may have been added since the last call.
+        if (gjkGuesses_.size () != prs.size ())
+          gjkGuesses_.resize (prs.size (), fcl::Vec3f (1, 0, 0));
+        // Broad phase: the distance between the bounding spheres of the
+        // objects of a pair is a lower bound of their distance. Pairs are
+        // checked by increasing sphere distance, and the remaining pairs
+        // are skipped as soon as their sphere distance is above the
+        // current lower bound, since they cannot lower it.
+        sphereDistances_.clear ();
+        for (std::size_t i = 0; i < prs.size (); ++i) {
+          pinocchio::FclConstCollisionObjectPtr_t object_a = prs [i].first ->fcl (data);
+          pinocchio::FclConstCollisionObjectPtr_t object_b = prs [i].second->fcl (data);
+          const fcl::CollisionGeometry& ga (*object_a->collisionGeometry ());
+          const fcl::CollisionGeometry& gb (*object_b->collisionGeometry ());
+          const value_type d
+            ((object_a->getTransform ().transform (ga.aabb_center) -
+              object_b->getTransform ().transform (gb.aabb_center)).norm ()
+             - ga.aabb_radius - gb.aabb_radius
+             - collisionRequest_.security_margin);
+          sphereDistances_.push_back (std::make_pair (d, i));
+        }
+        std::sort (sphereDistances_.begin (), sphereDistances_.end ());
+        // Pairs whose bounding spheres remain separated along the whole
+        // path are certified without distance query.
+        if (!sphereDistances_.empty () &&
+            sphereDistances_.front ().first >
+            std::min (coarseThreshold_, wholePathDistance_)) {
+          distanceLowerBound = sphereDistances_.front ().first;
+          return true;
+        }
+        for (std::size_t k = 0; k < sphereDistances_.size (); ++k) {
+          if (sphereDistances_ [k].first >= distanceLowerBound) break;
+          const std::size_t i (sphereDistances_ [k].second);
+          pinocchio::FclConstCollisionObjectPtr_t object_a = prs [i].first ->fcl (data);
+          pinocchio::FclConstCollisionObjectPtr_t object_b = prs [i].second->fcl (data);
           fcl::CollisionResult result;
+          collisionRequest_.cached_gjk_guess = gjkGuesses_ [i];
           fcl::collide (object_a, object_b, collisionRequest_, result);
+          gjkGuesses_ [i] = result.cached_gjk_guess;
           // Get result
           if (result.isCollision ()) {
-            setReport(report, result, *_pair);
+            setReport(report, result, prs [i]);
             return false;
           }
           if (result.distance_lower_bound < distanceLowerBound) {
@@ -18,14 +18,21 @@
 
 #include <hpp/core/continuous-validation/dichotomy.hh>
 
+#include <algorithm>
 #include <iterator>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <hpp/util/debug.hh>
 #include <hpp/core/collision-path-validation-report.hh>
+#include <hpp/core/deadline.hh>
 #include <hpp/core/straight-path.hh>
 #include <hpp/core/path-vector.hh>
+#include <hpp/core/continuous-validation/intervals.hh>
 
-#include "continuous-validation/intervals.hh"
 #include "continuous-validation/helper.hh"
 
 namespace hpp {
@@ -53,44 +60,116 @@ namespace hpp {
         else         return validateStraightPath<false>(bpc, path, validPart, report);
       }
 
+      /// Parameters of a level of the frontier and their validation
+      struct Dichotomy::Level
+      {
+        /// Parameters in the order of the validation
+        std::vector <value_type> parameters;
+        matrix_t configurations;
+        /// Valid intervals around the parameters before failure
+        std::vector <interval_t> intervals;
+        /// Index of the first invalid parameter, or number of parameters
+        std::size_t failure;
+        PathValidationReportPtr_t report;
+        boost::mutex mutex;
+      }; // struct Level
+
+      namespace {
+        /// Middles of the parts of a range not covered by valid intervals,
+        /// in the order of the validation
+        void middles (const Intervals& valid, const interval_t& range,
+                      bool reverse, std::vector <value_type>& result)
+        {
+          result.clear ();
+          value_type lower (range.first);
+          for (Intervals::Intervals_t::const_iterator it
+                 (valid.list ().begin ()); it != valid.list ().end ();
+               ++it) {
+            const value_type upper (std::min (it->first, range.second));
+            if (upper > lower) result.push_back (.5 * (lower + upper));
+            lower = std::max (lower, it->second);
+            if (lower >= range.second) break;
+          }
+          if (lower < range.second)
+            result.push_back (.5 * (lower + range.second));
+          if (reverse) std::reverse (result.begin (), result.end ());
+        }
+
+        /// Whether parameter a is validated before parameter b
+        inline bool before (const value_type& a, const value_type& b,
+                            bool reverse)
+        {
+          return reverse ? a > b : a < b;
+        }
+      } // namespace
+
       template <bool reverse>
       bool Dichotomy::validateStraightPath
       (IntervalValidations_t& bodyPairCollisions, const PathPtr_t& path, PathPtr_t& validPart,
        PathValidationReportPtr_t& report)
       {
-        // start by validating end of path
-        bool finished = false;
         bool valid = true;
-        setPath(bodyPairCollisions, path, reverse);
+        setPath(bodyPairCollisions, path, reverse, robot_);
+        std::vector <IntervalValidations_t*> copies;
         Intervals validSubset;
         const interval_t& tr (path->timeRange());
-        value_type t = first(tr, reverse);
-        validSubset.unionInterval (std::make_pair (t,t));
-        Configuration_t q (path->outputSize ());
-        value_type t0, t1, tmin, tmax;
-        while (!finished) {
-          bool success = (*path) (q, t);
-          PathValidationReportPtr_t pathReport;
-          interval_t interval;
-          if (!success) {
-            report = PathValidationReportPtr_t (new PathValidationReport (t,
-                  ValidationReportPtr_t(new ProjectionError())));
+        validSubset.unionInterval (std::make_pair (first (tr, reverse),
+                                                   first (tr, reverse)));
+        value_type tmin, tmax;
+        // Breadth first: the middles of all the intervals not validated yet
+        // are validated together, starting with the beginning of the path.
+        Level level;
+        level.parameters.assign (1, first (tr, reverse));
+        value_type bound (second (tr, reverse));
+        while (true) {
+          if (expired ()) {
+            report = PathValidationReportPtr_t (new PathValidationReport
+                (second (begin (validSubset.list (), reverse), reverse),
+                 ValidationReportPtr_t(new DeadlineExpired ())));
             valid = false;
-          } else if (!validateConfiguration (bodyPairCollisions, q, t, interval, pathReport)) {
-            report = pathReport;
+            break;
+          }
+          validateLevel (bodyPairCollisions, copies, path, reverse, level);
+          for (std::size_t i = 0; i < level.failure; ++i)
+            validSubset.unionInterval (level.intervals [i]);
+          if (level.failure < level.parameters.size ()) {
+            bound = level.parameters [level.failure];
+            report = level.report;
             valid = false;
-          } else {
-            validSubset.unionInterval (interval);
+            break;
           }
-          finished = (!valid || validSubset.contains (tr));
-          // Compute next parameter to check as middle of first non tested
-          // interval
-          t0 = second (begin(validSubset.list(), reverse), reverse);
-          t1 = second (tr                                , reverse);
-          if (validSubset.list().size() > 1)
-            t1 = first (Nth(validSubset.list(), 1, reverse), reverse);
-          t = .5* (t0 + t1);
+          if (validSubset.contains (tr)) break;
+          middles (validSubset, tr, reverse, level.parameters);
         }
+        // The valid part ends at the first interval not validated: it is
+        // extended by dichotomy between its end and the first invalid
+        // parameter found, as long as no other invalid parameter is found.
+        if (!valid && level.failure < level.parameters.size ()) {
+          while (before (second (begin (validSubset.list (), reverse),
+                                 reverse), bound, reverse)) {
+            if (expired ()) {
+              report = PathValidationReportPtr_t (new PathValidationReport
+                  (second (begin (validSubset.list (), reverse), reverse),
+                   ValidationReportPtr_t(new DeadlineExpired ())));
+              break;
+            }
+            value_type t0 = second (begin(validSubset.list(), reverse), reverse);
+            value_type t1 = bound;
+            if (validSubset.list().size() > 1 &&
+                before (first (Nth(validSubset.list(), 1, reverse), reverse),
+                        bound, reverse))
+              t1 = first (Nth(validSubset.list(), 1, reverse), reverse);
+            level.parameters.assign (1, .5 * (t0 + t1));
+            validateLevel (bodyPairCollisions, copies, path, reverse, level);
+            if (level.failure == 0) {
+              report = level.report;
+              break;
+            }
+            validSubset.unionInterval (level.intervals [0]);
+          }
+        }
+        for (std::size_t i = 0; i < copies.size (); ++i)
+          bodyPairCollisionPool_.release (copies [i]);
         if (!valid) {
           assert ( begin(validSubset.list (), reverse).first <=
                    first(tr                 , reverse));
@@ -112,6 +191,77 @@ namespace hpp {
         return false;
       }
 
+      void Dichotomy::validateLevel
+      (IntervalValidations_t& bodyPairCollisions,
+       std::vector <IntervalValidations_t*>& copies, const PathPtr_t& path,
+       bool reverse, Level& level)
+      {
+        const size_type n ((size_type) level.parameters.size ());
+        level.configurations.resize (path->outputSize (), n);
+        level.intervals.resize (level.parameters.size ());
+        level.report.reset ();
+        // Paths may project configurations, which is not thread safe:
+        // configurations are computed here, up to the first projection
+        // failure.
+        const size_type computed = path->eval
+          (Eigen::Map <const vector_t> (&level.parameters [0], n),
+           level.configurations);
+        level.failure = (std::size_t) computed;
+        if (computed < n) {
+          level.report = PathValidationReportPtr_t
+            (new PathValidationReport (level.parameters [computed],
+                                       ValidationReportPtr_t
+                                       (new ProjectionError ())));
+        }
+        const std::size_t nThreads
+          (std::min ((std::size_t) straightPathThreads (), level.failure));
+        if (nThreads <= 1) {
+          validateParameters (bodyPairCollisions, level, 0, 1);
+          return;
+        }
+        // Each thread uses its own copy of the interval validations.
+        while (copies.size () + 1 < nThreads) {
+          copies.push_back (acquireIntervalValidations ());
+          setPath (*copies.back (), path, reverse, robot_);
+        }
+        boost::thread_group threads;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          threads.create_thread
+            (boost::bind (&Dichotomy::validateParameters, this,
+                          boost::ref (t == 0 ? bodyPairCollisions :
+                                      *copies [t - 1]),
+                          boost::ref (level), t, nThreads));
+        }
+        threads.join_all ();
+      }
+
+      void Dichotomy::validateParameters
+      (IntervalValidations_t& bodyPairCollisions, Level& level,
+       std::size_t begin, std::size_t step)
+      {
+        Configuration_t q (level.configurations.rows ());
+        for (std::size_t i = begin; ; i += step) {
+          {
+            // Parameters after a failure found by another thread are
+            // useless.
+            boost::mutex::scoped_lock lock (level.mutex);
+            if (i >= level.failure) return;
+          }
+          q = level.configurations.col ((size_type) i);
+          PathValidationReportPtr_t report;
+          if (validateConfiguration (bodyPairCollisions, q,
+                                     level.parameters [i],
+                                     level.intervals [i], report))
+            continue;
+          boost::mutex::scoped_lock lock (level.mutex);
+          if (i < level.failure) {
+            level.failure = i;
+            level.report = report;
+          }
+          return;
+        }
+      }
+
       void Dichotomy::init(const DichotomyWkPtr_t weak)
       {
         ContinuousValidation::init (weak);
@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/continuous-validation/distance-field-collision.hh>
+
+#include <limits>
+#include <sstream>
+
+#include <hpp/pinocchio/body.hh>
+#include <hpp/pinocchio/collision-object.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/core/collision-validation-report.hh>
+#include <hpp/core/distance-field.hh>
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      DistanceFieldCollisionPtr_t DistanceFieldCollision::create
+      (const JointPtr_t& joint, const DistanceFieldPtr_t& field,
+       value_type tolerance)
+      {
+        DistanceFieldCollision* ptr
+          (new DistanceFieldCollision (joint, field, tolerance));
+        DistanceFieldCollisionPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      DistanceFieldCollisionPtr_t DistanceFieldCollision::createCopy
+      (const DistanceFieldCollisionPtr_t& other)
+      {
+        DistanceFieldCollision* ptr = new DistanceFieldCollision (*other);
+        DistanceFieldCollisionPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      IntervalValidationPtr_t DistanceFieldCollision::copy () const
+      {
+        return createCopy (weak_.lock ());
+      }
+
+      std::string DistanceFieldCollision::name () const
+      {
+        std::ostringstream oss;
+        oss << "(" << joint_a ()->name () << ",distance field)";
+        return oss.str ();
+      }
+
+      std::ostream& DistanceFieldCollision::print (std::ostream& os) const
+      {
+        return os << "DistanceFieldCollision: " << joint_a ()->name ()
+                  << " - distance field\n";
+      }
+
+      bool DistanceFieldCollision::computeDistanceLowerBound
+      (value_type &distanceLowerBound, ValidationReportPtr_t& report,
+       const pinocchio::DeviceData& data)
+      {
+        distanceLowerBound = std::numeric_limits <value_type>::infinity ();
+        for (ConstObjectStdVector_t::const_iterator it = objects_.begin ();
+             it != objects_.end (); ++it) {
+          const value_type d (field_->distanceLowerBound (*it, data) -
+                              securityMargin ());
+          if (d <= 0) {
+            CollisionValidationReportPtr_t collisionReport
+              (new CollisionValidationReport
+               (*it, CollisionObjectConstPtr_t (), fcl::CollisionResult ()));
+            collisionReport->objectName2 = "distance field";
+            report = collisionReport;
+            return false;
+          }
+          distanceLowerBound = std::min (distanceLowerBound, d);
+        }
+        return true;
+      }
+
+      DistanceFieldCollision::DistanceFieldCollision
+      (const JointPtr_t& joint, const DistanceFieldPtr_t& field,
+       value_type tolerance) :
+        SolidSolidCollision (joint, ConstObjectStdVector_t (), tolerance),
+        field_ (field)
+      {
+        BodyPtr_t body (joint->linkedBody ());
+        assert (body);
+        for (size_type i = 0; i < body->nbInnerObjects (); ++i)
+          objects_.push_back (body->innerObjectAt (i));
+      }
+
+      void DistanceFieldCollision::init
+      (const DistanceFieldCollisionWkPtr_t& weak)
+      {
+        SolidSolidCollision::init (weak.lock ());
+        weak_ = weak;
+      }
+    } // namespace continuousValidation
+  } // namespace core
+} // namespace hpp
@@ -18,6 +18,7 @@
 
 #include <iterator>
 #include <hpp/core/fwd.hh>
+#include <hpp/core/continuous-validation/intervals.hh>
 
 namespace hpp {
   namespace core {
@@ -31,25 +32,20 @@ namespace hpp {
         return first(I, !reverse);
       }
 
-      inline const interval_t& begin (const std::list<interval_t>& I, bool reverse)
+      inline const interval_t& begin (const Intervals::Intervals_t& I,
+                                      bool reverse)
       {
         return reverse ? I.back() : I.front();
       }
-      inline const interval_t& end   (const std::list<interval_t>& I, bool reverse)
+      inline const interval_t& end   (const Intervals::Intervals_t& I,
+                                      bool reverse)
       {
         return begin(I, !reverse);
       }
-      inline const interval_t& Nth (const std::list<interval_t>& I, int N, bool reverse)
+      inline const interval_t& Nth (const Intervals::Intervals_t& I, int N,
+                                    bool reverse)
       {
-        if (reverse) {
-          std::list<interval_t>::const_reverse_iterator it (I.rbegin());
-          std::advance(it, N);
-          return *it;
-        } else {
-          std::list<interval_t>::const_iterator         it (I. begin());
-          std::advance(it, N);
-          return *it;
-        }
+        return reverse ? I [I.size () - 1 - N] : I [N];
       }
     } // namespace continuousValidation
   } // namespace core
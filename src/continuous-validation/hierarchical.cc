@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/continuous-validation/hierarchical.hh>
+
+#include <hpp/core/continuous-validation/body-pair-collision.hh>
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      HierarchicalPtr_t Hierarchical::create (const DevicePtr_t& robot,
+                                              const value_type& tolerance)
+      {
+        Hierarchical* ptr = new Hierarchical (robot, tolerance);
+        HierarchicalPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        ptr->initialize ();
+        return shPtr;
+      }
+
+      bool Hierarchical::validateStraightPath
+      (IntervalValidations_t& bodyPairCollisions, const PathPtr_t& path,
+       bool reverse, PathPtr_t& validPart, PathValidationReportPtr_t& report)
+      {
+        // Body pairs may have been copied or added since the last path.
+        for (IntervalValidations_t::iterator it (bodyPairCollisions.begin ());
+             it != bodyPairCollisions.end (); ++it) {
+          BodyPairCollisionPtr_t bpc (HPP_DYNAMIC_PTR_CAST (BodyPairCollision,
+                                                            *it));
+          if (bpc) bpc->coarseThreshold (coarseThreshold_);
+        }
+        return Progressive::validateStraightPath (bodyPairCollisions, path,
+                                                  reverse, validPart, report);
+      }
+
+      Hierarchical::~Hierarchical ()
+      {
+      }
+
+      void Hierarchical::init (const HierarchicalWkPtr_t weak)
+      {
+        Progressive::init (weak);
+        weak_ = weak;
+      }
+
+      Hierarchical::Hierarchical (const DevicePtr_t& robot,
+                                  const value_type& tolerance) :
+        Progressive (robot, tolerance), weak_ (), coarseThreshold_ (tolerance)
+      {
+      }
+    } // namespace continuousValidation
+  } // namespace core
+} // namespace hpp
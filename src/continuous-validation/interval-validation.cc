@@ -0,0 +1,146 @@
+// Copyright (c) 2014,2015,2016,2018 CNRS
+// Authors: Florent Lamiraux, Joseph Mirabel, Diane Bury
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/continuous-validation/interval-validation.hh>
+
+#include <algorithm>
+#include <typeinfo>
+
+#include <hpp/core/straight-path.hh>
+
+#include "extracted-path.hh"
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      namespace {
+        /// Part of a root path followed by a path
+        ///
+        /// Parameter s of the path is parameter s of the root, or
+        /// range.first + range.second - s if the path runs backward.
+        struct Window
+        {
+          PathPtr_t root;
+          bool reversed;
+          interval_t range;
+
+          explicit Window (const PathPtr_t& path) :
+            root (path), reversed (false), range (path->paramRange ())
+          {
+            ExtractedPathPtr_t extracted
+              (HPP_DYNAMIC_PTR_CAST (ExtractedPath, path));
+            // Constraints added to a window change its geometry.
+            if (extracted && extracted->constraints () ==
+                extracted->original ()->constraints ()) {
+              root = extracted->original ();
+              reversed = extracted->reversed ();
+            }
+          }
+
+          /// Parameter in the root path of a parameter of the path, and
+          /// conversely
+          value_type map (const value_type& s) const
+          {
+            return reversed ? range.first + range.second - s : s;
+          }
+        }; // struct Window
+
+        /// Whether two paths are the same geometric path
+        bool sameGeometry (const PathPtr_t& a, const PathPtr_t& b)
+        {
+          if (a == b) return true;
+          const Path& pa (*a);
+          const Path& pb (*b);
+          if (!HPP_DYNAMIC_PTR_CAST (StraightPath, a) ||
+              typeid (pa) != typeid (pb))
+            return false;
+          if (a->constraints () != b->constraints () ||
+              a->paramRange () != b->paramRange () ||
+              a->outputSize () != b->outputSize ())
+            return false;
+          return a->initial () == b->initial () && a->end () == b->end ();
+        }
+
+        /// Add the intervals of a previous path to the parts of a path that
+        /// follow the same geometric path
+        /// \return whether an interval was added.
+        bool carry (const PathPtr_t& previous, const Intervals& intervals,
+                    const PathPtr_t& path, Intervals& result)
+        {
+          // The parameter of the path is not the parameter of the window.
+          if (previous->timeParameterization () ||
+              path->timeParameterization ())
+            return false;
+          const Window from (previous), to (path);
+          if (!sameGeometry (from.root, to.root)) return false;
+          bool carried (false);
+          for (Intervals::Intervals_t::const_iterator it
+                 (intervals.list ().begin ()); it != intervals.list ().end ();
+               ++it) {
+            // Intervals may exceed the previous path, over which only the
+            // velocity was bounded.
+            value_type a (from.map (std::max (it->first, from.range.first))),
+              b (from.map (std::min (it->second, from.range.second)));
+            if (a > b) std::swap (a, b);
+            a = std::max (a, to.range.first);
+            b = std::min (b, to.range.second);
+            if (a >= b) continue;
+            a = to.map (a);
+            b = to.map (b);
+            if (a > b) std::swap (a, b);
+            result.unionInterval (interval_t (a, b));
+            carried = true;
+          }
+          return carried;
+        }
+      } // namespace
+
+      void IntervalValidation::path (const PathPtr_t& path, bool reverse)
+      {
+        reverse_ = reverse;
+        if (path == path_ && path) {
+          setupPath ();
+          return;
+        }
+        if (path_) {
+          Certificate certificate;
+          certificate.path = path_;
+          certificate.clearance = clearance_;
+          if (valid_)
+            certificate.intervals.unionInterval (path_->timeRange ());
+          else
+            certificate.intervals = validInterval_;
+          if (!certificate.intervals.list ().empty ()) {
+            certificates_.push_front (certificate);
+            if (certificates_.size () > numberCertificates)
+              certificates_.pop_back ();
+          }
+        }
+        path_ = path;
+        validInterval_.clear ();
+        clearance_ = std::numeric_limits <value_type>::infinity ();
+        for (std::deque <Certificate>::const_iterator it
+               (certificates_.begin ()); it != certificates_.end (); ++it) {
+          if (carry (it->path, it->intervals, path_, validInterval_))
+            clearance_ = std::min (clearance_, it->clearance);
+        }
+        valid_ = validInterval_.contains (path_->timeRange ());
+        setupPath();
+      }
+    } // namespace continuousValidation
+  } // namespace core
+} // namespace hpp
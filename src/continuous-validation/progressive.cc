@@ -21,10 +21,11 @@
 #include <limits>
 #include <hpp/util/debug.hh>
 #include <hpp/core/collision-path-validation-report.hh>
+#include <hpp/core/deadline.hh>
 #include <hpp/core/straight-path.hh>
 #include <hpp/core/path-vector.hh>
+#include <hpp/core/continuous-validation/intervals.hh>
 
-#include "continuous-validation/intervals.hh"
 #include "continuous-validation/helper.hh"
 
 namespace hpp {
@@ -77,7 +78,7 @@ namespace hpp {
         PathValidationReportPtr_t pathReport;
         interval_t interval;
 
-        setPath(bodyPairCollisions, path, reverse);
+        setPath(bodyPairCollisions, path, reverse, robot_);
 
         const value_type tmin = tr.first;
         const value_type tmax = tr.second;
@@ -88,6 +89,12 @@ namespace hpp {
         // validate.
         if (reverse ? t <= tmin : t >= tmax) finished++;
         while (finished < 2 && valid) {
+          if (expired ()) {
+            report = PathValidationReportPtr_t (new PathValidationReport (t,
+                  ValidationReportPtr_t(new DeadlineExpired ())));
+            valid = false;
+            break;
+          }
           bool success = (*path) (q, t);
           value_type tprev = t;
           if (!success) {
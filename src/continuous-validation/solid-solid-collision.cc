@@ -81,6 +81,18 @@ namespace hpp {
         return maximalVelocity;
       }
 
+      value_type SolidSolidCollision::computeMaximalVelocity
+      (VelocityBounds& bounds, std::size_t i) const
+      {
+        value_type maximalVelocity = 0;
+        for (CoefficientVelocities_t::const_iterator itCoef =
+        m_->coefficients.begin (); itCoef != m_->coefficients.end (); ++itCoef) {
+          maximalVelocity += itCoef->value_ *
+            bounds.jointNorm (itCoef->joint_, i);
+        }
+        return maximalVelocity;
+      }
+
       bool SolidSolidCollision::removeObjectTo_b (const CollisionObjectConstPtr_t& object)
       {
         CollisionPairs_t& prs (pairs());
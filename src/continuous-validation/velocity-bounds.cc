@@ -0,0 +1,123 @@
+// Copyright (c) 2014,2015,2016,2018 CNRS
+// Authors: Florent Lamiraux, Joseph Mirabel, Diane Bury
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/continuous-validation/velocity-bounds.hh>
+
+#include <pinocchio/multibody/model.hpp>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/core/interpolated-path.hh>
+#include <hpp/core/path.hh>
+
+namespace hpp {
+  namespace core {
+    namespace continuousValidation {
+      namespace {
+        /// Number of pieces of paths that are not interpolated
+        const std::size_t numberUniformPieces = 32;
+      } // namespace
+
+      void VelocityBounds::path (const PathPtr_t& path)
+      {
+        path_ = path;
+        pieces_ = false;
+        pieceBounds_.clear ();
+        const interval_t& tr (path->timeRange ());
+        bounds_.resize (path->outputDerivativeSize (), 1);
+        if (tr.second > tr.first) {
+          vector_t Vb (path->outputDerivativeSize ());
+          path->velocityBound (Vb, tr.first, tr.second);
+          bounds_.col (0) = Vb;
+        } else {
+          bounds_.setZero ();
+        }
+        jointNorms_.setConstant (jointNorms_.rows (), 1, -1);
+        if (robot_) computeJointNorms (0);
+      }
+
+      void VelocityBounds::computeJointNorms (size_type first)
+      {
+        const pinocchio::Model& model (robot_->model ());
+        const size_type n (bounds_.cols ());
+        jointNorms_.conservativeResize (model.njoints, n);
+        for (size_type j = 0; j < model.njoints; ++j) {
+          const int iv (model.joints [j].idx_v ()), nv (model.joints [j].nv ());
+          for (size_type i = first; i < n; ++i)
+            jointNorms_ (j, i) = nv > 0 ?
+              bounds_.col (i).segment (iv, nv).norm () : 0;
+        }
+      }
+
+      void VelocityBounds::setupPieces ()
+      {
+        if (pieces_) return;
+        pieces_ = true;
+        const interval_t& tr (path_->timeRange ());
+        InterpolatedPathPtr_t ip (HPP_DYNAMIC_PTR_CAST (InterpolatedPath,
+                                                        path_));
+        if (ip && !path_->timeParameterization () &&
+            ip->interpolationPoints ().size () >= 2) {
+          // Interpolation points are given in the time range of the path.
+          const InterpolatedPath::InterpolationPoints_t& points
+            (ip->interpolationPoints ());
+          for (InterpolatedPath::InterpolationPoints_t::const_iterator it
+                 (points.begin ()); it != points.end (); ++it) {
+            pieceBounds_.push_back (it->first);
+          }
+        } else {
+          for (std::size_t i = 0; i <= numberUniformPieces; ++i) {
+            pieceBounds_.push_back
+              (tr.first + (tr.second - tr.first) * (value_type) i /
+               (value_type) numberUniformPieces);
+          }
+        }
+        pieceBounds_.front () = tr.first;
+        pieceBounds_.back () = tr.second;
+        const size_type n ((size_type) pieceBounds_.size () - 1);
+        bounds_.conservativeResize (bounds_.rows (), n + 1);
+        vector_t Vb (bounds_.rows ());
+        for (size_type i = 0; i < n; ++i) {
+          path_->velocityBound (Vb, pieceBounds_ [i], pieceBounds_ [i+1]);
+          // The bound of the whole path may be tighter.
+          bounds_.col (i + 1) = Vb.cwiseMin (bounds_.col (0));
+        }
+        const size_type rows (jointNorms_.rows ());
+        jointNorms_.conservativeResize (rows, n + 1);
+        jointNorms_.rightCols (n).setConstant (-1);
+        if (robot_) computeJointNorms (1);
+      }
+
+      value_type VelocityBounds::computeJointNorm (const JointPtr_t& joint,
+                                                   std::size_t i)
+      {
+        const size_type index ((size_type) joint->index ());
+        if (jointNorms_.rows () <= index) {
+          const size_type rows (jointNorms_.rows ());
+          jointNorms_.conservativeResize (index + 1, bounds_.cols ());
+          jointNorms_.bottomRows (index + 1 - rows).setConstant (-1);
+        }
+        value_type& norm (jointNorms_ (index, (size_type) i));
+        if (norm < 0)
+          norm = bounds_.col ((size_type) i).segment
+            (joint->rankInVelocity (), joint->numberDof ()).norm ();
+        return norm;
+      }
+    } // namespace continuousValidation
+  } // namespace core
+} // namespace hpp
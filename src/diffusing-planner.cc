@@ -18,6 +18,10 @@
 
 #include <hpp/core/diffusing-planner.hh>
 
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/next_prior.hpp>
 
@@ -27,11 +31,14 @@
 #include <hpp/pinocchio/device.hh>
 
 #include <hpp/core/config-projector.hh>
+#include <hpp/core/nearest-neighbor.hh>
 #include <hpp/core/node.hh>
 #include <hpp/core/edge.hh>
+#include <hpp/core/executor.hh>
 #include <hpp/core/path.hh>
 #include <hpp/core/path-projector.hh>
 #include <hpp/core/path-validation.hh>
+#include <hpp/core/planner-statistics.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/roadmap.hh>
 #include <hpp/core/steering-method.hh>
@@ -65,7 +72,10 @@ namespace hpp {
     DiffusingPlanner::DiffusingPlanner (const Problem& problem):
       PathPlanner (problem),
       configurationShooter_ (problem.configurationShooter()),
-      qProj_ (problem.robot ()->configSize ())
+      qProj_ (problem.robot ()->configSize ()), batchSize_ (1),
+      numberThreads_ (1),
+      extensionStepLength_ (problem, "DiffusingPlanner/extensionStepLength"),
+      extensionStepRatio_ (problem, "DiffusingPlanner/extensionStepRatio")
     {
     }
 
@@ -73,7 +83,10 @@ namespace hpp {
 					const RoadmapPtr_t& roadmap) :
       PathPlanner (problem, roadmap),
       configurationShooter_ (problem.configurationShooter()),
-      qProj_ (problem.robot ()->configSize ())
+      qProj_ (problem.robot ()->configSize ()), batchSize_ (1),
+      numberThreads_ (1),
+      extensionStepLength_ (problem, "DiffusingPlanner/extensionStepLength"),
+      extensionStepRatio_ (problem, "DiffusingPlanner/extensionStepRatio")
     {
     }
 
@@ -83,6 +96,40 @@ namespace hpp {
       weakPtr_ = weak;
     }
 
+    void DiffusingPlanner::startSolve ()
+    {
+      PathPlanner::startSolve ();
+      roadmap ()->nearestNeighbor ()->approximationFactor
+        (problem ().getParameter ("NearestNeighbor/approximationFactor").
+         floatValue ());
+      tools_.clear ();
+      if (batchSize_ <= 1) return;
+      if (numberThreads_ > 1) {
+        for (size_type i = 0; i < numberThreads_; ++i)
+          tools_.push_back (factory_ ());
+      } else {
+        ConnectionTools tools;
+        tools.steeringMethod = problem ().steeringMethod ();
+        tools.pathProjector = problem ().pathProjector ();
+        tools.pathValidation = problem ().pathValidation ();
+        tools_.push_back (tools);
+      }
+    }
+
+    void DiffusingPlanner::batch (size_type numberSamples,
+                                  size_type numberThreads,
+                                  const ConnectionToolsFactory_t& factory)
+    {
+      if (numberSamples < 1 || numberThreads < 1 ||
+          (numberThreads > 1 && !factory))
+        throw std::invalid_argument ("Batched extensions require a positive "
+                                     "number of samples and threads, and a "
+                                     "factory for several threads.");
+      batchSize_ = numberSamples;
+      numberThreads_ = numberThreads;
+      factory_ = factory;
+    }
+
     bool belongs (const ConfigurationPtr_t& q, const Nodes_t& nodes)
     {
       for (Nodes_t::const_iterator itNode = nodes.begin ();
@@ -92,12 +139,22 @@ namespace hpp {
       return false;
     }
 
+    bool belongs (const ConfigurationPtr_t& q, const Roadmap::Batch& batch)
+    {
+      for (std::size_t i = 0; i < batch.numberNodes (); ++i) {
+	if (*batch.configuration (i) == *q) return true;
+      }
+      return false;
+    }
+
     PathPtr_t DiffusingPlanner::extend (const NodePtr_t& near,
 					const Configuration_t& target)
     {
+      typedef PlannerStatistics::ScopedTimer Timer_t;
       const SteeringMethodPtr_t& sm (problem ().steeringMethod ());
       const ConstraintSetPtr_t& constraints (sm->constraints ());
       if (constraints) {
+        Timer_t timer (mutableStatistics (), PlannerStatistics::PROJECTION);
 	ConfigProjectorPtr_t configProjector (constraints->configProjector ());
 	if (configProjector) {
 	  configProjector->projectOnKernel (*(near->configuration ()), target,
@@ -113,14 +170,19 @@ namespace hpp {
       }
       // Here, qProj_ is a configuration that satisfies the constraints
       // or target if there are no constraints.
-      PathPtr_t path = (*sm) (*(near->configuration ()), qProj_);
-      value_type stepLength = problem().getParameter ("DiffusingPlanner/extensionStepLength").floatValue();
+      PathPtr_t path;
+      {
+        Timer_t timer (mutableStatistics (), PlannerStatistics::STEERING);
+        path = (*sm) (*(near->configuration ()), qProj_);
+      }
+      const value_type stepLength (extensionStepLength_.value ());
       if (stepLength > 0 && path->length() > stepLength) {
         value_type t0 = path->timeRange().first;
         path = path->extract(t0, t0 + stepLength);
       }
       PathProjectorPtr_t pp = problem ().pathProjector();
       if (pp) {
+        Timer_t timer (mutableStatistics (), PlannerStatistics::PROJECTION);
         PathPtr_t proj;
         pp->apply (path, proj);
         return proj;
@@ -154,9 +216,15 @@ namespace hpp {
 
     void DiffusingPlanner::oneStep ()
     {
+      if (batchSize_ > 1) {
+        batchedStep ();
+        return;
+      }
       HPP_START_TIMECOUNTER(oneStep);
+      typedef PlannerStatistics::ScopedTimer Timer_t;
+      PlannerStatistics& stats (mutableStatistics ());
 
-      value_type stepRatio = problem().getParameter ("DiffusingPlanner/extensionStepRatio").floatValue();
+      const value_type stepRatio (extensionStepRatio_.value ());
 
       typedef boost::tuple <NodePtr_t, ConfigurationPtr_t, PathPtr_t>
 	DelayedEdge_t;
@@ -168,16 +236,31 @@ namespace hpp {
       PathPtr_t validPath, path;
       // Pick a random node
       Configuration_t q_rand;
-      configurationShooter_->shoot (q_rand);
+      {
+        Timer_t timer (stats, PlannerStatistics::SAMPLING);
+        configurationShooter_->shoot (q_rand);
+        stats.sampled ();
+      }
       //
       // First extend each connected component toward q_rand
       //
+      // Find nearest node of each connected component in one search
+      vector_t distances;
+      NodeVector_t nearNodes;
+      {
+        Timer_t timer (stats, PlannerStatistics::NEAREST_NEIGHBOR);
+        nearNodes = roadmap ()->nearestNeighbor ()->
+          searchInConnectedComponents (q_rand,
+                                       roadmap ()->connectedComponents (),
+                                       distances);
+      }
+      NodeVector_t::const_iterator itNear (nearNodes.begin ());
       for (ConnectedComponents_t::const_iterator itcc =
 	     roadmap ()->connectedComponents ().begin ();
-	   itcc != roadmap ()->connectedComponents ().end (); ++itcc) {
-	// Find nearest node in roadmap
-	value_type distance;
-	NodePtr_t near = roadmap ()->nearestNode (q_rand, *itcc, distance);
+	   itcc != roadmap ()->connectedComponents ().end ();
+           ++itcc, ++itNear) {
+	NodePtr_t near = *itNear;
+        assert (near);
         nearestNeighbors.push_back (near);
         HPP_START_TIMECOUNTER(extend);
 	path = extend (near, q_rand);
@@ -185,8 +268,12 @@ namespace hpp {
 	if (path) {
 	  PathValidationReportPtr_t report;
           HPP_START_TIMECOUNTER(validatePath);
-	  bool pathValid = pathValidation->validate (path, false, validPath,
-						     report);
+	  bool pathValid;
+          {
+            Timer_t timer (stats, PlannerStatistics::VALIDATION);
+            pathValid = pathValidation->validate (path, false, validPath,
+                                                  report);
+          }
           HPP_STOP_TIMECOUNTER(validatePath);
 	  // Insert new path to q_near in roadmap
 	  value_type t_final = validPath->timeRange ().second;
@@ -198,6 +285,7 @@ namespace hpp {
 	    ConfigurationPtr_t q_new (new Configuration_t
 				      (validPath->end ()));
 	    if (!pathValid || !belongs (q_new, newNodes)) {
+              Timer_t timer (stats, PlannerStatistics::INSERTION);
 	      newNodes.push_back (roadmap ()->addNodeAndEdges
 				  (near, q_new, validPath));
 	    } else {
@@ -211,14 +299,17 @@ namespace hpp {
       }
       // Insert delayed edges
       HPP_START_TIMECOUNTER(delayedEdges);
-      for (DelayedEdges_t::const_iterator itEdge = delayedEdges.begin ();
-	   itEdge != delayedEdges.end (); ++itEdge) {
-	const NodePtr_t& near = itEdge-> get <0> ();
-	const ConfigurationPtr_t& q_new = itEdge-> get <1> ();
-	const PathPtr_t& validPath = itEdge-> get <2> ();
-	NodePtr_t newNode = roadmap ()->addNode (q_new);
-	roadmap ()->addEdge (near, newNode, validPath);
-	roadmap ()->addEdge (newNode, near, validPath->reverse());
+      if (!delayedEdges.empty ()) {
+        Timer_t timer (stats, PlannerStatistics::INSERTION);
+        for (DelayedEdges_t::const_iterator itEdge = delayedEdges.begin ();
+             itEdge != delayedEdges.end (); ++itEdge) {
+          const NodePtr_t& near = itEdge-> get <0> ();
+          const ConfigurationPtr_t& q_new = itEdge-> get <1> ();
+          const PathPtr_t& validPath = itEdge-> get <2> ();
+          NodePtr_t newNode = roadmap ()->addNode (q_new);
+          roadmap ()->addEdge (near, newNode, validPath);
+          roadmap ()->addEdge (newNode, near, validPath->reversedView());
+        }
       }
       HPP_STOP_TIMECOUNTER(delayedEdges);
 
@@ -226,6 +317,165 @@ namespace hpp {
       // Second, try to connect new nodes together
       //
       HPP_START_TIMECOUNTER(tryConnect);
+      connectNewNodes (newNodes, nearestNeighbors);
+      HPP_STOP_TIMECOUNTER(tryConnect);
+
+      pruneRoadmap ();
+      HPP_STOP_TIMECOUNTER(oneStep);
+
+      HPP_DISPLAY_TIMECOUNTER(oneStep);
+      HPP_DISPLAY_TIMECOUNTER(extend);
+      HPP_DISPLAY_TIMECOUNTER(validatePath);
+      HPP_DISPLAY_TIMECOUNTER(delayedEdges);
+      HPP_DISPLAY_TIMECOUNTER(tryConnect);
+    }
+
+    void DiffusingPlanner::extendRange
+    (const ConnectionTools& tools, const std::vector <Configuration_t>& samples,
+     value_type stepLength, Extensions_t& extensions, std::size_t begin,
+     std::size_t step)
+    {
+      for (std::size_t i = begin; i < extensions.size (); i += step) {
+        Extension& extension (extensions [i]);
+        PathPtr_t path ((*tools.steeringMethod)
+                        (*extension.near->configuration (),
+                         samples [extension.sample]));
+        if (!path) continue;
+        if (stepLength > 0 && path->length() > stepLength) {
+          value_type t0 = path->timeRange().first;
+          path = path->extract(t0, t0 + stepLength);
+        }
+        if (tools.pathProjector) {
+          PathPtr_t proj;
+          if (!tools.pathProjector->apply (path, proj) || !proj) continue;
+          path = proj;
+        }
+        PathValidationReportPtr_t report;
+        extension.valid = tools.pathValidation->validate
+          (path, false, extension.validPath, report);
+        extension.path = path;
+      }
+    }
+
+    void DiffusingPlanner::batchedStep ()
+    {
+      typedef PlannerStatistics::ScopedTimer Timer_t;
+      typedef boost::tuple <NodePtr_t, ConfigurationPtr_t, PathPtr_t>
+	DelayedEdge_t;
+      typedef std::vector <DelayedEdge_t> DelayedEdges_t;
+      PlannerStatistics& stats (mutableStatistics ());
+      const ConstraintSetPtr_t& constraints
+        (problem ().steeringMethod ()->constraints ());
+
+      // Shoot and project the samples
+      std::vector <Configuration_t> samples;
+      samples.reserve (batchSize_);
+      for (size_type i = 0; i < batchSize_; ++i) {
+        Configuration_t q;
+        {
+          Timer_t timer (stats, PlannerStatistics::SAMPLING);
+          configurationShooter_->shoot (q);
+          stats.sampled ();
+        }
+        if (constraints) {
+          Timer_t timer (stats, PlannerStatistics::PROJECTION);
+          if (!constraints->apply (q)) {
+            stats.reject (PlannerStatistics::PROJECTION_FAILURE);
+            continue;
+          }
+        }
+        samples.push_back (q);
+      }
+
+      // Extend the nearest node of each connected component toward each
+      // sample. Extensions of a sample are contiguous.
+      Extensions_t extensions;
+      std::vector <Nodes_t> nearestNeighbors (samples.size ());
+      {
+        Timer_t timer (stats, PlannerStatistics::NEAREST_NEIGHBOR);
+        vector_t distances;
+        for (std::size_t i = 0; i < samples.size (); ++i) {
+          const NodeVector_t nearNodes (roadmap ()->nearestNeighbor ()->
+              searchInConnectedComponents (samples [i],
+                                           roadmap ()->connectedComponents (),
+                                           distances));
+          for (NodeVector_t::const_iterator itNear = nearNodes.begin ();
+               itNear != nearNodes.end (); ++itNear) {
+            extensions.push_back (Extension (i, *itNear));
+            nearestNeighbors [i].push_back (*itNear);
+          }
+        }
+      }
+      const value_type stepLength (extensionStepLength_.value ());
+      const std::size_t nThreads
+        (std::min (tools_.size (), extensions.size ()));
+      if (nThreads <= 1) {
+        extendRange (tools_ [0], samples, stepLength, extensions, 0, 1);
+      } else {
+        Executor::Tasks_t tasks;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          tasks.push_back
+            (boost::bind (&DiffusingPlanner::extendRange,
+                          boost::cref (tools_ [t]), boost::cref (samples),
+                          stepLength, boost::ref (extensions), t, nThreads));
+        }
+        Executor::run (executor (), tasks);
+      }
+
+      // Insert the extensions of each sample in the roadmap and connect
+      // the new nodes.
+      const value_type stepRatio (extensionStepRatio_.value ());
+      Extensions_t::const_iterator itExt (extensions.begin ());
+      for (std::size_t i = 0; i < samples.size (); ++i) {
+        Roadmap::Batch batch;
+        DelayedEdges_t delayedEdges;
+        for (; itExt != extensions.end () && itExt->sample == i; ++itExt) {
+          if (!itExt->path) continue;
+          PathPtr_t validPath (itExt->validPath);
+          if (validPath->timeRange ().second ==
+              itExt->path->timeRange ().first) continue;
+          if (!itExt->valid && stepRatio > 0 && stepRatio < 1.) {
+            value_type t0 = validPath->timeRange().first;
+            validPath = validPath->extract(t0, t0 + validPath->length()*stepRatio);
+          }
+          ConfigurationPtr_t q_new (new Configuration_t (validPath->end ()));
+          if (!itExt->valid || !belongs (q_new, batch)) {
+            batch.addEdges (itExt->near, batch.addNode (q_new), validPath);
+          } else {
+            delayedEdges.push_back (DelayedEdge_t (itExt->near, q_new,
+                                                   validPath));
+          }
+        }
+        Nodes_t newNodes;
+        {
+          Timer_t timer (stats, PlannerStatistics::INSERTION);
+          const NodeVector_t nodes (roadmap ()->addNodesAndEdges (batch));
+          newNodes.assign (nodes.begin (), nodes.end ());
+        }
+        if (!delayedEdges.empty ()) {
+          Timer_t timer (stats, PlannerStatistics::INSERTION);
+          for (DelayedEdges_t::const_iterator itEdge = delayedEdges.begin ();
+               itEdge != delayedEdges.end (); ++itEdge) {
+            const NodePtr_t& near = itEdge-> get <0> ();
+            const ConfigurationPtr_t& q_new = itEdge-> get <1> ();
+            const PathPtr_t& validPath = itEdge-> get <2> ();
+            NodePtr_t newNode = roadmap ()->addNode (q_new);
+            roadmap ()->addEdge (near, newNode, validPath);
+            roadmap ()->addEdge (newNode, near, validPath->reversedView());
+          }
+        }
+        connectNewNodes (newNodes, nearestNeighbors [i]);
+      }
+      pruneRoadmap ();
+    }
+
+    void DiffusingPlanner::connectNewNodes (const Nodes_t& newNodes,
+                                            const Nodes_t& nearestNeighbors)
+    {
+      typedef PlannerStatistics::ScopedTimer Timer_t;
+      PlannerStatistics& stats (mutableStatistics ());
+      PathValidationPtr_t pathValidation (problem ().pathValidation ());
+      PathPtr_t validPath, path;
       const SteeringMethodPtr_t& sm (problem ().steeringMethod ());
       for (Nodes_t::const_iterator itn1 = newNodes.begin ();
 	   itn1 != newNodes.end (); ++itn1) {
@@ -235,11 +485,15 @@ namespace hpp {
 	  ConfigurationPtr_t q1 ((*itn1)->configuration ());
 	  ConfigurationPtr_t q2 ((*itn2)->configuration ());
 	  assert (*q1 != *q2);
-	  path = (*sm) (*q1, *q2);
+          {
+            Timer_t timer (stats, PlannerStatistics::STEERING);
+            path = (*sm) (*q1, *q2);
+          }
           if (!path) continue;
 
           PathProjectorPtr_t pp = problem ().pathProjector();
           if (pp) {
+            Timer_t timer (stats, PlannerStatistics::PROJECTION);
             PathPtr_t proj;
             // If projection failed, continue
             if (!pp->apply (path, proj)) continue;
@@ -248,13 +502,19 @@ namespace hpp {
 
 	  PathValidationReportPtr_t report;
           HPP_START_TIMECOUNTER(validatePath);
-	  bool valid = pathValidation->validate (path, false, validPath, report);
+	  bool valid;
+          {
+            Timer_t timer (stats, PlannerStatistics::VALIDATION);
+            valid = pathValidation->validate (path, false, validPath, report);
+          }
           HPP_STOP_TIMECOUNTER(validatePath);
           if (valid) {
+            Timer_t timer (stats, PlannerStatistics::INSERTION);
 	    roadmap ()->addEdge (*itn1, *itn2, path);
-	    roadmap ()->addEdge (*itn2, *itn1, path->reverse ());
+	    roadmap ()->addEdge (*itn2, *itn1, path->reversedView ());
           } else if (validPath && validPath->length () > 0) {
             // A -> B
+            Timer_t timer (stats, PlannerStatistics::INSERTION);
             ConfigurationPtr_t cfg (new Configuration_t (validPath->end()));
             roadmap ()->addNodeAndEdges (*itn1, cfg, validPath);
           }
@@ -267,11 +527,15 @@ namespace hpp {
           if (cc1 == (*itn2)->connectedComponent ()) continue;
 	  ConfigurationPtr_t q2 ((*itn2)->configuration ());
 	  assert (*q1 != *q2);
-	  path = (*sm) (*q1, *q2);
+          {
+            Timer_t timer (stats, PlannerStatistics::STEERING);
+            path = (*sm) (*q1, *q2);
+          }
           if (!path) continue;
 
           PathProjectorPtr_t pp = problem ().pathProjector();
           if (pp) {
+            Timer_t timer (stats, PlannerStatistics::PROJECTION);
             PathPtr_t proj;
             // If projection failed, continue
             if (!pp->apply (path, proj)) continue;
@@ -280,27 +544,24 @@ namespace hpp {
 
 	  PathValidationReportPtr_t report;
           HPP_START_TIMECOUNTER(validatePath);
-	  bool valid = pathValidation->validate (path, false, validPath, report);
+	  bool valid;
+          {
+            Timer_t timer (stats, PlannerStatistics::VALIDATION);
+            valid = pathValidation->validate (path, false, validPath, report);
+          }
           HPP_STOP_TIMECOUNTER(validatePath);
           if (valid) {
+            Timer_t timer (stats, PlannerStatistics::INSERTION);
 	    roadmap ()->addEdge (*itn1, *itn2, path);
-	    roadmap ()->addEdge (*itn2, *itn1, path->reverse ());
+	    roadmap ()->addEdge (*itn2, *itn1, path->reversedView ());
           } else if (validPath && validPath->length () > 0) {
             // A -> B
+            Timer_t timer (stats, PlannerStatistics::INSERTION);
             ConfigurationPtr_t cfg (new Configuration_t (validPath->end()));
             roadmap ()->addNodeAndEdges (*itn1, cfg, validPath);
           }
 	}
       }
-      HPP_STOP_TIMECOUNTER(tryConnect);
-
-      HPP_STOP_TIMECOUNTER(oneStep);
-
-      HPP_DISPLAY_TIMECOUNTER(oneStep);
-      HPP_DISPLAY_TIMECOUNTER(extend);
-      HPP_DISPLAY_TIMECOUNTER(validatePath);
-      HPP_DISPLAY_TIMECOUNTER(delayedEdges);
-      HPP_DISPLAY_TIMECOUNTER(tryConnect);
     }
 
     void DiffusingPlanner::configurationShooter
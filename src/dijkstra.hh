@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_DIJKSTRA_HH
+# define HPP_CORE_DIJKSTRA_HH
+
+# include <functional>
+# include <limits>
+# include <queue>
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    /// Dijkstra search in a graph stored in compressed sparse rows
+    ///
+    /// The out edges of node \c i are <c>offsets [i]</c> to
+    /// <c>offsets [i+1] - 1</c>. Arrays are accessed by operator[], so
+    /// that vectors and pointers to contiguous memory can be used.
+    /// \param numberNodes number of nodes,
+    /// \param offsets, targets, edgeCosts the graph,
+    /// \param sources ids of the start nodes,
+    /// \param initialCosts cost of each start node,
+    /// \param to id of the node where the search stops, -1 to explore
+    ///        all the reachable nodes.
+    /// \retval costs cost of the shortest path to each node, infinity if the
+    ///         node is not reached,
+    /// \retval parents id of the last edge of the shortest path to each
+    ///         node, -1 for unreached nodes and for start nodes.
+    template <typename Ids, typename Costs>
+    void dijkstra (size_type numberNodes, const Ids& offsets,
+                   const Ids& targets, const Costs& edgeCosts,
+                   const std::vector <size_type>& sources,
+                   const std::vector <value_type>& initialCosts,
+                   size_type to, std::vector <value_type>& costs,
+                   std::vector <size_type>& parents)
+    {
+      typedef std::pair <value_type, size_type> CostAndId_t;
+      costs.assign (numberNodes,
+                    std::numeric_limits <value_type>::infinity ());
+      parents.assign (numberNodes, -1);
+      std::priority_queue <CostAndId_t, std::vector <CostAndId_t>,
+                           std::greater <CostAndId_t> > queue;
+      for (std::size_t i = 0; i < sources.size (); ++i) {
+        if (initialCosts [i] < costs [sources [i]]) {
+          costs [sources [i]] = initialCosts [i];
+          queue.push (CostAndId_t (initialCosts [i], sources [i]));
+        }
+      }
+      while (!queue.empty ()) {
+        const CostAndId_t top (queue.top ());
+        queue.pop ();
+        // Outdated entry
+        if (top.first > costs [top.second]) continue;
+        if (top.second == to) return;
+        for (size_type e = (size_type) offsets [top.second];
+             e < (size_type) offsets [top.second + 1]; ++e) {
+          const value_type cost (top.first + edgeCosts [e]);
+          const size_type child ((size_type) targets [e]);
+          if (cost < costs [child]) {
+            costs [child] = cost;
+            parents [child] = e;
+            queue.push (CostAndId_t (cost, child));
+          }
+        }
+      }
+    }
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_DIJKSTRA_HH
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/distance-field-validation.hh>
+
+#include <hpp/pinocchio/body.hh>
+#include <hpp/pinocchio/collision-object.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+
+#include <hpp/core/collision-validation-report.hh>
+#include <hpp/core/distance-field.hh>
+
+namespace hpp {
+  namespace core {
+    DistanceFieldValidationPtr_t DistanceFieldValidation::create
+    (const DevicePtr_t& robot, const DistanceFieldPtr_t& field)
+    {
+      return DistanceFieldValidationPtr_t
+        (new DistanceFieldValidation (robot, field));
+    }
+
+    DistanceFieldValidation::DistanceFieldValidation
+    (const DevicePtr_t& robot, const DistanceFieldPtr_t& field) :
+      robot_ (robot), field_ (field), securityMargin_ (0)
+    {
+      for (size_type i = 0; i < robot_->nbJoints (); ++i) {
+        BodyPtr_t body (robot_->jointAt (i)->linkedBody ());
+        if (!body) continue;
+        for (size_type o = 0; o < body->nbInnerObjects (); ++o)
+          objects_.push_back (body->innerObjectAt (o));
+      }
+    }
+
+    bool DistanceFieldValidation::validate
+    (const Configuration_t& config, ValidationReportPtr_t& validationReport)
+    {
+      pinocchio::DeviceSync device (robot_);
+      device.currentConfiguration (config);
+      device.computeForwardKinematics ();
+      device.updateGeometryPlacements ();
+      for (ConstObjectStdVector_t::const_iterator it = objects_.begin ();
+           it != objects_.end (); ++it) {
+        if (field_->distanceLowerBound (*it, device.d ()) <= securityMargin_) {
+          CollisionValidationReportPtr_t report
+            (new CollisionValidationReport (*it, CollisionObjectConstPtr_t (),
+                                            fcl::CollisionResult ()));
+          report->objectName2 = "distance field";
+          validationReport = report;
+          return false;
+        }
+      }
+      return true;
+    }
+  } // namespace core
+} // namespace hpp
@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/distance-field.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+
+#include <hpp/util/exception-factory.hh>
+#include <hpp/fcl/collision_object.h>
+
+#include <pinocchio/spatial/fcl-pinocchio-conversions.hpp>
+
+#include <hpp/pinocchio/collision-object.hh>
+
+namespace hpp {
+  namespace core {
+    namespace {
+      /// First bytes of the files written by DistanceField::save
+      const char magic [8] = { 'h', 'p', 'p', '-', 's', 'd', 'f', '1' };
+    } // namespace
+
+    DistanceFieldPtr_t DistanceField::create (const vector3_t& origin,
+                                              value_type resolution,
+                                              size_type nx, size_type ny,
+                                              size_type nz)
+    {
+      return DistanceFieldPtr_t (new DistanceField (origin, resolution,
+                                                    nx, ny, nz));
+    }
+
+    DistanceField::DistanceField (const vector3_t& origin,
+                                  value_type resolution,
+                                  size_type nx, size_type ny, size_type nz) :
+      origin_ (origin), resolution_ (resolution)
+    {
+      if (resolution <= 0)
+        throw std::invalid_argument ("resolution should be positive.");
+      if (nx < 1 || ny < 1 || nz < 1)
+        throw std::invalid_argument ("grid should have at least one voxel.");
+      size_ [0] = nx; size_ [1] = ny; size_ [2] = nz;
+      values_.assign ((std::size_t) (nx * ny * nz),
+                      std::numeric_limits <float>::infinity ());
+    }
+
+    value_type DistanceField::distanceLowerBound (const vector3_t& point)
+      const
+    {
+      // Voxel containing the point, or closest voxel
+      size_type v [3];
+      bool inside (true);
+      for (size_type a = 0; a < 3; ++a) {
+        const value_type x ((point [a] - origin_ [a]) / resolution_);
+        if (x < 0 || x >= (value_type) size_ [a]) inside = false;
+        v [a] = std::max (size_type (0),
+                          std::min (size_ [a] - 1, (size_type) std::floor (x)));
+      }
+      vector3_t center;
+      for (size_type a = 0; a < 3; ++a)
+        center [a] = origin_ [a] + ((value_type) v [a] + .5) * resolution_;
+      const value_type d ((point - center).norm ());
+      const value_type bound (value (v [0], v [1], v [2]) - d);
+      if (inside) return bound;
+      // Obstacles are inside the grid: the distance to the grid is also a
+      // lower bound.
+      vector3_t closest;
+      for (size_type a = 0; a < 3; ++a) {
+        closest [a] = std::max (origin_ [a], std::min
+                                (origin_ [a] + (value_type) size_ [a] *
+                                 resolution_, point [a]));
+      }
+      return std::max (bound, (point - closest).norm ());
+    }
+
+    value_type DistanceField::distanceLowerBound
+    (const CollisionObjectConstPtr_t& object,
+     const pinocchio::DeviceData& data) const
+    {
+      const fcl::CollisionGeometry& geometry (*object->geometry ());
+      const vector3_t center (::pinocchio::toFclTransform3f
+                              (object->getTransform (data)).transform
+                              (geometry.aabb_center));
+      return distanceLowerBound (center) - geometry.aabb_radius;
+    }
+
+    void DistanceField::save (const std::string& filename) const
+    {
+      std::ofstream file (filename.c_str (), std::ios::binary);
+      if (!file) {
+        HPP_THROW (std::runtime_error, "Cannot open file " << filename);
+      }
+      file.write (magic, sizeof (magic));
+      for (size_type a = 0; a < 3; ++a) {
+        const boost::int64_t n (size_ [a]);
+        file.write (reinterpret_cast <const char*> (&n), sizeof (n));
+      }
+      for (size_type a = 0; a < 3; ++a) {
+        const double x (origin_ [a]);
+        file.write (reinterpret_cast <const char*> (&x), sizeof (x));
+      }
+      const double resolution (resolution_);
+      file.write (reinterpret_cast <const char*> (&resolution),
+                  sizeof (resolution));
+      file.write (reinterpret_cast <const char*> (&values_ [0]),
+                  (std::streamsize) (values_.size () * sizeof (float)));
+      if (!file) {
+        HPP_THROW (std::runtime_error, "Failed to write file " << filename);
+      }
+    }
+
+    DistanceFieldPtr_t DistanceField::load (const std::string& filename)
+    {
+      std::ifstream file (filename.c_str (), std::ios::binary);
+      if (!file) {
+        HPP_THROW (std::runtime_error, "Cannot open file " << filename);
+      }
+      char header [sizeof (magic)];
+      boost::int64_t n [3];
+      double x [3], resolution;
+      file.read (header, sizeof (header));
+      file.read (reinterpret_cast <char*> (n), sizeof (n));
+      file.read (reinterpret_cast <char*> (x), sizeof (x));
+      file.read (reinterpret_cast <char*> (&resolution), sizeof (resolution));
+      if (!file || std::memcmp (header, magic, sizeof (magic)) != 0) {
+        HPP_THROW (std::runtime_error, "File " << filename
+                   << " is not a distance field.");
+      }
+      DistanceFieldPtr_t field (create (vector3_t (x [0], x [1], x [2]),
+                                        resolution, n [0], n [1], n [2]));
+      file.read (reinterpret_cast <char*> (&field->values_ [0]),
+                 (std::streamsize) (field->values_.size () * sizeof (float)));
+      if (!file) {
+        HPP_THROW (std::runtime_error, "File " << filename
+                   << " is truncated.");
+      }
+      return field;
+    }
+  } // namespace core
+} // namespace hpp
@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2017 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/distance/dubins.hh>
+#include <hpp/core/steering-method/dubins.hh>
+
+namespace hpp {
+  namespace core {
+    namespace distance {
+
+      DistancePtr_t Dubins::clone () const
+      {
+	return createCopy (weak_.lock ());
+      }
+
+      DubinsPtr_t Dubins::create (const Problem& problem)
+      {
+	Dubins* ptr (new Dubins (problem));
+	DubinsPtr_t shPtr (ptr);
+	ptr->init (shPtr);
+	return shPtr;
+      }
+
+      DubinsPtr_t Dubins::create
+      (const Problem& problem, const value_type& turningRadius,
+       JointPtr_t xyJoint, JointPtr_t rzJoint)
+      {
+	Dubins* ptr (new Dubins (problem, turningRadius, xyJoint, rzJoint));
+	DubinsPtr_t shPtr (ptr);
+	ptr->init (shPtr);
+	return shPtr;
+      }
+
+      DubinsPtr_t Dubins::createCopy (const DubinsPtr_t& distance)
+      {
+	Dubins* ptr (new Dubins (*distance));
+	DubinsPtr_t shPtr (ptr);
+	ptr->init (shPtr);
+	return shPtr;
+      }
+
+      Dubins::Dubins (const Problem& problem) :
+	Distance (), sm_ (steeringMethod::Dubins::createWithGuess (problem))
+      {
+      }
+
+      Dubins::Dubins (const Problem& problem,
+		      const value_type& turningRadius,
+		      JointPtr_t xyJoint, JointPtr_t rzJoint) :
+	Distance (), sm_ (steeringMethod::Dubins::create
+			  (problem, turningRadius, xyJoint, rzJoint))
+      {
+      }
+
+      Dubins::Dubins (const Dubins& distance) :
+	Distance (), sm_ (steeringMethod::Dubins::createCopy (distance.sm_))
+      {
+      }
+
+      value_type Dubins::impl_distance (ConfigurationIn_t q1,
+					ConfigurationIn_t q2) const
+      {
+	return sm_->length (q1, q2);
+      }
+
+      value_type Dubins::impl_lowerBound (ConfigurationIn_t q1,
+					  ConfigurationIn_t q2) const
+      {
+	return sm_->lengthLowerBound (q1, q2);
+      }
+
+      void Dubins::impl_distances (matrixIn_t configurations,
+				   ConfigurationIn_t q,
+				   vector_t& distances) const
+      {
+	sm_->lengths (configurations, q, distances);
+      }
+
+      void Dubins::init (const DubinsWkPtr_t& weak)
+      {
+	weak_ = weak;
+      }
+
+    } // namespace distance
+  } //   namespace core
+} // namespace hpp
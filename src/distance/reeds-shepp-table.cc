@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2016 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/distance/reeds-shepp-table.hh>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <hpp/util/exception-factory.hh>
+
+#include <hpp/core/random-generator.hh>
+#include <hpp/core/reeds-shepp-path.hh>
+
+namespace hpp {
+  namespace core {
+    namespace distance {
+      namespace {
+        const char magic [8] = { 'H', 'P', 'P', 'R', 'S', 'T', 'B', '1' };
+
+        // Length of the curve from the origin to a pose, for a turning
+        // radius of 1.
+        value_type curveLength (value_type x, value_type y, value_type theta)
+        {
+          vector_t q1 (4), q2 (4);
+          q1 << 0, 0, 1, 0;
+          q2 << x, y, cos (theta), sin (theta);
+          return ReedsSheppPath::curveLength (q1, q2, 1, 0, 2);
+        }
+
+        value_type wrap (value_type theta)
+        {
+          return atan2 (sin (theta), cos (theta));
+        }
+      } // namespace
+
+      /// Beginning of the files and of the memory of the tables. The
+      /// lengths follow.
+      struct ReedsSheppTable::Header
+      {
+        char magic [8];
+        int64_t numberXY;
+        int64_t numberTheta;
+        double extent;
+        double margin;
+      }; // struct Header
+
+      ReedsSheppTablePtr_t ReedsSheppTable::create (size_type numberXY,
+                                                    size_type numberTheta,
+                                                    value_type extent)
+      {
+        if (numberXY < 2 || numberTheta < 2 || extent <= 0)
+          throw std::invalid_argument ("A table of Reeds and Shepp lengths "
+                                       "requires at least two nodes per "
+                                       "dimension and a positive extent.");
+        ReedsSheppTablePtr_t table (new ReedsSheppTable);
+        const std::size_t n ((std::size_t) (numberXY * numberXY *
+                                            numberTheta));
+        table->data_.resize (sizeof (Header) + n * sizeof (float));
+        Header* header (reinterpret_cast <Header*> (&table->data_ [0]));
+        std::memcpy (header->magic, magic, sizeof (magic));
+        header->numberXY = numberXY;
+        header->numberTheta = numberTheta;
+        header->extent = extent;
+        header->margin = 0;
+        float* lengths (reinterpret_cast <float*>
+                        (&table->data_ [sizeof (Header)]));
+        table->header_ = header;
+        table->lengths_ = lengths;
+
+        const value_type dxy (2 * extent / (value_type) (numberXY - 1)),
+          dt (2 * M_PI / (value_type) (numberTheta - 1));
+        for (size_type it = 0; it < numberTheta; ++it)
+          for (size_type iy = 0; iy < numberXY; ++iy)
+            for (size_type ix = 0; ix < numberXY; ++ix)
+              lengths [(it * numberXY + iy) * numberXY + ix] = (float)
+                curveLength (-extent + (value_type) ix * dxy,
+                             -extent + (value_type) iy * dxy,
+                             -M_PI + (value_type) it * dt);
+
+        // Measure the error of the interpolation at the centers of the
+        // cells and at random poses.
+        RandomGeneratorPtr_t generator (RandomGenerator::create (0));
+        value_type margin (0);
+        for (size_type it = 0; it + 1 < numberTheta; ++it)
+          for (size_type iy = 0; iy + 1 < numberXY; ++iy)
+            for (size_type ix = 0; ix + 1 < numberXY; ++ix) {
+              for (int k = 0; k < 2; ++k) {
+                const value_type
+                  ux (k == 0 ? .5 : generator->uniform ()),
+                  uy (k == 0 ? .5 : generator->uniform ()),
+                  ut (k == 0 ? .5 : generator->uniform ()),
+                  x (-extent + ((value_type) ix + ux) * dxy),
+                  y (-extent + ((value_type) iy + uy) * dxy),
+                  theta (-M_PI + ((value_type) it + ut) * dt);
+                margin = std::max (margin, table->interpolate (x, y, theta)
+                                   - curveLength (x, y, theta));
+              }
+            }
+        header->margin = margin;
+        return table;
+      }
+
+      ReedsSheppTablePtr_t ReedsSheppTable::load (const std::string& filename)
+      {
+        const int fd (::open (filename.c_str (), O_RDONLY));
+        if (fd < 0)
+          HPP_THROW (std::runtime_error, "Cannot open the table of Reeds and "
+                     "Shepp lengths " << filename);
+        struct stat status;
+        if (::fstat (fd, &status) != 0 ||
+            (std::size_t) status.st_size < sizeof (Header)) {
+          ::close (fd);
+          HPP_THROW (std::runtime_error, filename << " is not a table of "
+                     "Reeds and Shepp lengths.");
+        }
+        const std::size_t size ((std::size_t) status.st_size);
+        void* map (::mmap (0x0, size, PROT_READ, MAP_SHARED, fd, 0));
+        ::close (fd);
+        if (map == MAP_FAILED)
+          HPP_THROW (std::runtime_error, "Cannot map the table of Reeds and "
+                     "Shepp lengths " << filename);
+        ReedsSheppTablePtr_t table (new ReedsSheppTable);
+        table->map_ = map;
+        table->mapSize_ = size;
+        const Header* header (static_cast <const Header*> (map));
+        const std::size_t n
+          ((std::size_t) (header->numberXY * header->numberXY *
+                          header->numberTheta));
+        if (std::memcmp (header->magic, magic, sizeof (magic)) != 0 ||
+            header->numberXY < 2 || header->numberTheta < 2 ||
+            size != sizeof (Header) + n * sizeof (float))
+          HPP_THROW (std::runtime_error, filename << " is not a table of "
+                     "Reeds and Shepp lengths.");
+        table->header_ = header;
+        table->lengths_ = reinterpret_cast <const float*>
+          (static_cast <const char*> (map) + sizeof (Header));
+        return table;
+      }
+
+      void ReedsSheppTable::save (const std::string& filename) const
+      {
+        const std::string tmp (filename + ".tmp");
+        {
+          std::ofstream file (tmp.c_str (), std::ios::binary);
+          file.write (reinterpret_cast <const char*> (header_),
+                      sizeof (Header));
+          file.write (reinterpret_cast <const char*> (lengths_),
+                      (std::streamsize) (numberXY () * numberXY () *
+                                         numberTheta () * sizeof (float)));
+          if (!file)
+            HPP_THROW (std::runtime_error, "Cannot write the table of Reeds "
+                       "and Shepp lengths " << tmp);
+        }
+        if (std::rename (tmp.c_str (), filename.c_str ()) != 0)
+          HPP_THROW (std::runtime_error, "Cannot rename " << tmp << " into "
+                     << filename);
+      }
+
+      value_type ReedsSheppTable::interpolate (value_type x, value_type y,
+                                               value_type theta) const
+      {
+        const size_type nxy (numberXY ()), nt (numberTheta ());
+        const value_type
+          fx ((x + extent ()) / (2 * extent ()) * (value_type) (nxy - 1)),
+          fy ((y + extent ()) / (2 * extent ()) * (value_type) (nxy - 1)),
+          ft ((theta + M_PI) / (2 * M_PI) * (value_type) (nt - 1));
+        const size_type
+          ix (std::min ((size_type) fx, nxy - 2)),
+          iy (std::min ((size_type) fy, nxy - 2)),
+          it (std::min ((size_type) ft, nt - 2));
+        const value_type ux (fx - (value_type) ix), uy (fy - (value_type) iy),
+          ut (ft - (value_type) it);
+        value_type result (0);
+        for (int k = 0; k < 8; ++k) {
+          const int bx (k & 1), by ((k >> 1) & 1), bt ((k >> 2) & 1);
+          result += (bx ? ux : 1 - ux) * (by ? uy : 1 - uy) *
+            (bt ? ut : 1 - ut) * length (ix + bx, iy + by, it + bt);
+        }
+        return result;
+      }
+
+      value_type ReedsSheppTable::lowerBound (value_type x, value_type y,
+                                              value_type theta) const
+      {
+        const value_type euclidean (std::sqrt (x * x + y * y));
+        if (std::fabs (x) > extent () || std::fabs (y) > extent ())
+          return euclidean;
+        return std::max (euclidean,
+                         interpolate (x, y, wrap (theta)) - margin ());
+      }
+
+      value_type ReedsSheppTable::lowerBound
+      (ConfigurationIn_t q1, ConfigurationIn_t q2, value_type rho,
+       size_type xyId, size_type rzId) const
+      {
+        // Pose of q2 in the frame of q1, as ReedsSheppPath::curveLength
+        const value_type c (q1 [rzId]), s (q1 [rzId + 1]),
+          dx (q2 [xyId] - q1 [xyId]), dy (q2 [xyId + 1] - q1 [xyId + 1]);
+        const value_type
+          x ((dx * c + dy * s) / rho), y ((- dx * s + dy * c) / rho),
+          theta (atan2 (- q2 [rzId] * s + q2 [rzId + 1] * c,
+                        q2 [rzId] * c + q2 [rzId + 1] * s));
+        return rho * lowerBound (x, y, theta);
+      }
+
+      value_type ReedsSheppTable::margin () const
+      {
+        return header_->margin;
+      }
+
+      size_type ReedsSheppTable::numberXY () const
+      {
+        return header_->numberXY;
+      }
+
+      size_type ReedsSheppTable::numberTheta () const
+      {
+        return header_->numberTheta;
+      }
+
+      value_type ReedsSheppTable::extent () const
+      {
+        return header_->extent;
+      }
+
+      ReedsSheppTable::ReedsSheppTable () :
+        header_ (0x0), lengths_ (0x0), map_ (0x0), mapSize_ (0)
+      {
+      }
+
+      ReedsSheppTable::~ReedsSheppTable ()
+      {
+        if (map_) ::munmap (map_, mapSize_);
+      }
+    } // namespace distance
+  } //   namespace core
+} // namespace hpp
@@ -17,6 +17,11 @@
 // <http://www.gnu.org/licenses/>.
 
 #include <hpp/core/distance/reeds-shepp.hh>
+
+#include <sys/stat.h>
+
+#include <hpp/core/distance/reeds-shepp-table.hh>
+#include <hpp/core/problem.hh>
 #include <hpp/core/steering-method/reeds-shepp.hh>
 
 namespace hpp {
@@ -28,11 +33,29 @@ namespace hpp {
 	return createCopy (weak_.lock ());
       }
 
+      namespace {
+        /// Table of parameter "ReedsShepp/lookupTable", computed and saved
+        /// if the file does not exist.
+        ReedsSheppTablePtr_t lookupTable (const Problem& problem)
+        {
+          const std::string filename (problem.getParameter
+                                      ("ReedsShepp/lookupTable").stringValue ());
+          if (filename.empty ()) return ReedsSheppTablePtr_t ();
+          struct stat status;
+          if (::stat (filename.c_str (), &status) == 0)
+            return ReedsSheppTable::load (filename);
+          ReedsSheppTablePtr_t table (ReedsSheppTable::create (101, 64, 8));
+          table->save (filename);
+          return table;
+        }
+      } // namespace
+
       ReedsSheppPtr_t ReedsShepp::create (const Problem& problem)
       {
 	ReedsShepp* ptr (new ReedsShepp (problem));
 	ReedsSheppPtr_t shPtr (ptr);
 	ptr->init (shPtr);
+        ptr->lookupTable (lookupTable (problem));
 	return shPtr;
       }
       ReedsSheppPtr_t ReedsShepp::create
@@ -43,6 +66,7 @@ namespace hpp {
 					 xyJoint, rzJoint));
 	ReedsSheppPtr_t shPtr (ptr);
 	ptr->init (shPtr);
+        ptr->lookupTable (lookupTable (problem));
 	return shPtr;
       }
 
@@ -68,21 +92,40 @@ namespace hpp {
       }
       
       ReedsShepp::ReedsShepp (const ReedsShepp& distance) :
-	Distance (), sm_ (steeringMethod::ReedsShepp::createCopy (distance.sm_))
+	Distance (), sm_ (steeringMethod::ReedsShepp::createCopy (distance.sm_)),
+        table_ (distance.table_)
       {
       }
 
       value_type ReedsShepp::impl_distance (ConfigurationIn_t q1,
 					    ConfigurationIn_t q2) const
       {
-	return (*sm_) (q1, q2)->length ();
+	return sm_->length (q1, q2);
+      }
+
+      value_type ReedsShepp::impl_lowerBound (ConfigurationIn_t q1,
+					      ConfigurationIn_t q2) const
+      {
+        if (table_)
+          return table_->lowerBound (q1, q2, sm_->turningRadius (),
+                                     sm_->xyRank (), sm_->rzRank ());
+	return sm_->lengthLowerBound (q1, q2);
       }
 
       void ReedsShepp::init (const ReedsSheppWkPtr_t& weak)
       {
 	weak_ = weak;
       }
-			  
+
+      HPP_START_PARAMETER_DECLARATION(ReedsSheppDistance)
+      Problem::declareParameter(ParameterDescription (Parameter::STRING,
+            "ReedsShepp/lookupTable",
+            "File of the table of Reeds and Shepp lengths used as lower bound "
+            "of the distance by the nearest neighbor searches. The table is "
+            "computed and saved if the file does not exist. Empty to bound "
+            "the distance by the distance between the positions.",
+            Parameter(std::string())));
+      HPP_END_PARAMETER_DECLARATION(ReedsSheppDistance)
     } // namespace distance
   } //   namespace core
 } // namespace hpp
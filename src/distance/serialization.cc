@@ -25,10 +25,12 @@
 #include <hpp/pinocchio/serialization.hh> // For serialization of Device
 
 #include <hpp/core/distance.hh>
+#include <hpp/core/distance/dubins.hh>
 #include <hpp/core/distance/reeds-shepp.hh>
 #include <hpp/core/weighed-distance.hh>
 
 BOOST_CLASS_EXPORT(hpp::core::WeighedDistance)
+BOOST_CLASS_EXPORT(hpp::core::distance::Dubins)
 BOOST_CLASS_EXPORT(hpp::core::distance::ReedsShepp)
 
 namespace hpp {
@@ -49,12 +51,25 @@ inline void WeighedDistance::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(robot_);
   ar & BOOST_SERIALIZATION_NVP(weights_);
   ar & BOOST_SERIALIZATION_NVP(weak_);
+  if (Archive::is_loading::value)
+    computeDistancePlan ();
 }
 
 HPP_SERIALIZATION_IMPLEMENT(WeighedDistance);
 
 namespace distance {
 
+template <typename Archive>
+inline void Dubins::serialize(Archive& ar, const unsigned int version)
+{
+  throw std::logic_error("Dubins distance not serializable.");
+  (void) version;
+  ar & boost::serialization::make_nvp("base", boost::serialization::base_object<Distance>(*this));
+  ar & BOOST_SERIALIZATION_NVP(weak_);
+}
+
+HPP_SERIALIZATION_IMPLEMENT(Dubins);
+
 template <typename Archive>
 inline void ReedsShepp::serialize(Archive& ar, const unsigned int version)
 {
@@ -143,37 +143,46 @@ namespace hpp {
       weak_ = self;
     }
 
-    void DubinsPath::dubins_init_normalised
-    (double alpha, double beta, double d)
-    {
-      double best_cost = INFINITY;
-      int    best_word;
-      int    i;
-
-      best_word = -1;
-      for( i = 0; i < 6; i++ ) {
-        double params[3];
-        int err = dubins_words[i](alpha, beta, d, params);
-        if(err == EDUBOK) {
-	  double cost = params[0] + params[1] + params[2];
-	  if(cost < best_cost) {
-	    best_word = i;
-	    best_cost = cost;
-	    lengths_[0] = params[0];
-	    lengths_[1] = params[1];
-	    lengths_[2] = params[2];
-	    typeId_ = i;
-	  }
+    namespace {
+      /// Find the shortest of the six Dubins words
+      /// \retval lengths normalised lengths of the segments of the word,
+      /// \retval typeId index of the word in dubins_words,
+      /// \return whether a word connects the poses.
+      inline bool shortestWord (double alpha, double beta, double d,
+                                double* lengths, std::size_t& typeId)
+      {
+        double best_cost = INFINITY;
+        bool found = false;
+        for (std::size_t i = 0; i < 6; ++i) {
+          double params[3];
+          int err = dubins_words[i](alpha, beta, d, params);
+          if(err == EDUBOK) {
+            double cost = params[0] + params[1] + params[2];
+            if(cost < best_cost) {
+              best_cost = cost;
+              lengths[0] = params[0];
+              lengths[1] = params[1];
+              lengths[2] = params[2];
+              typeId = i;
+              found = true;
+            }
+          }
         }
+        return found;
       }
+    } // namespace
 
-      if(best_word == -1) {
+    void DubinsPath::dubins_init_normalised
+    (double alpha, double beta, double d)
+    {
+      double lengths [3];
+      if (!shortestWord (alpha, beta, d, lengths, typeId_)) {
 	hppDout (error, "Failed to build Dubins path between " <<
 		 initial_.transpose () << " and "
 		 << end_.transpose () << ".");
         throw std::logic_error ("Failed to build Dubins path");
       }
-      typeId_ = best_word;
+      lengths_ << lengths [0], lengths [1], lengths [2];
     }
 
     double fmodr( double x, double y)
@@ -186,16 +195,56 @@ namespace hpp {
       return fmodr( theta, 2 * M_PI );
     }
 
+    namespace {
+      /// Extract the planar pose (x, y, theta) from a configuration
+      inline vector3_t planarPose (ConfigurationIn_t q, size_type xyId,
+                                   size_type rzId)
+      {
+        vector3_t res;
+        res [0] = q [xyId + 0];
+        res [1] = q [xyId + 1];
+        res [2] = atan2 (q [rzId + 1], q [rzId + 0]);
+        return res;
+      }
+
+      /// Express the goal pose in the frame of the line joining the poses
+      inline void normalise (const vector3_t& q0, const vector3_t& q1,
+                             value_type rho, double& alpha, double& beta,
+                             double& d)
+      {
+        double dx = q1[0] - q0[0];
+        double dy = q1[1] - q0[1];
+        double D = sqrt( dx * dx + dy * dy );
+        d = D / rho;
+        double theta = mod2pi(atan2( dy, dx ));
+        alpha = mod2pi(q0[2] - theta);
+        beta  = mod2pi(q1[2] - theta);
+      }
+    } // namespace
+
+    value_type DubinsPath::curveLength (ConfigurationIn_t init,
+                                        ConfigurationIn_t end,
+                                        const value_type& rho,
+                                        size_type xyId, size_type rzId)
+    {
+      double alpha, beta, d;
+      normalise (planarPose (init, xyId, rzId), planarPose (end, xyId, rzId),
+                 rho, alpha, beta, d);
+      double lengths [3];
+      std::size_t typeId;
+      if (!shortestWord (alpha, beta, d, lengths, typeId)) {
+        hppDout (error, "Failed to build Dubins path between " <<
+		 init.transpose () << " and " << end.transpose () << ".");
+        throw std::logic_error ("Failed to build Dubins path");
+      }
+      return rho * (lengths [0] + lengths [1] + lengths [2]);
+    }
+
     void DubinsPath::dubins_init (vector3_t q0, vector3_t q1)
     {
       int i;
-      double dx = q1[0] - q0[0];
-      double dy = q1[1] - q0[1];
-      double D = sqrt( dx * dx + dy * dy );
-      double d = D / rho_;
-      double theta = mod2pi(atan2( dy, dx ));
-      double alpha = mod2pi(q0[2] - theta);
-      double beta  = mod2pi(q1[2] - theta);
+      double alpha, beta, d;
+      normalise (q0, q1, rho_, alpha, beta, d);
       for( i = 0; i < 3; i ++ ) {
         qi_ [i] = q0 [i];
       }
@@ -0,0 +1,417 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/executor.hh>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <hpp/util/exception-factory.hh>
+
+#ifdef __linux__
+# include <dirent.h>
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+namespace hpp {
+  namespace core {
+    namespace {
+      /// Tasks of one call to Executor::run
+      struct Batch
+      {
+        boost::mutex mutex;
+        boost::condition_variable done;
+        std::size_t remaining;
+        bool failed;
+        std::string error;
+      }; // struct Batch
+
+      struct Item
+      {
+        Executor::Task_t task;
+        Batch* batch;
+      }; // struct Item
+
+      struct Queue
+      {
+        boost::mutex mutex;
+        std::deque <Item> items;
+      }; // struct Queue
+
+      void execute (const Item& item)
+      {
+        Batch& batch (*item.batch);
+        bool failed (false);
+        std::string error;
+        try {
+          item.task ();
+        } catch (const std::exception& exc) {
+          failed = true;
+          error = exc.what ();
+        } catch (...) {
+          failed = true;
+          error = "unknown exception";
+        }
+        // The batch may be destroyed as soon as the lock is released.
+        boost::mutex::scoped_lock lock (batch.mutex);
+        if (failed && !batch.failed) {
+          batch.failed = true;
+          batch.error = error;
+        }
+        if (--batch.remaining == 0) batch.done.notify_all ();
+      }
+
+      /// Run the calling thread on one processor only
+      void pin (int cpu)
+      {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO (&cpus);
+        CPU_SET (cpu, &cpus);
+        pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t), &cpus);
+#else
+        (void) cpu;
+#endif
+      }
+
+      /// Parse a list of processors such as "0-3,8,10-11"
+      std::vector <int> parseCpuList (const std::string& list)
+      {
+        std::vector <int> cpus;
+        std::istringstream stream (list);
+        std::string range;
+        while (std::getline (stream, range, ',')) {
+          if (range.empty ()) continue;
+          const std::string::size_type dash (range.find ('-'));
+          const int first (std::atoi (range.substr (0, dash).c_str ()));
+          const int last (dash == std::string::npos ? first :
+                          std::atoi (range.substr (dash + 1).c_str ()));
+          for (int cpu = first; cpu <= last; ++cpu) cpus.push_back (cpu);
+        }
+        return cpus;
+      }
+
+      /// Processors of each NUMA node of the system
+      ///
+      /// Nodes are read in /sys/devices/system/node. If the directory
+      /// cannot be read, all the processors belong to one node.
+      std::vector <std::vector <int> > readNodes ()
+      {
+        std::vector <std::vector <int> > nodes;
+#ifdef __linux__
+        DIR* directory (opendir ("/sys/devices/system/node"));
+        if (directory) {
+          std::vector <int> ids;
+          for (struct dirent* entry = readdir (directory); entry;
+               entry = readdir (directory)) {
+            if (std::strncmp (entry->d_name, "node", 4) == 0 &&
+                std::isdigit ((unsigned char) entry->d_name [4]))
+              ids.push_back (std::atoi (entry->d_name + 4));
+          }
+          closedir (directory);
+          std::sort (ids.begin (), ids.end ());
+          for (std::size_t i = 0; i < ids.size (); ++i) {
+            std::ostringstream filename;
+            filename << "/sys/devices/system/node/node" << ids [i]
+                     << "/cpulist";
+            std::ifstream file (filename.str ().c_str ());
+            std::string list;
+            std::getline (file, list);
+            const std::vector <int> cpus (parseCpuList (list));
+            if (!cpus.empty ()) nodes.push_back (cpus);
+          }
+        }
+#endif
+        if (nodes.empty ()) {
+          nodes.resize (1);
+          const int n ((int) std::max
+                       (1u, boost::thread::hardware_concurrency ()));
+          for (int cpu = 0; cpu < n; ++cpu) nodes [0].push_back (cpu);
+        }
+        return nodes;
+      }
+    } // namespace
+
+    struct Executor::Impl
+    {
+      typedef std::vector <std::size_t> Ranks_t;
+
+      Impl (std::size_t numberThreads, bool pinning) :
+        queues (numberThreads), workerNode (numberThreads, 0),
+        workerCpu (numberThreads, -1), stealOrder (numberThreads),
+        pending (0), next (0), started (false), stop (false)
+      {
+        for (std::size_t i = 0; i < queues.size (); ++i) {
+          queues [i].reset (new Queue);
+          allWorkers.push_back (i);
+        }
+        const std::vector <std::vector <int> > nodes
+          (pinning ? readNodes () : std::vector <std::vector <int> > (1));
+        const std::size_t numberNodes (std::min (nodes.size (),
+                                                 numberThreads));
+        nodeWorkers.resize (numberNodes);
+        nextOfNode.resize (numberNodes, 0);
+        for (std::size_t i = 0; i < numberThreads; ++i) {
+          const std::size_t node (i % numberNodes);
+          workerNode [i] = node;
+          nodeWorkers [node].push_back (i);
+          if (pinning) {
+            const std::vector <int>& cpus (nodes [node]);
+            workerCpu [i] = cpus [(i / numberNodes) % cpus.size ()];
+          }
+        }
+        for (std::size_t node = 0; node < numberNodes && pinning; ++node) {
+          for (std::size_t k = 0; k < nodes [node].size (); ++k) {
+            const std::size_t cpu ((std::size_t) nodes [node][k]);
+            if (cpuNode.size () <= cpu) cpuNode.resize (cpu + 1, 0);
+            cpuNode [cpu] = node;
+          }
+        }
+        // Threads steal from the threads of their node first.
+        for (std::size_t i = 0; i < numberThreads; ++i) {
+          const Ranks_t& local (nodeWorkers [workerNode [i]]);
+          const std::size_t position (std::find (local.begin (), local.end (),
+                                                 i) - local.begin ());
+          for (std::size_t k = 0; k < local.size (); ++k)
+            stealOrder [i].push_back (local [(position + k) % local.size ()]);
+          for (std::size_t k = 1; k < numberThreads; ++k) {
+            const std::size_t j ((i + k) % numberThreads);
+            if (workerNode [j] != workerNode [i]) stealOrder [i].push_back (j);
+          }
+        }
+      }
+
+      /// Rank of the calling thread in the pool, or a null pointer
+      const std::size_t* rank () const
+      {
+        return workerRank.get ();
+      }
+
+      /// Pop a task of the queues, in a given order
+      /// \param own whether the first queue belongs to the calling thread,
+      ///        which pops its last task. The first task of the other
+      ///        queues is stolen.
+      bool pop (const Ranks_t& order, bool own, Item& item)
+      {
+        for (std::size_t k = 0; k < order.size (); ++k) {
+          Queue& queue (*queues [order [k]]);
+          boost::mutex::scoped_lock lock (queue.mutex);
+          if (queue.items.empty ()) continue;
+          if (own && k == 0) {
+            item = queue.items.back ();
+            queue.items.pop_back ();
+          } else {
+            item = queue.items.front ();
+            queue.items.pop_front ();
+          }
+          lock.unlock ();
+          boost::mutex::scoped_lock pendingLock (mutex);
+          --pending;
+          return true;
+        }
+        return false;
+      }
+
+      /// Pop a task for the calling thread
+      bool pop (Item& item)
+      {
+        const std::size_t* r (rank ());
+        if (r) return pop (stealOrder [*r], true, item);
+        return pop (allWorkers, false, item);
+      }
+
+      void work (std::size_t r)
+      {
+        workerRank.reset (new std::size_t (r));
+        if (workerCpu [r] >= 0) pin (workerCpu [r]);
+        Item item;
+        while (true) {
+          if (pop (stealOrder [r], true, item)) {
+            execute (item);
+            continue;
+          }
+          boost::mutex::scoped_lock lock (mutex);
+          while (!stop && pending == 0) wake.wait (lock);
+          if (stop && pending == 0) return;
+        }
+      }
+
+      /// Queue tasks to the threads of a node, or to all the threads if
+      /// node is negative
+      void push (const Tasks_t& tasks, Batch& batch, size_type node)
+      {
+        boost::mutex::scoped_lock lock (mutex);
+        if (!started) {
+          for (std::size_t i = 0; i < queues.size (); ++i)
+            threads.create_thread (boost::bind (&Impl::work, this, i));
+          started = true;
+        }
+        const Ranks_t& workers (node < 0 ? allWorkers :
+                                nodeWorkers [(std::size_t) node]);
+        std::size_t& position (node < 0 ? next :
+                               nextOfNode [(std::size_t) node]);
+        for (std::size_t i = 0; i < tasks.size (); ++i) {
+          Item item;
+          item.task = tasks [i];
+          item.batch = &batch;
+          Queue& queue (*queues [workers [position]]);
+          position = (position + 1) % workers.size ();
+          boost::mutex::scoped_lock queueLock (queue.mutex);
+          queue.items.push_back (item);
+        }
+        pending += tasks.size ();
+        wake.notify_all ();
+      }
+
+      /// Wait for the end of the tasks of a batch
+      /// \param help whether the calling thread runs queued tasks.
+      void wait (Batch& batch, bool help)
+      {
+        Item item;
+        while (help) {
+          {
+            boost::mutex::scoped_lock lock (batch.mutex);
+            if (batch.remaining == 0) break;
+          }
+          if (!pop (item)) break;
+          execute (item);
+        }
+        boost::mutex::scoped_lock lock (batch.mutex);
+        while (batch.remaining != 0) batch.done.wait (lock);
+      }
+
+      std::vector <boost::shared_ptr <Queue> > queues;
+      /// NUMA node and processor of each thread, -1 if not pinned
+      Ranks_t workerNode;
+      std::vector <int> workerCpu;
+      /// Order in which each thread pops the queues
+      std::vector <Ranks_t> stealOrder;
+      Ranks_t allWorkers;
+      /// Threads of each node
+      std::vector <Ranks_t> nodeWorkers;
+      /// Node of each processor
+      Ranks_t cpuNode;
+      boost::thread_specific_ptr <std::size_t> workerRank;
+      /// Protects pending, next, nextOfNode, started and stop
+      boost::mutex mutex;
+      boost::condition_variable wake;
+      /// Number of tasks in the queues
+      std::size_t pending;
+      /// Thread of the next task, among all threads or among the threads
+      /// of each node
+      std::size_t next;
+      Ranks_t nextOfNode;
+      bool started, stop;
+      boost::thread_group threads;
+    }; // struct Executor::Impl
+
+    ExecutorPtr_t Executor::create (size_type numberThreads, bool pinning)
+    {
+      if (numberThreads < 1)
+        throw std::invalid_argument ("Number of threads should be at least 1");
+      return ExecutorPtr_t (new Executor (numberThreads, pinning));
+    }
+
+    Executor::Executor (size_type numberThreads, bool pinning) :
+      numberThreads_ (numberThreads), pinning_ (pinning),
+      impl_ (new Impl ((std::size_t) numberThreads, pinning))
+    {
+    }
+
+    Executor::~Executor ()
+    {
+      {
+        boost::mutex::scoped_lock lock (impl_->mutex);
+        impl_->stop = true;
+        impl_->wake.notify_all ();
+      }
+      impl_->threads.join_all ();
+    }
+
+    size_type Executor::numberNodes () const
+    {
+      return (size_type) impl_->nodeWorkers.size ();
+    }
+
+    size_type Executor::node () const
+    {
+      const std::size_t* rank (impl_->rank ());
+      if (rank) return (size_type) impl_->workerNode [*rank];
+#ifdef __linux__
+      const int cpu (sched_getcpu ());
+      if (cpu >= 0 && (std::size_t) cpu < impl_->cpuNode.size ())
+        return (size_type) impl_->cpuNode [(std::size_t) cpu];
+#endif
+      return 0;
+    }
+
+    void Executor::run (const ExecutorPtr_t& executor, const Tasks_t& tasks)
+    {
+      if (executor) {
+        executor->run (tasks);
+        return;
+      }
+      boost::thread_group threads;
+      for (std::size_t i = 0; i < tasks.size (); ++i)
+        threads.create_thread (tasks [i]);
+      threads.join_all ();
+    }
+
+    void Executor::run (const Tasks_t& tasks)
+    {
+      if (tasks.empty ()) return;
+      Batch batch;
+      batch.remaining = tasks.size ();
+      batch.failed = false;
+      const std::size_t* rank (impl_->rank ());
+      impl_->push (tasks, batch, rank ?
+                   (size_type) impl_->workerNode [*rank] : -1);
+      impl_->wait (batch, true);
+      if (batch.failed) throw std::runtime_error (batch.error);
+    }
+
+    void Executor::run (const Tasks_t& tasks, size_type node)
+    {
+      if (node < 0 || node >= numberNodes ()) {
+        HPP_THROW (std::invalid_argument, "Executor has " << numberNodes ()
+                   << " NUMA nodes, node " << node << " does not exist.");
+      }
+      if (tasks.empty ()) return;
+      Batch batch;
+      batch.remaining = tasks.size ();
+      batch.failed = false;
+      impl_->push (tasks, batch, node);
+      impl_->wait (batch, impl_->rank () != 0x0);
+      if (batch.failed) throw std::runtime_error (batch.error);
+    }
+  } //   namespace core
+} // namespace hpp
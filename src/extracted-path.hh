@@ -20,6 +20,7 @@
 # define HPP_CORE_EXTRACTED_PATH_HH
 
 # include <hpp/core/path.hh>
+# include <hpp/core/pooled-allocation.hh>
 
 namespace hpp {
   namespace core {
@@ -30,6 +31,8 @@ namespace hpp {
     public:
       typedef Path parent_t;
 
+      HPP_CORE_POOLED_ALLOCATION (ExtractedPath)
+
       virtual ~ExtractedPath () {}
 
       /// Return a shared pointer to a copy of this
@@ -47,9 +50,19 @@ namespace hpp {
 	return createCopy (weak_.lock (), constraints);
       }
 
+      /// Create a window over a path
+      ///
+      /// Extractions of an extracted path are collapsed into one window
+      /// over the original path, so that evaluation goes through one
+      /// decorator only.
       static ExtractedPathPtr_t
       create (const PathPtr_t& original, const interval_t& subInterval)
       {
+        ExtractedPathPtr_t extracted
+          (HPP_DYNAMIC_PTR_CAST (ExtractedPath, original));
+        if (extracted)
+          return HPP_STATIC_PTR_CAST (ExtractedPath,
+                                      extracted->impl_extract (subInterval));
 	ExtractedPath* ptr = new ExtractedPath (original, subInterval);
 	ExtractedPathPtr_t shPtr (ptr);
 	ptr->init (shPtr);
@@ -86,8 +99,7 @@ namespace hpp {
 				    size_type order) const
       {
 	if (reversed_) {
-	  value_type param = (paramRange ().second - s);
-	  original_->impl_derivative (result, param, order);
+	  original_->impl_derivative (result, sInOriginalPath (s), order);
 	  if (order % 2 == 1) result *= -1.;
 	} else {
 	  original_->impl_derivative (result, s, order);
@@ -112,6 +124,18 @@ namespace hpp {
 	return path;
       }
 
+      /// Path the window is extracted from
+      const PathPtr_t& original () const
+      {
+        return original_;
+      }
+
+      /// Whether the window of the original path is run backward
+      bool reversed () const
+      {
+        return reversed_;
+      }
+
       /// Get the initial configuration
       inline Configuration_t initial () const
       {
@@ -183,17 +207,22 @@ namespace hpp {
 	weak_ = self;
       }
 
+      ExtractedPath () : reversed_ (false) {}
+
     private:
       inline value_type sInOriginalPath (const value_type& s) const
       {
         assert (paramRange().first <= s && s <= paramRange().second);
         if (!reversed_) return s;
-        return paramRange().second - s;
+        // The window [first, second] of the original path is run backward.
+        return paramRange().first + paramRange().second - s;
       }
 
       PathPtr_t original_;
       bool reversed_;
       ExtractedPathWkPtr_t weak_;
+
+      HPP_SERIALIZABLE();
     };
   } //   namespace core
 } // namespace hpp
@@ -0,0 +1,40 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include "forward-kinematics.hh"
+
+#include <pinocchio/algorithm/geometry.hpp>
+#include <pinocchio/algorithm/kinematics.hpp>
+
+namespace hpp {
+  namespace core {
+    void computeGeometryPlacements (pinocchio::DeviceSync& device,
+                                    ConfigurationIn_t config)
+    {
+      // Setting the configuration marks the kinematics of the device data
+      // as out of date: computing them through the device later computes
+      // what its flag requests.
+      device.currentConfiguration (config);
+      ::pinocchio::forwardKinematics (device.model (), device.data (),
+                                      config);
+      ::pinocchio::updateGeometryPlacements (device.model (), device.data (),
+                                             device.geomModel (),
+                                             device.geomData ());
+    }
+  } // namespace core
+} // namespace hpp
@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_FORWARD_KINEMATICS_HH
+# define HPP_CORE_FORWARD_KINEMATICS_HH
+
+# include <hpp/pinocchio/device-sync.hh>
+
+# include <hpp/core/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    /// Compute the placements of the joints and of the geometries of a
+    /// robot
+    ///
+    /// Only the placements of the joints, at order zero, and of the
+    /// geometries are computed, whatever the computation flag of the
+    /// device: collision checks read nothing else, while the Jacobians and
+    /// the center of mass that the constraints request cost more than the
+    /// placements.
+    /// \param device locked device data, the configuration of which is set
+    ///        to config.
+    void computeGeometryPlacements (pinocchio::DeviceSync& device,
+                                    ConfigurationIn_t config);
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_FORWARD_KINEMATICS_HH
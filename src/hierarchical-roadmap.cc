@@ -0,0 +1,289 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/hierarchical-roadmap.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include <pinocchio/multibody/model.hpp>
+
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/core/config-validations.hh>
+#include <hpp/core/configuration-shooter.hh>
+#include <hpp/core/connected-component.hh>
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/path-projector.hh>
+#include <hpp/core/path-validation.hh>
+#include <hpp/core/path-validation-report.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/random-generator.hh>
+#include <hpp/core/roadmap.hh>
+#include <hpp/core/steering-method.hh>
+
+#include "astar.hh"
+
+namespace hpp {
+  namespace core {
+    namespace {
+      /// Distance between the centers of two regions
+      value_type gridDistance (const HierarchicalRoadmap::Region_t& r1,
+                               const HierarchicalRoadmap::Region_t& r2,
+                               value_type regionSize)
+      {
+        const value_type dx ((value_type) (r2.first - r1.first)),
+          dy ((value_type) (r2.second - r1.second));
+        return regionSize * std::sqrt (dx * dx + dy * dy);
+      }
+    } // namespace
+
+    HierarchicalRoadmapPtr_t HierarchicalRoadmap::create
+    (const Problem& problem, value_type regionSize)
+    {
+      return HierarchicalRoadmapPtr_t (new HierarchicalRoadmap
+                                       (problem, regionSize));
+    }
+
+    HierarchicalRoadmap::HierarchicalRoadmap (const Problem& problem,
+                                              value_type regionSize) :
+      problem_ (problem), regionSize_ (regionSize), samplesPerRegion_ (20),
+      numberNeighbors_ (10), maxRegions_ (256), maxRoutes_ (10),
+      roadmap_ (), nodes_ (), forbidden_ ()
+    {
+      if (regionSize <= 0)
+        throw std::invalid_argument ("HierarchicalRoadmap: the size of the "
+                                     "regions should be positive.");
+      const DevicePtr_t& robot (problem.robot ());
+      if (robot->configSize () < 2)
+        throw std::invalid_argument ("HierarchicalRoadmap: the robot should "
+                                     "have at least two configuration "
+                                     "variables.");
+      const pinocchio::Model& model (robot->model ());
+      for (std::size_t axis = 0; axis < 2; ++axis) {
+        lower_ [axis] = model.lowerPositionLimit [axis];
+        upper_ [axis] = model.upperPositionLimit [axis];
+        if (!(std::abs (lower_ [axis]) <
+              std::numeric_limits <value_type>::infinity ()) ||
+            !(std::abs (upper_ [axis]) <
+              std::numeric_limits <value_type>::infinity ()))
+          throw std::invalid_argument ("HierarchicalRoadmap: the bounds of "
+                                       "the base should be finite.");
+      }
+      roadmap_ = Roadmap::create (problem.distance (), robot);
+    }
+
+    HierarchicalRoadmap::Region_t HierarchicalRoadmap::region
+    (const Configuration_t& configuration) const
+    {
+      return Region_t
+        ((size_type) std::floor (configuration [0] / regionSize_),
+         (size_type) std::floor (configuration [1] / regionSize_));
+    }
+
+    bool HierarchicalRoadmap::inBounds (const Region_t& region) const
+    {
+      const size_type indices [2] = { region.first, region.second };
+      for (std::size_t axis = 0; axis < 2; ++axis) {
+        if ((value_type) (indices [axis] + 1) * regionSize_ <=
+            lower_ [axis] ||
+            (value_type) indices [axis] * regionSize_ > upper_ [axis])
+          return false;
+      }
+      return true;
+    }
+
+    HierarchicalRoadmap::Regions_t HierarchicalRoadmap::route
+    (const Region_t& start, const Region_t& goal) const
+    {
+      typedef std::pair <value_type, Region_t> CostAndRegion_t;
+      typedef std::priority_queue <CostAndRegion_t,
+                                   std::vector <CostAndRegion_t>,
+                                   std::greater <CostAndRegion_t> > Queue_t;
+      Regions_t result;
+      if (!inBounds (start) || !inBounds (goal)) return result;
+      std::map <Region_t, value_type> costs;
+      std::map <Region_t, Region_t> parents;
+      std::set <Region_t> closed;
+      Queue_t open;
+      costs [start] = 0;
+      open.push (CostAndRegion_t (gridDistance (start, goal, regionSize_),
+                                  start));
+      while (!open.empty ()) {
+        const Region_t current (open.top ().second);
+        open.pop ();
+        if (!closed.insert (current).second) continue;
+        if (current == goal) {
+          for (Region_t r (goal); r != start; r = parents [r])
+            result.push_back (r);
+          result.push_back (start);
+          std::reverse (result.begin (), result.end ());
+          return result;
+        }
+        const value_type cost (costs [current]);
+        for (size_type dx = -1; dx <= 1; ++dx) {
+          for (size_type dy = -1; dy <= 1; ++dy) {
+            if (dx == 0 && dy == 0) continue;
+            const Region_t next (current.first + dx, current.second + dy);
+            if (!inBounds (next) || closed.count (next) ||
+                forbidden (current, next)) continue;
+            const value_type c
+              (cost + gridDistance (current, next, regionSize_));
+            std::map <Region_t, value_type>::iterator it (costs.find (next));
+            if (it != costs.end () && it->second <= c) continue;
+            costs [next] = c;
+            parents [next] = current;
+            open.push (CostAndRegion_t
+                       (c + gridDistance (next, goal, regionSize_), next));
+          }
+        }
+      }
+      return result;
+    }
+
+    PathPtr_t HierarchicalRoadmap::validate (const PathPtr_t& path) const
+    {
+      PathProjectorPtr_t pathProjector (problem_.pathProjector ());
+      PathValidationPtr_t pathValidation (problem_.pathValidation ());
+      PathPtr_t projected, validPart;
+      PathValidationReportPtr_t report;
+      if (pathProjector) {
+        if (!pathProjector->apply (path, projected)) return PathPtr_t ();
+      } else {
+        projected = path;
+      }
+      if (!pathValidation->validate (projected, false, validPart, report))
+        return PathPtr_t ();
+      return projected;
+    }
+
+    NodePtr_t HierarchicalRoadmap::insert
+    (const Configuration_t& configuration)
+    {
+      const std::size_t n (roadmap_->nodes ().size ());
+      NodePtr_t node (roadmap_->addNode (configuration));
+      // The configuration is already in the roadmap.
+      if (roadmap_->nodes ().size () == n) return node;
+      const Configuration_t& q (*node->configuration ());
+      const SteeringMethod& sm (*problem_.steeringMethod ());
+      const Nodes_t near (roadmap_->nearestNodes (q, numberNeighbors_ + 1));
+      for (Nodes_t::const_iterator it = near.begin (); it != near.end ();
+           ++it) {
+        if (*it == node) continue;
+        PathPtr_t path (sm (q, *(*it)->configuration ()));
+        if (!path) continue;
+        path = validate (path);
+        if (path) roadmap_->addEdges (node, *it, path);
+      }
+      return node;
+    }
+
+    void HierarchicalRoadmap::refine (const Region_t& region)
+    {
+      if (nodes_.count (region)) return;
+      NodeVector_t& nodes (nodes_ [region]);
+      const ConfigurationShooterPtr_t& shooter
+        (problem_.configurationShooter ());
+      RandomGenerator& random (*problem_.randomGenerator ());
+      const ConfigValidationsPtr_t& configValidations
+        (problem_.configValidations ());
+      const ConstraintSetPtr_t& constraints (problem_.constraints ());
+      const size_type indices [2] = { region.first, region.second };
+      value_type lower [2], upper [2];
+      for (std::size_t axis = 0; axis < 2; ++axis) {
+        lower [axis] = std::max (lower_ [axis],
+                                 (value_type) indices [axis] * regionSize_);
+        upper [axis] = std::min (upper_ [axis],
+                                 (value_type) (indices [axis] + 1) *
+                                 regionSize_);
+      }
+      Configuration_t q;
+      ValidationReportPtr_t report;
+      for (size_type i = 0; i < samplesPerRegion_; ++i) {
+        shooter->shoot (q);
+        q [0] = random.uniform (lower [0], upper [0]);
+        q [1] = random.uniform (lower [1], upper [1]);
+        if (constraints && !constraints->apply (q)) continue;
+        // Constraints may move the base out of the region.
+        if (this->region (q) != region) continue;
+        if (!configValidations->validate (q, report)) continue;
+        nodes.push_back (insert (q));
+      }
+    }
+
+    PathVectorPtr_t HierarchicalRoadmap::solve (const Configuration_t& start,
+                                                const Configuration_t& goal)
+    {
+      const Region_t from (region (start)), to (region (goal));
+      for (size_type attempt = 0; attempt < maxRoutes_; ++attempt) {
+        const Regions_t regions (route (from, to));
+        if (regions.empty ()) return PathVectorPtr_t ();
+
+        // Keep the number of refined regions bounded.
+        size_type missing (0);
+        for (Regions_t::const_iterator it = regions.begin ();
+             it != regions.end (); ++it)
+          if (!nodes_.count (*it)) ++missing;
+        if (!nodes_.empty () &&
+            (size_type) nodes_.size () + missing > maxRegions_) {
+          roadmap_->clear ();
+          nodes_.clear ();
+        }
+        for (Regions_t::const_iterator it = regions.begin ();
+             it != regions.end (); ++it)
+          refine (*it);
+
+        const NodePtr_t startNode (insert (start)), goalNode (insert (goal));
+        roadmap_->initNode (startNode->configuration ());
+        roadmap_->resetGoalNodes ();
+        roadmap_->addGoalNode (goalNode->configuration ());
+        if (roadmap_->pathExists ()) {
+          Astar astar (roadmap_, problem_.distance ());
+          PathVectorPtr_t path (PathVector::create
+                                (problem_.robot ()->configSize (),
+                                 problem_.robot ()->numberDof ()));
+          astar.solution (path);
+          return path;
+        }
+
+        // Forbid the first move of the route that the fine roadmap does
+        // not achieve, or the move to the goal region if all the regions
+        // are reached.
+        if (regions.size () == 1) return PathVectorPtr_t ();
+        const ConnectedComponentPtr_t cc (startNode->connectedComponent ());
+        std::size_t i (1);
+        for (; i + 1 < regions.size (); ++i) {
+          const NodeVector_t& nodes (nodes_ [regions [i]]);
+          bool reached (false);
+          for (NodeVector_t::const_iterator it = nodes.begin ();
+               !reached && it != nodes.end (); ++it)
+            reached = cc->canReach ((*it)->connectedComponent ());
+          if (!reached) break;
+        }
+        forbidden_.insert (Move_t (regions [i - 1], regions [i]));
+      }
+      return PathVectorPtr_t ();
+    }
+  } //   namespace core
+} // namespace hpp
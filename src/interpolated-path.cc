@@ -16,6 +16,8 @@
 
 #include <hpp/core/interpolated-path.hh>
 
+#include <algorithm>
+
 #include <hpp/util/debug.hh>
 
 #include <hpp/pinocchio/device.hh>
@@ -33,7 +35,7 @@ namespace hpp {
         interval_t timeRange) :
       parent_t (timeRange, device->configSize (),
 		device->numberDof ()),
-      device_ (device)
+      device_ (device), points_ (new Points)
     {
       assert (init.size() == device_->configSize ());
       insert (timeRange.first, init);
@@ -50,7 +52,7 @@ namespace hpp {
 				ConstraintSetPtr_t constraints) :
       parent_t (timeRange, device->configSize (),
 		device->numberDof (), constraints),
-      device_ (device)
+      device_ (device), points_ (new Points)
     {
       assert (init.size() == device_->configSize ());
       insert (timeRange.first, init);
@@ -63,7 +65,8 @@ namespace hpp {
                                         const DevicePtr_t& device,
                                         const std::size_t& nbSamples) :
       parent_t (path->timeRange(), device->configSize (),
-		device->numberDof (), path->constraints ()), device_ (device)
+		device->numberDof (), path->constraints ()), device_ (device),
+      points_ (new Points)
 
     {
       assert (path->initial ().size() == device_->configSize ());
@@ -84,7 +87,7 @@ namespace hpp {
     }
 
     InterpolatedPath::InterpolatedPath (const InterpolatedPath& path) :
-      parent_t (path), device_ (path.device_), configs_ (path.configs_)
+      parent_t (path), device_ (path.device_), points_ (path.points_)
     {
       assert (initial().size() == device_->configSize ());
     }
@@ -92,7 +95,7 @@ namespace hpp {
     InterpolatedPath::InterpolatedPath (const InterpolatedPath& path,
 				const ConstraintSetPtr_t& constraints) :
       parent_t (path, constraints), device_ (path.device_),
-      configs_ (path.configs_)
+      points_ (path.points_)
     {
     }
 
@@ -121,70 +124,84 @@ namespace hpp {
       checkPath ();
     }
 
+    void InterpolatedPath::insert (const value_type& time,
+                                   ConfigurationIn_t config)
+    {
+      assert (config.size () == outputSize ());
+      std::vector <value_type>::iterator it =
+        std::lower_bound (points_->times.begin (), points_->times.end (), time);
+      if (it != points_->times.end () && *it == time) return;
+      const std::size_t rank (it - points_->times.begin ());
+      // Points are shared by the copies of the path: copy them on write.
+      if (!points_.unique ()) points_.reset (new Points (*points_));
+      points_->times.insert (points_->times.begin () + rank, time);
+      points_->configs.insert (points_->configs.begin () + rank * outputSize (),
+                       config.data (), config.data () + config.size ());
+    }
+
+    InterpolatedPath::InterpolationPoints_t
+    InterpolatedPath::interpolationPoints () const
+    {
+      InterpolationPoints_t points;
+      for (std::size_t i = 0; i < points_->times.size (); ++i)
+        points.insert (points.end (), InterpolationPoint_t
+                       (points_->times [i], interpolationConfig (i)));
+      return points;
+    }
+
+    std::size_t InterpolatedPath::segmentAtParam (const value_type& param) const
+    {
+      assert (points_->times.size () >= 2);
+      std::size_t rank (std::upper_bound (points_->times.begin (), points_->times.end (),
+                                          param) - points_->times.begin ());
+      if (rank == 0) return 0;
+      return std::min (rank, points_->times.size () - 1) - 1;
+    }
+
     bool InterpolatedPath::impl_compute (ConfigurationOut_t result,
 				     value_type param) const
     {
       assert (param >= paramRange().first);
       if (param == paramRange ().first || paramLength() == 0) {
-	result.noalias () = initial();
+	result.noalias () = interpolationConfig (0);
 	return true;
       }
-      assert (fabs (configs_.rbegin()->first - paramRange ().second)
+      assert (fabs (points_->times.back () - paramRange ().second)
           < Eigen::NumTraits<value_type>::dummy_precision());
-      assert (param < configs_.rbegin()->first +
+      assert (param < points_->times.back () +
               Eigen::NumTraits<value_type>::dummy_precision());
-      if (param >= configs_.rbegin()->first) {
-	param = configs_.rbegin()->first;
-	result.noalias () = end();
+      if (param >= points_->times.back ()) {
+	result.noalias () = interpolationConfig (points_->times.size () - 1);
 	return true;
       }
-      InterpolationPoints_t::const_iterator itA = configs_.lower_bound (param);
-      assert (itA != configs_.end());
-      InterpolationPoints_t::const_iterator itB = itA; --itB;
-      const value_type T = itA->first - itB->first;
-      const value_type u = (param - itB->first) / T;
+      const std::size_t i (segmentAtParam (param));
+      const value_type T = points_->times [i+1] - points_->times [i];
+      const value_type u = (param - points_->times [i]) / T;
 
-      pinocchio::interpolate<hpp::pinocchio::RnxSOnLieGroupMap> (device_, itB->second, itA->second, u, result);
+      pinocchio::interpolate<hpp::pinocchio::RnxSOnLieGroupMap> (device_,
+          interpolationConfig (i), interpolationConfig (i+1), u, result);
       return true;
     }
 
     void InterpolatedPath::impl_derivative
     (vectorOut_t result, const value_type& s, size_type order) const
     {
-      value_type param (s);
-      assert (param >= paramRange().first);
+      assert (s >= paramRange().first);
       if (paramRange ().first == paramRange ().second) {
 	result.setZero ();
 	return;
       }
-      InterpolationPoints_t::const_iterator itA;
-      InterpolationPoints_t::const_iterator itB;
-      assert (fabs (configs_.rbegin()->first - paramRange ().second)
+      assert (fabs (points_->times.back () - paramRange ().second)
           < Eigen::NumTraits<value_type>::dummy_precision());
-      if (param >= configs_.rbegin()->first) {
-	param = configs_.rbegin()->first;
-        itA = configs_.end(); --itA;
-        itB = itA; --itB;
-      } else {
-        itA = configs_.upper_bound (param);
-        itB = configs_.lower_bound (param);
-        if (itB == itA) {
-          if (itB == configs_.begin ()) {
-            ++itA;
-          } else {
-            --itB;
-          }
-        }
-      }
-      assert (itA != configs_.end ());
-      const value_type T = itA->first - itB->first;
+      const std::size_t i (segmentAtParam (s));
+      const value_type T = points_->times [i+1] - points_->times [i];
       if (order > 1) {
 	result.setZero ();
 	return;
       }
       if (order == 1) {
 	pinocchio::difference <hpp::pinocchio::RnxSOnLieGroupMap>
-	  (device_, itA->second, itB->second, result);
+	  (device_, interpolationConfig (i+1), interpolationConfig (i), result);
 	result = (1/T) * result;
       }
     }
@@ -192,17 +209,14 @@ namespace hpp {
     void InterpolatedPath::impl_velocityBound (vectorOut_t result,
         const value_type& t0, const value_type& t1) const
     {
-      InterpolationPoints_t::const_iterator next = configs_.lower_bound (t0);
-      InterpolationPoints_t::const_iterator current = next; ++next;
-
       result.setZero();
       vector_t tmp (result.size());
-      while (t1 > current->first) {
+      for (std::size_t i = segmentAtParam (t0);
+           i + 1 < points_->times.size () && t1 > points_->times [i]; ++i) {
 	pinocchio::difference <hpp::pinocchio::RnxSOnLieGroupMap>
-	  (device_, next->second, current->second, tmp);
-        const value_type T = next->first - current->first;
+	  (device_, interpolationConfig (i+1), interpolationConfig (i), tmp);
+        const value_type T = points_->times [i+1] - points_->times [i];
         result.noalias() = result.cwiseMax(tmp.cwiseAbs() / T);
-        ++current; ++next;
       }
     }
 
@@ -231,13 +245,14 @@ namespace hpp {
       InterpolatedPathPtr_t result = InterpolatedPath::create (device_, q1, q2,
           l, constraints ());
 
-      InterpolationPoints_t::const_iterator it = configs_.upper_bound (tmin);
+      std::size_t i (std::upper_bound (points_->times.begin (), points_->times.end (), tmin)
+                     - points_->times.begin ());
       if (reverse)
-        for (; it->first < tmax; ++it)
-          result->insert (l - (it->first - tmin), it->second); 
+        for (; i < points_->times.size () && points_->times [i] < tmax; ++i)
+          result->insert (l - (points_->times [i] - tmin), interpolationConfig (i));
       else
-        for (; it->first < tmax; ++it)
-          result->insert (it->first - tmin, it->second); 
+        for (; i < points_->times.size () && points_->times [i] < tmax; ++i)
+          result->insert (points_->times [i] - tmin, interpolationConfig (i));
 
       return result;
     }
@@ -249,14 +264,8 @@ namespace hpp {
       InterpolatedPathPtr_t result =
         InterpolatedPath::create (device_, end(), initial(), l, constraints ());
 
-      if (configs_.size () > 2) {
-        InterpolationPoints_t::const_reverse_iterator it = configs_.rbegin();
-        ++it;
-        InterpolationPoints_t::const_reverse_iterator itEnd = configs_.rend();
-        --itEnd;
-        for (; it != itEnd; ++it)
-          result->insert (l - it->first, it->second); 
-      }
+      for (std::size_t i = points_->times.size () - 2; i > 0; --i)
+        result->insert (l - points_->times [i], interpolationConfig (i));
 
       return result;
     }
@@ -24,10 +24,35 @@
 
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/liegroup-space.hh>
+
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/path/spline.hh>
+#include <hpp/core/straight-path.hh>
 
 namespace hpp {
   namespace core {
     typedef pinocchio::JointConfiguration* JointConfigurationPtr_t;
+
+    namespace {
+      /// Control points of a spline in a vector space
+      ///
+      /// \tparam Spline_t spline in Bernstein basis of a robot whose
+      ///         configuration space is a vector space.
+      /// \retval points control points, one per column.
+      /// \return whether the path is of type Spline_t.
+      template <typename Spline_t>
+      bool controlPoints (const PathPtr_t& path, matrix_t& points)
+      {
+        typedef boost::shared_ptr <Spline_t> SplinePtr_t;
+        SplinePtr_t spline (HPP_DYNAMIC_PTR_CAST (Spline_t, path));
+        if (!spline) return false;
+        points = spline->parameters ().transpose ();
+        points.colwise () += spline->base ();
+        return true;
+      }
+    } // namespace
+
     JointBoundValidationPtr_t JointBoundValidation::create
     (const DevicePtr_t& robot)
     {
@@ -35,9 +60,54 @@ namespace hpp {
       return JointBoundValidationPtr_t (ptr);
     }
 
+    bool JointBoundValidation::withinBounds (ConfigurationIn_t config) const
+    {
+      const pinocchio::Model& model = robot_->model();
+      if ((config.head (model.nq).array () >
+           model.upperPositionLimit.array ()).any () ||
+          (config.head (model.nq).array () <
+           model.lowerPositionLimit.array ()).any ())
+        return false;
+      const pinocchio::ExtraConfigSpace& ecs = robot_->extraConfigSpace();
+      for (size_type i=0; i < ecs.dimension(); ++i) {
+        const value_type value = config [model.nq + i];
+        if (value < ecs.lower (i) || ecs.upper (i) < value) return false;
+      }
+      return true;
+    }
+
+    bool JointBoundValidation::certifies (const PathPtr_t& path) const
+    {
+      if (path->constraints ()) return false;
+      if (!robot_->configSpace ()->isVectorSpace ()) return false;
+      if (PathVectorPtr_t pv = HPP_DYNAMIC_PTR_CAST (PathVector, path)) {
+        for (std::size_t i = 0; i < pv->numberPaths (); ++i) {
+          if (!certifies (pv->pathAtRank (i))) return false;
+        }
+        return true;
+      }
+      if (StraightPathPtr_t sp = HPP_DYNAMIC_PTR_CAST (StraightPath, path)) {
+        return withinBounds (sp->initial ()) && withinBounds (sp->end ());
+      }
+      using path::BernsteinBasis;
+      matrix_t points;
+      if (!controlPoints <path::Spline <BernsteinBasis, 1> > (path, points) &&
+          !controlPoints <path::Spline <BernsteinBasis, 3> > (path, points) &&
+          !controlPoints <path::Spline <BernsteinBasis, 5> > (path, points))
+        return false;
+      // Splines lie in the convex hull of their control points.
+      for (size_type i = 0; i < points.cols (); ++i) {
+        if (!withinBounds (points.col (i))) return false;
+      }
+      return true;
+    }
+
     bool JointBoundValidation::validate
     (const Configuration_t& config, ValidationReportPtr_t& validationReport)
     {
+      // Most configurations are within bounds: check them at once and only
+      // look for the faulty rank otherwise.
+      if (withinBounds (config)) return true;
       const pinocchio::Model& model = robot_->model();
       // Check whether all config param are within boundaries.
       for (std::size_t i = 0; i < (std::size_t)model.nq; ++i) {
@@ -26,6 +26,8 @@
 #include <hpp/pinocchio/configuration.hh>
 #include <Eigen/SVD>
 
+#include "bang-bang.hh"
+
 namespace hpp {
 namespace core {
 
@@ -73,6 +75,7 @@ KinodynamicDistance::KinodynamicDistance (const DevicePtr_t& robot) :
     hppDout(warning,"Kinodynamic distance create from robot, cannot access user-defined velocity and acceleration bounds. Use default values");
     aMax_ = 10.;
     vMax_ = 1.;
+    computeBounds ();
 }
 
 KinodynamicDistance::KinodynamicDistance (const Problem& problem) :
@@ -84,131 +87,90 @@ KinodynamicDistance::KinodynamicDistance (const Problem& problem) :
     }
     aMax_=problem.getParameter(std::string("Kinodynamic/accelerationBound")).floatValue();
     vMax_ = problem.getParameter(std::string("Kinodynamic/velocityBound")).floatValue();
+    computeBounds ();
 }
 
 
 
 KinodynamicDistance::KinodynamicDistance (const KinodynamicDistance& distance) :
-    robot_ (distance.robot_)
+    robot_ (distance.robot_), aMax_ (distance.aMax_), vMax_ (distance.vMax_),
+    aMax3_ (distance.aMax3_), vMax3_ (distance.vMax3_),
+    invAMax3_ (distance.invAMax3_), invVMax3_ (distance.invVMax3_)
 {
 }
 
-void KinodynamicDistance::init (KinodynamicDistanceWkPtr_t self)
+void KinodynamicDistance::computeBounds ()
 {
-    weak_ = self;
-}
-
-inline double sgnenum(double val) {
-  return ((0. < val ) - (val < 0.));
+    aMax3_.setConstant (aMax_);
+    vMax3_.setConstant (vMax_);
+    invAMax3_.setConstant (1. / aMax_);
+    invVMax3_.setConstant (1. / vMax_);
 }
 
-inline int sgn(double d)  {
-  return d >= 0.0 ? 1 : -1;
-}
-
-inline double sgnf(double d)  {
-  return d >= 0.0 ? 1.0 : -1.0;
+void KinodynamicDistance::init (KinodynamicDistanceWkPtr_t self)
+{
+    weak_ = self;
 }
 
 double KinodynamicDistance::computeMinTime(double p1, double p2, double v1, double v2) const{
-  //hppDout(info,"p1 = "<<p1<<"  p2 = "<<p2<<"   ; v1 = "<<v1<<"    v2 = "<<v2);
-  // compute the sign of each acceleration
-  double t1,t2,tv;
-  int sigma;
-  double deltaPacc = 0.5*(v1+v2)*(fabs(v2-v1)/aMax_);
-  sigma = sgn(p2-p1-deltaPacc);
-  //hppDout(info,"sigma = "<<sigma);
-  if(sigma == 0){
-    sigma = sgn(p2-p1);
-    //hppDout(info,"sigma Bis= "<<sigma);
-  }
-  double a1 = (sigma)*aMax_;
-  double a2 = -a1;
-  double vLim = (sigma) * vMax_;
-  //hppDout(info,"Vlim = "<<vLim<<"   ;  aMax = "<<aMax_);
-  if(fabs(p2-p1) < (std::numeric_limits<double>::epsilon()*100.) && fabs(v2-v1)<(std::numeric_limits<double>::epsilon()*100.) ){
-    //hppDout(notice,"No movement in this joints, abort.");
-    return 0.;
-  }
-  // test if two segment trajectory is valid :
-  bool twoSegment = false;
-
-  // solve quadratic equation (cf eq 13 article)
-  const double a = a1;
-  const double b = 2. * v1;
-  const double c = (0.5*(v1+v2)*(v2-v1)/a2) - (p2-p1);
-
-  const double q = -0.5*(b+sgnf(b)*sqrt(b*b-4*a*c));
-  //hppDout(info, "sign of "<<b<<" is : "<<sgnf(b));
-  const double x1 = q/a;
-  const double x2 = c/q;
-  const double x = std::max(x1,x2);
-  //hppDout(info,"Solve quadratic equation : x1 = "<<x1<<"  ; x2 = "<<x2);
-  //hppDout(info," x = "<<x);
-  //hppDout(info,"t1 before vel limit = "<<x);
-
-  //hppDout(info,"inf bound on t1 (from t2 > 0) "<<-((v2-v1)/a2));
-  double minT1 = std::max(0.,-((v2-v1)/a2));  //lower bound for valid t1 value (cf eq 14)
-
-
-  if(x >= minT1){
-    twoSegment = true;
-    t1 = x;
-    //hppDout(info,"t1 >= minT1");
-  }
-  if(twoSegment){ // check if max velocity is respected
-    if(std::abs(v1+(t1)*a1) > vMax_){
-      twoSegment = false;
-      //hppDout(info,"Doesn't respect max velocity, need 3 segments");
-    }
-  }
-  if(twoSegment){ // compute t2 for two segment trajectory
-    tv = 0.;
-    t2 = ((v2-v1)/a2) + (t1);// eq 14
-  }else{// compute 3 segment trajectory, with constant velocity phase :
-    t1 = (vLim - v1)/a1;  //eq 15
-    tv = ((v1*v1+v2*v2 - 2*vLim*vLim)/(2*vLim*a1)) + (p2-p1)/vLim ; //eq 16
-    t2 = (v2-vLim)/a2;  //eq 17
-  }
-  /*
-  if(twoSegment){
-    hppDout(notice,"Trajectory with 2 segments");
-  }else{
-    hppDout(notice,"Trajectory with 3 segments");
-  }
-  */
-  //hppDout(notice,"a1 = "<<a1<<"  ;  a2 ="<<a2);
-  //hppDout(notice,"t = "<<(t1)<<"   ;   "<<(tv)<<"   ;   "<<(t2));
-  //double T = (t1)+(tv)+(t2);
-  //hppDout(notice,"T = "<<T);
-  return (t1)+(tv)+(t2);
+  typedef Eigen::Array<value_type, 1, 1> Array1;
+  Array1 sigma;
+  Eigen::Array<bool, 1, 1> twoSegment;
+  return bangBang::minimalTimes<1>
+    (Array1::Constant(p1), Array1::Constant(p2), Array1::Constant(v1),
+     Array1::Constant(v2), Array1::Constant(aMax_), Array1::Constant(vMax_),
+     sigma, twoSegment)[0];
 }
 
 value_type KinodynamicDistance::impl_distance (ConfigurationIn_t q1,
                                                ConfigurationIn_t q2) const
 {
-    double Tmax = 0;
-    double T = 0;
+    size_type configSize = robot_->configSize() - robot_->extraConfigSpace().dimension ();
+    // FIX ME : only work with freeflyer
+    Array3 sigma;
+    Eigen::Array<bool, 3, 1> twoSegment;
+    Array3 T = bangBang::minimalTimes<3>
+      (q1.head<3>().array(), q2.head<3>().array(),
+       q1.segment<3>(configSize).array(), q2.segment<3>(configSize).array(),
+       aMax3_, vMax3_, invAMax3_, invVMax3_, sigma, twoSegment);
+    return std::max(0., T.maxCoeff());
+}
 
+value_type KinodynamicDistance::impl_lowerBound (ConfigurationIn_t q1,
+                                                 ConfigurationIn_t q2) const
+{
     size_type configSize = robot_->configSize() - robot_->extraConfigSpace().dimension ();
-    // looking for Tmax
-    //hppDout(notice,"KinodynamicDistance :  Looking for Tmax :");
-   // hppDout(info,"Distance between : "<<pinocchio::displayConfig(q1));
-    //hppDout(info,"and              : "<<pinocchio::displayConfig(q2));
+    // FIX ME : only work with freeflyer
+    const Array3 dp ((q2.head<3>() - q1.head<3>()).array().abs()),
+      dv ((q2.segment<3>(configSize) - q1.segment<3>(configSize)).array().abs());
+    return (dp * invVMax3_).max (dv * invAMax3_).maxCoeff();
+}
 
+void KinodynamicDistance::impl_distances (matrixIn_t configurations,
+                                          ConfigurationIn_t q,
+                                          vector_t& distances) const
+{
+    typedef Eigen::Array<value_type, Eigen::Dynamic, 1> Array_t;
+    size_type configSize = robot_->configSize() - robot_->extraConfigSpace().dimension ();
+    size_type n = configurations.cols ();
+    // Solve one axis for all the configurations at once.
+    const Array_t aMax (Array_t::Constant(n, aMax_));
+    const Array_t vMax (Array_t::Constant(n, vMax_));
+    const Array_t invAMax (Array_t::Constant(n, invAMax3_[0]));
+    const Array_t invVMax (Array_t::Constant(n, invVMax3_[0]));
+    Array_t sigma (n), T (n);
+    Eigen::Array<bool, Eigen::Dynamic, 1> twoSegment (n);
+    distances.setZero (n);
     for(int indexConfig = 0 ; indexConfig < 3 ; indexConfig++){// FIX ME : only work with freeflyer
-        //hppDout(notice,"For joint :"<<robot_->getJointAtConfigRank(indexConfig)->name());
-        //if(robot_->getJointAtConfigRank(indexConfig)->name() != "base_joint_SO3" true){
-            T = computeMinTime(q1[indexConfig],q2[indexConfig],q1[indexConfig + configSize],q2[indexConfig + configSize]);
-            if(T > Tmax)
-                Tmax = T;
-        /*}else{
-            hppDout(notice,"!! Kinodynamic distance for quaternion not implemented yet.");
-        }*/
-
+        size_type indexVel = indexConfig + configSize;
+        T = bangBang::minimalTimes<Eigen::Dynamic>
+          (configurations.row(indexConfig).transpose().array(),
+           Array_t::Constant(n, q[indexConfig]),
+           configurations.row(indexVel).transpose().array(),
+           Array_t::Constant(n, q[indexVel]), aMax, vMax, invAMax, invVMax,
+           sigma, twoSegment);
+        distances.array() = distances.array().max(T);
     }
-   // hppDout(info," is : "<<Tmax);
-    return Tmax;
 }
 } //   namespace core
 } // namespace hpp
@@ -0,0 +1,373 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/mapped-roadmap.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <hpp/util/exception-factory.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/core/compact-roadmap.hh>
+#include <hpp/core/distance.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/roadmap.hh>
+#include <hpp/core/steering-method.hh>
+
+#include "dijkstra.hh"
+
+namespace hpp {
+  namespace core {
+    namespace {
+      const char fileMagic [8] = {'H', 'P', 'P', 'R', 'M', 'A', 'P', '\0'};
+      /// Read in another value if the file has another byte order
+      const boost::uint32_t byteOrderMark = 0x01020304;
+
+      struct Header
+      {
+        char magic [8];
+        boost::uint32_t version;
+        boost::uint32_t byteOrder;
+        boost::int64_t configSize;
+        boost::int64_t numberNodes;
+        boost::int64_t numberEdges;
+        boost::int64_t numberComponents;
+        boost::int64_t numberPivots;
+      }; // struct Header
+
+      std::size_t padded (std::size_t bytes)
+      {
+        return (bytes + 7) / 8 * 8;
+      }
+
+      /// Position in bytes of the arrays in the file
+      struct Layout
+      {
+        Layout (const Header& h)
+        {
+          const std::size_t n ((std::size_t) h.numberNodes),
+            m ((std::size_t) h.numberEdges),
+            c ((std::size_t) h.numberComponents),
+            p ((std::size_t) h.numberPivots);
+          std::size_t o (padded (sizeof (Header)));
+          configurations = o; o += 8 * n * (std::size_t) h.configSize;
+          offsets = o;        o += 8 * (n + 1);
+          sources = o;        o += 8 * m;
+          targets = o;        o += 8 * m;
+          costs = o;          o += 8 * m;
+          components = o;     o += 8 * n;
+          reachability = o;   o += padded (c * c);
+          pivots = o;         o += 8 * p;
+          pivotDistances = o; o += 8 * n * p;
+          size = o;
+        }
+        std::size_t configurations, offsets, sources, targets, costs,
+          components, reachability, pivots, pivotDistances, size;
+      }; // struct Layout
+
+      /// Write arrays at given positions, padding with zeros
+      struct Writer
+      {
+        Writer (const std::string& filename) :
+          os (filename.c_str (), std::ios::binary | std::ios::trunc),
+          position (0)
+        {
+          if (!os) {
+            HPP_THROW (std::runtime_error, "Cannot open " << filename
+                       << " for writing.");
+          }
+        }
+        template <typename T>
+        void write (std::size_t at, const T* data, std::size_t n)
+        {
+          const char zero (0);
+          for (; position < at; ++position) os.write (&zero, 1);
+          os.write ((const char*) data, sizeof (T) * n);
+          position += sizeof (T) * n;
+        }
+        std::ofstream os;
+        std::size_t position;
+      }; // struct Writer
+    } // namespace
+
+    struct MappedRoadmap::Storage
+    {
+      typedef boost::unordered_map <size_type, PathPtr_t> Paths_t;
+
+      boost::interprocess::file_mapping file;
+      boost::interprocess::mapped_region region;
+      /// Paths of the edges already requested
+      Paths_t paths;
+      boost::mutex mutex;
+    }; // struct Storage
+
+    void MappedRoadmap::save (const RoadmapPtr_t& roadmap,
+                              const std::string& filename,
+                              size_type numberPivots)
+    {
+      if (numberPivots < 0)
+        throw std::invalid_argument ("number of pivots should be non "
+                                     "negative.");
+      CompactRoadmapPtr_t compact (CompactRoadmap::create (roadmap));
+      const size_type n (compact->numberNodes ()),
+        m (compact->numberEdges ());
+
+      Header header;
+      std::memcpy (header.magic, fileMagic, sizeof (fileMagic));
+      header.version = fileVersion;
+      header.byteOrder = byteOrderMark;
+      header.configSize = (n > 0 ? compact->node (0)->configuration ()->size ()
+                           : 0);
+      header.numberNodes = n;
+      header.numberEdges = m;
+      header.numberComponents = roadmap->connectedComponents ().size ();
+      header.numberPivots = std::min (numberPivots, n);
+      const Layout layout (header);
+      const size_type c (header.numberComponents), p (header.numberPivots);
+
+      Writer writer (filename);
+      writer.write (0, &header, 1);
+      for (size_type i = 0; i < n; ++i) {
+        const Configuration_t& q (*compact->node (i)->configuration ());
+        writer.write (layout.configurations + 8 * i * header.configSize,
+                      q.data (), q.size ());
+      }
+
+      std::vector <boost::int64_t> ids (n + 1);
+      for (size_type i = 0; i <= n; ++i)
+        ids [i] = (i < n ? compact->edgeBegin (i) : m);
+      writer.write (layout.offsets, &ids [0], ids.size ());
+      ids.resize (m);
+      std::vector <double> costs (m);
+      for (size_type e = 0; e < m; ++e) ids [e] = compact->source (e);
+      if (m > 0) writer.write (layout.sources, &ids [0], ids.size ());
+      for (size_type e = 0; e < m; ++e) ids [e] = compact->target (e);
+      if (m > 0) writer.write (layout.targets, &ids [0], ids.size ());
+      for (size_type e = 0; e < m; ++e) costs [e] = compact->cost (e);
+      if (m > 0) writer.write (layout.costs, &costs [0], costs.size ());
+
+      // Reachability between components, from one node of each
+      ids.resize (n);
+      std::vector <size_type> representative (c, -1);
+      for (size_type i = 0; i < n; ++i) {
+        ids [i] = compact->connectedComponent (i);
+        representative [ids [i]] = i;
+      }
+      if (n > 0) writer.write (layout.components, &ids [0], ids.size ());
+      std::vector <boost::uint8_t> reachability (c * c, 0);
+      for (size_type i = 0; i < c; ++i)
+        for (size_type j = 0; j < c; ++j)
+          reachability [i * c + j] = compact->canReach
+            (representative [i], representative [j]);
+      if (c > 0)
+        writer.write (layout.reachability, &reachability [0], c * c);
+
+      // Pivots farthest from each other
+      const Distance& distance (*roadmap->distance ());
+      std::vector <double> pivotDistances (n * p);
+      std::vector <value_type> closest
+        (n, std::numeric_limits <value_type>::infinity ());
+      ids.resize (p);
+      for (size_type j = 0; j < p; ++j) {
+        ids [j] = (j == 0 ? 0 : std::max_element (closest.begin (),
+                                                  closest.end ())
+                   - closest.begin ());
+        const Configuration_t& pivot (*compact->node (ids [j])->
+                                      configuration ());
+        for (size_type i = 0; i < n; ++i) {
+          const value_type d (distance (pivot,
+                                        *compact->node (i)->configuration ()));
+          pivotDistances [i * p + j] = d;
+          closest [i] = std::min (closest [i], d);
+        }
+      }
+      if (p > 0) {
+        writer.write (layout.pivots, &ids [0], ids.size ());
+        writer.write (layout.pivotDistances, &pivotDistances [0],
+                      pivotDistances.size ());
+      }
+      const char zero (0);
+      for (; writer.position < layout.size; ++writer.position)
+        writer.os.write (&zero, 1);
+      writer.os.close ();
+      if (!writer.os) {
+        HPP_THROW (std::runtime_error, "Failed to write " << filename);
+      }
+    }
+
+    MappedRoadmapPtr_t MappedRoadmap::load (const std::string& filename,
+                                            const Problem& problem)
+    {
+      return MappedRoadmapPtr_t (new MappedRoadmap (filename, problem));
+    }
+
+    MappedRoadmap::MappedRoadmap (const std::string& filename,
+                                  const Problem& problem) :
+      storage_ (new Storage),
+      steeringMethod_ (problem.steeringMethod ()),
+      distance_ (problem.distance ())
+    {
+      using namespace boost::interprocess;
+      try {
+        file_mapping file (filename.c_str (), read_only);
+        mapped_region region (file, read_only);
+        storage_->file.swap (file);
+        storage_->region.swap (region);
+      } catch (const interprocess_exception& exc) {
+        HPP_THROW (std::runtime_error, "Cannot map " << filename << ": "
+                   << exc.what ());
+      }
+      const char* data ((const char*) storage_->region.get_address ());
+      const std::size_t size (storage_->region.get_size ());
+      if (size < sizeof (Header)) {
+        HPP_THROW (std::runtime_error, filename << " is not a roadmap.");
+      }
+      Header header;
+      std::memcpy (&header, data, sizeof (Header));
+      if (std::memcmp (header.magic, fileMagic, sizeof (fileMagic)) != 0) {
+        HPP_THROW (std::runtime_error, filename << " is not a roadmap.");
+      }
+      if (header.byteOrder != byteOrderMark) {
+        HPP_THROW (std::runtime_error, filename << " was written with "
+                   "another byte order.");
+      }
+      if (header.version != fileVersion) {
+        HPP_THROW (std::runtime_error, filename << " has version "
+                   << header.version << " instead of " << fileVersion);
+      }
+      const Layout layout (header);
+      if (size != layout.size) {
+        HPP_THROW (std::runtime_error, filename << " has " << size
+                   << " bytes instead of " << layout.size);
+      }
+      if (header.numberNodes > 0 &&
+          header.configSize != problem.robot ()->configSize ()) {
+        HPP_THROW (std::runtime_error, filename << " stores configurations "
+                   "of size " << header.configSize << " instead of "
+                   << problem.robot ()->configSize ());
+      }
+      configSize_ = header.configSize;
+      numberNodes_ = header.numberNodes;
+      numberEdges_ = header.numberEdges;
+      numberComponents_ = header.numberComponents;
+      numberPivots_ = header.numberPivots;
+      configurations_ = (const double*) (data + layout.configurations);
+      offsets_ = (const boost::int64_t*) (data + layout.offsets);
+      sources_ = (const boost::int64_t*) (data + layout.sources);
+      targets_ = (const boost::int64_t*) (data + layout.targets);
+      costs_ = (const double*) (data + layout.costs);
+      components_ = (const boost::int64_t*) (data + layout.components);
+      reachability_ = (const boost::uint8_t*) (data + layout.reachability);
+      pivots_ = (const boost::int64_t*) (data + layout.pivots);
+      pivotDistances_ = (const double*) (data + layout.pivotDistances);
+    }
+
+    PathPtr_t MappedRoadmap::path (size_type edge) const
+    {
+      // Steering methods are not required to be thread safe.
+      boost::mutex::scoped_lock lock (storage_->mutex);
+      Storage::Paths_t::const_iterator it (storage_->paths.find (edge));
+      if (it != storage_->paths.end ()) return it->second;
+      PathPtr_t result ((*steeringMethod_) (configuration (source (edge)),
+                                            configuration (target (edge))));
+      if (!result) {
+        HPP_THROW (std::runtime_error, "Steering method failed to rebuild "
+                   "edge " << edge << " of the roadmap.");
+      }
+      storage_->paths [edge] = result;
+      return result;
+    }
+
+    size_type MappedRoadmap::nearestNode (ConfigurationIn_t configuration,
+                                          value_type& distance) const
+    {
+      const Distance& d (*distance_);
+      distance = std::numeric_limits <value_type>::infinity ();
+      size_type nearest (-1);
+      std::vector <value_type> toPivots (numberPivots_);
+      for (size_type j = 0; j < numberPivots_; ++j) {
+        toPivots [j] = d (configuration, this->configuration (pivots_ [j]));
+        if (toPivots [j] < distance) {
+          distance = toPivots [j];
+          nearest = pivots_ [j];
+        }
+      }
+      for (size_type i = 0; i < numberNodes_; ++i) {
+        // Lower bound of the distance by the triangle inequality
+        const double* row (pivotDistances_ + i * numberPivots_);
+        value_type bound (0);
+        for (size_type j = 0; j < numberPivots_; ++j)
+          bound = std::max (bound, std::fabs (toPivots [j] - row [j]));
+        if (bound >= distance) continue;
+        const value_type di (d (configuration, this->configuration (i)));
+        if (di < distance) {
+          distance = di;
+          nearest = i;
+        }
+      }
+      return nearest;
+    }
+
+    bool MappedRoadmap::shortestPath (size_type from, size_type to,
+                                      EdgeIds_t& edges) const
+    {
+      std::vector <value_type> costs;
+      EdgeIds_t parents;
+      edges.clear ();
+      if (!canReach (from, to)) return false;
+      dijkstra (numberNodes_, offsets_, targets_, costs_,
+                std::vector <size_type> (1, from),
+                std::vector <value_type> (1, 0), to, costs, parents);
+      if (costs [to] == std::numeric_limits <value_type>::infinity ())
+        return false;
+      for (size_type node = to; node != from;) {
+        const size_type edge (parents [node]);
+        edges.push_back (edge);
+        node = source (edge);
+      }
+      std::reverse (edges.begin (), edges.end ());
+      return true;
+    }
+
+    PathVectorPtr_t MappedRoadmap::pathVector (const EdgeIds_t& edges) const
+    {
+      if (edges.empty ())
+        throw std::invalid_argument ("Cannot build a path from no edge.");
+      const PathPtr_t first (path (edges.front ()));
+      PathVectorPtr_t result (PathVector::create
+                              (first->outputSize (),
+                               first->outputDerivativeSize ()));
+      for (EdgeIds_t::const_iterator it = edges.begin (); it != edges.end ();
+           ++it) {
+        result->appendPath (path (*it));
+      }
+      return result;
+    }
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,293 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/multi-query-solver.hh>
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/core/compact-roadmap.hh>
+#include <hpp/core/edge.hh>
+#include <hpp/core/executor.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/path-projector.hh>
+#include <hpp/core/path-validation.hh>
+#include <hpp/core/path-validation-report.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/roadmap.hh>
+#include <hpp/core/shared-roadmap.hh>
+#include <hpp/core/steering-method.hh>
+
+namespace hpp {
+  namespace core {
+    /// Valid path between a configuration and a node of the roadmap
+    struct MultiQuerySolver::Connection
+    {
+      Connection (size_type n, const PathPtr_t& p) :
+        node (n), path (p), cost (p->length ())
+      {
+      }
+      /// Id of the node in the compact roadmap
+      size_type node;
+      PathPtr_t path;
+      value_type cost;
+    }; // struct Connection
+
+    /// Graph search of the queries sharing a start configuration
+    struct MultiQuerySolver::Search
+    {
+      /// Index of the start configuration
+      std::size_t start;
+      /// Indices of the queries
+      std::vector <std::size_t> queries;
+      /// Cost of the solution of each query through the roadmap
+      std::vector <value_type> costs;
+      /// Index of the start and goal connections of each solution
+      std::vector <std::size_t> startConnections;
+      std::vector <std::size_t> goalConnections;
+      /// Roadmap edges of each solution
+      std::vector <CompactRoadmap::EdgeIds_t> edges;
+    }; // struct Search
+
+    namespace {
+      /// Index of a configuration in a list of distinct configurations
+      ///
+      /// The configuration is appended if it is not in the list.
+      std::size_t index (std::vector <Configuration_t>& configurations,
+                         const Configuration_t& q)
+      {
+        for (std::size_t i = 0; i < configurations.size (); ++i) {
+          if (configurations [i] == q) return i;
+        }
+        configurations.push_back (q);
+        return configurations.size () - 1;
+      }
+    } // namespace
+
+    MultiQuerySolverPtr_t MultiQuerySolver::create (const Problem& problem,
+                                                    const RoadmapPtr_t& roadmap)
+    {
+      return create (problem, SharedRoadmap::create (roadmap));
+    }
+
+    MultiQuerySolverPtr_t MultiQuerySolver::create
+    (const Problem& problem, const SharedRoadmapPtr_t& roadmap)
+    {
+      return MultiQuerySolverPtr_t (new MultiQuerySolver (problem, roadmap));
+    }
+
+    MultiQuerySolver::MultiQuerySolver (const Problem& problem,
+                                        const SharedRoadmapPtr_t& roadmap) :
+      problem_ (problem), roadmap_ (roadmap), numberNeighbors_ (10),
+      numberThreads_ (std::max (1u, boost::thread::hardware_concurrency ()))
+    {
+    }
+
+    PathPtr_t MultiQuerySolver::validate (const PathPtr_t& path) const
+    {
+      PathProjectorPtr_t pathProjector (problem_.pathProjector ());
+      PathValidationPtr_t pathValidation (problem_.pathValidation ());
+      PathPtr_t projected, validPart;
+      PathValidationReportPtr_t report;
+      if (pathProjector) {
+        if (!pathProjector->apply (path, projected)) return PathPtr_t ();
+      } else {
+        projected = path;
+      }
+      if (!pathValidation->validate (projected, false, validPart, report))
+        return PathPtr_t ();
+      return projected;
+    }
+
+    std::vector <MultiQuerySolver::Connections_t> MultiQuerySolver::connect
+    (const std::vector <Configuration_t>& configurations, bool toRoadmap)
+      const
+    {
+      std::vector <Connections_t> result (configurations.size ());
+      if (configurations.empty () || roadmap_->roadmap ()->nodes ().empty ())
+        return result;
+      const SteeringMethod& sm (*problem_.steeringMethod ());
+      matrix_t qs (configurations.front ().size (), configurations.size ());
+      for (std::size_t i = 0; i < configurations.size (); ++i)
+        qs.col (i) = configurations [i];
+      const std::vector <Nodes_t> nearNodes
+        (roadmap_->nearestNodes (qs, numberNeighbors_));
+      const CompactRoadmap& compact (*roadmap_->compact ());
+      for (std::size_t i = 0; i < configurations.size (); ++i) {
+        for (Nodes_t::const_iterator it = nearNodes [i].begin ();
+             it != nearNodes [i].end (); ++it) {
+          const Configuration_t& q (*(*it)->configuration ());
+          PathPtr_t path (toRoadmap ? sm (configurations [i], q) :
+                          sm (q, configurations [i]));
+          if (!path) continue;
+          path = validate (path);
+          if (path) result [i].push_back (Connection (compact.id (*it),
+                                                      path));
+        }
+      }
+      return result;
+    }
+
+    namespace {
+      template <typename Search_t, typename Connections_t>
+      void searchRange (const CompactRoadmap& compact,
+                        const std::vector <Connections_t>& starts,
+                        const std::vector <Connections_t>& goals,
+                        const std::vector <std::size_t>& goalOfQuery,
+                        std::vector <Search_t>& searches,
+                        std::size_t begin, std::size_t step)
+      {
+        const value_type infinity (std::numeric_limits <value_type>::infinity ());
+        std::vector <size_type> sources;
+        std::vector <value_type> initialCosts, costs;
+        CompactRoadmap::EdgeIds_t parents;
+        for (std::size_t i = begin; i < searches.size (); i += step) {
+          Search_t& search (searches [i]);
+          const Connections_t& startConnections (starts [search.start]);
+          const std::size_t n (search.queries.size ());
+          search.costs.assign (n, infinity);
+          search.startConnections.assign (n, 0);
+          search.goalConnections.assign (n, 0);
+          search.edges.assign (n, CompactRoadmap::EdgeIds_t ());
+          if (startConnections.empty ()) continue;
+
+          sources.clear ();
+          initialCosts.clear ();
+          for (std::size_t j = 0; j < startConnections.size (); ++j) {
+            sources.push_back (startConnections [j].node);
+            initialCosts.push_back (startConnections [j].cost);
+          }
+          compact.shortestPaths (sources, initialCosts, costs, parents);
+
+          for (std::size_t j = 0; j < n; ++j) {
+            const Connections_t& goalConnections
+              (goals [goalOfQuery [search.queries [j]]]);
+            for (std::size_t k = 0; k < goalConnections.size (); ++k) {
+              const value_type cost (costs [goalConnections [k].node] +
+                                     goalConnections [k].cost);
+              if (cost < search.costs [j]) {
+                search.costs [j] = cost;
+                search.goalConnections [j] = k;
+              }
+            }
+            if (search.costs [j] == infinity) continue;
+            // Follow parents back to the node reached by a start connection
+            CompactRoadmap::EdgeIds_t& edges (search.edges [j]);
+            size_type node (goalConnections [search.goalConnections [j]].node);
+            while (parents [node] >= 0) {
+              edges.push_back (parents [node]);
+              node = compact.source (parents [node]);
+            }
+            std::reverse (edges.begin (), edges.end ());
+            for (std::size_t k = 0; k < startConnections.size (); ++k) {
+              if (startConnections [k].node == node &&
+                  startConnections [k].cost == costs [node]) {
+                search.startConnections [j] = k;
+                break;
+              }
+            }
+          }
+        }
+      }
+    } // namespace
+
+    std::vector <PathVectorPtr_t> MultiQuerySolver::solve
+    (const Queries_t& queries) const
+    {
+      // Group queries by start configuration and connect distinct
+      // configurations to the roadmap.
+      std::vector <Configuration_t> starts, goals;
+      std::vector <std::size_t> goalOfQuery (queries.size ());
+      std::vector <Search> searches;
+      for (std::size_t i = 0; i < queries.size (); ++i) {
+        const std::size_t start (index (starts, queries [i].first));
+        if (start == searches.size ()) {
+          searches.push_back (Search ());
+          searches.back ().start = start;
+        }
+        searches [start].queries.push_back (i);
+        goalOfQuery [i] = index (goals, queries [i].second);
+      }
+      const std::vector <Connections_t> startConnections
+        (connect (starts, true));
+      const std::vector <Connections_t> goalConnections
+        (connect (goals, false));
+
+      // Graph searches only read the compact roadmap and run in parallel.
+      const CompactRoadmap& compact (*roadmap_->compact ());
+      const std::size_t nThreads
+        (std::min ((std::size_t) numberThreads_, searches.size ()));
+      if (nThreads <= 1) {
+        searchRange (compact, startConnections, goalConnections,
+                     goalOfQuery, searches, 0, 1);
+      } else {
+        Executor::Tasks_t tasks;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          tasks.push_back
+            (boost::bind (&searchRange <Search, Connections_t>,
+                          boost::cref (compact),
+                          boost::cref (startConnections),
+                          boost::cref (goalConnections),
+                          boost::cref (goalOfQuery), boost::ref (searches),
+                          t, nThreads));
+        }
+        Executor::run (executor_, tasks);
+      }
+
+      // Build the paths, unless a direct path is shorter.
+      const SteeringMethod& sm (*problem_.steeringMethod ());
+      const DevicePtr_t& robot (problem_.robot ());
+      std::vector <PathVectorPtr_t> result (queries.size ());
+      for (std::size_t i = 0; i < searches.size (); ++i) {
+        const Search& search (searches [i]);
+        for (std::size_t j = 0; j < search.queries.size (); ++j) {
+          const std::size_t query (search.queries [j]);
+          PathVectorPtr_t pv (PathVector::create (robot->configSize (),
+                                                  robot->numberDof ()));
+          PathPtr_t direct (sm (queries [query].first,
+                                queries [query].second));
+          if (direct) direct = validate (direct);
+          if (direct && direct->length () <= search.costs [j]) {
+            pv->appendPath (direct);
+          } else if (search.costs [j] <
+                     std::numeric_limits <value_type>::infinity ()) {
+            pv->appendPath (startConnections [search.start]
+                            [search.startConnections [j]].path);
+            for (CompactRoadmap::EdgeIds_t::const_iterator it =
+                   search.edges [j].begin ();
+                 it != search.edges [j].end (); ++it) {
+              pv->appendPath (compact.edge (*it)->path ());
+            }
+            pv->appendPath (goalConnections [goalOfQuery [query]]
+                            [search.goalConnections [j]].path);
+          } else {
+            continue;
+          }
+          result [query] = pv;
+        }
+      }
+      return result;
+    }
+  } //   namespace core
+} // namespace hpp
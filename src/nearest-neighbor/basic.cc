@@ -51,10 +51,14 @@ namespace hpp {
 	for (NodeVector_t::const_iterator itNode =
 	       connectedComponent->nodes ().begin ();
 	     itNode != connectedComponent->nodes ().end (); ++itNode) {
-    if(reverse)
-      d = dist ( configuration, *(*itNode)->configuration ());
-    else
-      d = dist ( *(*itNode)->configuration (), configuration);
+    const Configuration_t& q (*(*itNode)->configuration ());
+    if(reverse) {
+      if (dist.lowerBound (configuration, q) >= distance) continue;
+      d = dist ( configuration, q);
+    } else {
+      if (dist.lowerBound (q, configuration) >= distance) continue;
+      d = dist ( q, configuration);
+    }
 	  if (d < distance) {
 	    distance = d;
 	    result = *itNode;
@@ -75,6 +79,8 @@ namespace hpp {
 	for (NodeVector_t::const_iterator itNode =
 	       connectedComponent->nodes ().begin ();
 	     itNode != connectedComponent->nodes ().end (); ++itNode) {
+	  if (dist.lowerBound (*(*itNode)->configuration (),
+			       *node->configuration ()) >= distance) continue;
 	  value_type d = dist (*itNode, node);
 	  if (d < distance) {
 	    distance = d;
@@ -97,6 +103,8 @@ namespace hpp {
         for (NodeVector_t::const_iterator itNode =
             connectedComponent->nodes ().begin ();
             itNode != connectedComponent->nodes ().end (); ++itNode) {
+          if (ns.size () == K && dist.lowerBound
+              (*(*itNode)->configuration (), q) >= ns.top ().first) continue;
           value_type d = dist (*(*itNode)->configuration (), q);
           if (ns.size () < K)
             ns.push (DistAndNode_t (d, (*itNode)));
@@ -125,6 +133,9 @@ namespace hpp {
         for (NodeVector_t::const_iterator itNode =
             connectedComponent->nodes ().begin ();
             itNode != connectedComponent->nodes ().end (); ++itNode) {
+          if (ns.size () == K && dist.lowerBound
+              (*(*itNode)->configuration (), *node->configuration ())
+              >= ns.top ().first) continue;
           value_type d = dist (*itNode, node);
           if (ns.size () < K)
             ns.push (DistAndNode_t (d, (*itNode)));
@@ -151,6 +162,8 @@ namespace hpp {
         for (Nodes_t::const_iterator itNode =
             roadmap->nodes ().begin ();
             itNode != roadmap->nodes ().end (); ++itNode) {
+          if (ns.size () == K && dist.lowerBound
+              (*(*itNode)->configuration (), q) >= ns.top ().first) continue;
           value_type d = dist (*(*itNode)->configuration (), q);
           if (ns.size () < K)
             ns.push (DistAndNode_t (d, (*itNode)));
@@ -167,6 +180,41 @@ namespace hpp {
         return nodes;
       }
 
+      std::vector <Nodes_t> Basic::KnearestSearch
+      (const matrix_t& configurations, const RoadmapPtr_t& roadmap,
+       const std::size_t K, vector_t& distances)
+      {
+        const std::size_t n ((std::size_t) configurations.cols ());
+        std::vector <Queue_t> ns (n);
+        const Distance& dist = *distance_;
+        for (Nodes_t::const_iterator itNode =
+            roadmap->nodes ().begin ();
+            itNode != roadmap->nodes ().end (); ++itNode) {
+          const Configuration_t& q (*(*itNode)->configuration ());
+          for (std::size_t i = 0; i < n; ++i) {
+            if (ns [i].size () == K && dist.lowerBound
+                (q, configurations.col (i)) >= ns [i].top ().first) continue;
+            value_type d = dist (q, configurations.col (i));
+            if (ns [i].size () < K)
+              ns [i].push (DistAndNode_t (d, (*itNode)));
+            else if (ns [i].top().first > d) {
+              ns [i].pop ();
+              ns [i].push (DistAndNode_t (d, (*itNode)));
+            }
+          }
+        }
+        std::vector <Nodes_t> result (n);
+        distances = vector_t::Constant
+          (n, std::numeric_limits <value_type>::infinity ());
+        for (std::size_t i = 0; i < n; ++i) {
+          if (ns [i].size() > 0) distances [i] = ns [i].top ().first;
+          while (ns [i].size () > 0) {
+            result [i].push_front (ns [i].top().second); ns [i].pop ();
+          }
+        }
+        return result;
+      }
+
       NodeVector_t Basic::withinBall (const Configuration_t& q,
                                       const ConnectedComponentPtr_t& cc,
                                        value_type maxDistance)
@@ -176,6 +224,7 @@ namespace hpp {
 	for (NodeVector_t::const_iterator itNode = cc->nodes ().begin ();
 	     itNode != cc->nodes ().end (); ++itNode) {
           NodePtr_t n = *itNode;
+	  if (dist.lowerBound (*n->configuration(), q) >= maxDistance) continue;
 	  if (dist (*n->configuration(), q) < maxDistance)
             nodes.push_back (n);
 	}
@@ -46,6 +46,11 @@ namespace hpp {
       {
       }
 
+      // Nodes are read from the connected components.
+      virtual void removeNode (const NodePtr_t&)
+      {
+      }
+
       virtual NodePtr_t search (const NodePtr_t& node,
              const ConnectedComponentPtr_t&
         connectedComponent,
@@ -79,6 +84,16 @@ namespace hpp {
                                       const std::size_t K,
 			              value_type& distance);
 
+      /// Return the K nearest nodes in the whole roadmap of several
+      /// configurations
+      ///
+      /// Nodes are visited once for all the configurations.
+      virtual std::vector <Nodes_t> KnearestSearch
+      (const matrix_t& configurations, const RoadmapPtr_t& roadmap,
+       const std::size_t K, vector_t& distances);
+
+      using NearestNeighbor::withinBall;
+
       NodeVector_t withinBall (const Configuration_t& configuration,
                                const ConnectedComponentPtr_t& cc,
                                value_type maxDistance);
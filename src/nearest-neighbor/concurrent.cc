@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include "../src/nearest-neighbor/concurrent.hh"
+
+#include <stdexcept>
+
+#include <boost/thread/locks.hpp>
+
+namespace hpp {
+  namespace core {
+    namespace nearestNeighbor {
+      typedef boost::shared_lock <boost::shared_mutex> ReadLock_t;
+      typedef boost::unique_lock <boost::shared_mutex> WriteLock_t;
+
+      Concurrent::Concurrent (NearestNeighborPtr_t nearestNeighbor) :
+        nearestNeighbor_ (nearestNeighbor)
+      {
+        if (!nearestNeighbor_)
+          throw std::invalid_argument ("Concurrent: null nearest neighbor");
+      }
+
+      Concurrent::~Concurrent ()
+      {
+        delete nearestNeighbor_;
+      }
+
+      void Concurrent::clear ()
+      {
+        WriteLock_t lock (mutex_);
+        nearestNeighbor_->clear ();
+      }
+
+      void Concurrent::addNode (const NodePtr_t& node)
+      {
+        WriteLock_t lock (mutex_);
+        nearestNeighbor_->addNode (node);
+      }
+
+      void Concurrent::addNodes (const NodeVector_t& nodes)
+      {
+        WriteLock_t lock (mutex_);
+        nearestNeighbor_->addNodes (nodes);
+      }
+
+      void Concurrent::removeNode (const NodePtr_t& node)
+      {
+        WriteLock_t lock (mutex_);
+        nearestNeighbor_->removeNode (node);
+      }
+
+      NodePtr_t Concurrent::search (const Configuration_t& configuration,
+                                    const ConnectedComponentPtr_t&
+                                    connectedComponent,
+                                    value_type& distance, bool reverse)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->search (configuration, connectedComponent,
+                                         distance, reverse);
+      }
+
+      NodePtr_t Concurrent::search (const NodePtr_t& node,
+                                    const ConnectedComponentPtr_t&
+                                    connectedComponent,
+                                    value_type& distance)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->search (node, connectedComponent, distance);
+      }
+
+      NodeVector_t Concurrent::searchInConnectedComponents
+      (const Configuration_t& configuration,
+       const ConnectedComponents_t& connectedComponents,
+       vector_t& distances, bool reverse)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->searchInConnectedComponents
+          (configuration, connectedComponents, distances, reverse);
+      }
+
+      Nodes_t Concurrent::KnearestSearch (const Configuration_t& configuration,
+                                          const ConnectedComponentPtr_t&
+                                          connectedComponent,
+                                          const std::size_t K,
+                                          value_type& distance)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->KnearestSearch (configuration,
+                                                 connectedComponent, K,
+                                                 distance);
+      }
+
+      Nodes_t Concurrent::KnearestSearch (const NodePtr_t& node,
+                                          const ConnectedComponentPtr_t&
+                                          connectedComponent,
+                                          const std::size_t K,
+                                          value_type& distance)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->KnearestSearch (node, connectedComponent, K,
+                                                 distance);
+      }
+
+      Nodes_t Concurrent::KnearestSearch (const Configuration_t& configuration,
+                                          const RoadmapPtr_t& roadmap,
+                                          const std::size_t K,
+                                          value_type& distance)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->KnearestSearch (configuration, roadmap, K,
+                                                 distance);
+      }
+
+      std::vector <Nodes_t> Concurrent::KnearestSearch
+      (const matrix_t& configurations, const RoadmapPtr_t& roadmap,
+       const std::size_t K, vector_t& distances)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->KnearestSearch (configurations, roadmap, K,
+                                                 distances);
+      }
+
+      NodeVector_t Concurrent::withinBall (const Configuration_t& configuration,
+                                           const ConnectedComponentPtr_t& cc,
+                                           value_type maxDistance)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->withinBall (configuration, cc, maxDistance);
+      }
+
+      NodeVector_t Concurrent::withinBall (const Configuration_t& configuration,
+                                           const ConnectedComponentPtr_t& cc,
+                                           value_type maxDistance,
+                                           size_type maxNodes)
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->withinBall (configuration, cc, maxDistance,
+                                             maxNodes);
+      }
+
+      void Concurrent::merge (ConnectedComponentPtr_t cc1,
+                              ConnectedComponentPtr_t cc2)
+      {
+        WriteLock_t lock (mutex_);
+        nearestNeighbor_->merge (cc1, cc2);
+      }
+
+      void Concurrent::approximationFactor (value_type factor)
+      {
+        WriteLock_t lock (mutex_);
+        nearestNeighbor_->approximationFactor (factor);
+      }
+
+      value_type Concurrent::approximationFactor () const
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->approximationFactor ();
+      }
+
+      size_type Concurrent::depth () const
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->depth ();
+      }
+
+      value_type Concurrent::averageDepth () const
+      {
+        ReadLock_t lock (mutex_);
+        return nearestNeighbor_->averageDepth ();
+      }
+
+      std::size_t Concurrent::memory () const
+      {
+        ReadLock_t lock (mutex_);
+        return sizeof (Concurrent) + nearestNeighbor_->memory ();
+      }
+
+      NearestNeighborPtr_t createConcurrent
+      (NearestNeighborPtr_t nearestNeighbor)
+      {
+        return new Concurrent (nearestNeighbor);
+      }
+    } // namespace nearestNeighbor
+  } // namespace core
+} // namespace hpp
@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_NEAREST_NEIGHBOR_CONCURRENT_HH
+# define HPP_CORE_NEAREST_NEIGHBOR_CONCURRENT_HH
+
+# include <boost/thread/shared_mutex.hpp>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/nearest-neighbor.hh>
+
+namespace hpp {
+  namespace core {
+    namespace nearestNeighbor {
+    /// Nearest neighbor structure shared between threads
+    ///
+    /// Wraps another nearest neighbor structure. Searches hold a shared
+    /// lock and may run concurrently, modifications (insertion, merge,
+    /// clear) hold an exclusive lock. A merge is thus seen by searches
+    /// either entirely or not at all.
+    ///
+    /// \note The wrapped structure should not read data that is modified
+    ///       outside of the lock. KDTree satisfies this requirement, Basic
+    ///       does not since it iterates over the nodes of the connected
+    ///       components.
+    class Concurrent : public NearestNeighbor
+    {
+    public:
+      /// Constructor
+      /// \param nearestNeighbor the wrapped structure, deleted with this
+      ///        object.
+      Concurrent (NearestNeighborPtr_t nearestNeighbor);
+
+      virtual ~Concurrent ();
+
+      virtual void clear ();
+
+      virtual void addNode (const NodePtr_t& node);
+
+      virtual void addNodes (const NodeVector_t& nodes);
+
+      virtual void removeNode (const NodePtr_t& node);
+
+      virtual NodePtr_t search (const Configuration_t& configuration,
+                                const ConnectedComponentPtr_t&
+                                connectedComponent,
+                                value_type& distance, bool reverse = false);
+
+      virtual NodePtr_t search (const NodePtr_t& node,
+                                const ConnectedComponentPtr_t&
+                                connectedComponent,
+                                value_type& distance);
+
+      virtual NodeVector_t searchInConnectedComponents
+      (const Configuration_t& configuration,
+       const ConnectedComponents_t& connectedComponents,
+       vector_t& distances, bool reverse = false);
+
+      virtual Nodes_t KnearestSearch (const Configuration_t& configuration,
+                                      const ConnectedComponentPtr_t&
+                                        connectedComponent,
+                                      const std::size_t K,
+                                      value_type& distance);
+
+      virtual Nodes_t KnearestSearch (const NodePtr_t& node,
+                                      const ConnectedComponentPtr_t&
+                                        connectedComponent,
+                                      const std::size_t K,
+                                      value_type& distance);
+
+      virtual Nodes_t KnearestSearch (const Configuration_t& configuration,
+                                      const RoadmapPtr_t& roadmap,
+                                      const std::size_t K,
+                                      value_type& distance);
+
+      virtual std::vector <Nodes_t> KnearestSearch
+      (const matrix_t& configurations, const RoadmapPtr_t& roadmap,
+       const std::size_t K, vector_t& distances);
+
+      virtual NodeVector_t withinBall (const Configuration_t& configuration,
+                                       const ConnectedComponentPtr_t& cc,
+                                       value_type maxDistance);
+
+      virtual NodeVector_t withinBall (const Configuration_t& configuration,
+                                       const ConnectedComponentPtr_t& cc,
+                                       value_type maxDistance,
+                                       size_type maxNodes);
+
+      virtual void merge (ConnectedComponentPtr_t cc1,
+                          ConnectedComponentPtr_t cc2);
+
+      virtual DistancePtr_t distance () const
+      {
+        return nearestNeighbor_->distance ();
+      }
+
+      virtual void approximationFactor (value_type factor);
+
+      virtual value_type approximationFactor () const;
+
+      virtual size_type depth () const;
+
+      virtual value_type averageDepth () const;
+
+      virtual std::size_t memory () const;
+
+    private:
+      NearestNeighborPtr_t nearestNeighbor_;
+      mutable boost::shared_mutex mutex_;
+
+      Concurrent () : nearestNeighbor_ (NULL) {}
+      HPP_SERIALIZABLE();
+    }; // class Concurrent
+    } // namespace nearestNeighbor
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_NEAREST_NEIGHBOR_CONCURRENT_HH
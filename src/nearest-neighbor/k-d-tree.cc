@@ -16,248 +16,849 @@
 // hpp-core  If not, see
 // <http://www.gnu.org/licenses/>.
 
-#include <iostream>
-#include <fstream>
+#include "../src/nearest-neighbor/k-d-tree.hh"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
 #include <stdexcept>
 
+#include <pinocchio/multibody/model.hpp>
+
 #include <hpp/util/debug.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/core/connected-component.hh>
 #include <hpp/core/distance.hh>
 #include <hpp/core/node.hh>
-#include <hpp/pinocchio/joint.hh>
-#include <hpp/pinocchio/device.hh>
+#include <hpp/core/roadmap.hh>
 #include <hpp/core/weighed-distance.hh>
-#include "../src/nearest-neighbor/k-d-tree.hh"
-
-using namespace std;
 
 namespace hpp {
   namespace core {
     namespace nearestNeighbor {
-    // Constructor with the mother tree node (same bounds)
-    KDTree::KDTree (const KDTreePtr_t mother, size_type splitDim) :
-      robot_(mother->robot_),
-      dim_(mother->dim_),
-      distance_(mother->distance_),
-      weights_ (mother->weights_),
-      nodesMap_(),
-      bucketSize_(mother->bucketSize_),
-      bucket_(0),
-      splitDim_(splitDim),
-      upperBounds_(mother->upperBounds_),
-      lowerBounds_(mother->lowerBounds_),
-      supChild_(0x0),
-      infChild_(0x0)
+    namespace {
+      typedef std::pair <value_type, NodePtr_t> DistAndNode_t;
+      struct DistAndNodeComp_t {
+        bool operator () (const DistAndNode_t& r,
+            const DistAndNode_t& l) {
+          return r.first < l.first;
+        }
+      };
+    } // namespace
+
+    /// Max-heap of the K best points found so far.
+    struct KDTree::Candidates
     {
-    }
+      /// \param K maximal number of candidates,
+      /// \param maxDistance only points closer than maxDistance are accepted.
+      Candidates (std::size_t K, value_type maxDistance =
+                  std::numeric_limits <value_type>::infinity ()) :
+        K_ (K), maxDistance_ (maxDistance)
+      {
+        heap_.reserve (K);
+      }
+
+      /// Distance of the worst accepted candidate.
+      value_type worst () const
+      {
+        if (heap_.size () < K_)
+          return maxDistance_;
+        return heap_.front ().first;
+      }
+
+      /// Squared distance of the worst accepted candidate.
+      value_type squaredWorst () const
+      {
+        if (heap_.size () < K_)
+          return maxDistance_ * maxDistance_;
+        return heap_.front ().first * heap_.front ().first;
+      }
+
+      void push (value_type d, const NodePtr_t& node)
+      {
+        if (d >= maxDistance_) return;
+        if (heap_.size () == K_ && d >= heap_.front ().first) return;
+        // A node may have been inserted as a seed.
+        for (std::size_t i = 0; i < heap_.size (); ++i)
+          if (heap_[i].second == node) return;
+        if (heap_.size () == K_) {
+          std::pop_heap (heap_.begin (), heap_.end (), DistAndNodeComp_t ());
+          heap_.pop_back ();
+        }
+        heap_.push_back (DistAndNode_t (d, node));
+        std::push_heap (heap_.begin (), heap_.end (), DistAndNodeComp_t ());
+      }
+
+      /// Return nodes sorted by increasing distance.
+      Nodes_t nodes (value_type& distance)
+      {
+        distance = std::numeric_limits <value_type>::infinity ();
+        if (!heap_.empty ()) distance = heap_.front ().first;
+        std::sort_heap (heap_.begin (), heap_.end (), DistAndNodeComp_t ());
+        Nodes_t result;
+        for (std::size_t i = 0; i < heap_.size (); ++i)
+          result.push_back (heap_[i].second);
+        return result;
+      }
+
+      std::size_t K_;
+      value_type maxDistance_;
+      std::vector <DistAndNode_t> heap_;
+    }; // struct Candidates
 
     KDTree::KDTree (const DevicePtr_t& robot, const DistancePtr_t& distance,
 		    int bucketSize) :
-      robot_(robot),
-      dim_(),
-      distance_(HPP_DYNAMIC_PTR_CAST (WeighedDistance, distance)),
-      weights_ (robot->configSize ()),
-      nodesMap_(),
-      bucketSize_(bucketSize),
-      bucket_(0),
-      splitDim_(),
-      upperBounds_(),
-      lowerBounds_(),
-      supChild_(),
-      infChild_()
-       {
-	 JointVector_t jointVector = robot_->getJointVector ();
-	 if (!distance_) {
-	   // create a weighed distance with unit weighs.
-       distance_ = WeighedDistance::createWithWeight
-	     (robot_, std::vector <value_type> (jointVector.size (), 1.0));
-	 }
-	 size_type i=0;
-	 // Fill vector of weights. index of vector is configuration coordinate
-	 // and not joint rank in robot.
-	 for (JointVector_t::const_iterator itJoint = jointVector.begin ();
-	      itJoint != jointVector.end (); ++itJoint) {
-	   weights_.segment ((*itJoint)->rankInConfiguration (),
-			     (*itJoint)->configSize ()).setConstant
-         (distance_->getWeight (i));
-	   ++i;
-	 }
-      this->findDeviceBounds();
-      dim_ = lowerBounds_.size();
-      splitDim_ = 0;
-      supChild_ = NULL;
-      infChild_ = NULL;
-    }
-
-    KDTree::~KDTree() {
-      clear ();
-    }
-
-    // find the leaf node in the tree for the configuration of the node
-    KDTreePtr_t KDTree::findLeaf (const NodePtr_t& node) {
-      KDTreePtr_t CurrentTree = this;
-      CurrentTree->nodesMap_[node->connectedComponent()];
-      while ( CurrentTree->supChild_ != NULL && CurrentTree->infChild_ != NULL)
-	{
-	  if ( (*(node->configuration()))[CurrentTree->supChild_->splitDim_]
-	       > CurrentTree->supChild_->lowerBounds_[CurrentTree->supChild_
-						      ->splitDim_] )  {
-	    CurrentTree = CurrentTree->supChild_;
-	    CurrentTree->nodesMap_[node->connectedComponent()];
-	  }
-	  else {
-	    CurrentTree = CurrentTree->infChild_;
-	    CurrentTree->nodesMap_[node->connectedComponent()];
-	  }
-	}
-      return CurrentTree;
-    }
-
-
-    void KDTree::addNode (const NodePtr_t& node) {
-
-      KDTreePtr_t Leaf = this->findLeaf(node);
-      if ( Leaf->bucket_ < bucketSize_ ) {
-	Leaf->nodesMap_[node->connectedComponent()].push_front(node);
-	Leaf->bucket_++;
-      }
-      else {
-	Leaf->split();
-	for ( NodesMap_t::iterator map = Leaf->nodesMap_.begin();
-	      map != Leaf->nodesMap_.end(); ++map) {
-	  for (Nodes_t::iterator it = map->second.begin ();
-	       it != map->second.end (); ++it) {
-	    Leaf->addNode(*it);
-	  }
-	  map->second.clear();
-	}
-	Leaf->addNode(node);
-      }
-    }
-
-
-    void KDTree::clear() {
-      nodesMap_.clear();
-      if (infChild_ != NULL ) {
-	delete infChild_;
-	infChild_ = NULL;
-      }
-      if (supChild_ != NULL ) {
-	delete supChild_;
-	supChild_ = NULL;
-      }
-    }
-
-
-    void KDTree::split() {
-      if ( infChild_ != NULL || supChild_ != NULL ) {
-	// Error, you're triing to split a non leaf part of the KDTree
-	throw std::runtime_error
-	  ("Attempt to split the KDTree in a non leaf part");
-      }
-      // Compute actual bounds of node configurations
-      vector_t actualLower (robot_->configSize ());
-      actualLower.setConstant (+std::numeric_limits <value_type>::infinity ());
-      vector_t actualUpper (robot_->configSize ());
-      actualUpper.setConstant (-std::numeric_limits <value_type>::infinity ());
-      std::vector <value_type> values (bucket_);
-      for (NodesMap_t::iterator itCC = nodesMap_.begin();
-	   itCC != nodesMap_.end(); ++itCC) {
-	Nodes_t nodes = itCC->second;
-	for (Nodes_t::const_iterator itNode = nodes.begin ();
-	     itNode != nodes.end (); ++itNode) {
-	  const Configuration_t& q (*((*itNode)->configuration ()));
-	  for (size_type i=0; i < q.size (); ++i) {
-	    if (q [i] < actualLower [i]) {
-	      actualLower [i] = q [i];
-	    }
-	    if (q [i] > actualUpper [i]) {
-	      actualUpper [i] = q [i];
-	    }
-	  }
-	}
-      }
-      // Split the widest dimention
-      double dimWidth = 0.;
+      distance_ (distance),
+      dim_ (robot->configSize ()),
+      bucketSize_ (bucketSize),
+      boundWeights_ (),
+      approximationFactor_ (1),
+      squaredFactor_ (1),
+      cells_ (),
+      configurations_ (robot->configSize (), 0),
+      nodes_ (),
+      removedPoints_ (0),
+      bucketPoints_ (),
+      bucketLabels_ (),
+      unusedBucketEntries_ (0),
+      freeCells_ (),
+      labels_ (),
+      labelParents_ (),
+      labelSizes_ (),
+      labelSeeds_ ()
+    {
+      if (bucketSize_ <= 0)
+        throw std::invalid_argument ("KDTree: bucket size should be positive");
+      if (!distance_) {
+        // create a weighed distance with unit weighs.
+        distance_ = WeighedDistance::createWithWeight
+          (robot, vector_t::Ones (robot->model ().njoints - 1));
+      }
+      computeBoundWeights (robot);
+    }
+
+    KDTree::~KDTree()
+    {
+    }
+
+    void KDTree::approximationFactor (value_type factor)
+    {
+      if (!(factor >= 1)) {
+        std::ostringstream oss;
+        oss << "KDTree: approximation factor should be greater than or equal "
+          "to 1, got " << factor;
+        throw std::invalid_argument (oss.str ());
+      }
+      approximationFactor_ = factor;
+      squaredFactor_ = factor * factor;
+    }
+
+    void KDTree::computeBoundWeights (const DevicePtr_t& robot)
+    {
+      boundWeights_ = vector_t::Zero (dim_);
+      WeighedDistancePtr_t wd (HPP_DYNAMIC_PTR_CAST (WeighedDistance,
+                                                     distance_));
+      if (!wd) {
+        hppDout (warning, "KDTree: distance is not a WeighedDistance, "
+                 "the tree will not prune the search.");
+        return;
+      }
+      const pinocchio::Model& model (robot->model ());
+      if (wd->size () + 1 < model.njoints) return;
+      for (int i = 1; i < model.njoints; ++i) {
+        const ::pinocchio::JointModel& jm (model.joints [i]);
+        const value_type w (wd->getWeight (i-1));
+        const std::string name (jm.shortname ());
+        // The difference of coordinates is a lower bound of the distance
+        // for vector spaces and for (cos, sin) parameterizations of SO(2).
+        // It is not for quaternions since q and -q represent the same
+        // rotation.
+        if (jm.nq () == jm.nv () || (jm.nq () == 2 && jm.nv () == 1) ||
+            name == "JointModelPlanar") {
+          boundWeights_.segment (jm.idx_q (), jm.nq ()).setConstant (w);
+        } else if (name == "JointModelFreeFlyer") {
+          boundWeights_.segment (jm.idx_q (), 3).setConstant (w);
+        }
+      }
+      const size_type extraDim (robot->extraConfigSpace ().dimension ());
+      boundWeights_.tail (extraDim).setOnes ();
+    }
+
+    size_type KDTree::label (const ConnectedComponent* cc) const
+    {
+      Labels_t::const_iterator it = labels_.find (cc);
+      if (it == labels_.end ()) return -1;
+      return findLabel (it->second);
+    }
+
+    size_type KDTree::insertLabel (const ConnectedComponent* cc)
+    {
+      Labels_t::iterator it = labels_.find (cc);
+      if (it != labels_.end ()) return findLabel (it->second);
+      size_type l ((size_type) labelParents_.size ());
+      labelParents_.push_back (l);
+      labelSizes_.push_back (1);
+      labelSeeds_.push_back (-1);
+      labels_.insert (std::make_pair (cc, l));
+      return l;
+    }
+
+    size_type KDTree::findLabel (size_type l) const
+    {
+      // Union by size keeps the chains short. Labels are not compressed
+      // here so that concurrent searches do not write.
+      while (labelParents_ [l] != l) l = labelParents_ [l];
+      return l;
+    }
+
+    void KDTree::allocateBucket (Cell& cell, size_type capacity)
+    {
+      cell.begin = (size_type) bucketPoints_.size ();
+      cell.capacity = capacity;
+      cell.size = 0;
+      bucketPoints_.resize (bucketPoints_.size () + capacity);
+      bucketLabels_.resize (bucketLabels_.size () + capacity);
+    }
+
+    void KDTree::insertInLeaf (size_type cell, size_type point,
+                               size_type label)
+    {
+      Cell& c (cells_ [cell]);
+      assert (c.isLeaf ());
+      if (c.size == c.capacity) {
+        // Move the leaf storage at the end of the bucket array.
+        const size_type oldBegin (c.begin), oldSize (c.size);
+        unusedBucketEntries_ += c.capacity;
+        allocateBucket (c, std::max (bucketSize_, 2 * c.capacity));
+        std::copy (bucketPoints_.begin () + oldBegin,
+                   bucketPoints_.begin () + oldBegin + oldSize,
+                   bucketPoints_.begin () + c.begin);
+        std::copy (bucketLabels_.begin () + oldBegin,
+                   bucketLabels_.begin () + oldBegin + oldSize,
+                   bucketLabels_.begin () + c.begin);
+        c.size = oldSize;
+      }
+      bucketPoints_ [c.begin + c.size] = point;
+      bucketLabels_ [c.begin + c.size] = label;
+      ++c.size;
+      ++c.count;
+    }
+
+    void KDTree::addNode (const NodePtr_t& node)
+    {
+      const Configuration_t& q (*node->configuration ());
+      assert (q.size () == dim_);
+      size_type point ((size_type) nodes_.size ());
+      nodes_.push_back (node);
+      if (configurations_.cols () <= point) {
+        configurations_.conservativeResize
+          (dim_, std::max <size_type> (16, 2 * configurations_.cols ()));
+      }
+      configurations_.col (point) = q;
+      size_type l (insertLabel (node->connectedComponent ().get ()));
+      labelSeeds_ [l] = point;
+
+      if (cells_.empty ()) {
+        cells_.push_back (Cell ());
+        allocateBucket (cells_.back (), bucketSize_);
+      }
+      // Descend to the leaf and find the highest unbalanced cell.
+      size_type current (0), scapegoat (-1);
+      while (!cells_ [current].isLeaf ()) {
+        Cell& c (cells_ [current]);
+        ++c.count;
+        const size_type next
+          ((q [c.splitDim] <= c.splitValue) ? c.inf : c.sup);
+        if (scapegoat < 0 && c.count > 4 * bucketSize_ &&
+            4 * (cells_ [next].count + 1) > 3 * c.count)
+          scapegoat = current;
+        current = next;
+      }
+      insertInLeaf (current, point, l);
+      if (scapegoat >= 0) {
+        hppDout (info, "KDTree: rebuild subtree of " <<
+                 cells_ [scapegoat].count << " points.");
+        rebuild (scapegoat);
+      } else {
+        const Cell& leaf (cells_ [current]);
+        if (leaf.size > bucketSize_ && leaf.size > leaf.splitSize)
+          rebuild (current);
+      }
+      if (2 * unusedBucketEntries_ > (size_type) bucketPoints_.size ())
+        compactBuckets ();
+    }
+
+    void KDTree::addNodes (const NodeVector_t& nodes)
+    {
+      if (nodes.empty ()) return;
+      Entries_t entries;
+      entries.reserve (nodes_.size () - removedPoints_ + nodes.size ());
+      if (!cells_.empty ()) collect (0, entries);
+      const size_type first ((size_type) nodes_.size ());
+      if (configurations_.cols () < first + (size_type) nodes.size ()) {
+        configurations_.conservativeResize
+          (dim_, std::max <size_type> (2 * configurations_.cols (),
+                                       first + (size_type) nodes.size ()));
+      }
+      for (std::size_t i = 0; i < nodes.size (); ++i) {
+        const size_type point (first + (size_type) i);
+        assert (nodes [i]->configuration ()->size () == dim_);
+        nodes_.push_back (nodes [i]);
+        configurations_.col (point) = *nodes [i]->configuration ();
+        size_type l (insertLabel (nodes [i]->connectedComponent ().get ()));
+        labelSeeds_ [l] = point;
+        entries.push_back (Entry_t (point, l));
+      }
+      cells_.clear ();
+      freeCells_.clear ();
+      bucketPoints_.clear ();
+      bucketLabels_.clear ();
+      unusedBucketEntries_ = 0;
+      cells_.push_back (Cell ());
+      build (0, entries, 0, (size_type) entries.size ());
+    }
+
+    void KDTree::removeNode (const NodePtr_t& node)
+    {
+      if (cells_.empty ()) return;
+      const Configuration_t& q (*node->configuration ());
+      // Descend to the leaf as in addNode: points of the inferior child
+      // are below or at the split value.
+      Indices_t path;
+      size_type current (0);
+      while (!cells_ [current].isLeaf ()) {
+        path.push_back (current);
+        const Cell& c (cells_ [current]);
+        current = (q [c.splitDim] <= c.splitValue) ? c.inf : c.sup;
+      }
+      Cell& leaf (cells_ [current]);
+      size_type i (leaf.begin);
+      while (i < leaf.begin + leaf.size && nodes_ [bucketPoints_ [i]] != node)
+        ++i;
+      if (i == leaf.begin + leaf.size) {
+        hppDout (warning, "KDTree: removed node is not in the tree.");
+        return;
+      }
+      const size_type point (bucketPoints_ [i]),
+        last (leaf.begin + leaf.size - 1);
+      bucketPoints_ [i] = bucketPoints_ [last];
+      bucketLabels_ [i] = bucketLabels_ [last];
+      --leaf.size;
+      --leaf.count;
+      for (std::size_t j = 0; j < path.size (); ++j) --cells_ [path [j]].count;
+
+      size_type l (label (node->connectedComponent ().get ()));
+      if (l >= 0 && labelSeeds_ [l] == point) labelSeeds_ [l] = -1;
+      nodes_ [point] = NULL;
+      ++removedPoints_;
+      if (2 * removedPoints_ > (size_type) nodes_.size ()) compactPoints ();
+    }
+
+    void KDTree::compactPoints ()
+    {
+      Indices_t newIndex (nodes_.size (), -1);
+      size_type n (0);
+      for (size_type p = 0; p < (size_type) nodes_.size (); ++p) {
+        if (!nodes_ [p]) continue;
+        newIndex [p] = n;
+        configurations_.col (n) = configurations_.col (p);
+        nodes_ [n] = nodes_ [p];
+        ++n;
+      }
+      nodes_.resize (n);
+      removedPoints_ = 0;
+      for (std::size_t l = 0; l < labelSeeds_.size (); ++l)
+        if (labelSeeds_ [l] >= 0) labelSeeds_ [l] = newIndex [labelSeeds_ [l]];
+
+      Entries_t entries;
+      entries.reserve (n);
+      collect (0, entries);
+      for (std::size_t i = 0; i < entries.size (); ++i)
+        entries [i].first = newIndex [entries [i].first];
+      cells_.clear ();
+      freeCells_.clear ();
+      bucketPoints_.clear ();
+      bucketLabels_.clear ();
+      unusedBucketEntries_ = 0;
+      if (n == 0) return;
+      cells_.push_back (Cell ());
+      build (0, entries, 0, n);
+    }
+
+    size_type KDTree::newCell ()
+    {
+      if (freeCells_.empty ()) {
+        cells_.push_back (Cell ());
+        return (size_type) cells_.size () - 1;
+      }
+      size_type cell (freeCells_.back ());
+      freeCells_.pop_back ();
+      cells_ [cell] = Cell ();
+      return cell;
+    }
+
+    void KDTree::collect (size_type cell, Entries_t& entries)
+    {
+      const Cell& c (cells_ [cell]);
+      if (c.isLeaf ()) {
+        for (size_type i = c.begin; i < c.begin + c.size; ++i)
+          entries.push_back (Entry_t (bucketPoints_ [i], bucketLabels_ [i]));
+        unusedBucketEntries_ += c.capacity;
+        return;
+      }
+      const size_type inf (c.inf), sup (c.sup);
+      collect (inf, entries);
+      collect (sup, entries);
+      freeCells_.push_back (inf);
+      freeCells_.push_back (sup);
+    }
+
+    namespace {
+      struct CoordinateLess
+      {
+        CoordinateLess (const matrix_t& m, size_type d) : m_ (m), d_ (d) {}
+        bool operator () (const std::pair <size_type, size_type>& a,
+                          const std::pair <size_type, size_type>& b) const
+        {
+          return m_ (d_, a.first) < m_ (d_, b.first);
+        }
+        const matrix_t& m_;
+        size_type d_;
+      };
+
+      struct CoordinateBelow
+      {
+        CoordinateBelow (const matrix_t& m, size_type d, value_type v) :
+          m_ (m), d_ (d), v_ (v) {}
+        bool operator () (const std::pair <size_type, size_type>& a) const
+        {
+          return m_ (d_, a.first) <= v_;
+        }
+        const matrix_t& m_;
+        size_type d_;
+        value_type v_;
+      };
+    } // namespace
+
+    void KDTree::makeLeaf (size_type cell, const Entries_t& entries,
+                           size_type begin, size_type end)
+    {
+      Cell c;
+      const size_type n (end - begin);
+      allocateBucket (c, std::max (bucketSize_, n));
+      for (size_type i = begin; i < end; ++i) {
+        bucketPoints_ [c.begin + c.size] = entries [i].first;
+        bucketLabels_ [c.begin + c.size] = entries [i].second;
+        ++c.size;
+      }
+      c.count = n;
+      cells_ [cell] = c;
+    }
+
+    void KDTree::build (size_type cell, Entries_t& entries,
+                        size_type begin, size_type end)
+    {
+      const size_type n (end - begin);
+      if (n <= bucketSize_) {
+        makeLeaf (cell, entries, begin, end);
+        return;
+      }
+      // Compute actual bounds of the points
+      vector_t lower (vector_t::Constant
+                      (dim_, +std::numeric_limits <value_type>::infinity ()));
+      vector_t upper (vector_t::Constant
+                      (dim_, -std::numeric_limits <value_type>::infinity ()));
+      for (size_type i = begin; i < end; ++i) {
+        const size_type p (entries [i].first);
+        lower = lower.cwiseMin (configurations_.col (p));
+        upper = upper.cwiseMax (configurations_.col (p));
+      }
+      // Split the widest weighted dimension
       size_type splitDim;
-      for (size_type i=0 ; i < actualUpper.size (); i++) {
-	if ((actualUpper [i] - actualLower [i]) * weights_ [i] > dimWidth ) {
-	  dimWidth =  actualUpper [i] - actualLower [i];
-	  splitDim = i;
-	}
-      }
-
-      // Compute median value of coordinates
-      infChild_ = new KDTree (this, splitDim);
-      infChild_->upperBounds_ [splitDim] = (actualUpper [splitDim] +
-					    actualLower [splitDim])/2;
-      supChild_ = new KDTree(this, splitDim);
-      supChild_->lowerBounds_ [splitDim] = (actualUpper [splitDim] +
-					    actualLower [splitDim])/2;
-    }
-
-    // get joints limits
-    void KDTree::findDeviceBounds ()
-    {
-      JointVector_t jv = robot_->getJointVector ();
-      int i=0;
-      upperBounds_.resize (robot_->configSize ());
-      lowerBounds_.resize (robot_->configSize ());
-      for (JointVector_t::const_iterator itJoint = jv.begin ();
-	   itJoint != jv.end (); ++itJoint) {
-	for (size_type rank=0 ; rank<(*itJoint)->configSize (); rank++) {
-	  upperBounds_[i] = (*itJoint)->upperBound (rank);
-	  lowerBounds_[i] = (*itJoint)->lowerBound (rank);
-	  ++i;
-	}
-      }
-      const pinocchio::ExtraConfigSpace& ecs = robot_->extraConfigSpace ();
-      for (size_type rank = 0; rank < ecs.dimension (); ++rank) {
-	upperBounds_[i] = ecs.upper (rank);
-	lowerBounds_[i] = ecs.lower (rank);
-	++i;
-      }
-    }
-
-
-    value_type KDTree::distanceToBox (const Configuration_t& configuration) {
-      value_type minDistance;
-      value_type DistanceToUpperBound;
-      value_type DistanceToLowerBound;
-      // Projection of the configuration on the box
-      Configuration_t confbox = configuration;
-
-      DistanceToLowerBound = fabs (lowerBounds_[splitDim_] -
-				   configuration [splitDim_])
-	* weights_ [splitDim_];
-      DistanceToUpperBound = fabs (upperBounds_[splitDim_] -
-				   configuration[splitDim_])
-	* weights_ [splitDim_];
-      minDistance = std::min (DistanceToLowerBound, DistanceToUpperBound);
-      return minDistance;
+      value_type width =
+        (boundWeights_.cwiseProduct (upper - lower)).maxCoeff (&splitDim);
+      if (!(width > 0)) {
+        // All points are identical in the coordinates used for pruning.
+        // Let the leaf grow before trying again.
+        makeLeaf (cell, entries, begin, end);
+        cells_ [cell].splitSize = 2 * n;
+        return;
+      }
+      // Split at the median
+      Entries_t::iterator first (entries.begin () + begin),
+        median (entries.begin () + begin + n / 2 - 1),
+        last (entries.begin () + end);
+      std::nth_element (first, median, last,
+                        CoordinateLess (configurations_, splitDim));
+      value_type splitValue (configurations_ (splitDim, median->first));
+      Entries_t::iterator middle (std::partition
+          (first, last, CoordinateBelow (configurations_, splitDim,
+                                         splitValue)));
+      if (middle == last) {
+        // Too many points equal to the median: split at the middle of the
+        // bounds, which separates the points since width > 0.
+        splitValue = (lower [splitDim] + upper [splitDim]) / 2;
+        middle = std::partition (first, last, CoordinateBelow
+                                 (configurations_, splitDim, splitValue));
+        if (middle == first || middle == last) {
+          // Bounds are too close to be separated numerically.
+          makeLeaf (cell, entries, begin, end);
+          cells_ [cell].splitSize = 2 * n;
+          return;
+        }
+      }
+      const size_type iInf (newCell ()), iSup (newCell ());
+      Cell& c (cells_ [cell]);
+      c = Cell ();
+      c.inf = iInf;
+      c.sup = iSup;
+      c.splitDim = splitDim;
+      c.splitValue = splitValue;
+      c.count = n;
+      const size_type m (begin + (middle - first));
+      build (iInf, entries, begin, m);
+      build (iSup, entries, m, end);
+    }
+
+    void KDTree::rebuild (size_type cell)
+    {
+      Entries_t entries;
+      entries.reserve (cells_ [cell].count);
+      collect (cell, entries);
+      build (cell, entries, 0, (size_type) entries.size ());
+    }
+
+    void KDTree::compactBuckets ()
+    {
+      Indices_t points, labels;
+      points.reserve (bucketPoints_.size () - unusedBucketEntries_);
+      labels.reserve (bucketPoints_.size () - unusedBucketEntries_);
+      // Store leaves in depth first order.
+      Indices_t stack (1, 0);
+      while (!stack.empty ()) {
+        Cell& c (cells_ [stack.back ()]);
+        stack.pop_back ();
+        if (c.isLeaf ()) {
+          const size_type begin ((size_type) points.size ());
+          points.insert (points.end (), bucketPoints_.begin () + c.begin,
+                         bucketPoints_.begin () + c.begin + c.capacity);
+          labels.insert (labels.end (), bucketLabels_.begin () + c.begin,
+                         bucketLabels_.begin () + c.begin + c.capacity);
+          c.begin = begin;
+        } else {
+          stack.push_back (c.sup);
+          stack.push_back (c.inf);
+        }
+      }
+      bucketPoints_.swap (points);
+      bucketLabels_.swap (labels);
+      unusedBucketEntries_ = 0;
+    }
+
+    size_type KDTree::depth () const
+    {
+      if (cells_.empty ()) return 0;
+      size_type result (0);
+      std::vector <std::pair <size_type, size_type> > stack
+        (1, std::pair <size_type, size_type> (0, 1));
+      while (!stack.empty ()) {
+        const size_type cell (stack.back ().first), d (stack.back ().second);
+        stack.pop_back ();
+        const Cell& c (cells_ [cell]);
+        if (c.isLeaf ()) {
+          result = std::max (result, d);
+        } else {
+          stack.push_back (std::make_pair (c.inf, d + 1));
+          stack.push_back (std::make_pair (c.sup, d + 1));
+        }
+      }
+      return result;
+    }
+
+    value_type KDTree::averageDepth () const
+    {
+      if (cells_.empty ()) return 0;
+      value_type sum (0);
+      size_type points (0);
+      std::vector <std::pair <size_type, size_type> > stack
+        (1, std::pair <size_type, size_type> (0, 1));
+      while (!stack.empty ()) {
+        const size_type cell (stack.back ().first), d (stack.back ().second);
+        stack.pop_back ();
+        const Cell& c (cells_ [cell]);
+        if (c.isLeaf ()) {
+          sum += (value_type) (d * c.size);
+          points += c.size;
+        } else {
+          stack.push_back (std::make_pair (c.inf, d + 1));
+          stack.push_back (std::make_pair (c.sup, d + 1));
+        }
+      }
+      return points > 0 ? sum / (value_type) points : 0;
+    }
+
+    std::size_t KDTree::memory () const
+    {
+      // Nodes of the map of labels: the pair and three pointers.
+      const std::size_t labelBytes
+        (sizeof (Labels_t::value_type) + 3 * sizeof (void*));
+      return sizeof (KDTree) + cells_.capacity () * sizeof (Cell) +
+        (std::size_t) configurations_.size () * sizeof (value_type) +
+        (std::size_t) boundWeights_.size () * sizeof (value_type) +
+        nodes_.capacity () * sizeof (NodePtr_t) +
+        (bucketPoints_.capacity () + bucketLabels_.capacity () +
+         freeCells_.capacity () + labelParents_.capacity () +
+         labelSizes_.capacity () + labelSeeds_.capacity ()) *
+        sizeof (size_type) + labels_.size () * labelBytes;
+    }
+
+    void KDTree::clear()
+    {
+      cells_.clear ();
+      nodes_.clear ();
+      configurations_.resize (dim_, 0);
+      bucketPoints_.clear ();
+      bucketLabels_.clear ();
+      labels_.clear ();
+      labelParents_.clear ();
+      labelSizes_.clear ();
+      labelSeeds_.clear ();
+      freeCells_.clear ();
+      unusedBucketEntries_ = 0;
+      removedPoints_ = 0;
+    }
+
+    value_type KDTree::computeDistance (ConfigurationIn_t q,
+                                        size_type point, bool reverse) const
+    {
+      if (reverse)
+        return (*distance_) (q, configurations_.col (point));
+      else
+        return (*distance_) (configurations_.col (point), q);
+    }
+
+    value_type KDTree::computeLowerBound (ConfigurationIn_t q,
+                                          size_type point, bool reverse) const
+    {
+      if (reverse)
+        return distance_->lowerBound (q, configurations_.col (point));
+      else
+        return distance_->lowerBound (configurations_.col (point), q);
+    }
+
+    void KDTree::search (size_type cell, const Configuration_t& q,
+                         size_type ccLabel, value_type boxDistance,
+                         vector_t& offsets, Candidates& candidates,
+                         bool reverse) const
+    {
+      // boxDistance is a squared distance
+      if (squaredFactor_ * boxDistance >= candidates.squaredWorst ()) return;
+      const Cell& c (cells_ [cell]);
+      if (c.isLeaf ()) {
+        for (size_type i = c.begin; i < c.begin + c.size; ++i) {
+          if (ccLabel >= 0 && findLabel (bucketLabels_ [i]) != ccLabel)
+            continue;
+          const size_type p (bucketPoints_ [i]);
+          if (computeLowerBound (q, p, reverse) >= candidates.worst ())
+            continue;
+          candidates.push (computeDistance (q, p, reverse), nodes_ [p]);
+        }
+        return;
+      }
+      const size_type d (c.splitDim);
+      const value_type diff (q [d] - c.splitValue);
+      size_type nearChild, farChild;
+      if (diff <= 0) { nearChild = c.inf; farChild = c.sup; }
+      else           { nearChild = c.sup; farChild = c.inf; }
+      search (nearChild, q, ccLabel, boxDistance, offsets, candidates,
+              reverse);
+      const value_type w (boundWeights_ [d]), oldOffset (offsets [d]);
+      const value_type farDistance (boxDistance
+          + w * w * (diff * diff - oldOffset * oldOffset));
+      if (squaredFactor_ * farDistance < candidates.squaredWorst ()) {
+        offsets [d] = diff;
+        search (farChild, q, ccLabel, farDistance, offsets, candidates,
+                reverse);
+        offsets [d] = oldOffset;
+      }
+    }
+
+    void KDTree::search (size_type cell, const matrix_t& queries,
+                         const Queries_t& active, matrix_t& offsets,
+                         std::vector <Candidates>& candidates) const
+    {
+      const Cell& c (cells_ [cell]);
+      if (c.isLeaf ()) {
+        Queries_t remaining;
+        remaining.reserve (active.size ());
+        for (std::size_t j = 0; j < active.size (); ++j)
+          if (squaredFactor_ * active [j].second <
+              candidates [active [j].first].squaredWorst ())
+            remaining.push_back (active [j]);
+        // Iterate on points first so that each point is loaded once.
+        for (size_type i = c.begin; i < c.begin + c.size; ++i) {
+          const size_type p (bucketPoints_ [i]);
+          for (std::size_t j = 0; j < remaining.size (); ++j) {
+            const size_type k (remaining [j].first);
+            if (computeLowerBound (queries.col (k), p, false) >=
+                candidates [k].worst ()) continue;
+            candidates [k].push (computeDistance (queries.col (k), p, false),
+                                 nodes_ [p]);
+          }
+        }
+        return;
+      }
+      const size_type d (c.splitDim);
+      const value_type w (boundWeights_ [d]);
+      // Queries closer to the inferior (resp. superior) child
+      Queries_t nearInf, nearSup;
+      for (std::size_t j = 0; j < active.size (); ++j) {
+        const Query_t& query (active [j]);
+        if (squaredFactor_ * query.second >=
+            candidates [query.first].squaredWorst ()) continue;
+        if (queries (d, query.first) <= c.splitValue)
+          nearInf.push_back (query);
+        else
+          nearSup.push_back (query);
+      }
+      if (!nearInf.empty ()) search (c.inf, queries, nearInf, offsets,
+                                     candidates);
+      if (!nearSup.empty ()) search (c.sup, queries, nearSup, offsets,
+                                     candidates);
+      // Visit the far children with updated lower bounds
+      for (int side = 0; side < 2; ++side) {
+        const Queries_t& near (side == 0 ? nearInf : nearSup);
+        Queries_t far;
+        vector_t oldOffsets (near.size ());
+        for (std::size_t j = 0; j < near.size (); ++j) {
+          const size_type k (near [j].first);
+          const value_type diff (queries (d, k) - c.splitValue);
+          const value_type oldOffset (offsets (d, k));
+          const value_type farDistance (near [j].second
+              + w * w * (diff * diff - oldOffset * oldOffset));
+          if (squaredFactor_ * farDistance < candidates [k].squaredWorst ()) {
+            oldOffsets [far.size ()] = oldOffset;
+            offsets (d, k) = diff;
+            far.push_back (Query_t (k, farDistance));
+          }
+        }
+        if (far.empty ()) continue;
+        search (side == 0 ? c.sup : c.inf, queries, far, offsets, candidates);
+        for (std::size_t j = 0; j < far.size (); ++j)
+          offsets (d, far [j].first) = oldOffsets [j];
+      }
     }
 
     NodePtr_t KDTree::search (const Configuration_t& configuration,
-            const ConnectedComponentPtr_t& connectedComponent,
-                              value_type& minDistance, bool) {
-      // Test if the configuration is in the root box
-      for ( std::size_t i=0 ; i<dim_ ; i++ ) {
-	if ( configuration[i] < lowerBounds_[i] || configuration[i]
-	     > upperBounds_[i] ) {
-	  std::ostringstream oss ("The Configuration isn't in the root box: \n"
-				  "  i = ");
-	  oss << i << ", lower = " << lowerBounds_[i] << ", config = "
-	      << configuration[i] << ", upper = " << upperBounds_[i]
-	      << ".";
-	  throw std::runtime_error (oss.str ());
-	}
-      }
-      value_type boxDistance = 0.;
-      NodePtr_t nearest = NULL;
-      minDistance = std::numeric_limits <value_type>::infinity ();
-      this->search (boxDistance, minDistance, configuration,
-		    connectedComponent, nearest);
-      assert (nearest);
-      return nearest;
+                              const ConnectedComponentPtr_t& connectedComponent,
+                              value_type& minDistance, bool reverse)
+    {
+      Candidates candidates (1);
+      size_type l (label (connectedComponent.get ()));
+      if (l >= 0) {
+        // Seed the search with the last point inserted in the connected
+        // component so that branches not containing the connected
+        // component are pruned.
+        const size_type seed (labelSeeds_ [l]);
+        if (seed >= 0)
+          candidates.push (computeDistance (configuration, seed, reverse),
+                           nodes_ [seed]);
+        vector_t offsets (vector_t::Zero (dim_));
+        search (0, configuration, l, 0., offsets, candidates, reverse);
+      }
+      Nodes_t nodes (candidates.nodes (minDistance));
+      assert (!nodes.empty ());
+      if (nodes.empty ()) return NULL;
+      return nodes.front ();
+    }
+
+    void KDTree::search (size_type cell, const Configuration_t& q,
+                         value_type boxDistance, vector_t& offsets,
+                         BestInConnectedComponents& best, bool reverse) const
+    {
+      // boxDistance is a squared distance
+      if (squaredFactor_ * boxDistance >= best.worst * best.worst) return;
+      const Cell& c (cells_ [cell]);
+      if (c.isLeaf ()) {
+        for (size_type i = c.begin; i < c.begin + c.size; ++i) {
+          const size_type l (findLabel (bucketLabels_ [i]));
+          LabelRanks_t::const_iterator it (std::lower_bound
+              (best.labelRanks.begin (), best.labelRanks.end (),
+               std::make_pair (l, (size_type) -1)));
+          if (it == best.labelRanks.end () || it->first != l) continue;
+          const size_type rank (it->second), p (bucketPoints_ [i]);
+          if (computeLowerBound (q, p, reverse) >= best.distances [rank])
+            continue;
+          const value_type d (computeDistance (q, p, reverse));
+          if (d < best.distances [rank]) {
+            const bool wasWorst (best.distances [rank] == best.worst);
+            best.distances [rank] = d;
+            best.nodes [rank] = nodes_ [p];
+            if (wasWorst) best.worst = best.distances.maxCoeff ();
+          }
+        }
+        return;
+      }
+      const size_type d (c.splitDim);
+      const value_type diff (q [d] - c.splitValue);
+      size_type nearChild, farChild;
+      if (diff <= 0) { nearChild = c.inf; farChild = c.sup; }
+      else           { nearChild = c.sup; farChild = c.inf; }
+      search (nearChild, q, boxDistance, offsets, best, reverse);
+      const value_type w (boundWeights_ [d]), oldOffset (offsets [d]);
+      const value_type farDistance (boxDistance
+          + w * w * (diff * diff - oldOffset * oldOffset));
+      if (squaredFactor_ * farDistance < best.worst * best.worst) {
+        offsets [d] = diff;
+        search (farChild, q, farDistance, offsets, best, reverse);
+        offsets [d] = oldOffset;
+      }
+    }
+
+    NodeVector_t KDTree::searchInConnectedComponents
+    (const Configuration_t& configuration,
+     const ConnectedComponents_t& connectedComponents,
+     vector_t& distances, bool reverse)
+    {
+      BestInConnectedComponents best;
+      const size_type n ((size_type) connectedComponents.size ());
+      best.nodes.resize (n, NULL);
+      best.distances = vector_t::Constant
+        (n, std::numeric_limits <value_type>::infinity ());
+      best.labelRanks.reserve (n);
+      size_type rank = 0;
+      for (ConnectedComponents_t::const_iterator itcc
+             (connectedComponents.begin ());
+           itcc != connectedComponents.end (); ++itcc, ++rank) {
+        size_type l (label (itcc->get ()));
+        if (l < 0) {
+          // Not in the tree: excluded from the largest distance until the
+          // end of the search.
+          best.distances [rank] = 0;
+          continue;
+        }
+        best.labelRanks.push_back (std::make_pair (l, rank));
+        // Seed with the last point inserted in the connected component.
+        const size_type seed (labelSeeds_ [l]);
+        if (seed >= 0) {
+          best.distances [rank] = computeDistance (configuration, seed,
+                                                   reverse);
+          best.nodes [rank] = nodes_ [seed];
+        } else {
+          best.distances [rank] = std::numeric_limits <value_type>::infinity ();
+        }
+      }
+      std::sort (best.labelRanks.begin (), best.labelRanks.end ());
+      best.worst = (n > 0) ? best.distances.maxCoeff () : 0;
+      if (!best.labelRanks.empty ()) {
+        vector_t offsets (vector_t::Zero (dim_));
+        search (0, configuration, 0., offsets, best, reverse);
+      }
+      for (size_type i = 0; i < n; ++i)
+        if (!best.nodes [i])
+          best.distances [i] = std::numeric_limits <value_type>::infinity ();
+      distances = best.distances;
+      return best.nodes;
     }
 
     NodePtr_t KDTree::search (const NodePtr_t& node,
@@ -266,100 +867,154 @@ namespace hpp {
       return search (*node->configuration (), connectedComponent, minDistance);
     }
 
-    Nodes_t KDTree::KnearestSearch (const NodePtr_t&,
-        const ConnectedComponentPtr_t&, const std::size_t,
-        value_type&)
+    Nodes_t KDTree::knearest (const Configuration_t& q, size_type ccLabel,
+                              std::size_t K, value_type& distance) const
     {
-      assert (false && "K-nearest neighbor in KD-tree: unimplemented features");
+      Candidates candidates (K);
+      if (K > 0 && !cells_.empty ()) {
+        vector_t offsets (vector_t::Zero (dim_));
+        search (0, q, ccLabel, 0., offsets, candidates, false);
+      }
+      return candidates.nodes (distance);
     }
 
-    Nodes_t KDTree::KnearestSearch (const Configuration_t&,
-        const ConnectedComponentPtr_t&, const std::size_t,
-        value_type&)
+    Nodes_t KDTree::KnearestSearch (const NodePtr_t& node,
+        const ConnectedComponentPtr_t& connectedComponent, const std::size_t K,
+        value_type& distance)
     {
-      assert (false && "K-nearest neighbor in KD-tree: unimplemented features");
+      return KnearestSearch (*node->configuration (), connectedComponent, K,
+                             distance);
     }
 
     Nodes_t KDTree::KnearestSearch (const Configuration_t& configuration,
-                                    const RoadmapPtr_t& roadmap,
+        const ConnectedComponentPtr_t& connectedComponent, const std::size_t K,
+        value_type& distance)
+    {
+      size_type l (label (connectedComponent.get ()));
+      if (l < 0) {
+        distance = std::numeric_limits <value_type>::infinity ();
+        return Nodes_t ();
+      }
+      return knearest (configuration, l, K, distance);
+    }
+
+    Nodes_t KDTree::KnearestSearch (const Configuration_t& configuration,
+                                    const RoadmapPtr_t&,
                                     const std::size_t K, value_type& distance)
     {
-      assert (false && "K-nearest neighbor in KD-tree: unimplemented features");
-    }
-
-    void KDTree::search (value_type boxDistance, value_type& minDistance,
-			 const Configuration_t& configuration,
-			 const ConnectedComponentPtr_t& connectedComponent,
-       NodePtr_t& nearest,bool reverse) {
-      if ( boxDistance < minDistance*minDistance
-	   && nodesMap_.count(connectedComponent) > 0 ) {
-	// minDistance^2 because boxDistance is a squared distance
-	if ( infChild_ == NULL || supChild_ == NULL ) {
-	  value_type distance = std::numeric_limits <value_type>::infinity ();
-	  for (Nodes_t::iterator itNode =
-		 nodesMap_[connectedComponent].begin ();
-	       itNode != nodesMap_[connectedComponent].end (); ++itNode) {
-      if(reverse)
-        distance = (*distance_) (configuration,*((*itNode)->configuration ()));
-      else
-        distance = (*distance_) (*((*itNode)->configuration ()),configuration);
-	    if (distance < minDistance) {
-	      minDistance = distance;
-	      nearest = (*itNode);
-	    }
-	  }
-	}
-	else {
-	  // find config to boxes distances
-	  value_type distanceToInfChild;
-	  value_type distanceToSupChild;
-	  if ( boxDistance == 0. ) {
-	    if ( configuration [supChild_->splitDim_]
-		 > supChild_->lowerBounds_[supChild_->splitDim_])  {
-	      distanceToSupChild = 0.;
-	      distanceToInfChild = infChild_->distanceToBox(configuration);
-	    }
-	    else {
-	      distanceToInfChild = 0.;
-	      distanceToSupChild = supChild_->distanceToBox(configuration);
-	    }
-	  }
-	  else {
-	    distanceToInfChild = infChild_->distanceToBox(configuration);
-	    distanceToSupChild = supChild_->distanceToBox(configuration);
-	  }
-	  // search in the children
-	  if ( distanceToInfChild < distanceToSupChild ) {
-	    infChild_->search(boxDistance, minDistance,
-			      configuration, connectedComponent, nearest);
-	    supChild_->search(boxDistance -
-			      distanceToInfChild*distanceToInfChild +
-			      distanceToSupChild*distanceToSupChild,
-			      minDistance, configuration, connectedComponent,
-			      nearest );
-	  }
-	  else {
-	    supChild_->search(boxDistance,minDistance,
-			      configuration, connectedComponent, nearest);
-	    infChild_->search(boxDistance -
-			      distanceToSupChild*distanceToSupChild +
-			      distanceToInfChild*distanceToInfChild,
-			      minDistance, configuration, connectedComponent,
-			      nearest);
-	  }
-	}
-      }
-    }
-
-    void KDTree::merge(ConnectedComponentPtr_t cc1,
-		       ConnectedComponentPtr_t cc2) {
-      nodesMap_[cc1].merge(nodesMap_[cc2]);
-      NodesMap_t::iterator it = nodesMap_.find (cc2);
-      nodesMap_.erase(it);
-      if ( infChild_ != NULL || supChild_ != NULL ) {
-	infChild_->merge(cc1, cc2);
-	supChild_->merge(cc1, cc2);
+      return knearest (configuration, -1, K, distance);
+    }
+
+    std::vector <Nodes_t> KDTree::KnearestSearch
+    (const matrix_t& configurations, const RoadmapPtr_t&,
+     const std::size_t K, vector_t& distances)
+    {
+      const size_type n (configurations.cols ());
+      std::vector <Candidates> candidates ((std::size_t) n, Candidates (K));
+      if (K > 0 && !cells_.empty ()) {
+        Queries_t active;
+        active.reserve (n);
+        for (size_type i = 0; i < n; ++i) active.push_back (Query_t (i, 0.));
+        matrix_t offsets (matrix_t::Zero (dim_, n));
+        search (0, configurations, active, offsets, candidates);
       }
+      std::vector <Nodes_t> result ((std::size_t) n);
+      distances.resize (n);
+      for (size_type i = 0; i < n; ++i)
+        result [i] = candidates [i].nodes (distances [i]);
+      return result;
+    }
+
+    void KDTree::withinBall (size_type cell, const Configuration_t& q,
+                             size_type ccLabel, value_type maxDistance,
+                             value_type boxDistance, vector_t& offsets,
+                             NodeVector_t& nodes) const
+    {
+      // boxDistance is a squared distance
+      if (boxDistance >= maxDistance * maxDistance) return;
+      const Cell& c (cells_ [cell]);
+      if (c.isLeaf ()) {
+        for (size_type i = c.begin; i < c.begin + c.size; ++i) {
+          if (findLabel (bucketLabels_ [i]) != ccLabel) continue;
+          const size_type p (bucketPoints_ [i]);
+          if (computeLowerBound (q, p, false) >= maxDistance) continue;
+          if (computeDistance (q, p, false) < maxDistance)
+            nodes.push_back (nodes_ [p]);
+        }
+        return;
+      }
+      const size_type d (c.splitDim);
+      const value_type diff (q [d] - c.splitValue);
+      size_type nearChild, farChild;
+      if (diff <= 0) { nearChild = c.inf; farChild = c.sup; }
+      else           { nearChild = c.sup; farChild = c.inf; }
+      withinBall (nearChild, q, ccLabel, maxDistance, boxDistance, offsets,
+                  nodes);
+      const value_type w (boundWeights_ [d]), oldOffset (offsets [d]);
+      offsets [d] = diff;
+      withinBall (farChild, q, ccLabel, maxDistance, boxDistance
+                  + w * w * (diff * diff - oldOffset * oldOffset), offsets,
+                  nodes);
+      offsets [d] = oldOffset;
+    }
+
+    NodeVector_t KDTree::withinBall (const Configuration_t& q,
+                                     const ConnectedComponentPtr_t& cc,
+                                     value_type maxDistance)
+    {
+      NodeVector_t nodes;
+      size_type l (label (cc.get ()));
+      if (l < 0 || cells_.empty ()) return nodes;
+      vector_t offsets (vector_t::Zero (dim_));
+      withinBall (0, q, l, maxDistance, 0., offsets, nodes);
+      return nodes;
+    }
+
+    NodeVector_t KDTree::withinBall (const Configuration_t& q,
+                                     const ConnectedComponentPtr_t& cc,
+                                     value_type maxDistance,
+                                     size_type maxNodes)
+    {
+      NodeVector_t nodes;
+      size_type l (label (cc.get ()));
+      if (l < 0 || cells_.empty () || maxNodes <= 0) return nodes;
+      Candidates candidates ((std::size_t) maxNodes, maxDistance);
+      vector_t offsets (vector_t::Zero (dim_));
+      search (0, q, l, 0., offsets, candidates, false);
+      value_type distance;
+      Nodes_t nearest (candidates.nodes (distance));
+      nodes.assign (nearest.begin (), nearest.end ());
+      return nodes;
+    }
+
+    void KDTree::merge (ConnectedComponentPtr_t cc1,
+		        ConnectedComponentPtr_t cc2)
+    {
+      Labels_t::iterator it2 (labels_.find (cc2.get ()));
+      if (it2 == labels_.end ()) return;
+      size_type l2 (findLabel (it2->second));
+      labels_.erase (it2);
+      Labels_t::iterator it1 (labels_.find (cc1.get ()));
+      if (it1 == labels_.end ()) {
+        labels_.insert (std::make_pair (cc1.get (), l2));
+        return;
+      }
+      size_type l1 (findLabel (it1->second));
+      if (l1 == l2) return;
+      if (labelSizes_ [l1] < labelSizes_ [l2]) {
+        labelSeeds_ [l2] = labelSeeds_ [l1];
+        std::swap (l1, l2);
+      }
+      labelParents_ [l2] = l1;
+      labelSizes_ [l1] += labelSizes_ [l2];
+      if (labelSeeds_ [l1] < 0) labelSeeds_ [l1] = labelSeeds_ [l2];
+    }
+
+    NearestNeighborPtr_t createKDTree (const DevicePtr_t& robot,
+                                       const DistancePtr_t& distance,
+                                       size_type bucketSize)
+    {
+      return new KDTree (robot, distance, (int) bucketSize);
     }
     } // namespace nearestNeighbor
   } // namespace core
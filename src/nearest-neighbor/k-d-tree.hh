@@ -19,6 +19,9 @@
 #ifndef HPP_CORE_NEAREST_NEIGHBOR_K_D_TREE_HH
 # define HPP_CORE_NEAREST_NEIGHBOR_K_D_TREE_HH
 
+# include <map>
+# include <vector>
+
 # include <hpp/core/distance.hh>
 # include <hpp/core/node.hh>
 # include <hpp/pinocchio/joint.hh>
@@ -28,24 +31,60 @@
 namespace hpp {
   namespace core {
     namespace nearestNeighbor {
-    // Built an k-dimentional tree for the nearest neighbour research
+    /// k-dimensional tree for nearest neighbor search
+    ///
+    /// The tree is stored flat:
+    /// \li cells (internal nodes and leaves) live in one array and refer to
+    ///     their children by index,
+    /// \li configurations of the roadmap nodes are packed as columns of one
+    ///     matrix,
+    /// \li each leaf owns a contiguous span of a global bucket array that
+    ///     stores point indices and the label of the connected component of
+    ///     each point.
+    ///
+    /// Leaves are split at the median of their points. When a child of a
+    /// cell holds more than 3/4 of the points of the cell, the subtree of the
+    /// cell is rebuilt with median splits, so that the depth of the tree
+    /// stays logarithmic in the number of points.
+    ///
+    /// Connected components are identified by integer labels. Merging
+    /// two connected components is a union of labels and does not walk
+    /// the tree.
+    ///
+    /// Searches do not modify the tree: several threads may search
+    /// concurrently provided no thread modifies the tree at the same time.
+    /// See nearestNeighbor::createConcurrent.
+    ///
+    /// Pruning uses a lower bound of the distance computed from the
+    /// coordinates of the configuration. Coordinates for which the
+    /// difference does not bound the distance (quaternions) are ignored.
+    /// If the distance is not a WeighedDistance, no pruning is performed.
     class KDTree : public NearestNeighbor
     {
     public:
+      /// Constructor
+      /// \param robot the robot the configurations of which are stored,
+      /// \param distance distance used to compare configurations,
+      /// \param bucketSize maximal number of points in a leaf.
+      KDTree (const DevicePtr_t& robot, const DistancePtr_t& distance,
+	      int bucketSize);
 
-      //constructor
-      KDTree(const KDTreePtr_t mother, size_type splitDim);
-      KDTree(const DevicePtr_t& robot, const DistancePtr_t& distance_,
-	     int bucketSize);
-
-      //destructor
-      virtual ~KDTree();
+      virtual ~KDTree ();
 
       // add a configuration in the KDTree
-      virtual void addNode(const NodePtr_t& node);
+      virtual void addNode (const NodePtr_t& node);
+
+      /// Add several nodes and rebuild the whole tree once
+      virtual void addNodes (const NodeVector_t& nodes);
+
+      /// Remove a node from the tree
+      ///
+      /// The storage of removed points is reclaimed and the tree rebuilt
+      /// when removed points outnumber the points in the tree.
+      virtual void removeNode (const NodePtr_t& node);
 
       // Clear all the nodes in the KDTree
-      virtual void clear();
+      virtual void clear ();
 
       // search nearest node
       virtual NodePtr_t search (const Configuration_t& configuration,
@@ -59,6 +98,14 @@ namespace hpp {
 				connectedComponent,
 				value_type& minDistance);
 
+      /// Return the nearest node of each connected component
+      ///
+      /// The tree is traversed once for all the connected components.
+      virtual NodeVector_t searchInConnectedComponents
+      (const Configuration_t& configuration,
+       const ConnectedComponents_t& connectedComponents,
+       vector_t& distances, bool reverse = false);
+
       virtual Nodes_t KnearestSearch (const NodePtr_t& configuration,
                                       const ConnectedComponentPtr_t&
                                         connectedComponent,
@@ -82,61 +129,231 @@ namespace hpp {
                                       const std::size_t K,
 			              value_type& distance);
 
+      /// Return the K nearest nodes in the whole roadmap of several
+      /// configurations
+      ///
+      /// The tree is traversed once for all the configurations. Points of
+      /// a leaf are compared to all the configurations that reach the leaf.
+      virtual std::vector <Nodes_t> KnearestSearch
+      (const matrix_t& configurations, const RoadmapPtr_t& roadmap,
+       const std::size_t K, vector_t& distances);
+
+      /// Return the nodes of a connected component within a ball
+      ///
+      /// Cells farther than maxDistance are pruned.
+      virtual NodeVector_t withinBall (const Configuration_t& configuration,
+                                       const ConnectedComponentPtr_t& cc,
+                                       value_type maxDistance);
+
+      /// Return at most maxNodes nodes of a connected component within a
+      /// ball, sorted by increasing distance.
+      ///
+      /// Like the other searches, this search is subject to the
+      /// approximation factor.
+      virtual NodeVector_t withinBall (const Configuration_t& configuration,
+                                       const ConnectedComponentPtr_t& cc,
+                                       value_type maxDistance,
+                                       size_type maxNodes);
+
       // merge two connected components in the whole tree
-      void merge(ConnectedComponentPtr_t cc1, ConnectedComponentPtr_t cc2);
+      virtual void merge (ConnectedComponentPtr_t cc1,
+                          ConnectedComponentPtr_t cc2);
+
       // Get distance function
       virtual DistancePtr_t distance () const
       {
 	return distance_;
       }
+
+      /// \copydoc NearestNeighbor::approximationFactor(value_type)
+      virtual void approximationFactor (value_type factor);
+
+      virtual value_type approximationFactor () const
+      {
+        return approximationFactor_;
+      }
+
+      /// Number of points stored in the tree
+      size_type size () const
+      {
+        return (size_type) nodes_.size () - removedPoints_;
+      }
+
+      /// Maximal depth of the leaves of the tree
+      virtual size_type depth () const;
+
+      /// Average depth of the points of the tree
+      virtual value_type averageDepth () const;
+
+      /// Memory allocated by the cells, the buckets, the configurations and
+      /// the labels of the tree
+      virtual std::size_t memory () const;
+
     private:
-      DevicePtr_t robot_;
-      std::size_t dim_;
+      /// Cell of the tree.
+      /// Internal cells have two children. Leaves own the span
+      /// [begin, begin+size) of the bucket array.
+      struct Cell
+      {
+        /// Index of child containing q[splitDim] <= splitValue,
+        /// -1 for a leaf.
+        size_type inf;
+        /// Index of child containing q[splitDim] > splitValue.
+        size_type sup;
+        size_type splitDim;
+        value_type splitValue;
+        size_type begin, size, capacity;
+        /// Size above which splitting the leaf is attempted.
+        size_type splitSize;
+        /// Number of points in the subtree.
+        size_type count;
+
+        Cell () : inf (-1), sup (-1), splitDim (-1), splitValue (0),
+        begin (0), size (0), capacity (0), splitSize (0), count (0)
+        {}
+        bool isLeaf () const { return inf < 0; }
+      };
+      typedef std::vector <Cell> Cells_t;
+      typedef std::vector <size_type> Indices_t;
+      typedef std::map <const ConnectedComponent*, size_type> Labels_t;
+      /// Query of a batch search: column index and squared lower bound of
+      /// the distance to the current cell.
+      typedef std::pair <size_type, value_type> Query_t;
+      typedef std::vector <Query_t> Queries_t;
+      /// Bucket entry: point index and label.
+      typedef std::pair <size_type, size_type> Entry_t;
+      typedef std::vector <Entry_t> Entries_t;
+      /// Sorted pairs (root label, rank of connected component)
+      typedef std::vector <std::pair <size_type, size_type> > LabelRanks_t;
+      /// Best node of several connected components
+      struct BestInConnectedComponents
+      {
+        LabelRanks_t labelRanks;
+        NodeVector_t nodes;
+        vector_t distances;
+        /// Largest distance in \c distances
+        value_type worst;
+      };
 
-      WeighedDistancePtr_t distance_;
-      vector_t weights_;
-      typedef std::map <ConnectedComponentPtr_t, Nodes_t> NodesMap_t;
-      NodesMap_t nodesMap_;
-      std::size_t bucketSize_;
-      std::size_t bucket_;
+      /// Best candidates found during a search
+      struct Candidates;
 
-      // number of the splited dimention
-      std::size_t splitDim_;
-      vector_t upperBounds_;
-      vector_t lowerBounds_;
+      /// Compute the weight of each configuration coordinate in the lower
+      /// bound of the distance.
+      void computeBoundWeights (const DevicePtr_t& robot);
 
-      // type of each dimention
-      //	0 => bounded dimention
-      //	1 => looped dimention
-      //	2 => quaternion
-      vector_t typeDims_;
+      /// Label of a connected component, -1 if not in the tree.
+      size_type label (const ConnectedComponent* cc) const;
+      /// Label of a connected component, created if not in the tree.
+      size_type insertLabel (const ConnectedComponent* cc);
+      /// Representative of a label after merges.
+      size_type findLabel (size_type l) const;
 
-      KDTreePtr_t supChild_;
-      KDTreePtr_t infChild_;
+      /// Allocate storage for a leaf of given capacity
+      void allocateBucket (Cell& cell, size_type capacity);
+      /// Insert point in leaf, growing the leaf storage if needed.
+      void insertInLeaf (size_type cell, size_type point, size_type label);
+      /// Get an unused cell.
+      size_type newCell ();
+      /// Gather the bucket entries of a subtree and free its cells.
+      void collect (size_type cell, Entries_t& entries);
+      /// Store entries [begin, end) in a leaf.
+      void makeLeaf (size_type cell, const Entries_t& entries,
+                     size_type begin, size_type end);
+      /// Build a subtree from entries [begin, end) with median splits on
+      /// the widest weighted dimension.
+      void build (size_type cell, Entries_t& entries,
+                  size_type begin, size_type end);
+      /// Rebuild the subtree of a cell.
+      void rebuild (size_type cell);
+      /// Remove the unused entries of the bucket arrays.
+      void compactBuckets ();
+      /// Renumber the points to remove the removed ones and rebuild the
+      /// tree.
+      void compactPoints ();
 
-      // Split the node into two subnodes
-      void split();
+      value_type computeDistance (ConfigurationIn_t q, size_type point,
+                                  bool reverse) const;
+      /// Distance::lowerBound of the distance to a point.
+      value_type computeLowerBound (ConfigurationIn_t q, size_type point,
+                                    bool reverse) const;
 
-      // find the leaf of the KDtree for the configuration/node.
-      // starts the research at KDTree then go down the tree.
-      // also add connectedComopnent of node along the path from tree
-      // root to tree leaf
-      KDTreePtr_t findLeaf(const NodePtr_t& node);
+      /// Recursive search
+      /// \param cell index of the cell to explore,
+      /// \param q the query configuration,
+      /// \param ccLabel label of the searched connected component, -1 to
+      ///        accept all the points,
+      /// \param boxDistance squared lower bound of the distance to the cell,
+      /// \param offsets per-dimension offsets of q to the cell box,
+      /// \param candidates best points found so far.
+      void search (size_type cell, const Configuration_t& q,
+                   size_type ccLabel, value_type boxDistance,
+                   vector_t& offsets, Candidates& candidates,
+                   bool reverse) const;
 
-      // find bounds on each dimention
-      void findDeviceBounds();
+      /// Recursive search of a batch of queries
+      /// \param cell index of the cell to explore,
+      /// \param queries the query configurations stored column-wise,
+      /// \param active queries that may have candidates in the cell,
+      /// \param offsets per-dimension offsets of each query to the cell box,
+      /// \param candidates best points found so far for each query.
+      void search (size_type cell, const matrix_t& queries,
+                   const Queries_t& active, matrix_t& offsets,
+                   std::vector <Candidates>& candidates) const;
 
-      // distance to the nearest bound on the splited dimention
-      value_type distanceToBox(const Configuration_t& configuration);
+      /// Recursive search of the nearest point of several connected
+      /// components
+      void search (size_type cell, const Configuration_t& q,
+                   value_type boxDistance, vector_t& offsets,
+                   BestInConnectedComponents& best, bool reverse) const;
 
-      // search nearest node
-      void search(value_type boxDistance, value_type& minDistance,
-      const Configuration_t& configuration,
-      const ConnectedComponentPtr_t& connectedComponent,
-      NodePtr_t& nearest, bool reverse = false);
+      /// Recursive radius search
+      /// \param boxDistance squared lower bound of the distance to the cell,
+      /// \param nodes nodes of label ccLabel closer than maxDistance.
+      void withinBall (size_type cell, const Configuration_t& q,
+                       size_type ccLabel, value_type maxDistance,
+                       value_type boxDistance, vector_t& offsets,
+                       NodeVector_t& nodes) const;
 
-    private:
-      KDTree();
+      Nodes_t knearest (const Configuration_t& q, size_type ccLabel,
+                        std::size_t K, value_type& distance) const;
+
+      DistancePtr_t distance_;
+      size_type dim_;
+      size_type bucketSize_;
+      /// Weights of the coordinates in the distance lower bound.
+      vector_t boundWeights_;
+      /// A cell is explored only if approximationFactor_ times the lower
+      /// bound of its distance is less than the current best distance.
+      value_type approximationFactor_, squaredFactor_;
+
+      /// Tree cells. The root is cells_[0].
+      Cells_t cells_;
+      /// Configurations of the points stored column-wise.
+      matrix_t configurations_;
+      /// Roadmap node of each point, NULL for removed points.
+      NodeVector_t nodes_;
+      /// Number of removed points in nodes_.
+      size_type removedPoints_;
+      /// Point index of each bucket entry.
+      Indices_t bucketPoints_;
+      /// Connected component label of each bucket entry.
+      Indices_t bucketLabels_;
+      /// Number of bucket entries not owned by any leaf.
+      size_type unusedBucketEntries_;
+      /// Cells freed by rebuilds.
+      Indices_t freeCells_;
+
+      Labels_t labels_;
+      /// Union-find parents of labels.
+      Indices_t labelParents_;
+      /// Number of labels in the set of each root label.
+      Indices_t labelSizes_;
+      /// Last inserted point of each root label, -1 if removed.
+      Indices_t labelSeeds_;
+
+      KDTree () : approximationFactor_ (1), squaredFactor_ (1),
+      removedPoints_ (0) {}
       HPP_SERIALIZABLE();
     }; // class KDTree
     } // namespace nearestNeighbor
@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include "../src/nearest-neighbor/reduced-chart.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <queue>
+#include <stdexcept>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/liegroup.hh>
+#include <hpp/core/config-projector.hh>
+#include <hpp/core/connected-component.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/weighed-distance.hh>
+
+namespace hpp {
+  namespace core {
+    namespace nearestNeighbor {
+      namespace {
+        typedef std::pair <value_type, NodePtr_t> DistAndNode_t;
+        struct DistAndNodeComp_t {
+          bool operator () (const DistAndNode_t& r,
+              const DistAndNode_t& l) {
+            return r.first < l.first;
+          }
+        };
+        typedef std::priority_queue <DistAndNode_t, std::vector <DistAndNode_t>,
+                DistAndNodeComp_t > Queue_t;
+      }
+
+      ReducedChart::ReducedChart (const DevicePtr_t& robot,
+                                  const DistancePtr_t& distance,
+                                  const ConfigProjectorPtr_t& projector) :
+        robot_ (robot), distance_ (distance), projector_ (projector),
+        reference_ (robot->neutralConfiguration ()),
+        weights_ (vector_t::Ones (robot->numberDof ())),
+        dim_ (projector ? projector->numberFreeVariables () : 0),
+        coordinates_ (dim_, 0), nodes_ (), components_ ()
+      {
+        if (!projector_)
+          throw std::invalid_argument ("ReducedChart: the configuration "
+                                       "projector should not be null.");
+        WeighedDistancePtr_t wd (HPP_DYNAMIC_PTR_CAST (WeighedDistance,
+                                                       distance_));
+        if (wd && wd->size () >= robot->nbJoints ()) {
+          for (size_type i = 0; i < robot->nbJoints (); ++i) {
+            JointPtr_t joint (robot->jointAt (i));
+            weights_.segment (joint->rankInVelocity (), joint->numberDof ())
+              .setConstant (wd->getWeight (i));
+          }
+        }
+      }
+
+      void ReducedChart::chart (ConfigurationIn_t configuration,
+                                vectorOut_t result) const
+      {
+        if (projector_->numberFreeVariables () != dim_)
+          throw std::logic_error ("ReducedChart: the number of free "
+                                  "variables of the projector changed.");
+        vector_t v (robot_->numberDof ());
+        pinocchio::difference <pinocchio::RnxSOnLieGroupMap>
+          (robot_, configuration, reference_, v);
+        v.array () *= weights_.array ();
+        projector_->compressVector (v, result);
+      }
+
+      void ReducedChart::squaredDistances (ConfigurationIn_t configuration,
+                                           vector_t& result) const
+      {
+        vector_t c (dim_);
+        chart (configuration, c);
+        const size_type n ((size_type) nodes_.size ());
+        result = (coordinates_.leftCols (n).colwise () - c).colwise ()
+          .squaredNorm ().transpose ();
+      }
+
+      Nodes_t ReducedChart::nearest (const vector_t& squaredDistances,
+                                     const ConnectedComponent* cc,
+                                     std::size_t K,
+                                     value_type& distance) const
+      {
+        Queue_t ns;
+        distance = std::numeric_limits <value_type>::infinity ();
+        for (std::size_t i = 0; i < nodes_.size (); ++i) {
+          if (cc && components_ [i] != cc) continue;
+          const value_type d (squaredDistances [i]);
+          if (ns.size () < K)
+            ns.push (DistAndNode_t (d, nodes_ [i]));
+          else if (ns.top ().first > d) {
+            ns.pop ();
+            ns.push (DistAndNode_t (d, nodes_ [i]));
+          }
+        }
+        Nodes_t nodes;
+        if (ns.size () > 0) distance = std::sqrt (ns.top ().first);
+        while (ns.size () > 0) {
+          nodes.push_front (ns.top ().second); ns.pop ();
+        }
+        return nodes;
+      }
+
+      void ReducedChart::clear ()
+      {
+        coordinates_.resize (dim_, 0);
+        nodes_.clear ();
+        components_.clear ();
+      }
+
+      void ReducedChart::addNode (const NodePtr_t& node)
+      {
+        const size_type point ((size_type) nodes_.size ());
+        if (coordinates_.cols () <= point) {
+          coordinates_.conservativeResize
+            (dim_, std::max <size_type> (16, 2 * coordinates_.cols ()));
+        }
+        chart (*node->configuration (), coordinates_.col (point));
+        nodes_.push_back (node);
+        components_.push_back (node->connectedComponent ().get ());
+      }
+
+      void ReducedChart::removeNode (const NodePtr_t& node)
+      {
+        NodeVector_t::iterator it (std::find (nodes_.begin (), nodes_.end (),
+                                              node));
+        if (it == nodes_.end ()) return;
+        const std::size_t i (it - nodes_.begin ()), last (nodes_.size () - 1);
+        nodes_ [i] = nodes_ [last];
+        components_ [i] = components_ [last];
+        coordinates_.col (i) = coordinates_.col (last);
+        nodes_.pop_back ();
+        components_.pop_back ();
+      }
+
+      NodePtr_t ReducedChart::search (const Configuration_t& configuration,
+                                      const ConnectedComponentPtr_t&
+                                      connectedComponent,
+                                      value_type& distance, bool)
+      {
+        vector_t d;
+        squaredDistances (configuration, d);
+        Nodes_t nodes (nearest (d, connectedComponent.get (), 1, distance));
+        assert (!nodes.empty ());
+        return nodes.empty () ? NULL : nodes.front ();
+      }
+
+      NodePtr_t ReducedChart::search (const NodePtr_t& node,
+                                      const ConnectedComponentPtr_t&
+                                      connectedComponent,
+                                      value_type& distance)
+      {
+        return search (*node->configuration (), connectedComponent,
+                       distance);
+      }
+
+      NodeVector_t ReducedChart::searchInConnectedComponents
+      (const Configuration_t& configuration,
+       const ConnectedComponents_t& connectedComponents,
+       vector_t& distances, bool)
+      {
+        vector_t d;
+        squaredDistances (configuration, d);
+        std::map <const ConnectedComponent*, std::size_t> ranks;
+        std::size_t rank (0);
+        for (ConnectedComponents_t::const_iterator itcc
+               (connectedComponents.begin ());
+             itcc != connectedComponents.end (); ++itcc, ++rank)
+          ranks [itcc->get ()] = rank;
+        NodeVector_t result (connectedComponents.size (), NodePtr_t ());
+        distances = vector_t::Constant
+          (connectedComponents.size (),
+           std::numeric_limits <value_type>::infinity ());
+        for (std::size_t i = 0; i < nodes_.size (); ++i) {
+          std::map <const ConnectedComponent*, std::size_t>::const_iterator
+            it (ranks.find (components_ [i]));
+          if (it == ranks.end () || d [i] >= distances [it->second])
+            continue;
+          distances [it->second] = d [i];
+          result [it->second] = nodes_ [i];
+        }
+        distances = distances.cwiseSqrt ();
+        return result;
+      }
+
+      Nodes_t ReducedChart::KnearestSearch (const Configuration_t&
+                                            configuration,
+                                            const ConnectedComponentPtr_t&
+                                            connectedComponent,
+                                            const std::size_t K,
+                                            value_type& distance)
+      {
+        vector_t d;
+        squaredDistances (configuration, d);
+        return nearest (d, connectedComponent.get (), K, distance);
+      }
+
+      Nodes_t ReducedChart::KnearestSearch (const NodePtr_t& node,
+                                            const ConnectedComponentPtr_t&
+                                            connectedComponent,
+                                            const std::size_t K,
+                                            value_type& distance)
+      {
+        return KnearestSearch (*node->configuration (), connectedComponent,
+                               K, distance);
+      }
+
+      Nodes_t ReducedChart::KnearestSearch (const Configuration_t&
+                                            configuration,
+                                            const RoadmapPtr_t&,
+                                            const std::size_t K,
+                                            value_type& distance)
+      {
+        vector_t d;
+        squaredDistances (configuration, d);
+        return nearest (d, NULL, K, distance);
+      }
+
+      NodeVector_t ReducedChart::withinBall (const Configuration_t&
+                                             configuration,
+                                             const ConnectedComponentPtr_t& cc,
+                                             value_type maxDistance)
+      {
+        vector_t d;
+        squaredDistances (configuration, d);
+        const value_type squaredRadius (maxDistance * maxDistance);
+        NodeVector_t nodes;
+        for (std::size_t i = 0; i < nodes_.size (); ++i) {
+          if (components_ [i] == cc.get () && d [i] < squaredRadius)
+            nodes.push_back (nodes_ [i]);
+        }
+        return nodes;
+      }
+
+      void ReducedChart::merge (ConnectedComponentPtr_t cc1,
+                                ConnectedComponentPtr_t cc2)
+      {
+        std::replace (components_.begin (), components_.end (),
+                      (const ConnectedComponent*) cc2.get (),
+                      (const ConnectedComponent*) cc1.get ());
+      }
+
+      std::size_t ReducedChart::memory () const
+      {
+        return sizeof (ReducedChart) +
+          (std::size_t) (coordinates_.size () + weights_.size () +
+                         reference_.size ()) * sizeof (value_type) +
+          nodes_.capacity () * sizeof (NodePtr_t) +
+          components_.capacity () * sizeof (const ConnectedComponent*);
+      }
+
+      NearestNeighborPtr_t createReducedChart
+      (const DevicePtr_t& robot, const DistancePtr_t& distance,
+       const ConfigProjectorPtr_t& projector)
+      {
+        return new ReducedChart (robot, distance, projector);
+      }
+    } // namespace nearestNeighbor
+  } // namespace core
+} // namespace hpp
@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_NEAREST_NEIGHBOR_REDUCED_CHART_HH
+# define HPP_CORE_NEAREST_NEIGHBOR_REDUCED_CHART_HH
+
+# include <vector>
+
+# include <hpp/core/fwd.hh>
+# include <hpp/core/nearest-neighbor.hh>
+
+namespace hpp {
+  namespace core {
+    namespace nearestNeighbor {
+    /// Nearest neighbor search in the free variables of a configuration
+    /// projector
+    ///
+    /// Each node is mapped to the chart coordinates of its configuration:
+    /// the free variables, see ConfigProjector::numberFreeVariables, of
+    /// the difference with the neutral configuration, scaled by the
+    /// weights of the joints if the distance is a WeighedDistance. Nodes
+    /// are compared by the Euclidean distance between their chart
+    /// coordinates, which ignores the directions the projector moves
+    /// along. The distances returned and the radius of the balls are
+    /// measured in the chart.
+    ///
+    /// The chart coordinates of the nodes are packed as columns of one
+    /// matrix, along with the connected component of each node, so that
+    /// searches scan small contiguous vectors and do not read the
+    /// connected components of the roadmap.
+    class ReducedChart : public NearestNeighbor
+    {
+    public:
+      /// Constructor
+      /// \param robot the robot the configurations of which are stored,
+      /// \param distance distance of the roadmap, the weights of which
+      ///        scale the coordinates if it is a WeighedDistance,
+      /// \param projector the free variables of which are the coordinates.
+      ReducedChart (const DevicePtr_t& robot, const DistancePtr_t& distance,
+                    const ConfigProjectorPtr_t& projector);
+
+      virtual ~ReducedChart ()
+      {
+      }
+
+      virtual void clear ();
+
+      virtual void addNode (const NodePtr_t& node);
+
+      virtual void removeNode (const NodePtr_t& node);
+
+      virtual NodePtr_t search (const Configuration_t& configuration,
+                                const ConnectedComponentPtr_t&
+                                connectedComponent,
+                                value_type& distance, bool reverse = false);
+
+      virtual NodePtr_t search (const NodePtr_t& node,
+                                const ConnectedComponentPtr_t&
+                                connectedComponent,
+                                value_type& distance);
+
+      /// Return the nearest node of each connected component
+      ///
+      /// The nodes are scanned once for all the connected components.
+      virtual NodeVector_t searchInConnectedComponents
+      (const Configuration_t& configuration,
+       const ConnectedComponents_t& connectedComponents,
+       vector_t& distances, bool reverse = false);
+
+      virtual Nodes_t KnearestSearch (const Configuration_t& configuration,
+                                      const ConnectedComponentPtr_t&
+                                      connectedComponent,
+                                      const std::size_t K,
+                                      value_type& distance);
+
+      virtual Nodes_t KnearestSearch (const NodePtr_t& node,
+                                      const ConnectedComponentPtr_t&
+                                      connectedComponent,
+                                      const std::size_t K,
+                                      value_type& distance);
+
+      virtual Nodes_t KnearestSearch (const Configuration_t& configuration,
+                                      const RoadmapPtr_t& roadmap,
+                                      const std::size_t K,
+                                      value_type& distance);
+
+      using NearestNeighbor::KnearestSearch;
+      using NearestNeighbor::withinBall;
+
+      virtual NodeVector_t withinBall (const Configuration_t& configuration,
+                                       const ConnectedComponentPtr_t& cc,
+                                       value_type maxDistance);
+
+      virtual void merge (ConnectedComponentPtr_t cc1,
+                          ConnectedComponentPtr_t cc2);
+
+      virtual DistancePtr_t distance () const
+      {
+        return distance_;
+      }
+
+      virtual std::size_t memory () const;
+
+      /// Number of chart coordinates
+      size_type dimension () const
+      {
+        return dim_;
+      }
+
+      /// Compute the chart coordinates of a configuration
+      void chart (ConfigurationIn_t configuration, vectorOut_t result) const;
+
+    private:
+      /// Squared chart distance of the nodes to the chart coordinates of
+      /// a configuration
+      void squaredDistances (ConfigurationIn_t configuration,
+                             vector_t& result) const;
+      /// K nodes of smallest squared distances among those of a connected
+      /// component, or all of them if cc is NULL, sorted by increasing
+      /// distance.
+      Nodes_t nearest (const vector_t& squaredDistances,
+                       const ConnectedComponent* cc, std::size_t K,
+                       value_type& distance) const;
+
+      DevicePtr_t robot_;
+      DistancePtr_t distance_;
+      ConfigProjectorPtr_t projector_;
+      /// Configuration the differences of which are projected.
+      Configuration_t reference_;
+      /// Weight of each degree of freedom.
+      vector_t weights_;
+      /// Number of free variables of the projector at construction.
+      size_type dim_;
+      /// Chart coordinates of the nodes stored column-wise.
+      matrix_t coordinates_;
+      NodeVector_t nodes_;
+      /// Connected component of each node.
+      std::vector <const ConnectedComponent*> components_;
+
+      ReducedChart () : dim_ (0) {}
+      HPP_SERIALIZABLE();
+    }; // class ReducedChart
+    } // namespace nearestNeighbor
+  } // namespace core
+} // namespace hpp
+#endif // HPP_CORE_NEAREST_NEIGHBOR_REDUCED_CHART_HH
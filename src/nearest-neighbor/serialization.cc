@@ -1,12 +1,18 @@
 #include "basic.hh"
-//#include "k-d-tree.hh"
+#include "k-d-tree.hh"
+#include "concurrent.hh"
+#include "reduced-chart.hh"
+
+#include <pinocchio/serialization/eigen.hpp>
 
 #include <hpp/util/serialization.hh>
 
 #include <hpp/core/distance.hh>
 
 BOOST_CLASS_EXPORT(hpp::core::nearestNeighbor::Basic)
-//BOOST_CLASS_EXPORT(hpp::core::nearestNeighbor::KDTree)
+BOOST_CLASS_EXPORT(hpp::core::nearestNeighbor::KDTree)
+BOOST_CLASS_EXPORT(hpp::core::nearestNeighbor::Concurrent)
+BOOST_CLASS_EXPORT(hpp::core::nearestNeighbor::ReducedChart)
 
 namespace hpp {
 namespace core {
@@ -32,18 +38,49 @@ inline void Basic::serialize(Archive& ar, const unsigned int version)
 
 HPP_SERIALIZATION_IMPLEMENT(Basic);
 
-/*
 template <typename Archive>
 inline void KDTree::serialize(Archive& ar, const unsigned int version)
 {
-  throw std::logic_error("nearestNeighbor::KDTree not serializable.");
   (void) version;
   ar & boost::serialization::make_nvp("base", boost::serialization::base_object<NearestNeighbor>(*this));
   ar & BOOST_SERIALIZATION_NVP(distance_);
+  ar & BOOST_SERIALIZATION_NVP(dim_);
+  ar & BOOST_SERIALIZATION_NVP(bucketSize_);
+  ar & BOOST_SERIALIZATION_NVP(boundWeights_);
+  // Points are inserted again by the roadmap when loading.
+  if (Archive::is_loading::value)
+    configurations_.resize (dim_, 0);
 }
 
 HPP_SERIALIZATION_IMPLEMENT(KDTree);
-*/
+
+template <typename Archive>
+inline void Concurrent::serialize(Archive& ar, const unsigned int version)
+{
+  (void) version;
+  ar & boost::serialization::make_nvp("base", boost::serialization::base_object<NearestNeighbor>(*this));
+  ar & BOOST_SERIALIZATION_NVP(nearestNeighbor_);
+}
+
+HPP_SERIALIZATION_IMPLEMENT(Concurrent);
+
+template <typename Archive>
+inline void ReducedChart::serialize(Archive& ar, const unsigned int version)
+{
+  (void) version;
+  ar & boost::serialization::make_nvp("base", boost::serialization::base_object<NearestNeighbor>(*this));
+  ar & BOOST_SERIALIZATION_NVP(robot_);
+  ar & BOOST_SERIALIZATION_NVP(distance_);
+  ar & BOOST_SERIALIZATION_NVP(projector_);
+  ar & BOOST_SERIALIZATION_NVP(reference_);
+  ar & BOOST_SERIALIZATION_NVP(weights_);
+  ar & BOOST_SERIALIZATION_NVP(dim_);
+  // Points are inserted again by the roadmap when loading.
+  if (Archive::is_loading::value)
+    coordinates_.resize (dim_, 0);
+}
+
+HPP_SERIALIZATION_IMPLEMENT(ReducedChart);
 
 } // namespace nearestNeighbor
 } // namespace core
@@ -84,6 +84,16 @@ namespace hpp {
       inEdges_.push_back (edge);
     }
 
+    void Node::removeOutEdge (EdgePtr_t edge)
+    {
+      outEdges_.remove (edge);
+    }
+
+    void Node::removeInEdge (EdgePtr_t edge)
+    {
+      inEdges_.remove (edge);
+    }
+
     void Node::connectedComponent (const ConnectedComponentPtr_t& cc)
     {
       connectedComponent_ = cc;
@@ -91,6 +101,9 @@ namespace hpp {
 
     ConnectedComponentPtr_t Node::connectedComponent () const
     {
+      // Connected components merged into another one are resolved lazily.
+      if (connectedComponent_ && connectedComponent_->mergedInto_)
+	connectedComponent_ = ConnectedComponent::root (connectedComponent_);
       return connectedComponent_;
     }
 
@@ -34,9 +34,12 @@ namespace hpp {
         CollisionRequests_t& reqs,
         fcl::CollisionResult& res,
         std::size_t& i,
-        pinocchio::DeviceData& data)
+        pinocchio::DeviceData& data,
+        bool useBoundingSpheres)
     {
       for (i = 0; i < pairs.size(); ++i) {
+        if (useBoundingSpheres && farApart (pairs[i], reqs[i], data))
+          continue;
         res.clear();
         const CollisionObjectConstPtr_t& a (pairs[i].first );
         const CollisionObjectConstPtr_t& b (pairs[i].second);
@@ -52,6 +55,24 @@ namespace hpp {
       return false;
     }
 
+    bool ObstacleUser::farApart (const CollisionPair_t& pair,
+        const fcl::CollisionRequest& request,
+        const pinocchio::DeviceData& data)
+    {
+      const fcl::CollisionGeometry& ga (*pair.first ->geometry ());
+      const fcl::CollisionGeometry& gb (*pair.second->geometry ());
+      // Compare squared distances to avoid a square root per pair.
+      const value_type r (ga.aabb_radius + gb.aabb_radius +
+                          request.security_margin);
+      if (r < 0) return true;
+      const fcl::Vec3f d
+        (toFclTransform3f (pair.first ->getTransform (data)).transform
+         (ga.aabb_center) -
+         toFclTransform3f (pair.second->getTransform (data)).transform
+         (gb.aabb_center));
+      return d.squaredNorm () > r * r;
+    }
+
     void ObstacleUser::addObstacle (const CollisionObjectConstPtr_t& object)
     {
       for (size_type j = 0; j < robot_->nbJoints(); ++j) {
@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/occupancy-cache.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <pinocchio/multibody/model.hpp>
+
+#include <hpp/util/exception-factory.hh>
+
+#include <hpp/pinocchio/body.hh>
+#include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/liegroup.hh>
+
+namespace hpp {
+  namespace core {
+    namespace {
+      const char magic [8] = { 'H', 'P', 'P', 'O', 'C', 'C', 'U', '1' };
+
+      /// Beginning of the files, followed by the keys of the cells
+      struct Header
+      {
+        char magic [8];
+        boost::int64_t numberDof;
+        double resolution;
+        boost::int64_t numberLevels;
+        boost::uint64_t scene;
+        boost::int64_t numberCells;
+      }; // struct Header
+    } // namespace
+
+    /// Keys of the cells, the level followed by the indices in the grid
+    struct OccupancyCache::Cells
+    {
+      typedef std::vector <boost::int64_t> Key_t;
+      typedef boost::unordered_set <Key_t, boost::hash <Key_t> > Set_t;
+
+      static void key (const vector_t& v, value_type resolution,
+                       size_type level, Key_t& result)
+      {
+        const value_type width (std::ldexp (resolution, (int) level));
+        result.resize (v.size () + 1);
+        result [0] = level;
+        for (size_type i = 0; i < v.size (); ++i)
+          result [i + 1] = (boost::int64_t) std::floor (v [i] / width);
+      }
+
+      Cells () : scene (0), hits (0), misses (0)
+      {
+      }
+
+      Set_t set;
+      std::size_t scene;
+      size_type hits;
+      size_type misses;
+      boost::mutex mutex;
+    }; // struct Cells
+
+    OccupancyCachePtr_t OccupancyCache::create (const DevicePtr_t& robot,
+                                                value_type resolution,
+                                                size_type numberLevels)
+    {
+      if (!(resolution > 0) || numberLevels < 1)
+        throw std::invalid_argument ("The resolution and the number of "
+                                     "levels of an occupancy cache should be "
+                                     "positive.");
+      return OccupancyCachePtr_t (new OccupancyCache (robot, resolution,
+                                                      numberLevels));
+    }
+
+    OccupancyCachePtr_t OccupancyCache::load (const DevicePtr_t& robot,
+                                              const std::string& filename)
+    {
+      std::ifstream file (filename.c_str (), std::ios::binary);
+      if (!file)
+        HPP_THROW (std::runtime_error, "Cannot open the occupancy cache "
+                   << filename);
+      Header header;
+      file.read (reinterpret_cast <char*> (&header), sizeof (Header));
+      if (!file || std::memcmp (header.magic, magic, sizeof (magic)) != 0 ||
+          !(header.resolution > 0) || header.numberLevels < 1 ||
+          header.numberCells < 0)
+        HPP_THROW (std::runtime_error, filename << " is not an occupancy "
+                   "cache.");
+      if (header.numberDof != robot->numberDof ())
+        HPP_THROW (std::runtime_error, "The occupancy cache " << filename
+                   << " has " << header.numberDof << " degrees of freedom "
+                   "instead of " << robot->numberDof () << ".");
+      OccupancyCachePtr_t cache (create (robot, header.resolution,
+                                         header.numberLevels));
+      cache->cells_->scene = (std::size_t) header.scene;
+      Cells::Key_t key ((std::size_t) header.numberDof + 1);
+      for (boost::int64_t i = 0; i < header.numberCells; ++i) {
+        file.read (reinterpret_cast <char*> (&key [0]),
+                   (std::streamsize) (key.size () * sizeof (key [0])));
+        if (!file)
+          HPP_THROW (std::runtime_error, "The occupancy cache " << filename
+                     << " is truncated.");
+        cache->cells_->set.insert (key);
+      }
+      return cache;
+    }
+
+    void OccupancyCache::save (const std::string& filename) const
+    {
+      const std::string tmp (filename + ".tmp");
+      {
+        std::ofstream file (tmp.c_str (), std::ios::binary);
+        boost::mutex::scoped_lock lock (cells_->mutex);
+        Header header;
+        std::memcpy (header.magic, magic, sizeof (magic));
+        header.numberDof = robot_->numberDof ();
+        header.resolution = resolution_;
+        header.numberLevels = numberLevels_;
+        header.scene = cells_->scene;
+        header.numberCells = (boost::int64_t) cells_->set.size ();
+        file.write (reinterpret_cast <const char*> (&header), sizeof (Header));
+        for (Cells::Set_t::const_iterator it = cells_->set.begin ();
+             it != cells_->set.end (); ++it)
+          file.write (reinterpret_cast <const char*> (&(*it) [0]),
+                      (std::streamsize) (it->size () * sizeof ((*it) [0])));
+        if (!file)
+          HPP_THROW (std::runtime_error, "Cannot write the occupancy cache "
+                     << tmp);
+      }
+      if (std::rename (tmp.c_str (), filename.c_str ()) != 0)
+        HPP_THROW (std::runtime_error, "Cannot rename " << tmp << " into "
+                   << filename);
+    }
+
+    bool OccupancyCache::isFree (ConfigurationIn_t config,
+                                 std::size_t scene) const
+    {
+      vector_t v;
+      coordinates (config, v);
+      std::vector <Cells::Key_t> keys ((std::size_t) numberLevels_);
+      for (size_type l = 0; l < numberLevels_; ++l)
+        Cells::key (v, resolution_, l, keys [l]);
+      boost::mutex::scoped_lock lock (cells_->mutex);
+      if (scene == cells_->scene) {
+        for (std::size_t l = keys.size (); l-- > 0;) {
+          if (cells_->set.count (keys [l])) {
+            ++cells_->hits;
+            return true;
+          }
+        }
+      }
+      ++cells_->misses;
+      return false;
+    }
+
+    bool OccupancyCache::insert (ConfigurationIn_t config,
+                                 value_type clearance, std::size_t scene)
+    {
+      if (!(clearance > 0)) return false;
+      vector_t v;
+      coordinates (config, v);
+      // Coarsest cell over which the points move by less than half the
+      // clearance, the objects of a pair possibly moving both.
+      size_type level (-1);
+      for (size_type l = 0; l < numberLevels_; ++l) {
+        const value_type width (std::ldexp (resolution_, (int) l));
+        value_type displacement (0);
+        for (size_type i = 0; i < v.size (); ++i) {
+          const value_type lower (std::floor (v [i] / width) * width);
+          displacement += coefficients_ [i] *
+            std::max (v [i] - lower, lower + width - v [i]);
+        }
+        if (2 * displacement >= clearance) break;
+        level = l;
+      }
+      if (level < 0) return false;
+      Cells::Key_t key;
+      Cells::key (v, resolution_, level, key);
+      boost::mutex::scoped_lock lock (cells_->mutex);
+      if (scene != cells_->scene) {
+        cells_->set.clear ();
+        cells_->scene = scene;
+      }
+      cells_->set.insert (key);
+      return true;
+    }
+
+    void OccupancyCache::clear ()
+    {
+      boost::mutex::scoped_lock lock (cells_->mutex);
+      cells_->set.clear ();
+    }
+
+    size_type OccupancyCache::numberCells () const
+    {
+      boost::mutex::scoped_lock lock (cells_->mutex);
+      return (size_type) cells_->set.size ();
+    }
+
+    size_type OccupancyCache::hits () const
+    {
+      boost::mutex::scoped_lock lock (cells_->mutex);
+      return cells_->hits;
+    }
+
+    size_type OccupancyCache::misses () const
+    {
+      boost::mutex::scoped_lock lock (cells_->mutex);
+      return cells_->misses;
+    }
+
+    std::size_t OccupancyCache::scene () const
+    {
+      boost::mutex::scoped_lock lock (cells_->mutex);
+      return cells_->scene;
+    }
+
+    void OccupancyCache::coordinates (ConfigurationIn_t config,
+                                      vector_t& v) const
+    {
+      v.resize (robot_->numberDof ());
+      pinocchio::difference <pinocchio::RnxSOnLieGroupMap>
+        (robot_, config, robot_->neutralConfiguration (), v);
+    }
+
+    OccupancyCache::OccupancyCache (const DevicePtr_t& robot,
+                                    value_type resolution,
+                                    size_type numberLevels) :
+      robot_ (robot), resolution_ (resolution), numberLevels_ (numberLevels),
+      coefficients_ (vector_t::Zero (robot->numberDof ())),
+      cells_ (new Cells)
+    {
+      // Largest distance between each joint and the points of its subtree,
+      // children coming after their parent.
+      const pinocchio::Model& model (robot->model ());
+      std::vector <value_type> radius (model.njoints, 0);
+      for (size_type i = robot->nbJoints () - 1; i >= 0; --i) {
+        JointPtr_t joint (robot->jointAt (i));
+        const std::size_t index (joint->index ());
+        if (joint->linkedBody ())
+          radius [index] = std::max (radius [index],
+                                     joint->linkedBody ()->radius ());
+        const std::size_t parent (model.parents [index]);
+        radius [parent] = std::max (radius [parent], radius [index] +
+                                    joint->maximalDistanceToParent ());
+      }
+      for (size_type i = 0; i < robot->nbJoints (); ++i) {
+        JointPtr_t joint (robot->jointAt (i));
+        coefficients_.segment (joint->rankInVelocity (),
+                               joint->numberDof ()).setConstant
+          (joint->upperBoundLinearVelocity () +
+           radius [joint->index ()] * joint->upperBoundAngularVelocity ());
+      }
+    }
+  } // namespace core
+} // namespace hpp
@@ -26,6 +26,7 @@
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 
+#include <hpp/core/distance.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/steering-method.hh>
 #include <hpp/core/roadmap.hh>
@@ -122,6 +123,8 @@ namespace hpp {
         /// Get all the edges and build a path
         ObjectFactory::ObjectFactoryList pathList = getChildrenOfType ("path");
         SteeringMethodPtr_t sm = problem_->steeringMethod ();
+        const bool deferred (problem_->getParameter
+            ("RoadmapFactory/deferredEdgePaths").boolValue ());
         for (ObjectFactory::ObjectFactoryList::const_iterator
             it = pathList.begin(); it != pathList.end(); ++it) {
           ObjectFactory* p = *it;
@@ -129,6 +132,13 @@ namespace hpp {
                 toId = boost::lexical_cast <int> (p->getAttribute ("to"));
           NodePtr_t from = nodes_[fromId],
                     to   = nodes_[toId];
+          if (deferred) {
+            // The path is built by the steering method on first access.
+            edges_.push_back (roadmap_->addEdge (from, to, sm,
+                  (*roadmap_->distance ()) (*(from->configuration()),
+                                            *(to  ->configuration()))));
+            continue;
+          }
           PathPtr_t path = (*sm) (*(from->configuration()),
                                   *(to  ->configuration()));
           if (!path) {
@@ -279,6 +289,17 @@ namespace hpp {
         }
         return id;
       }
+
+      // ----------- Declare parameters ------------------------------------- //
+
+      HPP_START_PARAMETER_DECLARATION(RoadmapFactory)
+      Problem::declareParameter(ParameterDescription (Parameter::BOOL,
+            "RoadmapFactory/deferredEdgePaths",
+            "Whether the paths of the edges of roadmaps read from files are "
+            "built on first access instead of at reading. Edge costs are "
+            "then the distances between the nodes.",
+            Parameter(false)));
+      HPP_END_PARAMETER_DECLARATION(RoadmapFactory)
     } // namespace parser
   } // namespace core
 } // namespace hpp
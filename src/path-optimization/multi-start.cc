@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/path-optimization/multi-start.hh>
+
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/util/debug.hh>
+#include <hpp/core/configuration-shooter.hh>
+#include <hpp/core/distance.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathOptimization {
+      MultiStartPtr_t MultiStart::create
+      (const Problem& problem, const Builder_t& builder,
+       const ConnectionToolsFactory_t& factory, size_type numberStarts)
+      {
+        if (numberStarts < 1)
+          throw std::invalid_argument ("The number of starts must be "
+                                       "positive.");
+        if (builder.empty () || factory.empty ())
+          throw std::invalid_argument ("MultiStart needs a builder of "
+                                       "optimizers and a factory of tools.");
+        return MultiStartPtr_t (new MultiStart (problem, builder, factory,
+                                                numberStarts));
+      }
+
+      MultiStart::MultiStart (const Problem& problem, const Builder_t& builder,
+                              const ConnectionToolsFactory_t& factory,
+                              size_type numberStarts) :
+        PathOptimizer (problem), builder_ (builder), factory_ (factory),
+        numberStarts_ (numberStarts)
+      {
+      }
+
+      value_type MultiStart::cost (const PathVectorPtr_t& path) const
+      {
+        PathVectorPtr_t flat (PathVector::create (path->outputSize (),
+                                                  path->outputDerivativeSize ()));
+        path->flatten (flat);
+        const Distance& distance (*problem ().distance ());
+        value_type result = 0;
+        for (std::size_t i = 0; i < flat->numberPaths (); ++i) {
+          const PathPtr_t& element (flat->pathAtRank (i));
+          result += distance (element->initial (), element->end ());
+        }
+        return result;
+      }
+
+      PathVectorPtr_t MultiStart::optimize (const PathVectorPtr_t& path)
+      {
+        // The worker problems must outlive their optimizers.
+        std::vector <ProblemPtr_t> problems (numberStarts_);
+        optimizers_.resize (numberStarts_);
+        results_.assign (numberStarts_, PathVectorPtr_t ());
+        errors_.assign (numberStarts_, std::string ());
+        for (size_type i = 0; i < numberStarts_; ++i) {
+          const PathPlanner::ConnectionTools tools (factory_ ());
+          ProblemPtr_t worker (Problem::create (problem ().robot ()));
+          worker->parameters = problem ().parameters;
+          worker->distance (problem ().distance ()->clone ());
+          worker->steeringMethod (tools.steeringMethod);
+          worker->pathValidation (tools.pathValidation);
+          worker->pathProjector (tools.pathProjector);
+          worker->configurationShooter (tools.configurationShooter);
+          worker->randomGenerator
+            (tools.configurationShooter->randomGenerator ());
+          problems [i] = worker;
+          optimizers_ [i] = builder_ (*worker);
+        }
+
+        boost::thread_group threads;
+        for (std::size_t i = 0; i < optimizers_.size (); ++i)
+          threads.create_thread (boost::bind (&MultiStart::run, this, i,
+                                              boost::cref (path)));
+        threads.join_all ();
+        optimizers_.clear ();
+
+        PathVectorPtr_t best;
+        value_type bestCost = 0;
+        std::ostringstream oss;
+        for (std::size_t i = 0; i < results_.size (); ++i) {
+          if (!results_ [i]) {
+            oss << "\n  " << i << ": " << errors_ [i];
+            continue;
+          }
+          const value_type c (cost (results_ [i]));
+          hppDout (info, "start " << i << ", cost " << c);
+          if (!best || c < bestCost) {
+            best = results_ [i];
+            bestCost = c;
+          }
+        }
+        results_.clear ();
+        if (!best)
+          throw std::runtime_error ("All the starts failed:" + oss.str ());
+        return best;
+      }
+
+      void MultiStart::run (std::size_t i, const PathVectorPtr_t& path)
+      {
+        try {
+          results_ [i] = optimizers_ [i]->optimize (path);
+        } catch (const std::exception& exc) {
+          errors_ [i] = exc.what ();
+        }
+      }
+    } // namespace pathOptimization
+  } // namespace core
+} // namespace hpp
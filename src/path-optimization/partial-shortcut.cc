@@ -16,6 +16,12 @@
 
 #include <hpp/core/path-optimization/partial-shortcut.hh>
 
+#include <set>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <hpp/util/debug.hh>
 
 #include <pinocchio/algorithm/joint-configuration.hpp>
@@ -26,9 +32,12 @@
 #include <hpp/pinocchio/liegroup.hh>
 
 #include <hpp/core/distance.hh>
+#include <hpp/core/path-projector.hh>
 #include <hpp/core/path-validation.hh>
 #include <hpp/core/path-vector.hh>
 #include <hpp/core/problem.hh>
+#include <hpp/core/steering-method.hh>
+#include <hpp/core/random-generator.hh>
 #include <hpp/core/config-projector.hh>
 #include <hpp/constraints/locked-joint.hh>
 
@@ -58,8 +67,87 @@ namespace hpp {
           }
           return result;
         }
+
+        // Validate the elements of path that are not elements of reference.
+        // The elements of reference are already valid.
+        // \param statistics null in worker threads, that are not timed.
+        bool validateNewElements (const PathValidationPtr_t& validation,
+                                  const PathVectorPtr_t& path,
+                                  const PathVectorPtr_t& reference,
+                                  PlannerStatistics* statistics)
+        {
+          if (statistics) {
+            PlannerStatistics::ScopedTimer timer
+              (*statistics, PlannerStatistics::VALIDATION);
+            return validateNewElements (validation, path, reference, 0x0);
+          }
+          std::set <PathPtr_t> certified;
+          for (std::size_t i = 0; i < reference->numberPaths (); ++i)
+            certified.insert (reference->pathAtRank (i));
+          for (std::size_t i = 0; i < path->numberPaths (); ++i) {
+            const PathPtr_t& element (path->pathAtRank (i));
+            if (certified.count (element)) continue;
+            value_type lastValidTime;
+            if (!validation->isValid (element, false, lastValidTime))
+              return false;
+          }
+          return true;
+        }
+
+        // Steer and project with the objects of a thread
+        PathPtr_t steerWith (const PathPlanner::ConnectionTools& tools,
+                             ConfigurationIn_t q1, ConfigurationIn_t q2)
+        {
+          PathPtr_t path ((*tools.steeringMethod) (q1, q2));
+          if (!path || !tools.pathProjector) return path;
+          PathPtr_t projected;
+          if (!tools.pathProjector->apply (path, projected))
+            return PathPtr_t ();
+          return projected;
+        }
+
+        // Whether an element of the path projects on constraints
+        bool hasConfigProjector (const PathVectorPtr_t& path)
+        {
+          for (std::size_t i = 0; i < path->numberPaths (); ++i) {
+            const ConstraintSetPtr_t& c (path->pathAtRank (i)->constraints ());
+            if (c && c->configProjector ()) return true;
+          }
+          return false;
+        }
+
+        // Replace the parts of current between t [i] and t [i+1] by
+        // straight [i] if the latter is valid.
+        PathVectorPtr_t replaceValidParts (const PathVectorPtr_t& current,
+                                           const PathVectorPtr_t straight [3],
+                                           const bool valid [3],
+                                           const value_type t [4])
+        {
+          PathVectorPtr_t result = PathVector::create
+            (current->outputSize (), current->outputDerivativeSize ());
+          for (int i = 0; i < 3; ++i) {
+            if (valid [i])
+              result->concatenate (straight [i]);
+            else
+              result->concatenate ((current->extract
+                    (std::make_pair (t [i], t [i+1])))-> as <PathVector> ());
+          }
+          return result;
+        }
       }
 
+      struct PartialShortcut::Candidate
+      {
+        JointConstPtr_t joint;
+        /// Number of sub-paths: 1 for step 2, 3 for step 3
+        int n;
+        value_type t [4];
+        Configuration_t q [4];
+        /// Null if steering or projection failed
+        PathVectorPtr_t straight [3];
+        bool valid [3];
+      }; // struct Candidate
+
       PartialShortcut::Parameters::Parameters () :
         removeLockedJoints (true), onlyFullShortcut (true),
         numberOfConsecutiveFailurePerJoints (5), progressionMargin (1e-3)
@@ -71,32 +159,55 @@ namespace hpp {
       }
 
       PartialShortcut::PartialShortcut (const Problem& problem) :
-        PathOptimizer (problem)
+        PathOptimizer (problem), numberThreads_ (1)
       {
       }
 
+      void PartialShortcut::parallelCandidates
+      (size_type numberThreads, const ConnectionToolsFactory_t& factory)
+      {
+        if (numberThreads < 1 || (numberThreads > 1 && !factory))
+          throw std::invalid_argument ("Parallel partial shortcut requires a "
+                                       "positive number of threads and a "
+                                       "factory for several threads.");
+        numberThreads_ = numberThreads;
+        factory_ = factory;
+      }
+
       PathVectorPtr_t PartialShortcut::optimize (const PathVectorPtr_t& path)
       {
+        monitorExecution ();
         PathVectorPtr_t unpacked = PathVector::create (path->outputSize(),
             path->outputDerivativeSize ());
         unpack (path, unpacked);
+        recordLength (pathLength (unpacked, problem ().distance ()));
 
         /// Step 1: Generate a suitable vector of joints
         JointStdVector_t straight_jv = generateJointVector (unpacked);
         JointStdVector_t jv;
 
+        std::vector <ConnectionTools> tools;
+        if (numberThreads_ > 1 && !hasConfigProjector (unpacked)) {
+          for (size_type i = 0; i < numberThreads_; ++i)
+            tools.push_back (factory_ ());
+        }
+
         /// Step 2: First try to optimize each joint from beginning to end
-        PathVectorPtr_t result = optimizeFullPath (unpacked, straight_jv, jv);
-        if (parameters.onlyFullShortcut) return result;
+        PathVectorPtr_t result = tools.empty () ?
+          optimizeFullPath (unpacked, straight_jv, jv) :
+          optimizeFullPathParallel (unpacked, straight_jv, jv, tools);
+        if (parameters.onlyFullShortcut || jv.empty ()) return result;
 
         /// Step 3: Optimize randomly each joint
-        return optimizeRandom (result, jv);
+        if (tools.empty ()) return optimizeRandom (result, jv);
+        return optimizeRandomParallel (result, jv, tools);
       }
 
       PathVectorPtr_t PartialShortcut::generatePath (
           PathVectorPtr_t path, JointConstPtr_t joint,
           const value_type t1, ConfigurationIn_t q1,
-          const value_type t2, ConfigurationIn_t q2) const
+          const value_type t2, ConfigurationIn_t q2,
+          const ConnectionTools* tools) const
       {
         value_type lt1, lt2;
         // TODO: correct API so thatn these casts are no longer necessary!!
@@ -128,12 +239,19 @@ namespace hpp {
               return PathVectorPtr_t ();
             }
           }
-          last = (steer) (qi, q_inter);
+          // Keep the element if the joint already follows the interpolation
+          if (qi == path->pathAtRank (i)->initial () &&
+              q_inter == path->pathAtRank (i)->end ())
+            last = path->pathAtRank (i);
+          else if (tools)
+            last = steerWith (*tools, qi, q_inter);
+          else
+            last = steer (qi, q_inter);
           if (!last) return PathVectorPtr_t ();
           pv->appendPath (last);
           qi = q_inter;
         }
-        last = steer (qi, q2);
+        last = tools ? steerWith (*tools, qi, q2) : steer (qi, q2);
         if (!last) return PathVectorPtr_t ();
         pv->appendPath (last);
         PathVectorPtr_t out = PathVector::create (
@@ -196,20 +314,19 @@ namespace hpp {
           bool valid;
           PathVectorPtr_t straight;
           straight = generatePath (opted, joint, t0, q0, t3, q3);
-          {
-            PathPtr_t validPart;
-            PathValidationReportPtr_t report;
-            if (!straight) valid = false;
-            else {
-              valid = problem ().pathValidation ()->validate
-                (straight, false, validPart, report);
-            }
+          if (!straight) valid = false;
+          else {
+            valid = validateNewElements (problem ().pathValidation (),
+                                         straight, opted,
+                                         &mutableStatistics ().stages);
           }
+          recordCandidate (valid);
           if (!valid) {
             jvOut.push_back (joint);
             continue;
           }
           opted = straight;
+          recordLength (pathLength (opted, problem ().distance ()));
 
           hppDout (info, "length = " << pathLength (opted, problem ().distance ())
               << ", joint " << joint->name());
@@ -243,15 +360,15 @@ namespace hpp {
           ++iJ;
 
           t3 = current->timeRange ().second;
-          value_type u2 = t3 * rand ()/RAND_MAX;
-          value_type u1 = t3 * rand ()/RAND_MAX;
+          value_type u2 = t3 * problem ().randomGenerator ()->uniform ();
+          value_type u1 = t3 * problem ().randomGenerator ()->uniform ();
 
           value_type t1, t2;
           if (u1 < u2) {t1 = u1; t2 = u2;} else {t1 = u2; t2 = u1;}
           bool success =
             (*current) (q1, t1) &&
             (*current) (q2, t2);
-          if (success) {
+          if (!success) {
             hppDout (warning, "The constraints could not be applied to the "
                 "current path");
             nbFail++;
@@ -264,38 +381,24 @@ namespace hpp {
           straight [1] = generatePath (current, joint, t1, q1, t2, q2);
           straight [2] = generatePath (current, joint, t2, q2, t3, q3);
           for (unsigned i=0; i<3; ++i) {
-            PathPtr_t validPart;
-            PathValidationReportPtr_t report;
             if (!straight [i]) valid[i] = false;
             else {
-              valid [i] = problem ().pathValidation ()->validate
-                (straight [i], false, validPart, report);
+              valid [i] = validateNewElements (problem ().pathValidation (),
+                                               straight [i], current,
+                                               &mutableStatistics ().stages);
             }
           }
           if (!valid[0] && !valid[1] && !valid[2]) {
+            recordCandidate (false);
             nbFail++;
             continue;
           }
           // Replace valid parts
-          result = PathVector::create (pv->outputSize (),
-              pv->outputDerivativeSize ());
-          if (valid [0])
-            result->concatenate (straight [0]);
-          else
-            result->concatenate ((current->extract
-                  (std::make_pair (t0, t1))-> as <PathVector> ()));
-          if (valid [1])
-            result->concatenate (straight [1]);
-          else
-            result->concatenate ((current->extract
-                  (std::make_pair (t1, t2))-> as <PathVector> ()));
-          if (valid [2])
-            result->concatenate (straight [2]);
-          else
-            result->concatenate
-	      (current->extract (std::make_pair (t2, t3))-> as <PathVector> ());
+          const value_type t [4] = { t0, t1, t2, t3 };
+          result = replaceValidParts (current, straight, valid, t);
 
           newLength = pathLength (result, problem ().distance ());
+          recordCandidate (newLength < length);
           if (newLength >= length) {
             nbFail++;
             continue;
@@ -306,11 +409,175 @@ namespace hpp {
             nbFail = 0;
           --iJ; // This joint could be optimized. Try another time on it.
           length = newLength;
+          recordLength (length);
           hppDout (info, "length = " << length << ", nbFail = " << nbFail
               << ", joint " << joint->name());
           current = result;
         }
-        return result;
+        return current;
+      }
+
+      void PartialShortcut::evaluateRange (const ConnectionTools& tools,
+          const PathVectorPtr_t& path, Candidates_t& candidates,
+          std::size_t begin, std::size_t step) const
+      {
+        for (std::size_t k = begin; k < candidates.size (); k += step) {
+          Candidate& c (candidates [k]);
+          for (int i = 0; i < c.n; ++i) {
+            c.straight [i] = generatePath (path, c.joint, c.t [i], c.q [i],
+                                           c.t [i+1], c.q [i+1], &tools);
+            c.valid [i] = c.straight [i] &&
+              validateNewElements (tools.pathValidation, c.straight [i],
+                                   path, 0x0);
+          }
+        }
+      }
+
+      void PartialShortcut::evaluate
+      (const std::vector <ConnectionTools>& tools,
+       const PathVectorPtr_t& path, Candidates_t& candidates) const
+      {
+        PlannerStatistics::ScopedTimer timer (mutableStatistics ().stages,
+                                              PlannerStatistics::VALIDATION);
+        const std::size_t n (std::min (tools.size (), candidates.size ()));
+        boost::thread_group threads;
+        for (std::size_t i = 1; i < n; ++i) {
+          threads.create_thread (boost::bind
+                                 (&PartialShortcut::evaluateRange, this,
+                                  boost::cref (tools [i]), boost::cref (path),
+                                  boost::ref (candidates), i, n));
+        }
+        evaluateRange (tools [0], path, candidates, 0, n);
+        threads.join_all ();
+      }
+
+      PathVectorPtr_t PartialShortcut::optimizeFullPathParallel (
+          const PathVectorPtr_t& pv, const JointStdVector_t& jvIn,
+          JointStdVector_t& jvOut, const std::vector <ConnectionTools>& tools)
+        const
+      {
+        Candidates_t candidates (jvIn.size ());
+        for (std::size_t iJ = 0; iJ < jvIn.size(); ++iJ) {
+          Candidate& c (candidates [iJ]);
+          c.joint = jvIn [iJ];
+          c.n = 1;
+          c.t [0] = 0; c.q [0] = pv->initial ();
+          c.t [1] = pv->timeRange ().second; c.q [1] = pv->end ();
+        }
+        evaluate (tools, pv, candidates);
+
+        // Combine the valid candidates in the order of the joints
+        PathVectorPtr_t opted = pv;
+        for (std::size_t iJ = 0; iJ < candidates.size (); ++iJ) {
+          const Candidate& c (candidates [iJ]);
+          bool valid = c.valid [0];
+          PathVectorPtr_t straight = c.straight [0];
+          if (valid && opted != pv) {
+            straight = generatePath (opted, c.joint, 0, c.q [0],
+                                     opted->timeRange ().second, c.q [1]);
+            valid = straight &&
+              validateNewElements (problem ().pathValidation (), straight,
+                                   opted, &mutableStatistics ().stages);
+          }
+          recordCandidate (valid);
+          if (!valid) {
+            jvOut.push_back (c.joint);
+            continue;
+          }
+          opted = straight;
+          recordLength (pathLength (opted, problem ().distance ()));
+
+          hppDout (info, "length = " << pathLength (opted, problem ().distance ())
+              << ", joint " << c.joint->name());
+        }
+        return opted;
+      }
+
+      PathVectorPtr_t PartialShortcut::optimizeRandomParallel (
+          const PathVectorPtr_t& pv, const JointStdVector_t& jv,
+          const std::vector <ConnectionTools>& tools) const
+      {
+        PathVectorPtr_t current = pv;
+        value_type length = pathLength (pv, problem ().distance ());
+
+        hppDout (info, "parallel random partial shorcut on " << jv.size ()
+                 << " joints.");
+
+        // Maximal number of iterations without improvements
+        const std::size_t maxFailure = jv.size ()
+          * parameters.numberOfConsecutiveFailurePerJoints;
+        const std::size_t nbCandidates (std::min (tools.size (), jv.size ()));
+        std::size_t nbFail = 0;
+        std::size_t iJ = 0;
+        Configuration_t q1 (pv->outputSize ()), q2 (pv->outputSize ());
+        while (nbFail < maxFailure) {
+          const value_type t3 = current->timeRange ().second;
+          value_type u2 = t3 * problem ().randomGenerator ()->uniform ();
+          value_type u1 = t3 * problem ().randomGenerator ()->uniform ();
+
+          value_type t1, t2;
+          if (u1 < u2) {t1 = u1; t2 = u2;} else {t1 = u2; t2 = u1;}
+          bool success =
+            (*current) (q1, t1) &&
+            (*current) (q2, t2);
+          if (!success) {
+            hppDout (warning, "The constraints could not be applied to the "
+                "current path");
+            nbFail += nbCandidates;
+            continue;
+          }
+          // Same times for consecutive joints
+          Candidates_t candidates (nbCandidates);
+          for (std::size_t k = 0; k < nbCandidates; ++k) {
+            Candidate& c (candidates [k]);
+            c.joint = jv [(iJ + k) % jv.size ()];
+            c.n = 3;
+            c.t [0] = 0;  c.q [0] = current->initial ();
+            c.t [1] = t1; c.q [1] = q1;
+            c.t [2] = t2; c.q [2] = q2;
+            c.t [3] = t3; c.q [3] = current->end ();
+          }
+          evaluate (tools, current, candidates);
+
+          // Keep the shortest path
+          PathVectorPtr_t best;
+          value_type bestLength = length;
+          std::size_t bestK = 0;
+          for (std::size_t k = 0; k < nbCandidates; ++k) {
+            const Candidate& c (candidates [k]);
+            if (!c.valid [0] && !c.valid [1] && !c.valid [2]) {
+              recordCandidate (false);
+              continue;
+            }
+            PathVectorPtr_t result = replaceValidParts (current, c.straight,
+                                                        c.valid, c.t);
+            const value_type newLength = pathLength (result,
+                                                     problem ().distance ());
+            recordCandidate (newLength < length);
+            if (newLength < bestLength) {
+              best = result;
+              bestLength = newLength;
+              bestK = k;
+            }
+          }
+          if (!best) {
+            nbFail += nbCandidates;
+            iJ = (iJ + nbCandidates) % jv.size ();
+            continue;
+          }
+          if (bestLength >= length - parameters.progressionMargin)
+            nbFail++;
+          else
+            nbFail = 0;
+          // The best joint could be optimized. Try another time from it.
+          iJ = (iJ + bestK) % jv.size ();
+          length = bestLength;
+          recordLength (length);
+          hppDout (info, "length = " << length << ", nbFail = " << nbFail
+              << ", joint " << candidates [bestK].joint->name());
+          current = best;
+        }
+        return current;
       }
     } // namespace pathOptimization
   } // namespace core
@@ -53,6 +53,8 @@ namespace hpp {
         HPP_SCOPE_TIMECOUNTER(QuadraticProgram_computeLLT);
         trace = H.trace();
         llt.compute(H);
+        invLT = llt.matrixU().solve(matrix_t::Identity(H.rows(), H.cols()));
+        traceInvLT = invLT.trace();
       }
 
       double QuadraticProgram::solve(const LinearConstraint& ce, const LinearConstraint& ci)
@@ -64,7 +66,7 @@ namespace hpp {
         // s.t.  CE^T x + ce0 = 0
         //       CI^T x + ci0 >= 0
         Eigen::QuadProgStatus status;
-        double cost = solve_quadprog2 (llt, trace, b,
+        double cost = solve_quadprog2 (llt, trace, invLT, traceInvLT, b,
             ce.J.transpose(), - ce.b,
             ci.J.transpose(), - ci.b,
             xStar, activeConstraint, activeSetSize, status);
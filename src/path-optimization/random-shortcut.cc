@@ -18,39 +18,150 @@
 
 #include <hpp/core/path-optimization/random-shortcut.hh>
 
+#include <algorithm>
 #include <limits>
 #include <deque>
 #include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 #include <hpp/util/assertion.hh>
 #include <hpp/util/debug.hh>
 #include <hpp/core/distance.hh>
 #include <hpp/core/path-validation.hh>
 #include <hpp/core/path-vector.hh>
 #include <hpp/core/problem.hh>
+#include <hpp/core/random-generator.hh>
 #include <hpp/core/path-projector.hh>
+#include <hpp/core/steering-method.hh>
 
 namespace hpp {
   namespace core {
     namespace pathOptimization {
-    // Compute the length of a vector of paths assuming that each element
-    // is optimal for the given distance.
-    template <bool reEstimateLength = false> struct _PathLength {
-      static inline value_type run (const PathVectorPtr_t& path,
-                             const DistancePtr_t& distance)
+    // Cumulated lengths of the elements of a vector of paths, assuming that
+    // each element is optimal for the given distance. The length of a
+    // shortcut is then computed from the replaced segments only.
+    struct ElementLengths
+    {
+      ElementLengths (const DistancePtr_t& d) : distance (d), sums (1, 0) {}
+
+      void reset (const PathVectorPtr_t& p)
+      {
+        path = p;
+        sums.assign (1, 0);
+        for (std::size_t i=0; i<path->numberPaths (); ++i) {
+          const PathPtr_t& element (path->pathAtRank (i));
+          push_back ((*distance) (element->initial (), element->end ()));
+        }
+      }
+
+      void push_back (const value_type& l)
+      {
+        sums.push_back (sums.back () + l);
+      }
+
+      value_type total () const
+      {
+        return sums.back ();
+      }
+
+      // Length of the sub-path between parameters t1 and t2, where path
+      // evaluates to q1 and q2.
+      value_type length (const value_type& t1, ConfigurationIn_t q1,
+                         const value_type& t2, ConfigurationIn_t q2) const
       {
-        if (reEstimateLength) return path->length ();
-        else {
-          value_type result = 0;
-          for (std::size_t i=0; i<path->numberPaths (); ++i) {
-            const PathPtr_t& element (path->pathAtRank (i));
-            Configuration_t q1 = element->initial ();
-            Configuration_t q2 = element->end ();
-            result += (*distance) (q1, q2);
+        value_type localParam;
+        const std::size_t r1 (path->rankAtParam (t1, localParam)),
+          r2 (path->rankAtParam (t2, localParam));
+        if (r1 == r2) return (*distance) (q1, q2);
+        return (*distance) (q1, path->pathAtRank (r1)->end ())
+          + sums [r2] - sums [r1+1]
+          + (*distance) (path->pathAtRank (r2)->initial (), q2);
+      }
+
+      // Append to result the sub-path of from between t1 and t2 and record
+      // the lengths of the new elements. The lengths of the elements fully
+      // contained in the sub-path are copied, unless extract did not keep
+      // one element per rank.
+      void extract (const ElementLengths& from, const PathVectorPtr_t& result,
+                    const value_type& t1, ConfigurationIn_t q1,
+                    const value_type& t2, ConfigurationIn_t q2)
+      {
+        const std::size_t before (result->numberPaths ());
+        result->concatenate (from.path->extract
+                             (std::make_pair (t1, t2))->as <PathVector> ());
+        value_type localParam;
+        const std::size_t r1 (from.path->rankAtParam (t1, localParam)),
+          r2 (from.path->rankAtParam (t2, localParam));
+        if (result->numberPaths () - before == r2 - r1 + 1) {
+          if (r1 == r2) {
+            push_back ((*distance) (q1, q2));
+            return;
           }
-          return result;
+          push_back ((*distance) (q1, from.path->pathAtRank (r1)->end ()));
+          for (std::size_t r = r1 + 1; r < r2; ++r)
+            push_back (from.sums [r+1] - from.sums [r]);
+          push_back ((*distance) (from.path->pathAtRank (r2)->initial (), q2));
+          return;
+        }
+        for (std::size_t i = before; i < result->numberPaths (); ++i) {
+          const PathPtr_t& element (result->pathAtRank (i));
+          push_back ((*distance) (element->initial (), element->end ()));
         }
       }
-    };
+
+      DistancePtr_t distance;
+      PathVectorPtr_t path;
+      // sums [i] is the length of the i first elements of path.
+      std::vector <value_type> sums;
+    }; // struct ElementLengths
+
+    // Length of the shortcut replacing the valid parts of current.
+    static value_type shortcutLength (const ElementLengths& current,
+        const value_type t[4], const Configuration_t q[4], const bool valid[3])
+    {
+      value_type result = 0;
+      for (int i = 0; i < 3; ++i) {
+        if (valid [i]) result += (*current.distance) (q[i], q[i+1]);
+        else result += current.length (t[i], q[i], t[i+1], q[i+1]);
+      }
+      return result;
+    }
+
+    // Build the shortcut replacing the valid parts of current, and the
+    // lengths of its elements.
+    static PathVectorPtr_t buildShortcut (const ElementLengths& current,
+        const value_type t[4], const Configuration_t q[4],
+        const PathPtr_t proj[3], const bool valid[3], ElementLengths& lengths)
+    {
+      PathVectorPtr_t result (PathVector::create
+                              (current.path->outputSize (),
+                               current.path->outputDerivativeSize ()));
+      lengths.sums.assign (1, 0);
+      for (int i = 0; i < 3; ++i) {
+        if (valid [i]) {
+          result->appendPath (proj [i]);
+          lengths.push_back ((*current.distance) (q[i], q[i+1]));
+        } else
+          lengths.extract (current, result, t[i], q[i], t[i+1], q[i+1]);
+      }
+      lengths.path = result;
+      return result;
+    }
+
+    // Whether t1 and t2 belong to the same element of path. The element
+    // being optimal and valid, steering between t1 and t2 would only
+    // rebuild and validate again the extracted sub-path.
+    static bool sameElement (const PathVectorPtr_t& path,
+                             const value_type& t1, const value_type& t2)
+    {
+      value_type localParam;
+      const std::size_t rank (path->rankAtParam (t1, localParam));
+      if (rank != path->rankAtParam (t2, localParam)) return false;
+      return !HPP_DYNAMIC_PTR_CAST (PathVector, path->pathAtRank (rank));
+    }
 
     RandomShortcutPtr_t
     RandomShortcut::create (const Problem& problem)
@@ -60,16 +171,31 @@ namespace hpp {
     }
 
     RandomShortcut::RandomShortcut (const Problem& problem) :
-      PathOptimizer (problem)
+      PathOptimizer (problem), batchSize_ (1), numberThreads_ (1),
+      numberOfLoops_ (problem, "PathOptimization/RandomShortcut/NumberOfLoops")
     {
     }
 
+    void RandomShortcut::batch (size_type numberCandidates,
+                                size_type numberThreads,
+                                const ConnectionToolsFactory_t& factory)
+    {
+      if (numberCandidates < 1 || numberThreads < 1 ||
+          (numberThreads > 1 && !factory))
+        throw std::invalid_argument ("Batched shortcuts require a positive "
+                                     "number of candidates and threads, and "
+                                     "a factory for several threads.");
+      batchSize_ = numberCandidates;
+      numberThreads_ = numberThreads;
+      factory_ = factory;
+    }
+
     PathVectorPtr_t RandomShortcut::optimize (const PathVectorPtr_t& path)
     {
       monitorExecution();
+      if (batchSize_ > 1) return batchedOptimize (path);
 
       using std::numeric_limits;
-      using std::make_pair;
       bool finished = false;
       value_type t[4];
       Configuration_t q[4];
@@ -80,11 +206,15 @@ namespace hpp {
       PathVectorPtr_t tmpPath = path;
 
       // Maximal number of iterations without improvements
-      const std::size_t n = problem().getParameter("PathOptimization/RandomShortcut/NumberOfLoops").intValue();
+      const std::size_t n = numberOfLoops_.value ();
       std::size_t projectionError = n;
       std::deque <value_type> length (n-1,
 				      numeric_limits <value_type>::infinity ());
-      length.push_back (_PathLength<>::run (tmpPath, problem ().distance ()));
+      ElementLengths current (problem ().distance ()),
+        next (problem ().distance ());
+      current.reset (tmpPath);
+      length.push_back (current.total ());
+      recordLength (current.total ());
       PathVectorPtr_t result;
 
       while (!shouldStop() && !finished && projectionError != 0) {
@@ -109,55 +239,62 @@ namespace hpp {
 	// Validate sub parts
 	bool valid [3];
 	PathPtr_t proj [3];
-        // Build and projects the path
+        // Build and projects the path, except in unchanged elements
         for (int i = 0; i < 3; ++i)
-          proj[i] = steer (q[i], q[i+1]);
+          if (!sameElement (tmpPath, t[i], t[i+1]))
+            proj[i] = steer (q[i], q[i+1]);
         if (!proj[0] && !proj[1] && !proj[2]) {
           hppDout (info, "Enable to create a valid path");
           projectionError--;
           continue;
         }
-        // validate the paths
-        for (unsigned i=0; i<3; ++i) {
-	  PathPtr_t validPart;
-	  PathValidationReportPtr_t report;
-          if (!proj [i]) valid[i] = false;
-          else
-            valid [i] = problem ().pathValidation ()->validate
-              (proj [i], false, validPart, report);
-	}
+        // validate the paths in one batch
+        std::vector <PathPtr_t> paths, validParts;
+        std::vector <int> ranks;
+        std::vector <PathValidationReportPtr_t> reports;
+        std::vector <bool> validPaths;
+        for (int i = 0; i < 3; ++i) {
+          valid [i] = false;
+          if (!proj [i]) continue;
+          paths.push_back (proj [i]);
+          ranks.push_back (i);
+        }
+        {
+          PlannerStatistics::ScopedTimer timer
+            (mutableStatistics ().stages, PlannerStatistics::VALIDATION);
+          problem ().pathValidation ()->validatePaths
+            (paths, false, validParts, reports, validPaths);
+        }
+        for (std::size_t i = 0; i < paths.size (); ++i)
+          valid [ranks [i]] = validPaths [i];
+        value_type newLength = shortcutLength (current, t, q, valid);
+        if (length[n-1] <= newLength) {
+          hppDout (info,  "the length would increase:" << length[n-1] << " " << newLength);
+          recordCandidate (false);
+          result = tmpPath;
+          projectionError--;
+          continue;
+        }
 	// Replace valid parts
-	result = PathVector::create (path->outputSize (),
-				     path->outputDerivativeSize ());
         try {
-          for (int i = 0; i < 3; ++i) {
-            if (valid [i])
-              result->appendPath (proj [i]);
-            else
-              result->concatenate (tmpPath->extract
-                                   (make_pair (t[i], t[i+1]))->
-                                   as <PathVector> ());
-          }
+          result = buildShortcut (current, t, q, proj, valid, next);
         } catch (const projection_error& e) {
           hppDout (error, "Caught exception at with time " << t[1] << " and " <<
               t[2] << ": " << e.what ());
+          recordCandidate (false);
           projectionError--;
           result = tmpPath;
           continue;
         }
-        value_type newLength = _PathLength<>::run (result, problem ().distance ());
-        if (length[n-1] <= newLength) {
-          hppDout (info,  "the length would increase:" << length[n-1] << " " << newLength);
-          result = tmpPath;
-          projectionError--;
-        } else {
-          length.push_back (newLength);
-          length.pop_front ();
-          finished = (length [0] - length [n-1]) <= 1e-4 * length[n-1];
-          hppDout (info, "length = " << length [n-1]);
-          tmpPath = result;
-          projectionError = n;
-        }
+        recordCandidate (true);
+        recordLength (newLength);
+        length.push_back (newLength);
+        length.pop_front ();
+        finished = (length [0] - length [n-1]) <= 1e-4 * length[n-1];
+        hppDout (info, "length = " << length [n-1]);
+        tmpPath = result;
+        std::swap (current, next);
+        projectionError = n;
       }
       if (!result) return path;
       hppDout (info, "RandomShortcut:" << *result);
@@ -171,14 +308,171 @@ namespace hpp {
       return result;
     }
 
+    void RandomShortcut::shortcutRange (const ConnectionTools& tools,
+        Candidates_t& candidates, std::size_t begin, std::size_t step)
+    {
+      for (std::size_t k = begin; k < candidates.size (); k += step) {
+        Candidate& c (candidates [k]);
+        for (int i = 0; i < 3; ++i) {
+          c.valid [i] = false;
+          if (c.unchanged [i]) continue;
+          PathPtr_t path ((*tools.steeringMethod) (c.q [i], c.q [i+1]));
+          if (path && tools.pathProjector) {
+            PathPtr_t proj;
+            if (!tools.pathProjector->apply (path, proj)) proj.reset ();
+            path = proj;
+          }
+          c.proj [i] = path;
+          if (!path) continue;
+          PathPtr_t validPart;
+          PathValidationReportPtr_t report;
+          c.valid [i] = tools.pathValidation->validate
+            (path, false, validPart, report);
+        }
+      }
+    }
+
+    PathVectorPtr_t RandomShortcut::batchedOptimize
+    (const PathVectorPtr_t& path)
+    {
+      using std::numeric_limits;
+      std::vector <ConnectionTools> tools;
+      if (numberThreads_ > 1) {
+        for (size_type i = 0; i < numberThreads_; ++i)
+          tools.push_back (factory_ ());
+      } else {
+        ConnectionTools t;
+        t.steeringMethod = problem ().steeringMethod ();
+        t.pathProjector = problem ().pathProjector ();
+        t.pathValidation = problem ().pathValidation ();
+        tools.push_back (t);
+      }
+
+      bool finished = false;
+      PathVectorPtr_t tmpPath = path;
+      // Maximal number of iterations without improvements
+      const std::size_t n = numberOfLoops_.value ();
+      std::size_t projectionError = n;
+      std::deque <value_type> length (n-1,
+				      numeric_limits <value_type>::infinity ());
+      ElementLengths current (problem ().distance ()),
+        next (problem ().distance ());
+      current.reset (tmpPath);
+      length.push_back (current.total ());
+      recordLength (current.total ());
+      PathVectorPtr_t result;
+      Candidates_t candidates;
+
+      while (!shouldStop() && !finished && projectionError != 0) {
+        endIteration();
+        // Sample the candidates in this thread since evaluating the path
+        // projects configurations with its constraints.
+        const value_type t0 (tmpPath->timeRange().first),
+          t3 (tmpPath->timeRange().second);
+        candidates.clear ();
+        for (size_type k = 0; k < batchSize_; ++k) {
+          Candidate c;
+          c.t [0] = t0; c.t [3] = t3;
+          if (!shootTimes (tmpPath, t0, c.t [1], c.t [2], t3)) continue;
+          c.q [0] = tmpPath->initial ();
+          c.q [3] = tmpPath->end ();
+          bool error = false;
+          for (int i = 1; i < 3; ++i) {
+            c.q [i].resize (tmpPath->outputSize ());
+            if (!(*tmpPath) (c.q [i], c.t [i])) {
+              hppDout (error, "Configuration at param "
+                  << c.t [i] << " could not be projected");
+              error = true;
+              break;
+            }
+          }
+          if (error) continue;
+          for (int i = 0; i < 3; ++i)
+            c.unchanged [i] = sameElement (tmpPath, c.t [i], c.t [i+1]);
+          if (!c.unchanged [0] || !c.unchanged [1] || !c.unchanged [2])
+            candidates.push_back (c);
+        }
+        if (candidates.empty ()) {
+          projectionError--;
+          continue;
+        }
+
+        const std::size_t nThreads
+          (std::min (tools.size (), candidates.size ()));
+        if (nThreads <= 1) {
+          shortcutRange (tools [0], candidates, 0, 1);
+        } else {
+          boost::thread_group threads;
+          for (std::size_t t = 0; t < nThreads; ++t) {
+            threads.create_thread
+              (boost::bind (&RandomShortcut::shortcutRange,
+                            boost::cref (tools [t]), boost::ref (candidates),
+                            t, nThreads));
+          }
+          threads.join_all ();
+        }
+
+        // Keep the shortest improvement
+        PathVectorPtr_t best;
+        value_type bestLength (length [n-1]);
+        std::vector <std::size_t> order;
+        std::vector <value_type> lengths;
+        for (std::size_t k = 0; k < candidates.size (); ++k) {
+          const Candidate& c (candidates [k]);
+          if (!c.valid [0] && !c.valid [1] && !c.valid [2]) continue;
+          lengths.push_back (shortcutLength (current, c.t, c.q, c.valid));
+          order.push_back (k);
+        }
+        // Only build the shortcuts by increasing length, until one can be
+        // extracted from the current path.
+        while (!best && !order.empty ()) {
+          const std::size_t j (std::min_element (lengths.begin (),
+                                                 lengths.end ())
+                               - lengths.begin ());
+          if (bestLength <= lengths [j]) break;
+          const Candidate& c (candidates [order [j]]);
+          try {
+            best = buildShortcut (current, c.t, c.q, c.proj, c.valid, next);
+            bestLength = lengths [j];
+          } catch (const projection_error& e) {
+            hppDout (error, "Caught exception at with time " << c.t [1] <<
+                " and " << c.t [2] << ": " << e.what ());
+          }
+          lengths.erase (lengths.begin () + j);
+          order.erase (order.begin () + j);
+        }
+        for (std::size_t k = (best ? 1 : 0); k < candidates.size (); ++k)
+          recordCandidate (false);
+        if (!best) {
+          hppDout (info, "no candidate decreases the length: "
+              << length [n-1]);
+          projectionError--;
+          continue;
+        }
+        recordCandidate (true);
+        recordLength (bestLength);
+        length.push_back (bestLength);
+        length.pop_front ();
+        finished = (length [0] - length [n-1]) <= 1e-4 * length[n-1];
+        hppDout (info, "length = " << length [n-1]);
+        tmpPath = best;
+        result = best;
+        std::swap (current, next);
+        projectionError = n;
+      }
+      if (!result) return path;
+      return result;
+    }
+
     bool RandomShortcut::shootTimes (const PathVectorPtr_t& /*current*/,
         const value_type& t0,
         value_type& t1,
         value_type& t2,
         const value_type& t3)
     {
-      value_type u2 = (t3-t0) * rand ()/RAND_MAX;
-      value_type u1 = (t3-t0) * rand ()/RAND_MAX;
+      RandomGenerator& generator (*problem ().randomGenerator ());
+      value_type u2 = (t3-t0) * generator.uniform ();
+      value_type u1 = (t3-t0) * generator.uniform ();
       if (u1 < u2) {
         t1 = t0 + u1;
         t2 = t0 + u2;
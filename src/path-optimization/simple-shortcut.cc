@@ -18,14 +18,22 @@
 
 #include <hpp/core/path-optimization/simple-shortcut.hh>
 
+#include <limits>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <hpp/util/assertion.hh>
 #include <hpp/util/debug.hh>
+#include <hpp/core/distance.hh>
 #include <hpp/core/path-validation.hh>
 #include <hpp/core/path-vector.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/problem-target.hh>
 #include <hpp/core/path-projector.hh>
 #include <hpp/core/roadmap.hh>
+#include <hpp/core/steering-method.hh>
 
 namespace hpp {
   namespace core {
@@ -38,12 +46,24 @@ namespace hpp {
       }
 
       SimpleShortcut::SimpleShortcut (const Problem& problem) :
-        PathOptimizer (problem)
+        PathOptimizer (problem), numberThreads_ (0)
+      {
+      }
+
+      void SimpleShortcut::visibilityGraph
+      (size_type numberThreads, const ConnectionToolsFactory_t& factory)
       {
+        if (numberThreads < 0 || (numberThreads > 1 && !factory))
+          throw std::invalid_argument ("The visibility graph requires a "
+                                       "non negative number of threads and "
+                                       "a factory for several threads.");
+        numberThreads_ = numberThreads;
+        factory_ = factory;
       }
 
       PathVectorPtr_t SimpleShortcut::optimize (const PathVectorPtr_t& path)
       {
+        if (numberThreads_ > 0) return visibilityOptimize (path);
         RoadmapPtr_t roadmap (Roadmap::create (problem ().distance (),
                                                problem ().robot ()));
         std::vector <NodePtr_t> nodes;
@@ -63,10 +83,9 @@ namespace hpp {
           for (std::size_t j=i+2; j < nodes.size (); ++j) {
             PathPtr_t path (steer (*(nodes [i]->configuration ()),
                                    *(nodes [j]->configuration ())));
-            PathValidationReportPtr_t report;
-            PathPtr_t unused;
+            value_type lastValidTime;
             if ((path) &&
-                (pv->validate (path, false, unused, report))) {
+                (pv->isValid (path, false, lastValidTime))) {
               roadmap->addEdge (nodes [i], nodes [j], path);
             }
           }
@@ -75,6 +94,133 @@ namespace hpp {
         assert (result);
         return result;
       }
+
+      void SimpleShortcut::validateRange
+      (const ConnectionTools& tools, const std::vector <Configuration_t>& q,
+       Pairs_t& pairs, std::size_t begin, std::size_t step)
+      {
+        for (std::size_t k = begin; k < pairs.size (); k += step) {
+          Pair& pair (pairs [k]);
+          pair.visible = false;
+          PathPtr_t path ((*tools.steeringMethod) (q [pair.i], q [pair.j]));
+          if (path && tools.pathProjector) {
+            PathPtr_t projected;
+            if (!tools.pathProjector->apply (path, projected)) continue;
+            path = projected;
+          }
+          value_type lastValidTime;
+          pair.visible = path &&
+            tools.pathValidation->isValid (path, false, lastValidTime);
+        }
+      }
+
+      PathVectorPtr_t SimpleShortcut::visibilityOptimize
+      (const PathVectorPtr_t& path)
+      {
+        std::vector <ConnectionTools> tools;
+        if (numberThreads_ > 1) {
+          for (size_type i = 0; i < numberThreads_; ++i)
+            tools.push_back (factory_ ());
+        } else {
+          ConnectionTools t;
+          t.steeringMethod = problem ().steeringMethod ();
+          t.pathProjector = problem ().pathProjector ();
+          t.pathValidation = problem ().pathValidation ();
+          tools.push_back (t);
+        }
+
+        // Waypoints and their times along path
+        const std::size_t n (path->numberPaths () + 1);
+        std::vector <Configuration_t> q (n);
+        std::vector <value_type> times (n);
+        q [0] = path->initial ();
+        times [0] = path->timeRange ().first;
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+          q [i+1] = path->pathAtRank (i)->end ();
+          times [i+1] = times [i] + path->pathAtRank (i)->length ();
+        }
+
+        // visible [i * n + j] for i < j. Consecutive waypoints are visible.
+        std::vector <bool> visible (n * n, false);
+        for (std::size_t i = 0; i + 1 < n; ++i) visible [i * n + i + 1] = true;
+        // covered [k] is the last waypoint of the visible pairs starting
+        // before k.
+        std::vector <std::size_t> covered (n);
+        for (std::size_t k = 0; k < n; ++k) covered [k] = k;
+        Pairs_t pairs;
+        for (std::size_t span = n - 1; span >= 2 && !shouldStop (); --span) {
+          pairs.clear ();
+          for (std::size_t i = 0; i + span < n; ++i) {
+            if (covered [i] >= i + span) continue;
+            Pair pair;
+            pair.i = i; pair.j = i + span;
+            pairs.push_back (pair);
+          }
+          if (pairs.empty ()) continue;
+          const std::size_t nThreads
+            (std::min (tools.size (), pairs.size ()));
+          {
+            PlannerStatistics::ScopedTimer timer
+              (mutableStatistics ().stages, PlannerStatistics::VALIDATION);
+            boost::thread_group threads;
+            for (std::size_t t = 1; t < nThreads; ++t) {
+              threads.create_thread
+                (boost::bind (&SimpleShortcut::validateRange,
+                              boost::cref (tools [t]), boost::cref (q),
+                              boost::ref (pairs), t, nThreads));
+            }
+            validateRange (tools [0], q, pairs, 0, nThreads);
+            threads.join_all ();
+          }
+          for (std::size_t k = 0; k < pairs.size (); ++k) {
+            recordCandidate (pairs [k].visible);
+            if (!pairs [k].visible) continue;
+            visible [pairs [k].i * n + pairs [k].j] = true;
+            covered [pairs [k].i] = std::max (covered [pairs [k].i],
+                                              pairs [k].j);
+          }
+          for (std::size_t k = 1; k < n; ++k)
+            covered [k] = std::max (covered [k], covered [k-1]);
+        }
+
+        // Shortest path, edges going forward
+        const DistancePtr_t& distance (problem ().distance ());
+        std::vector <value_type> cost
+          (n, std::numeric_limits <value_type>::infinity ());
+        std::vector <std::size_t> previous (n, 0);
+        cost [0] = 0;
+        for (std::size_t j = 1; j < n; ++j) {
+          for (std::size_t i = 0; i < j; ++i) {
+            if (!visible [i * n + j]) continue;
+            const value_type c (cost [i] + (*distance) (q [i], q [j]));
+            if (c < cost [j]) {
+              cost [j] = c;
+              previous [j] = i;
+            }
+          }
+        }
+
+        std::vector <std::size_t> waypoints (1, n - 1);
+        while (waypoints.back () != 0)
+          waypoints.push_back (previous [waypoints.back ()]);
+        PathVectorPtr_t result (PathVector::create
+                                (path->outputSize (),
+                                 path->outputDerivativeSize ()));
+        for (std::size_t k = waypoints.size () - 1; k > 0; --k) {
+          const std::size_t i (waypoints [k]), j (waypoints [k-1]);
+          PathPtr_t element;
+          if (j == i + 1)
+            element = path->pathAtRank (i);
+          else
+            element = steer (q [i], q [j]);
+          // The input path between i and j is valid anyway.
+          if (!element)
+            element = path->extract (std::make_pair (times [i], times [j]));
+          result->appendPath (element);
+        }
+        recordLength (cost [n-1]);
+        return result;
+      }
     } // namespace pathOptimization
   } // namespace core
 } // namespace hpp
@@ -157,9 +157,9 @@ namespace hpp {
         }
         const value_type infinity = std::numeric_limits<value_type>::infinity();
 
-        const value_type safety = problem().getParameter("SimpleTimeParameterization/safety").floatValue();
-        const size_type order = problem().getParameter("SimpleTimeParameterization/order").intValue();
-        const value_type maxAcc = problem().getParameter("SimpleTimeParameterization/maxAcceleration").floatValue();
+        const value_type safety = safety_.value ();
+        const size_type order = order_.value ();
+        const value_type maxAcc = maxAcceleration_.value ();
         if (order <= 1 && maxAcc > 0) {
           throw std::invalid_argument ("Maximum acceleration cannot be set when order is <= to 1. Please set parameter SimpleTimeParameterization/maxAcceleration to a negative value.");
         }
@@ -250,7 +250,11 @@ namespace hpp {
       }
 
       SimpleTimeParameterization::SimpleTimeParameterization (const Problem& problem):
-        PathOptimizer(problem) {}
+        PathOptimizer(problem),
+        safety_ (problem, "SimpleTimeParameterization/safety"),
+        order_ (problem, "SimpleTimeParameterization/order"),
+        maxAcceleration_ (problem, "SimpleTimeParameterization/maxAcceleration")
+      {}
 
       // ----------- Declare parameters ------------------------------------- //
 
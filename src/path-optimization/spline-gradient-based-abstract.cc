@@ -209,24 +209,51 @@ namespace hpp {
       {
         assert (validations_.size() == splines.size());
         HPP_SCOPE_TIMECOUNTER(SGB_validatePath);
-	PathPtr_t validPart;
-	PathValidationReportPtr_t report;
 	Reports_t reports;
         assert(reordering.size() == splines.size());
 #ifndef NDEBUG
         std::vector<bool> check_ordering (reordering.size(), false);
 #endif
+        // Group the splines by path validation, keeping the order given by
+        // reordering, so that each group is validated by one call to
+        // PathValidation::validatePaths which may use several threads.
+        typedef std::pair<PathValidationPtr_t, std::vector<std::size_t> > Group_t;
+        std::vector<Group_t> groups;
         for (std::size_t j = 0; j < splines.size(); ++j) {
           const std::size_t& i = reordering[j];
 #ifndef NDEBUG
           assert(!check_ordering[i]);
           check_ordering[i] = true;
 #endif
-	  if (!validations_[i]->validate (splines[i], false, validPart, report)) {
-	    reports.push_back (std::make_pair (report, i));
-            if (stopAtFirst) break;
-	  }
-	}
+          std::size_t g = 0;
+          while (g < groups.size() && groups[g].first != validations_[i]) ++g;
+          if (g == groups.size())
+            groups.push_back (Group_t (validations_[i], std::vector<std::size_t>()));
+          groups[g].second.push_back (j);
+        }
+
+        // Reports indexed by position in reordering
+        std::vector<PathValidationReportPtr_t> invalid (splines.size());
+        std::vector<PathPtr_t> paths, validParts;
+        std::vector<PathValidationReportPtr_t> pathReports;
+        std::vector<bool> valid;
+        for (std::size_t g = 0; g < groups.size(); ++g) {
+          const std::vector<std::size_t>& positions (groups[g].second);
+          paths.resize (positions.size());
+          for (std::size_t k = 0; k < positions.size(); ++k)
+            paths[k] = splines[reordering[positions[k]]];
+          groups[g].first->validatePaths (paths, false, validParts,
+              pathReports, valid, stopAtFirst);
+          // Paths skipped after the first invalid one have no report.
+          for (std::size_t k = 0; k < positions.size(); ++k)
+            if (!valid[k] && pathReports[k])
+              invalid[positions[k]] = pathReports[k];
+        }
+        for (std::size_t j = 0; j < splines.size(); ++j) {
+          if (!invalid[j]) continue;
+          reports.push_back (std::make_pair (invalid[j], reordering[j]));
+          if (stopAtFirst) break;
+        }
         if (reorder && !reports.empty()) {
           const std::size_t k = reports.front().second;
           // Set reordering to [ k, ..., n-1, 0, ..., k-1]
@@ -84,6 +84,7 @@ namespace hpp {
           splineIds.push_back(idx);
           rows.push_back(row);
           ratios.push_back(r);
+          parameters.push_back(vector_t());
         }
 
         void removeLastConstraint (const std::size_t& n, LinearConstraint& lc)
@@ -95,6 +96,7 @@ namespace hpp {
           splineIds.resize(nSize);
           rows.resize(nSize);
           ratios.resize(nSize);
+          parameters.resize(nSize);
 
           lc.J.conservativeResize(lc.J.rows() - n, lc.J.cols());
           lc.b.conservativeResize(lc.b.rows() - n, lc.b.cols());
@@ -148,18 +150,47 @@ namespace hpp {
           lc.b.segment(row, nbRows) =
             lc.J.block (row, col, nbRows, Spline::NbCoeffs * rDof)
             * spline->rowParameters();
+          parameters[fIdx] = spline->rowParameters();
         }
 
-        void linearize (const Splines_t& splines, const SplineOptimizationDatas_t& ss, LinearConstraint& lc)
+        // Linearize again the functions whose spline moved since their
+        // last linearization.
+        // eturn the indices of these functions.
+        std::vector<std::size_t> linearize (const Splines_t& splines, const SplineOptimizationDatas_t& ss, LinearConstraint& lc)
         {
-          for (std::size_t i = 0; i < functions.size(); ++i)
-            linearize(splines[splineIds[i]], ss[i], i, lc);
+          std::vector<std::size_t> moved;
+          for (std::size_t i = 0; i < functions.size(); ++i) {
+            const SplinePtr_t& spline = splines[splineIds[i]];
+            if (parameters[i].size() == spline->rowParameters().size() &&
+                parameters[i] == spline->rowParameters())
+              continue;
+            linearize(spline, ss[splineIds[i]], i, lc);
+            moved.push_back(i);
+          }
+          return moved;
+        }
+
+        // Reduce the row of a function into the solutions of constraint.
+        // The row is zero outside of the coefficients of its spline: only
+        // the corresponding rows of PK are read.
+        void reduce (const LinearConstraint& constraint, const LinearConstraint& lc,
+            LinearConstraint& lcr, const std::size_t& fIdx) const
+        {
+          const size_type row = rows[fIdx],
+                          size = Spline::NbCoeffs * functions[fIdx]->inputDerivativeSize(),
+                          col = splineIds[fIdx] * size;
+          lcr.J.row(row).noalias() =
+            lc.J.block (row, col, 1, size) * constraint.PK.middleRows(col, size);
+          lcr.b.segment(row, 1).noalias() = lc.b.segment(row, 1)
+            - lc.J.block (row, col, 1, size) * constraint.xStar.segment(col, size);
         }
 
         std::vector<typename CollisionFunction <SplinePtr_t>::Ptr_t> functions;
         std::vector<std::size_t> splineIds;
         std::vector<size_type> rows;
         std::vector<value_type> ratios;
+        /// Parameters of the spline at the last linearization
+        std::vector<vector_t> parameters;
 
         mutable Configuration_t q;
         mutable matrix_t J, Js;
@@ -337,7 +368,9 @@ namespace hpp {
         typename CollisionFunction <SplinePtr_t>::Ptr_t function
           (functions.functions[iF]);
 
-        solved = constraint.reduceConstraint(collision, collisionReduced);
+        // Only the rows of the new function need to be reduced.
+        const size_type row (functions.rows[iF]);
+        solved = constraint.reduceConstraint(collision, collisionReduced, row, true);
 
         size_type i = 5;
         while (not solved) {
@@ -355,7 +388,7 @@ namespace hpp {
           function->updateConstraint (q);
           functions.linearize(spline, sod, iF, collision);
           // check the rank
-          solved = constraint.reduceConstraint(collision, collisionReduced, true);
+          solved = constraint.reduceConstraint(collision, collisionReduced, row, true);
           --i;
         }
         return true;
@@ -376,6 +409,7 @@ namespace hpp {
         bool checkJointBound = problem().getParameter ("SplineGradientBased/checkJointBound").boolValue();
         bool returnOptimum = problem().getParameter ("SplineGradientBased/returnOptimum").boolValue();
         value_type costThreshold = problem().getParameter ("SplineGradientBased/costThreshold").floatValue();
+        bool sparseQP = problem().getParameter ("SplineGradientBased/sparseQP").boolValue();
 
         if (path->length() == 0) return path;
         PathVectorPtr_t input = Base::cleanInput (path);
@@ -446,14 +480,18 @@ namespace hpp {
         Base::copy(splines, alphaSplines); Base::copy(splines, collSplines);
         Reports_t reports;
 
-        QuadraticProgram QP(cost.inputDerivativeSize_);
+        QuadraticProgram QP(cost.inputDerivativeSize_, sparseQP);
         value_type optimalCost, costLowerBound = 0;
         cost.value(optimalCost, splines);
         hppDout (info, "Initial cost is " << optimalCost);
-        cost.hessian(QP.H, splines);
+        if (sparseQP)
+          cost.hessian(QP.Hs, splines);
+        else {
+          cost.hessian(QP.H, splines);
 #ifndef NDEBUG
-        checkHessian(cost, QP.H, splines);
+          checkHessian(cost, QP.H, splines);
 #endif // NDEBUG
+        }
 
         QuadraticProgram QPc (QP, constraint);
         if (QPc.H.rows() == 0)
@@ -496,10 +534,20 @@ namespace hpp {
             for (std::size_t i = 0; i < splines.size(); ++i)
               splines[i]->rowParameters((*currentSplines)[i]->rowParameters());
             if (linearizeAtEachStep) {
-              collisionFunctions.linearize (splines, solvers, collision);
-              constraint.reduceConstraint(collision, collisionReduced);
-              QPc.solve(collisionReduced, boundConstraintReduced);
-              hppDout (info, "linearized");
+              // Constraints on splines that did not move are kept.
+              std::vector<std::size_t> moved
+                (collisionFunctions.linearize (splines, solvers, collision));
+              if (!moved.empty()) {
+                if (collisionReduced.J.rows() == collision.J.rows()) {
+                  for (std::size_t i = 0; i < moved.size(); ++i)
+                    collisionFunctions.reduce (constraint, collision,
+                                               collisionReduced, moved[i]);
+                  collisionReduced.computeRank();
+                } else
+                  constraint.reduceConstraint(collision, collisionReduced);
+                QPc.solve(collisionReduced, boundConstraintReduced);
+              }
+              hppDout (info, "linearized " << moved.size() << " constraints");
               computeOptimum = true;
             }
             hppDout (info, "Improved path with alpha = " << alpha);
@@ -515,7 +563,7 @@ namespace hpp {
             if (alpha != 1.) {
               if (QPc.H.rows() <= collisionReduced.rank) {
                 hppDout (info, "No more constraints can be added."
-                    << QP.H.rows() << " variables for "
+                    << QP.b.rows() << " variables for "
                     << collisionReduced.rank << " independant constraints.");
                 break;
               }
@@ -626,7 +674,8 @@ namespace hpp {
             Parameter(false)));
       Problem::declareParameter(ParameterDescription (Parameter::BOOL,
             "SplineGradientBased/linearizeAtEachStep",
-            "If true, collision constraint will be re-linearized at each iteration.",
+            "If true, collision constraint will be re-linearized at each iteration. "
+            "Only the constraints on splines that moved are linearized again.",
             Parameter(false)));
       Problem::declareParameter(ParameterDescription (Parameter::BOOL,
             "SplineGradientBased/checkJointBound",
@@ -646,6 +695,11 @@ namespace hpp {
             "contains rows of zeros, in which case the "
             "corresponding DoF is considered passive.",
             Parameter(-1.)));
+      Problem::declareParameter(ParameterDescription (Parameter::BOOL,
+            "SplineGradientBased/sparseQP",
+            "If true, the Hessian of the cost is stored as a sparse matrix. "
+            "Reduces memory and time for long paths on robots with many DoF.",
+            Parameter(false)));
       HPP_END_PARAMETER_DECLARATION(SplineGradientBased)
     } // namespace pathOptimization
   }  // namespace core
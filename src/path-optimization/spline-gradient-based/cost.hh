@@ -17,6 +17,9 @@
 #ifndef HPP_CORE_PATH_OPTIMIZATION_SPLINE_GRADIENT_BASED_COST_HH
 #define HPP_CORE_PATH_OPTIMIZATION_SPLINE_GRADIENT_BASED_COST_HH
 
+#include <vector>
+#include <Eigen/SparseCore>
+
 #include <hpp/util/debug.hh>
 
 #include <hpp/core/path/spline.hh>
@@ -116,6 +119,28 @@ namespace hpp {
           }
         }
 
+        /// Same as above, storing only the diagonal of each block.
+        void hessian (Eigen::SparseMatrix<value_type>& H, const Splines_t& splines) const
+        {
+          typedef Eigen::Triplet<value_type> Triplet_t;
+          typename Spline::BasisFunctionIntegralMatrix_t Ic;
+          std::vector<Triplet_t> triplets;
+          triplets.reserve (nSplines_ * Spline::NbCoeffs * Spline::NbCoeffs * paramSize_);
+
+          for (std::size_t k = 0; k < nSplines_; ++k) {
+            splines[k]->squaredNormBasisFunctionIntegral (DerivativeOrder, Ic);
+            Ic *= 2;
+            const size_type shift = k * Spline::NbCoeffs * paramSize_;
+            for (size_type i = 0; i < Spline::NbCoeffs; ++i)
+              for (size_type j = 0; j < Spline::NbCoeffs; ++j)
+                for (size_type d = 0; d < paramSize_; ++d)
+                  triplets.push_back (Triplet_t (shift + i * paramSize_ + d,
+                        shift + j * paramSize_ + d, Ic(i,j) * lambda_[k]));
+          }
+          H.resize (inputDerivativeSize_, inputDerivativeSize_);
+          H.setFromTriplets (triplets.begin(), triplets.end());
+        }
+
         vector_t lambda_;
         const std::size_t nSplines_;
         const size_type paramSize_, paramDerivativeSize_;
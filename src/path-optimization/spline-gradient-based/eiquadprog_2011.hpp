@@ -142,6 +142,13 @@ namespace Eigen {
                            const MatrixXd & CI, const VectorXd & ci0,
                            VectorXd& x, VectorXi& A, int& q, QuadProgStatus& status);
 
+    /* same as above when J0 = L^-T and its trace c2 are precomputed as well */
+    double solve_quadprog2(const LLT<MatrixXd,Lower> &chol,  double c1,
+                           const MatrixXd & J0, double c2, const VectorXd & g0,
+                           const MatrixXd & CE, const VectorXd & ce0,
+                           const MatrixXd & CI, const VectorXd & ci0,
+                           VectorXd& x, VectorXi& A, int& q, QuadProgStatus& status);
+
     /* solve_quadprog is used for on-demand QP solving */
     inline double solve_quadprog(MatrixXd & G,  VectorXd & g0,
                                  const MatrixXd & CE, const VectorXd & ce0,
@@ -171,18 +178,38 @@ namespace Eigen {
                                   const MatrixXd & CI, const VectorXd & ci0,
                                   VectorXd& x, VectorXi& A, int& q,
                                   QuadProgStatus& status)
+    {
+        /* compute the inverse of the factorized matrix G^-1, this is the initial value for H */
+        // J = L^-T
+        MatrixXd J(g0.size(),g0.size());
+        J.setIdentity();
+        J = chol.matrixU().solve(J);
+        return solve_quadprog2(chol, c1, J, J.trace(), g0, CE, ce0, CI, ci0,
+                               x, A, q, status);
+    }
+
+    /* solve_quadprog2 is used when the inverse J0 = L^-T of the Cholesky factor
+     * is precomputed, so that solving the same program with other constraints
+     * does not invert the factor again.
+     */
+    inline double solve_quadprog2(const LLT<MatrixXd,Lower> &chol,  double c1,
+                                  const MatrixXd & J0, double c2, const VectorXd & g0,
+                                  const MatrixXd & CE, const VectorXd & ce0,
+                                  const MatrixXd & CI, const VectorXd & ci0,
+                                  VectorXd& x, VectorXi& A, int& q,
+                                  QuadProgStatus& status)
     {
         int i, j, k, l; /* indices */
         MatrixXd::Index ip, me, mi;
         VectorXd::Index n=g0.size();
         MatrixXd::Index p=CE.cols();
         MatrixXd::Index m=CI.cols();
-        MatrixXd R(g0.size(),g0.size()), J(g0.size(),g0.size());
+        MatrixXd R(g0.size(),g0.size()), J(J0);
 
 
         VectorXd s(m+p), z(n), r(m + p), d(n),  np(n), u(m + p);
         VectorXd x_old(n), u_old(m + p);
-        double f_value, psi, c2, sum, ss, R_norm;
+        double f_value, psi, sum, ss, R_norm;
         const double inf = std::numeric_limits<double>::infinity();
         double t, t1, t2; /* t is the step length, which is the minimum of the partial step length t1
                            * and the full step length t2 */
@@ -208,11 +235,6 @@ namespace Eigen {
         R.setZero();
         R_norm = 1.0; /* this variable will hold the norm of the matrix R */
 
-        /* compute the inverse of the factorized matrix G^-1, this is the initial value for H */
-        // J = L^-T
-        J.setIdentity();
-        J = chol.matrixU().solve(J);
-        c2 = J.trace();
 #ifdef TRACE_SOLVER
         print_matrix("J", J, n);
 #endif
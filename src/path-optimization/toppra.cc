@@ -0,0 +1,262 @@
+// Copyright (c) 2018, Joseph Mirabel
+// Authors: Joseph Mirabel (joseph.mirabel@laas.fr)
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/path-optimization/toppra.hh>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <pinocchio/multibody/model.hpp>
+
+#include <hpp/util/debug.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/time-parameterization/piecewise-polynomial.hh>
+#include <hpp/core/time-parameterization/polynomial.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathOptimization {
+      using timeParameterization::PiecewisePolynomial;
+      using timeParameterization::Polynomial;
+
+      namespace {
+        // Affine bound alpha * x + beta of u
+        struct Bound
+        {
+          Bound (const value_type& a, const value_type& b) : alpha (a), beta (b) {}
+          value_type operator() (const value_type& x) const
+          {
+            return alpha * x + beta;
+          }
+          value_type alpha, beta;
+        };
+        typedef std::vector<Bound> Bounds_t;
+
+        // Constraints at a point of the grid
+        struct GridPoint
+        {
+          // Bound of x from the velocity limits
+          value_type xMax;
+          // Bounds of u from the acceleration limits
+          Bounds_t upper, lower;
+        };
+
+        // Compute the constraints on (x, u) at a point where the path
+        // derivatives are dq and ddq.
+        void computeConstraints (const vector_t& dq, const vector_t& ddq,
+            const vector_t& lb, const vector_t& ub, const value_type& maxAcc,
+            GridPoint& point)
+        {
+          const value_type infinity = std::numeric_limits<value_type>::infinity();
+          value_type sdMax = infinity;
+          point.xMax = infinity;
+          point.upper.clear();
+          point.lower.clear();
+          for (size_type j = 0; j < ub.size(); ++j) {
+            if (dq[j] > 0) sdMax = std::min (sdMax, ub[j] / dq[j]);
+            else if (dq[j] < 0) sdMax = std::min (sdMax, lb[j] / dq[j]);
+            if (maxAcc <= 0) continue;
+            // -maxAcc <= dq u + ddq x <= maxAcc
+            if (dq[j] > 0) {
+              point.upper.push_back (Bound (- ddq[j] / dq[j],  maxAcc / dq[j]));
+              point.lower.push_back (Bound (- ddq[j] / dq[j], -maxAcc / dq[j]));
+            } else if (dq[j] < 0) {
+              point.upper.push_back (Bound (- ddq[j] / dq[j], -maxAcc / dq[j]));
+              point.lower.push_back (Bound (- ddq[j] / dq[j],  maxAcc / dq[j]));
+            } else if (ddq[j] != 0) {
+              point.xMax = std::min (point.xMax, maxAcc / std::fabs (ddq[j]));
+            }
+          }
+          point.xMax = std::min (point.xMax, sdMax * sdMax);
+        }
+
+        // Upper bound of the set of x for which a u satisfies
+        // lower(x) <= u <= upper(x), bounded by xMax. The set always contains
+        // 0 since x = u = 0 satisfies the constraints.
+        value_type projectOnX (const Bounds_t& upper, const Bounds_t& lower,
+            value_type xMax)
+        {
+          for (std::size_t i = 0; i < upper.size(); ++i) {
+            for (std::size_t j = 0; j < lower.size(); ++j) {
+              // lower[j](x) <= upper[i](x)
+              const value_type a = lower[j].alpha - upper[i].alpha,
+                               b = upper[i].beta  - lower[j].beta;
+              if (a > 0) xMax = std::min (xMax, b / a);
+            }
+          }
+          return std::max (xMax, value_type(0));
+        }
+
+        TimeParameterizationPtr_t computeTimeParameterization (
+            const PathPtr_t& path, const vector_t& lb, const vector_t& ub,
+            const value_type& maxAcc, const size_type N, value_type& T)
+        {
+          const interval_t& sr (path->paramRange());
+          const value_type delta = (sr.second - sr.first) / value_type(N);
+          vector_t dq (path->outputDerivativeSize()),
+                   ddq (path->outputDerivativeSize());
+
+          std::vector<GridPoint> points (N + 1);
+          for (size_type i = 0; i <= N; ++i) {
+            const value_type s = (i == N ? sr.second : sr.first + value_type(i) * delta);
+            path->derivative (dq , s, 1);
+            path->derivative (ddq, s, 2);
+            computeConstraints (dq, ddq, lb, ub, maxAcc, points[i]);
+          }
+
+          // Backward pass: K[i] is the upper bound of the controllable set
+          // at s_i. x_N = 0 so that the path ends at rest.
+          vector_t K (N + 1);
+          K[N] = 0;
+          Bounds_t upper, lower;
+          for (size_type i = N - 1; i >= 0; --i) {
+            upper = points[i].upper;
+            lower = points[i].lower;
+            // 0 <= x + 2 delta u <= K[i+1]
+            upper.push_back (Bound (- 1 / (2 * delta), K[i+1] / (2 * delta)));
+            lower.push_back (Bound (- 1 / (2 * delta), 0));
+            K[i] = projectOnX (upper, lower, points[i].xMax);
+          }
+
+          // Forward pass: x_0 = 0 so that the path starts at rest.
+          vector_t x (N + 1);
+          x[0] = 0;
+          for (size_type i = 0; i < N; ++i) {
+            value_type u ((K[i+1] - x[i]) / (2 * delta));
+            for (std::size_t j = 0; j < points[i].upper.size(); ++j)
+              u = std::min (u, points[i].upper[j] (x[i]));
+            x[i+1] = std::min (K[i+1], std::max (value_type(0), x[i] + 2 * delta * u));
+          }
+          if (!x.allFinite()) {
+            HPP_THROW(std::runtime_error, "The velocity of the path is not "
+                "bounded. Check the velocity limits of the robot.");
+          }
+
+          // s(t) = s_i + sd_i (t - t_i) + 1/2 u_i (t - t_i)^2 on [t_i, t_{i+1}]
+          matrix_t a (3, N);
+          vector_t t (N + 1);
+          t[0] = 0;
+          for (size_type i = 0; i < N; ++i) {
+            const value_type sd0 = std::sqrt (x[i]), sd1 = std::sqrt (x[i+1]);
+            if (sd0 + sd1 <= 0) {
+              HPP_THROW(std::runtime_error, "Path cannot be time parameterized: "
+                  "velocity is zero on interval " << i << " of " << N << ".");
+            }
+            a(0, i) = sr.first + value_type(i) * delta;
+            a(1, i) = sd0;
+            a(2, i) = (x[i+1] - x[i]) / (4 * delta);
+            t[i+1] = t[i] + 2 * delta / (sd0 + sd1);
+          }
+          T = t[N];
+          hppDout (info, "Time parameterization duration " << T);
+          return TimeParameterizationPtr_t (new PiecewisePolynomial (a, t));
+        }
+      }
+
+      TOPPRAPtr_t TOPPRA::create (const Problem& problem)
+      {
+        TOPPRAPtr_t ptr (new TOPPRA(problem));
+        return ptr;
+      }
+
+      PathVectorPtr_t TOPPRA::optimize (const PathVectorPtr_t& path)
+      {
+        if (path->length() == 0) {
+          return path;
+        }
+        const value_type infinity = std::numeric_limits<value_type>::infinity();
+
+        const value_type safety = problem().getParameter("TOPPRA/safety").floatValue();
+        const value_type maxAcc = problem().getParameter("TOPPRA/maxAcceleration").floatValue();
+        const size_type N = problem().getParameter("TOPPRA/numberOfSamples").intValue();
+        if (N < 1)
+          throw std::invalid_argument ("Parameter TOPPRA/numberOfSamples should be positive.");
+
+        // Retrieve velocity limits
+        const DevicePtr_t& robot = problem().robot();
+        vector_t ub ( robot->model().velocityLimit),
+                 lb (-robot->model().velocityLimit),
+                 cb ((ub + lb) / 2);
+        assert (cb.size() + robot->extraConfigSpace().dimension()
+            == robot->numberDof());
+
+        // The velocity must be in [lb, ub]
+        ub = cb + safety * (ub - cb);
+        lb = cb + safety * (lb - cb);
+
+        // When ub or lb are NaN, set them to infinity.
+        ub = (ub.array() == ub.array()).select(ub,  infinity);
+        lb = (lb.array() == lb.array()).select(lb, -infinity);
+
+        hppDout (info, "Lower velocity bound :" << lb.transpose());
+        hppDout (info, "Upper velocity bound :" << ub.transpose());
+
+        if (   ( ub.array() <= 0 ).any()
+            || ( lb.array() >= 0 ).any())
+          throw std::invalid_argument ("The case where zero is not an admissible velocity is not implemented.");
+
+        PathVectorPtr_t input = PathVector::create(
+            path->outputSize(), path->outputDerivativeSize());
+        PathVectorPtr_t output = PathVector::create(
+            path->outputSize(), path->outputDerivativeSize());
+        path->flatten(input);
+
+        for (std::size_t i = 0; i < input->numberPaths(); ++i) {
+          PathPtr_t pp = input->pathAtRank(i)->copy();
+          interval_t paramRange = input->pathAtRank(i)->paramRange();
+          pp->timeParameterization (TimeParameterizationPtr_t(), paramRange);
+
+          value_type T = 0;
+          TimeParameterizationPtr_t tp;
+          if (paramRange.second > paramRange.first) {
+            tp = computeTimeParameterization (pp, lb, ub, maxAcc, N, T);
+          } else {
+            vector_t a (vector_t::Zero(2));
+            a[0] = paramRange.first;
+            tp = TimeParameterizationPtr_t (new Polynomial (a));
+          }
+          pp->timeParameterization (tp, interval_t (0, T));
+
+          output->appendPath (pp);
+        }
+        return output;
+      }
+
+      TOPPRA::TOPPRA (const Problem& problem):
+        PathOptimizer(problem) {}
+
+      // ----------- Declare parameters ------------------------------------- //
+
+      HPP_START_PARAMETER_DECLARATION(TOPPRA)
+      Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+            "TOPPRA/safety",
+            "A scaling factor for the joint bounds.",
+            Parameter(1.)));
+      Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+            "TOPPRA/maxAcceleration",
+            "The maximum acceleration for each degree of freedom. Not considered if negative.",
+            Parameter((value_type)-1)));
+      Problem::declareParameter(ParameterDescription (Parameter::INT,
+            "TOPPRA/numberOfSamples",
+            "The number of intervals of the grid of each path element.",
+            Parameter((size_type)100)));
+      HPP_END_PARAMETER_DECLARATION(TOPPRA)
+    } // namespace pathOptimization
+  } // namespace core
+} // namespace hpp
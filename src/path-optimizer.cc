@@ -16,12 +16,12 @@
 
 #include <hpp/core/path-optimizer.hh>
 
+#include <ostream>
+
 #include <hpp/core/problem.hh>
 #include <hpp/core/path-projector.hh>
 #include <hpp/core/steering-method.hh>
 
-namespace bpt = boost::posix_time;
-
 namespace hpp {
   namespace core {
     PathOptimizer::PathOptimizer (const Problem& problem) :
@@ -30,17 +30,35 @@ namespace hpp {
       timeOut_ (std::numeric_limits <double>::infinity ())
     {
       monitor_.enabled = false;
+      monitor_.timeStart = Deadline::Clock_t::now ();
 
       initFromParameters();
     }
 
+    void PathOptimizer::Statistics::reset ()
+    {
+      stages.reset ();
+      iterations = 0;
+      accepted = 0;
+      rejected = 0;
+      lengths.clear ();
+      totalTime = 0;
+    }
+
     PathPtr_t PathOptimizer::steer (ConfigurationIn_t q1,
         ConfigurationIn_t q2) const
     {
-      PathPtr_t dp = (*problem().steeringMethod())(q1,q2);
+      PathPtr_t dp;
+      {
+        PlannerStatistics::ScopedTimer timer (statistics_.stages,
+                                              PlannerStatistics::STEERING);
+        dp = (*problem().steeringMethod())(q1,q2);
+      }
       if (dp) {
         if (!problem().pathProjector()) return dp;
         PathPtr_t pp;
+        PlannerStatistics::ScopedTimer timer (statistics_.stages,
+                                              PlannerStatistics::PROJECTION);
         if (problem().pathProjector()->apply (dp, pp))
           return pp;
       }
@@ -52,20 +70,57 @@ namespace hpp {
       interrupt_ = false;
       monitor_.enabled = true;
       monitor_.iteration = 0;
-      monitor_.timeStart = bpt::microsec_clock::universal_time();
+      monitor_.timeStart = Deadline::Clock_t::now ();
+      statistics_.reset ();
+    }
+
+    void PathOptimizer::recordCandidate (bool accepted) const
+    {
+      if (accepted) ++statistics_.accepted;
+      else ++statistics_.rejected;
+      statistics_.totalTime = elapsed ();
+    }
+
+    void PathOptimizer::recordLength (value_type length) const
+    {
+      statistics_.totalTime = elapsed ();
+      statistics_.lengths.push_back (std::make_pair (statistics_.totalTime,
+                                                     length));
+    }
+
+    value_type PathOptimizer::elapsed () const
+    {
+      return boost::chrono::duration <value_type>
+        (Deadline::Clock_t::now () - monitor_.timeStart).count ();
     }
 
     bool PathOptimizer::shouldStop() const
     {
       if (interrupt_) return true;
+      if (problem_.deadline ()->expired ()) return true;
       if (!monitor_.enabled) return false;
       if (monitor_.iteration >= maxIterations_) return true;
+      return elapsed () > timeOut_;
+    }
 
-      bpt::ptime timeStop(bpt::microsec_clock::universal_time());
-      if(static_cast<value_type>((timeStop - monitor_.timeStart)
-            .total_milliseconds()) > timeOut_*1e3)
-        return true;
-      return false;
+    std::ostream& operator<< (std::ostream& os,
+                              const PathOptimizer::Statistics& s)
+    {
+      os << "iterations: " << s.iterations << ", accepted: " << s.accepted
+         << ", rejected: " << s.rejected << ", total time: " << s.totalTime
+         << " s";
+      if (!s.lengths.empty ())
+        os << ", length: " << s.lengths.front ().second << " -> "
+           << s.lengths.back ().second;
+      const PlannerStatistics::Stage stages [] = {
+        PlannerStatistics::STEERING, PlannerStatistics::PROJECTION,
+        PlannerStatistics::VALIDATION };
+      for (std::size_t i = 0; i < 3; ++i) {
+        os << std::endl << "  " << PlannerStatistics::name (stages [i])
+           << ": " << s.stages.time (stages [i]) << " s in "
+           << s.stages.count (stages [i]) << " calls";
+      }
+      return os;
     }
 
     void PathOptimizer::initFromParameters ()
@@ -16,9 +16,17 @@
 // hpp-core  If not, see
 // <http://www.gnu.org/licenses/>.
 
-#include <boost/tuple/tuple.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <boost/bind.hpp>
 
 #include <hpp/core/path-planner.hh>
+#include <hpp/core/deadline.hh>
+#include <hpp/core/distance.hh>
+#include <hpp/core/executor.hh>
 #include <hpp/core/nearest-neighbor.hh>
 #include <hpp/util/debug.hh>
 
@@ -30,7 +38,10 @@
 #include <hpp/core/path.hh>
 #include <hpp/core/path-validation.hh>
 #include <hpp/core/path-projector.hh>
+#include <hpp/core/path-validation-report.hh>
 #include <hpp/core/steering-method.hh>
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/trace.hh>
 #include "astar.hh"
 #include <hpp/util/timer.hh>
 
@@ -45,7 +56,8 @@ namespace hpp {
       interrupt_ (false),
       maxIterations_ (uint_infty),
       timeOut_ (float_infty),
-      stopWhenProblemIsSolved_ (true)
+      stopWhenProblemIsSolved_ (true),
+      maxRoadmapNodes_ (-1), numberThreads_ (1)
     {
     }
 
@@ -55,7 +67,8 @@ namespace hpp {
       interrupt_ (false),
       maxIterations_ (uint_infty),
       timeOut_ (float_infty),
-      stopWhenProblemIsSolved_ (true)
+      stopWhenProblemIsSolved_ (true),
+      maxRoadmapNodes_ (-1), numberThreads_ (1)
     {
     }
 
@@ -85,18 +98,39 @@ namespace hpp {
           itGoal != goals.end (); ++itGoal) {
         roadmap()->addGoalNode (*itGoal);
       }
+      problem_.target()->addGoalNodes (roadmap(), false);
 
       problem_.target()->check(roadmap());
+      // Planners that accept approximate nearest neighbors set the factor
+      // after this call.
+      roadmap()->nearestNeighbor()->approximationFactor (1);
+      maxRoadmapNodes_ = problem_.getParameter
+        ("PathPlanner/maxRoadmapNodes").intValue ();
     }
 
-    PathVectorPtr_t PathPlanner::solve ()
+    void PathPlanner::pruneRoadmap ()
     {
-      namespace bpt = boost::posix_time;
+      if (maxRoadmapNodes_ < 0 ||
+          (size_type) roadmap ()->nodes ().size () <= maxRoadmapNodes_)
+        return;
+      roadmap ()->prune ((9 * maxRoadmapNodes_) / 10);
+    }
 
+    PathVectorPtr_t PathPlanner::solve ()
+    {
+      HPP_CORE_TRACE_SPAN ("PathPlanner::solve");
+      HPP_CORE_ALLOCATION_SCOPE (PLANNER);
       interrupt_ = false;
       bool solved = false;
       unsigned long int nIter (0);
-      bpt::ptime timeStart(bpt::microsec_clock::universal_time());
+      // Time is measured with a monotonic clock. Path validation and path
+      // projection stop when the deadline expires, so that a step does not
+      // overshoot the time out by much.
+      const DeadlinePtr_t& deadline (problem_.deadline ());
+      Deadline::Scope scope (deadline, timeOut_);
+      statistics_.reset ();
+      const AllocationProfile::Snapshot allocations
+        (AllocationProfile::snapshot ());
       startSolve ();
       tryConnectInitAndGoals ();
       // We choose to stop if a direct path solves the problem.
@@ -109,6 +143,7 @@ namespace hpp {
 	hppDout (info, "tryConnectInitAndGoals succeeded");
       }
       if (interrupt_) throw std::runtime_error ("Interruption");
+      bool reached (solved);
       while (!solved) {
         // Check limits
         std::ostringstream oss;
@@ -118,9 +153,7 @@ namespace hpp {
           oss << "Maximal number of iterations reached: " << maxIterations_;
           throw std::runtime_error (oss.str ().c_str ());
         }
-        bpt::ptime timeStop(bpt::microsec_clock::universal_time());
-        if(static_cast<value_type>((timeStop - timeStart).total_milliseconds())
-            > timeOut_*1000){
+        if (deadline->expired () && !interrupt_) {
           if (!stopWhenProblemIsSolved_
               && problem_.target()->reached (roadmap())) break;
           oss << "time out reached : " << timeOut_<<" s";
@@ -129,22 +162,64 @@ namespace hpp {
 
         // Execute one step
         hppStartBenchmark(ONE_STEP);
-        oneStep ();
+        {
+          HPP_CORE_TRACE_SPAN ("PathPlanner::oneStep");
+          oneStep ();
+        }
         hppStopBenchmark(ONE_STEP);
         hppDisplayBenchmark(ONE_STEP);
+        problem_.target()->addGoalNodes (roadmap(), true);
+        if (Trace::enabled ()) {
+          Trace::counter ("Roadmap nodes",
+                          (double) roadmap()->nodes().size());
+          Trace::counter ("Roadmap connected components",
+                          (double) roadmap()->connectedComponents().size());
+        }
 
         // Check if problem is solved.
         ++nIter;
-        solved = stopWhenProblemIsSolved_ && problem_.target()->reached (roadmap());
+        statistics_.iterations = nIter;
+        statistics_.totalTime = deadline->elapsed ();
+        if (AllocationProfile::enabled ())
+          statistics_.allocationsSince (allocations);
+        if (stopWhenProblemIsSolved_ || progressCallback_ ||
+            (!reached && solutionCallback_)) {
+          const bool wasReached (reached);
+          reached = problem_.target()->reached (roadmap());
+          solved = stopWhenProblemIsSolved_ && reached;
+          if (reached && !wasReached && !solved && solutionCallback_)
+            publishSolution (computePath ());
+        }
+        if (progressCallback_) {
+          Progress progress;
+          progress.iteration = nIter;
+          progress.time = statistics_.totalTime;
+          progress.numberNodes = (size_type) roadmap()->nodes().size();
+          progress.numberConnectedComponents =
+            (size_type) roadmap()->connectedComponents().size();
+          progress.solved = reached;
+          progressCallback_ (progress);
+        }
         if (interrupt_) throw std::runtime_error ("Interruption");
       }
       PathVectorPtr_t planned =  computePath ();
+      if (Trace::enabled ())
+        Trace::counter ("Roadmap bytes",
+                        (double) roadmap()->statistics ().bytes ());
+      if (AllocationProfile::enabled ())
+        statistics_.allocationsSince (allocations);
       return finishSolve (planned);
     }
 
     void PathPlanner::interrupt ()
     {
       interrupt_ = true;
+      problem_.deadline ()->cancel ();
+    }
+
+    void PathPlanner::publishSolution (const PathVectorPtr_t& path)
+    {
+      if (solutionCallback_) solutionCallback_ (path);
     }
 
     void PathPlanner::maxIterations (const unsigned long int& n)
@@ -189,8 +264,12 @@ namespace hpp {
       PathProjectorPtr_t pathProjector (problem ().pathProjector ());
       PathPtr_t validPath, projPath, path;
       NodePtr_t initNode = roadmap ()->initNode();
-      for (NodeVector_t::const_iterator itn = roadmap ()->goalNodes ().begin();
-	   itn != roadmap ()->goalNodes ().end (); ++itn) {
+      NodeVector_t goals (roadmap ()->goalNodes ());
+      const bool lazy (problem ().getParameter
+                       ("PathPlanner/lazyGoalConnection").boolValue ());
+      if (lazy) sortByDistance (initNode, goals);
+      for (NodeVector_t::const_iterator itn = goals.begin();
+	   itn != goals.end (); ++itn) {
 	ConfigurationPtr_t q1 ((initNode)->configuration ());
 	ConfigurationPtr_t q2 ((*itn)->configuration ());
 	path = (*sm) (*q1, *q2);
@@ -206,91 +285,212 @@ namespace hpp {
 						     report);
           if (pathValid && validPath->length() > 0) {
             roadmap ()->addEdge (initNode, *itn, projPath);
-            roadmap ()->addEdge (*itn, initNode, projPath->reverse());
+            roadmap ()->addEdge (*itn, initNode, projPath->reversedView ());
+            if (lazy && stopWhenProblemIsSolved_) return;
           }
         }
       }
     }
 
-    void PathPlanner::tryConnectInitAndGoals ()
-    {
-      // call steering method here to build a direct conexion
-      const SteeringMethodPtr_t& sm (problem ().steeringMethod ());
-      PathValidationPtr_t pathValidation (problem ().pathValidation ());
-      PathProjectorPtr_t pathProjector (problem ().pathProjector ());
-      PathPtr_t validPath, projPath, path;
-      NodePtr_t initNode = roadmap ()->initNode();
-      NearestNeighborPtr_t nn (roadmap ()->nearestNeighbor ());
-      // Register edges to add to roadmap and add them after iterating
-      // among the connected components.
-      typedef boost::tuple <NodePtr_t, NodePtr_t, PathPtr_t> FutureEdge_t;
-      typedef std::vector <FutureEdge_t> FutureEdges_t;
-      FutureEdges_t futureEdges;
-      ConnectedComponentPtr_t initCC (initNode->connectedComponent ());
-      for (ConnectedComponents_t::iterator itCC
-             (roadmap ()->connectedComponents ().begin ());
-           itCC != roadmap ()->connectedComponents ().end (); ++itCC) {
-        if (*itCC != initCC) {
-          value_type d;
-          NodePtr_t near (nn->search (*initNode->configuration (),
-                                      *itCC, d, true));
-          assert (near);
-          ConfigurationPtr_t q1 (initNode->configuration ());
-          ConfigurationPtr_t q2 (near->configuration ());
-          path = (*sm) (*q1, *q2);
+    namespace {
+      typedef std::pair <NodePtr_t, NodePtr_t> Connection_t;
+      typedef std::vector <Connection_t> Connections_t;
+
+      /// Compare the indices of connections by distance
+      struct CloserThan
+      {
+        CloserThan (const std::vector <value_type>& distances) :
+          distances_ (distances)
+        {
+        }
+        bool operator() (std::size_t i, std::size_t j) const
+        {
+          return distances_ [i] < distances_ [j];
+        }
+        const std::vector <value_type>& distances_;
+      }; // struct CloserThan
+
+      /// Steer, project and validate connections begin, begin + step, ...
+      /// \retval paths valid projected path of each connection, or null.
+      void connect (const PathPlanner::ConnectionTools& tools,
+                    const Connections_t& connections,
+                    std::vector <PathPtr_t>& paths,
+                    std::size_t begin, std::size_t step)
+      {
+        for (std::size_t i = begin; i < connections.size (); i += step) {
+          PathPtr_t validPath, projPath;
+          PathPtr_t path ((*tools.steeringMethod)
+                          (*connections [i].first->configuration (),
+                           *connections [i].second->configuration ()));
           if (!path) continue;
-          if (pathProjector) {
-            if (!pathProjector->apply (path, projPath)) continue;
+          if (tools.pathProjector) {
+            if (!tools.pathProjector->apply (path, projPath)) continue;
           } else {
             projPath = path;
           }
           if (projPath) {
             PathValidationReportPtr_t report;
-            bool pathValid = pathValidation->validate (projPath, false,
-                                                       validPath, report);
+            bool pathValid = tools.pathValidation->validate
+              (projPath, false, validPath, report);
             if (pathValid && validPath->length() > 0) {
-              futureEdges.push_back (FutureEdge_t (initNode, near, projPath));
+              paths [i] = projPath;
             }
           }
         }
       }
+    } // namespace
+
+    void PathPlanner::parallelConnections
+    (size_type numberThreads, const ConnectionToolsFactory_t& factory)
+    {
+      if (numberThreads < 1 || (numberThreads > 1 && !factory))
+        throw std::invalid_argument ("Parallel connections require a "
+                                     "positive number of threads and a "
+                                     "factory.");
+      numberThreads_ = numberThreads;
+      connectionToolsFactory_ = factory;
+    }
+
+    void PathPlanner::tryConnectInitAndGoals ()
+    {
+      NodePtr_t initNode = roadmap ()->initNode();
+      NearestNeighborPtr_t nn (roadmap ()->nearestNeighbor ());
+      // Register the connections to try while iterating among the
+      // connected components and add edges after validation.
+      Connections_t connections;
+      // Distance of each connection
+      std::vector <value_type> priorities;
+      ConnectedComponentPtr_t initCC (initNode->connectedComponent ());
+      vector_t distances;
+      NodeVector_t nearNodes (nn->searchInConnectedComponents
+                              (*initNode->configuration (),
+                               roadmap ()->connectedComponents (), distances,
+                               true));
+      NodeVector_t::const_iterator itNear (nearNodes.begin ());
+      for (ConnectedComponents_t::iterator itCC
+             (roadmap ()->connectedComponents ().begin ());
+           itCC != roadmap ()->connectedComponents ().end ();
+           ++itCC, ++itNear) {
+        if (*itCC != initCC) {
+          assert (*itNear);
+          connections.push_back (Connection_t (initNode, *itNear));
+          priorities.push_back (distances [itNear - nearNodes.begin ()]);
+        }
+      }
       for (NodeVector_t::const_iterator itn = roadmap ()->goalNodes ().begin();
 	   itn != roadmap ()->goalNodes ().end (); ++itn) {
         ConnectedComponentPtr_t goalCC ((*itn)->connectedComponent ());
+        nearNodes = nn->searchInConnectedComponents
+          (*(*itn)->configuration (), roadmap ()->connectedComponents (),
+           distances, false);
+        itNear = nearNodes.begin ();
         for (ConnectedComponents_t::iterator itCC
                (roadmap ()->connectedComponents ().begin ());
-             itCC != roadmap ()->connectedComponents ().end (); ++itCC) {
+             itCC != roadmap ()->connectedComponents ().end ();
+             ++itCC, ++itNear) {
           if (*itCC != goalCC) {
-            value_type d;
-            NodePtr_t near (nn->search (*(*itn)->configuration (), *itCC, d,
-                                        false));
-            assert (near);
-            ConfigurationPtr_t q1 (near->configuration ());
-            ConfigurationPtr_t q2 ((*itn)->configuration ());
-            path = (*sm) (*q1, *q2);
-            if (!path) continue;
-            if (pathProjector) {
-              if (!pathProjector->apply (path, projPath)) continue;
-            } else {
-              projPath = path;
-            }
-            if (projPath) {
-              PathValidationReportPtr_t report;
-              bool pathValid = pathValidation->validate (projPath, false,
-                                                         validPath, report);
-              if (pathValid && validPath->length() > 0) {
-                futureEdges.push_back (FutureEdge_t (near, (*itn), projPath));
-              }
-            }
+            assert (*itNear);
+            connections.push_back (Connection_t (*itNear, *itn));
+            priorities.push_back (distances [itNear - nearNodes.begin ()]);
+          }
+        }
+      }
+
+      const std::size_t nThreads
+        (std::min ((std::size_t) numberThreads_, connections.size ()));
+      std::vector <ConnectionTools> tools (std::max (nThreads,
+                                                     (std::size_t) 1));
+      if (nThreads <= 1) {
+        tools [0].steeringMethod = problem ().steeringMethod ();
+        tools [0].pathProjector = problem ().pathProjector ();
+        tools [0].pathValidation = problem ().pathValidation ();
+      } else {
+        for (std::size_t t = 0; t < nThreads; ++t)
+          tools [t] = connectionToolsFactory_ ();
+      }
+      // Lazy connections are validated closest first, by batches of one
+      // connection per thread, until the problem is solved.
+      std::vector <std::size_t> order (connections.size ());
+      for (std::size_t i = 0; i < order.size (); ++i) order [i] = i;
+      const bool lazy (problem ().getParameter
+                       ("PathPlanner/lazyGoalConnection").boolValue ());
+      if (lazy)
+        std::stable_sort (order.begin (), order.end (),
+                          CloserThan (priorities));
+      const std::size_t batchSize (lazy ? tools.size () : order.size ());
+      for (std::size_t begin = 0; begin < order.size (); begin += batchSize) {
+        const std::size_t end (std::min (begin + batchSize, order.size ()));
+        Connections_t batch;
+        for (std::size_t k = begin; k < end; ++k)
+          batch.push_back (connections [order [k]]);
+        std::vector <PathPtr_t> paths (batch.size ());
+        const std::size_t n (std::min (tools.size (), batch.size ()));
+        if (n <= 1) {
+          connect (tools [0], batch, paths, 0, 1);
+        } else {
+          Executor::Tasks_t tasks;
+          for (std::size_t t = 0; t < n; ++t) {
+            tasks.push_back (boost::bind
+                             (&connect, boost::cref (tools [t]),
+                              boost::cref (batch), boost::ref (paths), t, n));
           }
+          Executor::run (executor_, tasks);
+        }
+        // Add edges
+        for (std::size_t i = 0; i < batch.size (); ++i) {
+          if (paths [i])
+            roadmap ()->addEdge (batch [i].first, batch [i].second,
+                                 paths [i]);
         }
+        if (lazy && stopWhenProblemIsSolved_ &&
+            problem_.target ()->reached (roadmap ()))
+          return;
       }
-      // Add edges
-      for (FutureEdges_t::const_iterator it (futureEdges.begin ());
-           it != futureEdges.end (); ++it) {
-        roadmap ()->addEdge (it->get <0> (), it->get <1> (), it->get <2> ());
+    }
+
+    void PathPlanner::sortByDistance (const NodePtr_t& node,
+                                      NodeVector_t& nodes) const
+    {
+      const Distance& distance (*problem ().distance ());
+      std::vector <value_type> distances (nodes.size ());
+      std::vector <std::size_t> order (nodes.size ());
+      for (std::size_t i = 0; i < nodes.size (); ++i) {
+        distances [i] = distance (*node->configuration (),
+                                  *nodes [i]->configuration ());
+        order [i] = i;
       }
+      std::stable_sort (order.begin (), order.end (), CloserThan (distances));
+      NodeVector_t sorted (nodes.size ());
+      for (std::size_t i = 0; i < nodes.size (); ++i)
+        sorted [i] = nodes [order [i]];
+      nodes.swap (sorted);
     }
 
+    // ----------- Declare parameters ------------------------------------- //
+
+    HPP_START_PARAMETER_DECLARATION(NearestNeighbor)
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "NearestNeighbor/approximationFactor",
+          "Approximation factor of nearest neighbor searches in RRT-like "
+          "planners. Returned nodes are at most this factor times farther "
+          "than the nearest nodes. 1 means exact search.",
+          Parameter(1.)));
+    HPP_END_PARAMETER_DECLARATION(NearestNeighbor)
+
+    HPP_START_PARAMETER_DECLARATION(PathPlanner)
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "PathPlanner/maxRoadmapNodes",
+          "Maximal number of nodes of the roadmap in RRT-like planners. "
+          "When it is exceeded, leaves farthest from the initial and goal "
+          "nodes are removed. Negative values disable pruning.",
+          Parameter((size_type)-1)));
+    Problem::declareParameter(ParameterDescription (Parameter::BOOL,
+          "PathPlanner/lazyGoalConnection",
+          "Whether to try the connections of the initial and goal nodes to "
+          "the roadmap closest first, stopping as soon as the problem is "
+          "solved if the planner stops when the problem is solved, instead "
+          "of validating all of them.",
+          Parameter(false)));
+    HPP_END_PARAMETER_DECLARATION(PathPlanner)
   } //   namespace core
 } // namespace hpp
@@ -18,16 +18,25 @@
 
 #include <hpp/core/path-planner/bi-rrt-star.hh>
 
+#include <algorithm>
+#include <limits>
 #include <queue>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
 
 #include <hpp/pinocchio/configuration.hh>
 
 #include <hpp/core/configuration-shooter.hh>
+#include <hpp/core/configuration-shooter/informed.hh>
 #include <hpp/core/config-validations.hh>
+#include <hpp/core/continuous-validation.hh>
 #include <hpp/core/path-projector.hh>
 #include <hpp/core/path-validation.hh>
+#include <hpp/core/path-vector.hh>
 #include <hpp/core/path-validation-report.hh>
 #include <hpp/core/problem.hh>
+#include <hpp/core/random-generator.hh>
 #include <hpp/core/roadmap.hh>
 #include <hpp/core/edge.hh>
 
@@ -53,6 +62,8 @@ namespace hpp {
         Parent_t (problem),
         gamma_ (1.),
         extendMaxLength_ (1.),
+        maxNearNodes_ (-1),
+        bestCost_ (std::numeric_limits<value_type>::infinity()),
         toRoot_(2)
       {
         maxIterations(100);
@@ -63,6 +74,8 @@ namespace hpp {
         Parent_t (problem, roadmap),
         gamma_ (1.),
         extendMaxLength_ (1.),
+        maxNearNodes_ (-1),
+        bestCost_ (std::numeric_limits<value_type>::infinity()),
         toRoot_(2)
       {
         maxIterations(100);
@@ -77,20 +90,29 @@ namespace hpp {
 
       // ----------- Algorithm ---------------------------------------------- //
 
-      typedef std::pair<bool, PathPtr_t> ValidatedPath_t;
+      /// Path from a near node
+      struct ValidatedPath_t
+      {
+        ValidatedPath_t (bool v, const PathPtr_t& p, value_type c = -1) :
+          validated (v), path (p), clearance (c)
+        {
+        }
+        /// Whether the path validation was run
+        bool validated;
+        /// Null if the path is not valid
+        PathPtr_t path;
+        /// Clearance of the path, negative if unknown
+        value_type clearance;
+      };
 
-      typedef std::map<NodePtr_t, EdgePtr_t> ParentMap_t;
+      typedef std::pair<EdgePtr_t, value_type> Parent_t;
+      typedef boost::unordered_map<NodePtr_t, Parent_t> ParentMap_t;
       value_type computeCost(const ParentMap_t& map, NodePtr_t n)
       {
-        typedef ParentMap_t::const_iterator It_t;
-        value_type c = 0;
-        for (It_t current = map.find(n); current->second; 
-            current = map.find(current->second->from())) {
-          if (current == map.end())
-            throw std::logic_error("this node has no parent.");
-          c += current->second->path()->length();
-        }
-        return c;
+        ParentMap_t::const_iterator current (map.find(n));
+        if (current == map.end())
+          throw std::logic_error("this node has no parent.");
+        return current->second.second;
       }
 
       /// \param map the parent map to update
@@ -98,14 +120,48 @@ namespace hpp {
       /// \param e a roadmap edge that ends at \c n.
       /// \note if \c e is NULL, then \c n is considered a root of the parent
       /// map.
+      ///
+      /// The costs of the descendants of \c n are updated.
       void setParent(ParentMap_t& map, NodePtr_t n, EdgePtr_t e)
       {
+        value_type cost (0);
         if (e) {
           assert(e->to() == n);
-          if (map.find(e->from()) == map.end())
+          ParentMap_t::const_iterator from (map.find(e->from()));
+          if (from == map.end())
             throw std::logic_error("could not find node from of edge in parent map. Did you start from a pre-built roadmap ?");
+          cost = from->second.second + e->cost();
+        }
+        std::pair<ParentMap_t::iterator, bool> res
+          (map.insert(std::make_pair(n, Parent_t(e, cost))));
+        if (res.second) return;
+        res.first->second = Parent_t(e, cost);
+
+        // Children of a node are the targets of its out edges that are the
+        // parent edges of these targets.
+        std::vector<NodePtr_t> nodes (1, n);
+        while (!nodes.empty()) {
+          const NodePtr_t node (nodes.back());
+          nodes.pop_back();
+          const value_type c (map.find(node)->second.second);
+          const Edges_t& edges = node->outEdges();
+          for (Edges_t::const_iterator _edge = edges.begin();
+              _edge != edges.end(); ++_edge) {
+            ParentMap_t::iterator child (map.find((*_edge)->to()));
+            if (child == map.end() || child->second.first != *_edge) continue;
+            child->second.second = c + (*_edge)->cost();
+            nodes.push_back(child->first);
+          }
         }
-        map[n] = e;
+      }
+
+      /// Edge from the parent of a node, null for the root
+      EdgePtr_t parentEdge(const ParentMap_t& map, NodePtr_t n)
+      {
+        ParentMap_t::const_iterator current (map.find(n));
+        if (current == map.end())
+          throw std::logic_error("this node has no parent.");
+        return current->second.first;
       }
 
       struct WeighedNode_t {
@@ -150,14 +206,15 @@ namespace hpp {
                 _edge != edges.end(); ++_edge) {
               EdgePtr_t edge (*_edge);
               queue.push(WeighedNode_t(edge->to(), edge,
-                    current.cost + edge->path()->length()));
+                    current.cost + edge->cost()));
             }
           }
         }
 
         ParentMap_t result;
+        result.rehash(visited.size());
         for (ItV_t _v = visited.begin(); _v != visited.end(); ++_v)
-          result[_v->first] = _v->second.parent;
+          result[_v->first] = Parent_t(_v->second.parent, _v->second.cost);
         return result;
       }
 
@@ -172,6 +229,7 @@ namespace hpp {
         if (extendMaxLength_ <= 0)
           extendMaxLength_ = std::sqrt(problem().robot()->numberDof());
         gamma_ = problem().getParameter("BiRRT*/gamma").floatValue();
+        maxNearNodes_ = problem().getParameter("BiRRT*/maxNearNodes").intValue();
 
         roots_[0] = roadmap()->initNode();
         roots_[1] = roadmap()->goalNodes()[0];
@@ -180,6 +238,15 @@ namespace hpp {
         toRoot_[1].clear();
         setParent(toRoot_[0], roots_[0], EdgePtr_t());
         setParent(toRoot_[1], roots_[1], EdgePtr_t());
+        bestCost_ = std::numeric_limits<value_type>::infinity();
+
+        informed_.reset();
+        if (problem().getParameter("BiRRT*/informedSampling").boolValue()) {
+          informed_ = configurationShooter::Informed::create
+            (problem().configurationShooter(), problem().distance());
+          informed_->foci(*roots_[0]->configuration(),
+              *roots_[1]->configuration());
+        }
       }
 
       void BiRrtStar::oneStep ()
@@ -206,51 +273,80 @@ namespace hpp {
           assert(toRoot_[0].size() == toRoot_[1].size());
           assert(toRoot_[0].size() == roadmap()->nodes().size());
           improve(q);
+          if (informed_) {
+            const std::size_t i (roots_[0] == roadmap()->initNode() ? 0 : 1);
+            informed_->maxCost(computeCost(toRoot_[i], roots_[1-i]));
+          }
+          if (publishesSolutions()) publishImprovement();
         }
       }
 
+      void BiRrtStar::publishImprovement ()
+      {
+        // Parent map of the tree rooted at the initial node
+        const std::size_t i (roots_[0] == roadmap()->initNode() ? 0 : 1);
+        const value_type c (computeCost(toRoot_[i], roots_[1-i]));
+        const bool first (bestCost_ == std::numeric_limits<value_type>::infinity());
+        if (c >= bestCost_) return;
+        bestCost_ = c;
+        // PathPlanner::solve publishes the path found when the trees connect.
+        if (first) return;
+
+        std::vector<PathPtr_t> paths;
+        for (EdgePtr_t edge = parentEdge(toRoot_[i], roots_[1-i]); edge;
+            edge = parentEdge(toRoot_[i], edge->from()))
+          paths.push_back(edge->path());
+        PathVectorPtr_t pv (PathVector::create
+            (problem().robot()->configSize(), problem().robot()->numberDof()));
+        for (std::vector<PathPtr_t>::reverse_iterator _path = paths.rbegin();
+            _path != paths.rend(); ++_path)
+          pv->appendPath(*_path);
+        publishSolution(pv);
+      }
+
       Configuration_t BiRrtStar::sample ()
       {
         Configuration_t q (problem().robot()->configSize());
         ConfigurationShooterPtr_t shooter = problem().configurationShooter();
+        RandomGenerator& generator (*problem().randomGenerator());
+        // Once a solution exists, only sample configurations that may
+        // shorten it.
+        if (informed_ && roadmap()->connectedComponents().size() == 1)
+          shooter = informed_;
 
         if (roadmap()->connectedComponents().size() == 1
-            && value_type(rand())/INT_MAX > (value_type)0.2) {
+            && generator.uniform() > (value_type)0.2) {
           // Compute best path and find one point
-          typedef ParentMap_t::const_iterator It_t;
-          int nedges = 0;
-          for (It_t current = toRoot_[0].find(roots_[1]); current->second;
-              current = toRoot_[0].find(current->second->from())) {
-            if (current == toRoot_[0].end()) {
-              shooter->shoot(q);
-              return q;
-            }
-            ++nedges;
+          if (toRoot_[0].find(roots_[1]) == toRoot_[0].end()) {
+            shooter->shoot(q);
+            return q;
           }
+          std::vector<EdgePtr_t> edges;
+          for (EdgePtr_t edge = parentEdge(toRoot_[0], roots_[1]); edge;
+              edge = parentEdge(toRoot_[0], edge->from()))
+            edges.push_back(edge);
+          const int nedges ((int)edges.size());
           if (nedges >= 2) {
-            int i = 1+(rand()%(nedges-1));
-            It_t edge1, edge0;
-            for (edge1 = toRoot_[0].find(roots_[1]); i != 1;
-                edge1 = toRoot_[0].find(edge1->second->from()))
-              --i;
-            edge0 = toRoot_[0].find(edge1->second->from());
-            if(edge0->second->to() != edge1->second->from())
+            int i = 1+(int)generator.index(nedges-1);
+            const EdgePtr_t& e1 (edges[i-1]);
+            const EdgePtr_t& e0 (edges[i]);
+            if(e0->to() != e1->from())
               throw std::logic_error("wrong parent map.");
 
             // qm = (q0 + q2) / 2
             pinocchio::interpolate(problem().robot(),
-                *edge0->second->from()->configuration(),
-                *edge1->second->to()->configuration(),
+                *e0->from()->configuration(),
+                *e1->to()->configuration(),
                 0.5, q);
 
             // q = q1 + alpha * (qm - q1)
             vector_t v (problem().robot()->numberDof());
             pinocchio::difference(problem().robot(),
-                q, *edge0->second->to()->configuration(), v);
+                q, *e0->to()->configuration(), v);
             v.normalize();
 
-            value_type l (extendMaxLength_ - value_type(rand()) * extendMaxLength_ / (10 * (value_type)INT_MAX));
-            pinocchio::integrate(problem().robot(), *edge0->second->to()->configuration(), l*v, q);
+            value_type l (extendMaxLength_ - generator.uniform() * extendMaxLength_ / 10);
+            pinocchio::integrate(problem().robot(), *e0->to()->configuration(), l*v, q);
             return q;
           }
         }
@@ -259,18 +355,92 @@ namespace hpp {
         return q;
       }
 
-      bool validate(const Problem& problem, const PathPtr_t& path)
+      /// Validate path
+      /// \retval clearance clearance of the path if the path validation is
+      ///         a ContinuousValidation, -1 otherwise.
+      bool validate(const Problem& problem, const PathPtr_t& path,
+          value_type& clearance)
       {
         PathPtr_t validPart;
         PathValidationReportPtr_t report;
+        ContinuousValidationPtr_t continuous (HPP_DYNAMIC_PTR_CAST
+            (ContinuousValidation, problem.pathValidation()));
+        clearance = -1;
+        if (continuous)
+          return continuous->validateWithClearance (path, false, validPart,
+              report, clearance);
         return problem.pathValidation()
           ->validate (path, false, validPart, report);
       }
 
+      /// Validate paths[i] if not done yet
+      /// \return whether the path is valid.
+      bool validate(const Problem& problem, ValidatedPath_t& path)
+      {
+        if (!path.validated) {
+          path.validated = true;
+          if (!validate (problem, path.path, path.clearance))
+            path.path.reset();
+        }
+        return path.path;
+      }
+
+      /// Store the clearance of an edge and of its reverse edge
+      void storeClearance (const RoadmapPtr_t& roadmap, const EdgePtr_t& edge,
+          const EdgePtr_t& reverse, value_type clearance)
+      {
+        if (clearance < 0) return;
+        roadmap->clearance (edge, clearance);
+        roadmap->clearance (reverse, clearance);
+      }
+
+      /// Choose the parent of a new node among the nodes around it
+      ///
+      /// Candidates are sorted by a lower bound of the cost of the new node
+      /// through them, computed before their validation, and validated in
+      /// this order until the lower bound exceeds the cost of the chosen
+      /// candidate. The cost of an edge only exceeds its lower bound when
+      /// the edge cost of the roadmap depends on the clearance, see
+      /// Roadmap::ClearanceCost.
+      /// \param paths path from each near node to the new node. Paths of
+      ///        validated candidates are flagged, invalid ones are reset.
+      /// \param[in,out] parent, path, clearance, cost parent of the new node,
+      ///        path from the parent, its clearance and cost of the new
+      ///        node. The input parent is kept if no candidate is cheaper.
+      void chooseParent (const Problem& problem, const Roadmap& roadmap,
+          const ParentMap_t& parentMap, const NodeVector_t& nearNodes,
+          std::vector<ValidatedPath_t>& paths, NodePtr_t& parent,
+          PathPtr_t& path, value_type& clearance, value_type& cost)
+      {
+        typedef std::pair<value_type, std::size_t> Candidate_t;
+        std::vector<Candidate_t> candidates;
+        candidates.reserve(nearNodes.size());
+        for (std::size_t i = 0; i < nearNodes.size(); ++i) {
+          if (nearNodes[i] == parent || !paths[i].path) continue;
+          value_type c = computeCost(parentMap, nearNodes[i])
+            + roadmap.cost(paths[i].path, paths[i].clearance);
+          if (c < cost) candidates.push_back(Candidate_t(c, i));
+        }
+        std::sort(candidates.begin(), candidates.end());
+        for (std::size_t j = 0; j < candidates.size(); ++j) {
+          if (candidates[j].first >= cost) break;
+          const std::size_t i (candidates[j].second);
+          if (!validate (problem, paths[i])) continue;
+          const value_type c (computeCost(parentMap, nearNodes[i])
+              + roadmap.cost(paths[i].path, paths[i].clearance));
+          if (c >= cost) continue;
+          cost = c;
+          parent = nearNodes[i];
+          path = paths[i].path;
+          clearance = paths[i].clearance;
+        }
+      }
+
       PathPtr_t BiRrtStar::buildPath(const Configuration_t& q0, const Configuration_t& q1,
           value_type maxLength,
-          bool validatePath)
+          bool validatePath, value_type& clearance)
       {
+        clearance = -1;
         PathPtr_t path = problem().steeringMethod()->steer(q0, q1);
         if (!path) return path;
         if (problem().pathProjector()) { // path projection
@@ -289,10 +459,28 @@ namespace hpp {
 
         PathPtr_t validPart;
         PathValidationReportPtr_t report;
-        problem().pathValidation()->validate (path, false, validPart, report);
+        ContinuousValidationPtr_t continuous (HPP_DYNAMIC_PTR_CAST
+            (ContinuousValidation, problem().pathValidation()));
+        if (continuous)
+          continuous->validateWithClearance (path, false, validPart, report,
+              clearance);
+        else
+          problem().pathValidation()->validate (path, false, validPart, report);
         return validPart;
       }
 
+      NodeVector_t BiRrtStar::nodesWithinBall (const Configuration_t& q,
+          const ConnectedComponentPtr_t& cc)
+      {
+        const value_type n ((value_type)roadmap()->nodes().size());
+        const value_type radius (std::min(gamma_ * std::pow(std::log(n)/n,
+                1./(value_type)problem().robot()->numberDof()),
+              extendMaxLength_));
+        if (maxNearNodes_ < 0)
+          return roadmap()->nodesWithinBall(q, cc, radius);
+        return roadmap()->nodesWithinBall(q, cc, radius, maxNearNodes_);
+      }
+
       bool BiRrtStar::extend (NodePtr_t target, ParentMap_t& parentMap, Configuration_t& q)
       {
         ConnectedComponentPtr_t cc (target->connectedComponent());
@@ -302,64 +490,52 @@ namespace hpp {
         if (dist < 1e-16)
           return false;
 
-        PathPtr_t path = buildPath(*near->configuration(), q, extendMaxLength_, true);
+        value_type clearance;
+        PathPtr_t path = buildPath(*near->configuration(), q, extendMaxLength_,
+            true, clearance);
         if (!path || path->length() < 1e-10) return false;
         q = path->end();
 
-        value_type n ((value_type)roadmap()->nodes().size());
-        NodeVector_t nearNodes = roadmap()->nodesWithinBall(q, cc,
-            std::min(gamma_ * std::pow(std::log(n)/n, 1./(value_type)problem().robot()->numberDof()),
-              extendMaxLength_));
+        NodeVector_t nearNodes = nodesWithinBall(q, cc);
 
-        value_type cost_q (computeCost(parentMap, near) + path->length());
+        value_type cost_q (computeCost(parentMap, near)
+            + roadmap()->cost(path, clearance));
         std::vector<ValidatedPath_t> paths;
         paths.reserve(nearNodes.size());
+        value_type unused;
         for (NodeVector_t::const_iterator _near = nearNodes.begin(); _near != nearNodes.end(); ++_near) {
-          PathPtr_t near2new;
-          if (*_near == near) {
-            near2new = path;
-            paths.push_back(ValidatedPath_t(true, near2new));
-            continue;
-          } else {
-            near2new = buildPath(*(*_near)->configuration(), q, -1, false);
-            paths.push_back(ValidatedPath_t(false, near2new));
-          }
-          if (!near2new) continue;
-
-          value_type _cost_q = computeCost(parentMap, *_near) + near2new->length();
-          if (_cost_q < cost_q) {
-            paths.back().first = true;
-            // Run path validation
-            if (validate (problem(), near2new)) {
-              // Path is valid and shorter.
-              cost_q = _cost_q;
-              near = *_near;
-              path = near2new;
-            } else
-              paths.back().second.reset();
-          }
+          if (*_near == near)
+            paths.push_back(ValidatedPath_t(true, path, clearance));
+          else
+            paths.push_back(ValidatedPath_t(false,
+                  buildPath(*(*_near)->configuration(), q, -1, false, unused)));
         }
+        chooseParent (problem(), *roadmap(), parentMap, nearNodes, paths, near,
+            path, clearance, cost_q);
 
-        NodePtr_t qnew = roadmap()->addNode(boost::make_shared<Configuration_t>(q));
+        NodePtr_t qnew = roadmap()->addNode(q);
         EdgePtr_t edge = roadmap()->addEdge(near, qnew, path);
-        roadmap()->addEdge(qnew, near, path->reverse());
+        storeClearance (roadmap(), edge,
+            roadmap()->addEdge(qnew, near, path->reversedView()), clearance);
         assert(parentMap.find(near) != parentMap.end());
         setParent(parentMap, qnew, edge);
 
         for (std::size_t i = 0; i < nearNodes.size(); ++i) {
-          if (nearNodes[i] == near || !paths[i].second) continue;
-
-          value_type cost_q_near = cost_q + paths[i].second->length();
-          if (cost_q_near < computeCost(parentMap, nearNodes[i])) {
-            bool pathValid = paths[i].first;
-            if (!pathValid) // If path validation has not been run
-              pathValid = validate(problem(), paths[i].second);
-            if (pathValid) {
-              roadmap()->addEdge(nearNodes[i], qnew, paths[i].second);
-              edge = roadmap()->addEdge(qnew, nearNodes[i], paths[i].second->reverse());
-              setParent(parentMap, nearNodes[i], edge);
-            }
-          }
+          if (nearNodes[i] == near || !paths[i].path) continue;
+
+          // Lower bound of the cost if the path was not validated yet
+          value_type cost_q_near = cost_q
+            + roadmap()->cost(paths[i].path, paths[i].clearance);
+          if (cost_q_near >= computeCost(parentMap, nearNodes[i])) continue;
+          if (!validate(problem(), paths[i])) continue;
+          cost_q_near = cost_q
+            + roadmap()->cost(paths[i].path, paths[i].clearance);
+          if (cost_q_near >= computeCost(parentMap, nearNodes[i])) continue;
+          const EdgePtr_t forward
+            (roadmap()->addEdge(nearNodes[i], qnew, paths[i].path));
+          edge = roadmap()->addEdge(qnew, nearNodes[i], paths[i].path->reversedView());
+          storeClearance (roadmap(), forward, edge, paths[i].clearance);
+          setParent(parentMap, nearNodes[i], edge);
         }
         return true;
       }
@@ -383,74 +559,64 @@ namespace hpp {
         if (dist < 1e-16)
           return false;
 
-        const PathPtr_t nearQ_qnew = buildPath(*nearQ->configuration(), q, extendMaxLength_, true);
+        value_type nearQ_clearance;
+        const PathPtr_t nearQ_qnew = buildPath(*nearQ->configuration(), q,
+            extendMaxLength_, true, nearQ_clearance);
         if (!nearQ_qnew || nearQ_qnew->length() < 1e-10) return false;
 
         const Configuration_t qnew (nearQ_qnew->end());
 
-        const value_type n ((value_type)roadmap()->nodes().size());
-        NodeVector_t nearNodes = roadmap()->nodesWithinBall(qnew, roots_[0]->connectedComponent(),
-            std::min(gamma_ * std::pow(std::log(n)/n, 1./(value_type)problem().robot()->numberDof()),
-              extendMaxLength_));
+        NodeVector_t nearNodes = nodesWithinBall(qnew, roots_[0]->connectedComponent());
 
-        const NodePtr_t nnew = roadmap()->addNode(boost::make_shared<Configuration_t>(qnew));
+        const NodePtr_t nnew = roadmap()->addNode(qnew);
 
+        // Paths are shared by both trees: each path is validated at most
+        // once.
         std::vector<ValidatedPath_t> paths;
         paths.reserve(nearNodes.size());
+        value_type unused;
+        for (NodeVector_t::const_iterator _near = nearNodes.begin(); _near != nearNodes.end(); ++_near) {
+          if (*_near == nearQ)
+            paths.push_back(ValidatedPath_t(true, nearQ_qnew, nearQ_clearance));
+          else
+            paths.push_back(ValidatedPath_t(false,
+                  buildPath(*(*_near)->configuration(), qnew, -1, false, unused)));
+        }
 
         for (int k = 0; k < 2; ++k) {
-          paths.clear();
-
           NodePtr_t bestParent (nearQ);
           PathPtr_t best_qnew(nearQ_qnew);
-          value_type cost_q (computeCost(toRoot_[k], nearQ) + nearQ_qnew->length());
-
-          for (NodeVector_t::const_iterator _near = nearNodes.begin(); _near != nearNodes.end(); ++_near) {
-            PathPtr_t near2new;
-            if (*_near == nearQ) {
-              near2new = nearQ_qnew;
-              paths.push_back(ValidatedPath_t(true, near2new));
-              continue;
-            } else {
-              near2new = buildPath(*(*_near)->configuration(), qnew, -1, false);
-              paths.push_back(ValidatedPath_t(false, near2new));
-            }
-            if (!near2new) continue;
-
-            value_type _cost_q = computeCost(toRoot_[k], *_near) + near2new->length();
-            if (_cost_q < cost_q) {
-              paths.back().first = true;
-              // Run path validation
-              if (validate (problem(), near2new)) {
-                // Path is valid and shorter.
-                cost_q = _cost_q;
-                bestParent = *_near;
-                best_qnew = near2new;
-              } else
-                paths.back().second.reset();
-            }
-          }
+          value_type clearance (nearQ_clearance);
+          value_type cost_q (computeCost(toRoot_[k], nearQ)
+              + roadmap()->cost(nearQ_qnew, nearQ_clearance));
+
+          chooseParent (problem(), *roadmap(), toRoot_[k], nearNodes, paths,
+              bestParent, best_qnew, clearance, cost_q);
 
           EdgePtr_t edge = roadmap()->addEdge(bestParent, nnew, best_qnew);
-          roadmap()->addEdge(nnew, bestParent, best_qnew->reverse());
+          storeClearance (roadmap(), edge,
+              roadmap()->addEdge(nnew, bestParent, best_qnew->reversedView()),
+              clearance);
           assert(toRoot_[k].find(bestParent) != toRoot_[k].end());
           setParent(toRoot_[k], nnew, edge);
 
           for (std::size_t i = 0; i < nearNodes.size(); ++i) {
-            if (nearNodes[i] == bestParent || !paths[i].second) continue;
-
-            value_type cost_q_near = cost_q + paths[i].second->length();
-            if (cost_q_near < computeCost(toRoot_[k], nearNodes[i])) {
-              bool pathValid = paths[i].first;
-              if (!pathValid) // If path validation has not been run
-                pathValid = validate(problem(), paths[i].second);
-              if (pathValid) {
-                roadmap()->addEdge(nearNodes[i], nnew, paths[i].second);
-                edge = roadmap()->addEdge(nnew, nearNodes[i], paths[i].second->reverse());
-                assert(toRoot_[k].find(nnew) != toRoot_[k].end());
-                setParent(toRoot_[k], nearNodes[i], edge);
-              }
-            }
+            if (nearNodes[i] == bestParent || !paths[i].path) continue;
+
+            // Lower bound of the cost if the path was not validated yet
+            value_type cost_q_near = cost_q
+              + roadmap()->cost(paths[i].path, paths[i].clearance);
+            if (cost_q_near >= computeCost(toRoot_[k], nearNodes[i])) continue;
+            if (!validate(problem(), paths[i])) continue;
+            cost_q_near = cost_q
+              + roadmap()->cost(paths[i].path, paths[i].clearance);
+            if (cost_q_near >= computeCost(toRoot_[k], nearNodes[i])) continue;
+            const EdgePtr_t forward
+              (roadmap()->addEdge(nearNodes[i], nnew, paths[i].path));
+            edge = roadmap()->addEdge(nnew, nearNodes[i], paths[i].path->reversedView());
+            storeClearance (roadmap(), forward, edge, paths[i].clearance);
+            assert(toRoot_[k].find(nnew) != toRoot_[k].end());
+            setParent(toRoot_[k], nearNodes[i], edge);
           }
         }
         return true;
@@ -467,6 +633,14 @@ namespace hpp {
             "BiRRT*/gamma",
             "",
             Parameter(1.)));
+      Problem::declareParameter(ParameterDescription (Parameter::INT,
+            "BiRRT*/maxNearNodes",
+            "Maximal number of nodes considered when rewiring. If negative, all the nodes within the ball are considered.",
+            Parameter((size_type)-1)));
+      Problem::declareParameter(ParameterDescription (Parameter::BOOL,
+            "BiRRT*/informedSampling",
+            "Once a solution is found, only sample configurations whose distances to the initial and goal configurations sum to less than the cost of the solution.",
+            Parameter(true)));
       HPP_END_PARAMETER_DECLARATION(BiRrtStar)
     } // namespace pathPlanner
   } // namespace core
@@ -18,16 +18,31 @@
 
 #include <hpp/core/path-planner/k-prm-star.hh>
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <hpp/util/debug.hh>
+#include <hpp/pinocchio/device.hh>
 
 #include <hpp/core/configuration-shooter.hh>
 #include <hpp/core/config-validations.hh>
+#include <hpp/core/edge.hh>
+#include <hpp/core/node.hh>
 #include <hpp/core/path-projector.hh>
 #include <hpp/core/path-validation.hh>
 #include <hpp/core/path-validation-report.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/roadmap.hh>
 
+#include "../astar.hh"
+
 namespace hpp {
   namespace core {
     namespace pathPlanner {
@@ -61,6 +76,27 @@ namespace hpp {
         }
         numberNeighbors_ = (size_type) floor
           ((kPRM * log ((value_type) numberNodes_)) + .5);
+        const size_type densification
+          (problem().getParameter ("kPRM*/densification").intValue());
+        if (densification < 0) {
+          std::ostringstream oss;
+          oss << "kPrmStar: densification should be non negative, got "
+              << densification;
+          throw std::runtime_error (oss.str ().c_str ());
+        }
+        densification_ = (std::size_t) densification;
+        firstNewNode_ = 0;
+        lazy_ = problem().getParameter ("kPRM*/lazy").boolValue();
+        tools_.clear ();
+        if (numberThreads_ > 1) {
+          for (size_type i = 0; i < numberThreads_; ++i)
+            tools_.push_back (factory_ ());
+        }
+        samplingTools_.clear ();
+        if (numberSamplingThreads_ > 1) {
+          for (size_type i = 0; i < numberSamplingThreads_; ++i)
+            samplingTools_.push_back (samplingFactory_ ());
+        }
         if (roadmap ()->nodes ().size () >= numberNodes_) {
           state_ = CONNECT_INIT_GOAL;
         } else {
@@ -75,16 +111,29 @@ namespace hpp {
         switch (state_)
           {
           case BUILD_ROADMAP:
-            generateRandomConfig ();
+            if (samplingTools_.empty () ||
+                roadmap ()->nodes ().size () >= numberNodes_) {
+              generateRandomConfig ();
+            } else {
+              generateRandomConfigsInParallel ();
+            }
             break;
           case LINK_NODES:
-            linkNodes ();
+            if (tools_.empty ()) {
+              linkNodes ();
+            } else {
+              linkNodesInParallel ();
+            }
             break;
           case CONNECT_INIT_GOAL:
             connectInitAndGoal ();
-            state_ = FAILURE;
+            state_ = lazy_ ? VALIDATE_PATH : FAILURE;
+            break;
+          case VALIDATE_PATH:
+            validateShortestPath ();
             break;
           case FAILURE:
+            if (densify ()) break;
             oss << "kPRM* failed to solve problem with " << numberNodes_
                 << " nodes.";
             throw std::runtime_error (oss.str ().c_str ());
@@ -93,10 +142,6 @@ namespace hpp {
 
       void kPrmStar::generateRandomConfig ()
       {
-	// shoot a valid random configuration
-	Configuration_t qrand;
-	// Report of configuration validation: unused here
-	ValidationReportPtr_t validationReport;
 	// Configuration validation methods associated to the problem
 	ConfigValidationsPtr_t configValidations
           (problem ().configValidations ());
@@ -107,40 +152,146 @@ namespace hpp {
 	// Get roadmap
 	RoadmapPtr_t r (roadmap ());
         if (r->nodes ().size () < numberNodes_) {
-          size_type nbTry = 0;
-          bool valid (false);
+          // Shoot random configurations by blocks and validate each block
+          // in one call.
+          const size_type blockSize
+            ((size_type) std::min (numberNodes_ - r->nodes ().size (),
+                                   (std::size_t) 16));
+          Configuration_t qrand;
+          matrix_t block (problem ().robot ()->configSize (), blockSize);
+          std::vector <bool> valid;
+          // Reports of configuration validation give the rejection causes.
+          std::vector <ValidationReportPtr_t> validationReports;
+          PlannerStatistics& stats (mutableStatistics ());
+          size_type nbTry = 0, nbValid = 0;
           // After 10000 trials throw if no valid configuration has been found.
           do {
-            shooter->shoot (qrand);
-            valid = (!constraints || constraints->apply (qrand));
-            if (valid)
-              valid = configValidations->validate (qrand, validationReport);
-	    nbTry++;
-          } while (!valid && nbTry < 10000);
-          if (!valid) {
+            size_type n = 0;
+            for (size_type i = 0; i < blockSize; ++i) {
+              shooter->shoot (qrand);
+              if (!constraints || constraints->apply (qrand))
+                block.col (n++) = qrand;
+              else
+                stats.reject (PlannerStatistics::PROJECTION_FAILURE);
+            }
+            nbTry += blockSize;
+            stats.sampled (blockSize);
+            if (n == 0) continue;
+            const matrix_t samples (block.leftCols (n));
+            configValidations->validateConfigurations (samples, valid,
+                                                       validationReports);
+            for (size_type i = 0; i < n; ++i) {
+              if (!valid [i]) {
+                stats.reject (validationReports [i]);
+                continue;
+              }
+              r->addNode (Configuration_t (samples.col (i)));
+              ++nbValid;
+            }
+          } while (nbValid == 0 && nbTry < 10000);
+          if (nbValid == 0) {
             throw std::runtime_error
               ("Failed to generate free configuration after 10000 trials.");
           }
-          r->addNode (qrand);
         } else {
           state_ = LINK_NODES;
+          computeNeighbors ();
           linkingNodeIt_ = r->nodes ().begin ();
-          neighbors_ =roadmap ()->nearestNodes
-            (*(*linkingNodeIt_)->configuration (), numberNeighbors_);
+          std::advance (linkingNodeIt_, firstNewNode_);
+          linkingNodeRank_ = firstNewNode_;
+          neighbors_ = neighborsOfNodes_ [0];
           itNeighbor_ = neighbors_.begin ();
         }
       }
 
+      void kPrmStar::generateRandomConfigsInParallel ()
+      {
+	RoadmapPtr_t r (roadmap ());
+        const size_type configSize (problem ().robot ()->configSize ());
+        const std::size_t missing (numberNodes_ - r->nodes ().size ());
+        const std::size_t nThreads (std::min (samplingTools_.size (),
+                                              missing));
+        std::vector <std::vector <Configuration_t> > configurations
+          (nThreads);
+        std::vector <PlannerStatistics> statistics (nThreads);
+        boost::thread_group threads;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          // Split the missing configurations evenly among the threads.
+          const std::size_t count ((missing * (t + 1)) / nThreads -
+                                   (missing * t) / nThreads);
+          threads.create_thread
+            (boost::bind (&kPrmStar::sampleRange,
+                          boost::cref (samplingTools_ [t]), configSize, count,
+                          (size_type) 10000, boost::ref (configurations [t]),
+                          boost::ref (statistics [t])));
+        }
+        threads.join_all ();
+        for (std::size_t t = 0; t < nThreads; ++t)
+          mutableStatistics ().addSampling (statistics [t]);
+
+        std::size_t nbValid = 0;
+        for (std::size_t t = 0; t < nThreads; ++t)
+          nbValid += configurations [t].size ();
+        if (nbValid == 0) {
+          throw std::runtime_error
+            ("Failed to generate free configuration after 10000 trials.");
+        }
+        matrix_t block (configSize, nbValid);
+        size_type col = 0;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          for (std::size_t i = 0; i < configurations [t].size (); ++i)
+            block.col (col++) = configurations [t] [i];
+        }
+        r->addNodes (block);
+      }
+
+      void kPrmStar::sampleRange (const SamplingTools& tools,
+                                  size_type configSize, std::size_t count,
+                                  size_type maxTrials,
+                                  std::vector <Configuration_t>& configurations,
+                                  PlannerStatistics& statistics)
+      {
+        Configuration_t q (configSize);
+        ValidationReportPtr_t report;
+        size_type nbTry = 0;
+        while (configurations.size () < count && nbTry < maxTrials) {
+          tools.shooter->shoot (q);
+          ++nbTry;
+          statistics.sampled ();
+          if (tools.constraints && !tools.constraints->apply (q)) {
+            statistics.reject (PlannerStatistics::PROJECTION_FAILURE);
+            continue;
+          }
+          if (!tools.configValidations->validate (q, report)) {
+            statistics.reject (report);
+            continue;
+          }
+          configurations.push_back (q);
+          nbTry = 0;
+        }
+      }
+
+      void kPrmStar::parallelSampling (size_type numberThreads,
+                                       const SamplingToolsFactory_t& factory)
+      {
+        if (numberThreads < 1 || (numberThreads > 1 && !factory))
+          throw std::invalid_argument ("Parallel sampling requires a "
+                                       "positive number of threads and a "
+                                       "factory.");
+        numberSamplingThreads_ = numberThreads;
+        samplingFactory_ = factory;
+      }
+
       void kPrmStar::linkNodes ()
       {
 	// Get roadmap
 	RoadmapPtr_t r (roadmap ());
         if (linkingNodeIt_ != r->nodes ().end ()) {
           if (connectNodeToClosestNeighbors (*linkingNodeIt_)) {
-            ++linkingNodeIt_;
+            ++linkingNodeIt_; ++linkingNodeRank_;
 	    if (linkingNodeIt_ != r->nodes ().end ()) {
-	      neighbors_ = roadmap ()->nearestNodes
-		((*linkingNodeIt_)->configuration (), numberNeighbors_);
+	      neighbors_ = neighborsOfNodes_
+                [linkingNodeRank_ - firstNewNode_];
 	      // Connect current node with closest neighbors
 	      itNeighbor_ = neighbors_.begin ();
 	    }
@@ -148,41 +299,119 @@ namespace hpp {
             ++itNeighbor_;
           }
         } else {
+          neighborsOfNodes_.clear ();
           state_ = CONNECT_INIT_GOAL;
         }
       }
 
+      void kPrmStar::linkNodesInParallel ()
+      {
+	RoadmapPtr_t r (roadmap ());
+        // Gather the pairs of nodes that are not connected yet. Edges are
+        // added in both directions, so each pair is linked once.
+        typedef std::pair <const Node*, const Node*> Pair_t;
+        boost::unordered_set <Pair_t> pairs;
+        Links_t links;
+        Nodes_t::const_iterator itn (r->nodes ().begin ());
+        std::advance (itn, firstNewNode_);
+        for (std::size_t rank = 0; itn != r->nodes ().end (); ++itn, ++rank) {
+          const Nodes_t& neighbors (neighborsOfNodes_ [rank]);
+          for (Nodes_t::const_iterator itNeighbor (neighbors.begin ());
+               itNeighbor != neighbors.end (); ++itNeighbor) {
+            if (*itNeighbor == *itn || (*itNeighbor)->isOutNeighbor (*itn))
+              continue;
+            const Pair_t pair (std::min <const Node*> (*itn, *itNeighbor),
+                               std::max <const Node*> (*itn, *itNeighbor));
+            if (!pairs.insert (pair).second) continue;
+            links.push_back (Link (*itn, *itNeighbor));
+          }
+        }
+
+        const std::size_t nThreads (std::min (tools_.size (), links.size ()));
+        if (nThreads == 1) {
+          linkRange (tools_ [0], lazy_, links, 0, 1);
+        } else if (nThreads > 1) {
+          boost::thread_group threads;
+          for (std::size_t t = 0; t < nThreads; ++t) {
+            threads.create_thread
+              (boost::bind (&kPrmStar::linkRange, boost::cref (tools_ [t]),
+                            lazy_, boost::ref (links), t, nThreads));
+          }
+          threads.join_all ();
+        }
+
+        // Insert the edges and merge the connected components.
+        for (Links_t::const_iterator it = links.begin (); it != links.end ();
+             ++it) {
+          if (!it->path) continue;
+          if (lazy_) {
+            r->addEdges (it->from, it->to, it->path, false);
+          } else if (it->valid) {
+            r->addEdges (it->from, it->to, it->path);
+          }
+        }
+        neighborsOfNodes_.clear ();
+        state_ = CONNECT_INIT_GOAL;
+      }
+
+      void kPrmStar::linkRange (const ConnectionTools& tools, bool lazy,
+                                Links_t& links, std::size_t begin,
+                                std::size_t step)
+      {
+        for (std::size_t i = begin; i < links.size (); i += step) {
+          Link& link (links [i]);
+          link.path = (*tools.steeringMethod) (*link.from->configuration (),
+                                               *link.to->configuration ());
+          if (!link.path || lazy) continue;
+          PathPtr_t projected (link.path), validPart;
+          if (tools.pathProjector &&
+              !tools.pathProjector->apply (link.path, projected)) continue;
+          PathValidationReportPtr_t report;
+          link.valid = tools.pathValidation->validate (projected, false,
+                                                       validPart, report);
+        }
+      }
+
+      void kPrmStar::parallelLinking (size_type numberThreads,
+                                      const ConnectionToolsFactory_t& factory)
+      {
+        if (numberThreads < 1 || (numberThreads > 1 && !factory))
+          throw std::invalid_argument ("Parallel linking requires a positive "
+                                       "number of threads and a factory.");
+        numberThreads_ = numberThreads;
+        factory_ = factory;
+      }
+
+      void kPrmStar::computeNeighbors ()
+      {
+	RoadmapPtr_t r (roadmap ());
+        assert (r->nodes ().size () > firstNewNode_);
+        matrix_t configurations
+          (r->nodes ().front ()->configuration ()->size (),
+           r->nodes ().size () - firstNewNode_);
+        Nodes_t::const_iterator itn (r->nodes ().begin ());
+        std::advance (itn, firstNewNode_);
+        for (size_type i = 0; itn != r->nodes ().end (); ++itn, ++i) {
+          configurations.col (i) = *(*itn)->configuration ();
+        }
+        neighborsOfNodes_ = r->nearestNodes (configurations, numberNeighbors_);
+      }
+
       bool kPrmStar::connectNodeToClosestNeighbors (const NodePtr_t& node)
       {
-	// Retrieve the path validation algorithm associated to the problem
-	PathValidationPtr_t pathValidation (problem ().pathValidation ());
 	// Retrieve the steering method
 	SteeringMethodPtr_t sm (problem ().steeringMethod ());
-	// Retrieve the constraints the robot is subject to
-	ConstraintSetPtr_t constraints (problem ().constraints ());
-        // Retrieve path projector
-        PathProjectorPtr_t pathProjector (problem ().pathProjector ());
 
         if (itNeighbor_ != neighbors_.end ()) {
           // Connect only nodes that are not already connected
           if (!(*itNeighbor_)->isOutNeighbor (node) && (node != *itNeighbor_)) {
             PathPtr_t p ((*sm) (*node->configuration (),
                                 *(*itNeighbor_)->configuration ()));
-            PathValidationReportPtr_t report;
-            PathPtr_t validPart, projected;
             if (p) {
-              bool success;
-              if (pathProjector) {
-                success = pathProjector->apply (p, projected);
-              } else {
-                projected = p;
-                success = true;
-              }
-              if (success) {
-                if (pathValidation->validate (projected, false, validPart,
-                                              report)) {
-                  roadmap ()->addEdges (node, *itNeighbor_, p);
-                }
+              if (lazy_) {
+                roadmap ()->addEdges (node, *itNeighbor_, p, false);
+              } else if (validate (p)) {
+                roadmap ()->addEdges (node, *itNeighbor_, p);
               }
             }
           }
@@ -219,6 +448,107 @@ namespace hpp {
         }
       }
 
+      bool kPrmStar::densify ()
+      {
+        if (densification_ == 0) return false;
+        // Nodes already linked keep their edges, only the new ones are
+        // linked to their neighbors.
+        firstNewNode_ = roadmap ()->nodes ().size ();
+        numberNodes_ = firstNewNode_ + densification_;
+        numberNeighbors_ = (size_type) floor
+          ((kPRM * log ((value_type) numberNodes_)) + .5);
+        hppDout (info, "kPRM*: densification to " << numberNodes_
+                 << " nodes with " << numberNeighbors_ << " neighbors.");
+        state_ = BUILD_ROADMAP;
+        return true;
+      }
+
+      bool kPrmStar::validate (const PathPtr_t& path) const
+      {
+	// Retrieve the path validation algorithm associated to the problem
+	PathValidationPtr_t pathValidation (problem ().pathValidation ());
+        // Retrieve path projector
+        PathProjectorPtr_t pathProjector (problem ().pathProjector ());
+        PathValidationReportPtr_t report;
+        PathPtr_t validPart, projected;
+        if (pathProjector) {
+          if (!pathProjector->apply (path, projected)) return false;
+        } else {
+          projected = path;
+        }
+        return pathValidation->validate (projected, false, validPart, report);
+      }
+
+      void kPrmStar::validateShortestPath ()
+      {
+	RoadmapPtr_t r (roadmap ());
+        Astar astar (r, problem ().distance ());
+        astar.acceptUnvalidatedEdges (true);
+        Astar::Edges_t edges;
+        try {
+          edges = astar.shortestPath ();
+        } catch (const std::runtime_error&) {
+          // Initial and goal nodes are not connected, even lazily.
+          state_ = FAILURE;
+          return;
+        }
+        // Project the edges that are not validated yet, up to the first one
+        // that cannot be projected.
+        PathProjectorPtr_t pathProjector (problem ().pathProjector ());
+        std::vector <EdgePtr_t> lazyEdges;
+        std::vector <PathPtr_t> paths;
+        EdgePtr_t notProjected (0x0);
+        for (Astar::Edges_t::const_iterator itEdge = edges.begin ();
+             itEdge != edges.end (); ++itEdge) {
+          if ((*itEdge)->validated ()) continue;
+          PathPtr_t projected ((*itEdge)->path ());
+          if (pathProjector &&
+              !pathProjector->apply ((*itEdge)->path (), projected)) {
+            notProjected = *itEdge;
+            break;
+          }
+          lazyEdges.push_back (*itEdge);
+          paths.push_back (projected);
+        }
+        // Validate them in one batch, stopping at the first invalid one.
+        std::vector <PathPtr_t> validParts;
+        std::vector <PathValidationReportPtr_t> reports;
+        std::vector <bool> valid;
+        problem ().pathValidation ()->validatePaths
+          (paths, false, validParts, reports, valid, true);
+        for (std::size_t i = 0; i < lazyEdges.size (); ++i) {
+          // Edges are added in both directions by
+          // connectNodeToClosestNeighbors
+          const EdgePtr_t reverse (reverseEdge (lazyEdges [i]));
+          if (valid [i]) {
+            r->validateEdge (lazyEdges [i]);
+            if (reverse) r->validateEdge (reverse);
+          } else if (validParts [i]) {
+            // Edge found invalid, as opposed to not validated.
+            hppDout (info, "Removing invalid edge.");
+            r->removeEdge (lazyEdges [i]);
+            if (reverse) r->removeEdge (reverse);
+          }
+        }
+        if (notProjected) {
+          const EdgePtr_t reverse (reverseEdge (notProjected));
+          hppDout (info, "Removing edge that cannot be projected.");
+          r->removeEdge (notProjected);
+          if (reverse) r->removeEdge (reverse);
+        }
+      }
+
+      EdgePtr_t kPrmStar::reverseEdge (const EdgePtr_t& edge) const
+      {
+        for (Node::Edges_t::const_iterator it
+               (edge->to ()->outEdges ().begin ());
+             it != edge->to ()->outEdges ().end (); ++it) {
+          if ((*it)->to () == edge->from () && !(*it)->validated ())
+            return *it;
+        }
+        return 0x0;
+      }
+
       kPrmStar::STATE kPrmStar::getComputationState () const
       {
 	return state_;
@@ -226,12 +556,14 @@ namespace hpp {
 
       kPrmStar::kPrmStar (const Problem& problem) :
         Parent_t (problem),
-        state_ (BUILD_ROADMAP)
+        state_ (BUILD_ROADMAP), densification_ (0), firstNewNode_ (0),
+        lazy_ (false), numberThreads_ (1), numberSamplingThreads_ (1)
       {}
 
       kPrmStar::kPrmStar (const Problem& problem, const RoadmapPtr_t& roadmap) :
         Parent_t (problem, roadmap),
-        state_ (BUILD_ROADMAP)
+        state_ (BUILD_ROADMAP), densification_ (0), firstNewNode_ (0),
+        lazy_ (false), numberThreads_ (1), numberSamplingThreads_ (1)
       {}
 
       void kPrmStar::init (const kPrmStarWkPtr_t& weak)
@@ -247,6 +579,17 @@ namespace hpp {
             "kPRM*/numberOfNodes",
             "The desired number of nodes in the roadmap.",
             Parameter((size_type)100)));
+      Problem::declareParameter(ParameterDescription (Parameter::BOOL,
+            "kPRM*/lazy",
+            "Whether to insert edges in the roadmap without validating them "
+            "and to validate only the edges of candidate solution paths.",
+            Parameter(false)));
+      Problem::declareParameter(ParameterDescription (Parameter::INT,
+            "kPRM*/densification",
+            "Number of nodes added to the roadmap each time the initial and "
+            "goal nodes cannot be connected, the roadmap being kept. 0 to "
+            "fail instead.",
+            Parameter((size_type)0)));
       HPP_END_PARAMETER_DECLARATION(kPrmStar)
     } // namespace pathPlanner
   } // namespace core
@@ -0,0 +1,202 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/path-planner/parallel-bi-rrt.hh>
+
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/core/configuration-shooter.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/path.hh>
+#include <hpp/core/path-validation.hh>
+#include <hpp/core/path-validation-report.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/roadmap.hh>
+#include <hpp/core/steering-method.hh>
+
+#include "../nearest-neighbor/concurrent.hh"
+
+namespace hpp {
+  namespace core {
+    namespace pathPlanner {
+      ParallelBiRRTPtr_t ParallelBiRRT::create (const Problem& problem)
+      {
+        ParallelBiRRTPtr_t shPtr (new ParallelBiRRT (problem));
+        shPtr->init (shPtr);
+        return shPtr;
+      }
+
+      ParallelBiRRTPtr_t ParallelBiRRT::createWithRoadmap
+      (const Problem& problem, const RoadmapPtr_t& roadmap)
+      {
+        ParallelBiRRTPtr_t shPtr (new ParallelBiRRT (problem, roadmap));
+        shPtr->init (shPtr);
+        return shPtr;
+      }
+
+      void ParallelBiRRT::workers (size_type numberThreads,
+                                   const ConnectionToolsFactory_t& factory)
+      {
+        if (numberThreads < 1 || (numberThreads > 1 && !factory))
+          throw std::invalid_argument ("Parallel Bi-RRT requires a positive "
+                                       "number of threads and a factory.");
+        numberWorkers_ = numberThreads;
+        factory_ = factory;
+      }
+
+      void ParallelBiRRT::startSolve ()
+      {
+        Parent_t::startSolve ();
+        tools_.clear ();
+        if (numberWorkers_ > 1) {
+          for (size_type i = 0; i < numberWorkers_; ++i)
+            tools_.push_back (factory_ ());
+        } else {
+          ConnectionTools tools;
+          tools.steeringMethod = problem ().steeringMethod ();
+          tools.pathValidation = problem ().pathValidation ();
+          tools_.push_back (tools);
+        }
+        concurrentSearches_ = dynamic_cast <nearestNeighbor::Concurrent*>
+          (roadmap ()->nearestNeighbor ()) != 0x0;
+      }
+
+      void ParallelBiRRT::oneStep ()
+      {
+        if (tools_.size () == 1) {
+          extend (tools_ [0]);
+          return;
+        }
+        boost::thread_group threads;
+        for (std::size_t t = 0; t < tools_.size (); ++t) {
+          threads.create_thread (boost::bind (&ParallelBiRRT::extend, this,
+                                              boost::cref (tools_ [t])));
+        }
+        threads.join_all ();
+      }
+
+      NodePtr_t ParallelBiRRT::nearestNode
+      (const Configuration_t& configuration,
+       const ConnectedComponentPtr_t& component, bool reverse)
+      {
+        value_type distance;
+        if (concurrentSearches_)
+          return roadmap ()->nearestNode (configuration, component, distance,
+                                          reverse);
+        boost::mutex::scoped_lock lock (mutex_);
+        return roadmap ()->nearestNode (configuration, component, distance,
+                                        reverse);
+      }
+
+      void ParallelBiRRT::extend (const ConnectionTools& tools)
+      {
+        const SteeringMethodPtr_t& sm (tools.steeringMethod);
+        const PathValidationPtr_t& pathValidation (tools.pathValidation);
+        Configuration_t q_rand, qProj (problem ().robot ()->configSize ());
+        if (tools.configurationShooter) {
+          tools.configurationShooter->shoot (q_rand);
+        } else {
+          boost::mutex::scoped_lock lock (mutex_);
+          configurationShooter_->shoot (q_rand);
+        }
+        PathPtr_t path, validPath;
+        PathValidationReportPtr_t report;
+        NodePtr_t reachedNodeFromStart;
+        ConfigurationPtr_t q_new;
+        bool pathValidFromStart (false);
+
+        // first try to connect to start component
+        NodePtr_t near (nearestNode (q_rand, startComponent_, false));
+        path = extendInternal (sm, qProj, near, q_rand);
+        if (path) {
+          pathValidFromStart = pathValidation->validate (path, false,
+                                                         validPath, report);
+          if (validPath &&
+              validPath->timeRange ().second != path->timeRange ().first) {
+            q_new = ConfigurationPtr_t (new Configuration_t
+                                        (validPath->end ()));
+            boost::mutex::scoped_lock lock (mutex_);
+            reachedNodeFromStart = roadmap ()->addNodeAndEdge
+              (near, q_new, validPath);
+          }
+        }
+
+        // now try to connect to end components
+        for (std::vector <ConnectedComponentPtr_t>::const_iterator itcc =
+               endComponents_.begin (); itcc != endComponents_.end ();
+             ++itcc) {
+          near = nearestNode (q_rand, *itcc, true);
+          path = extendInternal (sm, qProj, near, q_rand, true);
+          if (!path) continue;
+          if (pathValidation->validate (path, true, validPath, report) &&
+              pathValidFromStart && reachedNodeFromStart) {
+            // we won, a path is found
+            boost::mutex::scoped_lock lock (mutex_);
+            roadmap ()->addEdge (reachedNodeFromStart, near, validPath);
+            return;
+          } else if (validPath && validPath->timeRange ().second !=
+                     path->timeRange ().first) {
+            ConfigurationPtr_t q_newEnd (new Configuration_t
+                                         (validPath->initial ()));
+            NodePtr_t newNode;
+            {
+              boost::mutex::scoped_lock lock (mutex_);
+              newNode = roadmap ()->addNodeAndEdge (q_newEnd, near,
+                                                    validPath);
+            }
+            // now try to connect both nodes
+            if (reachedNodeFromStart) {
+              path = (*sm) (*q_new, *q_newEnd);
+              if (path && pathValidation->validate (path, false, validPath,
+                                                    report)) {
+                boost::mutex::scoped_lock lock (mutex_);
+                roadmap ()->addEdge (reachedNodeFromStart, newNode, path);
+                return;
+              }
+            }
+          }
+        }
+      }
+
+      ParallelBiRRT::ParallelBiRRT (const Problem& problem) :
+        BiRRTPlanner (problem), numberWorkers_ (1),
+        concurrentSearches_ (false)
+      {
+      }
+
+      ParallelBiRRT::ParallelBiRRT (const Problem& problem,
+                                    const RoadmapPtr_t& roadmap) :
+        BiRRTPlanner (problem, roadmap), numberWorkers_ (1),
+        concurrentSearches_ (false)
+      {
+      }
+
+      void ParallelBiRRT::init (const ParallelBiRRTWkPtr_t& weak)
+      {
+        BiRRTPlanner::init (weak);
+        weak_ = weak;
+      }
+    } // namespace pathPlanner
+  } // namespace core
+} // namespace hpp
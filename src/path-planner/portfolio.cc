@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/path-planner/portfolio.hh>
+
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/core/config-projector.hh>
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/deadline.hh>
+#include <hpp/core/problem.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathPlanner {
+      PortfolioPtr_t Portfolio::create (const Problem& problem)
+      {
+        PortfolioPtr_t shPtr (new Portfolio (problem));
+        shPtr->init (shPtr);
+        return shPtr;
+      }
+
+      PortfolioPtr_t Portfolio::createWithRoadmap
+      (const Problem& problem, const RoadmapPtr_t& roadmap)
+      {
+        PortfolioPtr_t shPtr (new Portfolio (problem, roadmap));
+        shPtr->init (shPtr);
+        return shPtr;
+      }
+
+      void Portfolio::addPlanner (const PathPlannerPtr_t& planner)
+      {
+        if (!planner)
+          throw std::invalid_argument ("Cannot add a null planner to the "
+                                       "portfolio.");
+        if (&planner->problem () != &problem ())
+          throw std::invalid_argument ("The planners of a portfolio must "
+                                       "solve the same problem.");
+        planners_.push_back (planner);
+      }
+
+      PathVectorPtr_t Portfolio::solve ()
+      {
+        namespace bpt = boost::posix_time;
+
+        if (planners_.empty ())
+          throw std::logic_error ("The portfolio contains no planner.");
+        if (planners_.size () > 1 && problem ().constraints () &&
+            problem ().constraints ()->configProjector ())
+          throw std::runtime_error ("The planners of a portfolio cannot "
+                                    "share a config projector.");
+        result_.reset ();
+        errors_.assign (planners_.size (), std::string ());
+        interrupted_ = false;
+        // The planners share the deadline of the portfolio.
+        Deadline::Scope scope (problem ().deadline (), timeOut ());
+        for (std::size_t i = 0; i < planners_.size (); ++i) {
+          planners_ [i]->maxIterations (maxIterations ());
+          planners_ [i]->timeOut (timeOut ());
+        }
+
+        std::vector <boost::shared_ptr <boost::thread> > threads;
+        for (std::size_t i = 0; i < planners_.size (); ++i) {
+          threads.push_back (boost::shared_ptr <boost::thread>
+                             (new boost::thread
+                              (boost::bind (&Portfolio::run, this, i))));
+        }
+        // PathPlanner::solve clears the interruption flag when it starts:
+        // interrupt again the planners that started after the end of the
+        // search.
+        for (std::size_t i = 0; i < threads.size (); ++i) {
+          while (!threads [i]->timed_join (bpt::milliseconds (10))) {
+            boost::mutex::scoped_lock lock (mutex_);
+            if (result_ || interrupted_) planners_ [i]->interrupt ();
+          }
+        }
+
+        if (result_) return result_;
+        if (interrupted_) throw std::runtime_error ("Interruption");
+        std::ostringstream oss;
+        oss << "No planner of the portfolio found a solution:";
+        for (std::size_t i = 0; i < errors_.size (); ++i)
+          oss << std::endl << "  planner " << i << ": " << errors_ [i];
+        throw std::runtime_error (oss.str ().c_str ());
+      }
+
+      void Portfolio::oneStep ()
+      {
+        throw std::logic_error ("The planners of a portfolio are run by "
+                                "Portfolio::solve.");
+      }
+
+      void Portfolio::interrupt ()
+      {
+        PathPlanner::interrupt ();
+        boost::mutex::scoped_lock lock (mutex_);
+        interrupted_ = true;
+        for (std::size_t i = 0; i < planners_.size (); ++i)
+          planners_ [i]->interrupt ();
+      }
+
+      void Portfolio::run (std::size_t i)
+      {
+        try {
+          PathVectorPtr_t path (planners_ [i]->solve ());
+          boost::mutex::scoped_lock lock (mutex_);
+          if (!path) {
+            errors_ [i] = "no path returned.";
+          } else if (!result_) {
+            result_ = path;
+            for (std::size_t j = 0; j < planners_.size (); ++j)
+              if (j != i) planners_ [j]->interrupt ();
+          }
+        } catch (const std::exception& exc) {
+          boost::mutex::scoped_lock lock (mutex_);
+          errors_ [i] = exc.what ();
+        }
+      }
+
+      Portfolio::Portfolio (const Problem& problem) :
+        PathPlanner (problem), interrupted_ (false)
+      {
+      }
+
+      Portfolio::Portfolio (const Problem& problem,
+                            const RoadmapPtr_t& roadmap) :
+        PathPlanner (problem, roadmap), interrupted_ (false)
+      {
+      }
+
+      void Portfolio::init (const PortfolioWkPtr_t& weak)
+      {
+        PathPlanner::init (weak);
+        weak_ = weak;
+      }
+    } // namespace pathPlanner
+  } // namespace core
+} // namespace hpp
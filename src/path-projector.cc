@@ -19,10 +19,15 @@
 #include <hpp/util/pointer.hh>
 #include <hpp/util/timer.hh>
 
+#include <hpp/core/config-projector.hh>
+#include <hpp/core/constraint-set.hh>
 #include <hpp/core/path-vector.hh>
 #include <hpp/core/distance.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/steering-method.hh>
+#include <hpp/core/straight-path.hh>
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/trace.hh>
 
 namespace hpp {
   namespace core {
@@ -34,7 +39,7 @@ namespace hpp {
 				  const SteeringMethodPtr_t& steeringMethod,
 				  bool keepSteeringMethodConstraints) :
       steeringMethod_ (steeringMethod->copy ()),
-      distance_ (distance)
+      distance_ (distance), memorySize_ (0)
     {
       assert (distance_ != NULL);
       assert (steeringMethod_ != NULL);
@@ -66,10 +71,57 @@ namespace hpp {
     bool PathProjector::apply (const PathPtr_t& path,
 			       PathPtr_t& proj) const
     {
+      HPP_CORE_TRACE_SPAN ("PathProjector::apply");
+      HPP_CORE_ALLOCATION_SCOPE (PROJECTION);
       HPP_START_TIMECOUNTER (PathProjection);
-      bool ret = impl_apply (path, proj);
+      Memo memo;
+      if (memorySize_ == 0 || !memoKey (path, memo)) {
+        bool ret = impl_apply (path, proj);
+        HPP_STOP_TIMECOUNTER (PathProjection);
+        return ret;
+      }
+      for (std::list <Memo>::iterator it = memory_.begin ();
+           it != memory_.end (); ++it) {
+        if (it->length == memo.length && it->initial == memo.initial &&
+            it->end == memo.end && it->constraints == memo.constraints &&
+            it->rightHandSide == memo.rightHandSide) {
+          memory_.splice (memory_.begin (), memory_, it);
+          proj = memory_.front ().projection->copy ();
+          HPP_STOP_TIMECOUNTER (PathProjection);
+          return memory_.front ().success;
+        }
+      }
+      memo.success = impl_apply (path, proj);
       HPP_STOP_TIMECOUNTER (PathProjection);
-      return ret;
+      // A projection interrupted by the deadline may succeed later.
+      if (!proj || (!memo.success && expired ())) return memo.success;
+      memo.projection = proj->copy ();
+      memory_.push_front (memo);
+      if ((size_type) memory_.size () > memorySize_) memory_.pop_back ();
+      return memo.success;
+    }
+
+    bool PathProjector::memoKey (const PathPtr_t& path, Memo& memo) const
+    {
+      // Other paths are not determined by their end configurations.
+      if (!HPP_DYNAMIC_PTR_CAST (StraightPath, path) ||
+          path->timeParameterization ())
+        return false;
+      memo.initial = path->initial ();
+      memo.end = path->end ();
+      memo.length = path->length ();
+      const ConstraintSetPtr_t& constraints (path->constraints ());
+      if (!constraints) return true;
+      ConfigProjectorPtr_t cp (constraints->configProjector ());
+      // Only the constraints of the config projector are compared.
+      for (Constraints_t::iterator it = constraints->begin ();
+           it != constraints->end (); ++it) {
+        if (*it != cp) return false;
+      }
+      if (!cp) return true;
+      memo.constraints = cp->numericalConstraints ();
+      memo.rightHandSide = cp->rightHandSide ();
+      return true;
     }
 
     // ----------- Declare parameters ------------------------------------- //
@@ -83,6 +135,10 @@ namespace hpp {
           "PathProjection/MinimalDist",
           "The threshold which stops the projection (distance between consecutive interpolation points.)",
           Parameter(1e-3)));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "PathProjection/Progressive/MaxStep",
+          "Maximal step of pathProjector::Progressive, which then adapts its step. Not considered if negative.",
+          Parameter(-1.)));
     Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
           "PathProjection/RecursiveHermite/Beta",
           "See \"Fast Interpolation and Time-Optimization on Implicit Contact Submanifolds\" from Kris Hauser.",
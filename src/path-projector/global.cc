@@ -16,6 +16,9 @@
 
 #include "hpp/core/path-projector/global.hh"
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <hpp/util/debug.hh>
 #include <hpp/util/timer.hh>
 
@@ -71,7 +74,7 @@ namespace hpp {
                                 value_type hessianBound) :
         PathProjector (distance, steeringMethod), step_ (step),
         hessianBound_ (hessianBound),
-        thresholdMin_ (threshold)
+        thresholdMin_ (threshold), numberThreads_ (1)
       {
         // TODO Only steeringMethod::Straight has been tested so far.
         assert (HPP_DYNAMIC_PTR_CAST(hpp::core::steeringMethod::Straight, steeringMethod));
@@ -134,6 +137,7 @@ namespace hpp {
         assert ((cfgs.back () - path->end ()).isZero ());
         HPP_STOP_AND_DISPLAY_TIMECOUNTER(globalPathProjector_initCfgList);
 
+        const ConfigProjectors_t projectors (threadProjectors (p));
         Bools_t projected (cfgs.size () - 2, false);
         Alphas_t alphas   (cfgs.size () - 2, LineSearch_t());
         Lengths_t lengths (cfgs.size () - 1, 0);
@@ -145,7 +149,8 @@ namespace hpp {
           2 + (std::size_t)(10 * path->length() / step_);
 
         hppDout (info, "start with " << cfgs.size () << " configs");
-        while (!projectOneStep (p, cfgs, last, projected, lengths, alphas)) {
+        while (!projectOneStep (p, projectors, cfgs, last, projected, lengths,
+                                alphas)) {
           assert ((cfgs.back () - path->end ()).isZero ());
           if (cfgs.size() < maxCfgNum) {
             const size_type newCs =
@@ -163,7 +168,7 @@ namespace hpp {
 
           nbIter++;
 
-          if (nbIter > maxIter) break;
+          if (nbIter > maxIter || expired ()) break;
         }
         HPP_DISPLAY_TIMECOUNTER(globalPathProjector_projOneStep);
         HPP_DISPLAY_TIMECOUNTER(globalPathProjector_reinterpolate);
@@ -204,6 +209,7 @@ namespace hpp {
         assert ((datas.back().q - path->end ()).isZero ());
         HPP_STOP_AND_DISPLAY_TIMECOUNTER(globalPathProjector_initCfgList);
 
+        const ConfigProjectors_t projectors (threadProjectors (p));
         std::size_t nbIter = 0;
         const std::size_t maxIter = 2 * p.maxIterations ();
         const std::size_t maxCfgNum =
@@ -212,7 +218,7 @@ namespace hpp {
         hppDout (info, "start with " << datas.size () << " configs");
         bool repeat = true;
         while (repeat) {
-          repeat = !projectOneStep (p, datas, last);
+          repeat = !projectOneStep (p, projectors, datas, last);
           assert ((datas.back().q - path->end ()).isZero ());
           if (datas.size() < maxCfgNum || !repeat) {
             const size_type newCs = reinterpolate (p.robot(), p, datas, last);
@@ -230,7 +236,7 @@ namespace hpp {
           nbIter++;
 
           assert (datas.size() >= 2);
-          if (nbIter > maxIter) break;
+          if (nbIter > maxIter || expired ()) break;
         }
         HPP_DISPLAY_TIMECOUNTER(globalPathProjector_projOneStep);
         HPP_DISPLAY_TIMECOUNTER(globalPathProjector_reinterpolate);
@@ -242,7 +248,50 @@ namespace hpp {
         return ret;
       }
 
+      Global::ConfigProjectors_t Global::threadProjectors
+      (const ConfigProjector& p) const
+      {
+        ConfigProjectors_t projectors;
+        for (size_type i = 1; i < numberThreads_; ++i)
+          projectors.push_back (HPP_STATIC_PTR_CAST (ConfigProjector,
+                                                     p.copy ()));
+        return projectors;
+      }
+
+      void Global::oneStep (ConfigProjector& p,
+          const ConfigProjectors_t& projectors, Steps_t& steps) const
+      {
+        const size_type nThreads
+          (std::min ((size_type) projectors.size () + 1,
+                     (size_type) steps.size ()));
+        if (nThreads <= 1) {
+          oneStepRange (p, steps, 0, 1);
+          return;
+        }
+        boost::thread_group threads;
+        for (size_type t = 1; t < nThreads; ++t) {
+          threads.create_thread
+            (boost::bind (&Global::oneStepRange, this,
+                          boost::ref (*projectors [t-1]), boost::ref (steps),
+                          t, nThreads));
+        }
+        oneStepRange (p, steps, 0, nThreads);
+        threads.join_all ();
+      }
+
+      void Global::oneStepRange (ConfigProjector& p, Steps_t& steps,
+          size_type begin, size_type stride) const
+      {
+        for (size_type i = begin; i < (size_type) steps.size (); i += stride) {
+          Step& s (steps [i]);
+          s.satisfied = p.solver().oneStep (s.q, s.alpha);
+          s.dq = p.solver().lastStep();
+          s.sigma = p.sigma();
+        }
+      }
+
       bool Global::projectOneStep (ConfigProjector& p,
+          const ConfigProjectors_t& projectors,
           Configs_t& q, Configs_t::iterator& last,
           Bools_t& b, Lengths_t& l, Alphas_t& a) const
       {
@@ -250,6 +299,21 @@ namespace hpp {
         /// First and last should not be updated
         const Configs_t::iterator begin = ++(q.begin ());
         const Configs_t::iterator end   = --(q.end ());
+        // Compute the steps of the configurations that are not projected.
+        // They are applied by the loop below, that may stop before the end.
+        Steps_t steps;
+        {
+          Bools_t ::iterator itB (b.begin ());
+          Alphas_t::iterator itA (a.begin ());
+          for (Configs_t::iterator it = begin; it != last; ++it, ++itB, ++itA) {
+            if (*itB) continue;
+            steps.push_back (Step ());
+            steps.back ().q = *it;
+            steps.back ().alpha = *itA;
+          }
+        }
+        oneStep (p, projectors, steps);
+        Steps_t::const_iterator itS (steps.begin ());
         Bools_t  ::iterator itB   =   (b.begin ());
         Alphas_t ::iterator itA   =   (a.begin ());
         Lengths_t::iterator itL   =   (l.begin ());
@@ -268,8 +332,11 @@ namespace hpp {
         for (Configs_t::iterator it = begin; it != last; ++it) {
           if (!*itB) {
             oldQ.col(iCol) = *it;
-            *itB = p.solver().oneStep (*it, *itA);
-            dq.col(iCol) = p.solver().lastStep();
+            *it = itS->q;
+            *itA = itS->alpha;
+            *itB = itS->satisfied;
+            dq.col(iCol) = itS->dq;
+            ++itS;
             // *itA = alphaMax - 0.8 * (alphaMax - *itA);
             allAreSatisfied = allAreSatisfied && *itB;
             curUpdated = true;
@@ -318,6 +385,7 @@ namespace hpp {
           curUpdated = false;
           ++itCp;
           ++itB;
+          ++itA;
           ++itL;
         }
         if (prevUpdated)
@@ -327,6 +395,7 @@ namespace hpp {
       }
 
       bool Global::projectOneStep (ConfigProjector& p,
+          const ConfigProjectors_t& projectors,
           Datas_t& ds, const Datas_t::iterator& last) const
       {
         HPP_START_TIMECOUNTER(globalPathProjector_projOneStep);
@@ -335,11 +404,23 @@ namespace hpp {
         bool allAreSatisfied = true;
         bool curUpdated = false, prevUpdated = false;
 
+        Steps_t steps;
+        for (Datas_t::iterator it = _d; it != last; ++it) {
+          if (it->projected) continue;
+          steps.push_back (Step ());
+          steps.back ().q = it->q;
+          steps.back ().alpha = it->alpha;
+        }
+        oneStep (p, projectors, steps);
+        Steps_t::const_iterator itS (steps.begin ());
+
         for (; _d != last; ++_d) {
           if (!_d->projected) {
-            _d->projected = p.solver().oneStep (_d->q, _d->alpha);
-            // dq_ = p.solver().lastStep();
-            _d->sigma = p.sigma();
+            _d->q = itS->q;
+            _d->alpha = itS->alpha;
+            _d->projected = itS->satisfied;
+            _d->sigma = itS->sigma;
+            ++itS;
             ++_d->Niter;
             allAreSatisfied = allAreSatisfied && _d->projected;
             curUpdated = true;
@@ -587,12 +668,8 @@ namespace hpp {
           HPP_DYNAMIC_PTR_CAST (InterpolatedPath, path);
         if (ip) {
           // Get the waypoint of ip
-          const InterpolatedPath::InterpolationPoints_t& ips =
-            ip->interpolationPoints();
-          for (InterpolatedPath::InterpolationPoints_t::const_iterator it =
-              ips.begin (); it != ips.end (); ++it) {
-            cfgs.push_back (it->second);
-          }
+          for (std::size_t i = 0; i < ip->numberInterpolationPoints (); ++i)
+            cfgs.push_back (ip->interpolationConfig (i));
         } else {
           const value_type L = path->length ();
           Configuration_t q (path->outputSize ());
@@ -623,15 +700,10 @@ namespace hpp {
           HPP_DYNAMIC_PTR_CAST (InterpolatedPath, path);
         if (ip) {
           // Get the waypoint of ip
-          const InterpolatedPath::InterpolationPoints_t& ips =
-            ip->interpolationPoints();
-          InterpolatedPath::InterpolationPoints_t::const_iterator _ipPrev
-            = ips.begin();
-          for (InterpolatedPath::InterpolationPoints_t::const_iterator
-              _ip = ++(ips.begin ()); _ip != ips.end (); ++_ip) {
-            initData(newD, _ip->second, p, true, false, _ipPrev->second);
+          for (std::size_t i = 1; i < ip->numberInterpolationPoints (); ++i) {
+            initData(newD, ip->interpolationConfig (i), p, true, false,
+                     ip->interpolationConfig (i-1));
             ds.push_back (newD);
-            ++_ipPrev;
           }
         } else {
           initData(newD, path->end(), p, true, true, path->initial());
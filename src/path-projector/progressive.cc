@@ -48,8 +48,11 @@ namespace hpp {
           .getParameter("PathProjection/MinimalDist").floatValue();
         hppDout (info, "Hessian bound is " << hessianBound);
         hppDout (info, "Min Dist is " << thr_min);
-        return ProgressivePtr_t (new Progressive (distance, steeringMethod,
+        ProgressivePtr_t res (new Progressive (distance, steeringMethod,
               step, thr_min, hessianBound));
+        res->maxStep (steeringMethod->problem()
+            .getParameter("PathProjection/Progressive/MaxStep").floatValue());
+        return res;
       }
 
       ProgressivePtr_t Progressive::create (const Problem& problem,
@@ -63,7 +66,8 @@ namespace hpp {
 				value_type step, value_type thresholdMin, value_type hessianBound) :
         PathProjector (distance, steeringMethod), step_ (step),
         thresholdMin_ (thresholdMin),
-        hessianBound_ (hessianBound), withHessianBound_ (hessianBound > 0)
+        hessianBound_ (hessianBound), withHessianBound_ (hessianBound > 0),
+        maxStep_ (-1)
       {
         SteeringMethodStraightPtr_t sm
           (HPP_DYNAMIC_PTR_CAST (steeringMethod::Straight, steeringMethod));
@@ -144,11 +148,14 @@ namespace hpp {
         value_type sigma = cp->sigma();
 
         value_type min = std::numeric_limits<value_type>::max(), max = 0;
+        const bool adaptive (!withHessianBound_ && maxStep_ > step_);
+        value_type step (step_);
 
         while (true) {
-          const value_type threshold = (withHessianBound_ ? sigma / K : step_);
+          const value_type threshold = (withHessianBound_ ? sigma / K : step);
           const value_type thr_min = thresholdMin_;
 
+          if (expired ()) break;
           if (toSplit->length () < threshold) {
             paths.push (toSplit);
             assert (constraints->isSatisfied (toSplit->initial ()));
@@ -169,10 +176,14 @@ namespace hpp {
           /// Find the good length.
           /// Here, it would be good to have an upper bound of the Hessian
           /// of the constraint.
+          bool oneIteration (false);
           do {
             if (dicC >= maxDichotomyTries) break;
             (*toSplit) (qi, curStep);
-            if (constraints->apply (qi))
+            if (adaptive)
+              oneIteration = cp->solver().oneStep (qi, lineSearch) &&
+                constraints->isSatisfied (qi);
+            if (oneIteration || constraints->apply (qi))
               curLength = d (qb, qi);
             curStep /= 2;
             dicC++;
@@ -183,6 +194,14 @@ namespace hpp {
 	  assert (curLength == d (qb, qi));
           assert (constraints->isSatisfied (qi));
 
+          if (adaptive) {
+            // Grow the step if the first try was projected in one iteration.
+            if (oneIteration && dicC == 1)
+              step = std::min (2 * step, maxStep_);
+            else
+              step = std::max (step / 2, step_);
+          }
+
           if (withHessianBound_) {
             /// Update sigma
             qtmp = qi;
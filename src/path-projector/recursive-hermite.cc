@@ -25,8 +25,7 @@
 #include <hpp/core/steering-method/hermite.hh>
 
 #include <limits>
-#include <queue>
-#include <stack>
+#include <vector>
 
 namespace hpp {
   namespace core {
@@ -125,15 +124,12 @@ namespace hpp {
         if (!p) {
           InterpolatedPathPtr_t ip = HPP_DYNAMIC_PTR_CAST(InterpolatedPath, path);
           if (ip) {
-            typedef InterpolatedPath::InterpolationPoints_t IPs_t;
-            const IPs_t& ips = ip->interpolationPoints();
-            ps.reserve(ips.size() - 1);
-            IPs_t::const_iterator _ip1 = ips.begin(); std::advance (_ip1, 1);
-            for (IPs_t::const_iterator _ip0 = ips.begin();
-                _ip1 != ips.end(); ++_ip0) {
+            const std::size_t n (ip->numberInterpolationPoints());
+            ps.reserve(n - 1);
+            for (std::size_t i = 1; i < n; ++i) {
               ps.push_back (HPP_DYNAMIC_PTR_CAST(Hermite,
-                    steer (_ip0->second, _ip1->second)));
-              ++_ip1;
+                    steer (ip->interpolationConfig (i-1),
+                           ip->interpolationConfig (i))));
             }
           } else {
             p = HPP_DYNAMIC_PTR_CAST(Hermite, steer (path->initial(), path->end()));
@@ -152,14 +148,9 @@ namespace hpp {
             res->appendPath (p);
             continue;
           }
-          PathVectorPtr_t r = PathVector::create (path->outputSize(),
-                                                  path->outputDerivativeSize());
-          std::cout << p->hermiteLength() 
-            << " / " << thr
-            << " : " << 
-            path->constraints()->name() << std::endl;
-          success = recurse (p, r, thr);
-          res->concatenate (r);
+          hppDout (info, p->hermiteLength() << " / " << thr << " : "
+                   << path->constraints()->name());
+          success = subdivide (p, res, thr);
           if (!success) break;
         }
 #if HPP_ENABLE_BENCHMARK
@@ -198,56 +189,72 @@ namespace hpp {
         return false;
       }
 
-      bool RecursiveHermite::recurse (const HermitePtr_t& path, PathVectorPtr_t& proj,
-          const value_type& acceptThr) const
+      bool RecursiveHermite::subdivide (const HermitePtr_t& path,
+          const PathVectorPtr_t& proj, const value_type& acceptThr) const
       {
-        if (path->hermiteLength() < acceptThr) {
-          // TODO this does not work because it is not possible to remove
-          // constraints from a path.
-          // proj->appendPath (path->copy (ConstraintSetPtr_t()));
-          proj->appendPath(path);
-          return true;
-        } else {
-          const value_type t = 0.5; //path->timeRange().first + path->length() / 2;
+        // A null piece means that the subdivision stops when it is reached.
+        std::vector<HermitePtr_t> stack;
+        stack.push_back (path);
+        vector_t v (path->outputDerivativeSize ());
+        while (!stack.empty ()) {
+          const HermitePtr_t p (stack.back ());
+          stack.pop_back ();
+          if (!p) return false;
+          if (p->hermiteLength() < acceptThr) {
+            // TODO this does not work because it is not possible to remove
+            // constraints from a path.
+            // proj->appendPath (p->copy (ConstraintSetPtr_t()));
+            proj->appendPath(p);
+            continue;
+          }
+          const value_type t = 0.5; //p->timeRange().first + p->length() / 2;
           bool success;
-          const Configuration_t q1((*path) (t, success));
+          const Configuration_t q1((*p) (t, success));
           if (!success) {
             hppDout (info, "RHP stopped because it could not project a configuration");
             return false;
           }
-          const Configuration_t q0 = path->initial ();
-          const Configuration_t q2 = path->end ();
+          const Configuration_t q0 = p->initial ();
+          const Configuration_t q2 = p->end ();
           // Velocities must be divided by two because each half is rescale
           // from [0, 0.5] to [0, 1]
-          const vector_t vHalf = path->velocity (t) / 2;
+          const vector_t vHalf = p->velocity (t) / 2;
+          // The outer legs of the control polygons of the halves are the
+          // halves of the outer legs of p and the vHalf / 3 leg they share.
+          const value_type halfLeg (vHalf.norm () / 3);
+          const Hermite::parent_t::ParameterMatrix_t& P
+            (p->parameters ());
 
           HermitePtr_t left = HPP_DYNAMIC_PTR_CAST(Hermite, steer (q0, q1));
           if (!left) throw std::runtime_error ("Not an path::Hermite");
-          left->v0 (path->v0() / 2);
+          v.transpose () = 1.5 * (P.row (1) - P.row (0));
+          left->v0 (v);
           left->v1 (vHalf);
-          left->computeHermiteLength();
+          left->computeHermiteLength (p->legLength (0) / 2, halfLeg);
 
           HermitePtr_t right = HPP_DYNAMIC_PTR_CAST(Hermite, steer (q1, q2));
           if (!right) throw std::runtime_error ("Not an path::Hermite");
+          v.transpose () = 1.5 * (P.row (3) - P.row (2));
           right->v0 (vHalf);
-          right->v1 (path->v1() / 2);
-          right->computeHermiteLength();
+          right->v1 (v);
+          right->computeHermiteLength (halfLeg, p->legLength (2) / 2);
 
-          const value_type stopThr = beta_ * path->hermiteLength();
+          const value_type stopThr = beta_ * p->hermiteLength();
           bool lStop = ( left ->hermiteLength() > stopThr );
           bool rStop = ( right->hermiteLength() > stopThr );
-          bool stop = rStop || lStop;
           // This is the inverse of the condition in the RSS paper. Is there a typo in the paper ?
-          // if (std::max (left->hermiteLength(), right->hermiteLength()) > beta * path->hermiteLength()) {
-          if (stop) {
-            hppDout (info, "RHP stopped: " << path->hermiteLength() << " * " << beta_ << " -> " <<
+          // if (std::max (left->hermiteLength(), right->hermiteLength()) > beta * p->hermiteLength()) {
+          if (lStop || rStop) {
+            hppDout (info, "RHP stopped: " << p->hermiteLength() << " * " << beta_ << " -> " <<
                 left->hermiteLength() << " / " << right->hermiteLength());
           }
-          if (lStop || !recurse (left , proj, acceptThr)) return false;
-          if ( stop || !recurse (right, proj, acceptThr)) return false;
-
-          return true;
+          if (lStop) return false;
+          // The left half is processed first. The subdivision stops after
+          // it if the right half does not shrink enough.
+          stack.push_back (rStop ? HermitePtr_t () : right);
+          stack.push_back (left);
         }
+        return true;
       }
     } // namespace pathProjector
   } // namespace core
@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/path-sampler.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <hpp/core/config-projector.hh>
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/time-parameterization/piecewise-polynomial.hh>
+#include <hpp/core/time-parameterization/polynomial.hh>
+
+namespace hpp {
+  namespace core {
+    namespace {
+      /// Whether a time is before the start of a knot
+      struct StartsAfter
+      {
+        template <typename Knot>
+        bool operator() (const value_type& time, const Knot& knot) const
+        {
+          return time < knot.start;
+        }
+      }; // struct StartsAfter
+
+      /// Index of the polynomial of a piecewise polynomial defined at time
+      size_type segment (const vector_t& breakpoints, const value_type& time)
+      {
+        const value_type* begin = breakpoints.data() + 1;
+        const value_type* end = breakpoints.data() + breakpoints.size() - 1;
+        return std::upper_bound (begin, end, time) - begin;
+      }
+    } // namespace
+
+    PathSampler::PathSampler (const PathPtr_t& path) :
+      timeRange_ (path->timeRange ()), elements_ (), knots_ (),
+      coefficients_ (), cursor_ (0)
+    {
+      PathVectorPtr_t pv (HPP_DYNAMIC_PTR_CAST (PathVector, path));
+      if (pv) {
+        PathVectorPtr_t flat (PathVector::create
+                              (pv->outputSize (),
+                               pv->outputDerivativeSize ()));
+        pv->flatten (flat);
+        value_type start (timeRange_.first);
+        for (std::size_t i = 0; i < flat->numberPaths (); ++i) {
+          const PathPtr_t& element (flat->pathAtRank (i));
+          bake (element, start);
+          start += element->length ();
+        }
+      } else {
+        bake (path, timeRange_.first);
+      }
+      if (knots_.empty ())
+        throw std::invalid_argument ("PathSampler: the path is empty.");
+    }
+
+    void PathSampler::bake (const PathPtr_t& element, const value_type& start)
+    {
+      if (element->constraints () &&
+          element->constraints ()->configProjector ())
+        throw std::invalid_argument ("PathSampler: the constraints of the "
+                                     "paths are not applied, project the "
+                                     "path before sampling it.");
+      const interval_t& range (element->timeRange ());
+      // Time of the path at which the time of the element is zero
+      const value_type shift (start - range.first);
+      Knot knot;
+      knot.start = start;
+      knot.origin = shift;
+      knot.element = elements_.size ();
+      knot.begin = coefficients_.size ();
+      elements_.push_back (element);
+
+      const TimeParameterizationPtr_t& tp (element->timeParameterization ());
+      if (!tp) {
+        knot.size = 2;
+        coefficients_.push_back (0);
+        coefficients_.push_back (1);
+        knots_.push_back (knot);
+        return;
+      }
+      const timeParameterization::Polynomial* polynomial
+        (dynamic_cast <const timeParameterization::Polynomial*> (tp.get ()));
+      if (polynomial) {
+        const vector_t& a (polynomial->parameters ());
+        knot.size = (std::size_t) a.size ();
+        coefficients_.insert (coefficients_.end (), a.data (),
+                              a.data () + a.size ());
+        knots_.push_back (knot);
+        return;
+      }
+      const timeParameterization::PiecewisePolynomial* piecewise
+        (dynamic_cast <const timeParameterization::PiecewisePolynomial*>
+         (tp.get ()));
+      if (!piecewise)
+        throw std::invalid_argument ("PathSampler: only polynomial and "
+                                     "piecewise polynomial time "
+                                     "parameterizations can be baked.");
+      const matrix_t& a (piecewise->parameters ());
+      const vector_t& t (piecewise->breakpoints ());
+      const size_type first (segment (t, range.first)),
+        last (segment (t, range.second));
+      for (size_type i = first; i <= last; ++i) {
+        knot.start = start + (i == first ? 0 : t [i] - range.first);
+        knot.origin = shift + t [i];
+        knot.begin = coefficients_.size ();
+        knot.size = (std::size_t) a.rows ();
+        for (size_type j = 0; j < a.rows (); ++j)
+          coefficients_.push_back (a (j, i));
+        knots_.push_back (knot);
+      }
+    }
+
+    std::size_t PathSampler::knot (const value_type& time)
+    {
+      std::size_t k (cursor_);
+      if (time < knots_ [k].start) {
+        k = std::upper_bound (knots_.begin (), knots_.end (), time,
+                              StartsAfter ()) - knots_.begin ();
+        if (k > 0) --k;
+      }
+      while (k + 1 < knots_.size () && knots_ [k + 1].start <= time) ++k;
+      cursor_ = k;
+      return k;
+    }
+
+    value_type PathSampler::parameter (const Knot& knot,
+                                       const value_type& time,
+                                       value_type& derivative) const
+    {
+      const value_type dt (time - knot.origin);
+      const value_type* a (&coefficients_ [knot.begin]);
+      value_type s (0);
+      derivative = 0;
+      for (std::size_t j = knot.size; j-- > 0;) {
+        derivative = derivative * dt + s;
+        s = s * dt + a [j];
+      }
+      const interval_t& range (elements_ [knot.element]->paramRange ());
+      return std::min (std::max (s, range.first), range.second);
+    }
+
+    bool PathSampler::operator() (const value_type& time,
+                                  ConfigurationOut_t result)
+    {
+      const value_type t (std::min (std::max (time, timeRange_.first),
+                                    timeRange_.second));
+      const Knot& k (knots_ [knot (t)]);
+      value_type ds;
+      const value_type s (parameter (k, t, ds));
+      return elements_ [k.element]->impl_compute (result, s);
+    }
+
+    void PathSampler::velocity (const value_type& time, vectorOut_t result)
+    {
+      const value_type t (std::min (std::max (time, timeRange_.first),
+                                    timeRange_.second));
+      const Knot& k (knots_ [knot (t)]);
+      value_type ds;
+      const value_type s (parameter (k, t, ds));
+      elements_ [k.element]->impl_derivative (result, s, 1);
+      result *= ds;
+    }
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/path-validation/adaptive-discretized.hh>
+
+#include <cmath>
+#include <vector>
+
+#include <hpp/core/collision-path-validation-report.hh>
+#include <hpp/core/path.hh>
+#include <hpp/core/projection-error.hh>
+#include <hpp/util/debug.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathValidation {
+    namespace {
+      /// Reverse the order of the first bits of an integer
+      size_type reverseBits (size_type i, size_type nbBits)
+      {
+        size_type res = 0;
+        for (size_type b = 0; b < nbBits; ++b) {
+          res = (res << 1) | (i & 1);
+          i >>= 1;
+        }
+        return res;
+      }
+    } // namespace
+
+    AdaptiveDiscretizedPtr_t
+    AdaptiveDiscretized::create (const value_type& stepSize)
+    {
+      AdaptiveDiscretized* ptr = new AdaptiveDiscretized(stepSize);
+      return AdaptiveDiscretizedPtr_t (ptr);
+    }
+
+    bool AdaptiveDiscretized::validateSample
+    (const PathPtr_t& path, const value_type& t, bool skip,
+     const std::vector <ConfigValidationPtr_t>& validations,
+     Configuration_t& q, PathValidationReportPtr_t& report)
+    {
+      ValidationReportPtr_t configReport;
+      if (!(*path) (q, t)) {
+        report = PathValidationReportPtr_t
+          (new PathValidationReport
+           (t, ValidationReportPtr_t (new ProjectionError ())));
+        return false;
+      }
+      if (!validateConfiguration (q, skip, validations, configReport)) {
+        report = CollisionPathValidationReportPtr_t
+          (new CollisionPathValidationReport (t, configReport));
+        return false;
+      }
+      return true;
+    }
+
+    bool AdaptiveDiscretized::validate
+    (const PathPtr_t& path, bool reverse, PathPtr_t& validPart,
+     PathValidationReportPtr_t& validationReport)
+    {
+      hppDout(notice,"path validation, reverse : "<<reverse);
+      value_type lastValidTime;
+      if (validateOrdered (path, reverse, lastValidTime, validationReport)) {
+        validPart = path;
+        return true;
+      }
+      if (reverse)
+        validPart = path->extract (lastValidTime, path->timeRange ().second);
+      else
+        validPart = path->extract (path->timeRange ().first, lastValidTime);
+      return false;
+    }
+
+    bool AdaptiveDiscretized::isValid (const PathPtr_t& path, bool reverse,
+                                       value_type& lastValidTime)
+    {
+      PathValidationReportPtr_t report;
+      return validateOrdered (path, reverse, lastValidTime, report);
+    }
+
+    bool AdaptiveDiscretized::validateOrdered
+    (const PathPtr_t& path, bool reverse, value_type& lastValidTime,
+     PathValidationReportPtr_t& validationReport)
+    {
+      assert (path);
+      const value_type tmin = path->timeRange ().first;
+      const value_type tmax = path->timeRange ().second;
+      std::vector <ConfigValidationPtr_t> validations;
+      const bool skip (sampleValidations (path, validations));
+      if (skip && validations.empty ()) {
+        // Every configuration is known to be valid.
+        lastValidTime = reverse ? tmin : tmax;
+        return true;
+      }
+      // Samples are tmin + k * stepSize_ for k < n and tmax for k = n, as
+      // in Discretized, or mirrored if reverse.
+      const value_type T0 (reverse ? tmax : tmin);
+      const value_type T1 (reverse ? tmin : tmax);
+      const value_type step (reverse ? -stepSize_ : stepSize_);
+      const size_type n ((size_type) std::ceil ((tmax - tmin) / stepSize_));
+      Configuration_t q (path->outputSize());
+
+      std::vector <bool> tested ((std::size_t) n + 1, false);
+      size_type failed = n + 1;
+      // Test both ends, then the remaining samples in bisection order.
+      size_type nbBits = 0;
+      while (((size_type) 1 << nbBits) < n) ++nbBits;
+      const size_type m ((size_type) 1 << nbBits);
+      for (size_type i = -1; i < m; ++i) {
+        size_type k;
+        if (i == -1) k = 0;
+        else if (i == 0) k = n;
+        else k = (reverseBits (i, nbBits) * n + m / 2) / m;
+        if (tested [k]) continue;
+        tested [k] = true;
+        if (!validateSample (path, k == n ? T1 : T0 + (value_type) k * step,
+                             skip, validations, q, validationReport)) {
+          failed = k;
+          break;
+        }
+      }
+      if (failed > n) {
+        lastValidTime = T1;
+        return true;
+      }
+      // Find the first invalid sample.
+      for (size_type k = 0; k < failed; ++k) {
+        if (tested [k]) continue;
+        if (!validateSample (path, T0 + (value_type) k * step, skip,
+                             validations, q, validationReport)) {
+          failed = k;
+          break;
+        }
+      }
+      lastValidTime = failed == 0 ? T0 : T0 + (value_type) (failed - 1) * step;
+      return false;
+    }
+
+    AdaptiveDiscretized::AdaptiveDiscretized (const value_type& stepSize) :
+      Discretized (stepSize)
+    {
+    }
+
+    } // namespace pathValidation
+  } // namespace core
+} // namespace hpp
@@ -0,0 +1,326 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/path-validation/cached.hh>
+
+#include <list>
+#include <stdexcept>
+#include <typeinfo>
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <hpp/core/path.hh>
+#include <hpp/core/straight-path.hh>
+
+namespace hpp {
+  namespace core {
+    namespace pathValidation {
+      /// Least recently used results of the validation
+      struct Cached::Cache
+      {
+        struct Key
+        {
+          const std::type_info* type;
+          /// Null for straight paths, identified by their configurations
+          const Path* identity;
+          const ConstraintSet* constraints;
+          bool reverse;
+          interval_t range;
+          Configuration_t initial, end;
+        }; // struct Key
+        struct Entry
+        {
+          Key key;
+          /// Tells whether the path identified by key.identity still exists
+          PathWkPtr_t path;
+          /// Keeps the constraints of the key alive
+          ConstraintSetPtr_t constraints;
+          Result result;
+        }; // struct Entry
+        struct Hash
+        {
+          std::size_t operator() (const Key& key) const
+          {
+            std::size_t seed (0);
+            boost::hash_combine (seed, key.type);
+            boost::hash_combine (seed, key.identity);
+            boost::hash_combine (seed, key.constraints);
+            boost::hash_combine (seed, key.reverse);
+            boost::hash_combine (seed, key.range.first);
+            boost::hash_combine (seed, key.range.second);
+            boost::hash_range (seed, key.initial.data (),
+                               key.initial.data () + key.initial.size ());
+            boost::hash_range (seed, key.end.data (),
+                               key.end.data () + key.end.size ());
+            return seed;
+          }
+        }; // struct Hash
+        struct Equal
+        {
+          bool operator() (const Key& a, const Key& b) const
+          {
+            return a.type == b.type && a.identity == b.identity &&
+              a.constraints == b.constraints && a.reverse == b.reverse &&
+              a.range == b.range &&
+              a.initial.size () == b.initial.size () &&
+              a.initial == b.initial && a.end.size () == b.end.size () &&
+              a.end == b.end;
+          }
+        }; // struct Equal
+        /// Entries from the most to the least recently used
+        typedef std::list <Entry> Entries_t;
+        typedef boost::unordered_map <Key, Entries_t::iterator, Hash, Equal>
+          Map_t;
+
+        static Key key (const PathPtr_t& path, bool reverse)
+        {
+          Key result;
+          const Path& p (*path);
+          result.type = &typeid (p);
+          result.constraints = path->constraints ().get ();
+          result.reverse = reverse;
+          result.range = path->timeRange ();
+          // Other paths are not determined by their end configurations.
+          if (HPP_DYNAMIC_PTR_CAST (StraightPath, path) &&
+              !path->timeParameterization ()) {
+            result.identity = 0x0;
+            result.initial = path->initial ();
+            result.end = path->end ();
+          } else {
+            result.identity = path.get ();
+          }
+          return result;
+        }
+
+        Entries_t entries;
+        Map_t map;
+      }; // struct Cache
+
+      CachedPtr_t Cached::create (const PathValidationPtr_t& validation,
+                                  size_type cacheSize)
+      {
+        if (cacheSize < 1)
+          throw std::invalid_argument ("The size of the cache of path "
+                                       "validations should be positive.");
+        return CachedPtr_t (new Cached (validation, cacheSize));
+      }
+
+      Cached::Cached (const PathValidationPtr_t& validation,
+                      size_type cacheSize) :
+        validation_ (validation), cacheSize_ (cacheSize), cacheHits_ (0),
+        cacheMisses_ (0), cache_ (new Cache)
+      {
+      }
+
+      bool Cached::find (const PathPtr_t& path, bool reverse, Result& result)
+      {
+        const Cache::Key key (Cache::key (path, reverse));
+        Cache::Map_t::iterator found (cache_->map.find (key));
+        if (found != cache_->map.end () && key.identity &&
+            found->second->path.expired ()) {
+          // Another path was allocated at the address of a destroyed one.
+          cache_->entries.erase (found->second);
+          cache_->map.erase (found);
+          found = cache_->map.end ();
+        }
+        if (found == cache_->map.end ()) {
+          ++cacheMisses_;
+          return false;
+        }
+        ++cacheHits_;
+        cache_->entries.splice (cache_->entries.begin (), cache_->entries,
+                                found->second);
+        result = found->second->result;
+        return true;
+      }
+
+      void Cached::insert (const PathPtr_t& path, bool reverse,
+                           const Result& result)
+      {
+        // Interrupted validations do not tell whether the path is valid.
+        if (expired ()) return;
+        Cache::Entry entry;
+        entry.key = Cache::key (path, reverse);
+        if (cache_->map.find (entry.key) != cache_->map.end ()) return;
+        entry.path = path;
+        entry.constraints = path->constraints ();
+        entry.result = result;
+        cache_->entries.push_front (entry);
+        cache_->map [entry.key] = cache_->entries.begin ();
+        while ((size_type) cache_->map.size () > cacheSize_) {
+          cache_->map.erase (cache_->entries.back ().key);
+          cache_->entries.pop_back ();
+        }
+      }
+
+      PathPtr_t Cached::validPart (const PathPtr_t& path, bool reverse,
+                                   const Result& result)
+      {
+        if (result.valid) return path;
+        if (reverse)
+          return path->extract (result.lastValidTime, path->timeRange ().second);
+        return path->extract (path->timeRange ().first, result.lastValidTime);
+      }
+
+      bool Cached::validate (const PathPtr_t& path, bool reverse,
+                             PathPtr_t& validPart,
+                             PathValidationReportPtr_t& report)
+      {
+        Result result;
+        if (find (path, reverse, result)) {
+          validPart = Cached::validPart (path, reverse, result);
+          report = result.report;
+          return result.valid;
+        }
+        result.valid = validation_->validate (path, reverse, validPart,
+                                              report);
+        if (validPart) {
+          const interval_t& tr (path->timeRange ());
+          result.lastValidTime = reverse ? tr.second - validPart->length () :
+            tr.first + validPart->length ();
+          result.report = report;
+          insert (path, reverse, result);
+        }
+        return result.valid;
+      }
+
+      bool Cached::isValid (const PathPtr_t& path, bool reverse,
+                            value_type& lastValidTime)
+      {
+        Result result;
+        if (find (path, reverse, result)) {
+          lastValidTime = result.lastValidTime;
+          return result.valid;
+        }
+        result.valid = validation_->isValid (path, reverse, lastValidTime);
+        // Invalid paths are stored by validate only, that builds a report.
+        if (result.valid) {
+          result.lastValidTime = lastValidTime;
+          insert (path, reverse, result);
+        }
+        return result.valid;
+      }
+
+      bool Cached::validatePaths
+      (const std::vector <PathPtr_t>& paths, bool reverse,
+       std::vector <PathPtr_t>& validParts,
+       std::vector <PathValidationReportPtr_t>& reports,
+       std::vector <bool>& valid, bool stopAtFirstInvalid)
+      {
+        validParts.assign (paths.size (), PathPtr_t ());
+        reports.assign (paths.size (), PathValidationReportPtr_t ());
+        valid.assign (paths.size (), false);
+        bool result (true);
+        std::vector <PathPtr_t> missing;
+        std::vector <std::size_t> indices;
+        for (std::size_t i = 0; i < paths.size (); ++i) {
+          Result r;
+          if (!find (paths [i], reverse, r)) {
+            missing.push_back (paths [i]);
+            indices.push_back (i);
+            continue;
+          }
+          valid [i] = r.valid;
+          validParts [i] = validPart (paths [i], reverse, r);
+          reports [i] = r.report;
+          if (!r.valid) {
+            result = false;
+            // The missing paths are not validated.
+            if (stopAtFirstInvalid) return false;
+          }
+        }
+        if (missing.empty ()) return result;
+
+        std::vector <PathPtr_t> parts;
+        std::vector <PathValidationReportPtr_t> reps;
+        std::vector <bool> v;
+        if (!validation_->validatePaths (missing, reverse, parts, reps, v,
+                                         stopAtFirstInvalid))
+          result = false;
+        for (std::size_t k = 0; k < missing.size (); ++k) {
+          const std::size_t i (indices [k]);
+          valid [i] = v [k];
+          validParts [i] = parts [k];
+          reports [i] = reps [k];
+          // Paths that were not validated have no valid part.
+          if (!parts [k] || (!v [k] && !reps [k])) continue;
+          Result r;
+          r.valid = v [k];
+          const interval_t& tr (missing [k]->timeRange ());
+          r.lastValidTime = reverse ? tr.second - parts [k]->length () :
+            tr.first + parts [k]->length ();
+          r.report = reps [k];
+          insert (missing [k], reverse, r);
+        }
+        return result;
+      }
+
+      void Cached::deadline (const DeadlinePtr_t& deadline)
+      {
+        PathValidation::deadline (deadline);
+        validation_->deadline (deadline);
+      }
+
+      void Cached::clearCache ()
+      {
+        cache_->entries.clear ();
+        cache_->map.clear ();
+      }
+
+      ObstacleUserInterface* Cached::obstacleUser () const
+      {
+        return dynamic_cast <ObstacleUserInterface*> (validation_.get ());
+      }
+
+      void Cached::addObstacle (const CollisionObjectConstPtr_t& object)
+      {
+        clearCache ();
+        if (obstacleUser ()) obstacleUser ()->addObstacle (object);
+      }
+
+      void Cached::removeObstacleFromJoint
+      (const JointPtr_t& joint, const CollisionObjectConstPtr_t& obstacle)
+      {
+        clearCache ();
+        if (obstacleUser ())
+          obstacleUser ()->removeObstacleFromJoint (joint, obstacle);
+      }
+
+      void Cached::updateObstacle (const CollisionObjectConstPtr_t& object)
+      {
+        clearCache ();
+        if (obstacleUser ()) obstacleUser ()->updateObstacle (object);
+      }
+
+      void Cached::filterCollisionPairs
+      (const RelativeMotion::matrix_type& relMotion)
+      {
+        clearCache ();
+        if (obstacleUser ()) obstacleUser ()->filterCollisionPairs (relMotion);
+      }
+
+      void Cached::setSecurityMargins (const matrix_t& securityMatrix)
+      {
+        clearCache ();
+        if (obstacleUser ())
+          obstacleUser ()->setSecurityMargins (securityMatrix);
+      }
+    } // namespace pathValidation
+  } // namespace core
+} // namespace hpp
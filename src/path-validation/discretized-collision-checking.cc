@@ -17,6 +17,7 @@
 // <http://www.gnu.org/licenses/>.
 
 #include <hpp/core/path-validation/discretized.hh>
+#include <hpp/core/path-validation/adaptive-discretized.hh>
 #include <hpp/core/path-validation/discretized-collision-checking.hh>
 #include <hpp/core/collision-validation.hh>
 
@@ -31,6 +32,15 @@ namespace hpp {
         pv->add (cv);
         return pv;
       }
+
+      DiscretizedPtr_t createAdaptiveDiscretizedCollisionChecking (
+          const DevicePtr_t& robot, const value_type& stepSize)
+      {
+        DiscretizedPtr_t pv (AdaptiveDiscretized::create (stepSize));
+        CollisionValidationPtr_t cv (CollisionValidation::create (robot));
+        pv->add (cv);
+        return pv;
+      }
     } // namespace pathValidation
   } // namespace core
 } // namespace hpp
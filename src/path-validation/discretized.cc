@@ -16,19 +16,38 @@
 // hpp-core  If not, see
 // <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <hpp/pinocchio/device.hh>
 #include <hpp/core/collision-path-validation-report.hh>
 #include <hpp/core/collision-validation.hh>
 #include <hpp/core/config-validations.hh>
+#include <hpp/core/deadline.hh>
 #include <hpp/core/path.hh>
 #include <hpp/core/path-validation/discretized.hh>
 #include <hpp/core/projection-error.hh>
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/trace.hh>
 #include <hpp/util/debug.hh>
 
 namespace hpp {
   namespace core {
     namespace pathValidation {
 
+    /// First invalid sample found by the threads
+    struct Discretized::FirstFailure
+    {
+      FirstFailure (size_type n) : index (n) {}
+      /// Index of the sample, number of samples if none is invalid
+      size_type index;
+      PathValidationReportPtr_t report;
+      boost::mutex mutex;
+    }; // struct FirstFailure
+
     DiscretizedPtr_t
     Discretized::create (const value_type& stepSize)
     {
@@ -40,7 +59,68 @@ namespace hpp {
     (const PathPtr_t& path, bool reverse, PathPtr_t& validPart,
      PathValidationReportPtr_t& validationReport)
     {
+      HPP_CORE_TRACE_SPAN ("PathValidation::validate");
+      HPP_CORE_ALLOCATION_SCOPE (VALIDATION);
         hppDout(notice,"path validation, reverse : "<<reverse);
+      value_type lastValidTime;
+      if (validateSamples (path, reverse, lastValidTime, validationReport)) {
+        validPart = path;
+        return true;
+      }
+      if (reverse)
+        validPart = path->extract (lastValidTime, path->timeRange ().second);
+      else
+        validPart = path->extract (path->timeRange ().first, lastValidTime);
+      return false;
+    }
+
+    bool Discretized::isValid (const PathPtr_t& path, bool reverse,
+                               value_type& lastValidTime)
+    {
+      PathValidationReportPtr_t report;
+      return validateSamples (path, reverse, lastValidTime, report);
+    }
+
+    bool Discretized::sampleValidations
+    (const PathPtr_t& path,
+     std::vector <ConfigValidationPtr_t>& validations) const
+    {
+      validations.clear ();
+      for (std::vector <ConfigValidationPtr_t>::const_iterator
+             it = validations_.begin (); it != validations_.end (); ++it) {
+        if (!(*it)->certifies (path)) validations.push_back (*it);
+      }
+      return validations.size () < validations_.size ();
+    }
+
+    bool Discretized::validateConfiguration
+    (const Configuration_t& q, bool skip,
+     const std::vector <ConfigValidationPtr_t>& validations,
+     ValidationReportPtr_t& report)
+    {
+      if (!skip) return ConfigValidations::validate (q, report);
+      for (std::vector <ConfigValidationPtr_t>::const_iterator
+             it = validations.begin (); it != validations.end (); ++it) {
+        if (!(*it)->validate (q, report)) return false;
+      }
+      return true;
+    }
+
+    bool Discretized::validateSamples
+    (const PathPtr_t& path, bool reverse, value_type& lastValidTime,
+     PathValidationReportPtr_t& validationReport)
+    {
+      std::vector <ConfigValidationPtr_t> validations;
+      const bool skip (sampleValidations (path, validations));
+      if (skip && validations.empty ()) {
+        // Every configuration is known to be valid.
+        lastValidTime = reverse ? path->timeRange ().first :
+          path->timeRange ().second;
+        return true;
+      }
+      if (numberThreads_ > 1)
+        return validateParallel (path, reverse, skip, validations,
+                                 lastValidTime, validationReport);
       ValidationReportPtr_t configReport;
       assert (path);
       bool valid = true;
@@ -48,7 +128,7 @@ namespace hpp {
       const value_type tmax = path->timeRange ().second;
       unsigned finished = 0;
       Configuration_t q (path->outputSize());
-      value_type T1, step, lastValidTime;
+      value_type T1, step;
       if (reverse) {
         lastValidTime = tmax;
         T1 = tmin;
@@ -61,6 +141,13 @@ namespace hpp {
 
       value_type t = lastValidTime;
       while (finished < 2 && valid) {
+        if (expired ()) {
+          validationReport = PathValidationReportPtr_t (
+              new PathValidationReport (t,
+                ValidationReportPtr_t(new DeadlineExpired ())));
+          valid = false;
+          break;
+        }
         bool success = (*path) (q, t);
         if (!success) {
           validationReport = PathValidationReportPtr_t (
@@ -68,7 +155,8 @@ namespace hpp {
                 ValidationReportPtr_t(new ProjectionError()))
               );
           valid = false;
-        } else if (!ConfigValidations::validate (q, configReport)) {
+        } else if (!validateConfiguration (q, skip, validations,
+                                           configReport)) {
           validationReport = CollisionPathValidationReportPtr_t
             (new CollisionPathValidationReport (t, configReport));
           valid = false;
@@ -82,20 +170,116 @@ namespace hpp {
           finished++;
         }
       }
-      if (valid) {
-        validPart = path;
+      if (valid) lastValidTime = T1;
+      return valid;
+    }
+
+    bool Discretized::validateParallel
+    (const PathPtr_t& path, bool reverse, bool skip,
+     const std::vector <ConfigValidationPtr_t>& validations,
+     value_type& lastValidTime, PathValidationReportPtr_t& validationReport)
+    {
+      assert (path);
+      const value_type tmin = path->timeRange ().first;
+      const value_type tmax = path->timeRange ().second;
+      const value_type T0 (reverse ? tmax : tmin);
+      const value_type T1 (reverse ? tmin : tmax);
+      const value_type step (reverse ? -stepSize_ : stepSize_);
+
+      // Same samples as the sequential validation
+      std::vector <value_type> times;
+      for (value_type t = T0; (reverse && t > T1) || (!reverse && t < T1);
+           t += step)
+        times.push_back (t);
+      times.push_back (T1);
+
+      // Paths may project configurations, which is not thread safe:
+      // configurations are computed here, up to the first projection
+      // failure.
+      FirstFailure failure ((size_type) times.size ());
+      matrix_t configurations (path->outputSize (), (size_type) times.size ());
+      size_type computed = path->eval
+        (Eigen::Map <const vector_t> (&times [0], (size_type) times.size ()),
+         configurations);
+      if (computed < (size_type) times.size ()) {
+        failure.index = computed;
+        failure.report = PathValidationReportPtr_t
+          (new PathValidationReport
+           (times [computed], ValidationReportPtr_t (new ProjectionError ())));
+      }
+
+      if (failure.index > 0) {
+        const size_type nThreads (std::min (numberThreads_, failure.index));
+        // Chunks are small enough to balance the load between threads and
+        // to stop soon after the first failure.
+        const size_type chunkSize
+          (std::max ((size_type) 1, failure.index / (4 * nThreads)));
+        boost::thread_group threads;
+        for (size_type t = 0; t < nThreads; ++t) {
+          threads.create_thread
+            (boost::bind (&Discretized::validateChunks, this,
+                          boost::cref (configurations), boost::cref (times),
+                          skip, boost::cref (validations), chunkSize, t,
+                          nThreads, boost::ref (failure)));
+        }
+        threads.join_all ();
+      }
+
+      if (failure.index == (size_type) times.size ()) {
+        lastValidTime = T1;
         return true;
-      } else {
-        if (reverse)
-          validPart = path->extract (lastValidTime, tmax);
-        else
-	  validPart = path->extract (tmin, lastValidTime);
-        return false;
+      }
+      validationReport = failure.report;
+      lastValidTime = failure.index == 0 ? T0 : times [failure.index - 1];
+      return false;
+    }
+
+    void Discretized::validateChunks
+    (const matrix_t& configurations, const std::vector <value_type>& times,
+     bool skip, const std::vector <ConfigValidationPtr_t>& validations,
+     size_type chunkSize, size_type begin, size_type step,
+     FirstFailure& failure)
+    {
+      ValidationReportPtr_t configReport;
+      Configuration_t q (configurations.rows ());
+      size_type end;
+      {
+        boost::mutex::scoped_lock lock (failure.mutex);
+        end = failure.index;
+      }
+      for (size_type chunk = begin; chunk * chunkSize < end; chunk += step) {
+        for (size_type i = chunk * chunkSize;
+             i < std::min ((chunk + 1) * chunkSize, end); ++i) {
+          q = configurations.col (i);
+          if (validateConfiguration (q, skip, validations, configReport))
+            continue;
+          boost::mutex::scoped_lock lock (failure.mutex);
+          if (i < failure.index) {
+            failure.index = i;
+            failure.report = CollisionPathValidationReportPtr_t
+              (new CollisionPathValidationReport (times [i], configReport));
+          }
+          return;
+        }
+        // Samples after a failure found by another thread are useless.
+        boost::mutex::scoped_lock lock (failure.mutex);
+        if (expired ()) {
+          // The chunks not validated yet are considered invalid.
+          const size_type next (std::min ((chunk + 1) * chunkSize, end));
+          if (next < failure.index) {
+            failure.index = next;
+            failure.report = PathValidationReportPtr_t
+              (new PathValidationReport
+               (times [next], ValidationReportPtr_t (new DeadlineExpired ())));
+          }
+          return;
+        }
+        end = failure.index;
       }
     }
 
     Discretized::Discretized (const value_type& stepSize) :
-      stepSize_ (stepSize)
+      stepSize_ (stepSize), numberThreads_ (1)
     {
     }
 
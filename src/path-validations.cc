@@ -23,6 +23,8 @@
 #include <hpp/core/path.hh>
 #include <hpp/core/path-validations.hh>
 
+#include "validation-ordering.hh"
+
 namespace hpp {
   namespace core {
 
@@ -36,6 +38,24 @@ namespace hpp {
     (const PathValidationPtr_t& pathValidation)
     {
       validations_.push_back (pathValidation);
+      pathValidation->deadline (deadline ());
+      if (ordering_) adaptiveOrdering (true);
+    }
+
+    void PathValidations::adaptiveOrdering (bool enable)
+    {
+      if (enable)
+        ordering_.reset (new ValidationOrdering (validations_.size ()));
+      else
+        ordering_.reset ();
+    }
+
+    void PathValidations::deadline (const DeadlinePtr_t& deadline)
+    {
+      PathValidation::deadline (deadline);
+      for (std::vector <PathValidationPtr_t>::iterator
+	     it = validations_.begin (); it != validations_.end (); ++it)
+        (*it)->deadline (deadline);
     }
 
     bool PathValidations::validate
@@ -50,9 +70,22 @@ namespace hpp {
       value_type lastValidTime = path->timeRange ().second;
       value_type t = lastValidTime;
 
-      for (std::vector <PathValidationPtr_t>::iterator
-	     it = validations_.begin (); it != validations_.end (); ++it) {
-	    if ((*it)->validate (tempPath, reverse, tempValidPart, tempValidationReport) == false)
+      typedef ValidationOrdering::Clock_t Clock_t;
+      ValidationOrdering::OrderPtr_t order;
+      ValidationOrdering::Samples_t samples;
+      if (ordering_) order = ordering_->order ();
+      for (std::size_t k = 0; k < validations_.size (); ++k) {
+        const std::size_t i (order ? (*order) [k] : k);
+        const Clock_t::time_point start (Clock_t::now ());
+        const bool valid (validations_ [i]->validate
+                          (tempPath, reverse, tempValidPart,
+                           tempValidationReport));
+        if (order) {
+          samples.push_back (ValidationOrdering::Sample
+                             (i, 1, valid ? 0 : 1,
+                              ValidationOrdering::elapsed (start)));
+        }
+        if (!valid)
         {
           t = tempValidationReport->getParameter();
           if ( t < lastValidTime ) {
@@ -62,11 +95,30 @@ namespace hpp {
           result = false;
         }
       }
+      if (order) ordering_->record (samples);
       validPart = tempPath;
       validationReport->setParameter(lastValidTime);
       return result;
     }
 
+    bool PathValidations::isValid (const PathPtr_t& path, bool reverse,
+                                   value_type& lastValidTime)
+    {
+      bool result = true;
+      lastValidTime = reverse ? path->timeRange ().first :
+        path->timeRange ().second;
+      value_type t;
+      for (std::vector <PathValidationPtr_t>::iterator
+	     it = validations_.begin (); it != validations_.end (); ++it) {
+        if (!(*it)->isValid (path, reverse, t)) {
+          if (reverse ? t > lastValidTime : t < lastValidTime)
+            lastValidTime = t;
+          result = false;
+        }
+      }
+      return result;
+    }
+
     PathValidations::PathValidations ()
     {
     }
@@ -24,7 +24,9 @@
 #include <hpp/util/indent.hh>
 #include <hpp/util/serialization.hh>
 
+#include <algorithm>
 #include <stdexcept>
+#include <typeinfo>
 
 namespace hpp {
   namespace core {
@@ -35,23 +37,17 @@ namespace hpp {
       assert(!timeParameterization());
       if (paths_.empty())
         throw std::runtime_error ("PathVector is empty.");
-      std::size_t res = 0;
-      localParam = param;
-      bool finished = false;
-
-      while (res + 1 < paths_.size () && !finished) {
-	if (localParam > paths_ [res]->length ()) {
-	  localParam -= paths_ [res]->length ();
-	  res ++;
-	}
-	else {
-	  finished = true;
-	}
+      // The rank is the first sub-path ending after param, the last one if
+      // param is beyond the end.
+      std::size_t res = lastRank_;
+      if (res >= paths_.size () || !onPath (res, param)) {
+        res = std::lower_bound (ends_.begin (), ends_.end (), param) -
+          ends_.begin ();
+        if (res == paths_.size ()) --res;
+        lastRank_ = res;
       }
+      localParam = param - (res == 0 ? 0 : ends_ [res - 1]);
       if (localParam > paths_ [res]->length ()) {
-	if (res != paths_.size () -1) {
-	  throw std::runtime_error ("localparam out of range.");
-	}
 	localParam = paths_ [res]->timeRange ().second;
       } else {
 	localParam += paths_ [res]->timeRange ().first;
@@ -66,10 +62,20 @@ namespace hpp {
     void PathVector::appendPath (const PathPtr_t& path)
     {
       assert(!timeParameterization());
+      if (typeid (*path) == typeid (PathVector) && !path->constraints ()) {
+        const PathVector& pv (static_cast <const PathVector&> (*path));
+        if (!pv.timeParameterization ()) {
+          for (Paths_t::const_iterator it = pv.paths_.begin ();
+               it != pv.paths_.end (); ++it)
+            appendPath (*it);
+          return;
+        }
+      }
       paths_.push_back (path);
       interval_t tr = timeRange();
       tr.second += path->length ();
       timeRange (tr);
+      ends_.push_back ((ends_.empty () ? 0 : ends_.back ()) + path->length ());
     }
 
     PathPtr_t PathVector::pathAtRank (std::size_t rank) const
@@ -130,6 +136,50 @@ namespace hpp {
       return (*subpath) (result, localParam);
     }
 
+    std::size_t PathVector::run (vectorIn_t params, size_type begin,
+                                 std::vector <value_type>& localParams) const
+    {
+      value_type localParam;
+      std::size_t rank = rankAtParam (params [begin], localParam);
+      localParams.assign (1, localParam);
+      for (size_type i = begin + 1; i < params.size (); ++i) {
+        if (rankAtParam (params [i], localParam) != rank) break;
+        localParams.push_back (localParam);
+      }
+      return rank;
+    }
+
+    size_type PathVector::impl_compute (matrixOut_t result,
+                                        vectorIn_t params) const
+    {
+      assert(!timeParameterization());
+      std::vector <value_type> localParams;
+      for (size_type i = 0; i < params.size ();) {
+        std::size_t rank = run (params, i, localParams);
+        const size_type n ((size_type) localParams.size ());
+        Eigen::Map <const vector_t> times (&localParams [0], n);
+        size_type success = paths_ [rank]->eval (times,
+                                                 result.middleCols (i, n));
+        if (success < n) return i + success;
+        i += n;
+      }
+      return params.size ();
+    }
+
+    void PathVector::impl_derivative (matrixOut_t result, vectorIn_t params,
+                                      size_type order) const
+    {
+      assert(!timeParameterization());
+      std::vector <value_type> localParams;
+      for (size_type i = 0; i < params.size ();) {
+        std::size_t rank = run (params, i, localParams);
+        const size_type n ((size_type) localParams.size ());
+        Eigen::Map <const vector_t> times (&localParams [0], n);
+        paths_ [rank]->derivative (times, result.middleCols (i, n), order);
+        i += n;
+      }
+    }
+
     void PathVector::impl_derivative (vectorOut_t result, const value_type& param,
 				      size_type order) const
     {
@@ -231,6 +281,16 @@ namespace hpp {
       ar & make_nvp("base", base_object<Path>(*this));
       ar & BOOST_SERIALIZATION_NVP(paths_);
       ar & BOOST_SERIALIZATION_NVP(weak_);
+      if (Archive::is_loading::value) {
+        ends_.clear ();
+        value_type end (0);
+        for (Paths_t::const_iterator it = paths_.begin (); it != paths_.end ();
+             ++it) {
+          end += (*it)->length ();
+          ends_.push_back (end);
+        }
+        lastRank_ = 0;
+      }
     }
 
     HPP_SERIALIZATION_IMPLEMENT(PathVector);
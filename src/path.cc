@@ -141,6 +141,69 @@ namespace hpp {
       return constraints_->apply (result);
     }
 
+    size_type Path::eval (vectorIn_t times, matrixOut_t result) const
+    {
+      assert (result.rows () == outputSize ());
+      assert (result.cols () == times.size ());
+      vector_t params (times.size ());
+      for (size_type i = 0; i < times.size (); ++i)
+        params [i] = paramAtTime (times [i]);
+      size_type n = impl_compute (result, params);
+      if (!constraints_) return n;
+      for (size_type i = 0; i < n; ++i)
+        if (!applyConstraints (result.col (i), params [i])) return i;
+      return n;
+    }
+
+    size_type Path::impl_compute (matrixOut_t configurations,
+                                  vectorIn_t params) const
+    {
+      for (size_type i = 0; i < params.size (); ++i)
+        if (!impl_compute (configurations.col (i), params [i])) return i;
+      return params.size ();
+    }
+
+    void Path::impl_derivative (matrixOut_t derivatives, vectorIn_t params,
+                                size_type order) const
+    {
+      for (size_type i = 0; i < params.size (); ++i)
+        impl_derivative (derivatives.col (i), params [i], order);
+    }
+
+    void Path::derivative (vectorIn_t times, matrixOut_t result,
+        size_type order) const
+    {
+      assert (result.rows () == outputDerivativeSize ());
+      assert (result.cols () == times.size ());
+      if (!timeParam_) {
+        impl_derivative (result, times, order);
+        return;
+      }
+      vector_t params (times.size ());
+      for (size_type i = 0; i < times.size (); ++i)
+        params [i] = timeParam_->value (times [i]);
+      switch (order) {
+        case 1:
+          impl_derivative (result, params, 1);
+          for (size_type i = 0; i < times.size (); ++i)
+            result.col (i) *= timeParam_->derivative (times [i], 1);
+          break;
+        case 2: {
+                  matrix_t tmp (outputDerivativeSize (), times.size ());
+                  impl_derivative (tmp, params, 2);
+                  impl_derivative (result, params, 1);
+                  for (size_type i = 0; i < times.size (); ++i) {
+                    value_type der = timeParam_->derivative (times [i], 1);
+                    result.col (i) *= timeParam_->derivative (times [i], 2);
+                    result.col (i).noalias () += tmp.col (i) * (der*der);
+                  }
+                  break;
+                }
+        default:
+                throw std::invalid_argument ("Cannot compute the derivative of order greater than 2.");
+      }
+    }
+
     void Path::derivative (vectorOut_t result, const value_type& time,
         size_type order) const
     {
@@ -234,6 +297,22 @@ namespace hpp {
       return this->extract (interval);
     }
 
+    PathPtr_t Path::reversedView () const
+    {
+      if (timeParam_) return reverse ();
+      const PathPtr_t self (weak_.lock ());
+      ExtractedPathPtr_t extracted (HPP_DYNAMIC_PTR_CAST (ExtractedPath, self));
+      if (extracted && extracted->reversed ()) {
+        const PathPtr_t& original (extracted->original ());
+        if (!original->timeParameterization () &&
+            original->constraints () == constraints () &&
+            original->timeRange () == timeRange_)
+          return original;
+      }
+      return ExtractedPath::create
+        (self, interval_t (timeRange_.second, timeRange_.first));
+    }
+
     void Path::checkPath () const
     {
       using pinocchio::displayConfig;
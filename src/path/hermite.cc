@@ -93,7 +93,18 @@ namespace hpp {
 
       void Hermite::computeHermiteLength ()
       {
-        hermiteLength_ = (parameters_.bottomRows<3>() - parameters_.topRows<3>()).rowwise().norm().sum();
+        legLengths_ [0] = (parameters_.row (1) - parameters_.row (0)).norm ();
+        legLengths_ [2] = (parameters_.row (3) - parameters_.row (2)).norm ();
+        computeHermiteLength (legLengths_ [0], legLengths_ [2]);
+      }
+
+      void Hermite::computeHermiteLength (const value_type& firstLeg,
+                                          const value_type& lastLeg)
+      {
+        legLengths_ [0] = firstLeg;
+        legLengths_ [1] = (parameters_.row (2) - parameters_.row (1)).norm ();
+        legLengths_ [2] = lastLeg;
+        hermiteLength_ = legLengths_ [0] + legLengths_ [1] + legLengths_ [2];
       }
 
       vector_t Hermite::velocity (const value_type& param) const
@@ -38,6 +38,7 @@ namespace hpp {
           typedef Eigen::Matrix<size_type, NbCoeffs, 1> Factorials_t;
           typedef typename traits::Coeffs_t Coeffs_t;
           typedef typename traits::IntegralCoeffs_t IntegralCoeffs_t;
+          typedef IntegralCoeffs_t Monomials_t;
 
           static void eval (const value_type t, Coeffs_t& res);
           static void derivative (const size_type order, const value_type& t, Coeffs_t& res);
@@ -45,6 +46,9 @@ namespace hpp {
           static void integral (const size_type order, IntegralCoeffs_t& res);
           static void absDerBounds (Coeffs_t& res);
           static void bound (const size_type& order, const value_type& /* t0 */, const value_type& t1, Coeffs_t& res) { derivative(order, t1, res); }
+          /// Derivative of order k of the basis functions in the monomial
+          /// basis: res.row(i) are the coefficients of (1, t, ..., t^Degree).
+          static void monomials (const size_type k, Monomials_t& res);
         };
         template <int Degree>
         void spline_basis_function<CanonicalPolynomeBasis, Degree>::eval (const value_type t, Coeffs_t& res)
@@ -65,6 +69,15 @@ namespace hpp {
           }
         }
         template <int Degree>
+        void spline_basis_function<CanonicalPolynomeBasis, Degree>::monomials
+        (const size_type k, Monomials_t& res)
+        {
+          static Factorials_t factors = binomials<NbCoeffs>::factorials();
+          res.setZero();
+          for (size_type i = k; i < NbCoeffs; ++i)
+            res(i, i - k) = value_type(factors(i) / factors(i - k));
+        }
+        template <int Degree>
         void spline_basis_function<CanonicalPolynomeBasis, Degree>::integral
         (const size_type order, IntegralCoeffs_t& res)
         {
@@ -101,6 +114,8 @@ namespace hpp {
           typedef Eigen::Matrix<size_type, NbCoeffs, 1> Factorials_t;
           typedef Eigen::Matrix<value_type, NbCoeffs, 1> Coeffs_t;
           typedef Eigen::Matrix<value_type, NbCoeffs, NbCoeffs> IntegralCoeffs_t;
+          typedef IntegralCoeffs_t Monomials_t;
+          typedef std::vector<Monomials_t, Eigen::aligned_allocator<Monomials_t> > MonomialsVector_t;
 
           static void eval (const value_type t, Coeffs_t& res);
           static void derivative (const size_type order, const value_type& t, Coeffs_t& res);
@@ -108,9 +123,14 @@ namespace hpp {
           static void integral (const size_type order, IntegralCoeffs_t& res);
           static void absDerBounds (Coeffs_t& res);
           static void bound (const size_type& order, const value_type& t0, const value_type& t1, Coeffs_t& res);
+          /// Derivative of order k of the basis functions in the monomial
+          /// basis: res.row(i) are the coefficients of (1, t, ..., t^Degree).
+          static void monomials (const size_type k, Monomials_t& res);
 
           private:
           static Coeffs_t absBound (bool up);
+          /// Derivatives of order 0 to Degree in the monomial basis.
+          static MonomialsVector_t allMonomials ();
         };
         template <int Degree>
         void spline_basis_function<BernsteinBasis, Degree>::eval (const value_type t, Coeffs_t& res)
@@ -120,29 +140,48 @@ namespace hpp {
         template <int Degree>
         void spline_basis_function<BernsteinBasis, Degree>::derivative
         (const size_type k, const value_type& t, Coeffs_t& res)
+        {
+          if (k > Degree) {
+            res.setZero();
+            return;
+          }
+          static const MonomialsVector_t coeffs = allMonomials();
+          Coeffs_t powersOfT;
+          powersOfT(0) = 1;
+          for (size_type i = 1; i < NbCoeffs; ++i)
+            powersOfT(i) = powersOfT(i - 1) * t;
+          res.noalias() = coeffs[k] * powersOfT;
+        }
+        template <int Degree>
+        void spline_basis_function<BernsteinBasis, Degree>::monomials
+        (const size_type k, Monomials_t& res)
         {
           res.setZero();
           if (k > Degree) return;
           static Factorials_t factors = binomials<NbCoeffs>::factorials();
-          Coeffs_t powersOfT, powersOfOneMinusT;
-          powersOfT        (0) = 1;
-          powersOfOneMinusT(0) = 1;
-          const value_type oneMinusT = 1 - t;
-          for (size_type i = 1; i < NbCoeffs; ++i) {
-            powersOfT        (i) = powersOfT        (i - 1) * t;
-            powersOfOneMinusT(i) = powersOfOneMinusT(i - 1) * oneMinusT;
-          }
-
+          // d^k b_i / dt^k = Degree! sum_p (-1)^(k-p) C(k,p)
+          //                  t^(i-p) (1-t)^(Degree-k-i+p) / ((i-p)! (Degree-k-i+p)!)
+          // where (1-t)^m is expanded with the binomial formula.
           for (size_type i = 0; i < NbCoeffs; ++i) {
             for (size_type p = std::max((size_type)0, k + i - Degree); p <= std::min(i, k); ++p) {
-              size_type ip = i - p;
-              res(i) += value_type (( (k - p) % 2 == 0 ? 1 : -1 )
+              const size_type ip = i - p, m = Degree - k - ip;
+              const value_type c = value_type (( (k - p) % 2 == 0 ? 1 : -1 )
                 * binomials<NbCoeffs>::binomial (k, p))
-                *   powersOfT(ip) * powersOfOneMinusT(Degree - k - ip)
-                / value_type( factors  (ip) * factors  (Degree - k - ip) );
+                * value_type(factors(Degree))
+                / value_type( factors  (ip) * factors  (m) );
+              for (size_type j = 0; j <= m; ++j)
+                res(i, ip + j) += c * value_type ((j % 2 == 0 ? 1 : -1)
+                    * binomials<NbCoeffs>::binomial (m, j));
             }
           }
-          res *= value_type(factors(Degree));
+        }
+        template <int Degree>
+        typename spline_basis_function<BernsteinBasis, Degree>::MonomialsVector_t
+        spline_basis_function<BernsteinBasis, Degree>::allMonomials ()
+        {
+          MonomialsVector_t res (NbCoeffs);
+          for (size_type k = 0; k < NbCoeffs; ++k) monomials (k, res[k]);
+          return res;
         }
         template <int Degree>
         void spline_basis_function<BernsteinBasis, Degree>::integral
@@ -252,6 +291,38 @@ namespace hpp {
           }
           return res;
         }
+
+        /// Split a Bezier curve at u with the de Casteljau algorithm
+        /// \param points control points of the curve, one per row,
+        /// \retval left, right control points of the curve restricted to
+        ///         [0, u] and [u, 1].
+        inline void deCasteljau (const matrix_t& points, const value_type& u,
+            matrix_t& left, matrix_t& right)
+        {
+          const size_type m (points.rows());
+          matrix_t w (points);
+          left .resize (m, points.cols());
+          right.resize (m, points.cols());
+          left .row(0)     = w.row(0);
+          right.row(m - 1) = w.row(m - 1);
+          for (size_type k = 1; k < m; ++k) {
+            for (size_type i = 0; i < m - k; ++i)
+              w.row(i) = (1 - u) * w.row(i) + u * w.row(i + 1);
+            left .row(k)         = w.row(0);
+            right.row(m - 1 - k) = w.row(m - 1 - k);
+          }
+        }
+
+        /// Restrict a Bezier curve to [u0, u1], with 0 <= u0 <= u1 <= 1.
+        inline void restrictBezier (matrix_t& points, const value_type& u0,
+            const value_type& u1)
+        {
+          matrix_t left, right;
+          deCasteljau (points, u1, left, right);
+          if (u1 > 0) deCasteljau (left, u0 / u1, points, right);
+          else right = left;
+          points = right;
+        }
       }
 
       template <int _SplineType, int _Order>
@@ -366,6 +437,62 @@ namespace hpp {
         }
       }
 
+      template <int _SplineType, int _Order>
+      size_type Spline<_SplineType, _Order>::impl_compute (matrixOut_t res, vectorIn_t params) const
+      {
+        // Velocity polynomial in the monomial basis, evaluated with the
+        // Horner scheme for all the degrees of freedom at once.
+        typename BasisFunction_t::Monomials_t monomials;
+        BasisFunction_t::monomials (0, monomials);
+        const matrix_t coeffs (parameters_.transpose() * monomials);
+        vector_t velocity (parameterSize_);
+        for (size_type i = 0; i < params.size(); ++i) {
+          value_type u = 0;
+          if (paramLength() != 0) {
+            u = (params[i] - paramRange().first) / paramLength();
+            // clamp u between 0 and 1.
+            if      (u < 0.) u = 0.;
+            else if (u > 1.) u = 1.;
+          }
+          velocity = coeffs.col(NbCoeffs - 1);
+          for (size_type j = NbCoeffs - 2; j >= 0; --j) {
+            velocity *= u;
+            velocity += coeffs.col(j);
+          }
+          res.col(i) = (base_ + velocity).vector();
+        }
+        return params.size();
+      }
+
+      template <int _SplineType, int _Order>
+      void Spline<_SplineType, _Order>::impl_derivative (matrixOut_t res, vectorIn_t params, size_type order) const
+      {
+        assert (order > 0);
+        assert (order == 1 || robot_->configSpace()->isVectorSpace());
+        const bool vectorSpace (robot_->configSpace()->isVectorSpace());
+        matrix_t basisFuncs ((int)NbCoeffs, params.size()),
+                 basisFuncs0 ((int)NbCoeffs, vectorSpace ? 0 : params.size());
+        BasisFunctionVector_t basisFunc;
+        for (size_type i = 0; i < params.size(); ++i) {
+          const value_type u = (length() == 0 ? 0 : (params[i] - paramRange().first) / paramLength());
+          basisFunctionDerivative(order, u, basisFunc);
+          basisFuncs.col(i) = basisFunc;
+          if (!vectorSpace) {
+            basisFunctionDerivative(0, u, basisFunc);
+            basisFuncs0.col(i) = basisFunc;
+          }
+        }
+        res.noalias() = parameters_.transpose() * basisFuncs;
+
+        if (!vectorSpace) {
+          matrix_t v (parameters_.transpose() * basisFuncs0);
+          for (size_type i = 0; i < params.size(); ++i) {
+            vectorOut_t resi (res.col(i));
+            base_.space()->dIntegrate_dv<pinocchio::DerivativeTimesInput> (base_, v.col(i), resi);
+          }
+        }
+      }
+
       template <int _SplineType, int _Order>
       void Spline<_SplineType, _Order>::impl_paramDerivative (vectorOut_t res, const value_type& s) const
       {
@@ -396,10 +523,31 @@ namespace hpp {
       void Spline<_SplineType, _Order>::impl_velocityBound (
           vectorOut_t res, const value_type& t0, const value_type& t1) const
       {
+        if (paramLength() == 0) {
+          res.setZero();
+          return;
+        }
+        // Bounds of the basis functions are defined on [0, 1].
+        const value_type u0 = std::min (1., std::max (0.,
+              (t0 - paramRange().first) / paramLength())),
+                         u1 = std::min (1., std::max (u0,
+              (t1 - paramRange().first) / paramLength()));
         BasisFunctionVector_t ub;
-        BasisFunction_t::bound (1, t0, t1, ub);
+        BasisFunction_t::bound (1, u0, u1, ub);
         ub /= length();
         res.noalias() = parameters_.cwiseAbs().transpose() * ub;
+
+        if (PolynomeBasis == BernsteinBasis) {
+          // The derivative is a Bezier curve whose control points are the
+          // scaled differences of the parameters. Restricted to [u0, u1],
+          // it lies in the convex hull of its control points.
+          matrix_t hodograph (Order, parameterSize_);
+          for (size_type i = 0; i < Order; ++i)
+            hodograph.row(i) = value_type(Order) *
+              (parameters_.row(i + 1) - parameters_.row(i));
+          internal::restrictBezier (hodograph, u0, u1);
+          res = res.cwiseMin (hodograph.cwiseAbs().colwise().maxCoeff().transpose() / length());
+        }
       }
 
       template <int _SplineType, int _Order>
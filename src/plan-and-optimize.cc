@@ -16,32 +16,165 @@
 // hpp-core  If not, see
 // <http://www.gnu.org/licenses/>.
 
-#include <hpp/core/path-optimizer.hh>
 #include <hpp/core/plan-and-optimize.hh>
 
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/util/debug.hh>
+#include <hpp/core/path-optimizer.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/problem-target.hh>
+
 namespace hpp {
   namespace core {
+    namespace {
+      PathVectorPtr_t optimize (const PlanAndOptimize::Optimizers_t& optimizers,
+                                const PathVectorPtr_t& path)
+      {
+        PathVectorPtr_t result = path;
+        for (PlanAndOptimize::Optimizers_t::const_iterator itOpt =
+               optimizers.begin (); itOpt != optimizers.end (); ++itOpt) {
+          result = (*itOpt)->optimize (result);
+        }
+        return result;
+      }
+    } // namespace
+
+    /// State of the pipelined mode
+    struct PlanAndOptimize::Pipeline
+    {
+      OptimizersFactory_t factory;
+      size_type maxThreads;
+
+      boost::mutex mutex;
+      boost::thread_group threads;
+      /// Number of running threads
+      size_type running;
+      /// Latest solution waiting for a free thread
+      PathVectorPtr_t pending;
+      /// Optimized solutions
+      std::vector <PathVectorPtr_t> results;
+      /// Whether a solution of the current resolution was scheduled
+      bool scheduled;
+
+      /// Solution callback of the planner, called after scheduling
+      SolutionCallback_t callback;
+      PathPlannerPtr_t planner;
+
+      Pipeline () : maxThreads (1), running (0), scheduled (false) {}
+
+      /// Install the solution callback on planner
+      void start (const PathPlannerPtr_t& p)
+      {
+        stop ();
+        results.clear ();
+        scheduled = false;
+        planner = p;
+        callback = planner->solutionCallback ();
+        planner->solutionCallback
+          (boost::bind (&Pipeline::publish, this, _1));
+      }
+
+      /// Wait for the threads and restore the solution callback
+      void stop ()
+      {
+        threads.join_all ();
+        if (planner) planner->solutionCallback (callback);
+        planner.reset ();
+        callback.clear ();
+      }
+
+      void publish (const PathVectorPtr_t& path)
+      {
+        schedule (path);
+        if (callback) callback (path);
+      }
+
+      void schedule (const PathVectorPtr_t& path)
+      {
+        {
+          boost::mutex::scoped_lock lock (mutex);
+          scheduled = true;
+          if (running >= maxThreads) {
+            pending = path;
+            return;
+          }
+          ++running;
+        }
+        threads.create_thread (boost::bind (&Pipeline::run, this,
+                                            factory (), path));
+      }
+
+      void run (const Optimizers_t& optimizers, PathVectorPtr_t path)
+      {
+        while (true) {
+          PathVectorPtr_t result;
+          try {
+            result = optimize (optimizers, path);
+          } catch (const std::exception& exc) {
+            hppDout (error, "Failed to optimize a solution: " << exc.what ());
+          }
+          boost::mutex::scoped_lock lock (mutex);
+          if (result) results.push_back (result);
+          if (!pending) {
+            --running;
+            return;
+          }
+          path = pending;
+          pending.reset ();
+        }
+      }
+    }; // struct Pipeline
 
     void PlanAndOptimize::oneStep ()
     {
       pathPlanner_->oneStep ();
+      if (pipeline_ && !pipeline_->scheduled &&
+          problem ().target ()->reached (roadmap ()))
+        pipeline_->schedule (computePath ());
     }
 
     void PlanAndOptimize::startSolve ()
     {
+      if (pipeline_) pipeline_->start (pathPlanner_);
       pathPlanner_->startSolve ();
     }
 
     PathVectorPtr_t PlanAndOptimize::finishSolve (const PathVectorPtr_t& path)
     {
-      PathVectorPtr_t result = path;
-      for (Optimizers_t::iterator itOpt = optimizers_.begin ();
-	   itOpt != optimizers_.end (); ++itOpt) {
-	result = (*itOpt)->optimize (result);
+      PathVectorPtr_t result = optimize (optimizers_, path);
+      if (!pipeline_) return result;
+
+      pipeline_->stop ();
+      for (std::size_t i = 0; i < pipeline_->results.size (); ++i) {
+        const PathVectorPtr_t& other (pipeline_->results [i]);
+        if (other->length () < result->length ()) result = other;
       }
+      pipeline_->results.clear ();
       return result;
     }
 
+    void PlanAndOptimize::pipeline (const OptimizersFactory_t& factory,
+                                    size_type maxThreads)
+    {
+      if (maxThreads < 1)
+        throw std::invalid_argument ("The number of threads of the pipeline "
+                                     "must be positive.");
+      if (pipeline_) pipeline_->stop ();
+      if (factory.empty ()) {
+        pipeline_.reset ();
+        return;
+      }
+      if (!pipeline_) pipeline_.reset (new Pipeline);
+      pipeline_->factory = factory;
+      pipeline_->maxThreads = maxThreads;
+    }
+
     void PlanAndOptimize::addPathOptimizer
     (const PathOptimizerPtr_t& optimizer)
     {
@@ -61,5 +194,10 @@ namespace hpp {
     {
     }
 
+    PlanAndOptimize::~PlanAndOptimize ()
+    {
+      if (pipeline_) pipeline_->stop ();
+    }
+
   } // namespace core
 } // namespace hpp
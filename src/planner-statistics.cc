@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/planner-statistics.hh>
+
+#include <ostream>
+
+#include <hpp/util/pointer.hh>
+
+#include <hpp/core/collision-validation-report.hh>
+#include <hpp/core/joint-bound-validation.hh>
+
+namespace hpp {
+  namespace core {
+    typedef boost::chrono::steady_clock Clock_t;
+
+    PlannerStatistics::ScopedTimer::ScopedTimer
+    (PlannerStatistics& statistics, Stage stage) :
+      statistics_ (statistics), stage_ (stage), start_ (Clock_t::now ())
+    {
+    }
+
+    PlannerStatistics::ScopedTimer::~ScopedTimer ()
+    {
+      statistics_.add (stage_, boost::chrono::duration <value_type>
+                       (Clock_t::now () - start_).count ());
+    }
+
+    PlannerStatistics::PlannerStatistics ()
+    {
+      reset ();
+    }
+
+    void PlannerStatistics::reset ()
+    {
+      iterations = 0;
+      totalTime = 0;
+      for (int i = 0; i < NUMBER_STAGES; ++i) {
+        times_ [i] = 0;
+        counts_ [i] = 0;
+      }
+      samples_ = 0;
+      for (int i = 0; i < NUMBER_REJECTIONS; ++i)
+        rejections_ [i] = 0;
+      for (int i = 0; i < AllocationProfile::NUMBER_SUBSYSTEMS; ++i) {
+        allocations_ [i].allocations = 0;
+        allocations_ [i].bytes = 0;
+      }
+    }
+
+    void PlannerStatistics::reject (const ValidationReportPtr_t& report)
+    {
+      if (HPP_DYNAMIC_PTR_CAST (JointBoundValidationReport, report))
+        reject (JOINT_BOUNDS);
+      else if (HPP_DYNAMIC_PTR_CAST (CollisionValidationReport, report))
+        reject (COLLISION);
+      else
+        reject (OTHER_VALIDATION);
+    }
+
+    void PlannerStatistics::addSampling (const PlannerStatistics& other)
+    {
+      samples_ += other.samples_;
+      for (int i = 0; i < NUMBER_REJECTIONS; ++i)
+        rejections_ [i] += other.rejections_ [i];
+    }
+
+    void PlannerStatistics::allocationsSince
+    (const AllocationProfile::Snapshot& start)
+    {
+      const AllocationProfile::Snapshot now (AllocationProfile::snapshot ());
+      for (int i = 0; i < AllocationProfile::NUMBER_SUBSYSTEMS; ++i) {
+        allocations_ [i].allocations = now.counters [i].allocations -
+          start.counters [i].allocations;
+        allocations_ [i].bytes = now.counters [i].bytes -
+          start.counters [i].bytes;
+      }
+    }
+
+    const char* PlannerStatistics::name (Stage stage)
+    {
+      switch (stage) {
+      case SAMPLING: return "sampling";
+      case NEAREST_NEIGHBOR: return "nearest neighbor";
+      case STEERING: return "steering";
+      case PROJECTION: return "projection";
+      case VALIDATION: return "validation";
+      case INSERTION: return "insertion";
+      default: return "unknown";
+      }
+    }
+
+    const char* PlannerStatistics::name (Rejection cause)
+    {
+      switch (cause) {
+      case PROJECTION_FAILURE: return "projection failure";
+      case JOINT_BOUNDS: return "joint bounds";
+      case COLLISION: return "collision";
+      case OTHER_VALIDATION: return "other validation";
+      default: return "unknown";
+      }
+    }
+
+    std::ostream& operator<< (std::ostream& os, const PlannerStatistics& s)
+    {
+      os << "iterations: " << s.iterations << ", total time: "
+         << s.totalTime << " s";
+      for (int i = 0; i < PlannerStatistics::NUMBER_STAGES; ++i) {
+        const PlannerStatistics::Stage stage
+          (static_cast <PlannerStatistics::Stage> (i));
+        os << std::endl << "  " << PlannerStatistics::name (stage) << ": "
+           << s.time (stage) << " s in " << s.count (stage) << " calls";
+      }
+      os << std::endl << "samples: " << s.samples ();
+      for (int i = 0; i < PlannerStatistics::NUMBER_REJECTIONS; ++i) {
+        const PlannerStatistics::Rejection cause
+          (static_cast <PlannerStatistics::Rejection> (i));
+        os << std::endl << "  rejected by " << PlannerStatistics::name (cause)
+           << ": " << s.rejections (cause);
+      }
+      size_type allocations (0);
+      for (int i = 0; i < AllocationProfile::NUMBER_SUBSYSTEMS; ++i)
+        allocations += s.allocations
+          (static_cast <AllocationProfile::Subsystem> (i)).allocations;
+      // Nothing is recorded unless AllocationProfile is enabled.
+      if (allocations == 0) return os;
+      os << std::endl << "allocations: " << allocations;
+      for (int i = 0; i < AllocationProfile::NUMBER_SUBSYSTEMS; ++i) {
+        const AllocationProfile::Subsystem subsystem
+          (static_cast <AllocationProfile::Subsystem> (i));
+        const AllocationProfile::Counters& c (s.allocations (subsystem));
+        os << std::endl << "  " << AllocationProfile::name (subsystem) << ": "
+           << c.allocations << " allocations, " << c.bytes << " bytes";
+      }
+      return os;
+    }
+  } //   namespace core
+} // namespace hpp
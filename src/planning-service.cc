@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/planning-service.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <hpp/core/configuration-shooter.hh>
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/distance.hh>
+#include <hpp/core/multi-query-solver.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/roadmap.hh>
+
+namespace hpp {
+  namespace core {
+    PlanningServicePtr_t PlanningService::create (ProblemSolver& solver,
+                                                  size_type numberWorkers)
+    {
+      if (numberWorkers <= 0)
+        throw std::invalid_argument ("PlanningService: the number of "
+                                     "workers should be positive.");
+      return PlanningServicePtr_t (new PlanningService (solver,
+                                                        numberWorkers));
+    }
+
+    PlanningService::PlanningService (ProblemSolver& solver,
+                                      size_type numberWorkers) :
+      solver_ (solver), problems_ (), roadmaps_ (),
+      planners_ (numberWorkers), jobs_ (), queue_ (), nextTicket_ (0),
+      stopped_ (false)
+    {
+      statistics_.requests = 0;
+      statistics_.failures = 0;
+      statistics_.queueTime = 0;
+      statistics_.solveTime = 0;
+      statistics_.maxLatency = 0;
+
+      const ProblemPtr_t& problem (solver.problem ());
+      if (!problem) throw std::runtime_error ("The problem is not defined.");
+      for (size_type i = 0; i < numberWorkers; ++i) {
+        const PathPlanner::ConnectionTools tools
+          (solver.connectionTools (i + 1));
+        ProblemPtr_t worker (Problem::create (problem->robot ()));
+        worker->parameters = problem->parameters;
+        worker->distance (problem->distance ()->clone ());
+        worker->steeringMethod (tools.steeringMethod);
+        worker->pathValidation (tools.pathValidation);
+        worker->pathProjector (tools.pathProjector);
+        worker->configurationShooter (tools.configurationShooter);
+        worker->randomGenerator
+          (tools.configurationShooter->randomGenerator ());
+        // The obstacles were added to the validations by the solver.
+        worker->configValidation (problem->configValidations ());
+        // Projections are not thread safe.
+        if (problem->constraints ())
+          worker->constraints (ConstraintSet::createCopy
+                               (problem->constraints ()));
+        problems_.push_back (worker);
+        roadmaps_.push_back (Roadmap::create (worker->distance (),
+                                              worker->robot ()));
+      }
+      for (std::size_t i = 0; i < problems_.size (); ++i)
+        threads_.create_thread (boost::bind (&PlanningService::run, this, i));
+    }
+
+    PlanningService::~PlanningService ()
+    {
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        stopped_ = true;
+        for (std::deque <Ticket_t>::const_iterator it = queue_.begin ();
+             it != queue_.end (); ++it)
+          jobs_.erase (*it);
+        queue_.clear ();
+        for (std::size_t i = 0; i < planners_.size (); ++i)
+          if (planners_ [i]) planners_ [i]->interrupt ();
+        queued_.notify_all ();
+      }
+      threads_.join_all ();
+    }
+
+    PlanningService::Ticket_t PlanningService::submit
+    (const Request& request)
+    {
+      if (request.goals.empty ())
+        throw std::invalid_argument ("PlanningService: the request has no "
+                                     "goal configuration.");
+      Job job;
+      job.request = request;
+      if (job.request.pathPlannerType.empty ())
+        job.request.pathPlannerType = solver_.pathPlannerType ();
+      if (job.request.maxIterations == 0)
+        job.request.maxIterations = solver_.maxIterPathPlanning ();
+      if (job.request.timeOut <= 0)
+        job.request.timeOut = solver_.getTimeOutPathPlanning ();
+      job.builder = solver_.pathPlanners.get (job.request.pathPlannerType);
+      job.done = false;
+      job.submitted = Clock_t::now ();
+
+      boost::mutex::scoped_lock lock (mutex_);
+      const Ticket_t ticket (nextTicket_++);
+      jobs_ [ticket] = job;
+      queue_.push_back (ticket);
+      queued_.notify_one ();
+      return ticket;
+    }
+
+    const PlanningService::Job& PlanningService::job (Ticket_t ticket) const
+    {
+      Jobs_t::const_iterator it (jobs_.find (ticket));
+      if (it == jobs_.end ())
+        throw std::invalid_argument ("PlanningService: unknown ticket.");
+      return it->second;
+    }
+
+    bool PlanningService::done (Ticket_t ticket) const
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      return job (ticket).done;
+    }
+
+    bool PlanningService::wait (Ticket_t ticket, value_type seconds) const
+    {
+      const boost::system_time timeout
+        (boost::get_system_time () + boost::posix_time::microseconds
+         ((long) (1e6 * seconds)));
+      boost::mutex::scoped_lock lock (mutex_);
+      while (!job (ticket).done) {
+        if (!solved_.timed_wait (lock, timeout)) return job (ticket).done;
+      }
+      return true;
+    }
+
+    PlanningService::Result PlanningService::result (Ticket_t ticket)
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      while (!job (ticket).done) solved_.wait (lock);
+      const Result result (job (ticket).result);
+      jobs_.erase (ticket);
+      return result;
+    }
+
+    std::size_t PlanningService::pending () const
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      return queue_.size ();
+    }
+
+    PlanningService::Statistics PlanningService::statistics () const
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      return statistics_;
+    }
+
+    void PlanningService::run (std::size_t worker)
+    {
+      while (true) {
+        Ticket_t ticket;
+        Job job;
+        {
+          boost::mutex::scoped_lock lock (mutex_);
+          while (queue_.empty () && !stopped_) queued_.wait (lock);
+          if (stopped_) return;
+          ticket = queue_.front ();
+          queue_.pop_front ();
+          job = jobs_ [ticket];
+        }
+        const Clock_t::time_point start (Clock_t::now ());
+        Result result;
+        try {
+          result.path = solve (worker, job);
+        } catch (const std::exception& exc) {
+          result.error = exc.what ();
+        }
+        const Clock_t::time_point end (Clock_t::now ());
+        result.queueTime = boost::chrono::duration <value_type>
+          (start - job.submitted).count ();
+        result.solveTime = boost::chrono::duration <value_type>
+          (end - start).count ();
+        result.worker = worker;
+
+        boost::mutex::scoped_lock lock (mutex_);
+        planners_ [worker].reset ();
+        Job& stored (jobs_ [ticket]);
+        stored.result = result;
+        stored.done = true;
+        ++statistics_.requests;
+        if (!result.path) ++statistics_.failures;
+        statistics_.queueTime += result.queueTime;
+        statistics_.solveTime += result.solveTime;
+        statistics_.maxLatency = std::max (statistics_.maxLatency,
+                                           result.queueTime +
+                                           result.solveTime);
+        solved_.notify_all ();
+      }
+    }
+
+    PathVectorPtr_t PlanningService::solve (std::size_t worker,
+                                            const Job& job)
+    {
+      const Request& request (job.request);
+      const ProblemPtr_t& problem (problems_ [worker]);
+      problem->initConfig (ConfigurationPtr_t
+                           (new Configuration_t (request.init)));
+      problem->resetGoalConfigs ();
+      for (Configurations_t::const_iterator it = request.goals.begin ();
+           it != request.goals.end (); ++it)
+        problem->addGoalConfig (*it);
+
+      const SharedRoadmapPtr_t& shared (solver_.sharedRoadmap ());
+      if (shared) {
+        MultiQuerySolver::Queries_t queries;
+        for (Configurations_t::const_iterator it = request.goals.begin ();
+             it != request.goals.end (); ++it)
+          queries.push_back (MultiQuerySolver::Query_t (request.init, **it));
+        const MultiQuerySolverPtr_t solver
+          (MultiQuerySolver::create (*problem, shared));
+        // The workers already run in parallel.
+        solver->numberThreads (1);
+        const std::vector <PathVectorPtr_t> paths (solver->solve (queries));
+        PathVectorPtr_t result;
+        for (std::size_t i = 0; i < paths.size (); ++i) {
+          if (paths [i] &&
+              (!result || paths [i]->length () < result->length ()))
+            result = paths [i];
+        }
+        if (!result)
+          throw std::runtime_error ("No path was found in the shared "
+                                    "roadmap.");
+        return result;
+      }
+
+      roadmaps_ [worker]->clear ();
+      const PathPlannerPtr_t planner (job.builder (*problem,
+                                                   roadmaps_ [worker]));
+      planner->maxIterations (request.maxIterations);
+      planner->timeOut (request.timeOut);
+      planner->progressCallback
+        (boost::bind (&PlanningService::checkStop, this, worker, _1));
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        if (stopped_)
+          throw std::runtime_error ("The service was stopped.");
+        planners_ [worker] = planner;
+      }
+      return planner->solve ();
+    }
+
+    void PlanningService::checkStop (std::size_t worker,
+                                     const PathPlanner::Progress&)
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      // PathPlanner::solve clears the interruption flag when it starts.
+      if (stopped_) planners_ [worker]->interrupt ();
+    }
+  } //   namespace core
+} // namespace hpp
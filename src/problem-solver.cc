@@ -18,7 +18,14 @@
 
 #include <hpp/core/problem-solver.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
 #include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <hpp/fcl/collision_utility.h>
 
@@ -35,15 +42,26 @@
 #include <hpp/constraints/differentiable-function.hh>
 
 #include <hpp/core/configuration-shooter/uniform.hh>
+#include <hpp/core/batch-collision-validation.hh>
 #include <hpp/core/bi-rrt-planner.hh>
 #include <hpp/core/configuration-shooter/gaussian.hh>
+#include <hpp/core/configuration-shooter/bridge-test.hh>
+#include <hpp/core/configuration-shooter/goal-biased.hh>
+#include <hpp/core/configuration-shooter/halton.hh>
+#include <hpp/core/configuration-shooter/projected.hh>
 #include <hpp/core/config-projector.hh>
 #include <hpp/core/constraint-set.hh>
 #include <hpp/core/continuous-validation/dichotomy.hh>
+#include <hpp/core/continuous-validation/hierarchical.hh>
 #include <hpp/core/continuous-validation/progressive.hh>
 #include <hpp/core/diffusing-planner.hh>
+#include <hpp/core/distance/dubins.hh>
 #include <hpp/core/distance/reeds-shepp.hh>
 #include <hpp/core/distance-between-objects.hh>
+#include <hpp/core/edge.hh>
+#include <hpp/core/executor.hh>
+#include <hpp/core/multi-query-solver.hh>
+#include <hpp/core/occupancy-cache.hh>
 #include <hpp/core/roadmap.hh>
 #include <hpp/constraints/locked-joint.hh>
 #include <hpp/constraints/implicit.hh>
@@ -51,32 +69,43 @@
 #include <hpp/core/path-vector.hh>
 #include <hpp/core/path-planner/bi-rrt-star.hh>
 #include <hpp/core/path-planner/k-prm-star.hh>
+#include <hpp/core/path-planner/parallel-bi-rrt.hh>
+#include <hpp/core/path-planner/portfolio.hh>
 #include <hpp/core/path-projector/global.hh>
 #include <hpp/core/path-projector/dichotomy.hh>
 #include <hpp/core/path-projector/progressive.hh>
 #include <hpp/core/path-projector/recursive-hermite.hh>
+#include <hpp/core/path-optimization/multi-start.hh>
 #include <hpp/core/path-optimization/partial-shortcut.hh>
 #include <hpp/core/path-optimization/random-shortcut.hh>
 #include <hpp/core/path-optimization/simple-shortcut.hh>
 #include <hpp/core/path-optimization/simple-time-parameterization.hh>
+#include <hpp/core/path-optimization/toppra.hh>
+#include <hpp/core/path-validation/cached.hh>
 #include <hpp/core/path-validation/discretized-collision-checking.hh>
 #include <hpp/core/path-validation/discretized-joint-bound.hh>
 #include <hpp/core/path-validation-report.hh>
 // #include <hpp/core/problem-target/task-target.hh>
 #include <hpp/core/problem-target/goal-configurations.hh>
+#include <hpp/core/random-generator.hh>
 #include <hpp/core/roadmap.hh>
+#include <hpp/core/shared-roadmap.hh>
+#include <hpp/core/steering-method/cached.hh>
 #include <hpp/core/steering-method/dubins.hh>
 #include <hpp/core/steering-method/hermite.hh>
 #include <hpp/core/steering-method/reeds-shepp.hh>
 #include <hpp/core/steering-method/steering-kinodynamic.hh>
 #include <hpp/core/steering-method/snibud.hh>
 #include <hpp/core/steering-method/straight.hh>
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/trace.hh>
 #include <hpp/core/visibility-prm-planner.hh>
 #include <hpp/core/weighed-distance.hh>
 #include <hpp/core/collision-validation.hh>
 #include <hpp/core/joint-bound-validation.hh>
 #include <hpp/core/kinodynamic-distance.hh>
 
+#include "../src/forward-kinematics.hh"
 #include "../src/path-validation/no-validation.hh"
 
 namespace hpp {
@@ -117,6 +146,46 @@ namespace hpp {
           std::find_if(vector.begin(), vector.end(), FindCollisionObject(i));
         if (it != vector.end()) vector.erase(it);
       }
+
+      /// Build the FCL objects of the obstacles of group thread modulo
+      /// nThreads. Objects sharing a geometry are in the same group since
+      /// the constructor computes the local bounding box of the geometry.
+      void buildCollisionObjects
+      (const std::vector <FclCollisionObject>& objects,
+       const std::vector <std::size_t>& groups, std::size_t thread,
+       std::size_t nThreads, std::vector <FclCollisionObjectSharePtr_t>& built)
+      {
+        for (std::size_t k = 0; k < objects.size (); ++k) {
+          if (groups [k] % nThreads != thread) continue;
+          built [k].reset (new FclCollisionObject
+                           (objects [k].collisionGeometry ()));
+        }
+      }
+
+      /// Returns the tools of a new worker at each call.
+      struct ConnectionToolsFactory {
+        ConnectionToolsFactory (const ProblemSolver& ps) :
+          ps_ (ps), index_ (new size_type (0))
+        {
+        }
+        PathPlanner::ConnectionTools operator() () const
+        {
+          return ps_.connectionTools (++(*index_));
+        }
+        const ProblemSolver& ps_;
+        boost::shared_ptr<size_type> index_;
+      };
+
+      /// Put a path validation behind a cache if parameter
+      /// PathValidation/cacheSize is positive
+      PathValidationPtr_t cachePathValidation
+      (const Problem& problem, const PathValidationPtr_t& pathValidation)
+      {
+        const size_type cacheSize (problem.getParameter
+                                   ("PathValidation/cacheSize").intValue ());
+        if (cacheSize <= 0 || !pathValidation) return pathValidation;
+        return pathValidation::Cached::create (pathValidation, cacheSize);
+      }
     }
 
     // Struct that constructs an empty shared pointer to PathProjector.
@@ -174,6 +243,116 @@ namespace hpp {
       return ptr;
     }
 
+    configurationShooter::HaltonPtr_t createHaltonConfigShooter (const Problem& p)
+    {
+      configurationShooter::HaltonPtr_t ptr = configurationShooter::Halton::create(p.robot());
+      ptr->sampleExtraDOF(p.getParameter("ConfigurationShooter/sampleExtraDOF").boolValue());
+      return ptr;
+    }
+
+    /// Bridge test drawing its first configurations from a Uniform shooter
+    configurationShooter::BridgeTestPtr_t createBridgeTestConfigShooter (const Problem& p)
+    {
+      configurationShooter::UniformPtr_t uniform = createUniformConfigShooter (p);
+      uniform->randomGenerator (p.randomGenerator ());
+      configurationShooter::BridgeTestPtr_t ptr = configurationShooter::BridgeTest::create
+        (p.robot(), uniform, p.configValidations());
+      ptr->standardDeviation (p.getParameter
+          ("ConfigurationShooter/BridgeTest/standardDeviation").floatValue());
+      return ptr;
+    }
+
+    /// Goal biased sampling around a Uniform shooter
+    configurationShooter::GoalBiasedPtr_t createGoalBiasedConfigShooter (const Problem& p)
+    {
+      configurationShooter::UniformPtr_t uniform = createUniformConfigShooter (p);
+      uniform->randomGenerator (p.randomGenerator ());
+      configurationShooter::GoalBiasedPtr_t ptr =
+        configurationShooter::GoalBiased::create (uniform, p);
+      ptr->bias (p.getParameter ("ConfigurationShooter/GoalBiased/bias").floatValue());
+      return ptr;
+    }
+
+    /// Projection on the constraints of the problem of Uniform samples
+    configurationShooter::ProjectedPtr_t createProjectedConfigShooter (const Problem& p)
+    {
+      configurationShooter::UniformPtr_t uniform = createUniformConfigShooter (p);
+      uniform->randomGenerator (p.randomGenerator ());
+      configurationShooter::ProjectedPtr_t ptr =
+        configurationShooter::Projected::create (uniform, p);
+      ptr->poolSize (p.getParameter ("ConfigurationShooter/Projected/poolSize").intValue());
+      ptr->seedProbability (p.getParameter ("ConfigurationShooter/Projected/seedProbability").floatValue());
+      ptr->perturbation (p.getParameter ("ConfigurationShooter/Projected/perturbation").floatValue());
+      return ptr;
+    }
+
+    /// Build a portfolio from parameter "Portfolio/planners"
+    ///
+    /// Each planner is built with its own roadmap.
+    PathPlannerPtr_t createPortfolio (const ProblemSolver* ps,
+                                      const Problem& problem,
+                                      const RoadmapPtr_t& roadmap)
+    {
+      pathPlanner::PortfolioPtr_t portfolio
+        (pathPlanner::Portfolio::createWithRoadmap (problem, roadmap));
+      std::istringstream iss (problem.getParameter
+                              ("Portfolio/planners").stringValue ());
+      std::string type;
+      while (std::getline (iss, type, ',')) {
+        type.erase (0, type.find_first_not_of (" \t"));
+        type.erase (type.find_last_not_of (" \t") + 1);
+        if (type.empty ()) continue;
+        if (type == "Portfolio")
+          throw std::invalid_argument ("A portfolio cannot contain a "
+                                       "portfolio.");
+        portfolio->addPlanner (ps->pathPlanners.get (type)
+                               (problem, Roadmap::create (problem.distance (),
+                                                          problem.robot ())));
+      }
+      return portfolio;
+    }
+
+    /// Build a multi start optimizer from parameters "MultiStart/optimizer"
+    /// and "MultiStart/numberOfStarts"
+    PathOptimizerPtr_t createMultiStart (const ProblemSolver* ps,
+                                         const Problem& problem)
+    {
+      const std::string type (problem.getParameter
+                              ("MultiStart/optimizer").stringValue ());
+      if (type == "MultiStart")
+        throw std::invalid_argument ("A multi start optimizer cannot run "
+                                     "multi start optimizers.");
+      return pathOptimization::MultiStart::create
+        (problem, ps->pathOptimizers.get (type), ps->connectionToolsFactory (),
+         problem.getParameter ("MultiStart/numberOfStarts").intValue ());
+    }
+
+    /// Build a partial shortcut evaluating candidates in the number of
+    /// threads given by parameter "PartialShortcut/numberOfThreads"
+    PathOptimizerPtr_t createPartialShortcut (const ProblemSolver* ps,
+                                              const Problem& problem)
+    {
+      pathOptimization::PartialShortcutPtr_t optimizer
+        (pathOptimization::PartialShortcut::create (problem));
+      const size_type n (problem.getParameter
+                         ("PartialShortcut/numberOfThreads").intValue ());
+      if (n > 1) optimizer->parallelCandidates (n, ps->connectionToolsFactory ());
+      return optimizer;
+    }
+
+    /// Build a simple shortcut searching a visibility graph in the number
+    /// of threads given by parameter "SimpleShortcut/numberOfThreads"
+    PathOptimizerPtr_t createSimpleShortcut (const ProblemSolver* ps,
+                                             const Problem& problem)
+    {
+      pathOptimization::SimpleShortcutPtr_t optimizer
+        (pathOptimization::SimpleShortcut::create (problem));
+      const size_type n (problem.getParameter
+                         ("SimpleShortcut/numberOfThreads").intValue ());
+      if (n > 0) optimizer->visibilityGraph (n, ps->connectionToolsFactory ());
+      return optimizer;
+    }
+
     ProblemSolverPtr_t ProblemSolver::create ()
     {
       return new ProblemSolver ();
@@ -181,7 +360,7 @@ namespace hpp {
 
     ProblemSolver::ProblemSolver () :
       constraints_ (), robot_ (), problem_ (), pathPlanner_ (),
-      roadmap_ (), paths_ (),
+      roadmap_ (), sharedRoadmap_ (), paths_ (),
       pathProjectorType_ ("None"), pathProjectorTolerance_ (0.2),
       pathPlannerType_ ("DiffusingPlanner"),
       target_ (problemTarget::GoalConfigurations::create(ProblemPtr_t())),
@@ -204,7 +383,10 @@ namespace hpp {
       timeOutPathPlanning_(std::numeric_limits<double>::infinity()),
       
       passiveDofsMap_ (), comcMap_ (),
-      distanceBetweenObjects_ ()
+      distanceBetweenObjects_ (), warmStart_ (false), roadmapOutdated_ (false),
+      sceneChanges_ (), keepSetup_ (false),
+      executor_ (Executor::create
+                 (std::max (1u, boost::thread::hardware_concurrency ())))
     {
       obstacleRModel_->addFrame(::pinocchio::Frame("obstacle_frame", 0, 0, Transform3f::Identity(), ::pinocchio::BODY));
       obstacleRData_.reset (new Data (*obstacleRModel_));
@@ -216,12 +398,21 @@ namespace hpp {
       pathPlanners.add ("BiRRTPlanner", BiRRTPlanner::createWithRoadmap);
       pathPlanners.add ("kPRM*", pathPlanner::kPrmStar::createWithRoadmap);
       pathPlanners.add ("BiRRT*", pathPlanner::BiRrtStar::createWithRoadmap);
+      pathPlanners.add ("ParallelBiRRT",
+                        pathPlanner::ParallelBiRRT::createWithRoadmap);
+      pathPlanners.add ("Portfolio", bind (createPortfolio, this, _1, _2));
 
       configurationShooters.add ("Uniform" , createUniformConfigShooter);
       configurationShooters.add ("Gaussian", createGaussianConfigShooter);
+      configurationShooters.add ("BridgeTest", createBridgeTestConfigShooter);
+      configurationShooters.add ("GoalBiased", createGoalBiasedConfigShooter);
+      configurationShooters.add ("Halton",     createHaltonConfigShooter);
+      configurationShooters.add ("Projected",  createProjectedConfigShooter);
 
       distances.add ("Weighed",         WeighedDistance::createFromProblem);
+      distances.add ("WeighedFromSamples", WeighedDistance::createFromSamples);
       distances.add ("ReedsShepp",      bind (distance::ReedsShepp::create, _1));
+      distances.add ("Dubins",          bind (distance::Dubins::create, _1));
       distances.add ("Kinodynamic",     KinodynamicDistance::createFromProblem);
 
 
@@ -234,22 +425,32 @@ namespace hpp {
 
       // Store path optimization methods in map.
       pathOptimizers.add ("RandomShortcut",     pathOptimization::RandomShortcut::create);
-      pathOptimizers.add ("SimpleShortcut",     pathOptimization::SimpleShortcut::create);
-      pathOptimizers.add ("PartialShortcut",    pathOptimization::PartialShortcut::create);
+      pathOptimizers.add ("SimpleShortcut",
+                          bind (createSimpleShortcut, this, _1));
+      pathOptimizers.add ("PartialShortcut",
+                          bind (createPartialShortcut, this, _1));
       pathOptimizers.add ("SimpleTimeParameterization", pathOptimization::SimpleTimeParameterization::create);
+      pathOptimizers.add ("TOPPRA",             pathOptimization::TOPPRA::create);
+      pathOptimizers.add ("MultiStart", bind (createMultiStart, this, _1));
 
       // Store path validation methods in map.
       pathValidations.add ("NoValidation",
                            pathValidation::NoValidation::create);
       pathValidations.add ("Discretized", pathValidation::createDiscretizedCollisionChecking);
       pathValidations.add ("DiscretizedCollision", pathValidation::createDiscretizedCollisionChecking);
+      pathValidations.add ("AdaptiveDiscretizedCollision",
+                           pathValidation::createAdaptiveDiscretizedCollisionChecking);
       pathValidations.add ("DiscretizedJointBound", pathValidation::createDiscretizedJointBound);
       pathValidations.add ("DiscretizedCollisionAndJointBound", createDiscretizedJointBoundAndCollisionChecking);
       pathValidations.add ("Progressive", continuousValidation::Progressive::create);
       pathValidations.add ("Dichotomy",   continuousValidation::Dichotomy::create);
+      pathValidations.add ("Hierarchical",
+                           continuousValidation::Hierarchical::create);
 
       // Store config validation methods in map.
       configValidations.add ("CollisionValidation", CollisionValidation::create);
+      configValidations.add ("BatchCollisionValidation",
+                             BatchCollisionValidation::create);
       configValidations.add ("JointBoundValidation", JointBoundValidation::create);
 
       // Set default config validation methods.
@@ -266,6 +467,20 @@ namespace hpp {
 
     ProblemSolver::~ProblemSolver ()
     {
+      resetOccupancyCache ();
+    }
+
+    void ProblemSolver::resetOccupancyCache ()
+    {
+      if (occupancyCache_) {
+        try {
+          occupancyCache_->save (occupancyFile_);
+        } catch (const std::runtime_error& exc) {
+          hppDout (error, exc.what ());
+        }
+      }
+      occupancyCache_.reset ();
+      occupancyFile_.clear ();
     }
 
     void ProblemSolver::distanceType (const std::string& type)
@@ -331,6 +546,8 @@ namespace hpp {
       createPathOptimizers ();
       for (PathOptimizers_t::const_iterator it = pathOptimizers_.begin ();
 	   it != pathOptimizers_.end (); ++it) {
+        HPP_CORE_TRACE_SPAN ("PathOptimizer::optimize");
+        HPP_CORE_ALLOCATION_SCOPE (OPTIMIZATION);
 	path = (*it)->optimize (path);
 	paths_.push_back (path);
       }
@@ -354,9 +571,9 @@ namespace hpp {
     void ProblemSolver::initPathValidation ()
     {
       if (!problem_) throw std::runtime_error ("The problem is not defined.");
-      PathValidationPtr_t pathValidation =
-        pathValidations.get (pathValidationType_)
-        (robot_, pathValidationTolerance_);
+      PathValidationPtr_t pathValidation = cachePathValidation
+        (*problem_, pathValidations.get (pathValidationType_)
+         (robot_, pathValidationTolerance_));
       problem_->pathValidation (pathValidation);
     }
 
@@ -365,12 +582,37 @@ namespace hpp {
       if (!robot_) throw std::logic_error ("You must provide a robot first");
       if (!problem_) throw std::runtime_error ("The problem is not defined.");
       problem_->resetConfigValidations();
+      const std::string filename (problem_->getParameter
+                                  ("CollisionValidation/occupancyCache")
+                                  .stringValue ());
+      if (filename != occupancyFile_) resetOccupancyCache ();
+      if (!filename.empty () && !occupancyCache_) {
+        if (std::ifstream (filename.c_str ())) {
+          try {
+            occupancyCache_ = OccupancyCache::load (robot_, filename);
+          } catch (const std::runtime_error& exc) {
+            hppDout (warning, exc.what ());
+          }
+        }
+        if (!occupancyCache_) {
+          occupancyCache_ = OccupancyCache::create
+            (robot_, problem_->getParameter
+             ("CollisionValidation/occupancyResolution").floatValue (),
+             problem_->getParameter
+             ("CollisionValidation/occupancyLevels").intValue ());
+        }
+        occupancyFile_ = filename;
+      }
       for (ConfigValidationTypes_t::const_iterator it =
           configValidationTypes_.begin (); it != configValidationTypes_.end ();
           ++it)
       {
         ConfigValidationPtr_t configValidation =
           configValidations.get (*it) (robot_);
+        CollisionValidationPtr_t collisionValidation
+          (HPP_DYNAMIC_PTR_CAST (CollisionValidation, configValidation));
+        if (collisionValidation && occupancyCache_)
+          collisionValidation->occupancyCache (occupancyCache_);
         problem_->addConfigValidation (configValidation);
       }
     }
@@ -440,6 +682,7 @@ namespace hpp {
 
     void ProblemSolver::robot (const DevicePtr_t& robot)
     {
+      if (robot != robot_) resetOccupancyCache ();
       robot_ = robot;
       constraints_ = ConstraintSet::create (robot_, "Default constraint set");
       // Reset obstacles
@@ -448,6 +691,7 @@ namespace hpp {
       obstacleRData_.reset (new Data(*obstacleRModel_));
       obstacleModel_.reset (new GeomModel());
       obstacleData_ .reset (new GeomData(*obstacleModel_));
+      obstacleIndices_.clear ();
       resetProblem ();
     }
 
@@ -657,9 +901,29 @@ namespace hpp {
       initializeProblem (Problem::create(robot_));
     }
 
+    void ProblemSolver::resetQuery ()
+    {
+      if (!problem_) throw std::runtime_error ("The problem is not defined.");
+      initConf_.reset ();
+      goalConfigurations_.clear ();
+      target_ = problemTarget::GoalConfigurations::create (ProblemPtr_t ());
+      problem_->initConfig (ConfigurationPtr_t ());
+      problem_->resetGoalConfigs ();
+      if (!sharedRoadmap_) {
+        if (roadmap_) roadmap_->clear ();
+        else resetRoadmap ();
+        roadmapOutdated_ = false;
+        sceneChanges_.clear ();
+      }
+      // The objects built by initProblem belong to the current problem if
+      // the path planner does.
+      keepSetup_ = pathPlanner_ && &pathPlanner_->problem () == problem_.get ();
+    }
+
     void ProblemSolver::initializeProblem (ProblemPtr_t problem)
     {
       problem_ = problem;
+      keepSetup_ = false;
       resetRoadmap ();
       // Set constraints
       problem_->constraints (constraints_);
@@ -678,6 +942,7 @@ namespace hpp {
     void ProblemSolver::problem (ProblemPtr_t problem)
     {
       problem_ = problem;
+      keepSetup_ = false;
     }
 
     void ProblemSolver::resetRoadmap ()
@@ -685,6 +950,136 @@ namespace hpp {
       if (!problem_)
         throw std::runtime_error ("The problem is not defined.");
       roadmap_ = Roadmap::create (problem_->distance (), problem_->robot());
+      roadmapOutdated_ = false;
+      sceneChanges_.clear ();
+    }
+
+    void ProblemSolver::obstacleChanged (const fcl::AABB& box,
+                                         value_type displacement)
+    {
+      if (warmStart_ && roadmap_) {
+        roadmapOutdated_ = true;
+        SceneChange change;
+        change.box = box;
+        change.displacement = displacement;
+        sceneChanges_.push_back (change);
+      } else {
+        resetRoadmap ();
+      }
+    }
+
+    fcl::AABB ProblemSolver::sweptVolume (const PathPtr_t& path) const
+    {
+      const value_type step (problem_->getParameter
+                             ("WarmStart/sweptVolumeStep").floatValue ());
+      const value_type margin (problem_->getParameter
+                               ("WarmStart/sweptVolumeMargin").floatValue ());
+      pinocchio::DeviceSync robot (robot_);
+      const GeomModel& model (robot.geomModel ());
+      const interval_t& range (path->timeRange ());
+      const value_type length (range.second - range.first);
+      const size_type n (step > 0 ?
+                         std::max <size_type>
+                         (1, (size_type) std::ceil (length / step)) : 1);
+      fcl::AABB result;
+      Configuration_t q (path->outputSize ());
+      for (size_type i = 0; i <= n; ++i) {
+        const value_type t (range.first + length * (value_type) i /
+                            (value_type) n);
+        if (!(*path) (q, t)) {
+          // The robot is somewhere else: the edge may collide anywhere.
+          const value_type inf (std::numeric_limits <value_type>::max ());
+          return fcl::AABB (fcl::Vec3f (-inf, -inf, -inf),
+                            fcl::Vec3f (inf, inf, inf));
+        }
+        computeGeometryPlacements (robot, q);
+        const GeomData& data (robot.geomData ());
+        for (std::size_t j = 0; j < model.geometryObjects.size (); ++j) {
+          const fcl::CollisionGeometry& geometry
+            (*model.geometryObjects [j].geometry);
+          const fcl::Vec3f center (::pinocchio::toFclTransform3f
+                                   (data.oMg [j]).transform
+                                   (geometry.aabb_center));
+          const value_type r (geometry.aabb_radius + margin);
+          const fcl::Vec3f radius (r, r, r);
+          result += fcl::AABB (center - radius, center + radius);
+        }
+      }
+      return result;
+    }
+
+    fcl::AABB ProblemSolver::obstacleBox (const GeomIndex& id) const
+    {
+      fcl::CollisionObject& object (obstacleData_->collisionObjects [id]);
+      object.computeAABB ();
+      return object.getAABB ();
+    }
+
+    bool ProblemSolver::affected (const EdgePtr_t& edge)
+    {
+      if (edge->sweptVolume ().min_ [0] > edge->sweptVolume ().max_ [0])
+        roadmap_->sweptVolume (edge, sweptVolume (edge->path ()));
+      for (std::vector <SceneChange>::const_iterator it
+             (sceneChanges_.begin ()); it != sceneChanges_.end (); ++it) {
+        // The robot stays at distance clearance from the obstacle before
+        // the change, which moves its points by less than that.
+        if (edge->clearance () > it->displacement) continue;
+        if (edge->sweptVolume ().overlap (it->box)) return true;
+      }
+      return false;
+    }
+
+    void ProblemSolver::revalidateRoadmap ()
+    {
+      if (!roadmapOutdated_) return;
+      roadmapOutdated_ = false;
+      const Edges_t& edges (roadmap_->edges ());
+      std::vector <PathPtr_t> paths;
+      // Whether each edge is validated again
+      std::vector <bool> checked;
+      paths.reserve (edges.size ());
+      checked.reserve (edges.size ());
+      for (Edges_t::const_iterator it = edges.begin (); it != edges.end ();
+           ++it) {
+        // Edges that are not validated yet are validated by the planner.
+        checked.push_back ((*it)->validated () && affected (*it));
+        if (checked.back ()) paths.push_back ((*it)->path ());
+      }
+      sceneChanges_.clear ();
+      hppDout (info, "Validating again " << paths.size () << " edges out of "
+               << edges.size () << " after obstacles changed.");
+      std::vector <PathPtr_t> validParts;
+      std::vector <PathValidationReportPtr_t> reports;
+      std::vector <bool> valid;
+      if (paths.empty () ||
+          problem_->pathValidation ()->validatePaths (paths, false, validParts,
+                                                      reports, valid))
+        return;
+
+      // Removing validated edges may split connected components: copy the
+      // nodes and the edges that are still valid in a new roadmap.
+      hppDout (info, "Rebuilding the roadmap without the edges invalidated "
+               "by obstacles.");
+      RoadmapPtr_t roadmap (Roadmap::create (problem_->distance (),
+                                             problem_->robot ()));
+      std::map <NodePtr_t, NodePtr_t> newNodes;
+      for (Nodes_t::const_iterator it = roadmap_->nodes ().begin ();
+           it != roadmap_->nodes ().end (); ++it) {
+        newNodes [*it] = roadmap->addNode (*(*it)->configuration ());
+      }
+      std::size_t i = 0, k = 0;
+      for (Edges_t::const_iterator it = edges.begin (); it != edges.end ();
+           ++it, ++k) {
+        if (checked [k] && !valid [i++]) continue;
+        EdgePtr_t edge (roadmap->addEdge (newNodes [(*it)->from ()],
+                                          newNodes [(*it)->to ()],
+                                          (*it)->path (),
+                                          (*it)->validated ()));
+        if ((*it)->clearance () >= 0)
+          roadmap->clearance (edge, (*it)->clearance ());
+        roadmap->sweptVolume (edge, (*it)->sweptVolume ());
+      }
+      roadmap_ = roadmap;
     }
 
     void ProblemSolver::createPathOptimizers ()
@@ -713,6 +1108,10 @@ namespace hpp {
       SteeringMethodPtr_t sm (
           steeringMethods.get (steeringMethodType_) (*problem_)
           );
+      const size_type cacheSize (problem_->getParameter
+                                 ("SteeringMethod/cacheSize").intValue ());
+      if (cacheSize > 0)
+        sm = steeringMethod::Cached::create (sm, cacheSize);
       problem_->steeringMethod (sm);
     }
 
@@ -742,19 +1141,25 @@ namespace hpp {
     {
       if (!problem_) throw std::runtime_error ("The problem is not defined.");
 
-
-      // Set shooter
-      problem_->configurationShooter
-        (configurationShooters.get (configurationShooterType_) (*problem_));
-      // Set steeringMethod
-      initSteeringMethod ();
+      const bool keepSetup (keepSetup_);
+      keepSetup_ = false;
+      if (!keepSetup) {
+        // Set shooter
+        problem_->configurationShooter
+          (configurationShooters.get (configurationShooterType_) (*problem_));
+        problem_->configurationShooter ()->randomGenerator
+          (problem_->randomGenerator ());
+        // Set steeringMethod
+        initSteeringMethod ();
+      }
       PathPlannerBuilder_t createPlanner = pathPlanners.get (pathPlannerType_);
       pathPlanner_ = createPlanner (*problem_, roadmap_);
       pathPlanner_->maxIterations (maxIterPathPlanning_);
       pathPlanner_->timeOut(timeOutPathPlanning_);
+      pathPlanner_->executor (executor_);
       roadmap_ = pathPlanner_->roadmap();
       /// create Path projector
-      initPathProjector ();
+      if (!keepSetup) initPathProjector ();
       /// create Path optimizer
       // Reset init and goal configurations
       problem_->initConfig (initConf_);
@@ -769,6 +1174,7 @@ namespace hpp {
 
     bool ProblemSolver::prepareSolveStepByStep ()
     {
+      revalidateRoadmap ();
       initProblem ();
 
       pathPlanner_->startSolve ();
@@ -790,8 +1196,45 @@ namespace hpp {
       paths_.push_back (pathPlanner_->finishSolve (planned));
     }
 
+    namespace {
+      /// Trace a resolution if parameter "Trace/file" is set, and write the
+      /// trace at the end of the scope
+      struct TraceScope
+      {
+        explicit TraceScope (const ProblemPtr_t& problem)
+        {
+          if (!problem) return;
+          filename = problem->getParameter ("Trace/file").stringValue ();
+          if (filename.empty ()) return;
+          Trace::enable ((std::size_t) problem->getParameter
+                         ("Trace/capacity").intValue ());
+          Trace::clear ();
+        }
+        ~TraceScope ()
+        {
+          if (filename.empty ()) return;
+          Trace::disable ();
+          try {
+            Trace::dump (filename);
+          } catch (const std::exception& exc) {
+            hppDout (error, exc.what ());
+          }
+        }
+        std::string filename;
+      }; // struct TraceScope
+    } // namespace
+
     void ProblemSolver::solve ()
     {
+      TraceScope trace (problem_);
+      if (sharedRoadmap_) {
+        initProblem ();
+        PathVectorPtr_t path = solveInSharedRoadmap ();
+        paths_.push_back (path);
+        optimizePath (path);
+        return;
+      }
+      revalidateRoadmap ();
       initProblem ();
 
       PathVectorPtr_t path = pathPlanner_->solve ();
@@ -799,6 +1242,74 @@ namespace hpp {
       optimizePath (path);
     }
 
+    PathVectorPtr_t ProblemSolver::solveInSharedRoadmap () const
+    {
+      if (!problem_->initConfig ())
+        throw std::runtime_error ("The initial configuration is not set.");
+      const Configurations_t& goals (problem_->goalConfigs ());
+      MultiQuerySolver::Queries_t queries;
+      for (Configurations_t::const_iterator it = goals.begin ();
+           it != goals.end (); ++it)
+        queries.push_back (MultiQuerySolver::Query_t
+                           (*problem_->initConfig (), **it));
+      if (queries.empty ())
+        throw std::runtime_error ("Solving in a shared roadmap requires goal "
+                                  "configurations.");
+      const MultiQuerySolverPtr_t solver
+        (MultiQuerySolver::create (*problem_, sharedRoadmap_));
+      solver->executor (executor_);
+      const std::vector <PathVectorPtr_t> paths (solver->solve (queries));
+      PathVectorPtr_t result;
+      for (std::size_t i = 0; i < paths.size (); ++i) {
+        if (paths [i] && (!result || paths [i]->length () < result->length ()))
+          result = paths [i];
+      }
+      if (!result)
+        throw std::runtime_error ("No path was found in the shared roadmap.");
+      return result;
+    }
+
+    const PlannerStatistics& ProblemSolver::plannerStatistics () const
+    {
+      if (!pathPlanner_)
+        throw std::logic_error ("No path planner was created.");
+      return pathPlanner_->statistics ();
+    }
+
+    const PathOptimizer::Statistics& ProblemSolver::optimizerStatistics
+    (std::size_t rank) const
+    {
+      return pathOptimizers_.at (rank)->statistics ();
+    }
+
+    PathPlanner::ConnectionTools ProblemSolver::connectionTools
+    (size_type index) const
+    {
+      if (!problem_) throw std::runtime_error ("The problem is not defined.");
+      if (!problem_->steeringMethod ())
+        throw std::logic_error ("The problem has no steering method.");
+      PathPlanner::ConnectionTools tools;
+      tools.steeringMethod = problem_->steeringMethod ()->copy ();
+      tools.pathValidation = cachePathValidation
+        (*problem_, pathValidations.get (pathValidationType_)
+         (robot_, pathValidationTolerance_));
+      problem_->setupPathValidation (tools.pathValidation);
+      tools.pathProjector = pathProjectors.get (pathProjectorType_)
+        (*problem_, pathProjectorTolerance_);
+      tools.configurationShooter =
+        configurationShooters.get (configurationShooterType_) (*problem_);
+      tools.configurationShooter->randomGenerator
+        (problem_->randomGenerator ()->split
+         ((RandomGenerator::result_type) index));
+      return tools;
+    }
+
+    PathPlanner::ConnectionToolsFactory_t
+    ProblemSolver::connectionToolsFactory () const
+    {
+      return ConnectionToolsFactory (*this);
+    }
+
     bool ProblemSolver::directPath
     (ConfigurationIn_t start, ConfigurationIn_t end, bool validate,
      std::size_t& pathId, std::string& report)
@@ -921,7 +1432,8 @@ namespace hpp {
                                      /*const*/ FclCollisionObject &inObject,
 				     bool collision, bool distance)
     {
-      if (obstacleModel_->existGeometryName(name)) {
+      ::pinocchio::GeomIndex existing;
+      if (obstacleIndex (name, existing)) {
         HPP_THROW(std::runtime_error, "object with name " << name
             << " already added! Choose another name (prefix).");
       }
@@ -933,6 +1445,7 @@ namespace hpp {
             "",
             vector3_t::Ones()),
           *obstacleRModel_);
+      obstacleIndices_.add (name, id);
       // Update obstacleData_
       // FIXME This should be done in Pinocchio
       {
@@ -953,7 +1466,7 @@ namespace hpp {
 
       if (collision){
         collisionObstacles_.push_back (object);
-        resetRoadmap ();
+        obstacleChanged (obstacleBox (id));
       }
       if (distance)
         distanceObstacles_.push_back (object);
@@ -964,16 +1477,109 @@ namespace hpp {
       }
     }
 
+    void ProblemSolver::addObstacles
+    (const std::vector <std::string>& names,
+     const std::vector <FclCollisionObject>& objects, bool collision,
+     bool distance, size_type numberThreads)
+    {
+      if (names.size () != objects.size ())
+        throw std::invalid_argument ("addObstacles expects one name per "
+                                     "object.");
+      if (numberThreads < 1)
+        throw std::invalid_argument ("number of threads should be positive.");
+      // Check all the names before modifying the model.
+      boost::unordered_map <std::string, std::size_t> batch;
+      for (std::size_t k = 0; k < names.size (); ++k) {
+        GeomIndex existing;
+        if (obstacleIndex (names [k], existing)
+            || !batch.insert (std::make_pair (names [k], k)).second) {
+          HPP_THROW(std::runtime_error, "object with name " << names [k]
+              << " already added! Choose another name (prefix).");
+        }
+      }
+      if (objects.empty ()) return;
+
+      // Build the FCL objects of the geometry data, which computes the
+      // bounding boxes of the geometries, in parallel.
+      boost::unordered_map <const fcl::CollisionGeometry*, std::size_t>
+        geometries;
+      std::vector <std::size_t> groups (objects.size ());
+      for (std::size_t k = 0; k < objects.size (); ++k) {
+        groups [k] = geometries.insert (std::make_pair
+            (objects [k].collisionGeometry ().get (), geometries.size ()))
+          .first->second;
+      }
+      std::vector <FclCollisionObjectSharePtr_t> built (objects.size ());
+      const std::size_t nThreads
+        (std::min ((std::size_t) numberThreads, geometries.size ()));
+      if (nThreads <= 1) {
+        buildCollisionObjects (objects, groups, 0, 1, built);
+      } else {
+        Executor::Tasks_t tasks;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          tasks.push_back
+            (boost::bind (&buildCollisionObjects, boost::cref (objects),
+                          boost::cref (groups), t, nThreads,
+                          boost::ref (built)));
+        }
+        Executor::run (executor_, tasks);
+      }
+
+      ::pinocchio::GeometryModel& model = *obstacleModel_;
+      ::pinocchio::GeometryData& data = *obstacleData_;
+      model.geometryObjects.reserve (model.ngeoms + objects.size ());
+      data.collisionObjects.reserve (model.ngeoms + objects.size ());
+      ObjectStdVector_t added;
+      added.reserve (objects.size ());
+      for (std::size_t k = 0; k < objects.size (); ++k) {
+        GeomIndex id = model.addGeometryObject(::pinocchio::GeometryObject(
+              names [k], 1, 0,
+              objects [k].collisionGeometry(),
+              ::pinocchio::toPinocchioSE3(objects [k].getTransform()),
+              "",
+              vector3_t::Ones()),
+            *obstacleRModel_);
+        obstacleIndices_.add (names [k], id);
+        // Update obstacleData_ as in addObstacle
+        data.oMg.resize(model.ngeoms);
+        data.collisionObjects.push_back (*built [k]);
+        data.oMg[id] =  model.geometryObjects[id].placement;
+        data.collisionObjects[id].setTransform( ::pinocchio::toFclTransform3f(data.oMg[id]) );
+        added.push_back (CollisionObjectPtr_t
+                         (new CollisionObject(obstacleModel_,obstacleData_,id)));
+      }
+
+      if (collision) {
+        collisionObstacles_.insert (collisionObstacles_.end (),
+                                    added.begin (), added.end ());
+        for (ObjectStdVector_t::const_iterator it = added.begin ();
+             it != added.end (); ++it)
+          obstacleChanged (obstacleBox ((*it)->indexInModel ()));
+      }
+      if (distance)
+        distanceObstacles_.insert (distanceObstacles_.end (),
+                                   added.begin (), added.end ());
+      for (ObjectStdVector_t::const_iterator it = added.begin ();
+           it != added.end (); ++it) {
+        if (problem ())
+          problem ()->addObstacle (*it);
+        if (distanceBetweenObjects_)
+          distanceBetweenObjects_->addObstacle (*it);
+      }
+    }
+
     void ProblemSolver::removeObstacle (const std::string& name)
     {
-      if (!obstacleModel_->existGeometryName(name)) {
+      ::pinocchio::GeomIndex id;
+      if (!obstacleIndex (name, id)) {
         HPP_THROW(std::invalid_argument, "No obstacle with name " << name);
       }
-      ::pinocchio::GeomIndex id = obstacleModel_->getGeometryId(name);
 
       // Update obstacle model
       remove(obstacleModel_->geometryObjects, id);
       obstacleModel_->ngeoms--;
+      // The next lookups of the obstacles after id rebuild the index.
+      obstacleIndices_.erase (name);
       remove(obstacleData_->oMg, id);
       remove(obstacleData_->collisionObjects, id);
 
@@ -991,17 +1597,27 @@ namespace hpp {
         if (oid > id)
           _o->reset(new CollisionObject(obstacleModel_,obstacleData_,oid-1));
       }
+      // Removing an obstacle does not invalidate any edge.
+      RoadmapPtr_t roadmap (roadmap_);
+      const bool outdated (roadmapOutdated_);
+      const std::vector <SceneChange> changes (sceneChanges_);
       resetProblem(); // resets problem_ and distanceBetweenObjects_
-      resetRoadmap();
+      if (warmStart_ && roadmap) {
+        roadmap_ = roadmap;
+        roadmapOutdated_ = outdated;
+        sceneChanges_ = changes;
+      } else {
+        resetRoadmap();
+      }
     }
 
     void ProblemSolver::cutObstacle (const std::string& name,
                                      const fcl::AABB& aabb)
     {
-      if (!obstacleModel_->existGeometryName(name)) {
+      ::pinocchio::GeomIndex id;
+      if (!obstacleIndex (name, id)) {
         HPP_THROW(std::invalid_argument, "No obstacle with name " << name);
       }
-      ::pinocchio::GeomIndex id = obstacleModel_->getGeometryId(name);
 
       fcl::Transform3f oMg = ::pinocchio::toFclTransform3f(obstacleData_->oMg[id]);
       fcl::CollisionGeometryPtr_t fclgeom = obstacleModel_->geometryObjects[id].geometry;
@@ -1022,6 +1638,86 @@ namespace hpp {
       }
     }
 
+    void ProblemSolver::moveObstacle (const std::string& name,
+                                      const Transform3f& placement)
+    {
+      ::pinocchio::GeomIndex id;
+      if (!obstacleIndex (name, id)) {
+        HPP_THROW(std::invalid_argument, "No obstacle with name " << name);
+      }
+
+      const fcl::AABB before (obstacleBox (id));
+      // The displacement of the points of the obstacle is an affine
+      // function of the point, its norm is maximal at a corner of the box.
+      const Transform3f move (placement * obstacleData_->oMg[id].inverse ());
+      value_type displacement (0);
+      for (std::size_t c = 0; c < 8; ++c) {
+        const vector3_t corner (c & 1 ? before.max_ [0] : before.min_ [0],
+                                c & 2 ? before.max_ [1] : before.min_ [1],
+                                c & 4 ? before.max_ [2] : before.min_ [2]);
+        displacement = std::max (displacement,
+                                 (move.act (corner) - corner).norm ());
+      }
+      obstacleModel_->geometryObjects[id].placement = placement;
+      obstacleData_->oMg[id] = placement;
+      obstacleData_->collisionObjects[id].setTransform
+        (::pinocchio::toFclTransform3f(placement));
+      obstacleUpdated (id, before, displacement);
+    }
+
+    void ProblemSolver::replaceObstacleGeometry
+    (const std::string& name, const fcl::CollisionGeometryPtr_t& geometry)
+    {
+      ::pinocchio::GeomIndex id;
+      if (!obstacleIndex (name, id)) {
+        HPP_THROW(std::invalid_argument, "No obstacle with name " << name);
+      }
+
+      const fcl::AABB before (obstacleBox (id));
+      geometry->computeLocalAABB();
+      obstacleModel_->geometryObjects[id].geometry = geometry;
+      obstacleData_->collisionObjects[id] = fcl::CollisionObject
+        (geometry, ::pinocchio::toFclTransform3f(obstacleData_->oMg[id]));
+      obstacleUpdated (id, before);
+    }
+
+    bool ProblemSolver::obstacleIndex (const std::string& name,
+                                       GeomIndex& id) const
+    {
+      const GeomModel& model (*obstacleModel_);
+      ObstacleIndices_t::const_iterator it (obstacleIndices_.map.find (name));
+      if (it != obstacleIndices_.map.end ()
+          && it->second < model.geometryObjects.size ()
+          && model.geometryObjects [it->second].name == name) {
+        id = it->second;
+        return true;
+      }
+      // The model was modified without the index, for instance through
+      // obstacleGeomModel, or there is no such obstacle.
+      if (!model.existGeometryName (name)) return false;
+      obstacleIndices_.clear ();
+      for (GeomIndex i = 0; i < model.geometryObjects.size (); ++i)
+        obstacleIndices_.add (model.geometryObjects [i].name, i);
+      id = obstacleIndices_.get (name);
+      return true;
+    }
+
+    void ProblemSolver::obstacleUpdated (const GeomIndex& id,
+                                         const fcl::AABB& before,
+                                         value_type displacement)
+    {
+      for (ObjectStdVector_t::const_iterator _o = collisionObstacles_.begin();
+          _o != collisionObstacles_.end(); ++_o) {
+        if ((*_o)->indexInModel() == id) {
+          obstacleChanged (before + obstacleBox (id), displacement);
+          break;
+        }
+      }
+      if (problem ())
+        problem ()->updateObstacle
+          (obstacle (obstacleModel_->geometryObjects[id].name));
+    }
+
     void ProblemSolver::removeObstacleFromJoint
     (const std::string& obstacleName, const std::string& jointName)
     {
@@ -1050,8 +1746,8 @@ namespace hpp {
 
     CollisionObjectPtr_t ProblemSolver::obstacle (const std::string& name) const
     {
-      if (obstacleModel_->existGeometryName(name)) {
-        ::pinocchio::GeomIndex id = obstacleModel_->getGeometryId(name);
+      ::pinocchio::GeomIndex id;
+      if (obstacleIndex (name, id)) {
         return CollisionObjectPtr_t (
             new CollisionObject(obstacleModel_,obstacleData_,id));
       }
@@ -1099,6 +1795,56 @@ namespace hpp {
     // ----------- Declare parameters ------------------------------------- //
 
     HPP_START_PARAMETER_DECLARATION(ProblemSolver)
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "WarmStart/sweptVolumeStep",
+          "Step of the times at which the robot is placed along the paths "
+          "of the edges to compute their swept volumes, see "
+          "ProblemSolver::warmStart.",
+          Parameter(0.02)));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "WarmStart/sweptVolumeMargin",
+          "Margin added to the bounding spheres of the robot geometries "
+          "in the swept volumes of the edges, to cover the motion between "
+          "two steps.",
+          Parameter(0.05)));
+    Problem::declareParameter(ParameterDescription (Parameter::STRING,
+          "Trace/file",
+          "File in which ProblemSolver::solve writes the timeline of the "
+          "planning and optimization steps, in the Chrome trace event "
+          "format, see Trace. Empty to disable tracing.",
+          Parameter(std::string())));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "Trace/capacity",
+          "Number of spans kept by each thread when tracing, the oldest "
+          "ones being overwritten.",
+          Parameter((size_type)65536)));
+    Problem::declareParameter(ParameterDescription (Parameter::STRING,
+          "CollisionValidation/occupancyCache",
+          "File of the cells of the configuration space certified collision "
+          "free by the collision validations, see OccupancyCache. The cells "
+          "are loaded from the file if it exists and saved when the "
+          "problem solver is destroyed. Empty to disable.",
+          Parameter(std::string())));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "CollisionValidation/occupancyResolution",
+          "Width of the smallest cells of a new occupancy cache.",
+          Parameter(0.01)));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "CollisionValidation/occupancyLevels",
+          "Number of levels of the cells of a new occupancy cache, the "
+          "width of the cells doubling from a level to the next.",
+          Parameter((size_type)10)));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "PathValidation/cacheSize",
+          "Number of path validation results kept by a cache in front of the "
+          "path validation, see pathValidation::Cached. 0 disables the "
+          "cache.",
+          Parameter((size_type)0)));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "SteeringMethod/cacheSize",
+          "Number of paths kept by a cache in front of the steering method, "
+          "see steeringMethod::Cached. 0 disables the cache.",
+          Parameter((size_type)0)));
     Problem::declareParameter(ParameterDescription(Parameter::VECTOR,
 	  "ConfigurationShooter/Gaussian/center",
 	  "Center of gaussian random distribution.",
@@ -1115,6 +1861,52 @@ namespace hpp {
           "ConfigurationShooter/sampleExtraDOF",
           "If false, the value of the random configuration extraDOF are set to 0.",
           Parameter(true)));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "ConfigurationShooter/BridgeTest/standardDeviation",
+          "Standard deviation of the velocity between the configurations of "
+          "a bridge.",
+          Parameter(0.1)));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "ConfigurationShooter/GoalBiased/bias",
+          "Probability to sample a goal configuration.",
+          Parameter(0.05)));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "ConfigurationShooter/Projected/poolSize",
+          "Number of projected configurations kept as starts of projections.",
+          Parameter((size_type)100)));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "ConfigurationShooter/Projected/seedProbability",
+          "Probability to start a projection from a kept configuration.",
+          Parameter(0.5)));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "ConfigurationShooter/Projected/perturbation",
+          "Interpolation parameter between a kept configuration and a random "
+          "one giving the start of a projection.",
+          Parameter(0.1)));
+    Problem::declareParameter(ParameterDescription (Parameter::STRING,
+          "Portfolio/planners",
+          "Comma separated types of the planners run by path planner "
+          "Portfolio.",
+          Parameter(std::string("DiffusingPlanner,BiRRTPlanner"))));
+    Problem::declareParameter(ParameterDescription (Parameter::STRING,
+          "MultiStart/optimizer",
+          "Type of the path optimizer run by path optimizer MultiStart.",
+          Parameter(std::string("RandomShortcut"))));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "MultiStart/numberOfStarts",
+          "Number of instances run concurrently by path optimizer MultiStart.",
+          Parameter((size_type)4)));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "PartialShortcut/numberOfThreads",
+          "Number of threads evaluating the candidates of path optimizer "
+          "PartialShortcut. 1 for a sequential optimization.",
+          Parameter((size_type)1)));
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "SimpleShortcut/numberOfThreads",
+          "Number of threads validating the pairs of waypoints of path "
+          "optimizer SimpleShortcut in a visibility graph. 0 to build a "
+          "roadmap of all the pairs.",
+          Parameter((size_type)0)));
     HPP_END_PARAMETER_DECLARATION(ProblemSolver)
   } //   namespace core
 } // namespace hpp
@@ -60,7 +60,16 @@ namespace hpp {
       {
         ProblemPtr_t problem (problem_.lock());
         assert (problem);
-        Astar astar (roadmap, problem->distance ());
+        const GoalDistanceField* distanceField (0x0);
+        if (problem->getParameter
+            ("GoalConfigurations/distanceField").boolValue ()) {
+          if (!distanceField_)
+            distanceField_.reset (new GoalDistanceField);
+          if (!distanceField_->valid (roadmap))
+            distanceField_->compute (roadmap);
+          distanceField = distanceField_.get ();
+        }
+        Astar astar (roadmap, problem->distance (), distanceField);
         PathVectorPtr_t sol = PathVector::create (
             problem->robot()->configSize(), problem->robot()->numberDof());
         astar.solution (sol);
@@ -73,6 +82,17 @@ namespace hpp {
         }
         return sol;
       }
+
+      // ----------- Declare parameters ------------------------------------- //
+
+      HPP_START_PARAMETER_DECLARATION(GoalConfigurations)
+      Problem::declareParameter(ParameterDescription (Parameter::BOOL,
+            "GoalConfigurations/distanceField",
+            "Whether to compute the cost to the goal nodes of every node of "
+            "the roadmap and use it as A* heuristic. The costs are reused "
+            "as long as the roadmap is not modified.",
+            Parameter(false)));
+      HPP_END_PARAMETER_DECLARATION(GoalConfigurations)
     } // namespace problemTarget
   } // namespace core
 } // namespace hpp
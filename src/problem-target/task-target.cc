@@ -18,17 +18,63 @@
 
 #include <stdexcept>
 
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/core/configuration-shooter.hh>
 #include <hpp/core/node.hh>
 #include <hpp/core/connected-component.hh>
+#include <hpp/core/path-validation.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/roadmap.hh>
 #include <hpp/core/constraint-set.hh>
+#include <hpp/core/steering-method.hh>
 
 #include "../astar.hh"
 
 namespace hpp {
   namespace core {
     namespace problemTarget {
+      /// Goals sampled in background threads
+      struct TaskTarget::Sampler
+      {
+        Sampler (size_type n) : numberGoals (n), stop (false) {}
+
+        /// Body of a thread, that owns its constraints and tools
+        static void sample (const boost::shared_ptr <Sampler>& sampler,
+                            const ConstraintSetPtr_t& constraints,
+                            const ConnectionTools& tools)
+        {
+          Configuration_t q;
+          value_type lastValidTime;
+          while (true) {
+            {
+              boost::mutex::scoped_lock lock (sampler->mutex);
+              if (sampler->stop ||
+                  (size_type) sampler->goals.size () >= sampler->numberGoals)
+                return;
+            }
+            tools.configurationShooter->shoot (q);
+            if (!constraints->apply (q)) continue;
+            PathPtr_t path ((*tools.steeringMethod) (q, q));
+            if (!path ||
+                !tools.pathValidation->isValid (path, false, lastValidTime))
+              continue;
+            boost::mutex::scoped_lock lock (sampler->mutex);
+            if ((size_type) sampler->goals.size () < sampler->numberGoals)
+              sampler->goals.push_back
+                (ConfigurationPtr_t (new Configuration_t (q)));
+          }
+        }
+
+        size_type numberGoals;
+        bool stop;
+        Configurations_t goals;
+        mutable boost::mutex mutex;
+        boost::thread_group threads;
+      }; // struct Sampler
+
       TaskTargetPtr_t TaskTarget::create (const ProblemPtr_t& problem)
       {
         TaskTarget* tt = new TaskTarget (problem);
@@ -37,6 +83,79 @@ namespace hpp {
         return shPtr;
       }
 
+      TaskTarget::TaskTarget (const ProblemPtr_t& problem)
+        : ProblemTarget (problem), added_ (0)
+      {
+      }
+
+      TaskTarget::~TaskTarget ()
+      {
+        stopSampling ();
+      }
+
+      void TaskTarget::sampleGoals (size_type numberThreads,
+                                    size_type numberGoals,
+                                    const ConnectionToolsFactory_t& factory)
+      {
+        if (numberThreads < 1 || numberGoals < 1 || !factory)
+          throw std::invalid_argument ("Sampling goals requires positive "
+                                       "numbers of threads and goals and a "
+                                       "factory.");
+        if (!constraints_)
+          throw std::runtime_error ("No constraints: task not specified.");
+        std::vector <ConnectionTools> tools;
+        for (size_type i = 0; i < numberThreads; ++i) {
+          tools.push_back (factory ());
+          if (!tools.back ().configurationShooter)
+            throw std::invalid_argument ("Sampling goals requires a "
+                                         "configuration shooter per thread.");
+        }
+        stopSampling ();
+        sampler_.reset (new Sampler (numberGoals));
+        added_ = 0;
+        for (size_type i = 0; i < numberThreads; ++i) {
+          ConstraintSetPtr_t constraints
+            (HPP_STATIC_PTR_CAST (ConstraintSet, constraints_->copy ()));
+          sampler_->threads.create_thread
+            (boost::bind (&Sampler::sample, sampler_, constraints,
+                          tools [i]));
+        }
+      }
+
+      void TaskTarget::stopSampling ()
+      {
+        if (!sampler_) return;
+        {
+          boost::mutex::scoped_lock lock (sampler_->mutex);
+          sampler_->stop = true;
+        }
+        sampler_->threads.join_all ();
+      }
+
+      Configurations_t TaskTarget::goals () const
+      {
+        if (!sampler_) return Configurations_t ();
+        boost::mutex::scoped_lock lock (sampler_->mutex);
+        return sampler_->goals;
+      }
+
+      void TaskTarget::addGoalNodes (const RoadmapPtr_t& roadmap,
+                                     bool newOnly)
+      {
+        if (!newOnly) added_ = 0;
+        if (!sampler_) return;
+        Configurations_t goals;
+        {
+          boost::mutex::scoped_lock lock (sampler_->mutex);
+          if (sampler_->goals.size () == added_) return;
+          goals.assign (sampler_->goals.begin () + added_,
+                        sampler_->goals.end ());
+          added_ = sampler_->goals.size ();
+        }
+        for (std::size_t i = 0; i < goals.size (); ++i)
+          roadmap->addGoalNode (goals [i]);
+      }
+
       void TaskTarget::check (const RoadmapPtr_t&) const
       {
         if (!constraints_) {
@@ -46,9 +165,16 @@ namespace hpp {
         }
       }
 
-      bool TaskTarget::reached (const RoadmapPtr_t& /*roadmap*/) const
+      bool TaskTarget::reached (const RoadmapPtr_t& roadmap) const
       {
-        // TODO
+        if (!roadmap->initNode ()) return false;
+        const ConnectedComponentPtr_t ccInit
+          (roadmap->initNode ()->connectedComponent ());
+        const NodeVector_t& goals (roadmap->goalNodes ());
+        for (NodeVector_t::const_iterator it = goals.begin ();
+             it != goals.end (); ++it) {
+          if (ccInit->canReach ((*it)->connectedComponent ())) return true;
+        }
         return false;
       }
 
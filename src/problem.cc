@@ -18,15 +18,22 @@
 
 #include <hpp/core/problem.hh>
 
+#include <algorithm>
 #include <iostream>
 
 #include <hpp/util/debug.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/core/collision-validation.hh>
 #include <hpp/core/joint-bound-validation.hh>
+#include <hpp/core/config-projector.hh>
 #include <hpp/core/config-validations.hh>
+#include <hpp/core/deadline.hh>
+#include <hpp/core/path-projector.hh>
+#include <hpp/core/constraint-set.hh>
 #include <hpp/core/problem-target/goal-configurations.hh>
+#include <hpp/core/random-generator.hh>
 #include <hpp/core/configuration-shooter/uniform.hh>
+#include <hpp/core/self-collision-analysis.hh>
 #include <hpp/core/steering-method/straight.hh>
 #include <hpp/core/weighed-distance.hh>
 #include <hpp/core/path-validation/discretized-collision-checking.hh>
@@ -80,7 +87,8 @@ namespace hpp {
 
     // ======================================================================
     Problem::Problem (DevicePtr_t robot) :
-      robot_ (robot)
+      robot_ (robot), randomGenerator_ (RandomGenerator::create (0)),
+      deadline_ (Deadline::create ()), parametersRevision_ (0)
     {
     }
 
@@ -90,11 +98,13 @@ namespace hpp {
     {
       wkPtr_ = wkPtr;
 
-      distance_       = WeighedDistance::create (robot_);
+      distance_       = WeighedDistance::createFromProblem (*this);
       target_         = problemTarget::GoalConfigurations::create (wkPtr_.lock());
       steeringMethod_ = steeringMethod::Straight::create (*this);
       pathValidation_ = pathValidation::createDiscretizedCollisionChecking (robot_, 0.05);
+      pathValidation_->deadline (deadline_);
       configurationShooter_ = configurationShooter::Uniform::create (robot_);
+      configurationShooter_->randomGenerator (randomGenerator_);
 
       resetConfigValidations();
     }
@@ -104,7 +114,8 @@ namespace hpp {
     Problem::Problem () :
       robot_ (), distance_ (), initConf_ (), goalConfigurations_ (), target_ (),
       steeringMethod_ (), configValidations_ (), pathValidation_ (),
-      collisionObstacles_ (), constraints_ (), configurationShooter_()
+      collisionObstacles_ (), constraints_ (), configurationShooter_(),
+      parametersRevision_ (0)
     {
       assert (false && "This constructor should not be used.");
     }
@@ -205,10 +216,39 @@ namespace hpp {
 
     // ======================================================================
 
+    void Problem::updateObstacle (const CollisionObjectConstPtr_t& obstacle)
+    {
+      boost::shared_ptr<ObstacleUserInterface> oui =
+        HPP_DYNAMIC_PTR_CAST(ObstacleUserInterface, pathValidation_);
+      if (oui) oui->updateObstacle (obstacle);
+      if (configValidations_) {
+	configValidations_->updateObstacle (obstacle);
+      }
+    }
+
+    // ======================================================================
+
     void Problem::filterCollisionPairs ()
     {
-      RelativeMotion::matrix_type matrix = RelativeMotion::matrix (robot_);
-      RelativeMotion::fromConstraint (matrix, robot_, constraints_);
+      NumericalConstraints_t ncs;
+      if (constraints_ && constraints_->configProjector ())
+        ncs = constraints_->configProjector ()->numericalConstraints ();
+      const size_type N (robot_->model ().joints.size ());
+      const std::size_t n (relativeMotionConstraints_.size ());
+      // Start again unless the constraints of the previous call come first.
+      if (relativeMotion_.rows () != N || n > ncs.size () ||
+          !std::equal (relativeMotionConstraints_.begin (),
+                       relativeMotionConstraints_.end (), ncs.begin ())) {
+        relativeMotion_ = RelativeMotion::matrix (robot_);
+        relativeMotionConstraints_.clear ();
+      }
+      for (std::size_t i = relativeMotionConstraints_.size ();
+           i < ncs.size (); ++i) {
+        RelativeMotion::fromConstraint (relativeMotion_, robot_, ncs [i]);
+      }
+      relativeMotionConstraints_ = ncs;
+      RelativeMotion::matrix_type matrix (relativeMotion_);
+      if (selfCollisionAnalysis_) selfCollisionAnalysis_->filter (matrix);
       hppDout (info, "RelativeMotion matrix:\n" << matrix);
 
       boost::shared_ptr<ObstacleUserInterface> oui =
@@ -233,9 +273,18 @@ namespace hpp {
 
     // ======================================================================
 
+    void Problem::pathProjector (const PathProjectorPtr_t& pathProjector)
+    {
+      pathProjector_ = pathProjector;
+      if (pathProjector_) pathProjector_->deadline (deadline_);
+    }
+
+    // ======================================================================
+
     void Problem::pathValidation (const PathValidationPtr_t& pathValidation)
     {
       pathValidation_ = pathValidation;
+      if (pathValidation_) pathValidation_->deadline (deadline_);
       // Insert obstacles in path validation object
       boost::shared_ptr<ObstacleUserInterface> oui =
         HPP_DYNAMIC_PTR_CAST(ObstacleUserInterface, pathValidation_);
@@ -248,6 +297,27 @@ namespace hpp {
 
     // ======================================================================
 
+    void Problem::setupPathValidation
+    (const PathValidationPtr_t& pathValidation) const
+    {
+      if (!pathValidation) return;
+      pathValidation->deadline (deadline_);
+      boost::shared_ptr<ObstacleUserInterface> oui =
+        HPP_DYNAMIC_PTR_CAST(ObstacleUserInterface, pathValidation);
+      if (!oui) return;
+      for (ObjectStdVector_t::const_iterator it =  collisionObstacles_.begin ();
+           it != collisionObstacles_.end (); ++it)
+        oui->addObstacle (*it);
+      // Same filter as in filterCollisionPairs, if it was called.
+      if (relativeMotion_.rows () == (size_type) robot_->model ().joints.size ()) {
+        RelativeMotion::matrix_type matrix (relativeMotion_);
+        if (selfCollisionAnalysis_) selfCollisionAnalysis_->filter (matrix);
+        oui->filterCollisionPairs (matrix);
+      }
+    }
+
+    // ======================================================================
+
     void Problem::addConfigValidation (const ConfigValidationPtr_t& configValidation)
     {
       configValidations_->add ( configValidation );
@@ -262,6 +332,13 @@ namespace hpp {
 
     // ======================================================================
 
+    void Problem::seed (size_type seed)
+    {
+      randomGenerator_->seed ((RandomGenerator::result_type) seed);
+    }
+
+    // ======================================================================
+
     void Problem::checkProblem () const
     {
       if (!robot ()) {
@@ -302,6 +379,22 @@ namespace hpp {
       if (desc.type() != value.type())
         throw std::invalid_argument ("value is not a " + Parameter::typeName (desc.type()));
       parameters.add (name, value);
+      ++parametersRevision_;
+    }
+
+    // ======================================================================
+
+    ParameterHandleBase::ParameterHandleBase (const Problem& problem,
+                                              const std::string& name) :
+      problem_ (&problem), name_ (name),
+      problemRevision_ (&problem.parametersRevision ()), revision_ (-1)
+    {
+    }
+
+    const Parameter& ParameterHandleBase::lookup () const
+    {
+      revision_ = *problemRevision_;
+      return problem_->getParameter (name_);
     }
 
     // ======================================================================
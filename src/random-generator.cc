@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+
+#include <hpp/core/random-generator.hh>
+
+namespace hpp {
+  namespace core {
+    namespace {
+      typedef RandomGenerator::result_type result_type;
+
+      /// Finalizer of SplitMix64
+      result_type mix (result_type z)
+      {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+      }
+
+      const result_type golden (0x9e3779b97f4a7c15ULL);
+    } // namespace
+
+    RandomGeneratorPtr_t RandomGenerator::create (result_type seed)
+    {
+      return RandomGeneratorPtr_t (new RandomGenerator (mix (seed)));
+    }
+
+    RandomGeneratorPtr_t RandomGenerator::split (result_type index) const
+    {
+      return RandomGeneratorPtr_t
+        (new RandomGenerator (mix (key_ ^ mix ((index + 1) * golden))));
+    }
+
+    void RandomGenerator::seed (result_type seed)
+    {
+      key_ = mix (seed);
+      counter_ = 0;
+    }
+
+    RandomGenerator::result_type RandomGenerator::operator() ()
+    {
+      return mix (key_ + (++counter_) * golden);
+    }
+
+    RandomGenerator::RandomGenerator (result_type key) :
+      key_ (key), counter_ (0)
+    {
+    }
+  } //   namespace core
+} // namespace hpp
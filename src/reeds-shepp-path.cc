@@ -142,55 +142,69 @@ namespace hpp {
       return false;
     }
 
-    void ReedsSheppPath::setupPath (const std::size_t& typeId, double t,
-                                    double u, double v, double w, double x)
+    namespace {
+    // Shortest word found so far. Lengths are for a unit turning radius.
+    struct Word
     {
-      typeId_ = typeId;
-      lengths_(0) = t; lengths_(1) = u; lengths_(2) = v; lengths_(3) = w;
-      lengths_(4) = x;
-      rsLength_ = rho_ * lengths_.lpNorm<1> ();
+      typedef Eigen::Matrix<value_type, 5, 1> Lengths_t;
+
+      std::size_t typeId;
+      Lengths_t lengths;
+      value_type L;
+
+      Word () : typeId (0), lengths (Lengths_t::Zero ()),
+        L (std::numeric_limits <value_type>::infinity ()) {}
+
+      void set (const std::size_t& id, value_type t, value_type u=0.,
+                value_type v=0., value_type w=0., value_type x=0.)
+      {
+        typeId = id;
+        lengths << t, u, v, w, x;
+        L = lengths.lpNorm<1> ();
+      }
+    };
     }
 
-    void ReedsSheppPath::CSC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi)
+    inline void CSC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, Word& w)
     {
-      value_type t, u, v, Lmin = rsLength_, L;
+      value_type t, u, v, Lmin = w.L, L;
       if (LpSpLp(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(14, t, u, v);
+        w.set(14, t, u, v);
         Lmin = L;
       }
       if (LpSpLp(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(14, -t, -u, -v);
+        w.set(14, -t, -u, -v);
         Lmin = L;
       }
       if (LpSpLp(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(15, t, u, v);
+        w.set(15, t, u, v);
         Lmin = L;
       }
       if (LpSpLp(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
       {
-        setupPath(15, -t, -u, -v);
+        w.set(15, -t, -u, -v);
         Lmin = L;
       }
       if (LpSpRp(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(12, t, u, v);
+        w.set(12, t, u, v);
         Lmin = L;
       }
       if (LpSpRp(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(12, -t, -u, -v);
+        w.set(12, -t, -u, -v);
         Lmin = L;
       }
       if (LpSpRp(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(13, t, u, v);
+        w.set(13, t, u, v);
         Lmin = L;
       }
       if (LpSpRp(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
-        setupPath(13, -t, -u, -v);
+        w.set(13, -t, -u, -v);
     }
     // formula 8.3 / 8.4  *** TYPO IN PAPER ***
     inline bool LpRmL(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, value_type &t, value_type &u, value_type &v)
@@ -209,27 +223,27 @@ namespace hpp {
       }
       return false;
     }
-    void ReedsSheppPath::CCC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi)
+    inline void CCC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, Word& w)
     {
-      value_type t, u, v, Lmin = rsLength_, L;
+      value_type t, u, v, Lmin = w.L, L;
       if (LpRmL(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(0, t, u, v);
+        w.set(0, t, u, v);
         Lmin = L;
       }
       if (LpRmL(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(0, -t, -u, -v);
+        w.set(0, -t, -u, -v);
         Lmin = L;
       }
       if (LpRmL(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(1, t, u, v);
+        w.set(1, t, u, v);
         Lmin = L;
       }
       if (LpRmL(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
       {
-        setupPath(1, -t, -u, -v);
+        w.set(1, -t, -u, -v);
         Lmin = L;
       }
 
@@ -239,21 +253,21 @@ namespace hpp {
       // value_type xb = xy(0)*csPhi(0) + xy(1)*csPhi(1), yb = xy(0)*csPhi(1) - xy(1)*csPhi(0);
       if (LpRmL(xyb, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(0, v, u, t);
+        w.set(0, v, u, t);
         Lmin = L;
       }
       if (LpRmL(xyb.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(0, -v, -u, -t);
+        w.set(0, -v, -u, -t);
         Lmin = L;
       }
       if (LpRmL(xyb.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(1, v, u, t);
+        w.set(1, v, u, t);
         Lmin = L;
       }
       if (LpRmL(-xyb, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
-        setupPath(1, -v, -u, -t);
+        w.set(1, -v, -u, -t);
     }
     // formula 8.7
     inline bool LpRupLumRm(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, value_type &t, value_type &u, value_type &v)
@@ -288,47 +302,47 @@ namespace hpp {
       }
       return false;
     }
-    void ReedsSheppPath::CCCC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi)
+    inline void CCCC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, Word& w)
     {
-      value_type t, u, v, Lmin = rsLength_, L;
+      value_type t, u, v, Lmin = w.L, L;
       if (LpRupLumRm(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v)))
       {
-        setupPath(2, t, u, -u, v);
+        w.set(2, t, u, -u, v);
         Lmin = L;
       }
       if (LpRupLumRm(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(2, -t, -u, u, -v);
+        w.set(2, -t, -u, u, -v);
         Lmin = L;
       }
       if (LpRupLumRm(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v))) // reflect
       {
-        setupPath(3, t, u, -u, v);
+        w.set(3, t, u, -u, v);
         Lmin = L;
       }
       if (LpRupLumRm(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v))) // timeflip + reflect
       {
-        setupPath(3, -t, -u, u, -v);
+        w.set(3, -t, -u, u, -v);
         Lmin = L;
       }
 
       if (LpRumLumRp(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v)))
       {
-        setupPath(2, t, u, u, v);
+        w.set(2, t, u, u, v);
         Lmin = L;
       }
       if (LpRumLumRp(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(2, -t, -u, -u, -v);
+        w.set(2, -t, -u, -u, -v);
         Lmin = L;
       }
       if (LpRumLumRp(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v))) // reflect
       {
-        setupPath(3, t, u, u, v);
+        w.set(3, t, u, u, v);
         Lmin = L;
       }
       if (LpRumLumRp(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + 2.*fabs(u) + fabs(v))) // timeflip + reflect
-        setupPath(3, -t, -u, -u, -v);
+        w.set(3, -t, -u, -u, -v);
     }
     // formula 8.9
     inline bool LpRmSmLm(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, value_type &t, value_type &u, value_type &v)
@@ -365,48 +379,48 @@ namespace hpp {
       }
       return false;
     }
-    void ReedsSheppPath::CCSC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi)
+    inline void CCSC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, Word& w)
     {
-      value_type t, u, v, Lmin = rsLength_ - .5*pi, L;
+      value_type t, u, v, Lmin = w.L - .5*pi, L;
       if (LpRmSmLm(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(4, t, -.5*pi, u, v);
+        w.set(4, t, -.5*pi, u, v);
         Lmin = L;
       }
       if (LpRmSmLm(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(4, -t, .5*pi, -u, -v);
+        w.set(4, -t, .5*pi, -u, -v);
         Lmin = L;
       }
       if (LpRmSmLm(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(5, t, -.5*pi, u, v);
+        w.set(5, t, -.5*pi, u, v);
         Lmin = L;
       }
       if (LpRmSmLm(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
       {
-        setupPath(5, -t, .5*pi, -u, -v);
+        w.set(5, -t, .5*pi, -u, -v);
         Lmin = L;
       }
 
       if (LpRmSmRm(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(8, t, -.5*pi, u, v);
+        w.set(8, t, -.5*pi, u, v);
         Lmin = L;
       }
       if (LpRmSmRm(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(8, -t, .5*pi, -u, -v);
+        w.set(8, -t, .5*pi, -u, -v);
         Lmin = L;
       }
       if (LpRmSmRm(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(9, t, -.5*pi, u, v);
+        w.set(9, t, -.5*pi, u, v);
         Lmin = L;
       }
       if (LpRmSmRm(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
       {
-        setupPath(9, -t, .5*pi, -u, -v);
+        w.set(9, -t, .5*pi, -u, -v);
         Lmin = L;
       }
 
@@ -418,42 +432,42 @@ namespace hpp {
       // std::cout << xy(0)*csPhi(0) + xy(1)*csPhi(1) << " " << xy(0)*csPhi(1) - xy(1)*csPhi(0) << std::endl;
       if (LpRmSmLm(xyb, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(6, v, u, -.5*pi, t);
+        w.set(6, v, u, -.5*pi, t);
         Lmin = L;
       }
       if (LpRmSmLm(xyb.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(6, -v, -u, .5*pi, -t);
+        w.set(6, -v, -u, .5*pi, -t);
         Lmin = L;
       }
       if (LpRmSmLm(xyb.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(7, v, u, -.5*pi, t);
+        w.set(7, v, u, -.5*pi, t);
         Lmin = L;
       }
       if (LpRmSmLm(-xyb, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
       {
-        setupPath(7, -v, -u, .5*pi, -t);
+        w.set(7, -v, -u, .5*pi, -t);
         Lmin = L;
       }
 
       if (LpRmSmRm(xyb, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(10, v, u, -.5*pi, t);
+        w.set(10, v, u, -.5*pi, t);
         Lmin = L;
       }
       if (LpRmSmRm(xyb.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(10, -v, -u, .5*pi, -t);
+        w.set(10, -v, -u, .5*pi, -t);
         Lmin = L;
       }
       if (LpRmSmRm(xyb.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(11, v, u, -.5*pi, t);
+        w.set(11, v, u, -.5*pi, t);
         Lmin = L;
       }
       if (LpRmSmRm(-xyb, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
-        setupPath(11, -v, -u, .5*pi, -t);
+        w.set(11, -v, -u, .5*pi, -t);
     }
     // formula 8.11 *** TYPO IN PAPER ***
     inline bool LpRmSLmRp(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, value_type &t, value_type &u, value_type &v)
@@ -475,26 +489,61 @@ namespace hpp {
       }
       return false;
     }
-    void ReedsSheppPath::CCSCC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi)
+    inline void CCSCC(const vector2_t& xy, const vector2_t& csPhi, const value_type& phi, Word& w)
     {
-      value_type t, u, v, Lmin = rsLength_ - pi, L;
+      value_type t, u, v, Lmin = w.L - pi, L;
       if (LpRmSLmRp(xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v)))
       {
-        setupPath(16, t, -.5*pi, u, -.5*pi, v);
+        w.set(16, t, -.5*pi, u, -.5*pi, v);
         Lmin = L;
       }
       if (LpRmSLmRp(xy.cwiseProduct(oneMP), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip
       {
-        setupPath(16, -t, .5*pi, -u, .5*pi, -v);
+        w.set(16, -t, .5*pi, -u, .5*pi, -v);
         Lmin = L;
       }
       if (LpRmSLmRp(xy.cwiseProduct(onePM), csPhi.cwiseProduct(onePM), -phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // reflect
       {
-        setupPath(17, t, -.5*pi, u, -.5*pi, v);
+        w.set(17, t, -.5*pi, u, -.5*pi, v);
         Lmin = L;
       }
       if (LpRmSLmRp(-xy, csPhi, phi, t, u, v) && Lmin > (L = fabs(t) + fabs(u) + fabs(v))) // timeflip + reflect
-        setupPath(17, -t, .5*pi, -u, .5*pi, -v);
+        w.set(17, -t, .5*pi, -u, .5*pi, -v);
+    }
+
+    // Search the shortest word, the end pose being expressed in the frame of
+    // the initial pose, for a unit turning radius.
+    inline void shortestWord (const vector2_t& xy, const vector2_t& csPhi,
+                              const value_type& phi, Word& w)
+    {
+      // No curve is shorter than the straight line, nor than the change of
+      // orientation. Families are skipped once this bound is reached.
+      const value_type lowerBound (std::max (xy.norm (), fabs (phi)));
+      CSC  (xy, csPhi, phi, w);
+      if (w.L <= lowerBound) return;
+      CCC  (xy, csPhi, phi, w);
+      if (w.L <= lowerBound) return;
+      CCCC (xy, csPhi, phi, w);
+      if (w.L <= lowerBound) return;
+      // These families contain one or two quarter turns.
+      if (w.L > .5*pi) CCSC (xy, csPhi, phi, w);
+      if (w.L > pi)    CCSCC(xy, csPhi, phi, w);
+    }
+
+    value_type ReedsSheppPath::curveLength (ConfigurationIn_t init,
+                                            ConfigurationIn_t end,
+                                            const value_type& rho,
+                                            size_type xyId, size_type rzId)
+    {
+      vector2_t xy = rotate(end.segment<2>(xyId) - init.segment<2>(xyId),
+                            init.segment<2>(rzId));
+      xy /= rho;
+      vector2_t csPhi = rotate(end.segment<2>(rzId), init.segment<2>(rzId));
+      value_type phi = atan2(csPhi(1), csPhi(0));
+      if (xy.squaredNorm () + phi*phi < 1e-8) return 0;
+      Word word;
+      shortestWord (xy, csPhi, phi, word);
+      return rho * word.L;
     }
 
     ReedsSheppPathPtr_t ReedsSheppPath::create (const pinocchio::DevicePtr_t& device,
@@ -657,11 +706,11 @@ namespace hpp {
         rsLength_ = 0;
         return;
       }
-      CSC  (xy, csPhi, phi);
-      CCC  (xy, csPhi, phi);
-      CCCC (xy, csPhi, phi);
-      CCSC (xy, csPhi, phi);
-      CCSCC(xy, csPhi, phi);
+      Word word;
+      shortestWord (xy, csPhi, phi, word);
+      typeId_ = word.typeId;
+      lengths_ = word.lengths;
+      rsLength_ = rho_ * word.L;
       // build path vector
       value_type L (rsLength_), s (0.);
       for (unsigned int i=0; i<5; ++i) {
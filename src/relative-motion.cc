@@ -89,8 +89,6 @@ namespace hpp {
         const DevicePtr_t& robot,
         const ConstraintSetPtr_t& c)
     {
-      using constraints::Transformation;
-      using constraints::RelativeTransformation;
       assert (robot);
       assert (c);
 
@@ -101,55 +99,69 @@ namespace hpp {
       ConfigProjectorPtr_t proj = c->configProjector();
       if (!proj) return;
 
-      // Loop over the LockedJoint
-      const pinocchio::Model& model = robot->model();
       // Loop over the constraints
       const NumericalConstraints_t& ncs = proj->numericalConstraints ();
       for (NumericalConstraints_t::const_iterator _ncs = ncs.begin();
           _ncs != ncs.end(); ++_ncs) {
-        constraints::ImplicitConstPtr_t nc = *_ncs;
-        size_type i1, i2;
-        // Detect locked joints
-        LockedJointConstPtr_t lj (HPP_DYNAMIC_PTR_CAST (const LockedJoint, nc));
-        if (lj) {
-          const std::string& jointName = lj->jointName();
-          if (!model.existJointName(jointName)) {
-            // Extra dofs and partial locked joints have a name that won't be
-            // recognized by Device::getJointByName. So they can be filtered
-            // this way.
-            hppDout (info, "Joint of locked joint not found: " << *lj);
-            continue;
-          }
-          bool cstRHS (lj->parameterSize () == 0);
+        fromConstraint (matrix, robot, *_ncs);
+      }
+    }
 
-          i1 = model.getJointId(jointName); i2 = model.parents[i1];
-          recurseSetRelMotion (matrix, i1, i2, (cstRHS ? Constrained :
-                                                Parameterized));
-          hppDout (info, "Locked joint found: " << lj->jointName ());
-          continue;
-        }
-        // Detect relative pose constraints
-        if (nc->functionPtr()->outputSize() != 6) {
-          hppDout (info, "Constraint " << nc->functionPtr()->name ()
-                   << " is not of dimension 6.");
-          continue;
-        }
+    void RelativeMotion::fromConstraint (matrix_type& matrix,
+        const DevicePtr_t& robot,
+        const constraints::ImplicitConstPtr_t& nc)
+    {
+      using constraints::Transformation;
+      using constraints::RelativeTransformation;
+      assert (robot);
+      assert (nc);
 
-        if (!check <Transformation>::is (nc->functionPtr (), i1, i2)) {
-          hppDout (info, "Constraint function " << nc->functionPtr()->name ()
-                   << " is not of type Transformation");
-          if (!check <RelativeTransformation>::is
-              (nc->functionPtr (), i1, i2)) {
-            hppDout (info, "Constraint function "
-                     << nc->functionPtr()->name ()
-                     << " is not of type RelativeTransformation");
-            continue;
-          }
+      const size_type N = robot->model().joints.size();
+      if (matrix.rows() != N || matrix.cols() != N)
+        throw std::invalid_argument ("Wrong RelativeMotion::matrix_type size");
+
+      const pinocchio::Model& model = robot->model();
+      size_type i1, i2;
+      // Detect locked joints
+      LockedJointConstPtr_t lj (HPP_DYNAMIC_PTR_CAST (const LockedJoint, nc));
+      if (lj) {
+        const std::string& jointName = lj->jointName();
+        if (!model.existJointName(jointName)) {
+          // Extra dofs and partial locked joints have a name that won't be
+          // recognized by Device::getJointByName. So they can be filtered
+          // this way.
+          hppDout (info, "Joint of locked joint not found: " << *lj);
+          return;
         }
+        bool cstRHS (lj->parameterSize () == 0);
+
+        i1 = model.getJointId(jointName); i2 = model.parents[i1];
+        recurseSetRelMotion (matrix, i1, i2, (cstRHS ? Constrained :
+                                              Parameterized));
+        hppDout (info, "Locked joint found: " << lj->jointName ());
+        return;
+      }
+      // Detect relative pose constraints
+      if (nc->functionPtr()->outputSize() != 6) {
+        hppDout (info, "Constraint " << nc->functionPtr()->name ()
+                 << " is not of dimension 6.");
+        return;
+      }
 
-        bool cstRHS (nc->parameterSize () == 0);
-        recurseSetRelMotion (matrix, i1, i2, (cstRHS ? Constrained : Parameterized));
+      if (!check <Transformation>::is (nc->functionPtr (), i1, i2)) {
+        hppDout (info, "Constraint function " << nc->functionPtr()->name ()
+                 << " is not of type Transformation");
+        if (!check <RelativeTransformation>::is
+            (nc->functionPtr (), i1, i2)) {
+          hppDout (info, "Constraint function "
+                   << nc->functionPtr()->name ()
+                   << " is not of type RelativeTransformation");
+          return;
+        }
       }
+
+      bool cstRHS (nc->parameterSize () == 0);
+      recurseSetRelMotion (matrix, i1, i2, (cstRHS ? Constrained : Parameterized));
     }
 
     void RelativeMotion::recurseSetRelMotion(matrix_type& matrix,
@@ -0,0 +1,521 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/roadmap-checkpoint.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/util/debug.hh>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/core/edge.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/roadmap.hh>
+
+namespace hpp {
+  namespace core {
+    namespace {
+      const char fileMagic [8] = {'H', 'P', 'P', 'R', 'C', 'K', 'P', '\0'};
+      /// Read in another value if the file has another byte order
+      const boost::uint32_t byteOrderMark = 0x01020304;
+
+      struct Header
+      {
+        char magic [8];
+        boost::uint32_t version;
+        boost::uint32_t byteOrder;
+        boost::int64_t configSize;
+      }; // struct Header
+
+      /// Type of the records, followed by their content
+      enum RecordType {
+        /// configuration
+        NODE = 'N',
+        /// source, target, cost, validated
+        EDGE = 'E',
+        /// edge
+        VALIDATE_EDGE = 'V',
+        /// node
+        REMOVE_NODE = 'n',
+        /// edge
+        REMOVE_EDGE = 'e',
+        /// initial node or -1, number of goal nodes, goal nodes
+        TERMINALS = 'T',
+        /// end of a checkpoint
+        COMMIT = 'C'
+      }; // enum RecordType
+
+      template <typename T>
+      void put (std::string& buffer, const T& value)
+      {
+        buffer.append ((const char*) &value, sizeof (T));
+      }
+
+      void putIndex (std::string& buffer, size_type index)
+      {
+        put (buffer, (boost::int64_t) index);
+      }
+
+      /// Read records from a buffer, checking its bounds
+      struct Reader
+      {
+        Reader (const char* b, const char* e) : position (b), end (e) {}
+        template <typename T>
+        bool get (T& value)
+        {
+          if (end - position < (std::ptrdiff_t) sizeof (T)) return false;
+          std::memcpy (&value, position, sizeof (T));
+          position += sizeof (T);
+          return true;
+        }
+        bool getIndex (size_type& index)
+        {
+          boost::int64_t i;
+          if (!get (i)) return false;
+          index = (size_type) i;
+          return true;
+        }
+        const char* position;
+        const char* end;
+      }; // struct Reader
+
+      /// Content of a stream
+      struct State
+      {
+        struct EdgeState
+        {
+          size_type from, to;
+          value_type cost;
+          bool validated, alive;
+        }; // struct EdgeState
+
+        State (size_type n) : configSize (n), init (-1) {}
+
+        /// Check that a node index was read before
+        void checkNode (size_type i) const
+        {
+          if (i < 0 || i >= (size_type) nodeAlive.size ())
+            throw std::runtime_error ("Roadmap checkpoint refers to an "
+                                      "unknown node.");
+        }
+        void checkEdge (size_type i) const
+        {
+          if (i < 0 || i >= (size_type) edges.size ())
+            throw std::runtime_error ("Roadmap checkpoint refers to an "
+                                      "unknown edge.");
+        }
+
+        /// Read one record
+        /// \return false if the record is truncated.
+        bool read (Reader& reader, char& type)
+        {
+          if (!reader.get (type)) return false;
+          size_type i;
+          switch (type) {
+          case NODE:
+            {
+              const std::size_t start (configurations.size ());
+              configurations.resize (start + (std::size_t) configSize);
+              for (size_type k = 0; k < configSize; ++k)
+                if (!reader.get (configurations [start + k])) return false;
+              nodeAlive.push_back (true);
+            }
+            break;
+          case EDGE:
+            {
+              EdgeState e;
+              boost::uint8_t validated;
+              if (!reader.getIndex (e.from) || !reader.getIndex (e.to) ||
+                  !reader.get (e.cost) || !reader.get (validated))
+                return false;
+              checkNode (e.from); checkNode (e.to);
+              e.validated = (validated != 0);
+              e.alive = true;
+              edges.push_back (e);
+            }
+            break;
+          case VALIDATE_EDGE:
+            if (!reader.getIndex (i)) return false;
+            checkEdge (i);
+            edges [i].validated = true;
+            break;
+          case REMOVE_NODE:
+            if (!reader.getIndex (i)) return false;
+            checkNode (i);
+            nodeAlive [i] = false;
+            break;
+          case REMOVE_EDGE:
+            if (!reader.getIndex (i)) return false;
+            checkEdge (i);
+            edges [i].alive = false;
+            break;
+          case TERMINALS:
+            {
+              size_type n;
+              if (!reader.getIndex (init) || !reader.getIndex (n))
+                return false;
+              if (init >= 0) checkNode (init);
+              goals.resize ((std::size_t) std::max (n, (size_type) 0));
+              for (std::size_t k = 0; k < goals.size (); ++k) {
+                if (!reader.getIndex (goals [k])) return false;
+                checkNode (goals [k]);
+              }
+            }
+            break;
+          case COMMIT:
+            break;
+          default:
+            throw std::runtime_error ("Roadmap checkpoint is corrupted.");
+          }
+          return true;
+        }
+
+        size_type configSize;
+        /// Configurations of the nodes, one after the other
+        std::vector <double> configurations;
+        std::vector <bool> nodeAlive;
+        std::vector <EdgeState> edges;
+        size_type init;
+        std::vector <size_type> goals;
+      }; // struct State
+    } // namespace
+
+    /// Write the checkpoints in a background thread
+    struct RoadmapCheckpoint::Writer
+    {
+      Writer (const std::string& filename) :
+        os (filename.c_str (), std::ios::binary | std::ios::trunc),
+        busy (false), stop (false)
+      {
+        if (!os) {
+          HPP_THROW (std::runtime_error, "Cannot open " << filename
+                     << " for writing.");
+        }
+      }
+
+      void start ()
+      {
+        thread = boost::thread (boost::bind (&Writer::run, this));
+      }
+
+      void run ()
+      {
+        boost::mutex::scoped_lock lock (mutex);
+        while (true) {
+          while (pending.empty () && !stop) changed.wait (lock);
+          if (pending.empty ()) return;
+          std::string buffer;
+          buffer.swap (pending.front ());
+          pending.pop_front ();
+          busy = true;
+          lock.unlock ();
+          os.write (buffer.data (), (std::streamsize) buffer.size ());
+          os.flush ();
+          lock.lock ();
+          busy = false;
+          if (!os && error.empty ())
+            error = "Failed to write a roadmap checkpoint.";
+          changed.notify_all ();
+        }
+      }
+
+      void push (std::string& buffer)
+      {
+        boost::mutex::scoped_lock lock (mutex);
+        pending.push_back (std::string ());
+        pending.back ().swap (buffer);
+        changed.notify_all ();
+      }
+
+      void wait ()
+      {
+        boost::mutex::scoped_lock lock (mutex);
+        while (!pending.empty () || busy) changed.wait (lock);
+      }
+
+      void finish ()
+      {
+        {
+          boost::mutex::scoped_lock lock (mutex);
+          stop = true;
+          changed.notify_all ();
+        }
+        thread.join ();
+      }
+
+      /// Throw the error of the writing thread, if any
+      void check ()
+      {
+        boost::mutex::scoped_lock lock (mutex);
+        if (!error.empty ()) throw std::runtime_error (error);
+      }
+
+      std::ofstream os;
+      boost::thread thread;
+      boost::mutex mutex;
+      boost::condition_variable changed;
+      std::deque <std::string> pending;
+      std::string error;
+      bool busy, stop;
+    }; // struct Writer
+
+    RoadmapCheckpointPtr_t RoadmapCheckpoint::create
+    (const RoadmapPtr_t& roadmap, const DevicePtr_t& robot,
+     const std::string& filename)
+    {
+      return RoadmapCheckpointPtr_t (new RoadmapCheckpoint
+                                     (roadmap, robot, filename));
+    }
+
+    RoadmapCheckpoint::RoadmapCheckpoint (const RoadmapPtr_t& roadmap,
+                                          const DevicePtr_t& robot,
+                                          const std::string& filename) :
+      roadmap_ (roadmap), writer_ (new Writer (filename)),
+      numberNodes_ (0), numberEdges_ (0), numberCheckpoints_ (0),
+      terminals_ (1, -1)
+    {
+      Header header;
+      std::memcpy (header.magic, fileMagic, sizeof (fileMagic));
+      header.version = fileVersion;
+      header.byteOrder = byteOrderMark;
+      header.configSize = robot->configSize ();
+      writer_->os.write ((const char*) &header, sizeof (Header));
+      if (!writer_->os) {
+        HPP_THROW (std::runtime_error, "Cannot write " << filename << ".");
+      }
+      writer_->start ();
+    }
+
+    RoadmapCheckpoint::~RoadmapCheckpoint ()
+    {
+      writer_->finish ();
+    }
+
+    void RoadmapCheckpoint::checkpoint ()
+    {
+      writer_->check ();
+      std::string buffer;
+      for (NodeRecords_t::iterator it = nodes_.begin ();
+           it != nodes_.end (); ++it)
+        it->second.alive = false;
+      for (EdgeRecords_t::iterator it = edges_.begin ();
+           it != edges_.end (); ++it)
+        it->second.alive = false;
+
+      // New nodes
+      const Nodes_t& nodes (roadmap_->nodes ());
+      for (Nodes_t::const_iterator it = nodes.begin (); it != nodes.end ();
+           ++it) {
+        const Configuration_t& q (*(*it)->configuration ());
+        NodeRecords_t::iterator record (nodes_.find (*it));
+        if (record != nodes_.end () && record->second.configuration == &q) {
+          record->second.alive = true;
+          continue;
+        }
+        if (record != nodes_.end ()) {
+          // Another node was created at the address of a removed one.
+          buffer.push_back ((char) REMOVE_NODE);
+          putIndex (buffer, record->second.index);
+        }
+        NodeRecord& r (nodes_ [*it]);
+        r.index = numberNodes_++;
+        r.configuration = &q;
+        r.alive = true;
+        buffer.push_back ((char) NODE);
+        buffer.append ((const char*) q.data (), sizeof (double) * q.size ());
+      }
+
+      // New and validated edges
+      const Edges_t& edges (roadmap_->edges ());
+      for (Edges_t::const_iterator it = edges.begin (); it != edges.end ();
+           ++it) {
+        const Edge* edge (*it);
+        const size_type from (nodes_ [edge->from ()].index),
+          to (nodes_ [edge->to ()].index);
+        EdgeRecords_t::iterator record (edges_.find (edge));
+        if (record != edges_.end () && record->second.from == from &&
+            record->second.to == to) {
+          record->second.alive = true;
+          if (edge->validated () && !record->second.validated) {
+            record->second.validated = true;
+            buffer.push_back ((char) VALIDATE_EDGE);
+            putIndex (buffer, record->second.index);
+          }
+          continue;
+        }
+        if (record != edges_.end ()) {
+          buffer.push_back ((char) REMOVE_EDGE);
+          putIndex (buffer, record->second.index);
+        }
+        EdgeRecord& r (edges_ [edge]);
+        r.index = numberEdges_++;
+        r.from = from;
+        r.to = to;
+        r.validated = edge->validated ();
+        r.alive = true;
+        buffer.push_back ((char) EDGE);
+        putIndex (buffer, from);
+        putIndex (buffer, to);
+        put (buffer, (double) edge->cost ());
+        put (buffer, (boost::uint8_t) r.validated);
+      }
+
+      // Removed nodes and edges
+      for (NodeRecords_t::iterator it = nodes_.begin ();
+           it != nodes_.end ();) {
+        if (it->second.alive) { ++it; continue; }
+        buffer.push_back ((char) REMOVE_NODE);
+        putIndex (buffer, it->second.index);
+        it = nodes_.erase (it);
+      }
+      for (EdgeRecords_t::iterator it = edges_.begin ();
+           it != edges_.end ();) {
+        if (it->second.alive) { ++it; continue; }
+        buffer.push_back ((char) REMOVE_EDGE);
+        putIndex (buffer, it->second.index);
+        it = edges_.erase (it);
+      }
+
+      // Initial and goal nodes
+      std::vector <size_type> terminals;
+      terminals.reserve (1 + roadmap_->goalNodes ().size ());
+      terminals.push_back (roadmap_->initNode () ?
+                           nodes_ [roadmap_->initNode ()].index : -1);
+      for (NodeVector_t::const_iterator it = roadmap_->goalNodes ().begin ();
+           it != roadmap_->goalNodes ().end (); ++it)
+        terminals.push_back (nodes_ [*it].index);
+      if (terminals != terminals_) {
+        terminals_.swap (terminals);
+        buffer.push_back ((char) TERMINALS);
+        putIndex (buffer, terminals_ [0]);
+        putIndex (buffer, (size_type) terminals_.size () - 1);
+        for (std::size_t i = 1; i < terminals_.size (); ++i)
+          putIndex (buffer, terminals_ [i]);
+      }
+
+      buffer.push_back ((char) COMMIT);
+      ++numberCheckpoints_;
+      hppDout (info, "Checkpoint " << numberCheckpoints_ << " of "
+               << buffer.size () << " bytes");
+      writer_->push (buffer);
+    }
+
+    void RoadmapCheckpoint::wait ()
+    {
+      writer_->wait ();
+      writer_->check ();
+    }
+
+    RoadmapPtr_t RoadmapCheckpoint::load (const std::string& filename,
+                                          const Problem& problem)
+    {
+      std::ifstream is (filename.c_str (), std::ios::binary);
+      if (!is) {
+        HPP_THROW (std::runtime_error, "Cannot open " << filename << ".");
+      }
+      const std::string data ((std::istreambuf_iterator <char> (is)),
+                              std::istreambuf_iterator <char> ());
+      Header header;
+      if (data.size () < sizeof (Header)) {
+        HPP_THROW (std::runtime_error, filename << " is not a roadmap "
+                   "checkpoint.");
+      }
+      std::memcpy (&header, data.data (), sizeof (Header));
+      if (std::memcmp (header.magic, fileMagic, sizeof (fileMagic)) != 0) {
+        HPP_THROW (std::runtime_error, filename << " is not a roadmap "
+                   "checkpoint.");
+      }
+      if (header.byteOrder != byteOrderMark) {
+        HPP_THROW (std::runtime_error, filename << " was written with "
+                   "another byte order.");
+      }
+      if (header.version != fileVersion) {
+        HPP_THROW (std::runtime_error, filename << " has version "
+                   << header.version << " instead of " << fileVersion << ".");
+      }
+      const DevicePtr_t& robot (problem.robot ());
+      if (header.configSize != robot->configSize ()) {
+        HPP_THROW (std::runtime_error, filename << " stores configurations "
+                   "of size " << header.configSize << " instead of "
+                   << robot->configSize () << ".");
+      }
+      const SteeringMethodPtr_t& sm (problem.steeringMethod ());
+      if (!sm)
+        throw std::runtime_error ("A steering method is required to load a "
+                                  "roadmap checkpoint.");
+
+      // Find the end of the last complete checkpoint, then replay until it.
+      const char* begin (data.data () + sizeof (Header));
+      const char* end (begin);
+      {
+        State state (header.configSize);
+        Reader reader (begin, data.data () + data.size ());
+        char type;
+        while (state.read (reader, type))
+          if (type == COMMIT) end = reader.position;
+      }
+      State state (header.configSize);
+      Reader reader (begin, end);
+      char type;
+      while (state.read (reader, type)) {}
+
+      RoadmapPtr_t roadmap (Roadmap::create (problem.distance (), robot));
+      const size_type n (header.configSize);
+      std::vector <size_type> alive;
+      std::vector <size_type> ids (state.nodeAlive.size (), -1);
+      for (std::size_t i = 0; i < state.nodeAlive.size (); ++i)
+        if (state.nodeAlive [i]) {
+          ids [i] = (size_type) alive.size ();
+          alive.push_back ((size_type) i);
+        }
+      matrix_t configurations (n, (size_type) alive.size ());
+      for (std::size_t i = 0; i < alive.size (); ++i)
+        configurations.col (i) = Eigen::Map <const vector_t>
+          (&state.configurations [(std::size_t) (alive [i] * n)], n);
+      const NodeVector_t nodes (roadmap->addNodes (configurations));
+
+      for (std::size_t i = 0; i < state.edges.size (); ++i) {
+        const State::EdgeState& e (state.edges [i]);
+        if (!e.alive || ids [e.from] < 0 || ids [e.to] < 0) continue;
+        roadmap->addEdge (nodes [ids [e.from]], nodes [ids [e.to]], sm,
+                          e.cost, e.validated);
+      }
+      // Initial and goal nodes are found among the nodes by their
+      // configuration.
+      if (state.init >= 0 && ids [state.init] >= 0)
+        roadmap->initNode (nodes [ids [state.init]]->configuration ());
+      for (std::size_t i = 0; i < state.goals.size (); ++i)
+        if (ids [state.goals [i]] >= 0)
+          roadmap->addGoalNode (nodes [ids [state.goals [i]]]->configuration ());
+      hppDout (info, "Loaded " << nodes.size () << " nodes from "
+               << filename);
+      return roadmap;
+    }
+  } //   namespace core
+} // namespace hpp
@@ -17,24 +17,104 @@
 // <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
 #include <stdexcept>
 
+#include <boost/thread/mutex.hpp>
+
 #include <hpp/util/debug.hh>
+#include <hpp/util/exception-factory.hh>
 
 #include <hpp/pinocchio/configuration.hh>
 
+#include <hpp/core/allocation-profile.hh>
 #include <hpp/core/connected-component.hh>
+#include <hpp/core/distance.hh>
 #include <hpp/core/edge.hh>
 #include <hpp/core/node.hh>
 #include <hpp/core/path.hh>
+#include <hpp/core/path-vector.hh>
 #include <hpp/core/roadmap.hh>
+#include <hpp/core/steering-method.hh>
 
 #include <../src/nearest-neighbor/basic.hh>
+#include "configuration-arena.hh"
+#include "extracted-path.hh"
 
 namespace hpp {
   namespace core {
     using pinocchio::displayConfig;
 
+    namespace {
+      /// Serializes the construction of the paths of the edges
+      boost::mutex steerMutex;
+
+      /// Node connected to a given node by all its edges, NULL if the node
+      /// has no edge or several neighbors.
+      NodePtr_t uniqueNeighbor (const NodePtr_t& node)
+      {
+	NodePtr_t neighbor = 0x0;
+	for (Edges_t::const_iterator it = node->outEdges ().begin ();
+	     it != node->outEdges ().end (); ++it) {
+	  if (!neighbor) neighbor = (*it)->to ();
+	  else if ((*it)->to () != neighbor) return 0x0;
+	}
+	for (Edges_t::const_iterator it = node->inEdges ().begin ();
+	     it != node->inEdges ().end (); ++it) {
+	  if (!neighbor) neighbor = (*it)->from ();
+	  else if ((*it)->from () != neighbor) return 0x0;
+	}
+	return neighbor;
+      }
+
+      template <typename T> struct IsIn
+      {
+	IsIn (const std::set <T>& set) : set_ (set) {}
+	bool operator() (const T& t) const
+	{
+	  return set_.count (t) > 0;
+	}
+	const std::set <T>& set_;
+      }; // struct IsIn
+
+      typedef std::pair <value_type, NodePtr_t> ScoredNode_t;
+
+      /// Size of an element of a node based container holding a T
+      template <typename T> std::size_t elementSize ()
+      {
+        return sizeof (T) + 3 * sizeof (void*);
+      }
+
+      std::size_t configurationSize (size_type size)
+      {
+        return sizeof (Configuration_t) + (std::size_t) size *
+          sizeof (value_type);
+      }
+
+      /// Estimated memory of a path, counting each path of a path vector
+      /// and each path shared by reversed views once
+      std::size_t pathSize (const PathPtr_t& path,
+                            std::set <const Path*>& paths)
+      {
+        if (!paths.insert (path.get ()).second) return 0;
+        ExtractedPathPtr_t extracted (HPP_DYNAMIC_PTR_CAST (ExtractedPath,
+                                                            path));
+        if (extracted)
+          return sizeof (ExtractedPath) +
+            pathSize (extracted->original (), paths);
+        PathVectorPtr_t pv (HPP_DYNAMIC_PTR_CAST (PathVector, path));
+        if (!pv)
+          return sizeof (Path) + 2 * configurationSize (path->outputSize ());
+        std::size_t result (sizeof (PathVector) +
+                            pv->numberPaths () * sizeof (PathPtr_t));
+        for (std::size_t i = 0; i < pv->numberPaths (); ++i)
+          result += pathSize (pv->pathAtRank (i), paths);
+        return result;
+      }
+    } // namespace
+
     RoadmapPtr_t Roadmap::create (const DistancePtr_t& distance,
 				  const DevicePtr_t& robot)
     {
@@ -47,7 +127,9 @@ namespace hpp {
     Roadmap::Roadmap (const DistancePtr_t& distance, const DevicePtr_t&) :
       distance_ (distance), connectedComponents_ (), nodes_ (), edges_ (),
       initNode_ (), goalNodes_ (),
-      nearestNeighbor_ (new nearestNeighbor::Basic (distance))
+      nearestNeighbor_ (new nearestNeighbor::Basic (distance)),
+      configurationArena_ (new ConfigurationArena), revision_ (0),
+      distanceCacheSize_ (0)
     {
     }
 
@@ -95,10 +177,14 @@ namespace hpp {
       goalNodes_.clear ();
       initNode_ = 0x0;
       nearestNeighbor_->clear();
+      if (configurationArena_) configurationArena_->clear ();
+      distanceCache_.clear ();
+      ++revision_;
     }
 
     NodePtr_t Roadmap::addNode (const ConfigurationPtr_t& configuration)
     {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
       value_type distance;
       if (nodes_.size () != 0) {
 	NodePtr_t nearest = nearestNode (configuration, distance);
@@ -106,9 +192,161 @@ namespace hpp {
 	  return nearest;
 	}
       }
+      return addNewNode (configuration);
+    }
+
+    NodePtr_t Roadmap::addNode (const Configuration_t& configuration)
+    {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
+      value_type distance;
+      if (nodes_.size () != 0) {
+	NodePtr_t nearest = nearestNode (configuration, distance);
+	if (*(nearest->configuration ()) == configuration) {
+	  return nearest;
+	}
+      }
+      // Roadmaps created for serialization have no arena.
+      if (!configurationArena_)
+        configurationArena_.reset (new ConfigurationArena);
+      return addNewNode (configurationArena_->allocate (configuration));
+    }
+
+    NodeVector_t Roadmap::addNodes (const matrix_t& configurations)
+    {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
+      if (!configurationArena_)
+        configurationArena_.reset (new ConfigurationArena);
+      NodeVector_t result;
+      result.reserve (configurations.cols ());
+      for (size_type i = 0; i < configurations.cols (); ++i) {
+        NodePtr_t node = createNode (configurationArena_->allocate
+                                     (configurations.col (i)));
+        push_node (node);
+        connectedComponents_.insert (node->connectedComponent ());
+        node->connectedComponent ()->addNode (node);
+        result.push_back (node);
+      }
+      if (!result.empty ()) ++revision_;
+      nearestNeighbor_->addNodes (result);
+      return result;
+    }
+
+    namespace {
+      /// Representative of an element of a union-find forest
+      std::size_t findRoot (std::vector <std::size_t>& parents, std::size_t i)
+      {
+        while (parents [i] != i) {
+          parents [i] = parents [parents [i]];
+          i = parents [i];
+        }
+        return i;
+      }
+    } // namespace
+
+    NodeVector_t Roadmap::addNodesAndEdges (const Batch& batch)
+    {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
+      typedef std::vector <Batch::Edge_t> BatchEdges_t;
+      typedef std::map <const ConnectedComponent*, std::size_t> Ranks_t;
+      const std::size_t n (batch.configurations_.size ());
+      // Elements of the union-find forest are the nodes of the batch,
+      // followed by the connected components of the roadmap the edges
+      // refer to.
+      std::vector <std::size_t> parents (n);
+      for (std::size_t i = 0; i < n; ++i) parents [i] = i;
+      std::vector <bool> attached (n, false);
+      std::vector <ConnectedComponentPtr_t> components;
+      Ranks_t ranks;
+      for (BatchEdges_t::const_iterator it = batch.edges_.begin ();
+           it != batch.edges_.end (); ++it) {
+        const Batch::NodeRef* refs [2] = { &it->from, &it->to };
+        std::size_t ends [2];
+        for (std::size_t k = 0; k < 2; ++k) {
+          if (refs [k]->node) {
+            const ConnectedComponentPtr_t cc
+              (refs [k]->node->connectedComponent ());
+            std::pair <Ranks_t::iterator, bool> inserted
+              (ranks.insert (std::make_pair (cc.get (), parents.size ())));
+            if (inserted.second) {
+              components.push_back (cc);
+              parents.push_back (parents.size ());
+            }
+            ends [k] = inserted.first->second;
+          } else {
+            if (refs [k]->rank >= n)
+              throw std::invalid_argument ("Roadmap::addNodesAndEdges: an "
+                                           "edge refers to a node out of "
+                                           "the batch.");
+            ends [k] = refs [k]->rank;
+          }
+        }
+        // Like addNodeAndEdge, the first edge of a new node puts it in the
+        // connected component of the other node whatever its orientation.
+        bool attach (false);
+        for (std::size_t k = 0; k < 2; ++k) {
+          if (ends [k] < n && !attached [ends [k]]) {
+            attached [ends [k]] = true;
+            attach = true;
+          }
+        }
+        if (it->bothWays || attach)
+          parents [findRoot (parents, ends [0])] = findRoot (parents, ends [1]);
+      }
+
+      // Merge the connected components of the roadmap in the same set.
+      std::vector <ConnectedComponentPtr_t> sets (parents.size ());
+      for (std::size_t j = 0; j < components.size (); ++j) {
+        ConnectedComponentPtr_t& cc (sets [findRoot (parents, n + j)]);
+        if (!cc) {
+          cc = components [j];
+          continue;
+        }
+        const ConnectedComponentPtr_t other
+          (ConnectedComponent::root (components [j]));
+        cc = ConnectedComponent::root (cc);
+        connect (cc, other);
+        connect (ConnectedComponent::root (other),
+                 ConnectedComponent::root (cc));
+      }
+      // Merges may have involved the connected components of other sets.
+      for (std::size_t i = 0; i < sets.size (); ++i)
+        if (sets [i]) sets [i] = ConnectedComponent::root (sets [i]);
+
+      NodeVector_t result;
+      result.reserve (n);
+      for (std::size_t i = 0; i < n; ++i) {
+        NodePtr_t node = createNode (batch.configurations_ [i]);
+        ConnectedComponentPtr_t& cc (sets [findRoot (parents, i)]);
+        if (!cc) {
+          cc = node->connectedComponent ();
+          connectedComponents_.insert (cc);
+        } else {
+          node->connectedComponent (cc);
+        }
+        cc->addNode (node);
+        push_node (node);
+        result.push_back (node);
+      }
+      if (!result.empty ()) ++revision_;
+      nearestNeighbor_->addNodes (result);
+
+      for (BatchEdges_t::const_iterator it = batch.edges_.begin ();
+           it != batch.edges_.end (); ++it) {
+        const NodePtr_t from (it->from.node ? it->from.node :
+                              result [it->from.rank]);
+        const NodePtr_t to (it->to.node ? it->to.node : result [it->to.rank]);
+        if (it->bothWays) addEdges (from, to, it->path);
+        else addEdge (from, to, it->path);
+      }
+      return result;
+    }
+
+    NodePtr_t Roadmap::addNewNode (const ConfigurationPtr_t& configuration)
+    {
       NodePtr_t node = createNode (configuration);
       hppDout (info, "Added node: " << displayConfig (*configuration));
       push_node (node);
+      ++revision_;
       // Node constructor creates a new connected component. This new
       // connected component needs to be added in the roadmap and the
       // new node needs to be registered in the connected component.
@@ -119,6 +357,7 @@ namespace hpp {
     NodePtr_t Roadmap::addNode (const ConfigurationPtr_t& configuration,
 				ConnectedComponentPtr_t connectedComponent)
     {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
       assert (connectedComponent);
       value_type distance;
       if (nodes_.size () != 0) {
@@ -132,6 +371,7 @@ namespace hpp {
       node->connectedComponent (connectedComponent);
       hppDout (info, "Added node: " << displayConfig (*configuration));
       push_node (node);
+      ++revision_;
       // The new node needs to be registered in the connected
       // component.
       connectedComponent->addNode (node);
@@ -140,13 +380,16 @@ namespace hpp {
     }
 
     void Roadmap::addEdges (const NodePtr_t from, const NodePtr_t& to,
-			    const PathPtr_t& path)
+			    const PathPtr_t& path, bool validated)
     {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
       EdgePtr_t edge = new Edge (from, to, path);
+      edge->validated_ = validated;
       if (!from->isOutNeighbor (to)) from->addOutEdge (edge);
       if (!to->isInNeighbor  (from)) to->addInEdge (edge);
       addEdge(edge);
-      edge = new Edge (to, from, path->reverse ());
+      edge = new Edge (to, from, path->reversedView ());
+      edge->validated_ = validated;
       if (!from->isInNeighbor  (to)) from->addInEdge (edge);
       if (!to->isOutNeighbor (from)) to->addOutEdge (edge);
       addEdge(edge);
@@ -219,6 +462,14 @@ namespace hpp {
                                                d);
     }
 
+    std::vector <Nodes_t> Roadmap::nearestNodes
+    (const matrix_t& configurations, size_type k)
+    {
+      vector_t d;
+      return nearestNeighbor_->KnearestSearch (configurations, weak_.lock (),
+                                               k, d);
+    }
+
     Nodes_t Roadmap::nearestNodes (const Configuration_t& configuration,
                                    const ConnectedComponentPtr_t&
                                    connectedComponent,
@@ -236,10 +487,19 @@ namespace hpp {
       return nearestNeighbor_->withinBall(q, cc, maxD);
     }
 
+    NodeVector_t Roadmap::nodesWithinBall (const Configuration_t& q,
+                                           const ConnectedComponentPtr_t& cc,
+                                           value_type maxD,
+                                           size_type maxNodes)
+    {
+      return nearestNeighbor_->withinBall(q, cc, maxD, maxNodes);
+    }
+
     NodePtr_t Roadmap::addGoalNode (const ConfigurationPtr_t& config)
     {
       NodePtr_t node = addNode (config);
       goalNodes_.push_back (node);
+      ++revision_;
       return node;
     }
     
@@ -247,17 +507,98 @@ namespace hpp {
     {
       return distance_;
     }
+
+    value_type Roadmap::distance (const NodePtr_t& n1, const NodePtr_t& n2)
+    {
+      if (distanceCacheSize_ <= 0) return (*distance_) (n1, n2);
+      const std::pair <const Node*, const Node*> key (n1, n2);
+      DistanceCache_t::const_iterator it (distanceCache_.find (key));
+      if (it != distanceCache_.end ()) return it->second;
+      if ((size_type) distanceCache_.size () >= distanceCacheSize_)
+        distanceCache_.clear ();
+      const value_type d ((*distance_) (n1, n2));
+      distanceCache_.insert (std::make_pair (key, d));
+      return d;
+    }
+
+    void Roadmap::distanceCacheSize (size_type size)
+    {
+      distanceCacheSize_ = size;
+      distanceCache_.clear ();
+    }
     
     EdgePtr_t Roadmap::addEdge (const NodePtr_t& n1, const NodePtr_t& n2,
-				const PathPtr_t& path)
+				const PathPtr_t& path, bool validated)
     {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
       EdgePtr_t edge = new Edge (n1, n2, path);
+      edge->validated_ = validated;
+      if (!n1->isOutNeighbor (n2)) n1->addOutEdge (edge);
+      if (!n2->isInNeighbor  (n1)) n2->addInEdge (edge);
+      addEdge(edge);
+      return edge;
+    }
+
+    EdgePtr_t Roadmap::addEdge (const NodePtr_t& n1, const NodePtr_t& n2,
+				const SteeringMethodPtr_t& steeringMethod,
+                                value_type cost, bool validated)
+    {
+      HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
+      EdgePtr_t edge = new Edge (n1, n2, steeringMethod, cost);
+      edge->validated_ = validated;
       if (!n1->isOutNeighbor (n2)) n1->addOutEdge (edge);
       if (!n2->isInNeighbor  (n1)) n2->addInEdge (edge);
       addEdge(edge);
       return edge;
     }
 
+    PathPtr_t Edge::steer () const
+    {
+      boost::mutex::scoped_lock lock (steerMutex);
+      if (path_) return path_;
+      const Configuration_t& q1 (*n1_->configuration ()),
+        q2 (*n2_->configuration ());
+      path_ = (*steeringMethod_) (q1, q2);
+      if (!path_) {
+        PathPtr_t reverse ((*steeringMethod_) (q2, q1));
+        if (reverse) path_ = reverse->reverse ();
+      }
+      if (!path_) {
+        HPP_THROW (std::runtime_error, "Steering method failed to build the "
+                   "path of the edge from " << displayConfig (q1) << " to "
+                   << displayConfig (q2));
+      }
+      return path_;
+    }
+
+    bool Edge::deferred () const
+    {
+      if (!steeringMethod_) return false;
+      boost::mutex::scoped_lock lock (steerMutex);
+      return !path_;
+    }
+
+    void Roadmap::validateEdge (const EdgePtr_t& edge)
+    {
+      if (edge->validated_) return;
+      edge->validated_ = true;
+      ++revision_;
+      connect (edge->from ()->connectedComponent (),
+	       edge->to ()->connectedComponent ());
+    }
+
+    void Roadmap::removeEdge (const EdgePtr_t& edge)
+    {
+      if (edge->validated_)
+	throw std::logic_error ("Only edges that are not validated can be "
+				"removed from the roadmap.");
+      edge->from ()->removeOutEdge (edge);
+      edge->to ()->removeInEdge (edge);
+      edges_.remove (edge);
+      delete edge;
+      ++revision_;
+    }
+
     void Roadmap::addConnectedComponent (const NodePtr_t& node)
     {
       connectedComponents_.insert (node->connectedComponent ());
@@ -281,7 +622,9 @@ namespace hpp {
     {
       if (cc1->canReach (cc2)) return;
       ConnectedComponent::RawPtrs_t cc2Tocc1;
-      if (cc2->canReach (cc1, cc2Tocc1)) {
+      bool cycle = cc2->canReach (cc1, cc2Tocc1);
+      ConnectedComponent::addReachability (cc1.get (), cc2.get ());
+      if (cycle) {
 	merge (cc1, cc2Tocc1);
       } else {
 	cc1->reachableTo_.insert (cc2.get());
@@ -292,10 +635,20 @@ namespace hpp {
     void Roadmap::merge (const ConnectedComponentPtr_t& cc1,
 			 ConnectedComponent::RawPtrs_t& ccs)
     {
+      // Merge into the largest connected component, so that only the
+      // smaller ones are touched.
+      ccs.insert (cc1.get ());
+      ConnectedComponentPtr_t root (cc1);
       for (ConnectedComponent::RawPtrs_t::iterator itcc = ccs.begin ();
 	   itcc != ccs.end (); ++itcc) {
-	if (*itcc != cc1.get()) {
-	  cc1->merge ((*itcc)->self());
+	if ((*itcc)->nodes ().size () > root->nodes ().size ())
+	  root = (*itcc)->self ();
+      }
+      for (ConnectedComponent::RawPtrs_t::iterator itcc = ccs.begin ();
+	   itcc != ccs.end (); ++itcc) {
+	if (*itcc != root.get()) {
+	  root->merge ((*itcc)->self());
+	  nearestNeighbor_->merge (root, (*itcc)->self());
 #ifndef NDEBUG	  
 	  std::size_t nb =
 #endif
@@ -305,9 +658,58 @@ namespace hpp {
       }
     }
 
+    void Roadmap::edgeCost (const EdgeCost_t& cost)
+    {
+      edgeCost_ = cost;
+      for (Edges_t::const_iterator it = edges_.begin (); it != edges_.end ();
+	   ++it) {
+	computeCost (*it);
+      }
+      ++revision_;
+    }
+
+    void Roadmap::computeCost (const EdgePtr_t& edge) const
+    {
+      if (edgeCost_) edge->cost_ = edgeCost_ (*edge);
+      // Edges the path of which is not built keep their cost.
+      else if (!edge->deferred ()) edge->cost_ = edge->path ()->length ();
+    }
+
+    value_type Roadmap::cost (const PathPtr_t& path, value_type clearance) const
+    {
+      if (!edgeCost_) return path->length ();
+      Edge edge (0x0, 0x0, path);
+      edge.clearance_ = clearance;
+      return edgeCost_ (edge);
+    }
+
+    void Roadmap::clearance (const EdgePtr_t& edge, value_type clearance)
+    {
+      edge->clearance_ = clearance;
+      computeCost (edge);
+      ++revision_;
+    }
+
+    void Roadmap::sweptVolume (const EdgePtr_t& edge, const fcl::AABB& volume)
+    {
+      edge->sweptVolume_ = volume;
+    }
+
+    value_type Roadmap::ClearanceCost::operator() (const Edge& edge) const
+    {
+      const value_type length (edge.path ()->length ());
+      if (edge.clearance () < 0) return length;
+      return length * (1 + weight_ / std::max (edge.clearance (),
+                                               minClearance_));
+    }
+
     void Roadmap::addEdge (const EdgePtr_t& edge)
     {
+      computeCost (edge);
       edges_.push_back (edge);
+      ++revision_;
+      // Edges that are not validated do not connect components.
+      if (!edge->validated ()) return;
 
       ConnectedComponentPtr_t cc1 = edge->from()->connectedComponent ();
       ConnectedComponentPtr_t cc2 = edge->to  ()->connectedComponent ();
@@ -327,6 +729,151 @@ namespace hpp {
       return false;
     }
 
+    size_type Roadmap::prune (size_type maxNodes)
+    {
+      size_type removed = 0;
+      while ((size_type) nodes_.size () > maxNodes) {
+	// Score leaves by their distance to the initial and goal nodes.
+	std::vector <ScoredNode_t> leaves;
+	for (Nodes_t::const_iterator it = nodes_.begin (); it != nodes_.end ();
+	     ++it) {
+	  const NodePtr_t node = *it;
+	  if (node == initNode_ || std::find (goalNodes_.begin (),
+					      goalNodes_.end (), node) !=
+	      goalNodes_.end ()) continue;
+	  const NodePtr_t neighbor = uniqueNeighbor (node);
+	  if (!neighbor || neighbor->connectedComponent () !=
+	      node->connectedComponent ()) continue;
+	  value_type score = std::numeric_limits <value_type>::infinity ();
+	  if (initNode_) score = (*distance_) (initNode_, node);
+	  for (NodeVector_t::const_iterator itGoal = goalNodes_.begin ();
+	       itGoal != goalNodes_.end (); ++itGoal) {
+	    score = std::min (score, (*distance_) (*itGoal, node));
+	  }
+	  leaves.push_back (ScoredNode_t (score, node));
+	}
+	if (leaves.empty ()) break;
+	std::sort (leaves.begin (), leaves.end (),
+		   std::greater <ScoredNode_t> ());
+
+	// Two leaves connected to each other cannot both be removed.
+	std::set <NodePtr_t> toRemove;
+	for (std::size_t i = 0; i < leaves.size () &&
+	       nodes_.size () - toRemove.size () > (std::size_t) maxNodes; ++i) {
+	  const NodePtr_t node = leaves [i].second;
+	  if (toRemove.count (uniqueNeighbor (node))) continue;
+	  toRemove.insert (node);
+	}
+	removeLeaves (toRemove);
+	removed += (size_type) toRemove.size ();
+      }
+      hppDout (info, "Removed " << removed << " nodes from the roadmap.");
+      return removed;
+    }
+
+    void Roadmap::removeLeaves (const std::set <NodePtr_t>& leaves)
+    {
+      std::set <EdgePtr_t> edges;
+      std::set <ConnectedComponentPtr_t> ccs;
+      for (std::set <NodePtr_t>::const_iterator it = leaves.begin ();
+	   it != leaves.end (); ++it) {
+	const NodePtr_t node = *it;
+	for (Edges_t::const_iterator itEdge = node->outEdges ().begin ();
+	     itEdge != node->outEdges ().end (); ++itEdge) {
+	  (*itEdge)->to ()->removeInEdge (*itEdge);
+	  edges.insert (*itEdge);
+	}
+	for (Edges_t::const_iterator itEdge = node->inEdges ().begin ();
+	     itEdge != node->inEdges ().end (); ++itEdge) {
+	  (*itEdge)->from ()->removeOutEdge (*itEdge);
+	  edges.insert (*itEdge);
+	}
+	nearestNeighbor_->removeNode (node);
+	ccs.insert (node->connectedComponent ());
+      }
+      for (std::set <ConnectedComponentPtr_t>::const_iterator it = ccs.begin ();
+	   it != ccs.end (); ++it) {
+	NodeVector_t& nodes = (*it)->nodes_;
+	nodes.erase (std::remove_if (nodes.begin (), nodes.end (),
+				     IsIn <NodePtr_t> (leaves)), nodes.end ());
+      }
+      edges_.remove_if (IsIn <EdgePtr_t> (edges));
+      nodes_.remove_if (IsIn <NodePtr_t> (leaves));
+      for (std::set <EdgePtr_t>::const_iterator it = edges.begin ();
+	   it != edges.end (); ++it) {
+	delete *it;
+      }
+      for (std::set <NodePtr_t>::const_iterator it = leaves.begin ();
+	   it != leaves.end (); ++it) {
+	delete *it;
+      }
+      // Addresses of deleted nodes may be reused.
+      distanceCache_.clear ();
+      ++revision_;
+    }
+
+    Roadmap::Statistics::Statistics () :
+      nodes (0), edges (0), connectedComponents (0), deferredEdges (0),
+      averageDegree (0), nodeBytes (0), edgeBytes (0), pathBytes (0),
+      nearestNeighborBytes (0), connectedComponentBytes (0),
+      distanceCacheBytes (0), treeDepth (0), treeAverageDepth (0)
+    {
+    }
+
+    std::size_t Roadmap::Statistics::bytes () const
+    {
+      return nodeBytes + edgeBytes + pathBytes + nearestNeighborBytes +
+        connectedComponentBytes + distanceCacheBytes;
+    }
+
+    Roadmap::Statistics Roadmap::statistics () const
+    {
+      Statistics s;
+      for (Nodes_t::const_iterator it = nodes_.begin (); it != nodes_.end ();
+           ++it) {
+        ++s.nodes;
+        s.nodeBytes += sizeof (Node) + elementSize <NodePtr_t> () +
+          ((*it)->outEdges ().size () + (*it)->inEdges ().size ()) *
+          elementSize <EdgePtr_t> ();
+        if ((*it)->configuration ())
+          s.nodeBytes += configurationSize ((*it)->configuration ()->size ());
+      }
+      std::set <const Path*> paths;
+      for (Edges_t::const_iterator it = edges_.begin (); it != edges_.end ();
+           ++it) {
+        ++s.edges;
+        s.edgeBytes += sizeof (Edge) + elementSize <EdgePtr_t> ();
+        if ((*it)->deferred ()) {
+          ++s.deferredEdges;
+          continue;
+        }
+        if ((*it)->path ()) s.pathBytes += pathSize ((*it)->path (), paths);
+      }
+      if (s.nodes > 0)
+        s.averageDegree = (value_type) s.edges / (value_type) s.nodes;
+      for (ConnectedComponents_t::const_iterator it
+             (connectedComponents_.begin ());
+           it != connectedComponents_.end (); ++it) {
+        const ConnectedComponent& cc (**it);
+        ++s.connectedComponents;
+        s.connectedComponentBytes += sizeof (ConnectedComponent) +
+          elementSize <ConnectedComponentPtr_t> () +
+          cc.nodes_.capacity () * sizeof (NodePtr_t) +
+          (cc.reachableFrom_.size () + cc.reachableTo_.size () +
+           cc.allReachableFrom_.size () + cc.allReachableTo_.size ()) *
+          elementSize <ConnectedComponent::RawPtr_t> ();
+      }
+      if (nearestNeighbor_) {
+        s.nearestNeighborBytes = nearestNeighbor_->memory ();
+        s.treeDepth = nearestNeighbor_->depth ();
+        s.treeAverageDepth = nearestNeighbor_->averageDepth ();
+      }
+      s.distanceCacheBytes = distanceCache_.size () *
+        elementSize <DistanceCache_t::value_type> () +
+        distanceCache_.bucket_count () * sizeof (void*);
+      return s;
+    }
+
     std::ostream& Roadmap::print (std::ostream& os) const
     {
       // Enumerate nodes and connected components
@@ -416,6 +963,23 @@ namespace hpp {
     {
       return r.print (os);
     }
+
+    std::ostream& operator<< (std::ostream& os, const Roadmap::Statistics& s)
+    {
+      os << "nodes: " << s.nodes << ", edges: " << s.edges
+         << " (" << s.deferredEdges << " deferred), connected components: "
+         << s.connectedComponents << ", average degree: " << s.averageDegree
+         << std::endl << "nearest neighbor tree depth: " << s.treeDepth
+         << ", average depth: " << s.treeAverageDepth
+         << std::endl << "memory: " << s.bytes () << " bytes"
+         << std::endl << "  nodes: " << s.nodeBytes
+         << std::endl << "  edges: " << s.edgeBytes
+         << std::endl << "  paths: " << s.pathBytes
+         << std::endl << "  nearest neighbor: " << s.nearestNeighborBytes
+         << std::endl << "  connected components: "
+         << s.connectedComponentBytes
+         << std::endl << "  distance cache: " << s.distanceCacheBytes;
+      return os;
+    }
   } //   namespace core
 } // namespace hpp
-
@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/self-collision-analysis.hh>
+
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <hpp/util/debug.hh>
+#include <hpp/util/exception-factory.hh>
+#include <hpp/fcl/collision.h>
+
+#include <pinocchio/multibody/geometry.hpp>
+#include <pinocchio/multibody/model.hpp>
+
+#include <hpp/pinocchio/collision-object.hh>
+#include <hpp/pinocchio/device.hh>
+
+#include <hpp/core/configuration-shooter.hh>
+
+namespace hpp {
+  namespace core {
+    SelfCollisionAnalysisPtr_t SelfCollisionAnalysis::create
+    (const DevicePtr_t& robot)
+    {
+      return SelfCollisionAnalysisPtr_t (new SelfCollisionAnalysis (robot));
+    }
+
+    SelfCollisionAnalysis::SelfCollisionAnalysis (const DevicePtr_t& robot) :
+      robot_ (robot), numberSamples_ (0),
+      collisions_ (Counts_t::Constant (robot->nbJoints () + 1,
+                                       robot->nbJoints () + 1, -1))
+    {
+    }
+
+    void SelfCollisionAnalysis::run (const ConfigurationShooterPtr_t& shooter,
+                                     size_type nbSamples)
+    {
+      if (nbSamples < 1)
+        throw std::invalid_argument ("number of samples should be positive.");
+      typedef std::pair <CollisionObjectConstPtr_t, CollisionObjectConstPtr_t>
+        CollisionPair_t;
+      const pinocchio::GeomModel& model = robot_->geomModel();
+      const pinocchio::GeomData & data  = robot_->geomData();
+
+      std::vector <CollisionPair_t> pairs;
+      collisions_.setConstant (-1);
+      for (std::size_t i = 0; i < model.collisionPairs.size(); ++i) {
+        if (!data.activeCollisionPairs[i]) continue;
+        CollisionObjectConstPtr_t o1 (new pinocchio::CollisionObject(robot_,
+              model.collisionPairs[i].first));
+        CollisionObjectConstPtr_t o2 (new pinocchio::CollisionObject(robot_,
+              model.collisionPairs[i].second));
+        pairs.push_back (CollisionPair_t (o1, o2));
+        collisions_ (o1->jointIndex (), o2->jointIndex ()) = 0;
+        collisions_ (o2->jointIndex (), o1->jointIndex ()) = 0;
+      }
+
+      // Joint pairs in collision in the current sample
+      Eigen::Matrix <bool, Eigen::Dynamic, Eigen::Dynamic> inCollision
+        (collisions_.rows (), collisions_.cols ());
+      pinocchio::DeviceSync device (robot_);
+      fcl::CollisionRequest request (fcl::NO_REQUEST, 1);
+      fcl::CollisionResult result;
+      Configuration_t q;
+      for (size_type k = 0; k < nbSamples; ++k) {
+        shooter->shoot (q);
+        device.currentConfiguration (q);
+        device.computeForwardKinematics ();
+        device.updateGeometryPlacements ();
+        inCollision.setConstant (false);
+        for (std::size_t i = 0; i < pairs.size (); ++i) {
+          const size_type ja (pairs [i].first ->jointIndex ()),
+            jb (pairs [i].second->jointIndex ());
+          if (inCollision (ja, jb)) continue;
+          result.clear ();
+          if (fcl::collide (pairs [i].first ->fcl (device.d ()),
+                            pairs [i].second->fcl (device.d ()),
+                            request, result) != 0) {
+            inCollision (ja, jb) = inCollision (jb, ja) = true;
+          }
+        }
+        for (size_type i = 0; i < collisions_.rows (); ++i) {
+          for (size_type j = 0; j < collisions_.cols (); ++j) {
+            if (inCollision (i, j)) ++collisions_ (i, j);
+          }
+        }
+      }
+      numberSamples_ = nbSamples;
+    }
+
+    SelfCollisionAnalysis::PairStatus SelfCollisionAnalysis::status
+    (size_type jointA, size_type jointB) const
+    {
+      const size_type count (collisions_ (jointA, jointB));
+      if (count < 0) return NotTested;
+      if (count == 0) return NeverCollide;
+      if (count == numberSamples_) return AlwaysCollide;
+      return SometimesCollide;
+    }
+
+    void SelfCollisionAnalysis::filter (RelativeMotion::matrix_type& matrix)
+      const
+    {
+      if (numberSamples_ == 0) return;
+      assert (matrix.rows () == collisions_.rows ());
+      assert (matrix.cols () == collisions_.cols ());
+      for (size_type i = 0; i < collisions_.rows (); ++i) {
+        for (size_type j = 0; j < collisions_.cols (); ++j) {
+          const PairStatus s (status (i, j));
+          if (s == NeverCollide || s == AlwaysCollide) {
+            hppDout (info, "Pair of joints " << robot_->model ().names [i]
+                     << ", " << robot_->model ().names [j]
+                     << (s == NeverCollide ? " never" : " always")
+                     << " collide.");
+            matrix (i, j) = RelativeMotion::Constrained;
+          }
+        }
+      }
+    }
+
+    void SelfCollisionAnalysis::save (std::ostream& os) const
+    {
+      const pinocchio::Model& model (robot_->model ());
+      os << numberSamples_ << '\n';
+      for (size_type i = 0; i < collisions_.rows (); ++i) {
+        for (size_type j = i + 1; j < collisions_.cols (); ++j) {
+          if (collisions_ (i, j) < 0) continue;
+          os << model.names [i] << ' ' << model.names [j] << ' '
+             << collisions_ (i, j) << '\n';
+        }
+      }
+    }
+
+    void SelfCollisionAnalysis::load (std::istream& is)
+    {
+      const pinocchio::Model& model (robot_->model ());
+      size_type nbSamples;
+      if (!(is >> nbSamples) || nbSamples < 0)
+        throw std::runtime_error ("Failed to read the number of samples of "
+                                  "the self-collision analysis.");
+      Counts_t collisions (Counts_t::Constant (collisions_.rows (),
+                                               collisions_.cols (), -1));
+      std::string nameA, nameB;
+      size_type count;
+      while (is >> nameA >> nameB >> count) {
+        if (!model.existJointName (nameA) || !model.existJointName (nameB)) {
+          HPP_THROW (std::runtime_error, "Joint " << nameA << " or " << nameB
+                     << " is not in the model of robot " << robot_->name ());
+        }
+        if (count < 0 || count > nbSamples) {
+          HPP_THROW (std::runtime_error, "Wrong number of collisions "
+                     << count << " between joints " << nameA
+                     << " and " << nameB << '.');
+        }
+        const size_type i (model.getJointId (nameA)),
+          j (model.getJointId (nameB));
+        collisions (i, j) = collisions (j, i) = count;
+      }
+      if (!is.eof ())
+        throw std::runtime_error ("Failed to read the self-collision "
+                                  "analysis.");
+      numberSamples_ = nbSamples;
+      collisions_ = collisions;
+    }
+  } // namespace core
+} // namespace hpp
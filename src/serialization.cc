@@ -19,6 +19,7 @@
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/set.hpp>
 #include <boost/serialization/list.hpp>
+#include <boost/serialization/version.hpp>
 #include <boost/serialization/weak_ptr.hpp>
 
 #include <pinocchio/serialization/eigen.hpp>
@@ -37,6 +38,8 @@ BOOST_CLASS_EXPORT(hpp::core::Node)
 BOOST_CLASS_EXPORT(hpp::core::Edge)
 BOOST_CLASS_EXPORT(hpp::core::ConnectedComponent)
 BOOST_CLASS_EXPORT(hpp::core::Roadmap)
+// Version 1 stores whether edges are validated.
+BOOST_CLASS_VERSION(hpp::core::Edge, 1)
 
 namespace hpp {
 namespace core {
@@ -48,6 +51,8 @@ inline void Node::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(configuration_);
   ar & BOOST_SERIALIZATION_NVP(outEdges_);
   ar & BOOST_SERIALIZATION_NVP(inEdges_);
+  // Store the connected component after merges.
+  if (!Archive::is_loading::value) connectedComponent ();
   ar & BOOST_SERIALIZATION_NVP(connectedComponent_);
 }
 HPP_SERIALIZATION_IMPLEMENT(Node);
@@ -55,10 +60,14 @@ HPP_SERIALIZATION_IMPLEMENT(Node);
 template <typename Archive>
 inline void Edge::serialize(Archive& ar, const unsigned int version)
 {
-  (void) version;
   ar & BOOST_SERIALIZATION_NVP(n1_);
   ar & BOOST_SERIALIZATION_NVP(n2_);
+  // Paths built on first access are built before being saved.
+  if (!Archive::is_loading::value) path ();
   ar & BOOST_SERIALIZATION_NVP(path_);
+  if (version > 0) ar & BOOST_SERIALIZATION_NVP(validated_);
+  // Custom costs are not stored, see Roadmap::edgeCost.
+  if (Archive::is_loading::value) cost_ = path_->length ();
 }
 HPP_SERIALIZATION_IMPLEMENT(Edge);
 
@@ -85,6 +94,16 @@ inline void Roadmap::serialize(Archive& ar, const unsigned int version)
   ar & BOOST_SERIALIZATION_NVP(goalNodes_);
   ar & BOOST_SERIALIZATION_NVP(nearestNeighbor_);
   ar & BOOST_SERIALIZATION_NVP(weak_);
+  if (Archive::is_loading::value) {
+    // Nearest neighbor structures do not store the nodes.
+    nearestNeighbor_->clear ();
+    for (Nodes_t::const_iterator it = nodes_.begin (); it != nodes_.end (); ++it)
+      nearestNeighbor_->addNode (*it);
+    // Transitive reachability is not stored.
+    for (ConnectedComponents_t::const_iterator it = connectedComponents_.begin ();
+         it != connectedComponents_.end (); ++it)
+      (*it)->computeAllReachableTo ();
+  }
 }
 HPP_SERIALIZATION_IMPLEMENT(Roadmap);
 
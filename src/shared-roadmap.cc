@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/shared-roadmap.hh>
+
+#include <hpp/core/compact-roadmap.hh>
+#include <hpp/core/roadmap.hh>
+
+namespace hpp {
+  namespace core {
+    SharedRoadmapPtr_t SharedRoadmap::create (const RoadmapPtr_t& roadmap)
+    {
+      return SharedRoadmapPtr_t (new SharedRoadmap (roadmap));
+    }
+
+    SharedRoadmap::SharedRoadmap (const RoadmapPtr_t& roadmap) :
+      roadmap_ (roadmap), compact_ (CompactRoadmap::create (roadmap))
+    {
+    }
+
+    std::vector <Nodes_t> SharedRoadmap::nearestNodes
+    (const matrix_t& configurations, size_type k) const
+    {
+      if (roadmap_->nodes ().empty ())
+        return std::vector <Nodes_t> (configurations.cols ());
+      boost::mutex::scoped_lock lock (mutex_);
+      return roadmap_->nearestNodes (configurations, k);
+    }
+  } //   namespace core
+} // namespace hpp
@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/steering-method/cached.hh>
+
+#include <list>
+#include <stdexcept>
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <hpp/core/config-projector.hh>
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/path.hh>
+#include <hpp/core/trace.hh>
+
+namespace hpp {
+  namespace core {
+    namespace steeringMethod {
+      /// Least recently used paths of the steering method
+      struct Cached::Cache
+      {
+        struct Key
+        {
+          const ConstraintSet* constraints;
+          Configuration_t initial, end;
+          vector_t rhs;
+        }; // struct Key
+        struct Entry
+        {
+          Key key;
+          /// Keeps the constraints of the key alive
+          ConstraintSetPtr_t constraints;
+          PathPtr_t path;
+        }; // struct Entry
+        struct Hash
+        {
+          std::size_t operator() (const Key& key) const
+          {
+            std::size_t seed (0);
+            boost::hash_combine (seed, key.constraints);
+            boost::hash_range (seed, key.initial.data (),
+                               key.initial.data () + key.initial.size ());
+            boost::hash_range (seed, key.end.data (),
+                               key.end.data () + key.end.size ());
+            boost::hash_range (seed, key.rhs.data (),
+                               key.rhs.data () + key.rhs.size ());
+            return seed;
+          }
+        }; // struct Hash
+        struct Equal
+        {
+          bool operator() (const Key& a, const Key& b) const
+          {
+            return a.constraints == b.constraints &&
+              a.initial.size () == b.initial.size () &&
+              a.initial == b.initial && a.end.size () == b.end.size () &&
+              a.end == b.end && a.rhs.size () == b.rhs.size () &&
+              a.rhs == b.rhs;
+          }
+        }; // struct Equal
+        /// Entries from the most to the least recently used
+        typedef std::list <Entry> Entries_t;
+        typedef boost::unordered_map <Key, Entries_t::iterator, Hash, Equal>
+          Map_t;
+
+        static Key key (const ConstraintSetPtr_t& constraints,
+                        ConfigurationIn_t q1, ConfigurationIn_t q2,
+                        const vector_t& rhs)
+        {
+          Key result;
+          result.constraints = constraints.get ();
+          result.initial = q1;
+          result.end = q2;
+          result.rhs = rhs;
+          return result;
+        }
+
+        Entries_t entries;
+        Map_t map;
+      }; // struct Cache
+
+      CachedPtr_t Cached::create (const SteeringMethodPtr_t& steeringMethod,
+                                  size_type cacheSize)
+      {
+        if (cacheSize < 1)
+          throw std::invalid_argument ("The size of the cache of steering "
+                                       "methods should be positive.");
+        Cached* ptr = new Cached (steeringMethod, cacheSize);
+        CachedPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      CachedPtr_t Cached::createCopy (const CachedPtr_t& other)
+      {
+        Cached* ptr = new Cached (*other);
+        CachedPtr_t shPtr (ptr);
+        ptr->init (shPtr);
+        return shPtr;
+      }
+
+      Cached::Cached (const SteeringMethodPtr_t& steeringMethod,
+                      size_type cacheSize) :
+        SteeringMethod (steeringMethod->problem ()),
+        steeringMethod_ (steeringMethod), cacheSize_ (cacheSize),
+        cacheHits_ (0), cacheMisses_ (0), cache_ (new Cache), weak_ ()
+      {
+        constraints (steeringMethod->constraints ());
+      }
+
+      Cached::Cached (const Cached& other) :
+        SteeringMethod (other),
+        steeringMethod_ (other.steeringMethod_->copy ()),
+        cacheSize_ (other.cacheSize_), cacheHits_ (0), cacheMisses_ (0),
+        cache_ (new Cache), weak_ ()
+      {
+      }
+
+      size_type Cached::cacheHits () const
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        return cacheHits_;
+      }
+
+      size_type Cached::cacheMisses () const
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        return cacheMisses_;
+      }
+
+      void Cached::clearCache ()
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        cache_->entries.clear ();
+        cache_->map.clear ();
+      }
+
+      vector_t Cached::rightHandSide () const
+      {
+        const ConstraintSetPtr_t& c (constraints ());
+        if (c && c->configProjector ())
+          return c->configProjector ()->rightHandSide ();
+        return vector_t ();
+      }
+
+      PathPtr_t Cached::find (ConfigurationIn_t q1, ConfigurationIn_t q2,
+                              const vector_t& rhs) const
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        Cache::Map_t::iterator found
+          (cache_->map.find (Cache::key (constraints (), q1, q2, rhs)));
+        if (found == cache_->map.end ()) {
+          ++cacheMisses_;
+          if (Trace::enabled ())
+            Trace::counter ("SteeringMethod cache misses",
+                            (double) cacheMisses_);
+          return PathPtr_t ();
+        }
+        ++cacheHits_;
+        if (Trace::enabled ())
+          Trace::counter ("SteeringMethod cache hits", (double) cacheHits_);
+        cache_->entries.splice (cache_->entries.begin (), cache_->entries,
+                                found->second);
+        return found->second->path->copy ();
+      }
+
+      void Cached::insert (ConfigurationIn_t q1, ConfigurationIn_t q2,
+                           const vector_t& rhs, const PathPtr_t& path) const
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        Cache::Entry entry;
+        entry.key = Cache::key (constraints (), q1, q2, rhs);
+        if (cache_->map.find (entry.key) != cache_->map.end ()) return;
+        entry.constraints = constraints ();
+        // The caller may modify the path it receives.
+        entry.path = path->copy ();
+        cache_->entries.push_front (entry);
+        cache_->map [entry.key] = cache_->entries.begin ();
+        while ((size_type) cache_->map.size () > cacheSize_) {
+          cache_->map.erase (cache_->entries.back ().key);
+          cache_->entries.pop_back ();
+        }
+      }
+
+      PathPtr_t Cached::impl_compute (ConfigurationIn_t q1,
+                                      ConfigurationIn_t q2) const
+      {
+        const vector_t rhs (rightHandSide ());
+        PathPtr_t path (find (q1, q2, rhs));
+        if (path) return path;
+        steeringMethod_->constraints (constraints ());
+        path = (*steeringMethod_) (q1, q2);
+        if (path) insert (q1, q2, rhs, path);
+        return path;
+      }
+
+      void Cached::impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+                                 std::vector <PathPtr_t>& paths) const
+      {
+        const vector_t rhs (rightHandSide ());
+        std::vector <size_type> missing;
+        for (size_type i = 0; i < targets.cols (); ++i) {
+          paths [i] = find (q1, targets.col (i), rhs);
+          if (!paths [i]) missing.push_back (i);
+        }
+        if (missing.empty ()) return;
+
+        matrix_t missingTargets (targets.rows (), missing.size ());
+        for (std::size_t k = 0; k < missing.size (); ++k)
+          missingTargets.col (k) = targets.col (missing [k]);
+        std::vector <PathPtr_t> missingPaths;
+        steeringMethod_->constraints (constraints ());
+        steeringMethod_->steer (q1, missingTargets, missingPaths);
+        for (std::size_t k = 0; k < missing.size (); ++k) {
+          const PathPtr_t& path (missingPaths [k]);
+          paths [missing [k]] = path;
+          if (path) insert (q1, targets.col (missing [k]), rhs, path);
+        }
+      }
+    } // namespace steeringMethod
+  } // namespace core
+} // namespace hpp
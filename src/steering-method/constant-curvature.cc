@@ -356,6 +356,23 @@ namespace hpp {
         }
       }
 
+      value_type ConstantCurvature::rigidAngularVelocity () const
+      {
+        const value_type L = paramLength();
+        if (curvature_ == 0 || L == 0) return 0;
+        vector_t v (robot_->numberDof ());
+        pinocchio::difference <pinocchio::RnxSOnLieGroupMap>
+          (robot_, end_, initial_, v);
+        v.segment<2> (dxyId_).setZero ();
+        v [drzId_] = 0;
+        for (std::vector<Wheels_t>::const_iterator w = wheels_.begin ();
+             w < wheels_.end (); ++w) {
+          v.segment (w->j->rankInVelocity (), w->j->numberDof ()).setZero ();
+        }
+        if (!v.isZero ()) return 0;
+        return std::fabs (curvature_ * curveLength_) / L;
+      }
+
       PathPtr_t ConstantCurvature::impl_extract
       (const interval_t& paramInterval) const
       {
@@ -26,10 +26,10 @@
 namespace hpp {
   namespace core {
     namespace steeringMethod {
-      PathPtr_t Dubins::impl_compute (ConfigurationIn_t q1,
-          ConfigurationIn_t q2) const
+      value_type Dubins::extraLength (ConfigurationIn_t q1,
+          ConfigurationIn_t q2, Configuration_t& qEnd) const
       {
-        Configuration_t qEnd (q2);
+        qEnd = q2;
         qEnd.segment<2>(xyId_) = q1.segment<2>(xyId_);
         qEnd.segment<2>(rzId_) = q1.segment<2>(rzId_);
         // Do not take into account wheel joints in additional distance.
@@ -39,8 +39,35 @@ namespace hpp {
           qEnd [i] = q1 [i];
         }
         // The length corresponding to the non RS DoF
-        DistancePtr_t d (problem().distance());
-        value_type extraL = (*d) (q1, qEnd);
+        return (*problem().distance()) (q1, qEnd);
+      }
+
+      value_type Dubins::length (ConfigurationIn_t q1,
+          ConfigurationIn_t q2) const
+      {
+        Configuration_t qEnd (q2.size ());
+        return DubinsPath::curveLength (q1, q2, rho_, xyId_, rzId_)
+          + extraLength (q1, q2, qEnd);
+      }
+
+      void Dubins::lengths (matrixIn_t q1s, ConfigurationIn_t q2,
+          vector_t& lengths) const
+      {
+        lengths.resize (q1s.cols ());
+        // Shared by all the columns.
+        Configuration_t qEnd (q2.size ());
+        for (size_type i = 0; i < q1s.cols (); ++i) {
+          lengths [i] =
+            DubinsPath::curveLength (q1s.col (i), q2, rho_, xyId_, rzId_)
+            + extraLength (q1s.col (i), q2, qEnd);
+        }
+      }
+
+      PathPtr_t Dubins::impl_compute (ConfigurationIn_t q1,
+          ConfigurationIn_t q2) const
+      {
+        Configuration_t qEnd (q2.size ());
+        value_type extraL = extraLength (q1, q2, qEnd);
         DubinsPathPtr_t path =
           DubinsPath::create (device_.lock (), q1, q2, extraL,
 			      rho_ , xyId_, rzId_, wheels_, constraints ());
@@ -28,7 +28,7 @@
 namespace hpp {
   namespace core {
     namespace steeringMethod {
-      PathPtr_t ReedsShepp::impl_compute (ConfigurationIn_t q1,
+      value_type ReedsShepp::extraLength (ConfigurationIn_t q1,
           ConfigurationIn_t q2) const
       {
         // TODO this should not be done here.
@@ -43,7 +43,20 @@ namespace hpp {
           qEnd [i] = q1 [i];
         }
         // The length corresponding to the non RS DoF
-        value_type extraL = (*problem().distance()) (q1, qEnd);
+        return (*problem().distance()) (q1, qEnd);
+      }
+
+      value_type ReedsShepp::length (ConfigurationIn_t q1,
+          ConfigurationIn_t q2) const
+      {
+        return ReedsSheppPath::curveLength (q1, q2, rho_, xyId_, rzId_)
+          + extraLength (q1, q2);
+      }
+
+      PathPtr_t ReedsShepp::impl_compute (ConfigurationIn_t q1,
+          ConfigurationIn_t q2) const
+      {
+        value_type extraL = extraLength (q1, q2);
 
         ReedsSheppPathPtr_t path =
           ReedsSheppPath::create (device_.lock (), q1, q2, extraL,
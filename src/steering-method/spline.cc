@@ -29,6 +29,17 @@
 namespace hpp {
   namespace core {
     namespace steeringMethod {
+      namespace {
+        /// Orders 1 to n
+        std::vector<int> defaultOrders (int n)
+        {
+          std::vector<int> orders (n);
+          for (std::size_t i = 0; i < orders.size (); ++i)
+            orders[i] = int(i + 1);
+          return orders;
+        }
+      } // namespace
+
       template <int _PB, int _SO>
       PathPtr_t Spline<_PB, _SO>::impl_compute (ConfigurationIn_t q1,
           ConfigurationIn_t q2) const
@@ -40,11 +51,73 @@ namespace hpp {
         typedef typename DerMatrix_t::ConstantReturnType DefaultDerivatives_t;
 
         DefaultDerivatives_t defaultDer (DerMatrix_t::Zero(device_.lock()->numberDof(), NDerivativeConstraintPerSide));
-        std::vector<int> orders (NDerivativeConstraintPerSide);
-        for (std::size_t i = 0; i < NDerivativeConstraintPerSide; ++i) orders[i] = int(i + 1);
+        std::vector<int> orders (defaultOrders (NDerivativeConstraintPerSide));
         return impl_compute (q1, orders, defaultDer, q2, orders, defaultDer);
       }
 
+      template <int _PB, int _SO>
+      void Spline<_PB, _SO>::impl_compute (ConfigurationIn_t q1,
+          matrixIn_t targets, std::vector <PathPtr_t>& paths) const
+      {
+        enum {
+          NDerivativeConstraintPerSide = int( (SplineOrder + 1 - 2) / 2)
+        };
+        typedef Eigen::Matrix<value_type, SplineOrder+1, 1> Coefficients_t;
+
+        // Same problem as impl_compute (q1, q2) with null derivatives. The
+        // base is q1, so the right hand side is zero except for the row of
+        // q2, which is the difference between q2 and q1. The solution is
+        // thus the column of the inverse for this row times this
+        // difference.
+        const std::vector<int> orders
+          (defaultOrders (NDerivativeConstraintPerSide));
+        const size_type row = 1 + NDerivativeConstraintPerSide;
+        Coefficients_t x (inverse (orders, orders).col (row));
+
+        DevicePtr_t robot (device_.lock());
+        const Distance& d (*problem_.distance());
+        vector_t dq (robot->numberDof());
+        for (size_type i = 0; i < targets.cols (); ++i) {
+          value_type length = d (q1, targets.col (i));
+          SplinePathPtr_t p = SplinePath::create
+            (robot, interval_t (0, length), constraints());
+          p->base(q1);
+          pinocchio::difference<pinocchio::RnxSOnLieGroupMap>(robot, targets.col (i), q1, dq);
+          p->parameters (x * dq.transpose());
+          paths [i] = p;
+        }
+      }
+
+      template <int _PB, int _SO>
+      const typename Spline<_PB, _SO>::Inverse_t& Spline<_PB, _SO>::inverse
+      (const std::vector<int>& order1, const std::vector<int>& order2) const
+      {
+        typedef Eigen::Matrix<value_type, Eigen::Dynamic, SplineOrder+1, Eigen::RowMajor> ConstraintMatrix_t;
+
+        Orders_t orders (order1, order2);
+        typename std::map<Orders_t, Inverse_t>::iterator it
+          (inverses_.find (orders));
+        if (it != inverses_.end ()) return it->second;
+
+        // Compute the matrix
+        const size_type nbConstraints = 2 + order1.size() + order2.size();
+        ConstraintMatrix_t coeffs (nbConstraints, SplineOrder+1);
+        SplinePath::timeFreeBasisFunctionDerivative(0, 0, coeffs.row(0).transpose());
+        for (std::size_t i = 0; i < order1.size(); ++i)
+          SplinePath::timeFreeBasisFunctionDerivative(order1[i], 0, coeffs.row(i+1).transpose());
+        const size_type row = 1 + order1.size();
+        SplinePath::timeFreeBasisFunctionDerivative(0, 1, coeffs.row(row).transpose());
+        for (std::size_t i = 0; i < order2.size(); ++i)
+          SplinePath::timeFreeBasisFunctionDerivative(order2[i], 1, coeffs.row(row+1+i).transpose());
+
+        // Least square solution of coeffs * P = rhs is inverse * rhs
+        typedef Eigen::JacobiSVD < ConstraintMatrix_t > SVD_t;
+        SVD_t svd (coeffs, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        Inverse_t inv (svd.solve
+                       (matrix_t::Identity (nbConstraints, nbConstraints)));
+        return inverses_.insert (std::make_pair (orders, inv)).first->second;
+      }
+
       template <int _PB, int _SO>
       PathPtr_t Spline<_PB, _SO>::steer (
           ConfigurationIn_t q1, std::vector<int> order1,  matrixIn_t derivatives1,
@@ -61,9 +134,6 @@ namespace hpp {
               ConfigurationIn_t q1, std::vector<int> order1,  const Eigen::MatrixBase<Derived>& derivatives1,
               ConfigurationIn_t q2, std::vector<int> order2,  const Eigen::MatrixBase<Derived>& derivatives2) const
       {
-        // Compute the decomposition
-        // typedef Eigen::Matrix<value_type, SplineOrder+1, SplineOrder+1> ConstraintMatrix_t;
-        typedef Eigen::Matrix<value_type, Eigen::Dynamic, SplineOrder+1, Eigen::RowMajor> ConstraintMatrix_t;
         typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RhsMatrix_t;
 
         DistancePtr_t d = problem_.distance();
@@ -72,7 +142,6 @@ namespace hpp {
           (device_.lock(), interval_t (0, length), constraints());
 
         const size_type nbConstraints = 2 + derivatives1.cols() + derivatives2.cols();
-        ConstraintMatrix_t coeffs (nbConstraints, SplineOrder+1);
         RhsMatrix_t rhs (nbConstraints, device_.lock()->numberDof());
 
         p->base(q1); // TODO use the center ?
@@ -81,28 +150,18 @@ namespace hpp {
         // pinocchio::interpolate<pinocchio::RnxSOnLieGroupMap>(device_.lock(), q1, q2, 0.5, qmiddle);
         // p->base(qmiddle);
 
-        // Compute the matrices
-        // TODO calls to basisFunctionDerivative could be cached as they do not
-        // depend on the inputs.
-        SplinePath::timeFreeBasisFunctionDerivative(0, 0, coeffs.row(0).transpose());
+        // Compute the right hand side
         pinocchio::difference<pinocchio::RnxSOnLieGroupMap>(device_.lock(), q1, p->base(), rhs.row(0));
-        for (std::size_t i = 0; i < order1.size(); ++i)
-          SplinePath::timeFreeBasisFunctionDerivative(order1[i], 0, coeffs.row(i+1).transpose());
         rhs.middleRows(1, order1.size()).transpose() = derivatives1;
 
         size_type row = 1 + order1.size();
-        SplinePath::timeFreeBasisFunctionDerivative(0, 1, coeffs.row(row).transpose());
         pinocchio::difference<pinocchio::RnxSOnLieGroupMap>(device_.lock(), q2, p->base(), rhs.row(row));
         ++row;
-        for (std::size_t i = 0; i < order2.size(); ++i)
-          SplinePath::timeFreeBasisFunctionDerivative(order2[i], 1, coeffs.row(i+row).transpose());
         rhs.middleRows(row, order2.size()).transpose() = derivatives2;
 
         // Solve the problem
         // coeffs * P = rhs
-        typedef Eigen::JacobiSVD < ConstraintMatrix_t > SVD_t;
-        SVD_t svd (coeffs, Eigen::ComputeFullU | Eigen::ComputeFullV);
-        p->parameters (svd.solve(rhs));
+        p->parameters (inverse (order1, order2) * rhs);
 
         return p;
       }
@@ -110,12 +169,21 @@ namespace hpp {
       template <int _PB, int _SO>
       Spline<_PB, _SO>::Spline (const Problem& problem) :
         SteeringMethod (problem), device_ (problem.robot ())
-      {}
+      {
+        enum {
+          NDerivativeConstraintPerSide = int( (SplineOrder + 1 - 2) / 2)
+        };
+        // Steering without derivatives only reads the cache.
+        const std::vector<int> orders
+          (defaultOrders (NDerivativeConstraintPerSide));
+        inverse (orders, orders);
+      }
 
       /// Copy constructor
       template <int _PB, int _SO>
       Spline<_PB, _SO>::Spline (const Spline& other) :
-        SteeringMethod (other), device_ (other.device_)
+        SteeringMethod (other), device_ (other.device_),
+        inverses_ (other.inverses_)
       {}
 
       //template class Spline<path::CanonicalPolynomeBasis, 1>; // equivalent to StraightPath
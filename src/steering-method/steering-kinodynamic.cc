@@ -20,9 +20,11 @@
 # include <hpp/pinocchio/joint.hh>
 # include <hpp/pinocchio/configuration.hh>
 # include <hpp/core/problem.hh>
+# include <hpp/core/projection-error.hh>
 # include <hpp/core/weighed-distance.hh>
 # include <hpp/core/kinodynamic-path.hh>
 # include <hpp/core/kinodynamic-oriented-path.hh>
+# include "../bang-bang.hh"
 
 namespace hpp {
   namespace core {
@@ -70,15 +72,78 @@ namespace hpp {
         return T;
       }
 
+      Eigen::Array<bool, 3, 1> Kinodynamic::steeredAxes () const
+      {
+        // FIX ME : only work for freeflyer
+        Eigen::Array<bool, 3, 1> steered;
+        for(int indexConfig = 0 ; indexConfig < 3 ; indexConfig++){
+          steered[indexConfig] = problem_.robot()->getJointAtConfigRank(indexConfig)->name() != "base_joint_SO3";
+          if(!steered[indexConfig])
+            hppDout(notice,"!! Steering method for quaternion not implemented yet.");
+        }
+        return steered;
+      }
+
       PathPtr_t Kinodynamic::impl_compute (ConfigurationIn_t q1,
                                            ConfigurationIn_t q2) const
       {
-        double Tmax = 0;
-        double T = 0;
+        size_type configSize = problem_.robot()->configSize() - problem_.robot()->extraConfigSpace().dimension ();
+        // Minimal times of all the axis at once
+        typedef Eigen::Array<value_type, 3, 1> Array3;
+        Array3 sigma;
+        Eigen::Array<bool, 3, 1> twoSegment;
+        Array3 minTimes = bangBang::minimalTimes<3>
+          (q1.head<3>().array(), q2.head<3>().array(),
+           q1.segment<3>(configSize).array(), q2.segment<3>(configSize).array(),
+           aMax_.array().abs(), vMax_.array(), sigma, twoSegment);
+        return createPath (q1, q2, steeredAxes (), minTimes, sigma, twoSegment);
+      }
+
+      void Kinodynamic::impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+                                      std::vector <PathPtr_t>& paths) const
+      {
+        typedef Eigen::Array<value_type, Eigen::Dynamic, 1> Array_t;
+        size_type configSize = problem_.robot()->configSize() - problem_.robot()->extraConfigSpace().dimension ();
+        size_type n = targets.cols ();
+        const Eigen::Array<bool, 3, 1> steered (steeredAxes ());
+        // Solve each axis for all the targets at once
+        Eigen::Array<value_type, 3, Eigen::Dynamic> minTimes (3, n), sigma (3, n);
+        Eigen::Array<bool, 3, Eigen::Dynamic> twoSegment (3, n);
+        Array_t s (n);
+        Eigen::Array<bool, Eigen::Dynamic, 1> two (n);
+        for(int indexConfig = 0 ; indexConfig < 3 ; indexConfig++){
+          size_type indexVel = indexConfig + configSize;
+          minTimes.row(indexConfig) = bangBang::minimalTimes<Eigen::Dynamic>
+            (Array_t::Constant(n, q1[indexConfig]),
+             targets.row(indexConfig).transpose().array(),
+             Array_t::Constant(n, q1[indexVel]),
+             targets.row(indexVel).transpose().array(),
+             Array_t::Constant(n, std::fabs(aMax_[indexConfig])),
+             Array_t::Constant(n, vMax_[indexConfig]), s, two).transpose();
+          sigma.row(indexConfig) = s.transpose();
+          twoSegment.row(indexConfig) = two.transpose();
+        }
+        for (size_type i = 0; i < n; ++i) {
+          try {
+            paths [i] = createPath (q1, targets.col (i), steered,
+                                    minTimes.col (i), sigma.col (i),
+                                    twoSegment.col (i));
+          } catch (const projection_error& e) {
+            hppDout (info, "Could not build path: " << e.what());
+          }
+        }
+      }
+
+      PathPtr_t Kinodynamic::createPath
+      (ConfigurationIn_t q1, ConfigurationIn_t q2,
+       const Eigen::Array<bool, 3, 1>& steered,
+       const Eigen::Array<value_type, 3, 1>& minimalTimes,
+       const Eigen::Array<value_type, 3, 1>& sigma,
+       const Eigen::Array<bool, 3, 1>& twoSegment) const
+      {
         double t0,t1,tv,t2,a1,vLim;
         pinocchio::vector3_t dir(q2[0] - q1[0] ,q2[1] - q1[1] ,q2[2] - q1[2] );
         hppDout(notice,"direction = "<<dir);
-        interval_t infeasibleInterval;
         std::vector<interval_t> infIntervalsVector;
         size_type configSize = problem_.robot()->configSize() - problem_.robot()->extraConfigSpace().dimension ();
         // looking for Tmax
@@ -86,17 +151,13 @@ namespace hpp {
         hppDout(info,"between : "<<pinocchio::displayConfig(q1));
         hppDout(info,"and     : "<<pinocchio::displayConfig(q2));
 
-        // for all joints
-        for(int indexConfig = 0 ; indexConfig < 3 ; indexConfig++){ // FIX ME : only work for freeflyer
+        double Tmax = std::max(0., steered.select(minimalTimes, 0.).maxCoeff());
+        for(int indexConfig = 0 ; indexConfig < 3 ; indexConfig++){
           size_type indexVel = indexConfig + configSize;
-          hppDout(notice,"For joint :"<<problem_.robot()->getJointAtConfigRank(indexConfig)->name());
-          if(problem_.robot()->getJointAtConfigRank(indexConfig)->name() != "base_joint_SO3"){
-            T = computeMinTime(indexConfig,q1[indexConfig],q2[indexConfig],q1[indexVel],q2[indexVel],&infeasibleInterval);
-            infIntervalsVector.push_back(infeasibleInterval);
-            if(T > Tmax)
-              Tmax = T;
-          }else{
-            hppDout(notice,"!! Steering method for quaternion not implemented yet.");
+          if(steered[indexConfig]){
+            infIntervalsVector.push_back(bangBang::infeasibleInterval
+                                         (q1[indexConfig],q2[indexConfig],q1[indexVel],q2[indexVel],
+                                          std::fabs(aMax_[indexConfig]),vMax_[indexConfig],sigma[indexConfig],twoSegment[indexConfig]));
           }
         }
 
@@ -136,8 +197,7 @@ namespace hpp {
         hppDout(info,"compute fixed end-time trajectory for each joint : ");
         for(int indexConfig = 0 ; indexConfig < 3 ; indexConfig++){
           size_type indexVel = indexConfig + configSize;
-          hppDout(notice,"For joint :"<<problem_.robot()->getJointAtConfigRank(indexConfig)->name());
-          if(problem_.robot()->getJointAtConfigRank(indexConfig)->name() != "base_joint_SO3"){
+          if(steered[indexConfig]){
             fixedTimeTrajectory(indexConfig,length,q1[indexConfig],q2[indexConfig],q1[indexVel],q2[indexVel],&a1,&t0,&t1,&tv,&t2,&vLim);
             a1_t[indexConfig]=a1;
             t0_t[indexConfig]=t0;
@@ -201,146 +261,19 @@ namespace hpp {
       }
       
       double Kinodynamic::computeMinTime(int index, double p1, double p2, double v1, double v2, interval_t *infInterval) const{
-        hppDout(info,"p1 = "<<p1<<"  p2 = "<<p2<<"   ; v1 = "<<v1<<"    v2 = "<<v2);        
-        // compute the sign of each acceleration
+        hppDout(info,"p1 = "<<p1<<"  p2 = "<<p2<<"   ; v1 = "<<v1<<"    v2 = "<<v2);
         assert(index >= 0 && index < 3 && "index of joint should be between in [0;2]");
+        typedef Eigen::Array<value_type, 1, 1> Array1;
         double aMax =std::fabs(aMax_[index]);
-        hppDout(notice,"amax used in computeMinTime("<<index<<") = "<<aMax);
         double vMax = vMax_[index];
-        double t1,t2,tv;
-        int sigma;
-        double deltaPacc = 0.5*(v1+v2)*(fabs(v2-v1)/aMax);
-        sigma = sgnenum(p2-p1-deltaPacc);  //TODO bug sigma == 0, temp fix ?
-        hppDout(notice,"deltaPacc = "<<deltaPacc);
-        hppDout(info,"sigma = "<<sigma);
-        if(sigma == 0){ // ??? FIXME
-          sigma = sgn(p2-p1);
-          hppDout(info,"sigma Bis= "<<sigma);
-        }
-        double a1 = (sigma)*aMax;
-        double a2 = -a1;
-        double vLim = (sigma) * vMax;
-        hppDout(info,"Vlim = "<<vLim<<"   ;  aMax = "<<aMax);
-        if(fabs(p2-p1) < (std::numeric_limits<double>::epsilon()*100.) && fabs(v2-v1)<(std::numeric_limits<double>::epsilon()*100.) ){
-          hppDout(notice,"No movement in this joints, abort.");
-          return 0.;
-        }
-        // test if two segment trajectory is valid :
-        bool twoSegment = false;        
-
-        // solve quadratic equation (cf eq 13 article)
-        const double a = a1;
-        const double b = 2. * v1;
-        const double c = (0.5*(v1+v2)*(v2-v1)/a2) - (p2-p1);
-
-        const double q = -0.5*(b+sgnf(b)*sqrt(b*b-4*a*c));
-        hppDout(info, "sign of "<<b<<" is : "<<sgnf(b));
-        double x1 = 0;
-        double x2 = 0;
-        if(a!= 0)
-          x1 = q/a;
-        if(q!=0)
-          x2 = c/q;
-        const double x = std::max(x1,x2);
-        hppDout(info,"Solve quadratic equation : x1 = "<<x1<<"  ; x2 = "<<x2);
-        hppDout(info," x = "<<x);
-        hppDout(info,"t1 before vel limit = "<<x);
-
-        hppDout(info,"inf bound on t1 (from t2 > 0) "<<-((v2-v1)/a2));
-        double minT1 = std::max(0.,-((v2-v1)/a2));  //lower bound for valid t1 value (cf eq 14)
-
-
-        if(x >= minT1){
-          twoSegment = true;
-          t1 = x;
-          hppDout(info,"t1 >= minT1");
-        } 
-        if(twoSegment){ // check if max velocity is respected
-          if(std::abs(v1+(t1)*a1) > vMax){
-            twoSegment = false;
-            hppDout(info,"Doesn't respect max velocity, need 3 segments");
-          }
-        }
-        if(twoSegment){ // compute t2 for two segment trajectory
-          tv = 0.;
-          t2 = ((v2-v1)/a2) + (t1);// eq 14
-        }else{// compute 3 segment trajectory, with constant velocity phase :
-          t1 = (vLim - v1)/a1;  //eq 15
-          tv = ((v1*v1+v2*v2 - 2*vLim*vLim)/(2*vLim*a1)) + (p2-p1)/vLim ; //eq 16
-          t2 = (v2-vLim)/a2;  //eq 17
-        }
-        if(twoSegment){
-          hppDout(notice,"Trajectory with 2 segments");
-        }else{
-          hppDout(notice,"Trajectory with 3 segments");
-        }
-        hppDout(notice,"a1 = "<<a1<<"  ;  a2 ="<<a2);
-        hppDout(notice,"t = "<<(t1)<<"   ;   "<<(tv)<<"   ;   "<<(t2));
-        double T = (t1)+(tv)+(t2);
+        Array1 sigma;
+        Eigen::Array<bool, 1, 1> twoSegment;
+        double T = bangBang::minimalTimes<1>
+          (Array1::Constant(p1), Array1::Constant(p2), Array1::Constant(v1),
+           Array1::Constant(v2), Array1::Constant(aMax), Array1::Constant(vMax),
+           sigma, twoSegment)[0];
         hppDout(notice,"T = "<<T);
-
-        // Compute infeasible interval :
-
-        hppDout(info," !!! CHECKING INFEASIBLE INTERVALS : ");
-
-        if(v1 * v2 <= 0.0 || a1 * v1 < 0.0){
-          // If minimum-time solution goes through zero-velocity, there is no infeasible time interval, because we can stop and wait at zero-velocity
-          infInterval->first=std::numeric_limits<value_type>::infinity();
-          infInterval->second=0;
-          hppDout(info," ! go through v=0, no infeasible interval");
-        }
-        else{
-          double zeroTime1 = std::abs(v1) / aMax;
-          double zeroTime2 = std::abs(v2) / aMax;
-          double zeroDistance = zeroTime1 * v1 / 2.0 + zeroTime2 * v2 / 2.0;
-          if(std::abs(zeroDistance) < std::abs(p2-p1)) { // no infeasible interval
-            infInterval->first = std::numeric_limits<value_type>::infinity();
-            infInterval->second = 0;
-            hppDout(info," ! not region I");
-          }else{ // "region I", infeasible interval exist
-            hppDout(info," ! region I, infeasible interval exist");
-            a1 = a2;
-            a2 = -a2;
-            vLim = -vLim;
-            // solve eq 13 with new a1/a2 :
-            const double ai = a1;
-            const double bi = 2. * v1;
-            const double ci = (0.5*(v1+v2)*(v2-v1)/a2) - (p2-p1);
-            const double deltai = bi*bi - 4.0*ai*ci;
-            if(deltai < 0 )
-              std::cout<<"Error : determinant of quadratic function negative"<<std::endl;
-
-
-            const double x1i = (-bi + sqrt(deltai))/(2*ai);
-            const double x2i = (-bi - sqrt(deltai))/(2*ai);
-            const double xi = std::max(x1i,x2i);
-            hppDout(info,"quadratic equation solutions : "<<x1i<<" , "<<x2i);
-            // min bound of infeasible interval is given by lesser solution
-            t1 = std::min(x1i,x2i);
-            infInterval->first = (((v2-v1)/a2) + (t1)) + t1; // eq 14 (T = t2+t1)
-            //check if greater solution violate velocity limits :
-            minT1 = -minT1;
-            if(xi > minT1){
-              twoSegment = true;
-              t1 = xi;
-            }
-            if(twoSegment){ // check if max velocity is respected
-              if(std::abs(v1+(t1)*a1) > vMax)
-                twoSegment = false;
-            }
-            if(twoSegment){ // compute t2 for two segment trajectory
-              tv = 0.;
-              t2 = ((v2-v1)/a2) + (t1);// eq 14
-            }else{// compute 3 segment trajectory, with constant velocity phase :
-              t1 = (vLim - v1)/a1;  //eq 15
-              tv = ((v1*v1+v2*v2 - 2*vLim*vLim)/(2*vLim*a1)) + (p2-p1)/vLim ; //eq 16
-              t2 = (v2-vLim)/a2;  //eq 17
-            }
-            infInterval->second = t1+tv+t2;
-            hppDout(info,"! INFEASIBLE INTERVAL : ["<<infInterval->first<<" ; "<<infInterval->second<<" ]");
-          }
-        }
-
+        *infInterval = bangBang::infeasibleInterval(p1,p2,v1,v2,aMax,vMax,sigma[0],twoSegment[0]);
         return T;
       }
       
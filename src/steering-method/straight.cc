@@ -40,6 +40,33 @@ namespace hpp {
           (problem_.robot(), q1, q2, length, c);
         return path;
       }
+
+      void Straight::impl_compute (ConfigurationIn_t q1, matrixIn_t targets,
+          std::vector <PathPtr_t>& paths) const
+      {
+        const Distance& distance (*problem_.distance());
+        ConstraintSetPtr_t c;
+        bool copy = constraints() && constraints()->configProjector ();
+        if (copy) {
+          c = HPP_STATIC_PTR_CAST (ConstraintSet, constraints()->copy ());
+          c->configProjector()->rightHandSideFromConfig (q1);
+          c->configProjector()->lineSearchType (ConfigProjector::Backtracking);
+        } else {
+          c = constraints ();
+        }
+        for (size_type i = 0; i < targets.cols (); ++i) {
+          value_type length = distance (q1, targets.col (i));
+          // Each path owns a copy of the constraints with the right hand
+          // side computed above.
+          try {
+            paths [i] = StraightPath::create
+              (problem_.robot(), q1, targets.col (i), length,
+               copy ? HPP_STATIC_PTR_CAST (ConstraintSet, c->copy ()) : c);
+          } catch (const projection_error& e) {
+            hppDout (info, "Could not build path: " << e.what());
+          }
+        }
+      }
     } // namespace steeringMethod
   } // namespace core
 } // namespace hpp
@@ -51,7 +51,7 @@ namespace hpp {
 				interval_t interval) :
       parent_t (interval, space->nq(), space->nv()),
       space_ (space),
-      initial_ (init), end_ (end)
+      initial_ (init), end_ (end), vectorSpace_ (space->isVectorSpace ())
     {
       assert (interval.second >= interval.first);
       assert (!constraints ());
@@ -64,7 +64,7 @@ namespace hpp {
                                 ConstraintSetPtr_t constraints) :
       parent_t (interval, space->nq(), space->nv(), constraints),
       space_ (space),
-      initial_ (init), end_ (end)
+      initial_ (init), end_ (end), vectorSpace_ (space->isVectorSpace ())
     {
       assert (interval.second >= interval.first);
     }
@@ -72,14 +72,15 @@ namespace hpp {
     StraightPath::StraightPath (const StraightPath& path) :
       parent_t (path), space_ (path.space_),
       initial_ (path.initial_),
-      end_ (path.end_)
+      end_ (path.end_), vectorSpace_ (path.vectorSpace_)
     {
     }
 
     StraightPath::StraightPath (const StraightPath& path,
 				const ConstraintSetPtr_t& constraints) :
       parent_t (path, constraints), space_ (path.space_),
-      initial_ (path.initial_), end_ (path.end_)
+      initial_ (path.initial_), end_ (path.end_),
+      vectorSpace_ (path.vectorSpace_)
     {
       assert (constraints->isSatisfied (initial_));
       assert (constraints->isSatisfied (end_));
@@ -99,10 +100,48 @@ namespace hpp {
       }
       value_type u = (param - paramRange().first) / L;
       if (L == 0) u = 0;
-      space_->interpolate(initial_, end_, u, result);
+      if (vectorSpace_)
+        result.noalias () = initial_ + u * (end_ - initial_);
+      else
+        space_->interpolate(initial_, end_, u, result);
       return true;
     }
 
+    size_type StraightPath::impl_compute (matrixOut_t result,
+                                          vectorIn_t params) const
+    {
+      const value_type L = paramLength();
+      const LiegroupElementConstRef q0
+        (space_->elementConstRef (initial_));
+      vector_t v;
+      if (L != 0) {
+        if (vectorSpace_) v = end_ - initial_;
+        else v = space_->elementConstRef (end_) - q0;
+      }
+      for (size_type i = 0; i < params.size (); ++i) {
+        const value_type& param = params [i];
+        const value_type u ((param - paramRange().first) / L);
+        if (param == paramRange ().first || L == 0)
+          result.col (i) = initial_;
+        else if (param == paramRange ().second)
+          result.col (i) = end_;
+        else if (vectorSpace_)
+          result.col (i).noalias () = initial_ + u * v;
+        else
+          result.col (i) = (q0 + u * v).vector ();
+      }
+      return params.size ();
+    }
+
+    void StraightPath::impl_derivative (matrixOut_t result, vectorIn_t params,
+					size_type order) const
+    {
+      if (params.size () == 0) return;
+      impl_derivative (result.col (0), params [0], order);
+      for (size_type i = 1; i < params.size (); ++i)
+        result.col (i) = result.col (0);
+    }
+
     void StraightPath::impl_derivative (vectorOut_t result, const value_type&,
 					size_type order) const
     {
@@ -115,7 +154,10 @@ namespace hpp {
 	  result.setZero ();
 	  return;
 	}
-        result = space_->elementConstRef(end_) - space_->elementConstRef(initial_);
+        if (vectorSpace_)
+          result.noalias () = end_ - initial_;
+        else
+          result = space_->elementConstRef(end_) - space_->elementConstRef(initial_);
         result /= paramLength();
 	return;
       }
@@ -169,6 +211,8 @@ namespace hpp {
       ar & BOOST_SERIALIZATION_NVP(initial_);
       ar & BOOST_SERIALIZATION_NVP(end_);
       ar & BOOST_SERIALIZATION_NVP(weak_);
+      if (Archive::is_loading::value)
+        vectorSpace_ = space_->isVectorSpace ();
     }
 
     HPP_SERIALIZATION_IMPLEMENT(StraightPath);
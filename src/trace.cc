@@ -0,0 +1,231 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <hpp/core/trace.hh>
+
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <hpp/util/exception-factory.hh>
+
+namespace hpp {
+  namespace core {
+    namespace {
+      /// Span, or value of a counter if end is negative
+      struct Event
+      {
+        const char* name;
+        boost::int64_t start, end;
+        double value;
+      }; // struct Event
+
+      /// Ring buffer of the spans of a thread
+      ///
+      /// Only the thread writes in the buffer. Span i is stored in
+      /// events [i % capacity]: before writing it, the thread sets reserved
+      /// to i + 1, and after, it sets head to i + 1. A reader that copies
+      /// the spans from head - capacity to head and then reads reserved
+      /// knows which ones may have been overwritten meanwhile.
+      struct Buffer
+      {
+        Buffer (std::size_t capacity, std::size_t t) :
+          events (capacity), head (0), reserved (0), thread (t)
+        {
+        }
+
+        std::vector <Event> events;
+        boost::atomic <boost::uint64_t> head;
+        boost::atomic <boost::uint64_t> reserved;
+        /// Index of the thread in the trace
+        std::size_t thread;
+      }; // struct Buffer
+
+      struct Registry
+      {
+        Registry () : capacity (1 << 16), origin (0)
+        {
+        }
+
+        boost::mutex mutex;
+        /// Buffers of all the threads that recorded spans, kept after the
+        /// threads exit
+        std::vector <boost::shared_ptr <Buffer> > buffers;
+        /// Capacity of the buffers created
+        std::size_t capacity;
+        /// Spans started before are discarded
+        boost::atomic <boost::int64_t> origin;
+      }; // struct Registry
+
+      Registry& registry ()
+      {
+        static Registry instance;
+        return instance;
+      }
+
+      /// The buffers are owned by the registry.
+      void keep (Buffer*)
+      {
+      }
+
+      boost::thread_specific_ptr <Buffer> localBuffer (&keep);
+
+      void writeName (std::ostream& os, const char* name)
+      {
+        for (const char* c = name; *c; ++c) {
+          if (*c == '"' || *c == '\\') os << '\\';
+          os << *c;
+        }
+      }
+
+      /// Store an event in the buffer of the calling thread
+      void write (const char* name, boost::int64_t start,
+                  boost::int64_t end, double value)
+      {
+        Buffer* buffer (localBuffer.get ());
+        if (!buffer) {
+          Registry& r (registry ());
+          boost::mutex::scoped_lock lock (r.mutex);
+          r.buffers.push_back (boost::shared_ptr <Buffer>
+                               (new Buffer (r.capacity, r.buffers.size ())));
+          buffer = r.buffers.back ().get ();
+          localBuffer.reset (buffer);
+        }
+        const boost::uint64_t i
+          (buffer->head.load (boost::memory_order_relaxed));
+        buffer->reserved.store (i + 1, boost::memory_order_relaxed);
+        boost::atomic_thread_fence (boost::memory_order_release);
+        Event& event (buffer->events [i % buffer->events.size ()]);
+        event.name = name;
+        event.start = start;
+        event.end = end;
+        event.value = value;
+        buffer->head.store (i + 1, boost::memory_order_release);
+      }
+    } // namespace
+
+    volatile bool Trace::enabled_ (false);
+
+    void Trace::enable (std::size_t capacity)
+    {
+      if (capacity == 0)
+        throw std::invalid_argument ("The number of spans kept by each "
+                                     "thread should be positive.");
+      Registry& r (registry ());
+      {
+        boost::mutex::scoped_lock lock (r.mutex);
+        r.capacity = capacity;
+      }
+      enabled_ = true;
+    }
+
+    void Trace::disable ()
+    {
+      enabled_ = false;
+    }
+
+    void Trace::clear ()
+    {
+      registry ().origin.store (now ());
+    }
+
+    boost::int64_t Trace::now ()
+    {
+      return boost::chrono::duration_cast <boost::chrono::nanoseconds>
+        (boost::chrono::steady_clock::now ().time_since_epoch ()).count ();
+    }
+
+    void Trace::record (const char* name, boost::int64_t start,
+                        boost::int64_t end)
+    {
+      write (name, start, end, 0);
+    }
+
+    void Trace::record (const char* name, boost::int64_t time, double value)
+    {
+      write (name, time, -1, value);
+    }
+
+    void Trace::dump (std::ostream& os)
+    {
+      Registry& r (registry ());
+      std::vector <boost::shared_ptr <Buffer> > buffers;
+      {
+        boost::mutex::scoped_lock lock (r.mutex);
+        buffers = r.buffers;
+      }
+      const boost::int64_t origin (r.origin.load ());
+      const std::ios::fmtflags flags (os.flags ());
+      os.setf (std::ios::fixed, std::ios::floatfield);
+      const std::streamsize precision (os.precision (3));
+      os << "{\"traceEvents\": [";
+      bool first (true);
+      std::vector <Event> events;
+      for (std::size_t b = 0; b < buffers.size (); ++b) {
+        const Buffer& buffer (*buffers [b]);
+        const boost::uint64_t capacity (buffer.events.size ());
+        const boost::uint64_t head
+          (buffer.head.load (boost::memory_order_acquire));
+        boost::uint64_t begin (head > capacity ? head - capacity : 0);
+        events.clear ();
+        for (boost::uint64_t i = begin; i < head; ++i)
+          events.push_back (buffer.events [i % capacity]);
+        boost::atomic_thread_fence (boost::memory_order_acquire);
+        // Spans whose slot is being written by the thread are skipped.
+        const boost::uint64_t reserved
+          (buffer.reserved.load (boost::memory_order_relaxed));
+        const boost::uint64_t valid
+          (reserved > capacity ? reserved - capacity : 0);
+        for (boost::uint64_t i = begin; i < head; ++i) {
+          if (i < valid) continue;
+          const Event& event (events [i - begin]);
+          if (event.start < origin) continue;
+          os << (first ? "\n" : ",\n") << "  {\"name\": \"";
+          writeName (os, event.name);
+          os << "\", \"ph\": \"" << (event.end < 0 ? 'C' : 'X')
+             << "\", \"pid\": 0, \"tid\": " << buffer.thread
+             << ", \"ts\": " << 1e-3 * (double) (event.start - origin);
+          if (event.end < 0)
+            os << ", \"args\": {\"value\": " << event.value << "}}";
+          else
+            os << ", \"dur\": " << 1e-3 * (double) (event.end - event.start)
+               << "}";
+          first = false;
+        }
+      }
+      os << "\n], \"displayTimeUnit\": \"ms\"}" << std::endl;
+      os.precision (precision);
+      os.flags (flags);
+    }
+
+    void Trace::dump (const std::string& filename)
+    {
+      std::ofstream file (filename.c_str ());
+      dump (file);
+      if (!file)
+        HPP_THROW (std::runtime_error, "Cannot write the trace " << filename);
+    }
+  } // namespace core
+} // namespace hpp
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef HPP_CORE_VALIDATION_ORDERING_HH
+# define HPP_CORE_VALIDATION_ORDERING_HH
+
+# include <algorithm>
+# include <limits>
+# include <vector>
+
+# include <boost/chrono/system_clocks.hpp>
+# include <boost/thread/mutex.hpp>
+
+# include <hpp/core/fwd.hh>
+
+namespace hpp {
+  namespace core {
+    /// Order of evaluation of a sequence of validations
+    ///
+    /// The rejection rate and the average duration of each validation are
+    /// measured. Every \ref period recorded evaluations, the validations
+    /// are sorted by decreasing rejection rate per second, so that cheap
+    /// validations that often fail are evaluated first. Rates are smoothed
+    /// by the Laplace rule, and validations never evaluated come first so
+    /// that they get measured.
+    class ValidationOrdering
+    {
+    public:
+      typedef boost::chrono::steady_clock Clock_t;
+      typedef std::vector <std::size_t> Order_t;
+      typedef boost::shared_ptr <const Order_t> OrderPtr_t;
+
+      /// Measure of one validation during an evaluation
+      struct Sample
+      {
+        /// \param i index of the validation,
+        /// \param c number of calls,
+        /// \param r number of rejections among the calls,
+        /// \param t total duration of the calls in seconds.
+        Sample (std::size_t i, size_type c, size_type r, value_type t) :
+          index (i), calls (c), rejections (r), duration (t) {}
+        std::size_t index;
+        size_type calls;
+        size_type rejections;
+        value_type duration;
+      }; // struct Sample
+      typedef std::vector <Sample> Samples_t;
+
+      /// Number of recorded evaluations between two sortings
+      static const size_type period = 100;
+
+      /// \param n number of validations, evaluated in insertion order
+      ///        until the first sorting.
+      explicit ValidationOrdering (std::size_t n) :
+        calls_ (n, 0), rejections_ (n, 0), durations_ (n, 0), evaluations_ (0)
+      {
+        Order_t* order (new Order_t (n));
+        for (std::size_t i = 0; i < n; ++i) (*order) [i] = i;
+        order_.reset (order);
+      }
+
+      /// Current order of evaluation
+      ///
+      /// The returned order is not modified by later sortings.
+      OrderPtr_t order () const
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        return order_;
+      }
+
+      /// Record the measures of an evaluation
+      void record (const Samples_t& samples)
+      {
+        boost::mutex::scoped_lock lock (mutex_);
+        for (std::size_t k = 0; k < samples.size (); ++k) {
+          const Sample& s (samples [k]);
+          calls_ [s.index] += s.calls;
+          rejections_ [s.index] += s.rejections;
+          durations_ [s.index] += s.duration;
+        }
+        if (++evaluations_ % period == 0) sort ();
+      }
+
+      /// Duration in seconds since start
+      static value_type elapsed (const Clock_t::time_point& start)
+      {
+        return boost::chrono::duration <value_type>
+          (Clock_t::now () - start).count ();
+      }
+
+    private:
+      struct Greater
+      {
+        Greater (const std::vector <value_type>& s) : score (s) {}
+        bool operator() (std::size_t a, std::size_t b) const
+        {
+          return score [a] > score [b];
+        }
+        const std::vector <value_type>& score;
+      }; // struct Greater
+
+      void sort ()
+      {
+        const std::size_t n (calls_.size ());
+        std::vector <value_type> score (n);
+        for (std::size_t i = 0; i < n; ++i) {
+          if (calls_ [i] == 0) {
+            score [i] = std::numeric_limits <value_type>::infinity ();
+            continue;
+          }
+          const value_type rate
+            ((value_type) (rejections_ [i] + 1) / (value_type) (calls_ [i] + 2));
+          const value_type duration
+            (std::max (durations_ [i] / (value_type) calls_ [i],
+                       std::numeric_limits <value_type>::min ()));
+          score [i] = rate / duration;
+        }
+        Order_t* order (new Order_t (*order_));
+        std::stable_sort (order->begin (), order->end (), Greater (score));
+        order_.reset (order);
+      }
+
+      std::vector <size_type> calls_;
+      std::vector <size_type> rejections_;
+      /// Sum of the durations in seconds
+      std::vector <value_type> durations_;
+      size_type evaluations_;
+      OrderPtr_t order_;
+      mutable boost::mutex mutex_;
+    }; // class ValidationOrdering
+  } // namespace core
+} // namespace hpp
+
+#endif // HPP_CORE_VALIDATION_ORDERING_HH
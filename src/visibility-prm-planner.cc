@@ -22,6 +22,7 @@
 #include <hpp/core/config-projector.hh>
 #include <hpp/core/config-validations.hh>
 #include <hpp/core/connected-component.hh>
+#include <hpp/core/executor.hh>
 #include <hpp/core/path-validation.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/roadmap.hh>
@@ -31,6 +32,8 @@
 #include <stdio.h>
 #include <time.h>
 
+#include <boost/bind.hpp>
+
 namespace hpp {
   namespace core {
     using pinocchio::displayConfig;
@@ -50,13 +53,13 @@ namespace hpp {
     }
 
     VisibilityPrmPlanner::VisibilityPrmPlanner (const Problem& problem):
-      PathPlanner (problem)
+      PathPlanner (problem), numberThreads_ (1)
     {
     }
 
     VisibilityPrmPlanner::VisibilityPrmPlanner (const Problem& problem,
 						const RoadmapPtr_t& roadmap) :
-      PathPlanner (problem, roadmap)
+      PathPlanner (problem, roadmap), numberThreads_ (1)
     {
     }
 
@@ -66,42 +69,56 @@ namespace hpp {
       weakPtr_ = weak;
     }
 
-    bool VisibilityPrmPlanner::visibleFromCC (const Configuration_t q, 
-					      const ConnectedComponentPtr_t cc){
-      PathPtr_t validPart;
-      bool found = false; 
-      value_type length = std::numeric_limits <value_type>::infinity ();
-      PathValidationPtr_t pathValidation (problem ().pathValidation ());
-      SteeringMethodPtr_t sm (problem ().steeringMethod ());
-      RoadmapPtr_t r (roadmap ());
-      DelayedEdge_t delayedEdge;
+    void VisibilityPrmPlanner::startSolve ()
+    {
+      PathPlanner::startSolve ();
+      tools_.clear ();
+      if (numberThreads_ > 1) {
+        for (size_type i = 0; i < numberThreads_; ++i)
+          tools_.push_back (factory_ ());
+      }
+    }
 
-      for (NodeVector_t::const_iterator n_it = cc->nodes ().begin (); 
-	   n_it != cc->nodes ().end (); ++n_it){
-	if(nodeStatus_ [*n_it]){// only iterate on guard nodes
+    void VisibilityPrmPlanner::parallelVisibility
+    (size_type numberThreads, const ConnectionToolsFactory_t& factory)
+    {
+      if (numberThreads < 1 || (numberThreads > 1 && !factory))
+        throw std::invalid_argument ("Parallel visibility tests require a "
+                                     "positive number of threads and a "
+                                     "factory.");
+      numberThreads_ = numberThreads;
+      factory_ = factory;
+    }
+
+    void VisibilityPrmPlanner::visibleFromCCs (const ConnectionTools& tools,
+                                               const Configuration_t& q,
+                                               Visibilities_t& visibilities,
+                                               std::size_t begin,
+                                               std::size_t step)
+    {
+      PathPtr_t validPart;
+      for (std::size_t i = begin; i < visibilities.size (); i += step) {
+        Visibility& visibility (visibilities [i]);
+        value_type length = std::numeric_limits <value_type>::infinity ();
+        for (NodeVector_t::const_iterator n_it = visibility.guards.begin ();
+             n_it != visibility.guards.end (); ++n_it){
 	  ConfigurationPtr_t qCC = (*n_it)->configuration ();
-	  PathPtr_t path = (*sm) (q, *qCC);
+	  PathPtr_t path = (*tools.steeringMethod) (q, *qCC);
 	  PathValidationReportPtr_t report;
-	  if (path && pathValidation->validate (path, false, validPart,
-						report)){
+	  if (path && tools.pathValidation->validate (path, false, validPart,
+                                                      report)){
 	    // q and qCC see each other
 	    if (path->length () < length) {
 	      length = path->length ();
 	      // Save shortest edge
-	      delayedEdge = DelayedEdge_t (*n_it,
+	      visibility.edge = DelayedEdge_t (*n_it,
                   boost::make_shared<Configuration_t>(q),
-                  path->reverse ());
+                  path->reversedView ());
 	    }
-	    found = true;
+	    visibility.visible = true;
 	  }
-	}
-      }
-      if (found) {
-	// Store shortest delayed edge in list
-	delayedEdges_.push_back (delayedEdge);
-	return true;
+        }
       }
-      else return false;
     }
 
     void VisibilityPrmPlanner::applyConstraints (const Configuration_t& qFrom,
@@ -122,17 +139,44 @@ namespace hpp {
       qout = qTo;
     }
 
+    void VisibilityPrmPlanner::shootValidConfigurations
+    (const Configuration_t& qFrom)
+    {
+      const size_type blockSize = 16;
+      ConfigurationShooterPtr_t configurationShooter
+        (problem().configurationShooter());
+      ConfigValidationsPtr_t configValidations (problem ().configValidations());
+      PlannerStatistics& stats (mutableStatistics ());
+      Configuration_t q_rand, q_proj (qFrom.size ());
+      matrix_t block (qFrom.size (), blockSize);
+      size_type n = 0;
+      for (size_type i = 0; i < blockSize; ++i) {
+	configurationShooter->shoot (q_rand);
+        constrApply_ = true; // stay true if no constraint in Problem
+	applyConstraints(qFrom, q_rand, q_proj);
+        if (constrApply_) block.col (n++) = q_proj;
+        else stats.reject (PlannerStatistics::PROJECTION_FAILURE);
+      }
+      stats.sampled (blockSize);
+      if (n == 0) return;
+      const matrix_t samples (block.leftCols (n));
+      std::vector <bool> valid;
+      std::vector <ValidationReportPtr_t> reports;
+      configValidations->validateConfigurations (samples, valid, reports);
+      for (size_type i = 0; i < n; ++i) {
+        if (valid [i]) validSamples_.push_back (samples.col (i));
+        else stats.reject (reports [i]);
+      }
+    }
+
     void VisibilityPrmPlanner::oneStep ()
     {
       DevicePtr_t robot (problem ().robot ());
-      ConfigurationShooterPtr_t configurationShooter (problem().configurationShooter());
-      ConfigValidationsPtr_t configValidations (problem ().configValidations());
       RoadmapPtr_t r (roadmap ());
       value_type count; // number of times q has been seen
       constrApply_ = true; // stay true if no constraint in Problem
       Configuration_t q_init (*(r->initNode ()->configuration ())),
-                      q_proj (robot->configSize()),
-                      q_rand (robot->configSize());
+                      q_proj (robot->configSize());
 
       /* Initialization of guard status */
       nodeStatus_ [r->initNode ()] = true; // init node is guard
@@ -142,24 +186,58 @@ namespace hpp {
       }
 
       // Shoot random config as long as not collision-free
-      ValidationReportPtr_t report;
-      do {
-	configurationShooter->shoot (q_rand);
-	applyConstraints(q_init, q_rand, q_proj);
-	robot->currentConfiguration (q_proj);
-	robot->computeForwardKinematics ();
-      } while (!configValidations->validate (q_proj, report) ||
-	       !constrApply_);
+      while (validSamples_.empty ())
+        shootValidConfigurations (q_init);
+      q_proj = validSamples_.front ();
+      validSamples_.pop_front ();
+      robot->currentConfiguration (q_proj);
+      robot->computeForwardKinematics ();
       count = 0;
 
+      // Gather the guard nodes of each connected component. Visibility
+      // tests do not modify the roadmap and may run in parallel.
+      Visibilities_t visibilities (r->connectedComponents ().size ());
+      std::size_t i = 0;
       for (ConnectedComponents_t::const_iterator itcc =
 	     r->connectedComponents ().begin ();
-	   itcc != r->connectedComponents ().end (); ++itcc) {
-	ConnectedComponentPtr_t cc = *itcc;
-	if (visibleFromCC (q_proj, cc)) { 
-	  // delayedEdges_ will completed if visible
+	   itcc != r->connectedComponents ().end (); ++itcc, ++i) {
+        const NodeVector_t& nodes ((*itcc)->nodes ());
+        for (NodeVector_t::const_iterator n_it = nodes.begin ();
+             n_it != nodes.end (); ++n_it) {
+          std::map <NodePtr_t, bool>::const_iterator status
+            (nodeStatus_.find (*n_it));
+          // only test guard nodes
+          if (status != nodeStatus_.end () && status->second)
+            visibilities [i].guards.push_back (*n_it);
+        }
+      }
+      const std::size_t nThreads
+        (std::min (tools_.size (), visibilities.size ()));
+      if (nThreads <= 1) {
+        ConnectionTools tools;
+        if (tools_.empty ()) {
+          tools.steeringMethod = problem ().steeringMethod ();
+          tools.pathValidation = problem ().pathValidation ();
+        } else {
+          tools = tools_ [0];
+        }
+        visibleFromCCs (tools, q_proj, visibilities, 0, 1);
+      } else {
+        Executor::Tasks_t tasks;
+        for (std::size_t t = 0; t < nThreads; ++t) {
+          tasks.push_back
+            (boost::bind (&VisibilityPrmPlanner::visibleFromCCs,
+                          boost::cref (tools_ [t]), boost::cref (q_proj),
+                          boost::ref (visibilities), t, nThreads));
+        }
+        Executor::run (executor (), tasks);
+      }
+      for (i = 0; i < visibilities.size (); ++i) {
+        if (visibilities [i].visible) {
+	  // Store shortest delayed edge in list
+          delayedEdges_.push_back (visibilities [i].edge);
 	  count++; // count how many times q has been seen
-	}
+        }
       }
 	
       if (count == 0){ // q not visible from anywhere
@@ -177,7 +255,7 @@ namespace hpp {
 	  NodePtr_t newNode = r->addNode (q_new);
 	  nodeStatus_ [newNode] = false;
 	  r->addEdge (near, newNode, validPath);
-	  r->addEdge (newNode, near, validPath->reverse());
+	  r->addEdge (newNode, near, validPath->reversedView());
 	  hppDout(info, "connection between q1: " 
 		  << displayConfig (*(near->configuration ())) 
 		  << "and q2: " << displayConfig (*q_new));
@@ -18,8 +18,18 @@
 
 #include <hpp/core/weighed-distance.hh>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <Eigen/Geometry>
 #include <Eigen/SVD>
 
 #include <pinocchio/algorithm/joint-configuration.hpp>
@@ -33,6 +43,7 @@
 #include <hpp/pinocchio/joint-collection.hh>
 #include <hpp/pinocchio/liegroup.hh>
 
+#include <hpp/core/configuration-shooter.hh>
 #include <hpp/core/problem.hh>
 
 namespace hpp {
@@ -146,6 +157,39 @@ namespace hpp {
       };
     }
 
+    namespace {
+      /// Hash of the data the weights at the current configuration depend on
+      std::size_t weightsKey (const DevicePtr_t& robot)
+      {
+        const pinocchio::Model& model (robot->model ());
+        std::size_t seed (0);
+        boost::hash_combine (seed, model.nq);
+        boost::hash_combine (seed, model.nv);
+        for (pinocchio::JointIndex i = 1; i < model.joints.size (); ++i) {
+          boost::hash_combine (seed, model.joints [i].shortname ());
+          boost::hash_combine (seed, model.parents [i]);
+          const ::pinocchio::SE3& M (model.jointPlacements [i]);
+          for (int k = 0; k < 3; ++k) {
+            boost::hash_combine (seed, M.translation () [k]);
+            for (int l = 0; l < 3; ++l)
+              boost::hash_combine (seed, M.rotation () (k, l));
+          }
+        }
+        const std::vector <value_type>& radius (robot->geomData ().radius);
+        boost::hash_range (seed, radius.begin (), radius.end ());
+        const Configuration_t& q (robot->currentConfiguration ());
+        boost::hash_range (seed, q.data (), q.data () + q.size ());
+        return seed;
+      }
+
+      std::string weightsFile (const std::string& directory, std::size_t key)
+      {
+        std::ostringstream oss;
+        oss << directory << "/weighed-distance-" << std::hex << key << ".bin";
+        return oss.str ();
+      }
+    } // namespace
+
     WeighedDistancePtr_t WeighedDistance::create (const DevicePtr_t& robot)
     {
       WeighedDistance* ptr = new WeighedDistance (robot);
@@ -163,6 +207,17 @@ namespace hpp {
       return shPtr;
     }
 
+    WeighedDistancePtr_t WeighedDistance::createFromSamples
+    (const Problem& problem)
+    {
+      WeighedDistance* ptr = new WeighedDistance (problem,
+          problem.getParameter ("WeighedDistance/numberOfSamples").intValue(),
+          problem.getParameter ("WeighedDistance/percentile").floatValue());
+      WeighedDistancePtr_t shPtr (ptr);
+      ptr->init (shPtr);
+      return shPtr;
+    }
+
     WeighedDistancePtr_t
     WeighedDistance::createWithWeight (const DevicePtr_t& robot,
 			     const vector_t& weights)
@@ -197,6 +252,7 @@ namespace hpp {
       if ( ws.size() == weights_.size() )
       {
 	weights_ = ws;
+        computeDistancePlan ();
       }
       else {
 	std::ostringstream oss;
@@ -216,6 +272,7 @@ namespace hpp {
       if ( rank < weights_.size() )
       {
 	weights_[rank] = weight;
+        computeDistancePlan ();
       }
       else {
 	std::ostringstream oss;
@@ -234,6 +291,53 @@ namespace hpp {
         weights_.resize (0);
         return;
       }
+      jacobianWeights (weights_);
+      hppDout(info, "The weights are " << weights_);
+    }
+
+    void WeighedDistance::computeWeights
+    (const ConfigurationShooterPtr_t& shooter, size_type numberSamples,
+     value_type percentile)
+    {
+      if (numberSamples < 1)
+        throw std::invalid_argument ("WeighedDistance: the number of samples "
+            "should be positive.");
+      if (!(percentile >= 0 && percentile <= 1))
+        throw std::invalid_argument ("WeighedDistance: the percentile should "
+            "be in [0, 1].");
+      if (robot_->configSize() == 0) {
+        weights_.resize (0);
+        return;
+      }
+      const Configuration_t q0 (robot_->currentConfiguration ());
+      Configuration_t q (robot_->configSize ());
+      vector_t weights;
+      matrix_t samples (robot_->model().joints.size()-1, numberSamples);
+      for (size_type k = 0; k < numberSamples; ++k) {
+        shooter->shoot (q);
+        robot_->currentConfiguration (q);
+        jacobianWeights (weights);
+        samples.col (k) = weights;
+      }
+      robot_->currentConfiguration (q0);
+      robot_->computeForwardKinematics ();
+
+      const std::size_t rank ((std::size_t)
+          (percentile * value_type (numberSamples - 1) + .5));
+      std::vector <value_type> values ((std::size_t) numberSamples);
+      weights_.resize (samples.rows ());
+      for (size_type i = 0; i < samples.rows (); ++i) {
+        for (size_type k = 0; k < numberSamples; ++k)
+          values [(std::size_t) k] = samples (i, k);
+        std::nth_element (values.begin (), values.begin () + rank,
+                          values.end ());
+        weights_ [i] = values [rank];
+      }
+      hppDout(info, "The weights are " << weights_);
+    }
+
+    void WeighedDistance::jacobianWeights (vector_t& weights) const
+    {
       // Store computation flag
       pinocchio::Computation_t flag = robot_->computationFlag ();
       pinocchio::Computation_t newflag = static_cast <pinocchio::Computation_t>
@@ -246,7 +350,7 @@ namespace hpp {
       const pinocchio::Model& model = robot_->model();
       const pinocchio::Data& data = robot_->data();
       const pinocchio::GeomData& geomData = robot_->geomData();
-      weights_.resize (model.joints.size()-1);
+      weights.resize (model.joints.size()-1);
       // TODO when there is only one freeflyer, and the body radius is 0,
       // the weights should be [0,].
       // The algorithm below returns [inf,]
@@ -256,37 +360,142 @@ namespace hpp {
           ComputeWeightStep::run(model.joints[i],
               ComputeWeightStep::ArgsType(model, data, geomData, length));
 	  if (minLength > length && length > 0) minLength = length;
-	  weights_[i-1] = length;
+	  weights[i-1] = length;
 	for (std::size_t k=0; k < i; ++k) {
-	  if (weights_ [k] == 0) {
-	    weights_ [k] = minLength;
+	  if (weights [k] == 0) {
+	    weights [k] = minLength;
 	  }
 	}
       }
-      hppDout(info, "The weights are " << weights_);
+    }
+
+    void WeighedDistance::computeDistancePlan ()
+    {
+      const pinocchio::Model& model = robot_->model();
+      euclideanWeights_ = vector_t::Zero (robot_->configSize ());
+      rotations_.clear ();
+      otherJoints_.clear ();
+      for (pinocchio::JointIndex i = 1; i < model.joints.size(); ++i)
+      {
+        if (i > (pinocchio::JointIndex) weights_.size ()) break;
+        const ::pinocchio::JointModel& jmodel (model.joints[i]);
+        const std::string name (jmodel.shortname ());
+        const value_type w2 (weights_ [i-1] * weights_ [i-1]);
+        // Number of translation coordinates before the rotation, if the
+        // joint is a rotation or a translation followed by a rotation.
+        size_type nt = -1;
+        Rotation rotation;
+        if (name.compare (0, 13, "JointModelRUB") == 0 ||
+            name == "JointModelRevoluteUnboundedUnaligned") {
+          nt = 0; rotation.type = Rotation::SO2;
+        } else if (name == "JointModelPlanar") {
+          nt = 2; rotation.type = Rotation::SO2;
+        } else if (name == "JointModelSpherical") {
+          nt = 0; rotation.type = Rotation::SO3;
+        } else if (name == "JointModelFreeFlyer") {
+          nt = 3; rotation.type = Rotation::SO3;
+        }
+        if (jmodel.nq () == jmodel.nv () && name != "JointModelComposite") {
+          euclideanWeights_.segment (jmodel.idx_q (), jmodel.nq ()).
+            setConstant (w2);
+        } else if (nt >= 0) {
+          euclideanWeights_.segment (jmodel.idx_q (), nt).setConstant (w2);
+          rotation.idx_q = jmodel.idx_q () + nt;
+          rotation.squaredWeight = w2;
+          rotations_.push_back (rotation);
+        } else {
+          otherJoints_.push_back ((size_type) i);
+        }
+      }
+      euclideanWeights_.tail (robot_->extraConfigSpace ().dimension()).
+        setOnes ();
     }
 
     WeighedDistance::WeighedDistance (const DevicePtr_t& robot) :
       robot_ (robot), weights_ ()
     {
       computeWeights ();
+      computeDistancePlan ();
     }
 
     WeighedDistance::WeighedDistance (const Problem& problem) :
       robot_ (problem.robot()), weights_ ()
     {
-      computeWeights ();
+      const std::string directory (problem.getParameter
+          ("WeighedDistance/cacheDirectory").stringValue ());
+      if (directory.empty ()) {
+        computeWeights ();
+      } else {
+        const std::string filename (weightsFile (directory,
+                                                 weightsKey (robot_)));
+        if (!loadWeights (filename)) {
+          computeWeights ();
+          saveWeights (filename);
+        }
+      }
+      computeDistancePlan ();
+    }
+
+    bool WeighedDistance::loadWeights (const std::string& filename)
+    {
+      std::ifstream is (filename.c_str (), std::ios::binary);
+      boost::int64_t n;
+      if (!is.read ((char*) &n, sizeof (n)) ||
+          n != (boost::int64_t) robot_->model ().joints.size () - 1)
+        return false;
+      vector_t weights ((size_type) n);
+      if (!is.read ((char*) weights.data (), sizeof (value_type) * n))
+        return false;
+      weights_ = weights;
+      hppDout (info, "The weights are read from " << filename);
+      return true;
+    }
+
+    void WeighedDistance::saveWeights (const std::string& filename) const
+    {
+      // Write in another file first, so that concurrent readers never read
+      // a partial file.
+      std::ostringstream tmp;
+      tmp << filename << "." << this;
+      {
+        std::ofstream os (tmp.str ().c_str (),
+                          std::ios::binary | std::ios::trunc);
+        const boost::int64_t n (weights_.size ());
+        os.write ((const char*) &n, sizeof (n));
+        os.write ((const char*) weights_.data (), sizeof (value_type) * n);
+        if (!os) {
+          hppDout (warning, "Failed to write the weights in " << filename);
+          std::remove (tmp.str ().c_str ());
+          return;
+        }
+      }
+      if (std::rename (tmp.str ().c_str (), filename.c_str ()) != 0)
+        std::remove (tmp.str ().c_str ());
     }
 
     WeighedDistance::WeighedDistance (const DevicePtr_t& robot,
 				      const vector_t& weights) :
       robot_ (robot), weights_ (weights)
     {
+      computeDistancePlan ();
+    }
+
+    WeighedDistance::WeighedDistance (const Problem& problem,
+                                      size_type numberSamples,
+                                      value_type percentile) :
+      robot_ (problem.robot()), weights_ ()
+    {
+      computeWeights (problem.configurationShooter (), numberSamples,
+                      percentile);
+      computeDistancePlan ();
     }
 
     WeighedDistance::WeighedDistance (const WeighedDistance& distance) :
       robot_ (distance.robot_),
-      weights_ (distance.weights_)
+      weights_ (distance.weights_),
+      euclideanWeights_ (distance.euclideanWeights_),
+      rotations_ (distance.rotations_),
+      otherJoints_ (distance.otherJoints_)
     {
     }
 
@@ -295,24 +504,96 @@ namespace hpp {
       weak_ = self;
     }
 
-    value_type WeighedDistance::impl_distance (ConfigurationIn_t q1,
-					       ConfigurationIn_t q2) const
+    value_type WeighedDistance::otherJointsSquaredDistance
+    (ConfigurationIn_t q1, ConfigurationIn_t q2) const
     {
       value_type res = 0, d = std::numeric_limits <value_type>::infinity ();
 
+      for (std::size_t k = 0; k < rotations_.size (); ++k)
+      {
+        const Rotation& r (rotations_ [k]);
+        switch (r.type) {
+          case Rotation::SO2:
+            {
+              // Angle between (cos, sin) pairs
+              const value_type c1 (q1 [r.idx_q]), s1 (q1 [r.idx_q + 1]),
+                               c2 (q2 [r.idx_q]), s2 (q2 [r.idx_q + 1]);
+              d = atan2 (c1 * s2 - s1 * c2, c1 * c2 + s1 * s2);
+            }
+            break;
+          case Rotation::SO3:
+            {
+              // Coefficients are stored in order (x, y, z, w).
+              const Eigen::Quaternion<value_type>
+                quat1 (q1.segment<4> (r.idx_q)),
+                quat2 (q2.segment<4> (r.idx_q));
+              d = quat1.angularDistance (quat2);
+            }
+            break;
+        }
+        res += r.squaredWeight * d * d;
+      }
+
       const pinocchio::Model& model = robot_->model();
-      assert ((size_type)model.joints.size() <= weights_.size () + 1);
-      // Configuration_t qq1 (q1), qq2 (q2);
-      // Loop over robot joint
-      for( pinocchio::JointIndex i=1; i<(pinocchio::JointIndex) model.njoints; ++i )
+      // Loop over joints that are not vector spaces
+      for (std::size_t k = 0; k < otherJoints_.size (); ++k)
       {
+        const size_type i (otherJoints_ [k]);
         value_type length = weights_ [i-1] * weights_ [i-1];
         SquaredDistanceStep::ArgsType args(q1, q2, length, d);
         SquaredDistanceStep::run(model.joints[i], args);
         res += d;
       }
-      res+=(q1 - q2).tail (robot_->extraConfigSpace ().dimension()).squaredNorm ();
+      return res;
+    }
+
+    value_type WeighedDistance::impl_distance (ConfigurationIn_t q1,
+					       ConfigurationIn_t q2) const
+    {
+      assert ((size_type)robot_->model().joints.size() <= weights_.size () + 1);
+      value_type res = (euclideanWeights_.array () *
+                        (q1 - q2).array ().square ()).sum ();
+      res += otherJointsSquaredDistance (q1, q2);
       return sqrt (res);
     }
+
+    void WeighedDistance::impl_distances (matrixIn_t configurations,
+                                          ConfigurationIn_t q,
+                                          vector_t& distances) const
+    {
+      assert ((size_type)robot_->model().joints.size() <= weights_.size () + 1);
+      assert (configurations.rows () == q.size ());
+      // Vector space coordinates of all configurations at once
+      distances.noalias () = (configurations.colwise () - q).array ().square ().
+        matrix ().transpose () * euclideanWeights_;
+      if (!rotations_.empty () || !otherJoints_.empty ()) {
+        for (size_type i = 0; i < configurations.cols (); ++i)
+          distances [i] += otherJointsSquaredDistance (configurations.col (i),
+                                                       q);
+      }
+      distances = distances.cwiseSqrt ();
+    }
+
+    // ----------- Declare parameters ------------------------------------- //
+
+    HPP_START_PARAMETER_DECLARATION(WeighedDistance)
+    Problem::declareParameter(ParameterDescription (Parameter::INT,
+          "WeighedDistance/numberOfSamples",
+          "Number of configurations sampled to compute the weights, "
+          "see WeighedDistance::createFromSamples.",
+          Parameter((size_type)100)));
+    Problem::declareParameter(ParameterDescription (Parameter::FLOAT,
+          "WeighedDistance/percentile",
+          "Percentile of the weights at the samples, in [0, 1], "
+          "see WeighedDistance::createFromSamples.",
+          Parameter(1.)));
+    Problem::declareParameter(ParameterDescription (Parameter::STRING,
+          "WeighedDistance/cacheDirectory",
+          "Directory where the weights computed at the current configuration "
+          "are stored, in a file named after a hash of the kinematic chain, "
+          "of the radius of the bodies and of the configuration. Weights "
+          "are read from the file when it exists. Empty to disable.",
+          Parameter(std::string())));
+    HPP_END_PARAMETER_DECLARATION(WeighedDistance)
   } //   namespace core
 } // namespace hpp
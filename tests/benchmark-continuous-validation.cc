@@ -0,0 +1,472 @@
+// Copyright (c) 2014, LAAS-CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+// Benchmark of the continuous path validations.
+//
+// Sets of paths are built once from random configurations, with a given
+// seed, and each set is validated by Progressive and Dichotomy. The sets
+// are
+// \li straight paths, interpolated paths through a random waypoint and
+//     cubic Bernstein splines of a free flying humanoid robot,
+// \li Reeds and Shepp paths of a car-like robot,
+// among the robot bodies and a box obstacle.
+//
+// One record is printed per set and validation, as JSON, with the number
+// of valid paths, the mean time of the validation of the valid paths, the
+// mean time to reject the invalid paths, the mean number of calls to the
+// interval validations and of distance queries per path, and the mean
+// length of the collision free intervals relative to the length of the
+// path. Calls answered by intervals validated before are not distance
+// queries. One record is then printed for each of the most expensive body
+// pairs with the same statistics and the time spent in the pair.
+//
+// Usage: benchmark-continuous-validation [--paths N] [--seed N]
+//          [--pairs N]
+//
+// --pairs sets the number of body pairs printed per set and validation.
+// Compare the output of two builds to catch performance regressions.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/chrono/system_clocks.hpp>
+
+#include <hpp/fcl/collision_object.h>
+#include <hpp/fcl/shape/geometric_shapes.h>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/simple-device.hh>
+
+#include <hpp/core/configuration-shooter.hh>
+#include <hpp/core/continuous-validation/dichotomy.hh>
+#include <hpp/core/continuous-validation/interval-validation.hh>
+#include <hpp/core/continuous-validation/progressive.hh>
+#include <hpp/core/distance.hh>
+#include <hpp/core/interpolated-path.hh>
+#include <hpp/core/path-validation-report.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/problem-solver.hh>
+#include <hpp/core/steering-method.hh>
+#include <hpp/core/steering-method/spline.hh>
+
+using namespace hpp::core;
+using namespace hpp::pinocchio;
+using hpp::core::continuousValidation::IntervalValidation;
+using hpp::core::continuousValidation::IntervalValidationPtr_t;
+
+typedef boost::chrono::steady_clock Clock_t;
+
+struct Options
+{
+  size_type paths, seed, pairs;
+
+  Options () : paths (100), seed (0), pairs (5)
+  {}
+};
+
+/// Cost of the calls to an interval validation, or to all of them
+struct Statistics
+{
+  std::string name;
+  size_type calls, queries;
+  /// Time spent in the calls (in seconds)
+  value_type time;
+  /// Sum of the lengths of the intervals returned, relative to the length
+  /// of the path
+  value_type intervals;
+
+  Statistics () : calls (0), queries (0), time (0), intervals (0)
+  {}
+
+  void add (const Statistics& other)
+  {
+    calls += other.calls;
+    queries += other.queries;
+    time += other.time;
+    intervals += other.intervals;
+  }
+
+  bool operator< (const Statistics& other) const
+  {
+    return time > other.time;
+  }
+};
+
+/// Interval validation that measures the calls to another one
+///
+/// Copies share the statistics.
+class Measured : public IntervalValidation
+{
+public:
+  Measured (const IntervalValidationPtr_t& validation,
+            Statistics* statistics) :
+    IntervalValidation (validation->tolerance ()), validation_ (validation),
+    statistics_ (statistics)
+  {}
+
+  bool validateConfiguration (const value_type& t, interval_t& interval,
+                              ValidationReportPtr_t& report,
+                              const DeviceData& data)
+  {
+    interval_t known (interval);
+    const bool query (!validation_->validated (t, known));
+    const Clock_t::time_point start (Clock_t::now ());
+    const bool valid (validation_->validateConfiguration (t, interval, report,
+                                                          data));
+    statistics_->time += boost::chrono::duration <value_type>
+      (Clock_t::now () - start).count ();
+    ++statistics_->calls;
+    if (query) ++statistics_->queries;
+    if (!valid) return false;
+    // Same bookkeeping as the measured validation
+    const interval_t& tr (path_->timeRange ());
+    if (tr.second > tr.first) {
+      statistics_->intervals +=
+        std::max (value_type (0), std::min (interval.second, tr.second) -
+                  std::max (interval.first, tr.first)) /
+        (tr.second - tr.first);
+    }
+    validInterval_.unionInterval (interval);
+    if (validInterval_.contains (tr)) valid_ = true;
+    return true;
+  }
+
+  std::string name () const
+  {
+    return validation_->name ();
+  }
+
+  std::ostream& print (std::ostream& os) const
+  {
+    return validation_->print (os);
+  }
+
+  IntervalValidationPtr_t copy () const
+  {
+    return IntervalValidationPtr_t (new Measured (validation_->copy (),
+                                                  statistics_));
+  }
+
+private:
+  virtual void setupPath ()
+  {
+    validation_->path (path_, reverse_);
+  }
+
+  IntervalValidationPtr_t validation_;
+  Statistics* statistics_;
+}; // class Measured
+
+/// Continuous validation whose interval validations are measured
+template <typename Validation>
+class MeasuredValidation : public Validation
+{
+public:
+  typedef boost::shared_ptr <MeasuredValidation> Ptr_t;
+
+  static Ptr_t create (const DevicePtr_t& robot, value_type tolerance)
+  {
+    MeasuredValidation* ptr (new MeasuredValidation (robot, tolerance));
+    Ptr_t shPtr (ptr);
+    ptr->init (shPtr);
+    ptr->initialize ();
+    return shPtr;
+  }
+
+  /// Measure the interval validations, once the obstacles are added
+  /// \retval statistics the statistics of each body pair, keyed by name.
+  void measure (std::map <std::string, Statistics>& statistics)
+  {
+    for (std::size_t i = 0; i < this->intervalValidations_.size (); ++i) {
+      const IntervalValidationPtr_t validation
+        (this->intervalValidations_ [i]);
+      Statistics& s (statistics [validation->name ()]);
+      s.name = validation->name ();
+      this->intervalValidations_ [i] = IntervalValidationPtr_t
+        (new Measured (validation, &s));
+    }
+    this->bodyPairCollisionPool_.clear ();
+  }
+
+protected:
+  MeasuredValidation (const DevicePtr_t& robot, value_type tolerance) :
+    Validation (robot, tolerance)
+  {}
+}; // class MeasuredValidation
+
+/// Robot, obstacles and paths validated
+struct Scene
+{
+  std::string name;
+  ProblemSolverPtr_t solver;
+  std::vector <PathPtr_t> paths;
+};
+
+void addBox (const ProblemSolverPtr_t& ps, const vector3_t& center)
+{
+  FclCollisionObject box
+    (hpp::fcl::CollisionGeometryPtr_t (new hpp::fcl::Box (.3, .3, .3)),
+     matrix3_t::Identity (), center);
+  ps->addObstacle ("box", box, true, true);
+}
+
+/// Create a scene without paths
+/// \param dimension number of coordinates of the root joint bounded in
+///        [-1, 1].
+Scene createScene (const std::string& name, const DevicePtr_t& robot,
+                   size_type dimension, const std::string& steeringMethod)
+{
+  Scene scene;
+  scene.name = name;
+  scene.solver = ProblemSolver::create ();
+  const ProblemSolverPtr_t& ps (scene.solver);
+  for (size_type i = 0; i < dimension; ++i) {
+    robot->rootJoint ()->lowerBound (i, -1);
+    robot->rootJoint ()->upperBound (i,  1);
+  }
+  ps->robot (robot);
+  ps->steeringMethodType (steeringMethod);
+  addBox (ps, vector3_t (.5, 0, 0));
+  return scene;
+}
+
+/// Random pairs of configurations of a scene
+void shootPairs (const Scene& scene, const Options& options,
+                 std::vector <Configuration_t>& configurations)
+{
+  ProblemPtr_t problem (scene.solver->problem ());
+  problem->seed (options.seed);
+  ConfigurationShooterPtr_t shooter (problem->configurationShooter ());
+  configurations.clear ();
+  for (size_type i = 0; i < 2 * options.paths; ++i)
+    configurations.push_back (*shooter->shoot ());
+}
+
+/// Paths of the steering method of the scene
+void steerPaths (Scene& scene, const Options& options)
+{
+  std::vector <Configuration_t> q;
+  shootPairs (scene, options, q);
+  SteeringMethodPtr_t sm (scene.solver->problem ()->steeringMethod ());
+  for (std::size_t i = 0; i + 1 < q.size (); i += 2) {
+    PathPtr_t path ((*sm) (q [i], q [i + 1]));
+    if (path) scene.paths.push_back (path);
+  }
+}
+
+/// Paths interpolated through a random waypoint
+void interpolatePaths (Scene& scene, const Options& options)
+{
+  std::vector <Configuration_t> q;
+  shootPairs (scene, options, q);
+  ProblemPtr_t problem (scene.solver->problem ());
+  const DistancePtr_t& distance (problem->distance ());
+  ConfigurationShooterPtr_t shooter (problem->configurationShooter ());
+  for (std::size_t i = 0; i + 1 < q.size (); i += 2) {
+    Configuration_t waypoint (*shooter->shoot ());
+    const value_type d1 ((*distance) (q [i], waypoint)),
+      d2 ((*distance) (waypoint, q [i + 1]));
+    if (d1 + d2 <= 0) continue;
+    InterpolatedPathPtr_t path (InterpolatedPath::create
+                                (problem->robot (), q [i], q [i + 1],
+                                 d1 + d2));
+    path->insert (d1, waypoint);
+    scene.paths.push_back (path);
+  }
+}
+
+/// Cubic Bernstein splines with null velocities at both ends
+void splinePaths (Scene& scene, const Options& options)
+{
+  typedef steeringMethod::Spline <path::BernsteinBasis, 3> Spline_t;
+  std::vector <Configuration_t> q;
+  shootPairs (scene, options, q);
+  ProblemPtr_t problem (scene.solver->problem ());
+  Spline_t::Ptr_t sm (Spline_t::create (*problem));
+  std::vector <int> orders (1, 1);
+  const vector_t v (vector_t::Zero (problem->robot ()->numberDof ()));
+  for (std::size_t i = 0; i + 1 < q.size (); i += 2) {
+    PathPtr_t path (sm->steer (q [i], orders, v, q [i + 1], orders, v));
+    if (path) scene.paths.push_back (path);
+  }
+}
+
+/// Results of the validation of the paths of a scene
+struct Record
+{
+  std::string scene, validation;
+  size_type paths, valid;
+  value_type validTime, rejectionTime;
+  Statistics total;
+  std::vector <Statistics> pairs;
+
+  Record (const std::string& s, const std::string& v) :
+    scene (s), validation (v), paths (0), valid (0), validTime (0),
+    rejectionTime (0)
+  {}
+};
+
+void print (const Statistics& s, size_type paths, std::ostream& os)
+{
+  const value_type n (paths > 0 ? (value_type) paths : 1);
+  os << "\"mean_calls\": " << (value_type) s.calls / n
+     << ", \"mean_queries\": " << (value_type) s.queries / n
+     << ", \"mean_interval_ratio\": "
+     << (s.calls > 0 ? s.intervals / (value_type) s.calls : 0);
+}
+
+void print (const Record& r, std::size_t pairs, bool first)
+{
+  if (!first) std::cout << "," << std::endl;
+  const size_type invalid (r.paths - r.valid);
+  std::cout << "  {\"scene\": \"" << r.scene
+            << "\", \"validation\": \"" << r.validation
+            << "\", \"paths\": " << r.paths
+            << ", \"valid\": " << r.valid
+            << ", \"mean_valid_time\": "
+            << (r.valid > 0 ? r.validTime / (value_type) r.valid : 0)
+            << ", \"mean_rejection_time\": "
+            << (invalid > 0 ? r.rejectionTime / (value_type) invalid : 0)
+            << ", ";
+  print (r.total, r.paths, std::cout);
+  std::cout << "}";
+  for (std::size_t i = 0; i < std::min (pairs, r.pairs.size ()); ++i) {
+    const Statistics& s (r.pairs [i]);
+    std::cout << "," << std::endl
+              << "  {\"scene\": \"" << r.scene
+              << "\", \"validation\": \"" << r.validation
+              << "\", \"pair\": \"" << s.name
+              << "\", \"mean_time\": "
+              << (r.paths > 0 ? s.time / (value_type) r.paths : 0) << ", ";
+    print (s, r.paths, std::cout);
+    std::cout << "}";
+  }
+}
+
+/// Validate the paths of a scene
+template <typename Validation>
+Record benchmark (const Scene& scene, const std::string& name,
+                  value_type tolerance)
+{
+  Record record (scene.name, name);
+  ProblemPtr_t problem (scene.solver->problem ());
+  typename MeasuredValidation <Validation>::Ptr_t validation
+    (MeasuredValidation <Validation>::create (problem->robot (),
+                                              tolerance));
+  problem->setupPathValidation (validation);
+  std::map <std::string, Statistics> statistics;
+  validation->measure (statistics);
+  for (std::size_t i = 0; i < scene.paths.size (); ++i) {
+    PathPtr_t validPart;
+    PathValidationReportPtr_t report;
+    const Clock_t::time_point start (Clock_t::now ());
+    const bool valid (validation->validate (scene.paths [i], false,
+                                            validPart, report));
+    const value_type time (boost::chrono::duration <value_type>
+                           (Clock_t::now () - start).count ());
+    ++record.paths;
+    if (valid) {
+      ++record.valid;
+      record.validTime += time;
+    } else {
+      record.rejectionTime += time;
+    }
+  }
+  for (std::map <std::string, Statistics>::const_iterator it
+         (statistics.begin ()); it != statistics.end (); ++it) {
+    record.total.add (it->second);
+    record.pairs.push_back (it->second);
+  }
+  std::sort (record.pairs.begin (), record.pairs.end ());
+  return record;
+}
+
+Options parse (int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg (argv [i]);
+    if (i + 1 >= argc) {
+      std::ostringstream oss;
+      oss << "Missing value for option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+    const char* value (argv [++i]);
+    if (arg == "--paths") options.paths = (size_type) std::atof (value);
+    else if (arg == "--seed") options.seed = (size_type) std::atof (value);
+    else if (arg == "--pairs") options.pairs = (size_type) std::atof (value);
+    else {
+      std::ostringstream oss;
+      oss << "Unknown option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+  }
+  if (options.paths <= 0)
+    throw std::invalid_argument ("Number of paths should be positive");
+  if (options.pairs < 0)
+    throw std::invalid_argument ("Number of pairs should not be negative");
+  return options;
+}
+
+int main (int argc, char** argv)
+{
+  Options options;
+  try {
+    options = parse (argc, argv);
+  } catch (const std::exception& exc) {
+    std::cerr << exc.what () << std::endl;
+    return 1;
+  }
+
+  // Add new path sets here.
+  std::vector <Scene> scenes;
+  scenes.push_back (createScene ("humanoid-straight", unittest::makeDevice
+                                 (unittest::HumanoidSimple), 3, "Straight"));
+  steerPaths (scenes.back (), options);
+  scenes.push_back (createScene ("humanoid-interpolated", unittest::makeDevice
+                                 (unittest::HumanoidSimple), 3, "Straight"));
+  interpolatePaths (scenes.back (), options);
+  scenes.push_back (createScene ("humanoid-spline", unittest::makeDevice
+                                 (unittest::HumanoidSimple), 3, "Straight"));
+  splinePaths (scenes.back (), options);
+  scenes.push_back (createScene ("car-like-reeds-shepp", unittest::makeDevice
+                                 (unittest::CarLike), 2, "ReedsShepp"));
+  steerPaths (scenes.back (), options);
+
+  std::cout << "[" << std::endl;
+  bool first = true;
+  for (std::size_t s = 0; s < scenes.size (); ++s) {
+    Record progressive (benchmark <continuousValidation::Progressive>
+                        (scenes [s], "Progressive", 0.001));
+    print (progressive, (std::size_t) options.pairs, first);
+    first = false;
+    Record dichotomy (benchmark <continuousValidation::Dichotomy>
+                      (scenes [s], "Dichotomy", 0));
+    print (dichotomy, (std::size_t) options.pairs, first);
+  }
+  std::cout << std::endl << "]" << std::endl;
+
+  for (std::size_t s = 0; s < scenes.size (); ++s)
+    delete scenes [s].solver;
+  return 0;
+}
@@ -0,0 +1,394 @@
+// Copyright (c) 2014, LAAS-CNRS
+// Authors: Mathieu Geisert
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+// Benchmark of the nearest neighbor implementations.
+//
+// For each device, each implementation and each roadmap size, the program
+// measures the insertion throughput and the latency distribution of
+// nearest, k-nearest and radius searches. One record is printed
+// per device, implementation, size and operation, as CSV (default) or
+// JSON.
+//
+// Usage: benchmark-nearest-neighbor [--format csv|json] [--min-nodes N]
+//          [--max-nodes N] [--basic-max-nodes N] [--queries N] [--k K]
+//          [--radius R]
+//
+// Sizes are the powers of 10 between --min-nodes and --max-nodes.
+// Basic is linear in the number of nodes and is skipped above
+// --basic-max-nodes.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/urdf/util.hh>
+#include <hpp/core/fwd.hh>
+#include <hpp/core/configuration-shooter/uniform.hh>
+#include <hpp/core/connected-component.hh>
+#include <hpp/core/nearest-neighbor.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/weighed-distance.hh>
+#include "../src/nearest-neighbor/basic.hh"
+
+using namespace hpp::core;
+using namespace hpp::pinocchio;
+
+namespace bpt = boost::posix_time;
+
+typedef NearestNeighborPtr_t (*Factory_t) (const DevicePtr_t& robot,
+                                           const DistancePtr_t& distance);
+
+struct Implementation
+{
+  const char* name;
+  Factory_t create;
+  /// Whether the cost of the searches is linear in the number of nodes
+  bool linear;
+};
+
+NearestNeighborPtr_t createBasic (const DevicePtr_t&,
+                                  const DistancePtr_t& distance)
+{
+  return new nearestNeighbor::Basic (distance);
+}
+
+NearestNeighborPtr_t createKDTree (const DevicePtr_t& robot,
+                                   const DistancePtr_t& distance)
+{
+  return nearestNeighbor::createKDTree (robot, distance);
+}
+
+// Add new implementations here.
+const Implementation implementations [] = {
+  { "Basic", &createBasic, true },
+  { "KDTree", &createKDTree, false }
+};
+
+struct Options
+{
+  std::string format;
+  size_type minNodes, maxNodes, basicMaxNodes, queries;
+  std::size_t K;
+  value_type radius;
+
+  Options () : format ("csv"), minNodes (1000), maxNodes (100000),
+  basicMaxNodes (100000), queries (1000), K (10), radius (.5)
+  {}
+};
+
+DevicePtr_t createPlanarRobot ()
+{
+  std::string urdf ("<robot name='planar'>"
+      "<link name='link1'/>"
+      "<link name='link2'/>"
+      "<link name='link3'/>"
+      "<joint name='rz' type='continuous'>"
+        "<parent link='link1'/>"
+        "<child  link='link2'/>"
+        "<limit effort='30' velocity='1.0'/>"
+      "</joint>"
+      "<joint name='tz' type='prismatic'>"
+        "<axis xyz='0 0 1'/>"
+        "<parent link='link2'/>"
+        "<child  link='link3'/>"
+        "<limit effort='30' velocity='1.0' lower='-3' upper='3'/>"
+      "</joint>"
+      "</robot>"
+      );
+
+  DevicePtr_t robot = Device::create ("planar");
+  urdf::loadModelFromString (robot, 0, "", "planar", urdf, "");
+  robot->rootJoint ()->lowerBound (0, -3);
+  robot->rootJoint ()->lowerBound (1, -3);
+  robot->rootJoint ()->upperBound (0,  3);
+  robot->rootJoint ()->upperBound (1,  3);
+  return robot;
+}
+
+DevicePtr_t createFreeflyerRobot ()
+{
+  DevicePtr_t robot = Device::create ("freeflyer");
+  urdf::loadModel (robot, 0, "", "freeflyer",
+                   "file://" TEST_DIRECTORY "/empty.urdf", "");
+  for (size_type i = 0; i < 3; ++i) {
+    robot->rootJoint ()->lowerBound (i, -3);
+    robot->rootJoint ()->upperBound (i,  3);
+  }
+  return robot;
+}
+
+/// Latencies in microseconds of one operation
+struct Record
+{
+  std::string device, implementation, operation;
+  size_type nodes;
+  std::vector <value_type> latencies;
+  /// Total time in seconds
+  value_type time;
+  /// Mean number of nodes returned by a query
+  value_type results;
+
+  value_type percentile (value_type p) const
+  {
+    if (latencies.empty ()) return 0;
+    std::size_t i ((std::size_t) (p * (value_type) (latencies.size () - 1)));
+    return latencies [i];
+  }
+
+  value_type throughput () const
+  {
+    if (time <= 0) return 0;
+    return (value_type) latencies.size () / time;
+  }
+};
+
+value_type elapsed (const bpt::ptime& start, const bpt::ptime& stop)
+{
+  return (value_type) (stop - start).total_microseconds ();
+}
+
+void finish (Record& record)
+{
+  record.time = 0;
+  for (std::size_t i = 0; i < record.latencies.size (); ++i)
+    record.time += record.latencies [i];
+  record.time *= 1e-6;
+  std::sort (record.latencies.begin (), record.latencies.end ());
+}
+
+void printHeader (const Options& options)
+{
+  if (options.format == "csv")
+    std::cout << "device,implementation,nodes,operation,count,"
+      "throughput,mean_results,p50_us,p90_us,p99_us,max_us" << std::endl;
+  else
+    std::cout << "[" << std::endl;
+}
+
+void print (const Options& options, const Record& r, bool first)
+{
+  if (options.format == "csv") {
+    std::cout << r.device << ',' << r.implementation << ',' << r.nodes << ','
+              << r.operation << ',' << r.latencies.size () << ','
+              << r.throughput () << ',' << r.results << ','
+              << r.percentile (.5) << ',' << r.percentile (.9) << ','
+              << r.percentile (.99) << ',' << r.percentile (1.)
+              << std::endl;
+  } else {
+    if (!first) std::cout << "," << std::endl;
+    std::cout << "  {\"device\": \"" << r.device
+              << "\", \"implementation\": \"" << r.implementation
+              << "\", \"nodes\": " << r.nodes
+              << ", \"operation\": \"" << r.operation
+              << "\", \"count\": " << r.latencies.size ()
+              << ", \"throughput\": " << r.throughput ()
+              << ", \"mean_results\": " << r.results
+              << ", \"p50_us\": " << r.percentile (.5)
+              << ", \"p90_us\": " << r.percentile (.9)
+              << ", \"p99_us\": " << r.percentile (.99)
+              << ", \"max_us\": " << r.percentile (1.) << "}";
+  }
+}
+
+void printFooter (const Options& options)
+{
+  if (options.format == "json")
+    std::cout << std::endl << "]" << std::endl;
+}
+
+/// Benchmark one implementation on one roadmap
+/// \param configurations configurations of the nodes, column-wise,
+/// \param queries query configurations, column-wise.
+std::vector <Record> benchmark (const std::string& device,
+                                const Implementation& implementation,
+                                const DevicePtr_t& robot,
+                                const DistancePtr_t& distance,
+                                const matrix_t& configurations,
+                                const matrix_t& queries,
+                                const Options& options)
+{
+  const size_type n (configurations.cols ());
+  const std::size_t nCC (4);
+  NearestNeighborPtr_t nn (implementation.create (robot, distance));
+  std::vector <ConnectedComponentPtr_t> ccs (nCC);
+  for (std::size_t i = 0; i < nCC; ++i)
+    ccs [i] = ConnectedComponent::create ();
+
+  std::vector <Record> records (4);
+  const char* operations [] = { "insert", "nearest", "knearest", "radius" };
+  for (std::size_t i = 0; i < records.size (); ++i) {
+    records [i].device = device;
+    records [i].implementation = implementation.name;
+    records [i].operation = operations [i];
+    records [i].nodes = n;
+    records [i].results = 0;
+  }
+
+  // Insertion
+  std::vector <NodePtr_t> nodes ((std::size_t) n);
+  records [0].latencies.reserve ((std::size_t) n);
+  for (size_type i = 0; i < n; ++i) {
+    ConnectedComponentPtr_t cc (ccs [(std::size_t) i % nCC]);
+    NodePtr_t node (new Node (ConfigurationPtr_t
+                              (new Configuration_t (configurations.col (i))),
+                              cc));
+    cc->addNode (node);
+    nodes [(std::size_t) i] = node;
+    bpt::ptime start (bpt::microsec_clock::universal_time ());
+    nn->addNode (node);
+    bpt::ptime stop (bpt::microsec_clock::universal_time ());
+    records [0].latencies.push_back (elapsed (start, stop));
+  }
+  records [0].results = 1;
+
+  // Searches
+  for (size_type j = 0; j < queries.cols (); ++j) {
+    Configuration_t q (queries.col (j));
+    const ConnectedComponentPtr_t& cc (ccs [(std::size_t) j % nCC]);
+    value_type d;
+
+    bpt::ptime start (bpt::microsec_clock::universal_time ());
+    nn->search (q, cc, d);
+    bpt::ptime stop (bpt::microsec_clock::universal_time ());
+    records [1].latencies.push_back (elapsed (start, stop));
+    records [1].results += 1;
+
+    start = bpt::microsec_clock::universal_time ();
+    Nodes_t knearest (nn->KnearestSearch (q, cc, options.K, d));
+    stop = bpt::microsec_clock::universal_time ();
+    records [2].latencies.push_back (elapsed (start, stop));
+    records [2].results += (value_type) knearest.size ();
+
+    start = bpt::microsec_clock::universal_time ();
+    NodeVector_t ball (nn->withinBall (q, cc, options.radius));
+    stop = bpt::microsec_clock::universal_time ();
+    records [3].latencies.push_back (elapsed (start, stop));
+    records [3].results += (value_type) ball.size ();
+  }
+  for (std::size_t i = 1; i < records.size (); ++i)
+    records [i].results /= (value_type) queries.cols ();
+  for (std::size_t i = 0; i < records.size (); ++i)
+    finish (records [i]);
+
+  delete nn;
+  for (std::size_t i = 0; i < nodes.size (); ++i) delete nodes [i];
+  return records;
+}
+
+matrix_t shoot (const DevicePtr_t& robot, size_type n)
+{
+  configurationShooter::UniformPtr_t shooter
+    (configurationShooter::Uniform::create (robot));
+  matrix_t result (robot->configSize (), n);
+  Configuration_t q (robot->configSize ());
+  for (size_type i = 0; i < n; ++i) {
+    shooter->shoot (q);
+    result.col (i) = q;
+  }
+  return result;
+}
+
+size_type parseSize (const char* value)
+{
+  // Accept 1e6 as well as 1000000
+  return (size_type) std::atof (value);
+}
+
+Options parse (int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg (argv [i]);
+    if (i + 1 >= argc) {
+      std::ostringstream oss;
+      oss << "Missing value for option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+    const char* value (argv [++i]);
+    if (arg == "--format") options.format = value;
+    else if (arg == "--min-nodes") options.minNodes = parseSize (value);
+    else if (arg == "--max-nodes") options.maxNodes = parseSize (value);
+    else if (arg == "--basic-max-nodes")
+      options.basicMaxNodes = parseSize (value);
+    else if (arg == "--queries") options.queries = parseSize (value);
+    else if (arg == "--k") options.K = (std::size_t) parseSize (value);
+    else if (arg == "--radius") options.radius = std::atof (value);
+    else {
+      std::ostringstream oss;
+      oss << "Unknown option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+  }
+  if (options.format != "csv" && options.format != "json")
+    throw std::invalid_argument ("Format should be csv or json");
+  if (options.minNodes <= 0 || options.queries <= 0)
+    throw std::invalid_argument ("Numbers of nodes and queries should be "
+                                 "positive");
+  return options;
+}
+
+int main (int argc, char** argv)
+{
+  Options options;
+  try {
+    options = parse (argc, argv);
+  } catch (const std::exception& exc) {
+    std::cerr << exc.what () << std::endl;
+    return 1;
+  }
+
+  std::vector <std::pair <std::string, DevicePtr_t> > devices;
+  devices.push_back (std::make_pair (std::string ("planar"),
+                                     createPlanarRobot ()));
+  devices.push_back (std::make_pair (std::string ("freeflyer"),
+                                     createFreeflyerRobot ()));
+
+  printHeader (options);
+  bool first = true;
+  for (std::size_t d = 0; d < devices.size (); ++d) {
+    const DevicePtr_t& robot (devices [d].second);
+    DistancePtr_t distance (WeighedDistance::create (robot));
+    // Same configurations for all the implementations
+    std::srand (0);
+    matrix_t queries (shoot (robot, options.queries));
+    for (size_type n = options.minNodes; n <= options.maxNodes; n *= 10) {
+      matrix_t configurations (shoot (robot, n));
+      for (std::size_t i = 0;
+           i < sizeof (implementations) / sizeof (Implementation); ++i) {
+        if (implementations [i].linear && n > options.basicMaxNodes)
+          continue;
+        std::vector <Record> records
+          (benchmark (devices [d].first, implementations [i], robot,
+                      distance, configurations, queries, options));
+        for (std::size_t j = 0; j < records.size (); ++j) {
+          print (options, records [j], first);
+          first = false;
+        }
+      }
+    }
+  }
+  printFooter (options);
+  return 0;
+}
@@ -0,0 +1,457 @@
+// Copyright (c) 2014, LAAS-CNRS
+// Authors: Mathieu Geisert
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+// Benchmark of the path projectors.
+//
+// Random pairs of configurations satisfying a set of constraints are
+// connected by the steering method of each path projector, and the
+// resulting paths are projected. The sets of constraints are
+// \li the position of the end effector of an arm,
+// \li the center of mass of an arm,
+// \li an object held by another one through an explicit relative pose,
+//     the position of the first object being constrained.
+// One record is printed per set of constraints and path projector, as
+// JSON, with the success rate, the median time of a projection, the mean
+// number of Newton iterations and the mean number of segments of the
+// projected paths. The Newton iterations are counted as the evaluations of
+// the jacobian of the implicit constraints. The segments are the leaves of
+// the projected path, interpolation points included.
+//
+// Usage: benchmark-path-projectors [--pairs N] [--seed N] [--step STEP]
+//          [--hermite-step STEP] [--projector NAME]
+//
+// --projector restricts the benchmark to one projector and may be repeated.
+// Compare the output of two builds to catch performance regressions.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/chrono/system_clocks.hpp>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/simple-device.hh>
+#include <hpp/pinocchio/urdf/util.hh>
+
+#include <hpp/constraints/differentiable-function.hh>
+#include <hpp/constraints/explicit/relative-pose.hh>
+#include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/implicit.hh>
+
+#include <hpp/core/config-projector.hh>
+#include <hpp/core/configuration-shooter.hh>
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/interpolated-path.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/steering-method/hermite.hh>
+#include <hpp/core/steering-method/straight.hh>
+#include <hpp/core/path-projector/dichotomy.hh>
+#include <hpp/core/path-projector/global.hh>
+#include <hpp/core/path-projector/progressive.hh>
+#include <hpp/core/path-projector/recursive-hermite.hh>
+
+using hpp::constraints::Equality;
+using hpp::constraints::Implicit;
+using hpp::constraints::Position;
+namespace explicit_ = hpp::constraints::explicit_;
+
+using namespace hpp::core;
+using namespace hpp::pinocchio;
+
+typedef boost::chrono::steady_clock Clock_t;
+
+struct Options
+{
+  size_type pairs, seed;
+  value_type step, hermiteStep;
+  std::vector <std::string> projectors;
+
+  Options () : pairs (20), seed (0), step (.1), hermiteStep (2)
+  {}
+};
+
+/// Function that counts the evaluations of the jacobian of another one
+class Counter : public DifferentiableFunction
+{
+  public:
+    Counter (const DifferentiableFunctionPtr_t& function) :
+      DifferentiableFunction (function->inputSize (),
+                              function->inputDerivativeSize (),
+                              function->outputSpace (), function->name ()),
+      jacobians (0), function_ (function)
+    {
+      activeParameters_ = function->activeParameters ();
+      activeDerivativeParameters_ = function->activeDerivativeParameters ();
+    }
+
+    mutable size_type jacobians;
+
+  protected:
+    void impl_compute (LiegroupElementRef result, vectorIn_t argument) const
+    {
+      function_->value (result, argument);
+    }
+    void impl_jacobian (matrixOut_t jacobian, vectorIn_t argument) const
+    {
+      ++jacobians;
+      function_->jacobian (jacobian, argument);
+    }
+
+  private:
+    DifferentiableFunctionPtr_t function_;
+};
+typedef boost::shared_ptr <Counter> CounterPtr_t;
+
+/// Position of the center of mass of a robot in the world frame
+class CenterOfMass : public DifferentiableFunction
+{
+  public:
+    CenterOfMass (const DevicePtr_t& robot) :
+      DifferentiableFunction (robot->configSize (), robot->numberDof (),
+                              LiegroupSpace::R3 (), "center of mass"),
+      robot_ (robot)
+    {}
+
+  protected:
+    void impl_compute (LiegroupElementRef result, vectorIn_t argument) const
+    {
+      robot_->currentConfiguration (argument);
+      robot_->computeForwardKinematics ();
+      result.vector () = robot_->positionCenterOfMass ();
+    }
+    void impl_jacobian (matrixOut_t jacobian, vectorIn_t argument) const
+    {
+      robot_->currentConfiguration (argument);
+      robot_->computeForwardKinematics ();
+      jacobian = robot_->jacobianCenterOfMass ();
+    }
+
+  private:
+    DevicePtr_t robot_;
+};
+
+/// Robot, constraints and random pairs of configurations satisfying them
+struct Scene
+{
+  std::string name;
+  ProblemPtr_t problem;
+  ConstraintSetPtr_t constraints;
+  /// Counters of the Newton iterations of each implicit constraint
+  std::vector <CounterPtr_t> counters;
+  std::vector <std::pair <Configuration_t, Configuration_t> > pairs;
+
+  size_type iterations () const
+  {
+    size_type res (0);
+    for (std::size_t i = 0; i < counters.size (); ++i)
+      res += counters [i]->jacobians;
+    return res;
+  }
+  void resetIterations ()
+  {
+    for (std::size_t i = 0; i < counters.size (); ++i)
+      counters [i]->jacobians = 0;
+  }
+};
+
+/// Add an implicit equality constraint whose iterations are counted
+void addCounted (Scene& scene, const DifferentiableFunctionPtr_t& function)
+{
+  CounterPtr_t counter (new Counter (function));
+  scene.counters.push_back (counter);
+  scene.constraints->configProjector ()->add
+    (Implicit::create (counter, ComparisonTypes_t
+                       ((std::size_t) function->outputSpace ()->nv (),
+                        Equality)));
+}
+
+Scene createScene (const std::string& name, const DevicePtr_t& robot)
+{
+  Scene scene;
+  scene.name = name;
+  scene.problem = Problem::create (robot);
+  scene.constraints = ConstraintSet::create (robot, name);
+  scene.constraints->addConstraint
+    (ConfigProjector::create (robot, name, 1e-4, 40));
+  return scene;
+}
+
+/// Shoot the random pairs of configurations of a scene
+/// The right hand side of the constraints is set so that the neutral
+/// configuration of the robot satisfies them.
+void shootPairs (Scene& scene, const Options& options)
+{
+  const DevicePtr_t& robot (scene.problem->robot ());
+  scene.constraints->configProjector ()->rightHandSideFromConfig
+    (robot->neutralConfiguration ());
+  scene.problem->seed (options.seed);
+  ConfigurationShooterPtr_t shooter (scene.problem->configurationShooter ());
+  for (size_type i = 0; (size_type) scene.pairs.size () < options.pairs &&
+         i < 100 * options.pairs; ++i) {
+    Configuration_t q1 (*shooter->shoot ()), q2 (*shooter->shoot ());
+    if (scene.constraints->apply (q1) && scene.constraints->apply (q2))
+      scene.pairs.push_back (std::make_pair (q1, q2));
+  }
+}
+
+/// Position of the end effector of an arm
+Scene createEffectorScene (const Options& options)
+{
+  DevicePtr_t robot (unittest::makeDevice (unittest::ManipulatorArm2));
+  Scene scene (createScene ("arm-effector-position", robot));
+  JointPtr_t effector (robot->jointAt (robot->nbJoints () - 1));
+  matrix3_t rot; rot.setIdentity ();
+  vector3_t zero; zero.setZero ();
+  addCounted (scene, Position::create ("effector position", robot, effector,
+                                       Transform3f (rot, zero),
+                                       Transform3f (rot, zero)));
+  shootPairs (scene, options);
+  return scene;
+}
+
+/// Center of mass of an arm
+Scene createComScene (const Options& options)
+{
+  DevicePtr_t robot (unittest::makeDevice (unittest::ManipulatorArm2));
+  robot->controlComputation ((Computation_t)
+                             (JOINT_POSITION | JACOBIAN | COM));
+  Scene scene (createScene ("arm-center-of-mass", robot));
+  addCounted (scene, DifferentiableFunctionPtr_t (new CenterOfMass (robot)));
+  shootPairs (scene, options);
+  return scene;
+}
+
+/// Object held by another one, the position of the latter being fixed
+Scene createHeldObjectScene (const Options& options)
+{
+  DevicePtr_t robot (Device::create ("2-objects"));
+  urdf::loadModel (robot, 0, "obj1/", "freeflyer",
+                   "file://" DATA_DIR "/empty.urdf", "");
+  urdf::loadModel (robot, 0, "obj2/", "freeflyer",
+                   "file://" DATA_DIR "/empty.urdf", "");
+  robot->controlComputation ((Computation_t) (JOINT_POSITION | JACOBIAN));
+  JointPtr_t object1 (robot->getJointByName ("obj1/root_joint"));
+  JointPtr_t object2 (robot->getJointByName ("obj2/root_joint"));
+  for (size_type i = 0; i < 3; ++i) {
+    object1->lowerBound (i, -2); object1->upperBound (i, 2);
+    object2->lowerBound (i, -2); object2->upperBound (i, 2);
+  }
+  Scene scene (createScene ("held-object", robot));
+  matrix3_t rot; rot.setIdentity ();
+  Transform3f M1inO1 (rot, vector3_t (.1, 0, 0)), M2inO2 (rot, vector3_t::Zero ());
+  scene.constraints->configProjector ()->add
+    (explicit_::RelativePose::create ("obj2 in obj1", robot, object1,
+                                      object2, M1inO1, M2inO2,
+                                      6 * Equality));
+  addCounted (scene, Position::create ("obj1 position", robot, object1,
+                                       Transform3f (rot, vector3_t::Zero ()),
+                                       Transform3f (rot, vector3_t::Zero ())));
+  shootPairs (scene, options);
+  return scene;
+}
+
+/// Results of the projections of the paths of a scene with a projector
+struct Record
+{
+  std::string scene, projector;
+  size_type runs, successes;
+  /// Time of each projection (in seconds)
+  std::vector <value_type> times;
+  value_type iterations, segments;
+  std::string lastError;
+
+  Record (const std::string& s, const std::string& p) :
+    scene (s), projector (p), runs (0), successes (0), iterations (0),
+    segments (0)
+  {}
+
+  /// Mean of a sum over the path projections
+  value_type mean (value_type sum) const
+  {
+    return runs > 0 ? sum / (value_type) runs : 0;
+  }
+  value_type median ()
+  {
+    if (times.empty ()) return 0;
+    std::sort (times.begin (), times.end ());
+    return times [times.size () / 2];
+  }
+};
+
+void print (Record& r, bool first)
+{
+  if (!first) std::cout << "," << std::endl;
+  std::cout << "  {\"scene\": \"" << r.scene
+            << "\", \"projector\": \"" << r.projector
+            << "\", \"runs\": " << r.runs
+            << ", \"success_rate\": "
+            << (r.runs > 0 ? (value_type) r.successes / (value_type) r.runs
+                : 0)
+            << ", \"median_time\": " << r.median ()
+            << ", \"mean_newton_iterations\": " << r.mean (r.iterations)
+            << ", \"mean_segments\": " << r.mean (r.segments) << "}";
+  if (!r.lastError.empty ())
+    std::cerr << r.scene << ", " << r.projector << ": " << r.lastError
+              << std::endl;
+}
+
+/// Number of leaves of a path, counting the intervals between the
+/// interpolation points of interpolated paths.
+size_type numberSegments (const PathPtr_t& path)
+{
+  PathVectorPtr_t pv (HPP_DYNAMIC_PTR_CAST (PathVector, path));
+  if (pv) {
+    size_type res (0);
+    for (std::size_t i = 0; i < pv->numberPaths (); ++i)
+      res += numberSegments (pv->pathAtRank (i));
+    return res;
+  }
+  InterpolatedPathPtr_t ip (HPP_DYNAMIC_PTR_CAST (InterpolatedPath, path));
+  if (ip)
+    return (size_type) ip->interpolationPoints ().size () - 1;
+  return 1;
+}
+
+/// Set the steering method required by the projector and create it
+PathProjectorPtr_t createProjector (const std::string& name,
+                                    const Scene& scene,
+                                    const Options& options)
+{
+  Problem& problem (*scene.problem);
+  if (name == "RecursiveHermite")
+    problem.steeringMethod (steeringMethod::Hermite::create (problem));
+  else
+    problem.steeringMethod (steeringMethod::Straight::create (problem));
+  problem.steeringMethod ()->constraints (scene.constraints);
+
+  if (name == "Dichotomy")
+    return pathProjector::Dichotomy::create (problem, options.step);
+  if (name == "Global")
+    return pathProjector::Global::create (problem, options.step);
+  if (name == "Progressive")
+    return pathProjector::Progressive::create (problem, options.step);
+  if (name == "RecursiveHermite")
+    return pathProjector::RecursiveHermite::create (problem,
+                                                    options.hermiteStep);
+  throw std::invalid_argument ("Unknown path projector " + name);
+}
+
+/// Project the path between each pair of configurations of the scene
+Record benchmarkProjector (Scene& scene, const std::string& name,
+                           const Options& options)
+{
+  Record record (scene.name, name);
+  PathProjectorPtr_t projector (createProjector (name, scene, options));
+  SteeringMethodPtr_t sm (scene.problem->steeringMethod ());
+  for (std::size_t i = 0; i < scene.pairs.size (); ++i) {
+    ++record.runs;
+    try {
+      PathPtr_t path ((*sm) (scene.pairs [i].first, scene.pairs [i].second));
+      if (!path) {
+        record.lastError = "steering method failed.";
+        continue;
+      }
+      PathPtr_t projection;
+      scene.resetIterations ();
+      const Clock_t::time_point start (Clock_t::now ());
+      bool success (projector->apply (path, projection));
+      record.times.push_back (boost::chrono::duration <value_type>
+                              (Clock_t::now () - start).count ());
+      record.iterations += (value_type) scene.iterations ();
+      if (projection)
+        record.segments += (value_type) numberSegments (projection);
+      if (success) ++record.successes;
+    } catch (const std::exception& exc) {
+      record.lastError = exc.what ();
+    }
+  }
+  return record;
+}
+
+Options parse (int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg (argv [i]);
+    if (i + 1 >= argc) {
+      std::ostringstream oss;
+      oss << "Missing value for option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+    const char* value (argv [++i]);
+    if (arg == "--pairs") options.pairs = (size_type) std::atof (value);
+    else if (arg == "--seed") options.seed = (size_type) std::atof (value);
+    else if (arg == "--step") options.step = std::atof (value);
+    else if (arg == "--hermite-step") options.hermiteStep = std::atof (value);
+    else if (arg == "--projector") options.projectors.push_back (value);
+    else {
+      std::ostringstream oss;
+      oss << "Unknown option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+  }
+  if (options.pairs <= 0)
+    throw std::invalid_argument ("Number of pairs should be positive");
+  if (options.step <= 0 || options.hermiteStep <= 0)
+    throw std::invalid_argument ("Projection steps should be positive");
+  return options;
+}
+
+int main (int argc, char** argv)
+{
+  Options options;
+  try {
+    options = parse (argc, argv);
+  } catch (const std::exception& exc) {
+    std::cerr << exc.what () << std::endl;
+    return 1;
+  }
+  if (options.projectors.empty ()) {
+    options.projectors.push_back ("Dichotomy");
+    options.projectors.push_back ("Global");
+    options.projectors.push_back ("Progressive");
+    options.projectors.push_back ("RecursiveHermite");
+  }
+
+  // Add new sets of constraints here.
+  std::vector <Scene> scenes;
+  scenes.push_back (createEffectorScene (options));
+  scenes.push_back (createComScene (options));
+  scenes.push_back (createHeldObjectScene (options));
+
+  std::cout << "[" << std::endl;
+  bool first = true;
+  for (std::size_t s = 0; s < scenes.size (); ++s) {
+    if ((size_type) scenes [s].pairs.size () < options.pairs)
+      std::cerr << scenes [s].name << ": only " << scenes [s].pairs.size ()
+                << " pairs of configurations could be projected."
+                << std::endl;
+    for (std::size_t i = 0; i < options.projectors.size (); ++i) {
+      Record record (benchmarkProjector (scenes [s], options.projectors [i],
+                                         options));
+      print (record, first);
+      first = false;
+    }
+  }
+  std::cout << std::endl << "]" << std::endl;
+  return 0;
+}
@@ -0,0 +1,363 @@
+// Copyright (c) 2014, LAAS-CNRS
+// Authors: Mathieu Geisert
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+// Benchmark of the nearest neighbor implementations.
+// Benchmark of the path planners and path optimizers.
+//
+// Each planner registered in ProblemSolver is run on a set of scenes with
+// several seeds of the random numbers of the problem. One record is
+// printed per scene and planner, as JSON, with the success rate, the time
+// to the first solution, the number of iterations, the number of calls to
+// the nearest neighbor searches and to path validation, and the cost of
+// the solutions. The statistics of the stages are only filled by the
+// planners that instrument their steps, see PathPlanner::statistics.
+// Each registered path optimizer is then run on the solutions of the
+// reference planner, and one record is printed per scene and optimizer.
+//
+// Usage: benchmark-planners [--seeds N] [--max-iterations N]
+//          [--time-out SECONDS] [--planner NAME] [--reference NAME]
+//
+// --planner restricts the benchmark to one planner and may be repeated.
+// Compare the output of two builds to catch performance regressions.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/chrono/system_clocks.hpp>
+
+#include <hpp/fcl/collision_object.h>
+#include <hpp/fcl/shape/geometric_shapes.h>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/urdf/util.hh>
+
+#include <hpp/core/path-optimizer.hh>
+#include <hpp/core/path-planner.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/planner-statistics.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/problem-solver.hh>
+#include <hpp/core/roadmap.hh>
+
+using namespace hpp::core;
+using namespace hpp::pinocchio;
+
+typedef boost::chrono::steady_clock Clock_t;
+
+struct Options
+{
+  size_type seeds;
+  unsigned long int maxIterations;
+  value_type timeOut;
+  std::vector <std::string> planners;
+  std::string reference;
+
+  Options () : seeds (10), maxIterations (10000), timeOut (10),
+  reference ("DiffusingPlanner")
+  {}
+};
+
+/// Robot, obstacles, and start and goal configurations
+struct Scene
+{
+  std::string name;
+  ProblemSolverPtr_t solver;
+};
+
+const char* sphereUrdf =
+  "<robot name='sphere'><link name='base_link'>"
+  "<collision><geometry><sphere radius='0.05'/></geometry></collision>"
+  "</link></robot>";
+
+DevicePtr_t createSphereRobot (const std::string& rootJoint)
+{
+  DevicePtr_t robot = Device::create ("sphere");
+  urdf::loadModelFromString (robot, 0, "", rootJoint, sphereUrdf, "");
+  for (size_type i = 0; i < 3; ++i) {
+    robot->rootJoint ()->lowerBound (i, -2);
+    robot->rootJoint ()->upperBound (i,  2);
+  }
+  return robot;
+}
+
+void addBox (const ProblemSolverPtr_t& ps, const std::string& name,
+             const vector3_t& size, const vector3_t& center)
+{
+  FclCollisionObject box
+    (hpp::fcl::CollisionGeometryPtr_t
+     (new hpp::fcl::Box (size [0], size [1], size [2])),
+     matrix3_t::Identity (), center);
+  ps->addObstacle (name, box, true, true);
+}
+
+/// Wall in plane x = 0 with a square hole of given width at the origin
+void addWall (const ProblemSolverPtr_t& ps, value_type hole)
+{
+  const value_type h (hole / 2), l (2 - h), c ((2 + h) / 2);
+  addBox (ps, "wall_y+", vector3_t (.1, l, 4), vector3_t (0,  c, 0));
+  addBox (ps, "wall_y-", vector3_t (.1, l, 4), vector3_t (0, -c, 0));
+  addBox (ps, "wall_z+", vector3_t (.1, hole, l), vector3_t (0, 0,  c));
+  addBox (ps, "wall_z-", vector3_t (.1, hole, l), vector3_t (0, 0, -c));
+}
+
+/// Create a scene
+/// \param hole width of the hole of the wall, 0 for a single box.
+Scene createScene (const std::string& name, const std::string& rootJoint,
+                   value_type hole)
+{
+  Scene scene;
+  scene.name = name;
+  scene.solver = ProblemSolver::create ();
+  const ProblemSolverPtr_t& ps (scene.solver);
+  DevicePtr_t robot (createSphereRobot (rootJoint));
+  ps->robot (robot);
+  if (hole > 0)
+    addWall (ps, hole);
+  else
+    addBox (ps, "box", vector3_t (.5, .5, .5), vector3_t (0, 0, 0));
+
+  ProblemPtr_t problem (ps->problem ());
+  ConfigurationPtr_t qinit (new Configuration_t
+                            (robot->neutralConfiguration ()));
+  ConfigurationPtr_t qgoal (new Configuration_t
+                            (robot->neutralConfiguration ()));
+  (*qinit) [0] = -1;
+  (*qgoal) [0] =  1;
+  problem->initConfig (qinit);
+  problem->addGoalConfig (qgoal);
+  return scene;
+}
+
+/// Results of the runs of a planner or an optimizer on a scene
+struct Record
+{
+  std::string scene, kind, name;
+  size_type runs, successes;
+  /// Time to the first solution of each successful run (in seconds)
+  std::vector <value_type> times;
+  value_type iterations, nearestNeighborCalls, validationCalls, cost;
+  std::string lastError;
+
+  Record (const std::string& s, const std::string& k, const std::string& n) :
+    scene (s), kind (k), name (n), runs (0), successes (0), iterations (0),
+    nearestNeighborCalls (0), validationCalls (0), cost (0)
+  {}
+
+  /// Mean of a sum over the successful runs
+  value_type mean (value_type sum) const
+  {
+    return successes > 0 ? sum / (value_type) successes : 0;
+  }
+  value_type median ()
+  {
+    if (times.empty ()) return 0;
+    std::sort (times.begin (), times.end ());
+    return times [times.size () / 2];
+  }
+};
+
+void print (Record& r, bool first)
+{
+  if (!first) std::cout << "," << std::endl;
+  std::cout << "  {\"scene\": \"" << r.scene
+            << "\", \"" << r.kind << "\": \"" << r.name
+            << "\", \"runs\": " << r.runs
+            << ", \"success_rate\": "
+            << (r.runs > 0 ? (value_type) r.successes / (value_type) r.runs
+                : 0)
+            << ", \"median_time\": " << r.median ()
+            << ", \"mean_iterations\": " << r.mean (r.iterations)
+            << ", \"mean_nearest_neighbor_calls\": "
+            << r.mean (r.nearestNeighborCalls)
+            << ", \"mean_validation_calls\": " << r.mean (r.validationCalls)
+            << ", \"mean_cost\": " << r.mean (r.cost) << "}";
+  if (r.successes < r.runs)
+    std::cerr << r.scene << ", " << r.name << ": " << r.lastError
+              << std::endl;
+}
+
+/// Store the time at which the target is first reached
+void recordFirstSolution (value_type& time, const PathPlanner::Progress& p)
+{
+  if (p.solved && time < 0) time = p.time;
+}
+
+/// Run a planner with each seed
+/// \retval solutions the path found with each seed, null on failure.
+Record benchmarkPlanner (const Scene& scene, const std::string& name,
+                         const Options& options,
+                         std::vector <PathVectorPtr_t>& solutions)
+{
+  Record record (scene.name, "planner", name);
+  const ProblemSolverPtr_t& ps (scene.solver);
+  ProblemPtr_t problem (ps->problem ());
+  solutions.assign ((std::size_t) options.seeds, PathVectorPtr_t ());
+  for (size_type seed = 0; seed < options.seeds; ++seed) {
+    ++record.runs;
+    problem->seed (seed);
+    RoadmapPtr_t roadmap (Roadmap::create (problem->distance (),
+                                           problem->robot ()));
+    try {
+      PathPlannerPtr_t planner (ps->pathPlanners.get (name)
+                                (*problem, roadmap));
+      planner->maxIterations (options.maxIterations);
+      planner->timeOut (options.timeOut);
+      value_type firstSolution (-1);
+      planner->progressCallback
+        (boost::bind (&recordFirstSolution, boost::ref (firstSolution), _1));
+      PathVectorPtr_t path (planner->solve ());
+      if (!path) {
+        record.lastError = "no path returned.";
+        continue;
+      }
+      const PlannerStatistics& statistics (planner->statistics ());
+      ++record.successes;
+      // A direct path found before the first step is not reported.
+      record.times.push_back (firstSolution < 0 ? statistics.totalTime :
+                              firstSolution);
+      record.iterations += (value_type) statistics.iterations;
+      record.nearestNeighborCalls += (value_type) statistics.count
+        (PlannerStatistics::NEAREST_NEIGHBOR);
+      record.validationCalls += (value_type) statistics.count
+        (PlannerStatistics::VALIDATION);
+      record.cost += path->length ();
+      solutions [(std::size_t) seed] = path;
+    } catch (const std::exception& exc) {
+      record.lastError = exc.what ();
+    }
+  }
+  return record;
+}
+
+/// Run an optimizer on the solutions of the reference planner
+Record benchmarkOptimizer (const Scene& scene, const std::string& name,
+                           const std::vector <PathVectorPtr_t>& solutions)
+{
+  Record record (scene.name, "optimizer", name);
+  const ProblemSolverPtr_t& ps (scene.solver);
+  ProblemPtr_t problem (ps->problem ());
+  for (std::size_t i = 0; i < solutions.size (); ++i) {
+    if (!solutions [i]) continue;
+    ++record.runs;
+    problem->seed ((size_type) i);
+    try {
+      PathOptimizerPtr_t optimizer (ps->pathOptimizers.get (name)
+                                    (*problem));
+      const Clock_t::time_point start (Clock_t::now ());
+      PathVectorPtr_t path (optimizer->optimize (solutions [i]));
+      const value_type time (boost::chrono::duration <value_type>
+                             (Clock_t::now () - start).count ());
+      if (!path) {
+        record.lastError = "no path returned.";
+        continue;
+      }
+      ++record.successes;
+      record.times.push_back (time);
+      record.cost += path->length ();
+    } catch (const std::exception& exc) {
+      record.lastError = exc.what ();
+    }
+  }
+  return record;
+}
+
+Options parse (int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg (argv [i]);
+    if (i + 1 >= argc) {
+      std::ostringstream oss;
+      oss << "Missing value for option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+    const char* value (argv [++i]);
+    if (arg == "--seeds") options.seeds = (size_type) std::atof (value);
+    else if (arg == "--max-iterations")
+      options.maxIterations = (unsigned long int) std::atof (value);
+    else if (arg == "--time-out") options.timeOut = std::atof (value);
+    else if (arg == "--planner") options.planners.push_back (value);
+    else if (arg == "--reference") options.reference = value;
+    else {
+      std::ostringstream oss;
+      oss << "Unknown option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+  }
+  if (options.seeds <= 0)
+    throw std::invalid_argument ("Number of seeds should be positive");
+  return options;
+}
+
+int main (int argc, char** argv)
+{
+  Options options;
+  try {
+    options = parse (argc, argv);
+  } catch (const std::exception& exc) {
+    std::cerr << exc.what () << std::endl;
+    return 1;
+  }
+
+  // Add new scenes here.
+  std::vector <Scene> scenes;
+  scenes.push_back (createScene ("point-box", "translation3d", 0));
+  scenes.push_back (createScene ("point-narrow-passage", "translation3d",
+                                 .2));
+  scenes.push_back (createScene ("freeflyer-narrow-passage", "freeflyer",
+                                 .2));
+
+  std::cout << "[" << std::endl;
+  bool first = true;
+  for (std::size_t s = 0; s < scenes.size (); ++s) {
+    const ProblemSolverPtr_t& ps (scenes [s].solver);
+    std::vector <std::string> planners (options.planners);
+    if (planners.empty ())
+      planners = ps->pathPlanners.getKeys <std::vector <std::string> > ();
+    std::vector <PathVectorPtr_t> solutions, referenceSolutions;
+    for (std::size_t i = 0; i < planners.size (); ++i) {
+      Record record (benchmarkPlanner (scenes [s], planners [i], options,
+                                       solutions));
+      if (planners [i] == options.reference) referenceSolutions = solutions;
+      print (record, first);
+      first = false;
+    }
+    if (referenceSolutions.empty ())
+      benchmarkPlanner (scenes [s], options.reference, options,
+                        referenceSolutions);
+    const std::vector <std::string> optimizers
+      (ps->pathOptimizers.getKeys <std::vector <std::string> > ());
+    for (std::size_t i = 0; i < optimizers.size (); ++i) {
+      Record record (benchmarkOptimizer (scenes [s], optimizers [i],
+                                         referenceSolutions));
+      print (record, first);
+      first = false;
+    }
+  }
+  std::cout << std::endl << "]" << std::endl;
+
+  for (std::size_t s = 0; s < scenes.size (); ++s)
+    delete scenes [s].solver;
+  return 0;
+}
@@ -0,0 +1,587 @@
+// Copyright (c) 2014, LAAS-CNRS
+// Authors: Mathieu Geisert
+//
+// This file is part of hpp-core.
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core. If not, see <http://www.gnu.org/licenses/>.
+
+// Benchmark of ProblemSolver on problems read from files.
+//
+// Each problem is solved with every combination of the path planners,
+// path optimizers, path validations and path projectors given on the
+// command line, with several seeds of the random numbers of the problem,
+// by ProblemSolver::solve. Problems are solved in parallel, each one by a
+// single thread. One record is printed per problem and combination, as
+// JSON, with the success rate, the minimum, median, 90th percentile and
+// maximum of the time of ProblemSolver::solve and of the length of the
+// paths, and the sums of the counters of PathPlanner::statistics,
+// PathOptimizer::Statistics, pathValidation::Cached and
+// steeringMethod::Cached. The caches are only counted if enabled, see
+// the parameters PathValidation/cacheSize and SteeringMethod/cacheSize.
+// The allocations of each subsystem are only counted if hpp-core is built
+// with HPP_CORE_PROFILE_ALLOCATIONS, see AllocationProfile. They include
+// the allocations of the other threads, unless --threads is 1.
+//
+// Usage: benchmark-problems [--seeds N] [--threads N] [--max-iterations N]
+//          [--time-out SECONDS] [--plugin LIBRARY] [--planner NAME]
+//          [--optimizer NAME] [--validation NAME,TOLERANCE]
+//          [--projector NAME,TOLERANCE] FILE...
+//
+// --plugin, --planner, --optimizer, --validation and --projector may be
+// repeated. Plugins are loaded with plugin::loadPlugin in the solver of
+// each problem, so that the planners they register can be benchmarked
+// against the built-in ones. Optimizer None does not optimize the paths.
+// By default, the types of a new ProblemSolver are used.
+//
+// A problem file has one statement per line. Lines starting with # are
+// ignored.
+//   robot ROOT_JOINT_TYPE URDF_FILE
+//   bound RANK LOWER UPPER
+//   box NAME SIZE_X SIZE_Y SIZE_Z X Y Z
+//   sphere NAME RADIUS X Y Z
+//   query INITIAL_CONFIGURATION GOAL_CONFIGURATION...
+// The URDF file is relative to the problem file. Bounds apply to the
+// configuration variables of the root joint. A query has one initial
+// configuration and one or more goal configurations. See the files in
+// tests/data/benchmark-problems.
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <hpp/fcl/collision_object.h>
+#include <hpp/fcl/shape/geometric_shapes.h>
+
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/urdf/util.hh>
+
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/path-optimizer.hh>
+#include <hpp/core/path-planner.hh>
+#include <hpp/core/path-validation/cached.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/planner-statistics.hh>
+#include <hpp/core/plugin.hh>
+#include <hpp/core/problem.hh>
+#include <hpp/core/problem-solver.hh>
+#include <hpp/core/roadmap.hh>
+#include <hpp/core/steering-method/cached.hh>
+
+using namespace hpp::core;
+using namespace hpp::pinocchio;
+
+typedef boost::chrono::steady_clock Clock_t;
+
+/// Type of a path validation or a path projector, and its tolerance
+struct Tool
+{
+  std::string name;
+  value_type tolerance;
+};
+
+struct Options
+{
+  size_type seeds;
+  size_type threads;
+  unsigned long int maxIterations;
+  value_type timeOut;
+  std::vector <std::string> plugins;
+  std::vector <std::string> planners;
+  std::vector <std::string> optimizers;
+  std::vector <Tool> validations;
+  std::vector <Tool> projectors;
+  std::vector <std::string> files;
+
+  Options () : seeds (10),
+  threads ((size_type) std::max (1u, boost::thread::hardware_concurrency ())),
+  maxIterations (10000), timeOut (10)
+  {}
+};
+
+/// Initial and goal configurations
+struct Query
+{
+  Configuration_t init;
+  std::vector <Configuration_t> goals;
+};
+
+/// Results of the runs of a combination of types on a problem
+struct Record
+{
+  std::string planner, optimizer, validation, projector;
+  size_type runs, successes;
+  /// Time of ProblemSolver::solve of each successful run (in seconds)
+  std::vector <value_type> times;
+  /// Length of the path of each successful run
+  std::vector <value_type> costs;
+  value_type iterations, nearestNeighborCalls, validationCalls,
+    optimizerIterations, validationCacheHits, validationCacheMisses,
+    steeringCacheHits, steeringCacheMisses;
+  /// Allocations and allocated bytes of each subsystem during the path
+  /// planning
+  value_type allocations [AllocationProfile::NUMBER_SUBSYSTEMS],
+    allocatedBytes [AllocationProfile::NUMBER_SUBSYSTEMS];
+  std::string lastError;
+
+  Record () : runs (0), successes (0), iterations (0),
+  nearestNeighborCalls (0), validationCalls (0), optimizerIterations (0),
+  validationCacheHits (0), validationCacheMisses (0), steeringCacheHits (0),
+  steeringCacheMisses (0)
+  {
+    for (int i = 0; i < AllocationProfile::NUMBER_SUBSYSTEMS; ++i) {
+      allocations [i] = 0;
+      allocatedBytes [i] = 0;
+    }
+  }
+};
+
+/// Problem read from a file and the results of its benchmark
+struct BenchmarkProblem
+{
+  std::string file;
+  ProblemSolverPtr_t solver;
+  std::vector <Query> queries;
+  std::vector <Record> records;
+  std::string error;
+};
+
+/// Directory of a file, with a trailing slash
+std::string directory (const std::string& file)
+{
+  const std::string::size_type slash (file.rfind ('/'));
+  return slash == std::string::npos ? "" : file.substr (0, slash + 1);
+}
+
+/// Read a problem file in the solver of the problem
+void read (BenchmarkProblem& problem)
+{
+  std::ifstream input (problem.file.c_str ());
+  if (!input)
+    throw std::runtime_error ("Cannot open " + problem.file);
+  const ProblemSolverPtr_t& ps (problem.solver);
+  DevicePtr_t robot;
+  std::string line;
+  for (size_type number = 1; std::getline (input, line); ++number) {
+    std::istringstream iss (line);
+    std::string keyword;
+    if (!(iss >> keyword) || keyword [0] == '#') continue;
+    std::ostringstream where;
+    where << problem.file << ":" << number << ": ";
+    if (keyword == "robot") {
+      std::string rootJoint, urdfFile;
+      if (!(iss >> rootJoint >> urdfFile))
+        throw std::runtime_error (where.str () + "expected a root joint "
+                                  "type and a URDF file.");
+      const std::string path (directory (problem.file) + urdfFile);
+      std::ifstream urdfInput (path.c_str ());
+      if (!urdfInput)
+        throw std::runtime_error (where.str () + "cannot open " + urdfFile);
+      std::ostringstream contents;
+      contents << urdfInput.rdbuf ();
+      robot = Device::create (urdfFile);
+      urdf::loadModelFromString (robot, 0, "", rootJoint, contents.str (),
+                                 "");
+      continue;
+    }
+    if (!robot)
+      throw std::runtime_error (where.str () + "the robot should be "
+                                "defined first.");
+    if (keyword == "bound") {
+      size_type rank;
+      value_type lower, upper;
+      if (!(iss >> rank >> lower >> upper))
+        throw std::runtime_error (where.str () + "expected a rank and two "
+                                  "bounds.");
+      robot->rootJoint ()->lowerBound (rank, lower);
+      robot->rootJoint ()->upperBound (rank, upper);
+      continue;
+    }
+    // The solver creates its problem, needed by the obstacles, when it
+    // gets the robot.
+    if (ps->robot () != robot) ps->robot (robot);
+    if (keyword == "box" || keyword == "sphere") {
+      std::string name;
+      value_type size [3];
+      vector3_t center;
+      iss >> name >> size [0];
+      if (keyword == "box") iss >> size [1] >> size [2];
+      iss >> center [0] >> center [1] >> center [2];
+      if (!iss)
+        throw std::runtime_error (where.str () + "expected a name, the size "
+                                  "and the center of the obstacle.");
+      hpp::fcl::CollisionGeometryPtr_t geometry;
+      if (keyword == "box")
+        geometry.reset (new hpp::fcl::Box (size [0], size [1], size [2]));
+      else
+        geometry.reset (new hpp::fcl::Sphere (size [0]));
+      FclCollisionObject object (geometry, matrix3_t::Identity (), center);
+      ps->addObstacle (name, object, true, true);
+    } else if (keyword == "query") {
+      std::vector <value_type> values;
+      value_type value;
+      while (iss >> value) values.push_back (value);
+      const size_type n (robot->configSize ());
+      const size_type size ((size_type) values.size ());
+      if (size < 2 * n || size % n != 0)
+        throw std::runtime_error (where.str () + "expected an initial and "
+                                  "goal configurations.");
+      Query query;
+      query.init = Eigen::Map <Configuration_t> (&values [0], n);
+      for (size_type i = n; i < size; i += n)
+        query.goals.push_back (Eigen::Map <Configuration_t>
+                               (&values [(std::size_t) i], n));
+      problem.queries.push_back (query);
+    } else {
+      throw std::runtime_error (where.str () + "unknown statement " +
+                                keyword);
+    }
+  }
+  if (!robot)
+    throw std::runtime_error (problem.file + ": no robot.");
+  if (ps->robot () != robot) ps->robot (robot);
+  if (problem.queries.empty ())
+    throw std::runtime_error (problem.file + ": no query.");
+}
+
+/// Add the counters of the last call to ProblemSolver::solve
+void addCounters (const ProblemSolverPtr_t& ps, Record& record)
+{
+  const PlannerStatistics& statistics (ps->plannerStatistics ());
+  record.iterations += (value_type) statistics.iterations;
+  record.nearestNeighborCalls += (value_type) statistics.count
+    (PlannerStatistics::NEAREST_NEIGHBOR);
+  record.validationCalls += (value_type) statistics.count
+    (PlannerStatistics::VALIDATION);
+  for (int i = 0; i < AllocationProfile::NUMBER_SUBSYSTEMS; ++i) {
+    const AllocationProfile::Counters& c (statistics.allocations
+                                          ((AllocationProfile::Subsystem) i));
+    record.allocations [i] += (value_type) c.allocations;
+    record.allocatedBytes [i] += (value_type) c.bytes;
+  }
+  if (record.optimizer != "None")
+    record.optimizerIterations += (value_type)
+      ps->optimizerStatistics (0).iterations;
+}
+
+/// Add the counters of the cache of the steering method, created by each
+/// call to ProblemSolver::solve
+void addSteeringCacheCounters (const ProblemSolverPtr_t& ps, Record& record)
+{
+  steeringMethod::CachedPtr_t steeringMethod
+    (HPP_DYNAMIC_PTR_CAST (steeringMethod::Cached,
+                           ps->problem ()->steeringMethod ()));
+  if (steeringMethod) {
+    record.steeringCacheHits += (value_type) steeringMethod->cacheHits ();
+    record.steeringCacheMisses += (value_type) steeringMethod->cacheMisses ();
+  }
+}
+
+/// Add the counters of the cache of the path validation, created for each
+/// combination of types
+void addValidationCacheCounters (const ProblemSolverPtr_t& ps,
+                                 Record& record)
+{
+  pathValidation::CachedPtr_t validation
+    (HPP_DYNAMIC_PTR_CAST (pathValidation::Cached,
+                           ps->problem ()->pathValidation ()));
+  if (validation) {
+    record.validationCacheHits += (value_type) validation->cacheHits ();
+    record.validationCacheMisses += (value_type) validation->cacheMisses ();
+  }
+}
+
+/// Solve the queries of a problem with a combination of types
+Record benchmark (BenchmarkProblem& problem, const Options& options,
+                  const std::string& planner, const std::string& optimizer,
+                  const Tool& validation, const Tool& projector)
+{
+  Record record;
+  record.planner = planner;
+  record.optimizer = optimizer;
+  record.validation = validation.name;
+  record.projector = projector.name;
+  const ProblemSolverPtr_t& ps (problem.solver);
+  try {
+    ps->pathPlannerType (planner);
+    ps->pathValidationType (validation.name, validation.tolerance);
+    ps->pathProjectorType (projector.name, projector.tolerance);
+    ps->clearPathOptimizers ();
+    if (optimizer != "None") ps->addPathOptimizer (optimizer);
+    ps->maxIterPathPlanning (options.maxIterations);
+    ps->setTimeOutPathPlanning (options.timeOut);
+  } catch (const std::exception& exc) {
+    record.lastError = exc.what ();
+    return record;
+  }
+  for (size_type seed = 0; seed < options.seeds; ++seed) {
+    for (std::size_t i = 0; i < problem.queries.size (); ++i) {
+      const Query& query (problem.queries [i]);
+      ++record.runs;
+      ps->problem ()->seed (seed);
+      ps->resetRoadmap ();
+      ps->initConfig (ConfigurationPtr_t (new Configuration_t (query.init)));
+      ps->resetGoalConfigs ();
+      for (std::size_t j = 0; j < query.goals.size (); ++j)
+        ps->addGoalConfig (ConfigurationPtr_t (new Configuration_t
+                                               (query.goals [j])));
+      try {
+        const Clock_t::time_point start (Clock_t::now ());
+        ps->solve ();
+        const value_type time (boost::chrono::duration <value_type>
+                               (Clock_t::now () - start).count ());
+        ++record.successes;
+        record.times.push_back (time);
+        record.costs.push_back (ps->paths ().back ()->length ());
+        addCounters (ps, record);
+      } catch (const std::exception& exc) {
+        record.lastError = exc.what ();
+      }
+      addSteeringCacheCounters (ps, record);
+      while (!ps->paths ().empty ()) ps->erasePath (0);
+    }
+  }
+  addValidationCacheCounters (ps, record);
+  return record;
+}
+
+/// Types of a solver, if none is given
+template <typename T>
+std::vector <T> orDefault (const std::vector <T>& types, const T& type)
+{
+  return types.empty () ? std::vector <T> (1, type) : types;
+}
+
+/// Solve a problem with every combination of types
+void benchmark (BenchmarkProblem& problem, const Options& options)
+{
+  const ProblemSolverPtr_t& ps (problem.solver);
+  Tool validation, projector;
+  validation.name = ps->pathValidationType (validation.tolerance);
+  projector.name = ps->pathProjectorType (projector.tolerance);
+  const std::vector <std::string> planners
+    (orDefault (options.planners, ps->pathPlannerType ()));
+  const std::vector <std::string> optimizers
+    (orDefault (options.optimizers, std::string ("None")));
+  const std::vector <Tool> validations
+    (orDefault (options.validations, validation));
+  const std::vector <Tool> projectors
+    (orDefault (options.projectors, projector));
+  for (std::size_t i = 0; i < planners.size (); ++i)
+    for (std::size_t j = 0; j < optimizers.size (); ++j)
+      for (std::size_t k = 0; k < validations.size (); ++k)
+        for (std::size_t l = 0; l < projectors.size (); ++l)
+          problem.records.push_back (benchmark (problem, options,
+                                                planners [i], optimizers [j],
+                                                validations [k],
+                                                projectors [l]));
+}
+
+/// Benchmark the problems not taken by another thread yet
+void work (std::vector <BenchmarkProblem>& problems, std::size_t& next,
+           boost::mutex& mutex, const Options& options)
+{
+  while (true) {
+    std::size_t i;
+    {
+      boost::mutex::scoped_lock lock (mutex);
+      if (next >= problems.size ()) return;
+      i = next++;
+    }
+    try {
+      benchmark (problems [i], options);
+    } catch (const std::exception& exc) {
+      problems [i].error = exc.what ();
+    }
+  }
+}
+
+/// Print the minimum, median, 90th percentile and maximum of values
+void printDistribution (std::vector <value_type> values)
+{
+  std::cout << "{";
+  if (!values.empty ()) {
+    std::sort (values.begin (), values.end ());
+    const std::size_t n (values.size () - 1);
+    std::cout << "\"min\": " << values.front ()
+              << ", \"median\": " << values [n / 2]
+              << ", \"p90\": " << values [(9 * n) / 10]
+              << ", \"max\": " << values.back ();
+  }
+  std::cout << "}";
+}
+
+void print (const std::string& file, const Record& r, bool first)
+{
+  if (!first) std::cout << "," << std::endl;
+  std::cout << "  {\"problem\": \"" << file
+            << "\", \"planner\": \"" << r.planner
+            << "\", \"optimizer\": \"" << r.optimizer
+            << "\", \"validation\": \"" << r.validation
+            << "\", \"projector\": \"" << r.projector
+            << "\", \"runs\": " << r.runs
+            << ", \"success_rate\": "
+            << (r.runs > 0 ? (value_type) r.successes / (value_type) r.runs
+                : 0)
+            << ", \"time\": ";
+  printDistribution (r.times);
+  std::cout << ", \"cost\": ";
+  printDistribution (r.costs);
+  std::cout << ", \"iterations\": " << r.iterations
+            << ", \"nearest_neighbor_calls\": " << r.nearestNeighborCalls
+            << ", \"validation_calls\": " << r.validationCalls
+            << ", \"optimizer_iterations\": " << r.optimizerIterations
+            << ", \"validation_cache_hits\": " << r.validationCacheHits
+            << ", \"validation_cache_misses\": " << r.validationCacheMisses
+            << ", \"steering_cache_hits\": " << r.steeringCacheHits
+            << ", \"steering_cache_misses\": " << r.steeringCacheMisses
+            << ", \"allocations\": {";
+  for (int i = 0; i < AllocationProfile::NUMBER_SUBSYSTEMS; ++i) {
+    const AllocationProfile::Subsystem subsystem
+      ((AllocationProfile::Subsystem) i);
+    std::cout << (i > 0 ? ", " : "") << "\""
+              << AllocationProfile::name (subsystem) << "\": {\"count\": "
+              << r.allocations [i] << ", \"bytes\": "
+              << r.allocatedBytes [i] << "}";
+  }
+  std::cout << "}}";
+  if (r.successes < r.runs)
+    std::cerr << file << ", " << r.planner << ", " << r.optimizer << ", "
+              << r.validation << ", " << r.projector << ": " << r.lastError
+              << std::endl;
+}
+
+/// Parse a type and its tolerance separated by a comma
+Tool parseTool (const std::string& value)
+{
+  const std::string::size_type comma (value.find (','));
+  if (comma == std::string::npos)
+    throw std::invalid_argument ("Expected NAME,TOLERANCE instead of " +
+                                 value);
+  Tool tool;
+  tool.name = value.substr (0, comma);
+  tool.tolerance = std::atof (value.substr (comma + 1).c_str ());
+  return tool;
+}
+
+Options parse (int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg (argv [i]);
+    if (arg.compare (0, 2, "--") != 0) {
+      options.files.push_back (arg);
+      continue;
+    }
+    if (i + 1 >= argc) {
+      std::ostringstream oss;
+      oss << "Missing value for option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+    const char* value (argv [++i]);
+    if (arg == "--seeds") options.seeds = (size_type) std::atof (value);
+    else if (arg == "--threads")
+      options.threads = (size_type) std::atof (value);
+    else if (arg == "--max-iterations")
+      options.maxIterations = (unsigned long int) std::atof (value);
+    else if (arg == "--time-out") options.timeOut = std::atof (value);
+    else if (arg == "--plugin") options.plugins.push_back (value);
+    else if (arg == "--planner") options.planners.push_back (value);
+    else if (arg == "--optimizer") options.optimizers.push_back (value);
+    else if (arg == "--validation")
+      options.validations.push_back (parseTool (value));
+    else if (arg == "--projector")
+      options.projectors.push_back (parseTool (value));
+    else {
+      std::ostringstream oss;
+      oss << "Unknown option " << arg;
+      throw std::invalid_argument (oss.str ());
+    }
+  }
+  if (options.seeds <= 0)
+    throw std::invalid_argument ("Number of seeds should be positive");
+  if (options.threads <= 0)
+    throw std::invalid_argument ("Number of threads should be positive");
+  if (options.files.empty ())
+    throw std::invalid_argument ("No problem file");
+  return options;
+}
+
+int main (int argc, char** argv)
+{
+  Options options;
+  std::vector <BenchmarkProblem> problems;
+  try {
+    options = parse (argc, argv);
+    // Plugins and problems are loaded before the threads start.
+    problems.resize (options.files.size ());
+    for (std::size_t i = 0; i < problems.size (); ++i) {
+      problems [i].file = options.files [i];
+      problems [i].solver = ProblemSolver::create ();
+      for (std::size_t j = 0; j < options.plugins.size (); ++j) {
+        if (!plugin::loadPlugin (options.plugins [j], problems [i].solver))
+          throw std::runtime_error ("Cannot load plugin " +
+                                    options.plugins [j]);
+      }
+      read (problems [i]);
+    }
+  } catch (const std::exception& exc) {
+    std::cerr << exc.what () << std::endl;
+    for (std::size_t i = 0; i < problems.size (); ++i)
+      delete problems [i].solver;
+    return 1;
+  }
+
+  // Nothing is counted unless the library replaces operator new.
+  AllocationProfile::enable ();
+  std::size_t next (0);
+  boost::mutex mutex;
+  boost::thread_group threads;
+  const size_type n (std::min ((size_type) problems.size (),
+                               options.threads));
+  for (size_type i = 0; i < n; ++i)
+    threads.create_thread (boost::bind (&work, boost::ref (problems),
+                                        boost::ref (next),
+                                        boost::ref (mutex),
+                                        boost::cref (options)));
+  threads.join_all ();
+
+  int status (0);
+  std::cout << "[" << std::endl;
+  bool first = true;
+  for (std::size_t i = 0; i < problems.size (); ++i) {
+    if (!problems [i].error.empty ()) {
+      std::cerr << problems [i].file << ": " << problems [i].error
+                << std::endl;
+      status = 1;
+    }
+    for (std::size_t j = 0; j < problems [i].records.size (); ++j) {
+      print (problems [i].file, problems [i].records [j], first);
+      first = false;
+    }
+  }
+  std::cout << std::endl << "]" << std::endl;
+
+  for (std::size_t i = 0; i < problems.size (); ++i)
+    delete problems [i].solver;
+  return status;
+}
@@ -20,6 +20,8 @@
 
 #include <hpp/core/configuration-shooter/uniform.hh>
 #include <hpp/core/configuration-shooter/gaussian.hh>
+#include <hpp/core/configuration-shooter/halton.hh>
+#include <hpp/core/random-generator.hh>
 
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/configuration.hh>
@@ -65,3 +67,86 @@ BOOST_AUTO_TEST_CASE (gaussian)
   cs->shoot(q);
   BOOST_CHECK(q.isApprox(cs->center()));
 }
+
+BOOST_AUTO_TEST_CASE (reproducible)
+{
+  using hpp::core::RandomGenerator;
+  using hpp::core::RandomGeneratorPtr_t;
+  DevicePtr_t robot = pin_test::makeDevice(pin_test::HumanoidSimple);
+
+  UniformPtr_t cs1 = Uniform::create (robot), cs2 = Uniform::create (robot);
+  RandomGeneratorPtr_t generator (RandomGenerator::create (42));
+  cs1->randomGenerator (generator->split (0));
+  cs2->randomGenerator (generator->split (0));
+  basic_test (cs1, robot);
+
+  // Streams only depend on the seed and on their index.
+  hpp::core::Configuration_t q1, q2;
+  cs1->randomGenerator (generator->split (0));
+  for (int i = 0; i < 10; ++i) {
+    cs1->shoot (q1);
+    cs2->shoot (q2);
+    BOOST_CHECK (q1 == q2);
+  }
+  cs2->randomGenerator (generator->split (1));
+  cs1->shoot (q1);
+  cs2->shoot (q2);
+  BOOST_CHECK (q1 != q2);
+
+  generator->seed (42);
+  const RandomGenerator::result_type first ((*generator) ());
+  generator->seed (42);
+  BOOST_CHECK_EQUAL ((*generator) (), first);
+  for (int i = 0; i < 100; ++i) {
+    const hpp::core::value_type u (generator->uniform ());
+    BOOST_CHECK (u >= 0 && u < 1);
+  }
+}
+
+template <typename CS_t>
+void block_test (CS_t cs, DevicePtr_t robot)
+{
+  hpp::core::matrix_t configurations (1, 20);
+  cs->shoot (configurations);
+  BOOST_CHECK_EQUAL (configurations.rows (), robot->configSize ());
+  BOOST_CHECK_EQUAL (configurations.cols (), 20);
+  for (hpp::core::size_type i = 0; i < configurations.cols (); ++i)
+  {
+    hpp::core::Configuration_t q (configurations.col (i));
+    hpp::pinocchio::ArrayXb unused(robot->numberDof());
+    BOOST_CHECK(!hpp::pinocchio::saturate(robot, q, unused));
+  }
+  BOOST_CHECK (configurations.col (0) != configurations.col (1));
+}
+
+BOOST_AUTO_TEST_CASE (block)
+{
+  DevicePtr_t robot = pin_test::makeDevice(pin_test::HumanoidSimple);
+
+  block_test (Uniform::create (robot), robot);
+  block_test (Gaussian::create (robot), robot);
+
+  // Vector space robot
+  DevicePtr_t arm = pin_test::makeDevice(pin_test::ManipulatorArm2);
+  block_test (Gaussian::create (arm), arm);
+}
+
+BOOST_AUTO_TEST_CASE (halton)
+{
+  DevicePtr_t robot = pin_test::makeDevice(pin_test::HumanoidSimple);
+  HaltonPtr_t cs1 = Halton::create (robot), cs2 = Halton::create (robot);
+
+  basic_test (cs1, robot);
+  BOOST_CHECK_EQUAL (cs1->index (), 11);
+
+  // The sequence is deterministic.
+  hpp::core::Configuration_t q1, q2;
+  cs1->index (1);
+  for (int i = 0; i < 10; ++i) {
+    cs1->shoot (q1);
+    cs2->shoot (q2);
+    BOOST_CHECK (q1 == q2);
+  }
+  cs2->shoot (q2);
+  BOOST_CHECK (q1 != q2);
+}
@@ -27,6 +27,7 @@
 #include <hpp/util/timer.hh>
 
 #include <hpp/core/fwd.hh>
+#include <hpp/core/config-projector.hh>
 #include <hpp/core/configuration-shooter/uniform.hh>
 #include <hpp/constraints/explicit/relative-pose.hh>
 #include <hpp/constraints/matrix-view.hh>
@@ -345,3 +346,34 @@ BOOST_AUTO_TEST_CASE (compare_to_relative_transform)
     EIGEN_IS_APPROX (J0, J1, test_precision);
   }
 }
+
+BOOST_AUTO_TEST_CASE (explicit_only_projection)
+{
+  DevicePtr_t robot = createRobot();
+  BOOST_REQUIRE (robot);
+  ConfigurationShooterPtr_t cs = configurationShooter::Uniform::create(robot);
+
+  JointPtr_t object2 = robot->getJointByName("obj2/root_joint");
+  JointPtr_t object1  = robot->getJointByName("obj1/root_joint");
+
+  matrix3_t I (matrix3_t::Identity ());
+  Transform3f M1inO1 (I, vector3_t (.1, 0, 0)),
+    M2inO2 (Transform3f::Identity());
+
+  ExplicitPtr_t enm (explicit_::RelativePose::create
+                     ("explicit_relative_transformation", robot, object1,
+                      object2, M1inO1, M2inO2, 6 * Equality));
+  ConfigProjectorPtr_t projector
+    (ConfigProjector::create (robot, "explicit", 1e-8, 20));
+  projector->add (enm);
+
+  // The explicit constraints are solved without jacobian.
+  robot->controlComputation (JOINT_POSITION);
+  for (int i = 0; i < NB_RANDOM_CONF; ++i) {
+    Configuration_t q (*cs->shoot ()), qout (q);
+    BOOST_CHECK (projector->apply (qout));
+    BOOST_CHECK (projector->isSatisfied (qout));
+    // The input configuration of the explicit function is not modified.
+    EIGEN_VECTOR_IS_APPROX (q.head<7> (), qout.head<7> (), test_precision);
+  }
+}
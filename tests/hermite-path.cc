@@ -172,4 +172,13 @@ BOOST_AUTO_TEST_CASE (hermitePath)
   std::cout << p->velocity (1).transpose() << std::endl;
   std::cout << bezier.velocity (1).transpose() << std::endl;
   std::cout << (*p) (1  , s).transpose() << std::endl;
+
+  // Length of the control polygon
+  BOOST_CHECK_CLOSE (p->legLength (0), v0.norm () / 3, 1e-8);
+  BOOST_CHECK_CLOSE (p->legLength (2), v2.norm () / 3, 1e-8);
+  BOOST_CHECK_CLOSE (p->hermiteLength (), p->legLength (0) + p->legLength (1)
+                     + p->legLength (2), 1e-8);
+  const value_type length (p->hermiteLength ());
+  p->computeHermiteLength (v0.norm () / 3, v2.norm () / 3);
+  BOOST_CHECK_CLOSE (p->hermiteLength (), length, 1e-8);
 }
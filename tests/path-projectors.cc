@@ -353,3 +353,123 @@ BOOST_AUTO_TEST_CASE_TEMPLATE (projectors, traits, test_types)
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE (global_parallel)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  ConstraintSetPtr_t c = createConstraints (dev);
+  DifferentiableFunctionPtr_t func = traits_circle::func (dev);
+  c->configProjector ()->add (Implicit::create (func,
+    ComparisonTypes_t(func->outputSpace()->nv(), EqualToZero)));
+  problem->steeringMethod(steeringMethod::Straight::create (*problem));
+  problem->steeringMethod ()->constraints (c);
+
+  for (int c = 0; c < 2; ++c) {
+    if (c == 0)
+      problem->setParameter ("PathProjection/HessianBound", Parameter((value_type)-1));
+    else
+      problem->setParameter ("PathProjection/HessianBound", Parameter(traits_circle::K));
+
+    pathProjector::GlobalPtr_t serial = pathProjector::Global::create
+      (*problem, traits_global::projection_step);
+    pathProjector::GlobalPtr_t parallel = pathProjector::Global::create
+      (*problem, traits_global::projection_step);
+    BOOST_CHECK_THROW (parallel->numberThreads (0), std::invalid_argument);
+    parallel->numberThreads (3);
+
+    Configuration_t q1 (dev->configSize());
+    Configuration_t q2 (dev->configSize());
+    for (int i = 0; i < traits_circle::NB_CONFS; ++i) {
+      traits_circle::make_conf (q1, q2, i);
+      PathPtr_t path = (*problem->steeringMethod ()) (q1,q2);
+
+      // The projection does not depend on the number of threads.
+      PathPtr_t p1, p2;
+      bool s1 (serial->apply (path, p1));
+      bool s2 (parallel->apply (path, p2));
+      BOOST_CHECK_EQUAL (s1, s2);
+      BOOST_CHECK_SMALL (p1->length () - p2->length (), 1e-10);
+      BOOST_CHECK ((p1->end () - p2->end ()).isZero (1e-10));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (projection_memory)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  ConstraintSetPtr_t c = createConstraints (dev);
+  DifferentiableFunctionPtr_t func = traits_circle::func (dev);
+  c->configProjector ()->add (Implicit::create (func,
+    ComparisonTypes_t(func->outputSpace()->nv(), EqualToZero)));
+  problem->steeringMethod(steeringMethod::Straight::create (*problem));
+  problem->steeringMethod ()->constraints (c);
+
+  pathProjector::ProgressivePtr_t projector = pathProjector::Progressive::create
+    (*problem, traits_progressive::projection_step);
+  projector->memorySize (2);
+  BOOST_CHECK_EQUAL (projector->memorySize (), 2);
+
+  Configuration_t q1 (dev->configSize());
+  Configuration_t q2 (dev->configSize());
+  for (int i = 0; i < 3; ++i) {
+    traits_circle::make_conf (q1, q2, i);
+    PathPtr_t path = (*problem->steeringMethod ()) (q1,q2);
+    PathPtr_t p1, p2;
+    bool s1 (projector->apply (path, p1));
+    // A new path between the same configurations reuses the projection.
+    path = (*problem->steeringMethod ()) (q1,q2);
+    bool s2 (projector->apply (path, p2));
+    BOOST_CHECK_EQUAL (s1, s2);
+    BOOST_REQUIRE (p1 && p2);
+    BOOST_CHECK (p1 != p2);
+    BOOST_CHECK_EQUAL (p1->length (), p2->length ());
+    BOOST_CHECK (p1->end () == p2->end ());
+  }
+}
+
+BOOST_AUTO_TEST_CASE (progressive_adaptive_step)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  ConstraintSetPtr_t c = createConstraints (dev);
+  DifferentiableFunctionPtr_t func = traits_parabola::func (dev);
+  c->configProjector ()->add (Implicit::create (func,
+    ComparisonTypes_t(func->outputSpace()->nv(), EqualToZero)));
+  problem->steeringMethod(steeringMethod::Straight::create (*problem));
+  problem->steeringMethod ()->constraints (c);
+
+  const value_type step (traits_progressive::projection_step);
+  pathProjector::ProgressivePtr_t fixed = pathProjector::Progressive::create
+    (*problem, step);
+  BOOST_CHECK (fixed->maxStep () < 0);
+  pathProjector::ProgressivePtr_t adaptive = pathProjector::Progressive::create
+    (*problem, step);
+  adaptive->maxStep (8 * step);
+
+  Configuration_t q1 (dev->configSize());
+  Configuration_t q2 (dev->configSize());
+  for (int i = 0; i < traits_parabola::NB_CONFS; ++i) {
+    traits_parabola::make_conf (q1, q2, i);
+    PathPtr_t path = (*problem->steeringMethod ()) (q1,q2);
+    PathPtr_t p1, p2;
+    bool s1 (fixed->apply (path, p1));
+    bool s2 (adaptive->apply (path, p2));
+    if (!s1) continue;
+    BOOST_CHECK (s2);
+    BOOST_REQUIRE (p2);
+    BOOST_CHECK ((p2->end () - path->end ()).isZero ());
+    bool success;
+    Configuration_t q ((*p2) (p2->timeRange ().first + p2->length () / 2,
+                              success));
+    BOOST_CHECK (success);
+    BOOST_CHECK (c->isSatisfied (q));
+  }
+}
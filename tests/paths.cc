@@ -28,8 +28,12 @@
 // the unit test framework
 // #include <boost/timer.hh>
 
+#include <hpp/core/binary-path.hh>
+#include <hpp/core/interpolated-path.hh>
+#include <hpp/core/path-vector.hh>
 #include <hpp/core/straight-path.hh>
 #include <hpp/core/subchain-path.hh>
+#include <hpp/core/path/spline.hh>
 
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
@@ -137,6 +141,43 @@ BOOST_AUTO_TEST_CASE (extracted)
   checkAt (p1, 1.0, p2, .25);
 }
 
+BOOST_AUTO_TEST_CASE (pathVectorRank)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  // Sub-paths i of length 1 from i to i+1.
+  PathVectorPtr_t pv = PathVector::create (dev->configSize (),
+                                           dev->numberDof ());
+  Configuration_t q1 (dev->configSize()), q2 (dev->configSize());
+  for (int i = 0; i < 4; ++i) {
+    q1 << i - 2; q2 << i - 1;
+    pv->appendPath ((*problem->steeringMethod()) (q1, q2));
+  }
+  BOOST_CHECK_EQUAL (pv->length (), 4);
+
+  value_type localParam;
+  // Forward and backward sweeps, and random access.
+  value_type params [] = { 0, 0.5, 1, 1.5, 2.5, 4, 3.5, 0.25, 2, 1.75 };
+  std::size_t ranks [] = { 0, 0,   0, 1,   2,   3, 3,   0,    1, 1 };
+  for (std::size_t k = 0; k < 10; ++k) {
+    BOOST_CHECK_EQUAL (pv->rankAtParam (params [k], localParam), ranks [k]);
+    BOOST_CHECK_CLOSE (localParam, params [k] - (value_type) ranks [k]
+                       + pv->pathAtRank (ranks [k])->timeRange ().first,
+                       1e-8);
+  }
+  checkAt (pv->pathAtRank (2), 0.5, pv, 2.5);
+
+  // Beyond the end, the parameter is clamped to the end of the last path.
+  BOOST_CHECK_EQUAL (pv->rankAtParam (5, localParam), 3);
+  BOOST_CHECK_EQUAL (localParam, pv->pathAtRank (3)->timeRange ().second);
+
+  // Copies keep the index.
+  PathVectorPtr_t copy = HPP_DYNAMIC_PTR_CAST (PathVector, pv->copy ());
+  BOOST_CHECK_EQUAL (copy->rankAtParam (2.5, localParam), 2);
+}
+
 BOOST_AUTO_TEST_CASE (subchain)
 {
   DevicePtr_t dev = createRobot2(); // 10 translations
@@ -167,4 +208,221 @@ BOOST_AUTO_TEST_CASE (subchain)
   (*p2) (q, p1->length() * 0.5);
   BOOST_CHECK(q.head<3>().isApprox( Configuration_t::Ones(3) * 0.5));
   BOOST_CHECK(q.tail<3>().isApprox(-Configuration_t::Ones(3) * 0.5));
+
+  // A subchain of a subchain selects the parameters of the original path.
+  segments_t last;
+  last.push_back(segment_t (2,2));
+  PathPtr_t p3 = SubchainPath::create(p2, last, last);
+  BOOST_CHECK(p3->outputSize() == 2);
+  Configuration_t r (p3->outputSize());
+  (*p3) (r, p1->length());
+  BOOST_CHECK_CLOSE (r [0] + 2, 3, 1e-8);
+  BOOST_CHECK_CLOSE (r [1] + 2, 1, 1e-8);
+
+  // Reversed windows that do not start at 0, extracted again.
+  PathPtr_t e1 = p2->extract (Pair_t (0.75 * p1->length(),
+                                      0.25 * p1->length()));
+  PathPtr_t e2 = e1->extract (Pair_t (0.5 * p1->length(),
+                                      0.25 * p1->length()));
+  checkAt (p2, 0.25 * p1->length(), e1, 0.75 * p1->length());
+  // Reversing a reversed window runs forward again.
+  checkAt (p2, 0.5 * p1->length(), e2, 0.5 * p1->length());
+  checkAt (p2, 0.75 * p1->length(), e2, 0.75 * p1->length());
+}
+
+BOOST_AUTO_TEST_CASE (batchEvaluation)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  PathVectorPtr_t pv = PathVector::create (dev->configSize (),
+                                           dev->numberDof ());
+  Configuration_t q1 (dev->configSize()), q2 (dev->configSize());
+  q1 << -1; q2 << 1;
+  pv->appendPath ((*problem->steeringMethod()) (q1, q2));
+  q1 << 1; q2 << 0;
+  pv->appendPath ((*problem->steeringMethod()) (q1, q2));
+
+  vector_t times (7);
+  times << 0, 0.5, 1.75, 2, 2.5, 3, 1;
+  matrix_t configs (dev->configSize (), times.size ()),
+           velocities (dev->numberDof (), times.size ());
+  BOOST_CHECK_EQUAL (pv->eval (times, configs), times.size ());
+  pv->derivative (times, velocities, 1);
+
+  Configuration_t q (dev->configSize ());
+  vector_t v (dev->numberDof ());
+  for (size_type i = 0; i < times.size (); ++i) {
+    BOOST_REQUIRE ((*pv) (q, times [i]));
+    BOOST_CHECK (configs.col (i).isApprox (q));
+    pv->derivative (v, times [i], 1);
+    BOOST_CHECK (velocities.col (i).isApprox (v));
+  }
+}
+
+BOOST_AUTO_TEST_CASE (nestedPathVector)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  PathVectorPtr_t inner = PathVector::create (dev->configSize (),
+                                              dev->numberDof ()),
+                  outer = PathVector::create (dev->configSize (),
+                                              dev->numberDof ());
+  Configuration_t q1 (dev->configSize()), q2 (dev->configSize());
+  q1 << 0; q2 << 1;
+  inner->appendPath ((*problem->steeringMethod()) (q1, q2));
+  q1 << 1; q2 << 2;
+  inner->appendPath ((*problem->steeringMethod()) (q1, q2));
+  outer->appendPath (inner);
+  outer->appendPath (inner->extract (Pair_t (0.5, 1.5)));
+
+  // Sub-path vectors are replaced by their sub-paths.
+  BOOST_CHECK_EQUAL (outer->numberPaths (), 4);
+  for (std::size_t i = 0; i < outer->numberPaths (); ++i)
+    BOOST_CHECK (!HPP_DYNAMIC_PTR_CAST (PathVector, outer->pathAtRank (i)));
+  BOOST_CHECK_CLOSE (outer->length (), 3, 1e-8);
+  checkAt (inner, 1.25, outer, 2.75);
+}
+
+BOOST_AUTO_TEST_CASE (interpolatedPath)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+
+  Configuration_t q1 (dev->configSize()), q2 (dev->configSize()),
+                  q (dev->configSize());
+  q1 << 0; q2 << 0;
+  InterpolatedPathPtr_t ip = InterpolatedPath::create (dev, q1, q2, 4);
+  // Points inserted out of order, the second one at time 1 is ignored.
+  q << 2; ip->insert (3, q);
+  q << 1; ip->insert (1, q);
+  q << 3; ip->insert (1, q);
+  BOOST_CHECK_EQUAL (ip->numberInterpolationPoints (), 4);
+  BOOST_CHECK_EQUAL (ip->interpolationTimes () [1], 1);
+  BOOST_CHECK_EQUAL (ip->interpolationPoints ().size (), 4);
+
+  value_type times [] = { 0, 0.5, 1, 2, 3, 3.5, 4 };
+  value_type values [] = { 0, 0.5, 1, 1.5, 2, 1, 0 };
+  for (std::size_t i = 0; i < 7; ++i) {
+    BOOST_REQUIRE ((*ip) (q, times [i]));
+    BOOST_CHECK_CLOSE (q [0] + 1, values [i] + 1, 1e-8);
+  }
+
+  vector_t v (dev->numberDof ());
+  ip->derivative (v, 0.5, 1);
+  BOOST_CHECK_CLOSE (v [0], 1, 1e-8);
+  ip->derivative (v, 3, 1);
+  BOOST_CHECK_CLOSE (v [0], -2, 1e-8);
+
+  PathPtr_t reversed = ip->reverse ();
+  checkAt (ip, 0.5, reversed, 3.5);
+  checkAt (ip, 2, reversed, 2);
+  PathPtr_t extracted = ip->extract (Pair_t (0.5, 3.5));
+  checkAt (ip, 2, extracted, 1.5);
+  checkAt (ip, 3, extracted, 2.5);
+}
+
+BOOST_AUTO_TEST_CASE (interpolatedPathCopyOnWrite)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+
+  Configuration_t q1 (dev->configSize()), q2 (dev->configSize()),
+                  q (dev->configSize());
+  q1 << 0; q2 << 2;
+  InterpolatedPathPtr_t ip = InterpolatedPath::create (dev, q1, q2, 2);
+  InterpolatedPathPtr_t copy =
+    HPP_DYNAMIC_PTR_CAST (InterpolatedPath, ip->copy ());
+  BOOST_REQUIRE (copy);
+  // Copies share their points until one of them is modified.
+  BOOST_CHECK_EQUAL (&ip->interpolationTimes (), &copy->interpolationTimes ());
+
+  q << 0; copy->insert (1, q);
+  BOOST_CHECK_EQUAL (ip->numberInterpolationPoints (), 2);
+  BOOST_CHECK_EQUAL (copy->numberInterpolationPoints (), 3);
+  BOOST_REQUIRE ((*ip) (q, 1));
+  BOOST_CHECK_CLOSE (q [0], 1, 1e-8);
+  BOOST_REQUIRE ((*copy) (q, 1));
+  BOOST_CHECK_SMALL (q [0], 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE (reversedView)
+{
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+
+  Configuration_t q1 (dev->configSize()), q2 (dev->configSize()),
+                  q (dev->configSize());
+  q1 << 0; q2 << 0;
+  InterpolatedPathPtr_t ip = InterpolatedPath::create (dev, q1, q2, 4);
+  q << 2; ip->insert (3, q);
+  q << 1; ip->insert (1, q);
+
+  // The view runs the path backward without copying its points.
+  PathPtr_t view = ip->reversedView ();
+  BOOST_CHECK (!HPP_DYNAMIC_PTR_CAST (InterpolatedPath, view));
+  BOOST_CHECK_EQUAL (view->length (), ip->length ());
+  checkAt (ip, 0.5, view, 3.5);
+  checkAt (ip, 2, view, 2);
+  checkAt (ip, 4, view, 0);
+  vector_t v (dev->numberDof ());
+  view->derivative (v, 0.5, 1);
+  BOOST_CHECK_CLOSE (v [0], 2, 1e-8);
+
+  // Reversing the view gives back the path.
+  BOOST_CHECK (view->reversedView () == ip);
+  // Windows keep the parameter of the path they are extracted from.
+  PathPtr_t extracted = view->extract (Pair_t (1, 3));
+  checkAt (ip, 3, extracted, 1);
+  checkAt (ip, 1, extracted, 3);
+  PathPtr_t forward = extracted->reversedView ();
+  BOOST_CHECK (forward != ip);
+  checkAt (ip, 1, forward, 1);
+  checkAt (ip, 2.5, forward, 2.5);
+}
+
+BOOST_AUTO_TEST_CASE (binaryPath)
+{
+  typedef path::Spline <path::BernsteinBasis, 3> Spline_t;
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+
+  PathVectorPtr_t pv = PathVector::create (dev->configSize (),
+                                           dev->numberDof ());
+  Configuration_t q1 (dev->configSize()), q2 (dev->configSize()),
+                  q (dev->configSize());
+  q1 << -1; q2 << 1;
+  pv->appendPath (StraightPath::create (dev, q1, q2, 2));
+  Spline_t::Ptr_t spline (Spline_t::create (dev, interval_t (0, 2),
+                                            ConstraintSetPtr_t ()));
+  Spline_t::ParameterMatrix_t parameters (4, dev->numberDof ());
+  parameters << 0, 1, 3, 2;
+  spline->base (q2);
+  spline->parameters (parameters);
+  pv->appendPath (spline);
+  q1 << 3; q2 << 2;
+  InterpolatedPathPtr_t ip = InterpolatedPath::create (dev, q1, q2, 2);
+  q << 1; ip->insert (1, q);
+  pv->appendPath (ip);
+
+  std::string buffer;
+  BinaryPath::write (pv, 0.5, buffer);
+  PathVectorPtr_t read (BinaryPath::read (buffer.data (), buffer.size (),
+                                          dev));
+  // The interpolated path is written as 5 waypoints, read as 4 straight
+  // paths.
+  BOOST_CHECK_EQUAL (read->numberPaths (), 6);
+  BOOST_CHECK_CLOSE (read->length (), pv->length (), 1e-8);
+  for (value_type t = 0; t <= pv->length (); t += 0.25)
+    checkAt (pv, t, read, t);
+
+  BOOST_CHECK_THROW (BinaryPath::write (pv, 0, buffer),
+                     std::invalid_argument);
+  BOOST_CHECK_THROW (BinaryPath::read (buffer.data (), 8, dev),
+                     std::runtime_error);
+  BOOST_CHECK_THROW (BinaryPath::read (buffer.data (), buffer.size (),
+                                       createRobot2 ()), std::runtime_error);
 }
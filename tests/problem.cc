@@ -18,16 +18,66 @@
 #include <pinocchio/fwd.hpp>
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <hpp/fcl/collision_object.h>
 #include <hpp/fcl/shape/geometric_shapes.h>
 
+#include <hpp/pinocchio/configuration.hh>
 #include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/liegroup.hh>
 #include <hpp/pinocchio/simple-device.hh>
 #include <hpp/pinocchio/urdf/util.hh>
 
+#include <hpp/core/allocation-profile.hh>
+#include <hpp/core/async-solve.hh>
+#include <hpp/core/batch-collision-validation.hh>
+#include <hpp/core/bi-rrt-planner.hh>
+#include <hpp/core/collision-validation.hh>
+#include <hpp/core/collision-validation-report.hh>
+#include <hpp/core/configuration-shooter/uniform.hh>
+#include <hpp/core/constraint-set.hh>
+#include <hpp/core/deadline.hh>
+#include <hpp/core/diffusing-planner.hh>
+#include <hpp/core/distance/dubins.hh>
+#include <hpp/core/distance/reeds-shepp.hh>
+#include <hpp/core/distance/reeds-shepp-table.hh>
+#include <hpp/core/edge.hh>
+#include <hpp/core/hierarchical-roadmap.hh>
+#include <hpp/core/executor.hh>
+#include <hpp/core/node.hh>
+#include <hpp/core/occupancy-cache.hh>
+#include <hpp/core/path-optimization/multi-start.hh>
+#include <hpp/core/path-optimization/partial-shortcut.hh>
+#include <hpp/core/path-optimization/random-shortcut.hh>
+#include <hpp/core/path-optimization/simple-shortcut.hh>
+#include <hpp/core/path-planner/bi-rrt-star.hh>
+#include <hpp/core/path-validation.hh>
+#include <hpp/core/path-validation/cached.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/plan-and-optimize.hh>
+#include <hpp/core/planner-statistics.hh>
+#include <hpp/core/planning-service.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/problem-solver.hh>
+#include <hpp/core/problem-target/task-target.hh>
 #include <hpp/core/roadmap.hh>
+#include <hpp/core/steering-method.hh>
+#include <hpp/core/steering-method/cached.hh>
+#include <hpp/core/straight-path.hh>
+#include <hpp/core/trace.hh>
+#include <hpp/core/weighed-distance.hh>
 
 using namespace hpp::core;
 using namespace hpp::pinocchio;
@@ -52,7 +102,7 @@ BOOST_AUTO_TEST_CASE (memory_deallocation)
   BOOST_CHECK_MESSAGE( !roadmap .lock(), "Roadmap was not deleted");
 }
 
-void pointMassProblem (const char* steeringMethod,
+ProblemSolverPtr_t pointMassProblemSolver (const char* steeringMethod,
     const char* distance,
     const char* pathValidation, value_type tolerance)
 {
@@ -90,12 +140,51 @@ void pointMassProblem (const char* steeringMethod,
 
   ps->initConfig (qinit);
   ps->addGoalConfig (qgoal);
+  return ps;
+}
+
+void pointMassProblem (const char* steeringMethod,
+    const char* distance,
+    const char* pathValidation, value_type tolerance)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver (steeringMethod, distance,
+      pathValidation, tolerance);
 
   ps->solve ();
 
   BOOST_CHECK (ps->roadmap()->nodes().size() > 2);
   BOOST_TEST_MESSAGE ("Solved the problem with " << ps->roadmap()->nodes().size()
       << " nodes.");
+
+  // The obstacle prevents the direct path, and the diffusing planner shoots
+  // one configuration per iteration.
+  const PlannerStatistics& stats (ps->plannerStatistics ());
+  BOOST_CHECK (stats.iterations > 0);
+  BOOST_CHECK_EQUAL ((unsigned long int)
+      stats.count (PlannerStatistics::SAMPLING), stats.iterations);
+  BOOST_CHECK (stats.count (PlannerStatistics::VALIDATION) > 0);
+  BOOST_CHECK (stats.totalTime >= stats.time (PlannerStatistics::VALIDATION));
+  BOOST_CHECK_EQUAL ((unsigned long int) stats.samples (), stats.iterations);
+  BOOST_TEST_MESSAGE (stats);
+}
+
+BOOST_AUTO_TEST_CASE (samplingRejections)
+{
+  PlannerStatistics stats;
+  stats.sampled (4);
+  stats.reject (PlannerStatistics::PROJECTION_FAILURE);
+  stats.reject (ValidationReportPtr_t (new CollisionValidationReport));
+  stats.reject (ValidationReportPtr_t ());
+  PlannerStatistics other (stats);
+  stats.addSampling (other);
+  BOOST_CHECK_EQUAL (stats.samples (), 8);
+  BOOST_CHECK_EQUAL (stats.rejections (PlannerStatistics::PROJECTION_FAILURE), 2);
+  BOOST_CHECK_EQUAL (stats.rejections (PlannerStatistics::COLLISION), 2);
+  BOOST_CHECK_EQUAL (stats.rejections (PlannerStatistics::OTHER_VALIDATION), 2);
+  BOOST_CHECK_EQUAL (stats.rejections (PlannerStatistics::JOINT_BOUNDS), 0);
+  stats.reset ();
+  BOOST_CHECK_EQUAL (stats.samples (), 0);
+  BOOST_CHECK_EQUAL (stats.rejections (PlannerStatistics::COLLISION), 0);
 }
 
 void carLikeProblem (const char* steeringMethod,
@@ -143,14 +232,1305 @@ BOOST_AUTO_TEST_CASE (pointMass)
   pointMassProblem ("Straight", "Weighed", "Dichotomy"  , 0   );
 }
 
+BOOST_AUTO_TEST_CASE (batchedDiffusingPlanner)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->solve ();
+
+  // Solve again from an empty roadmap with 4 samples per step.
+  DiffusingPlannerPtr_t planner (HPP_DYNAMIC_PTR_CAST (DiffusingPlanner,
+        ps->pathPlanner ()));
+  BOOST_REQUIRE (planner);
+  BOOST_CHECK_THROW (planner->batch (0), std::invalid_argument);
+  BOOST_CHECK_THROW (planner->batch (4, 2), std::invalid_argument);
+  planner->batch (4);
+  ps->roadmap ()->clear ();
+  PathVectorPtr_t path (planner->solve ());
+  BOOST_REQUIRE (path);
+  BOOST_CHECK (ps->roadmap()->nodes().size() > 2);
+  BOOST_CHECK_EQUAL (planner->statistics ().count (PlannerStatistics::SAMPLING),
+      4 * (size_type) planner->statistics ().iterations);
+  BOOST_CHECK (path->initial () == *ps->initConfig ());
+}
+
+BOOST_AUTO_TEST_CASE (adaptiveBiRRTPlanner)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->maxIterPathPlanning (1000);
+  ps->pathPlannerType ("BiRRTPlanner");
+  ps->problem ()->setParameter ("BiRRTPlanner/extensionStepLength",
+                                Parameter (0.5));
+  ps->problem ()->setParameter ("BiRRTPlanner/greedyConnection",
+                                Parameter (true));
+  ps->solve ();
+
+  BiRRTPlannerPtr_t planner (HPP_DYNAMIC_PTR_CAST (BiRRTPlanner,
+        ps->pathPlanner ()));
+  BOOST_REQUIRE (planner);
+  BOOST_CHECK (planner->stepLength () >= 0.5 / 16);
+  BOOST_CHECK (planner->stepLength () <= 0.5 * 16);
+  BOOST_CHECK (ps->roadmap ()->pathExists ());
+  // The extensions are truncated, hence the roadmap has intermediate nodes.
+  BOOST_CHECK (ps->roadmap ()->nodes ().size () > 2);
+  delete ps;
+}
+
+BOOST_AUTO_TEST_CASE (hierarchicalRoadmap)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->solve ();
+  ProblemPtr_t problem (ps->problem ());
+  BOOST_CHECK_THROW (HierarchicalRoadmap::create (*problem, 0),
+                     std::invalid_argument);
+
+  // Regions of 2 by 2 over the base bounds [-10, 10]
+  HierarchicalRoadmapPtr_t hr (HierarchicalRoadmap::create (*problem, 2));
+  Configuration_t q1 (Configuration_t::Zero (3)), q2 (q1);
+  q1 << 1, 1, 0;
+  q2 << -3, 1, 0;
+  BOOST_CHECK (hr->region (q2) == HierarchicalRoadmap::Region_t (-2, 0));
+  const HierarchicalRoadmap::Regions_t route
+    (hr->route (hr->region (q1), hr->region (q2)));
+  BOOST_REQUIRE_EQUAL (route.size (), 3);
+  BOOST_CHECK (route [1] == HierarchicalRoadmap::Region_t (-1, 0));
+  // Regions out of the bounds are not routed.
+  BOOST_CHECK (hr->route (hr->region (q1),
+                          HierarchicalRoadmap::Region_t (6, 0)).empty ());
+
+  PathVectorPtr_t path (hr->solve (q1, q2));
+  BOOST_REQUIRE (path);
+  BOOST_CHECK (path->initial () == q1);
+  BOOST_CHECK (path->end () == q2);
+  // Only the regions on the routes are refined.
+  BOOST_CHECK (hr->numberRegions () >= route.size ());
+  BOOST_CHECK (hr->numberRegions () < 100);
+
+  // A new query far away clears the fine roadmap of the first one.
+  hr->maxRegions (4);
+  Configuration_t q3 (q1), q4 (q1);
+  q3 << 7, -7, 0;
+  q4 << 9, -7, 0;
+  BOOST_CHECK (hr->solve (q3, q4));
+  BOOST_CHECK (hr->numberRegions () <= 4);
+  delete ps;
+}
+
+BOOST_AUTO_TEST_CASE (kPrmStarDensification)
+{
+  // The box lies between the initial and goal configurations, a roadmap
+  // of these two nodes cannot solve the problem.
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->maxIterPathPlanning (100000);
+  ps->pathPlannerType ("kPRM*");
+  ps->problem ()->setParameter ("kPRM*/numberOfNodes",
+                                Parameter ((size_type) 2));
+  BOOST_CHECK_THROW (ps->solve (), std::runtime_error);
+  delete ps;
+
+  // Batches of 20 nodes are added until the problem is solved.
+  ps = pointMassProblemSolver ("Straight", "Weighed", "Discretized", 0.05);
+  ps->maxIterPathPlanning (100000);
+  ps->pathPlannerType ("kPRM*");
+  ps->problem ()->setParameter ("kPRM*/numberOfNodes",
+                                Parameter ((size_type) 2));
+  ps->problem ()->setParameter ("kPRM*/densification",
+                                Parameter ((size_type) 20));
+  ps->solve ();
+  BOOST_REQUIRE (!ps->paths ().empty ());
+  const std::size_t n (ps->roadmap ()->nodes ().size ());
+  BOOST_CHECK (n > 2);
+  BOOST_CHECK_EQUAL ((n - 2) % 20, 0);
+  delete ps;
+}
+
+BOOST_AUTO_TEST_CASE (lazyGoalConnection)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ConfigurationPtr_t q1 (new Configuration_t (Configuration_t::Zero (3)));
+  ConfigurationPtr_t q2 (new Configuration_t (Configuration_t::Zero (3)));
+  *q1 << 1, 0, 0;
+  *q2 << 3, 0, 0;
+  ps->addGoalConfig (q1);
+  ps->addGoalConfig (q2);
+  ps->solve ();
+  PathPlannerPtr_t planner (ps->pathPlanner ());
+
+  // All the connections between the initial and goal nodes are validated.
+  ps->roadmap ()->clear ();
+  planner->startSolve ();
+  planner->tryConnectInitAndGoals ();
+  const std::size_t n (ps->roadmap ()->edges ().size ());
+  BOOST_CHECK (n > 1);
+
+  // The shortest connection solves the problem.
+  ps->problem ()->setParameter ("PathPlanner/lazyGoalConnection",
+                                Parameter (true));
+  ps->roadmap ()->clear ();
+  planner->startSolve ();
+  planner->tryConnectInitAndGoals ();
+  BOOST_CHECK_EQUAL (ps->roadmap ()->edges ().size (), 1);
+  BOOST_CHECK (ps->problem ()->target ()->reached (ps->roadmap ()));
+
+  // Without stopping when the problem is solved, all are validated.
+  planner->stopWhenProblemIsSolved (false);
+  ps->roadmap ()->clear ();
+  planner->startSolve ();
+  planner->tryConnectInitAndGoals ();
+  BOOST_CHECK_EQUAL (ps->roadmap ()->edges ().size (), n);
+  delete ps;
+}
+
+BOOST_AUTO_TEST_CASE (resetQuery)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ProblemPtr_t problem (ps->problem ());
+  ps->solve ();
+  SteeringMethodPtr_t sm (problem->steeringMethod ());
+  ConfigurationShooterPtr_t shooter (problem->configurationShooter ());
+  PathValidationPtr_t pathValidation (problem->pathValidation ());
+
+  ps->resetQuery ();
+  BOOST_CHECK (!ps->initConfig ());
+  BOOST_CHECK (ps->goalConfigs ().empty ());
+  BOOST_CHECK (!problem->initConfig ());
+  BOOST_CHECK (ps->roadmap ()->nodes ().empty ());
+
+  ConfigurationPtr_t qinit (new Configuration_t (Configuration_t::Zero (3)));
+  ConfigurationPtr_t qgoal (new Configuration_t (Configuration_t::Zero (3)));
+  *qinit << -4, 0, 0;
+  *qgoal << 0, 1, 0;
+  ps->initConfig (qinit);
+  ps->addGoalConfig (qgoal);
+  ps->solve ();
+  BOOST_CHECK (ps->problem () == problem);
+  BOOST_CHECK (problem->steeringMethod () == sm);
+  BOOST_CHECK (problem->configurationShooter () == shooter);
+  BOOST_CHECK (problem->pathValidation () == pathValidation);
+  BOOST_CHECK_EQUAL (problem->goalConfigs ().size (), 1);
+  PathVectorPtr_t path (ps->paths ().back ());
+  BOOST_CHECK (path->initial () == *qinit);
+  BOOST_CHECK (path->end () == *qgoal);
+
+  // Without a call to resetQuery, solve builds the steering method again.
+  ps->solve ();
+  BOOST_CHECK (problem->steeringMethod () != sm);
+}
+
+BOOST_AUTO_TEST_CASE (cachedPathValidation)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ProblemPtr_t problem (ps->problem ());
+  DevicePtr_t robot (problem->robot ());
+  problem->setParameter ("PathValidation/cacheSize",
+                         Parameter ((size_type) 16));
+  ps->pathValidationType ("Discretized", 0.05);
+  pathValidation::CachedPtr_t cached (HPP_DYNAMIC_PTR_CAST
+      (pathValidation::Cached, problem->pathValidation ()));
+  BOOST_REQUIRE (cached);
+  BOOST_CHECK_THROW (pathValidation::Cached::create
+                     (cached->validation (), 0), std::invalid_argument);
+
+  // The box is centered at (-2, 0, 0).
+  Configuration_t q1 (Configuration_t::Zero (3)), q2 (q1);
+  q2 [0] = -4;
+  PathPtr_t validPart, cachedPart;
+  PathValidationReportPtr_t report, cachedReport;
+  BOOST_CHECK (!cached->validate (StraightPath::create (robot, q1, q2, 4),
+                                  false, validPart, report));
+  BOOST_CHECK (report);
+  PathPtr_t path (StraightPath::create (robot, q1, q2, 4));
+  BOOST_CHECK (!cached->validate (path, false, cachedPart, cachedReport));
+  BOOST_CHECK_EQUAL (cached->cacheMisses (), 1);
+  BOOST_CHECK_EQUAL (cached->cacheHits (), 1);
+  BOOST_CHECK_EQUAL (cachedReport, report);
+  BOOST_CHECK_CLOSE (cachedPart->length (), validPart->length (), 1e-10);
+  BOOST_CHECK (cachedPart->initial () == q1);
+  value_type lastValidTime;
+  BOOST_CHECK (!cached->isValid (path, false, lastValidTime));
+  BOOST_CHECK_CLOSE (lastValidTime, validPart->length (), 1e-10);
+  BOOST_CHECK_EQUAL (cached->cacheHits (), 2);
+
+  // Moving the obstacle clears the cache.
+  ps->moveObstacle ("box", Transform3f (matrix3_t::Identity (),
+                                        vector3_t (0, 5, 0)));
+  BOOST_CHECK (cached->validate (path, false, cachedPart, cachedReport));
+  BOOST_CHECK_EQUAL (cachedPart, path);
+  BOOST_CHECK_EQUAL (cached->cacheMisses (), 2);
+}
+
+BOOST_AUTO_TEST_CASE (cachedSteeringMethod)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ProblemPtr_t problem (ps->problem ());
+  problem->setParameter ("SteeringMethod/cacheSize",
+                         Parameter ((size_type) 2));
+  ps->steeringMethodType ("Straight");
+  steeringMethod::CachedPtr_t cached (HPP_DYNAMIC_PTR_CAST
+      (steeringMethod::Cached, problem->steeringMethod ()));
+  BOOST_REQUIRE (cached);
+  BOOST_CHECK_THROW (steeringMethod::Cached::create
+                     (cached->steeringMethod (), 0), std::invalid_argument);
+
+  Configuration_t q1 (Configuration_t::Zero (3)), q2 (q1), q3 (q1);
+  q2 [0] = -4;
+  q3 [1] = 1;
+  PathPtr_t path ((*cached) (q1, q2));
+  BOOST_REQUIRE (path);
+  PathPtr_t again ((*cached) (q1, q2));
+  BOOST_REQUIRE (again);
+  BOOST_CHECK_EQUAL (cached->cacheMisses (), 1);
+  BOOST_CHECK_EQUAL (cached->cacheHits (), 1);
+  // Callers never share a path.
+  BOOST_CHECK (again != path);
+  BOOST_CHECK (again->initial () == q1);
+  BOOST_CHECK (again->end () == q2);
+  BOOST_CHECK_CLOSE (again->length (), path->length (), 1e-10);
+
+  // The batch interface goes through the cache.
+  matrix_t targets (3, 2);
+  targets.col (0) = q2;
+  targets.col (1) = q3;
+  std::vector <PathPtr_t> paths;
+  cached->steer (q1, targets, paths);
+  BOOST_REQUIRE_EQUAL (paths.size (), (std::size_t) 2);
+  BOOST_REQUIRE (paths [1]);
+  BOOST_CHECK (paths [1]->end () == q3);
+  BOOST_CHECK_EQUAL (cached->cacheHits (), 2);
+  BOOST_CHECK_EQUAL (cached->cacheMisses (), 2);
+
+  // The least recently used path is discarded.
+  cached->steer (q2, q3);
+  BOOST_CHECK_EQUAL (cached->cacheMisses (), 3);
+  (*cached) (q1, q3);
+  BOOST_CHECK_EQUAL (cached->cacheHits (), 3);
+  (*cached) (q1, q2);
+  BOOST_CHECK_EQUAL (cached->cacheMisses (), 4);
+
+  // Copies do not share the cache.
+  SteeringMethodPtr_t copy (cached->copy ());
+  (*copy) (q1, q2);
+  BOOST_CHECK_EQUAL (HPP_DYNAMIC_PTR_CAST (steeringMethod::Cached, copy)
+                     ->cacheMisses (), 1);
+  delete ps;
+}
+
+BOOST_AUTO_TEST_CASE (collisionValidationBatch)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  DevicePtr_t robot (ps->robot ());
+  CollisionValidationPtr_t validation (CollisionValidation::create (robot));
+  validation->addObstacle (ps->obstacle ("box"));
+  BatchCollisionValidationPtr_t batch
+    (BatchCollisionValidation::create (robot));
+  batch->addObstacle (ps->obstacle ("box"));
+  batch->numberThreads (2);
+
+  // More configurations than a block, every third one in the box.
+  matrix_t configurations (3, 41);
+  for (size_type i = 0; i < configurations.cols (); ++i) {
+    configurations.col (i) << -2 + (i % 3 == 0 ? .01 * (value_type) (i % 7)
+                                    : .2 + .1 * (value_type) i), 0, .05;
+  }
+  ValidationReportPtr_t report;
+  std::vector <bool> expected;
+  for (size_type i = 0; i < configurations.cols (); ++i)
+    expected.push_back (validation->validate (configurations.col (i), report));
+  BOOST_CHECK (std::find (expected.begin (), expected.end (), false) !=
+               expected.end ());
+
+  for (int spheres = 0; spheres < 2; ++spheres) {
+    validation->useBoundingSpheres (spheres == 1);
+    batch->useBoundingSpheres (spheres == 1);
+    std::vector <bool> valid;
+    std::vector <ValidationReportPtr_t> reports;
+    BOOST_CHECK (!validation->validateConfigurations (configurations, valid,
+                                                      reports));
+    BOOST_CHECK (valid == expected);
+    for (std::size_t i = 0; i < valid.size (); ++i)
+      BOOST_CHECK_EQUAL (!reports [i], (bool) valid [i]);
+    BOOST_CHECK (!batch->validateConfigurations (configurations, valid,
+                                                 reports));
+    BOOST_CHECK (valid == expected);
+  }
+  delete ps;
+}
+
+BOOST_AUTO_TEST_CASE (occupancyCache)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  DevicePtr_t robot (ps->robot ());
+  CollisionValidationPtr_t validation (CollisionValidation::create (robot));
+  validation->addObstacle (ps->obstacle ("box"));
+  BOOST_CHECK_THROW (OccupancyCache::create (robot, 0, 10),
+                     std::invalid_argument);
+  OccupancyCachePtr_t cache (OccupancyCache::create (robot, .01, 10));
+  validation->occupancyCache (cache);
+  const std::size_t scene (validation->sceneKey ());
+
+  // The box of width 0.3 is centered at (-2, 0, 0), the sphere has radius
+  // 0.01: the clearance at the origin is 1.84, the cell of level 4 of
+  // width 0.16 is the largest that fits.
+  Configuration_t q (Configuration_t::Zero (3));
+  ValidationReportPtr_t report;
+  BOOST_CHECK (validation->validate (q, report));
+  BOOST_REQUIRE_EQUAL (cache->numberCells (), 1);
+  BOOST_CHECK_EQUAL (cache->misses (), 1);
+  Configuration_t inside (q);
+  inside << .1, .1, .1;
+  BOOST_CHECK (cache->isFree (inside, scene));
+  BOOST_CHECK (validation->validate (inside, report));
+  BOOST_CHECK_EQUAL (cache->hits (), 2);
+  Configuration_t outside (q);
+  outside << .2, 0, 0;
+  BOOST_CHECK (!cache->isFree (outside, scene));
+
+  // Configurations in collision add no cell.
+  Configuration_t collision (q);
+  collision [0] = -1.9;
+  BOOST_CHECK (!validation->validate (collision, report));
+  BOOST_CHECK (report);
+  BOOST_CHECK (cache->numberCells () >= 1);
+  BOOST_CHECK (!cache->isFree (collision, scene));
+
+  // Saved cells are loaded with their scene.
+  const std::string filename ("occupancy-cache");
+  cache->save (filename);
+  OccupancyCachePtr_t loaded (OccupancyCache::load (robot, filename));
+  BOOST_CHECK_EQUAL (loaded->numberCells (), cache->numberCells ());
+  BOOST_CHECK_EQUAL (loaded->scene (), scene);
+  BOOST_CHECK (loaded->isFree (inside, scene));
+  std::remove (filename.c_str ());
+
+  // Another obstacle changes the scene.
+  FclCollisionObject box (
+      hpp::fcl::CollisionGeometryPtr_t (new hpp::fcl::Box (0.3, 0.3, 0.3)),
+      matrix3_t::Identity(), vector3_t (.05, .05, .05));
+  ps->addObstacle ("box2", box, true, true);
+  validation->addObstacle (ps->obstacle ("box2"));
+  BOOST_CHECK (validation->sceneKey () != scene);
+  BOOST_CHECK (!validation->validate (inside, report));
+
+  // The problem solver gives the cache to its collision validations.
+  ps->problem ()->setParameter ("CollisionValidation/occupancyCache",
+                                Parameter (filename));
+  ps->clearConfigValidations ();
+  ps->addConfigValidation ("CollisionValidation");
+  BOOST_REQUIRE (ps->occupancyCache ());
+  BOOST_CHECK_EQUAL (ps->occupancyCache ()->resolution (), .01);
+  delete ps;
+  BOOST_CHECK (std::ifstream (filename.c_str ()).good ());
+  std::remove (filename.c_str ());
+}
+
+BOOST_AUTO_TEST_CASE (batchedRandomShortcut)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->solve ();
+  PathVectorPtr_t path (ps->paths ().front ());
+  BOOST_REQUIRE (path);
+
+  pathOptimization::RandomShortcutPtr_t optimizer
+    (pathOptimization::RandomShortcut::create (*ps->problem ()));
+  BOOST_CHECK_THROW (optimizer->batch (0), std::invalid_argument);
+  BOOST_CHECK_THROW (optimizer->batch (4, 2), std::invalid_argument);
+  optimizer->batch (4, 2, ps->connectionToolsFactory ());
+  PathVectorPtr_t optimized (optimizer->optimize (path));
+  BOOST_REQUIRE (optimized);
+  BOOST_CHECK (optimized->length () <= path->length () + 1e-8);
+  BOOST_CHECK (optimized->initial () == path->initial ());
+  BOOST_CHECK (optimized->end () == path->end ());
+}
+
+BOOST_AUTO_TEST_CASE (optimizerStatistics)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->solve ();
+  PathVectorPtr_t path (ps->paths ().front ());
+  BOOST_REQUIRE (path);
+
+  ps->addPathOptimizer ("RandomShortcut");
+  ps->optimizePath (path);
+  BOOST_CHECK_THROW (ps->optimizerStatistics (1), std::out_of_range);
+  const PathOptimizer::Statistics& stats (ps->optimizerStatistics (0));
+  BOOST_CHECK (stats.iterations > 0);
+  BOOST_CHECK (stats.accepted + stats.rejected <= stats.iterations);
+  BOOST_REQUIRE_EQUAL (stats.lengths.size (), stats.accepted + 1);
+  BOOST_CHECK (stats.lengths.back ().second
+               <= stats.lengths.front ().second);
+  BOOST_CHECK (stats.stages.count (PlannerStatistics::VALIDATION) > 0);
+  BOOST_CHECK (stats.totalTime >= stats.lengths.back ().first);
+  BOOST_TEST_MESSAGE (stats);
+}
+
+BOOST_AUTO_TEST_CASE (multiStart)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->solve ();
+  PathVectorPtr_t path (ps->paths ().front ());
+  BOOST_REQUIRE (path);
+  ProblemPtr_t problem (ps->problem ());
+
+  BOOST_CHECK_THROW (pathOptimization::MultiStart::create (*problem,
+        pathOptimization::RandomShortcut::create,
+        ps->connectionToolsFactory (), 0), std::invalid_argument);
+  pathOptimization::MultiStartPtr_t optimizer
+    (pathOptimization::MultiStart::create (*problem,
+        pathOptimization::RandomShortcut::create,
+        ps->connectionToolsFactory (), 3));
+  PathVectorPtr_t optimized (optimizer->optimize (path));
+  BOOST_REQUIRE (optimized);
+  BOOST_CHECK (optimizer->cost (optimized) <= optimizer->cost (path) + 1e-8);
+  BOOST_CHECK (optimized->initial () == path->initial ());
+  BOOST_CHECK (optimized->end () == path->end ());
+  PathPtr_t validPart;
+  PathValidationReportPtr_t report;
+  BOOST_CHECK (problem->pathValidation ()->validate
+               (optimized, false, validPart, report));
+
+  // Registered in the problem solver
+  problem->setParameter ("MultiStart/numberOfStarts",
+                         Parameter ((size_type) 2));
+  ps->addPathOptimizer ("MultiStart");
+  ps->optimizePath (path);
+  BOOST_CHECK (ps->paths ().back () != path);
+}
+
+BOOST_AUTO_TEST_CASE (shortcutsKeepValidElements)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->solve ();
+  PathVectorPtr_t path (ps->paths ().front ());
+  BOOST_REQUIRE (path);
+
+  // Elements kept from the input path are not validated again: the
+  // optimized paths must still be valid.
+  std::vector <PathOptimizerPtr_t> optimizers;
+  optimizers.push_back (pathOptimization::RandomShortcut::create
+                        (*ps->problem ()));
+  optimizers.push_back (pathOptimization::PartialShortcut::create
+                        (*ps->problem ()));
+  // Candidates evaluated in threads
+  pathOptimization::PartialShortcutPtr_t parallel
+    (pathOptimization::PartialShortcut::create (*ps->problem ()));
+  BOOST_CHECK_THROW (parallel->parallelCandidates
+                     (2, PathPlanner::ConnectionToolsFactory_t ()),
+                     std::invalid_argument);
+  parallel->parallelCandidates (2, ps->connectionToolsFactory ());
+  parallel->parameters.onlyFullShortcut = false;
+  optimizers.push_back (parallel);
+  pathOptimization::SimpleShortcutPtr_t visibility
+    (pathOptimization::SimpleShortcut::create (*ps->problem ()));
+  visibility->visibilityGraph (2, ps->connectionToolsFactory ());
+  optimizers.push_back (visibility);
+  for (std::size_t i = 0; i < optimizers.size (); ++i) {
+    PathVectorPtr_t optimized (optimizers [i]->optimize (path));
+    BOOST_REQUIRE (optimized);
+    BOOST_CHECK (optimized->length () <= path->length () + 1e-8);
+    PathPtr_t validPart;
+    PathValidationReportPtr_t report;
+    BOOST_CHECK (ps->problem ()->pathValidation ()->validate
+                 (optimized, false, validPart, report));
+  }
+}
+
+BOOST_AUTO_TEST_CASE (connectionTools)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ProblemPtr_t problem (ps->problem ());
+
+  PathPlanner::ConnectionToolsFactory_t factory (ps->connectionToolsFactory ());
+  PathPlanner::ConnectionTools t1 (factory ()), t2 (factory ());
+  BOOST_REQUIRE (t1.steeringMethod && t1.pathValidation
+      && t1.configurationShooter);
+  BOOST_CHECK (t1.steeringMethod != problem->steeringMethod ());
+  BOOST_CHECK (t1.steeringMethod != t2.steeringMethod);
+  BOOST_CHECK (t1.pathValidation != problem->pathValidation ());
+  BOOST_CHECK (t1.pathValidation != t2.pathValidation);
+  BOOST_CHECK (t1.configurationShooter->randomGenerator ()
+      != t2.configurationShooter->randomGenerator ());
+
+  // The worker validation sees the obstacle of the problem.
+  Configuration_t q1 (*ps->initConfig ()), q2 (q1);
+  q2.head<2> () << -4, 0;
+  PathPtr_t path ((*t1.steeringMethod) (q1, q2));
+  BOOST_REQUIRE (path);
+  PathPtr_t validPart;
+  PathValidationReportPtr_t report;
+  BOOST_CHECK (!t1.pathValidation->validate (path, false, validPart, report));
+}
+
+// Build the optimizers of a pipeline thread on a worker problem.
+struct WorkerOptimizers
+{
+  WorkerOptimizers (ProblemSolverPtr_t ps, std::vector <ProblemPtr_t>& problems)
+    : ps_ (ps), problems_ (problems) {}
+
+  PlanAndOptimize::Optimizers_t operator() () const
+  {
+    PathPlanner::ConnectionTools tools (ps_->connectionToolsFactory () ());
+    ProblemPtr_t problem (Problem::create (ps_->robot ()));
+    problem->steeringMethod (tools.steeringMethod);
+    problem->pathValidation (tools.pathValidation);
+    problems_.push_back (problem);
+
+    PlanAndOptimize::Optimizers_t optimizers;
+    optimizers.push_back (pathOptimization::RandomShortcut::create (*problem));
+    return optimizers;
+  }
+
+  ProblemSolverPtr_t ps_;
+  std::vector <ProblemPtr_t>& problems_;
+};
+
+BOOST_AUTO_TEST_CASE (pipelinedPlanAndOptimize)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->solve ();
+  ProblemPtr_t problem (ps->problem ());
+
+  // BiRRT* publishes each improvement of its solution.
+  PathPlannerPtr_t planner (pathPlanner::BiRrtStar::create (*problem));
+  PlanAndOptimizePtr_t pao (PlanAndOptimize::create (planner));
+  pao->addPathOptimizer (pathOptimization::RandomShortcut::create (*problem));
+
+  std::vector <ProblemPtr_t> problems;
+  WorkerOptimizers factory (ps, problems);
+  BOOST_CHECK_THROW (pao->pipeline (factory, 0), std::invalid_argument);
+  pao->pipeline (factory, 2);
+
+  PathVectorPtr_t path (pao->solve ());
+  BOOST_REQUIRE (path);
+  BOOST_CHECK (!problems.empty ());
+  BOOST_CHECK (!planner->solutionCallback ());
+  BOOST_CHECK (path->initial () == *ps->initConfig ());
+  PathPtr_t validPart;
+  PathValidationReportPtr_t report;
+  BOOST_CHECK (problem->pathValidation ()->validate
+               (path, false, validPart, report));
+}
+
 BOOST_AUTO_TEST_CASE (carlike)
 {
   carLikeProblem ("Straight", "Weighed", "Discretized", 0.05);
   carLikeProblem ("Straight", "Weighed", "Progressive", 0.05);
   carLikeProblem ("Straight", "Weighed", "Dichotomy"  , 0   );
   carLikeProblem ("ReedsShepp", "ReedsShepp", "Discretized", 0.05);
+  carLikeProblem ("Dubins", "Dubins", "Discretized", 0.05);
   // Not implemented
   // carLikeProblem ("ReedsShepp", "ReedsShepp", "Progressive", 0.05);
   // Not implemented
   // carLikeProblem ("ReedsShepp", "ReedsShepp", "Dichotomy"  , 0   );
 }
+
+BOOST_AUTO_TEST_CASE (carlikeContinuousValidation)
+{
+  ProblemSolverPtr_t ps = ProblemSolver::create();
+  DevicePtr_t robot = unittest::makeDevice(unittest::CarLike);
+  robot->rootJoint()->lowerBound (0, -5);
+  robot->rootJoint()->lowerBound (1, -5);
+  robot->rootJoint()->upperBound (0,  5);
+  robot->rootJoint()->upperBound (1,  5);
+  ps->robot(robot);
+  ps->steeringMethodType ("Dubins");
+
+  FclCollisionObject box (
+      hpp::fcl::CollisionGeometryPtr_t (new hpp::fcl::Box (0.3, 0.3, 0.3)),
+      matrix3_t::Identity(), vector3_t (-2, 0, 0));
+  ps->addObstacle ("box", box, true, true);
+
+  ProblemPtr_t problem = ps->problem();
+  PathValidationPtr_t progressive
+    (ps->pathValidations.get ("Progressive") (robot, 0.01));
+  PathValidationPtr_t discretized
+    (ps->pathValidations.get ("Discretized") (robot, 0.01));
+  problem->setupPathValidation (progressive);
+  problem->setupPathValidation (discretized);
+
+  // Paths of Dubins are made of arcs along which the robot moves rigidly.
+  ConfigurationShooterPtr_t shooter (configurationShooter::Uniform::create
+                                     (robot));
+  Configuration_t q1 (robot->neutralConfiguration()),
+                  q2 (robot->configSize ());
+  for (int i = 0; i < 50; ++i) {
+    shooter->shoot (q2);
+    PathPtr_t path ((*problem->steeringMethod ()) (q1, q2));
+    BOOST_REQUIRE (path);
+    PathPtr_t validPart;
+    PathValidationReportPtr_t report;
+    bool continuous (progressive->validate (path, false, validPart, report));
+    bool discrete (discretized->validate (path, false, validPart, report));
+    // The discretized validation may miss collisions, not the reverse.
+    if (continuous) BOOST_CHECK (discrete);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (dubinsDistance)
+{
+  ProblemSolverPtr_t ps = ProblemSolver::create();
+  ps->robot(unittest::makeDevice(unittest::CarLike));
+  ps->steeringMethodType ("Dubins");
+  ProblemPtr_t problem = ps->problem();
+  distance::DubinsPtr_t dist (distance::Dubins::create (*problem));
+
+  matrix_t qs (6, 3);
+  qs.col (0) = ps->robot()->neutralConfiguration();
+  qs.col (1) << 2, 1, 0, 1, 0, 0;
+  qs.col (2) << -1, 3, -1, 0, 0, 0;
+  Configuration_t q (qs.col (1));
+  q.head<2> () << 1, -2;
+
+  vector_t distances;
+  dist->compute (qs, q, distances);
+  BOOST_REQUIRE_EQUAL (distances.size (), 3);
+  for (size_type i = 0; i < qs.cols (); ++i) {
+    PathPtr_t path ((*problem->steeringMethod ()) (qs.col (i), q));
+    BOOST_REQUIRE (path);
+    BOOST_CHECK_CLOSE (distances [i], path->length (), 1e-6);
+    BOOST_CHECK_CLOSE ((*dist) (qs.col (i), q), path->length (), 1e-6);
+    BOOST_CHECK (dist->lowerBound (qs.col (i), q) <= distances [i] + 1e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (reedsSheppTable)
+{
+  ProblemSolverPtr_t ps = ProblemSolver::create();
+  ps->robot(unittest::makeDevice(unittest::CarLike));
+  ps->steeringMethodType ("ReedsShepp");
+  ProblemPtr_t problem = ps->problem();
+  distance::ReedsSheppPtr_t dist (distance::ReedsShepp::create (*problem));
+  BOOST_CHECK (!dist->lookupTable ());
+  BOOST_CHECK_THROW (distance::ReedsSheppTable::create (1, 16, 4),
+                     std::invalid_argument);
+  distance::ReedsSheppTablePtr_t table (distance::ReedsSheppTable::create
+                                        (21, 16, 4));
+  BOOST_CHECK (table->margin () >= 0);
+  dist->lookupTable (table);
+
+  matrix_t qs (6, 3);
+  qs.col (0) = ps->robot()->neutralConfiguration();
+  qs.col (1) << 2, 1, 0, 1, 0, 0;
+  qs.col (2) << -1, 3, -1, 0, 0, 0;
+  Configuration_t q (qs.col (1));
+  q.head<2> () << 1, -2;
+  for (size_type i = 0; i < qs.cols (); ++i) {
+    const value_type d ((*dist) (qs.col (i), q));
+    BOOST_CHECK (dist->lowerBound (qs.col (i), q) <= d + 1e-6);
+    // Closer to the distance than the distance between the positions
+    BOOST_CHECK (dist->lowerBound (qs.col (i), q) >=
+                 (qs.col (i).head<2> () - q.head<2> ()).norm () - 1e-10);
+  }
+
+  // Saved tables are mapped with the same lengths.
+  const std::string filename ("reeds-shepp-table");
+  table->save (filename);
+  distance::ReedsSheppTablePtr_t loaded (distance::ReedsSheppTable::load
+                                         (filename));
+  BOOST_CHECK_EQUAL (loaded->numberXY (), 21);
+  BOOST_CHECK_EQUAL (loaded->numberTheta (), 16);
+  BOOST_CHECK_EQUAL (loaded->margin (), table->margin ());
+  for (value_type x = -5; x <= 5; x += .7)
+    BOOST_CHECK_EQUAL (loaded->lowerBound (x, .3 * x, .1 * x),
+                       table->lowerBound (x, .3 * x, .1 * x));
+
+  // The parameter loads the table from the file.
+  problem->setParameter ("ReedsShepp/lookupTable", Parameter (filename));
+  dist = distance::ReedsShepp::create (*problem);
+  BOOST_REQUIRE (dist->lookupTable ());
+  BOOST_CHECK_EQUAL (dist->lookupTable ()->numberXY (), 21);
+  std::remove (filename.c_str ());
+
+  {
+    std::ofstream os (filename.c_str ());
+    os << "not a table";
+  }
+  BOOST_CHECK_THROW (distance::ReedsSheppTable::load (filename),
+                     std::runtime_error);
+  std::remove (filename.c_str ());
+}
+
+BOOST_AUTO_TEST_CASE (weighedDistanceRotations)
+{
+  // The root joint of the car is planar.
+  DevicePtr_t robot = unittest::makeDevice(unittest::CarLike);
+  vector_t weights (vector_t::LinSpaced (robot->nbJoints (), 1, 2));
+  WeighedDistancePtr_t dist (WeighedDistance::createWithWeight (robot,
+                                                                weights));
+  ConfigurationShooterPtr_t shooter (configurationShooter::Uniform::create
+                                     (robot));
+  Configuration_t q1 (robot->configSize ()), q2 (robot->configSize ());
+  vector_t dq (robot->numberDof ());
+  for (int i = 0; i < 20; ++i) {
+    shooter->shoot (q1);
+    shooter->shoot (q2);
+    pinocchio::difference<pinocchio::RnxSOnLieGroupMap> (robot, q2, q1, dq);
+    value_type expected = 0;
+    for (size_type j = 0; j < robot->nbJoints (); ++j) {
+      JointPtr_t joint (robot->jointAt (j));
+      expected += weights [j] * weights [j] * dq.segment
+        (joint->rankInVelocity (), joint->numberDof ()).squaredNorm ();
+    }
+    BOOST_CHECK_CLOSE ((*dist) (q1, q2), sqrt (expected), 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (weighedDistanceFromSamples)
+{
+  DevicePtr_t robot = unittest::makeDevice(unittest::ManipulatorArm2);
+  ProblemPtr_t problem = Problem::create (robot);
+  Configuration_t q (robot->neutralConfiguration ());
+  robot->currentConfiguration (q);
+
+  problem->setParameter ("WeighedDistance/numberOfSamples",
+                         Parameter ((size_type) 20));
+  problem->setParameter ("WeighedDistance/percentile", Parameter (1.));
+  WeighedDistancePtr_t max (WeighedDistance::createFromSamples (*problem));
+  problem->setParameter ("WeighedDistance/percentile", Parameter (0.));
+  WeighedDistancePtr_t min (WeighedDistance::createFromSamples (*problem));
+
+  BOOST_CHECK (robot->currentConfiguration () == q);
+  BOOST_REQUIRE_EQUAL (max->size (), robot->nbJoints ());
+  BOOST_REQUIRE_EQUAL (min->size (), robot->nbJoints ());
+  for (size_type i = 0; i < max->size (); ++i) {
+    BOOST_CHECK (max->getWeight (i) > 0);
+    BOOST_CHECK (max->getWeight (i) >= min->getWeight (i));
+  }
+
+  problem->setParameter ("WeighedDistance/percentile", Parameter (2.));
+  BOOST_CHECK_THROW (WeighedDistance::createFromSamples (*problem),
+                     std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE (weighedDistanceCache)
+{
+  DevicePtr_t robot = unittest::makeDevice(unittest::ManipulatorArm2);
+  ProblemPtr_t problem = Problem::create (robot);
+  robot->currentConfiguration (robot->neutralConfiguration ());
+  WeighedDistancePtr_t computed (WeighedDistance::createFromProblem
+                                 (*problem));
+
+  // The weights are stored in the cache directory.
+  const std::string directory ("weighed-distance-cache");
+  mkdir (directory.c_str (), 0755);
+  problem->setParameter ("WeighedDistance/cacheDirectory",
+                         Parameter (directory));
+  WeighedDistancePtr_t stored (WeighedDistance::createFromProblem (*problem));
+  BOOST_CHECK (stored->weights () == computed->weights ());
+  std::vector <std::string> files;
+  DIR* dir (opendir (directory.c_str ()));
+  BOOST_REQUIRE (dir);
+  while (dirent* entry = readdir (dir))
+    if (entry->d_name [0] != '.')
+      files.push_back (directory + "/" + entry->d_name);
+  closedir (dir);
+  BOOST_REQUIRE_EQUAL (files.size (), 1);
+
+  // Then read instead of computed.
+  {
+    std::ofstream os (files [0].c_str (), std::ios::binary | std::ios::trunc);
+    const boost::int64_t n (robot->nbJoints ());
+    const vector_t ones (vector_t::Ones (n));
+    os.write ((const char*) &n, sizeof (n));
+    os.write ((const char*) ones.data (), sizeof (value_type) * n);
+  }
+  WeighedDistancePtr_t read (WeighedDistance::createFromProblem (*problem));
+  BOOST_CHECK (read->weights () == vector_t::Ones (robot->nbJoints ()));
+
+  // Another configuration has other weights.
+  Configuration_t q (robot->neutralConfiguration ());
+  q [0] = 1;
+  robot->currentConfiguration (q);
+  WeighedDistancePtr_t other (WeighedDistance::createFromProblem (*problem));
+  BOOST_CHECK (other->weights () != vector_t::Ones (robot->nbJoints ()));
+
+  dir = opendir (directory.c_str ());
+  while (dirent* entry = readdir (dir))
+    if (entry->d_name [0] != '.')
+      std::remove ((directory + "/" + entry->d_name).c_str ());
+  closedir (dir);
+  rmdir (directory.c_str ());
+}
+
+BOOST_AUTO_TEST_CASE (parameterHandle)
+{
+  DevicePtr_t robot = unittest::makeDevice(unittest::CarLike);
+  ProblemPtr_t problem = Problem::create (robot);
+  ParameterHandle <value_type> stepLength
+    (*problem, "DiffusingPlanner/extensionStepLength");
+  ParameterHandle <size_type> loops
+    (*problem, "PathOptimization/RandomShortcut/NumberOfLoops");
+
+  // Default values until the parameters are set.
+  BOOST_CHECK_EQUAL (stepLength.value (), Problem::parameterDescription
+      ("DiffusingPlanner/extensionStepLength").defaultValue ().floatValue ());
+  BOOST_CHECK_EQUAL (loops.value (), Problem::parameterDescription
+      ("PathOptimization/RandomShortcut/NumberOfLoops").defaultValue ()
+      .intValue ());
+
+  const size_type revision (problem->parametersRevision ());
+  problem->setParameter ("DiffusingPlanner/extensionStepLength",
+                         Parameter (.25));
+  BOOST_CHECK_EQUAL (problem->parametersRevision (), revision + 1);
+  BOOST_CHECK_EQUAL (stepLength.value (), .25);
+  problem->setParameter ("PathOptimization/RandomShortcut/NumberOfLoops",
+                         Parameter ((size_type) 7));
+  BOOST_CHECK_EQUAL (loops.value (), 7);
+  BOOST_CHECK_EQUAL (stepLength.value (), .25);
+}
+
+BOOST_AUTO_TEST_CASE (obstacleNames)
+{
+  ProblemSolverPtr_t ps = ProblemSolver::create ();
+  ps->robot (unittest::makeDevice(unittest::CarLike));
+  hpp::fcl::CollisionGeometryPtr_t geom (new hpp::fcl::Box (0.3, 0.3, 0.3));
+  for (int i = 0; i < 4; ++i) {
+    FclCollisionObject box (geom, matrix3_t::Identity(),
+                            vector3_t (value_type (i), 0, 0));
+    ps->addObstacle (std::string ("box") + char ('0' + i), box, true, true);
+  }
+  BOOST_CHECK_THROW (ps->addObstacle ("box1", FclCollisionObject (geom),
+                                      true, true), std::runtime_error);
+  BOOST_CHECK_EQUAL (ps->obstacle ("box2")->indexInModel (), 2);
+
+  // Obstacles after a removed one are shifted in the model.
+  ps->removeObstacle ("box1");
+  BOOST_CHECK_THROW (ps->obstacle ("box1"), std::invalid_argument);
+  BOOST_CHECK_EQUAL (ps->obstacle ("box2")->indexInModel (), 1);
+  BOOST_CHECK_EQUAL (ps->obstacle ("box3")->indexInModel (), 2);
+  BOOST_CHECK_EQUAL (ps->obstacle ("box0")->indexInModel (), 0);
+  BOOST_CHECK_EQUAL (ps->obstacleNames (true, false).size (), 3);
+
+  // Batches are rejected as a whole if a name is used.
+  std::vector <std::string> names;
+  std::vector <FclCollisionObject> objects;
+  for (int i = 0; i < 6; ++i) {
+    names.push_back (std::string ("batch") + char ('0' + i));
+    objects.push_back (FclCollisionObject (geom, matrix3_t::Identity(),
+                                           vector3_t (0, value_type (i), 0)));
+  }
+  names.push_back ("box2");
+  objects.push_back (FclCollisionObject (geom));
+  BOOST_CHECK_THROW (ps->addObstacles (names, objects, true, false, 2),
+                     std::runtime_error);
+  BOOST_CHECK_EQUAL (ps->obstacleNames (true, false).size (), 3);
+
+  names.pop_back (); objects.pop_back ();
+  ps->addObstacles (names, objects, true, false, 2);
+  BOOST_CHECK_EQUAL (ps->obstacleNames (true, false).size (), 9);
+  BOOST_CHECK_EQUAL (ps->obstacleNames (false, true).size (), 3);
+  BOOST_CHECK_EQUAL (ps->obstacle ("batch4")->indexInModel (), 7);
+  BOOST_CHECK (ps->obstacle ("batch4")->fcl ()->getTransform ()
+               .getTranslation ().isApprox (vector3_t (0, 4, 0)));
+}
+
+/// Edge of a roadmap from a configuration to another one
+EdgePtr_t findEdge (const RoadmapPtr_t& roadmap, const Configuration_t& from,
+                    const Configuration_t& to)
+{
+  for (Edges_t::const_iterator it = roadmap->edges ().begin ();
+       it != roadmap->edges ().end (); ++it) {
+    if ((*it)->from ()->configuration ()->isApprox (from) &&
+        (*it)->to ()->configuration ()->isApprox (to))
+      return *it;
+  }
+  return EdgePtr_t ();
+}
+
+BOOST_AUTO_TEST_CASE (warmStartSweptVolumes)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->warmStart (true);
+  ps->prepareSolveStepByStep ();
+  const SteeringMethodPtr_t& sm (ps->problem ()->steeringMethod ());
+  Configuration_t qa (3), qb (3), qc (3);
+  qa << 0, 3, 0;
+  qb << 2, 3, 0;
+  qc << 0, 5, 0;
+  NodePtr_t a (ps->roadmap ()->addNode (qa)),
+    b (ps->roadmap ()->addNode (qb)), c (ps->roadmap ()->addNode (qc));
+  ps->roadmap ()->addEdges (a, b, (*sm) (qa, qb));
+  ps->roadmap ()->addEdges (a, c, (*sm) (qa, qc));
+
+  // An obstacle far from the edges keeps the roadmap.
+  RoadmapPtr_t roadmap (ps->roadmap ());
+  FclCollisionObject far (
+      hpp::fcl::CollisionGeometryPtr_t (new hpp::fcl::Box (0.3, 0.3, 0.3)),
+      matrix3_t::Identity(), vector3_t (8, -8, 0));
+  ps->addObstacle ("far", far, true, true);
+  ps->prepareSolveStepByStep ();
+  BOOST_CHECK (ps->roadmap () == roadmap);
+  EdgePtr_t ab (findEdge (ps->roadmap (), qa, qb));
+  BOOST_REQUIRE (ab);
+  const hpp::fcl::AABB& volume (ab->sweptVolume ());
+  BOOST_CHECK (volume.contain (vector3_t (qa)) && volume.contain (vector3_t (qb)));
+  BOOST_CHECK (!volume.contain (vector3_t (8, -8, 0)));
+
+  // Only the edges crossing a new obstacle are removed.
+  FclCollisionObject wall (
+      hpp::fcl::CollisionGeometryPtr_t (new hpp::fcl::Box (1, 0.3, 1)),
+      matrix3_t::Identity(), vector3_t (0, 4, 0));
+  ps->addObstacle ("wall", wall, true, true);
+  ps->prepareSolveStepByStep ();
+  BOOST_CHECK (!findEdge (ps->roadmap (), qa, qc));
+  BOOST_CHECK (!findEdge (ps->roadmap (), qc, qa));
+  ab = findEdge (ps->roadmap (), qa, qb);
+  BOOST_REQUIRE (ab);
+  BOOST_CHECK (ab->sweptVolume ().contain (vector3_t (qa)));
+  BOOST_CHECK (findEdge (ps->roadmap (), qb, qa));
+
+  // Moving the far obstacle does not affect the edges, and removing an
+  // obstacle keeps the roadmap.
+  roadmap = ps->roadmap ();
+  ps->moveObstacle ("far", Transform3f (matrix3_t::Identity (),
+                                        vector3_t (8, -7, 0)));
+  ps->removeObstacle ("wall");
+  ps->prepareSolveStepByStep ();
+  BOOST_CHECK (ps->roadmap () == roadmap);
+  BOOST_CHECK (findEdge (ps->roadmap (), qa, qb));
+  delete ps;
+}
+
+BOOST_AUTO_TEST_CASE (asyncSolve)
+{
+  const char* urdfString =
+      "<robot name='foo'><link name='base_link'>"
+      "<collision><geometry><sphere radius='0.01'/></geometry></collision>"
+      "</link></robot>";
+
+  DevicePtr_t robot = Device::create ("point");
+  urdf::loadModelFromString (robot, 0, "", "translation3d", urdfString, "");
+  for (size_type i = 0; i < 3; ++i) {
+    robot->rootJoint()->lowerBound (i, -10);
+    robot->rootJoint()->upperBound (i,  10);
+  }
+
+  ProblemPtr_t problem = Problem::create (robot);
+  ConfigurationPtr_t qinit (new Configuration_t (robot->neutralConfiguration()));
+  ConfigurationPtr_t qgoal (new Configuration_t (robot->neutralConfiguration()));
+  *qgoal << -4, 0, 0;
+  problem->initConfig (qinit);
+  problem->addGoalConfig (qgoal);
+
+  // BiRRT* runs 100 iterations by default.
+  PathPlannerPtr_t planner (pathPlanner::BiRrtStar::create (*problem));
+  AsyncSolvePtr_t handle (AsyncSolve::create (planner));
+  PathVectorPtr_t path (handle->result ());
+  BOOST_REQUIRE (path);
+  BOOST_CHECK (handle->done ());
+  BOOST_CHECK_EQUAL (handle->latestSolution (), path);
+  BOOST_CHECK_EQUAL (handle->progress ().iteration, 100ul);
+  BOOST_CHECK (handle->progress ().solved);
+  BOOST_CHECK (!planner->progressCallback ());
+  BOOST_CHECK (!planner->solutionCallback ());
+
+  // Interruption
+  planner->maxIterations (100000000);
+  handle = AsyncSolve::create (planner);
+  handle->interrupt ();
+  BOOST_CHECK_THROW (handle->result (), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE (planningService)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->robot ()->numberDeviceData (2);
+  ps->solve ();
+
+  BOOST_CHECK_THROW (PlanningService::create (*ps, 0), std::invalid_argument);
+  PlanningServicePtr_t service (PlanningService::create (*ps, 2));
+  BOOST_CHECK_EQUAL (service->numberWorkers (), 2ul);
+
+  PlanningService::Request request;
+  BOOST_CHECK_THROW (service->submit (request), std::invalid_argument);
+  request.init = ps->robot ()->neutralConfiguration ();
+  Configuration_t goal (request.init);
+  goal << -4, 0, 0;
+  request.goals.push_back (ConfigurationPtr_t (new Configuration_t (goal)));
+  request.pathPlannerType = "unknown";
+  BOOST_CHECK_THROW (service->submit (request), std::invalid_argument);
+  request.pathPlannerType = "";
+
+  std::vector <PlanningService::Ticket_t> tickets;
+  for (std::size_t i = 0; i < 4; ++i) {
+    goal [1] = (value_type) i;
+    request.goals [0] = ConfigurationPtr_t (new Configuration_t (goal));
+    tickets.push_back (service->submit (request));
+  }
+  for (std::size_t i = 0; i < tickets.size (); ++i) {
+    const PlanningService::Result result (service->result (tickets [i]));
+    BOOST_REQUIRE_MESSAGE (result.path, result.error);
+    BOOST_CHECK (result.path->initial () == request.init);
+    BOOST_CHECK_CLOSE (result.path->end () [1], (value_type) i, 1e-6);
+    BOOST_CHECK (result.queueTime >= 0);
+    BOOST_CHECK (result.solveTime >= 0);
+    BOOST_CHECK (result.worker < 2);
+    // The ticket is released.
+    BOOST_CHECK_THROW (service->done (tickets [i]), std::invalid_argument);
+  }
+  const PlanningService::Statistics stats (service->statistics ());
+  BOOST_CHECK_EQUAL (stats.requests, 4ul);
+  BOOST_CHECK_EQUAL (stats.failures, 0ul);
+  BOOST_CHECK_EQUAL (service->pending (), 0ul);
+  BOOST_CHECK (stats.maxLatency <= stats.queueTime + stats.solveTime + 1e-12);
+
+  // Queued requests are dropped by the destructor.
+  for (std::size_t i = 0; i < 4; ++i) service->submit (request);
+  service.reset ();
+  delete ps;
+}
+
+void square (std::vector <size_type>& values, std::size_t i)
+{
+  values [i] = (size_type) (i * i);
+}
+
+void throwRuntimeError ()
+{
+  throw std::runtime_error ("task failed");
+}
+
+/// Run nested tasks in the executor
+void squareAll (const ExecutorPtr_t& executor, std::vector <size_type>& values)
+{
+  Executor::Tasks_t tasks;
+  for (std::size_t i = 0; i < values.size (); ++i)
+    tasks.push_back (boost::bind (&square, boost::ref (values), i));
+  executor->run (tasks);
+}
+
+BOOST_AUTO_TEST_CASE (taskTargetSampling)
+{
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ProblemPtr_t problem (ps->problem ());
+  problemTarget::TaskTargetPtr_t target
+    (problemTarget::TaskTarget::create (problem));
+  BOOST_CHECK_THROW (target->sampleGoals (1, 4, ps->connectionToolsFactory ()),
+                     std::runtime_error);
+  target->constraints (ConstraintSet::create (ps->robot (), "goal"));
+  target->sampleGoals (2, 4, ps->connectionToolsFactory ());
+  while (target->goals ().size () < 4)
+    boost::this_thread::sleep_for (boost::chrono::milliseconds (1));
+  target->stopSampling ();
+  BOOST_CHECK_EQUAL (target->goals ().size (), 4);
+
+  // Goals are tagged once, and again after the goal nodes are reset.
+  RoadmapPtr_t roadmap (Roadmap::create (problem->distance (), ps->robot ()));
+  target->addGoalNodes (roadmap, false);
+  target->addGoalNodes (roadmap, true);
+  BOOST_CHECK_EQUAL (roadmap->goalNodes ().size (), 4);
+  roadmap->resetGoalNodes ();
+  target->addGoalNodes (roadmap, false);
+  BOOST_CHECK_EQUAL (roadmap->goalNodes ().size (), 4);
+}
+
+BOOST_AUTO_TEST_CASE (executor)
+{
+  BOOST_CHECK_THROW (Executor::create (0), std::invalid_argument);
+  ProblemSolverPtr_t ps = ProblemSolver::create ();
+  BOOST_REQUIRE (ps->executor ());
+  BOOST_CHECK (ps->executor ()->numberThreads () >= 1);
+  delete ps;
+
+  ExecutorPtr_t executor (Executor::create (2, true));
+  BOOST_CHECK_EQUAL (executor->numberThreads (), 2);
+  BOOST_CHECK (executor->pinning ());
+
+  std::vector <std::vector <size_type> > values
+    (4, std::vector <size_type> (100, -1));
+  Executor::Tasks_t tasks;
+  for (std::size_t i = 0; i < values.size (); ++i) {
+    tasks.push_back (boost::bind (&squareAll, boost::cref (executor),
+                                  boost::ref (values [i])));
+  }
+  executor->run (tasks);
+  for (std::size_t i = 0; i < values.size (); ++i)
+    for (std::size_t j = 0; j < values [i].size (); ++j)
+      BOOST_CHECK_EQUAL (values [i][j], (size_type) (j * j));
+
+  // The other tasks run even if one of them fails.
+  std::vector <size_type> squares (2, -1);
+  tasks.clear ();
+  tasks.push_back (boost::bind (&square, boost::ref (squares), 0));
+  tasks.push_back (&throwRuntimeError);
+  tasks.push_back (boost::bind (&square, boost::ref (squares), 1));
+  BOOST_CHECK_THROW (executor->run (tasks), std::runtime_error);
+  BOOST_CHECK_EQUAL (squares [0], 0);
+  BOOST_CHECK_EQUAL (squares [1], 1);
+
+  // NUMA nodes
+  const size_type n (executor->numberNodes ());
+  BOOST_CHECK (n >= 1 && n <= 2);
+  BOOST_CHECK (executor->node () >= 0 && executor->node () < n);
+  tasks.assign (1, boost::bind (&square, boost::ref (squares), 1));
+  BOOST_CHECK_THROW (executor->run (tasks, n), std::invalid_argument);
+  squares [1] = -1;
+  executor->run (tasks, n - 1);
+  BOOST_CHECK_EQUAL (squares [1], 1);
+
+  vector_t weights (vector_t::LinSpaced (10, 0, 1));
+  NodeReplicas <vector_t> replicas (executor, weights);
+  BOOST_CHECK_EQUAL ((size_type) replicas.size (), n);
+  BOOST_CHECK (replicas.get () == weights);
+  BOOST_CHECK (replicas.get (n - 1) == weights);
+  BOOST_CHECK (&replicas.get (0) != &weights);
+  NodeReplicas <vector_t> single (ExecutorPtr_t (), weights);
+  BOOST_CHECK_EQUAL (single.size (), 1);
+  BOOST_CHECK (single.get () == weights);
+}
+
+BOOST_AUTO_TEST_CASE (deadline)
+{
+  DeadlinePtr_t deadline (Deadline::create ());
+  BOOST_CHECK (!deadline->running ());
+  BOOST_CHECK (!deadline->expired ());
+
+  deadline->start (0);
+  BOOST_CHECK (deadline->running ());
+  BOOST_CHECK (deadline->expired ());
+  BOOST_CHECK_EQUAL (deadline->remaining (), 0);
+
+  deadline->start (std::numeric_limits <value_type>::infinity ());
+  BOOST_CHECK (!deadline->expired ());
+  deadline->cancel ();
+  BOOST_CHECK (deadline->expired ());
+  deadline->stop ();
+  BOOST_CHECK (!deadline->expired ());
+
+  // Nested scopes share the deadline of the outer one.
+  {
+    Deadline::Scope outer (deadline, 0);
+    {
+      Deadline::Scope inner (deadline, 1000);
+      BOOST_CHECK (deadline->expired ());
+    }
+    BOOST_CHECK (deadline->running ());
+  }
+  BOOST_CHECK (!deadline->running ());
+}
+
+namespace {
+  std::size_t numberSpans (const std::string& trace)
+  {
+    std::size_t n (0);
+    for (std::size_t i = trace.find ("\"ph\""); i != std::string::npos;
+         i = trace.find ("\"ph\"", i + 1))
+      ++n;
+    return n;
+  }
+} // namespace
+
+BOOST_AUTO_TEST_CASE (trace)
+{
+  BOOST_CHECK_THROW (Trace::enable (0), std::invalid_argument);
+  BOOST_CHECK (!Trace::enabled ());
+
+  // Each thread keeps its last spans, the buffer of this thread is created
+  // by its first span.
+  Trace::enable (4);
+  Trace::clear ();
+  for (int i = 0; i < 10; ++i) {
+    HPP_CORE_TRACE_SPAN ("test");
+  }
+  std::ostringstream os;
+  Trace::dump (os);
+  BOOST_CHECK (os.str ().find ("\"traceEvents\"") != std::string::npos);
+  BOOST_CHECK (os.str ().find ("\"name\": \"test\"") != std::string::npos);
+  BOOST_CHECK (numberSpans (os.str ()) <= 4);
+  BOOST_CHECK (numberSpans (os.str ()) > 0);
+
+  Trace::clear ();
+  os.str ("");
+  Trace::dump (os);
+  BOOST_CHECK_EQUAL (numberSpans (os.str ()), 0);
+  Trace::disable ();
+  {
+    HPP_CORE_TRACE_SPAN ("disabled");
+  }
+  os.str ("");
+  Trace::dump (os);
+  BOOST_CHECK_EQUAL (numberSpans (os.str ()), 0);
+
+  // The problem solver traces the resolution in the file given.
+  const std::string filename ("trace.json");
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  ps->problem ()->setParameter ("Trace/file", Parameter (filename));
+  ps->solve ();
+  BOOST_CHECK (!Trace::enabled ());
+  std::ifstream file (filename.c_str ());
+  std::stringstream content;
+  content << file.rdbuf ();
+  BOOST_CHECK (content.str ().find ("PathPlanner::solve") !=
+               std::string::npos);
+  delete ps;
+  std::remove (filename.c_str ());
+}
+
+BOOST_AUTO_TEST_CASE (allocationProfile)
+{
+  // Recording does not allocate, the counters of the roadmap only change
+  // by the allocations recorded below.
+  BOOST_CHECK (!AllocationProfile::enabled ());
+  AllocationProfile::Snapshot start (AllocationProfile::snapshot ());
+  {
+    HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
+    AllocationProfile::record (100);
+  }
+  BOOST_CHECK_EQUAL (AllocationProfile::counters
+                     (AllocationProfile::ROADMAP).allocations,
+                     start.counters [AllocationProfile::ROADMAP].allocations);
+
+  AllocationProfile::enable ();
+  {
+    HPP_CORE_ALLOCATION_SCOPE (ROADMAP);
+    AllocationProfile::record (100);
+    {
+      // The innermost scope wins.
+      HPP_CORE_ALLOCATION_SCOPE (STEERING);
+    }
+    AllocationProfile::record (20);
+  }
+  AllocationProfile::disable ();
+  const AllocationProfile::Counters c
+    (AllocationProfile::counters (AllocationProfile::ROADMAP));
+  BOOST_CHECK_EQUAL (c.allocations, start.counters
+                     [AllocationProfile::ROADMAP].allocations + 2);
+  BOOST_CHECK_EQUAL (c.bytes, start.counters
+                     [AllocationProfile::ROADMAP].bytes + 120);
+
+  AllocationProfile::reset ();
+  BOOST_CHECK_EQUAL (AllocationProfile::counters
+                     (AllocationProfile::ROADMAP).allocations, 0);
+
+  // The planner records the allocations of the resolution, there are
+  // none unless the library replaces operator new.
+  ProblemSolverPtr_t ps = pointMassProblemSolver ("Straight", "Weighed",
+      "Discretized", 0.05);
+  AllocationProfile::enable ();
+  start = AllocationProfile::snapshot ();
+  ps->solve ();
+  AllocationProfile::disable ();
+  const PlannerStatistics& statistics (ps->pathPlanner ()->statistics ());
+  BOOST_CHECK (statistics.allocations (AllocationProfile::PLANNER).bytes <=
+               AllocationProfile::counters (AllocationProfile::PLANNER).bytes
+               - start.counters [AllocationProfile::PLANNER].bytes);
+  delete ps;
+}
@@ -16,20 +16,38 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with hpp-core.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
 #include <boost/assign.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <hpp/util/debug.hh>
+#include <hpp/constraints/locked-joint.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/liegroup-element.hh>
 #include <hpp/pinocchio/urdf/util.hh>
 #include <hpp/core/fwd.hh>
 #include <hpp/core/roadmap.hh>
 #include <hpp/core/problem.hh>
 #include <hpp/core/weighed-distance.hh>
+#include <hpp/core/compact-roadmap.hh>
+#include <hpp/core/config-projector.hh>
 #include <hpp/core/connected-component.hh>
+#include <hpp/core/edge.hh>
+#include <hpp/core/path.hh>
 #include <hpp/core/node.hh>
+#include <hpp/core/mapped-roadmap.hh>
+#include <hpp/core/multi-query-solver.hh>
 #include <hpp/core/nearest-neighbor.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/roadmap-checkpoint.hh>
+#include <hpp/core/shared-roadmap.hh>
 
 #include <hpp/core/steering-method/straight.hh>
 #include <hpp/core/weighed-distance.hh>
@@ -391,6 +409,769 @@ BOOST_AUTO_TEST_CASE (nearestNeighbor) {
   }
 }
 
+BOOST_AUTO_TEST_CASE (configurationStorage) {
+  DevicePtr_t robot = createRobot();
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  // Fill more than one chunk of the configuration storage.
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 3000; ++i) {
+    q [0] = i; q [1] = -i;
+    nodes.push_back (r->addNode (q));
+  }
+  BOOST_CHECK_EQUAL (r->nodes ().size (), 3000);
+  for (int i = 0; i < 3000; ++i) {
+    BOOST_CHECK_EQUAL ((*nodes [i]->configuration ()) [0], i);
+    BOOST_CHECK_EQUAL ((*nodes [i]->configuration ()) [1], -i);
+  }
+  // Adding an existing configuration returns the existing node.
+  q [0] = 12; q [1] = -12;
+  BOOST_CHECK_EQUAL (r->addNode (q), nodes [12]);
+  BOOST_CHECK_EQUAL (r->nodes ().size (), 3000);
+
+  // Configurations outlive the roadmap nodes.
+  ConfigurationPtr_t q12 (nodes [12]->configuration ());
+  r->clear ();
+  BOOST_CHECK_EQUAL ((*q12) [0], 12);
+  nodes.clear ();
+  NodePtr_t n = r->addNode (q);
+  BOOST_CHECK_EQUAL (*n->configuration (), q);
+}
+
+BOOST_AUTO_TEST_CASE (prune) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  // Star around the initial node: spoke i is at distance 0.3 * i.
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  r->initNode (ConfigurationPtr_t (new Configuration_t (q)));
+  std::vector <NodePtr_t> nodes;
+  nodes.push_back (r->initNode ());
+  for (int i = 1; i < 10; ++i) {
+    q [0] = .3 * i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+    addEdge (r, *sm, nodes, 0, i);
+    addEdge (r, *sm, nodes, i, 0);
+  }
+  BOOST_CHECK_EQUAL (r->connectedComponents ().size (), 1);
+
+  // The farthest spokes are removed first, the initial node is kept.
+  BOOST_CHECK_EQUAL (r->prune (5), 5);
+  BOOST_CHECK_EQUAL (r->nodes ().size (), 5);
+  BOOST_CHECK_EQUAL (r->edges ().size (), 8);
+  BOOST_CHECK_EQUAL (r->initNode (), nodes [0]);
+  BOOST_CHECK_EQUAL (r->initNode ()->outEdges ().size (), 4);
+  BOOST_CHECK_EQUAL (r->initNode ()->inEdges ().size (), 4);
+  BOOST_CHECK_EQUAL (r->connectedComponents ().size (), 1);
+  BOOST_CHECK_EQUAL
+    (r->initNode ()->connectedComponent ()->nodes ().size (), 5);
+  value_type d;
+  q [0] = 3;
+  BOOST_CHECK_EQUAL (r->nearestNode (ConfigurationPtr_t
+				     (new Configuration_t (q)), d),
+		     nodes [4]);
+
+  // The initial node alone cannot be removed.
+  BOOST_CHECK_EQUAL (r->prune (0), 4);
+  BOOST_CHECK_EQUAL (r->nodes ().size (), 1);
+  BOOST_CHECK_EQUAL (r->edges ().size (), 0);
+}
+
+BOOST_AUTO_TEST_CASE (lazyEdges) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 3; ++i) {
+    q [0] = i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  // Edges that are not validated do not connect components.
+  PathPtr_t path01 ((*sm) (*nodes [0]->configuration (),
+			   *nodes [1]->configuration ()));
+  PathPtr_t path12 ((*sm) (*nodes [1]->configuration (),
+			   *nodes [2]->configuration ()));
+  r->addEdges (nodes [0], nodes [1], path01, false);
+  r->addEdges (nodes [1], nodes [2], path12, false);
+  BOOST_CHECK_EQUAL (r->edges ().size (), 4);
+  BOOST_CHECK_EQUAL (r->connectedComponents ().size (), 3);
+
+  EdgePtr_t e01 (nodes [0]->outEdges ().front ());
+  EdgePtr_t e10 (nodes [1]->outEdges ().front ());
+  BOOST_CHECK (!e01->validated ());
+  r->validateEdge (e01);
+  BOOST_CHECK (e01->validated ());
+  BOOST_CHECK (nodes [0]->connectedComponent ()->canReach
+	       (nodes [1]->connectedComponent ()));
+  BOOST_CHECK (!nodes [1]->connectedComponent ()->canReach
+	       (nodes [0]->connectedComponent ()));
+  r->validateEdge (e10);
+  BOOST_CHECK_EQUAL (r->connectedComponents ().size (), 2);
+
+  // Only edges that are not validated can be removed.
+  BOOST_CHECK_THROW (r->removeEdge (e01), std::logic_error);
+  EdgePtr_t e12 (nodes [2]->inEdges ().front ());
+  EdgePtr_t e21 (nodes [2]->outEdges ().front ());
+  r->removeEdge (e12);
+  r->removeEdge (e21);
+  BOOST_CHECK_EQUAL (r->edges ().size (), 2);
+  BOOST_CHECK (nodes [2]->inEdges ().empty ());
+  BOOST_CHECK (nodes [2]->outEdges ().empty ());
+  BOOST_CHECK_EQUAL (nodes [1]->outEdges ().size (), 1);
+  BOOST_CHECK_EQUAL (r->connectedComponents ().size (), 2);
+}
+
+BOOST_AUTO_TEST_CASE (batchInsertion) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  // Three isolated nodes of the roadmap
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 3; ++i) {
+    q [0] = 2 * i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  BOOST_CHECK_EQUAL (r->connectedComponents ().size (), 3);
+
+  // New nodes between the nodes of the roadmap: a links 0 and 1 both ways,
+  // b is reached from 2 only, c is isolated.
+  Roadmap::Batch batch;
+  std::vector <ConfigurationPtr_t> qs;
+  for (int i = 0; i < 3; ++i) {
+    q [0] = 2 * i + 1;
+    qs.push_back (ConfigurationPtr_t (new Configuration_t (q)));
+  }
+  const std::size_t a (batch.addNode (qs [0])), b (batch.addNode (qs [1])),
+    c (batch.addNode (qs [2]));
+  batch.addEdges (nodes [0], a, (*sm) (*nodes [0]->configuration (), *qs [0]));
+  batch.addEdges (a, nodes [1], (*sm) (*qs [0], *nodes [1]->configuration ()));
+  batch.addEdge (nodes [2], b, (*sm) (*nodes [2]->configuration (), *qs [1]));
+  batch.addEdge (b, nodes [1], (*sm) (*qs [1], *nodes [1]->configuration ()));
+  BOOST_CHECK_EQUAL (batch.numberNodes (), 3);
+
+  // Ranks out of the batch are rejected before modifying the roadmap.
+  Roadmap::Batch wrong (batch);
+  wrong.addEdge (c, 3, (*sm) (*qs [2], *qs [2]));
+  BOOST_CHECK_THROW (r->addNodesAndEdges (wrong), std::invalid_argument);
+  BOOST_CHECK_EQUAL (r->nodes ().size (), 3);
+  BOOST_CHECK (r->edges ().empty ());
+
+  const NodeVector_t newNodes (r->addNodesAndEdges (batch));
+  BOOST_REQUIRE_EQUAL (newNodes.size (), 3);
+  BOOST_CHECK (*newNodes [1]->configuration () == *qs [1]);
+  BOOST_CHECK_EQUAL (r->nodes ().size (), 6);
+  BOOST_CHECK_EQUAL (r->edges ().size (), 6);
+  // 0, a and 1 are merged, b joins 2, c is alone.
+  BOOST_CHECK_EQUAL (r->connectedComponents ().size (), 3);
+  BOOST_CHECK (nodes [0]->connectedComponent () ==
+               nodes [1]->connectedComponent ());
+  BOOST_CHECK (newNodes [0]->connectedComponent () ==
+               nodes [0]->connectedComponent ());
+  BOOST_CHECK (newNodes [1]->connectedComponent () ==
+               nodes [2]->connectedComponent ());
+  BOOST_CHECK (nodes [2]->connectedComponent ()->canReach
+               (nodes [1]->connectedComponent ()));
+  BOOST_CHECK (!nodes [1]->connectedComponent ()->canReach
+               (nodes [2]->connectedComponent ()));
+  BOOST_CHECK (newNodes [2]->connectedComponent ()->nodes ().size () == 1);
+
+  // The new nodes are indexed by the nearest neighbor structure.
+  value_type d;
+  BOOST_CHECK (r->nearestNode (*qs [2], d) == newNodes [2]);
+  BOOST_CHECK_SMALL (d, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE (deferredEdges) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  NodePtr_t n0 = r->addNode (ConfigurationPtr_t (new Configuration_t (q)));
+  q [0] = 1;
+  NodePtr_t n1 = r->addNode (ConfigurationPtr_t (new Configuration_t (q)));
+
+  EdgePtr_t e (r->addEdge (n0, n1, sm, 2.));
+  BOOST_CHECK (e->deferred ());
+  BOOST_CHECK_EQUAL (e->cost (), 2.);
+  BOOST_CHECK (n0->connectedComponent ()->canReach
+	       (n1->connectedComponent ()));
+
+  // The path is built once, on first access.
+  PathPtr_t path (e->path ());
+  BOOST_REQUIRE (path);
+  BOOST_CHECK (!e->deferred ());
+  BOOST_CHECK_EQUAL (e->path (), path);
+  BOOST_CHECK_EQUAL (e->cost (), 2.);
+  BOOST_CHECK (path->initial ().isApprox (*n0->configuration ()));
+  BOOST_CHECK (path->end ().isApprox (*n1->configuration ()));
+}
+
+BOOST_AUTO_TEST_CASE (statistics) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+  r->nearestNeighbor (nearestNeighbor::createKDTree (robot, distance, 4));
+
+  Roadmap::Statistics s (r->statistics ());
+  BOOST_CHECK_EQUAL (s.nodes, 0);
+  BOOST_CHECK_EQUAL (s.averageDegree, 0);
+
+  // A chain of 20 nodes, the last edge being deferred.
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 20; ++i) {
+    q [0] = .1 * i;
+    q [1] = .05 * (i % 3);
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  for (std::size_t i = 0; i + 2 < nodes.size (); ++i)
+    addEdge (r, *sm, nodes, i, i + 1);
+  r->addEdge (nodes [18], nodes [19], sm, 1.);
+
+  s = r->statistics ();
+  BOOST_CHECK_EQUAL (s.nodes, 20);
+  BOOST_CHECK_EQUAL (s.edges, 19);
+  BOOST_CHECK_EQUAL (s.deferredEdges, 1);
+  BOOST_CHECK_EQUAL (s.connectedComponents,
+                     r->connectedComponents ().size ());
+  BOOST_CHECK_CLOSE (s.averageDegree, .95, 1e-9);
+  BOOST_CHECK (s.nodeBytes > (std::size_t) (20 * robot->configSize ()) *
+              sizeof (value_type));
+  BOOST_CHECK (s.edgeBytes > 0);
+  BOOST_CHECK (s.pathBytes > 0);
+  BOOST_CHECK (s.nearestNeighborBytes > 0);
+  BOOST_CHECK (s.connectedComponentBytes > 0);
+  BOOST_CHECK_EQUAL (s.bytes (), s.nodeBytes + s.edgeBytes + s.pathBytes +
+                     s.nearestNeighborBytes + s.connectedComponentBytes +
+                     s.distanceCacheBytes);
+  // Leaves of 4 points at most.
+  BOOST_CHECK (s.treeDepth >= 3);
+  BOOST_CHECK (s.treeAverageDepth > 1);
+  BOOST_CHECK (s.treeAverageDepth <= s.treeDepth);
+  // Computing the statistics does not build deferred paths.
+  BOOST_CHECK (nodes [18]->outEdges ().back ()->deferred ());
+
+  // Paths shared by edges are counted once.
+  const std::size_t pathBytes (s.pathBytes);
+  PathPtr_t shared (nodes [0]->outEdges ().front ()->path ());
+  r->addEdge (nodes [0], nodes [1], shared);
+  s = r->statistics ();
+  BOOST_CHECK_EQUAL (s.edges, 20);
+  BOOST_CHECK_EQUAL (s.pathBytes, pathBytes);
+  std::cout << s << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE (reducedChart) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+  BOOST_CHECK_THROW (nearestNeighbor::createReducedChart
+                     (robot, distance, ConfigProjectorPtr_t ()),
+                     std::invalid_argument);
+
+  // Joint ty is locked, the chart is the coordinate of tx.
+  ConfigProjectorPtr_t projector (ConfigProjector::create
+                                  (robot, "locked ty", 1e-4, 20));
+  JointPtr_t ty (robot->getJointByName ("ty"));
+  LiegroupElement value (ty->configurationSpace ());
+  value.vector () << 0;
+  projector->add (hpp::constraints::LockedJoint::create (ty, value));
+  BOOST_REQUIRE_EQUAL (projector->numberFreeVariables (), 1);
+  r->nearestNeighbor (nearestNeighbor::createReducedChart
+                      (robot, distance, projector));
+
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (robot->configSize ());
+  q << 0, 2;
+  nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  q << 1, 0;
+  nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+
+  // The closest node in the configuration space is nodes [1].
+  q << .1, 0;
+  value_type d;
+  Nodes_t nearest (r->nearestNeighbor ()->KnearestSearch (q, r, 1, d));
+  BOOST_REQUIRE_EQUAL (nearest.size (), 1);
+  BOOST_CHECK_EQUAL (nearest.front (), nodes [0]);
+  BOOST_CHECK_CLOSE (d, .1, 1e-8);
+  vector_t distances;
+  NodeVector_t near (r->nearestNeighbor ()->searchInConnectedComponents
+                     (q, r->connectedComponents (), distances));
+  BOOST_REQUIRE_EQUAL (near.size (), 2);
+  BOOST_CHECK_CLOSE (distances.minCoeff () + distances.maxCoeff (), 1, 1e-8);
+
+  addEdge (r, *sm, nodes, 0, 1);
+  addEdge (r, *sm, nodes, 1, 0);
+  BOOST_REQUIRE_EQUAL (r->connectedComponents ().size (), 1);
+  ConnectedComponentPtr_t cc (nodes [0]->connectedComponent ());
+  BOOST_CHECK_EQUAL (r->nearestNeighbor ()->search (q, cc, d), nodes [0]);
+  NodeVector_t ball (r->nearestNeighbor ()->withinBall (q, cc, .5));
+  BOOST_REQUIRE_EQUAL (ball.size (), 1);
+  BOOST_CHECK_EQUAL (ball [0], nodes [0]);
+  BOOST_CHECK_EQUAL (r->nearestNeighbor ()->withinBall (q, cc, 1).size (), 2);
+}
+
+value_type unitCost (const Edge&)
+{
+  return 1;
+}
+
+BOOST_AUTO_TEST_CASE (edgeCost) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 3; ++i) {
+    q [0] = .5 * i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  addEdge (r, *sm, nodes, 0, 1);
+  // By default, the cost is the length of the path.
+  for (Edges_t::const_iterator it = r->edges ().begin ();
+       it != r->edges ().end (); ++it) {
+    BOOST_CHECK_EQUAL ((*it)->cost (), (*it)->path ()->length ());
+  }
+  // Custom costs apply to existing and new edges.
+  size_type revision (r->revision ());
+  r->edgeCost (unitCost);
+  BOOST_CHECK (r->revision () != revision);
+  addEdge (r, *sm, nodes, 1, 2);
+  for (Edges_t::const_iterator it = r->edges ().begin ();
+       it != r->edges ().end (); ++it) {
+    BOOST_CHECK_EQUAL ((*it)->cost (), 1);
+  }
+  r->edgeCost (Roadmap::EdgeCost_t ());
+  BOOST_CHECK_EQUAL (r->edges ().back ()->cost (),
+		     r->edges ().back ()->path ()->length ());
+}
+
+BOOST_AUTO_TEST_CASE (clearanceCost) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+  r->edgeCost (Roadmap::ClearanceCost (1, .1));
+
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 2; ++i) {
+    q [0] = .5 * i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  addEdge (r, *sm, nodes, 0, 1);
+  EdgePtr_t edge (r->edges ().front ());
+  const value_type length (edge->path ()->length ());
+  // Unknown clearance: the cost is the length.
+  BOOST_CHECK_EQUAL (edge->clearance (), -1);
+  BOOST_CHECK_CLOSE (edge->cost (), length, 1e-8);
+  BOOST_CHECK_CLOSE (r->cost (edge->path (), -1), length, 1e-8);
+
+  size_type revision (r->revision ());
+  r->clearance (edge, .5);
+  BOOST_CHECK (r->revision () != revision);
+  BOOST_CHECK_EQUAL (edge->clearance (), .5);
+  BOOST_CHECK_CLOSE (edge->cost (), 3 * length, 1e-8);
+  BOOST_CHECK_CLOSE (r->cost (edge->path (), .5), 3 * length, 1e-8);
+  // The clearance is bounded from below.
+  BOOST_CHECK_CLOSE (r->cost (edge->path (), 0), 11 * length, 1e-8);
+}
+
+// Weighed distance counting its evaluations
+class CountingDistance : public WeighedDistance
+{
+public:
+  static boost::shared_ptr <CountingDistance> create (const DevicePtr_t& robot)
+  {
+    boost::shared_ptr <CountingDistance> ptr (new CountingDistance (robot));
+    ptr->init (ptr);
+    return ptr;
+  }
+  mutable size_type count;
+protected:
+  CountingDistance (const DevicePtr_t& robot) :
+    WeighedDistance (robot, vector_t::Ones (2)), count (0)
+  {
+  }
+  virtual value_type impl_distance (ConfigurationIn_t q1,
+                                    ConfigurationIn_t q2) const
+  {
+    ++count;
+    return WeighedDistance::impl_distance (q1, q2);
+  }
+};
+
+BOOST_AUTO_TEST_CASE (distanceCache) {
+  DevicePtr_t robot = createRobot();
+  boost::shared_ptr <CountingDistance> distance (CountingDistance::create
+                                                 (robot));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 3; ++i) {
+    q [0] = .5 * i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  // Disabled by default
+  BOOST_CHECK_EQUAL (r->distanceCacheSize (), 0);
+  size_type count (distance->count);
+  BOOST_CHECK_CLOSE (r->distance (nodes [0], nodes [1]), .5, 1e-8);
+  BOOST_CHECK_CLOSE (r->distance (nodes [0], nodes [1]), .5, 1e-8);
+  BOOST_CHECK_EQUAL (distance->count, count + 2);
+
+  r->distanceCacheSize (2);
+  count = distance->count;
+  BOOST_CHECK_CLOSE (r->distance (nodes [0], nodes [1]), .5, 1e-8);
+  BOOST_CHECK_CLOSE (r->distance (nodes [0], nodes [1]), .5, 1e-8);
+  BOOST_CHECK_EQUAL (distance->count, count + 1);
+  // Pairs are ordered.
+  BOOST_CHECK_CLOSE (r->distance (nodes [1], nodes [0]), .5, 1e-8);
+  BOOST_CHECK_EQUAL (distance->count, count + 2);
+  // The cache is full: it is emptied.
+  BOOST_CHECK_CLOSE (r->distance (nodes [0], nodes [2]), 1., 1e-8);
+  BOOST_CHECK_CLOSE (r->distance (nodes [0], nodes [1]), .5, 1e-8);
+  BOOST_CHECK_EQUAL (distance->count, count + 4);
+}
+
+BOOST_AUTO_TEST_CASE (compactRoadmap) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  // 0 <-> 1 <-> 2 -> 3 and a direct edge 0 -> 2 longer than 0 -> 1 -> 2.
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  q [0] = 0; q [1] = 0;
+  nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  q [0] = 1; q [1] = 0;
+  nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  q [0] = 2; q [1] = 0;
+  nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  q [0] = 3; q [1] = 0;
+  nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  addEdge (r, *sm, nodes, 0, 1);
+  addEdge (r, *sm, nodes, 1, 0);
+  addEdge (r, *sm, nodes, 1, 2);
+  addEdge (r, *sm, nodes, 2, 1);
+  addEdge (r, *sm, nodes, 2, 3);
+  r->edgeCost (unitCost);
+  addEdge (r, *sm, nodes, 0, 2);
+
+  CompactRoadmapPtr_t compact (CompactRoadmap::create (r));
+  BOOST_CHECK_EQUAL (compact->numberNodes (), 4);
+  BOOST_CHECK_EQUAL (compact->numberEdges (), 6);
+  for (std::size_t i = 0; i < nodes.size (); ++i) {
+    BOOST_CHECK_EQUAL (compact->node (compact->id (nodes [i])), nodes [i]);
+  }
+  const size_type n0 (compact->id (nodes [0])), n1 (compact->id (nodes [1])),
+    n2 (compact->id (nodes [2])), n3 (compact->id (nodes [3]));
+  BOOST_CHECK (compact->canReach (n0, n3));
+  BOOST_CHECK (!compact->canReach (n3, n0));
+  BOOST_CHECK_EQUAL (compact->connectedComponent (n0),
+		     compact->connectedComponent (n2));
+
+  // With unit costs, the direct edge is the shortest path.
+  CompactRoadmap::EdgeIds_t edges;
+  BOOST_CHECK (compact->shortestPath (n0, n3, edges));
+  BOOST_CHECK_EQUAL (edges.size (), 2);
+  BOOST_CHECK_EQUAL (compact->source (edges [0]), n0);
+  BOOST_CHECK_EQUAL (compact->target (edges [0]), n2);
+  BOOST_CHECK_EQUAL (compact->target (edges [1]), n3);
+  BOOST_CHECK (!compact->shortestPath (n3, n1, edges));
+  BOOST_CHECK (edges.empty ());
+
+  std::vector <value_type> costs;
+  CompactRoadmap::EdgeIds_t parents;
+  compact->shortestPaths (n1, costs, parents);
+  BOOST_CHECK_EQUAL (costs [n0], 1);
+  BOOST_CHECK_EQUAL (costs [n3], 2);
+  BOOST_CHECK_EQUAL (parents [n1], -1);
+}
+
+BOOST_AUTO_TEST_CASE (multiQuery) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  p->steeringMethod (sm);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  // Chain of nodes along x.
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 5; ++i) {
+    q [0] = i - 2;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+    if (i > 0) {
+      addEdge (r, *sm, nodes, i - 1, i);
+      addEdge (r, *sm, nodes, i, i - 1);
+    }
+  }
+
+  MultiQuerySolverPtr_t solver (MultiQuerySolver::create (*p, r));
+  solver->numberNeighbors (1);
+  solver->numberThreads (2);
+  MultiQuerySolver::Queries_t queries;
+  Configuration_t q1 (q), q2 (q), q3 (q);
+  q1 [0] = -2; q1 [1] = .5;
+  q2 [0] = 2; q2 [1] = .5;
+  q3 [0] = 1; q3 [1] = -.5;
+  queries.push_back (MultiQuerySolver::Query_t (q1, q2));
+  queries.push_back (MultiQuerySolver::Query_t (q1, q3));
+  queries.push_back (MultiQuerySolver::Query_t (q3, q1));
+  std::vector <PathVectorPtr_t> paths (solver->solve (queries));
+  BOOST_REQUIRE_EQUAL (paths.size (), queries.size ());
+  for (std::size_t i = 0; i < queries.size (); ++i) {
+    BOOST_REQUIRE (paths [i]);
+    BOOST_CHECK (paths [i]->initial ().isApprox (queries [i].first));
+    BOOST_CHECK (paths [i]->end ().isApprox (queries [i].second));
+  }
+}
+
+void solveQueries (const MultiQuerySolverPtr_t& solver,
+                   const MultiQuerySolver::Queries_t& queries,
+                   std::vector <PathVectorPtr_t>& paths)
+{
+  paths = solver->solve (queries);
+}
+
+BOOST_AUTO_TEST_CASE (sharedRoadmap) {
+  DevicePtr_t robot = createRobot();
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+  std::vector <ProblemPtr_t> problems;
+  for (int i = 0; i < 2; ++i) {
+    problems.push_back (Problem::create(robot));
+    problems.back ()->steeringMethod (Straight::create (*problems.back ()));
+  }
+
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 5; ++i) {
+    q [0] = i - 2;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+    if (i > 0) {
+      addEdge (r, *problems [0]->steeringMethod (), nodes, i - 1, i);
+      addEdge (r, *problems [0]->steeringMethod (), nodes, i, i - 1);
+    }
+  }
+  SharedRoadmapPtr_t shared (SharedRoadmap::create (r));
+
+  // Solvers of two problems run concurrently in the same roadmap.
+  Configuration_t q1 (q), q2 (q);
+  q1 [0] = -2; q1 [1] = .5;
+  q2 [0] = 2; q2 [1] = .5;
+  std::vector <MultiQuerySolver::Queries_t> queries (2);
+  queries [0].push_back (MultiQuerySolver::Query_t (q1, q2));
+  queries [1].push_back (MultiQuerySolver::Query_t (q2, q1));
+  std::vector <std::vector <PathVectorPtr_t> > paths (2);
+  boost::thread_group threads;
+  for (std::size_t i = 0; i < 2; ++i) {
+    MultiQuerySolverPtr_t solver (MultiQuerySolver::create (*problems [i],
+                                                            shared));
+    solver->numberNeighbors (1);
+    threads.create_thread (boost::bind (&solveQueries, solver,
+                                        boost::cref (queries [i]),
+                                        boost::ref (paths [i])));
+  }
+  threads.join_all ();
+  for (std::size_t i = 0; i < 2; ++i) {
+    BOOST_REQUIRE_EQUAL (paths [i].size (), 1);
+    BOOST_REQUIRE (paths [i][0]);
+    BOOST_CHECK (paths [i][0]->initial ().isApprox (queries [i][0].first));
+    BOOST_CHECK (paths [i][0]->end ().isApprox (queries [i][0].second));
+  }
+  // The connections are not inserted in the shared roadmap.
+  BOOST_CHECK_EQUAL (r->nodes ().size (), 5);
+  BOOST_CHECK_EQUAL (r->edges ().size (), 8);
+}
+
+BOOST_AUTO_TEST_CASE (mappedRoadmap) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  p->steeringMethod (sm);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  p->distance (distance);
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  // Chain of nodes along x and an isolated node.
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 6; ++i) {
+    q [0] = i - 2; q [1] = (i == 5 ? 3 : 0);
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+    if (i > 0 && i < 5) {
+      addEdge (r, *sm, nodes, i - 1, i);
+      addEdge (r, *sm, nodes, i, i - 1);
+    }
+  }
+
+  const std::string filename ("mapped-roadmap.bin");
+  MappedRoadmap::save (r, filename, 2);
+  MappedRoadmapPtr_t mapped (MappedRoadmap::load (filename, *p));
+  CompactRoadmapPtr_t compact (CompactRoadmap::create (r));
+  BOOST_REQUIRE_EQUAL (mapped->numberNodes (), 6);
+  BOOST_REQUIRE_EQUAL (mapped->numberEdges (), 8);
+  for (size_type i = 0; i < mapped->numberNodes (); ++i) {
+    BOOST_CHECK (mapped->configuration (i) ==
+                 *compact->node (i)->configuration ());
+    BOOST_CHECK_EQUAL (mapped->edgeBegin (i), compact->edgeBegin (i));
+    BOOST_CHECK_EQUAL (mapped->connectedComponent (i),
+                       compact->connectedComponent (i));
+  }
+  for (size_type e = 0; e < mapped->numberEdges (); ++e) {
+    BOOST_CHECK_EQUAL (mapped->target (e), compact->target (e));
+    BOOST_CHECK_EQUAL (mapped->cost (e), compact->cost (e));
+  }
+
+  // The nearest neighbor index gives the same nodes as a linear search.
+  for (int k = 0; k < 20; ++k) {
+    Configuration_t qr (q);
+    qr [0] = 6 * value_type (rand ()) / RAND_MAX - 3;
+    qr [1] = 4 * value_type (rand ()) / RAND_MAX - 1;
+    value_type best (std::numeric_limits <value_type>::infinity ()), d;
+    for (size_type i = 0; i < mapped->numberNodes (); ++i)
+      best = std::min (best, (*distance) (qr, mapped->configuration (i)));
+    const size_type nearest (mapped->nearestNode (qr, d));
+    BOOST_CHECK_CLOSE (d, best, 1e-9);
+    BOOST_CHECK_CLOSE ((*distance) (qr, mapped->configuration (nearest)),
+                       best, 1e-9);
+  }
+
+  // Paths are rebuilt by the steering method and kept.
+  const size_type n0 (compact->id (nodes [0])), n4 (compact->id (nodes [4])),
+    n5 (compact->id (nodes [5]));
+  MappedRoadmap::EdgeIds_t edges;
+  BOOST_CHECK (!mapped->canReach (n0, n5));
+  BOOST_CHECK (!mapped->shortestPath (n0, n5, edges));
+  BOOST_REQUIRE (mapped->shortestPath (n0, n4, edges));
+  BOOST_CHECK_EQUAL (edges.size (), 4);
+  BOOST_CHECK (mapped->path (edges [0]) == mapped->path (edges [0]));
+  PathVectorPtr_t path (mapped->pathVector (edges));
+  BOOST_CHECK (path->initial () == *nodes [0]->configuration ());
+  BOOST_CHECK (path->end () == *nodes [4]->configuration ());
+  mapped.reset ();
+
+  // Other files are rejected.
+  {
+    std::ofstream os (filename.c_str (), std::ios::binary | std::ios::trunc);
+    os << "not a roadmap, but long enough to have a header";
+  }
+  BOOST_CHECK_THROW (MappedRoadmap::load (filename, *p), std::runtime_error);
+  std::remove (filename.c_str ());
+}
+
+BOOST_AUTO_TEST_CASE (roadmapCheckpoint) {
+  DevicePtr_t robot = createRobot();
+  ProblemPtr_t p = Problem::create(robot);
+  StraightPtr_t sm = Straight::create (*p);
+  p->steeringMethod (sm);
+  hpp::core::DistancePtr_t distance (WeighedDistance::createWithWeight
+				     (robot, vector_t::Ones(2)));
+  p->distance (distance);
+  RoadmapPtr_t r = Roadmap::create (distance, robot);
+
+  const std::string filename ("roadmap-checkpoint.bin");
+  RoadmapCheckpointPtr_t stream (RoadmapCheckpoint::create (r, robot,
+                                                            filename));
+  std::vector <NodePtr_t> nodes;
+  Configuration_t q (Configuration_t::Zero (robot->configSize ()));
+  for (int i = 0; i < 3; ++i) {
+    q [0] = i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  r->initNode (nodes [0]->configuration ());
+  addEdge (r, *sm, nodes, 0, 1);
+  addEdge (r, *sm, nodes, 1, 0);
+  stream->checkpoint ();
+
+  // Modifications since the first checkpoint.
+  for (int i = 3; i < 5; ++i) {
+    q [0] = i;
+    nodes.push_back (r->addNode (ConfigurationPtr_t (new Configuration_t (q))));
+  }
+  r->addGoalNode (nodes [3]->configuration ());
+  PathPtr_t path12 ((*sm) (*nodes [1]->configuration (),
+			   *nodes [2]->configuration ()));
+  PathPtr_t path34 ((*sm) (*nodes [3]->configuration (),
+			   *nodes [4]->configuration ()));
+  r->addEdges (nodes [1], nodes [2], path12, false);
+  r->addEdges (nodes [3], nodes [4], path34, false);
+  r->validateEdge (nodes [1]->outEdges ().back ());
+  r->removeEdge (nodes [3]->outEdges ().front ());
+  stream->checkpoint ();
+  BOOST_CHECK_EQUAL (stream->numberCheckpoints (), 2);
+  stream.reset ();
+  {
+    // A checkpoint interrupted by a crash.
+    std::ofstream os (filename.c_str (), std::ios::binary | std::ios::app);
+    os << "N12";
+  }
+
+  RoadmapPtr_t loaded (RoadmapCheckpoint::load (filename, *p));
+  BOOST_CHECK_EQUAL (loaded->nodes ().size (), 5);
+  BOOST_CHECK_EQUAL (loaded->edges ().size (), 5);
+  BOOST_CHECK_EQUAL (loaded->connectedComponents ().size (),
+                     r->connectedComponents ().size ());
+  BOOST_REQUIRE (loaded->initNode ());
+  BOOST_CHECK (*loaded->initNode ()->configuration () ==
+               *nodes [0]->configuration ());
+  BOOST_REQUIRE_EQUAL (loaded->goalNodes ().size (), 1);
+  BOOST_CHECK (*loaded->goalNodes () [0]->configuration () ==
+               *nodes [3]->configuration ());
+  size_type validated (0);
+  for (Edges_t::const_iterator it = loaded->edges ().begin ();
+       it != loaded->edges ().end (); ++it) {
+    if ((*it)->validated ()) ++validated;
+    BOOST_CHECK ((*it)->deferred ());
+  }
+  BOOST_CHECK_EQUAL (validated, 3);
+  BOOST_CHECK (loaded->edges ().front ()->path ());
+
+  std::remove (filename.c_str ());
+}
+
 template<typename Base>
 struct oarchive : Base, hpp::serialization::archive_device_wrapper
 {
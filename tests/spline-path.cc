@@ -171,6 +171,22 @@ void check_velocity_bounds ()
   value_type t0 = spline->timeRange().first, t1 = spline->timeRange().second;
   spline->velocityBound (vb1, t0, t1);
 
+  // The bound holds on a sub-interval. The rotation part of the root joint
+  // is skipped: the bound is computed in the tangent space at the base.
+  {
+    const value_type L = spline->length(),
+                     s0 = t0 + 0.25 * L, s1 = t0 + 0.6 * L;
+    vector_t bound (dev->numberDof()), v (dev->numberDof());
+    spline->velocityBound (bound, s0, s1);
+    for (value_type t = s0; t <= s1; t += 0.05 * L) {
+      spline->derivative (v, t, 1);
+      BOOST_CHECK ((v.head<3>().cwiseAbs().array() <=
+                    bound.head<3>().array() + 1e-8).all());
+      BOOST_CHECK ((v.tail(dev->numberDof() - 6).cwiseAbs().array() <=
+                    bound.tail(dev->numberDof() - 6).array() + 1e-8).all());
+    }
+  }
+
   std::size_t N = 1000;
   value_type step = spline->length() / value_type(N);
   for (std::size_t i = 0; i < N; ++i) {
@@ -197,3 +213,89 @@ BOOST_AUTO_TEST_CASE (spline_bernstein_velocity)
 {
   check_velocity_bounds<path::BernsteinBasis, 3>();
 }
+
+template <int SplineType, int Degree>
+void check_batch_evaluation ()
+{
+  typedef path::Spline<SplineType, Degree> path_t;
+  typedef steeringMethod::Spline<SplineType, Degree> SM_t;
+
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  // Bernstein polynomials are a partition of unity.
+  typename path_t::BasisFunctionVector_t b;
+  for (value_type u = 0; u <= 1; u += 0.125) {
+    path_t::timeFreeBasisFunctionDerivative (0, u, b);
+    BOOST_CHECK_CLOSE (b.sum(), 1, 1e-8);
+    path_t::timeFreeBasisFunctionDerivative (1, u, b);
+    BOOST_CHECK_SMALL (b.sum(), 1e-8);
+  }
+
+  Configuration_t q1 (::pinocchio::randomConfiguration(dev->model()));
+  Configuration_t q2 (::pinocchio::randomConfiguration(dev->model()));
+  std::vector<int> orders (1, 1);
+  vector_t v1 (vector_t::Random(dev->numberDof())),
+           v2 (vector_t::Random(dev->numberDof()));
+  typename SM_t::Ptr_t sm (SM_t::create (*problem));
+  PathPtr_t spline = sm->steer (q1, orders, v1, q2, orders, v2);
+
+  const size_type N = 20;
+  vector_t times (vector_t::LinSpaced (N, spline->timeRange().first,
+                                       spline->timeRange().second));
+  matrix_t configs (dev->configSize(), N);
+  BOOST_CHECK_EQUAL (spline->eval (times, configs), N);
+  Configuration_t q (dev->configSize());
+  for (size_type i = 0; i < N; ++i) {
+    BOOST_REQUIRE ((*spline) (q, times[i]));
+    CONFIGURATION_VECTOR_IS_APPROX(dev, configs.col(i), q, 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (spline_bernstein_batch)
+{
+  check_batch_evaluation<path::BernsteinBasis, 3>();
+  check_batch_evaluation<path::BernsteinBasis, 5>();
+}
+
+template <int SplineType, int Degree>
+void check_batch_steering ()
+{
+  typedef steeringMethod::Spline<SplineType, Degree> SM_t;
+
+  DevicePtr_t dev = createRobot();
+  BOOST_REQUIRE (dev);
+  ProblemPtr_t problem = Problem::create(dev);
+
+  Configuration_t q1 (::pinocchio::randomConfiguration(dev->model()));
+  matrix_t targets (dev->configSize(), 5);
+  for (size_type i = 0; i < targets.cols(); ++i)
+    targets.col(i) = ::pinocchio::randomConfiguration(dev->model());
+  targets.col(0) = q1;
+
+  typename SM_t::Ptr_t sm (SM_t::create (*problem));
+  std::vector<PathPtr_t> paths;
+  sm->steer (q1, targets, paths);
+  BOOST_REQUIRE_EQUAL (paths.size(), (std::size_t) targets.cols());
+  Configuration_t q (dev->configSize()), qb (dev->configSize());
+  for (size_type i = 0; i < targets.cols(); ++i) {
+    BOOST_REQUIRE (paths[i]);
+    PathPtr_t path = (*sm) (q1, targets.col(i));
+    BOOST_REQUIRE (path);
+    BOOST_CHECK_EQUAL (paths[i]->length(), path->length());
+    for (value_type u = 0; u <= 1; u += 0.125) {
+      value_type t = u * path->length();
+      BOOST_REQUIRE ((*path) (q, t));
+      BOOST_REQUIRE ((*paths[i]) (qb, t));
+      CONFIGURATION_VECTOR_IS_APPROX(dev, qb, q, 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE (spline_bernstein_batch_steering)
+{
+  check_batch_steering<path::BernsteinBasis, 1>();
+  check_batch_steering<path::BernsteinBasis, 3>();
+  check_batch_steering<path::BernsteinBasis, 5>();
+}
@@ -20,11 +20,19 @@
 
 #include <pinocchio/fwd.hpp>
 
+#include <cmath>
+
 #include <boost/test/included/unit_test.hpp>
 
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/urdf/util.hh>
+
 #include <hpp/core/problem.hh>
 #include <hpp/core/problem-solver.hh>
 #include <hpp/core/config-validations.hh>
+#include <hpp/core/joint-bound-validation.hh>
+#include <hpp/core/straight-path.hh>
+#include <hpp/core/path-validation/discretized-joint-bound.hh>
 
 using namespace hpp::core;
 
@@ -62,3 +70,139 @@ BOOST_AUTO_TEST_CASE ( test_add_config_validation )
       (problem->configValidations ()->numberConfigValidations () == 1,
        "Adding CollisionValidation to the ProblemSolver did not work");
 }
+
+// Configuration validation counting its calls
+class CountingValidation : public ConfigValidation
+{
+public:
+  CountingValidation () : calls (0) {}
+  bool validate (const Configuration_t& config, ValidationReportPtr_t&)
+  {
+    ++calls;
+    return config [0] > 0;
+  }
+  size_type calls;
+};
+
+BOOST_AUTO_TEST_CASE (config_validations_cache)
+{
+  boost::shared_ptr <CountingValidation> counting (new CountingValidation);
+  ConfigValidationsPtr_t configValidations = ConfigValidations::create ();
+  configValidations->add (counting);
+  configValidations->cacheSize (2);
+
+  Configuration_t q1 (1), q2 (1), q3 (1);
+  q1 << 1; q2 << -1; q3 << 2;
+  ValidationReportPtr_t report;
+  BOOST_CHECK (configValidations->validate (q1, report));
+  BOOST_CHECK (!configValidations->validate (q2, report));
+  BOOST_CHECK (configValidations->validate (q1, report));
+  BOOST_CHECK (!configValidations->validate (q2, report));
+  BOOST_CHECK_EQUAL (counting->calls, 2);
+  BOOST_CHECK_EQUAL (configValidations->cacheHits (), 2);
+  BOOST_CHECK_EQUAL (configValidations->cacheMisses (), 2);
+
+  // q1 is the least recently used result and is discarded.
+  BOOST_CHECK (configValidations->validate (q3, report));
+  BOOST_CHECK (configValidations->validate (q1, report));
+  BOOST_CHECK_EQUAL (counting->calls, 4);
+
+  // Close configurations share their result.
+  configValidations->cacheResolution (.5);
+  q3 [0] = 1.1;
+  BOOST_CHECK (configValidations->validate (q1, report));
+  BOOST_CHECK (configValidations->validate (q3, report));
+  BOOST_CHECK_EQUAL (counting->calls, 5);
+
+  configValidations->clearCache ();
+  BOOST_CHECK (configValidations->validate (q1, report));
+  BOOST_CHECK_EQUAL (counting->calls, 6);
+}
+
+// Configuration validation accepting every configuration after a
+// computation
+class SlowValidation : public ConfigValidation
+{
+public:
+  SlowValidation () : calls (0) {}
+  bool validate (const Configuration_t& config, ValidationReportPtr_t&)
+  {
+    ++calls;
+    value_type sum (0);
+    for (int i = 0; i < 1000; ++i) sum += std::sqrt ((value_type) i + std::fabs (config [0]));
+    return sum == sum;
+  }
+  size_type calls;
+};
+
+BOOST_AUTO_TEST_CASE (config_validations_ordering)
+{
+  boost::shared_ptr <SlowValidation> slow (new SlowValidation);
+  boost::shared_ptr <CountingValidation> counting (new CountingValidation);
+  ConfigValidationsPtr_t configValidations = ConfigValidations::create ();
+  configValidations->add (slow);
+  configValidations->add (counting);
+  BOOST_CHECK (!configValidations->adaptiveOrdering ());
+  configValidations->adaptiveOrdering (true);
+
+  // The measures of the first evaluations are in insertion order.
+  Configuration_t q (1);
+  q << -1;
+  ValidationReportPtr_t report;
+  for (int i = 0; i < 100; ++i)
+    BOOST_CHECK (!configValidations->validate (q, report));
+  BOOST_CHECK_EQUAL (slow->calls, 100);
+  BOOST_CHECK_EQUAL (counting->calls, 100);
+
+  // Then the validation that always fails is evaluated first.
+  for (int i = 0; i < 100; ++i)
+    BOOST_CHECK (!configValidations->validate (q, report));
+  BOOST_CHECK_EQUAL (slow->calls, 100);
+  BOOST_CHECK_EQUAL (counting->calls, 200);
+
+  // Valid configurations are checked by both validations.
+  q << 1;
+  BOOST_CHECK (configValidations->validate (q, report));
+  BOOST_CHECK_EQUAL (slow->calls, 101);
+
+  // Adding a validation resets the order.
+  configValidations->add (ConfigValidationPtr_t (new SlowValidation));
+  q << -1;
+  BOOST_CHECK (!configValidations->validate (q, report));
+  BOOST_CHECK_EQUAL (slow->calls, 102);
+}
+
+BOOST_AUTO_TEST_CASE (joint_bound_certification)
+{
+  std::string urdf ("<robot name='test'>"
+      "<link name='link0'/>"
+      "<joint name='joint0' type='prismatic'>"
+        "<parent link='link0'/>"
+        "<child  link='link1'/>"
+        "<limit effort='30' velocity='1.0' lower='-4' upper='4'/>"
+      "</joint>"
+      "<link name='link1'/>"
+      "</robot>"
+      );
+  DevicePtr_t robot = hpp::pinocchio::Device::create ("test");
+  hpp::pinocchio::urdf::loadModelFromString (robot, 0, "", "anchor", urdf,
+                                             "");
+  JointBoundValidationPtr_t jointBounds (JointBoundValidation::create (robot));
+
+  Configuration_t q1 (1), q2 (1), q3 (1);
+  q1 << 1; q2 << 3; q3 << 5;
+  PathPtr_t inside (StraightPath::create (robot, q1, q2, 1));
+  PathPtr_t outside (StraightPath::create (robot, q1, q3, 1));
+  BOOST_CHECK (jointBounds->certifies (inside));
+  BOOST_CHECK (!jointBounds->certifies (outside));
+
+  // Certified paths are valid without sampling, others are sampled.
+  PathValidationPtr_t pathValidation
+    (pathValidation::createDiscretizedJointBound (robot, 0.1));
+  PathPtr_t validPart;
+  PathValidationReportPtr_t report;
+  BOOST_CHECK (pathValidation->validate (inside, false, validPart, report));
+  BOOST_CHECK (validPart == inside);
+  BOOST_CHECK (!pathValidation->validate (outside, false, validPart, report));
+  BOOST_CHECK_CLOSE (validPart->length (), .7, 1e-6);
+}
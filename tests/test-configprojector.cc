@@ -166,4 +166,132 @@ BOOST_AUTO_TEST_CASE (copy)
   BOOST_CHECK (success);
 }
 
+BOOST_AUTO_TEST_CASE (warm_start)
+{
+  DevicePtr_t dev = createRobot();
+  JointPtr_t xyz = dev->getJointByName ("root_joint");
+  ConfigProjectorPtr_t projector =
+    ConfigProjector::create (dev, "test", 1e-4, 20);
+  matrix3_t rot; rot.setIdentity ();
+  vector3_t zero; zero.setZero();
+  PositionPtr_t position
+    (Position::create ("Position", dev, xyz, Transform3f (rot, zero),
+                       Transform3f(rot,vector3_t (1,1,1))));
+  projector->add (constraints::Implicit::create
+                  (position, ComparisonTypes_t (3, constraints::Equality)));
+  projector->warmStartRadius (.1);
+  BOOST_CHECK_EQUAL (projector->warmStartRadius (), .1);
+
+  Configuration_t q (dev->neutralConfiguration ());
+  q.head<3> ().setZero ();
+  Configuration_t q1 (q);
+  BOOST_CHECK (projector->apply (q1));
+  BOOST_CHECK_EQUAL (projector->warmStarts (), 0);
+
+  // Close to the last projected configuration
+  q [7] += .05;
+  Configuration_t q2 (q);
+  BOOST_CHECK (projector->apply (q2));
+  BOOST_CHECK_EQUAL (projector->warmStarts (), 1);
+  BOOST_CHECK_EQUAL (projector->warmStartSuccesses (), 1);
+  BOOST_CHECK (projector->isSatisfied (q2));
+  BOOST_CHECK_SMALL (q2 [7] - q [7], 1e-6);
+
+  // Far from the last projected configuration
+  q.head<3> ().setConstant (-1);
+  Configuration_t q3 (q);
+  BOOST_CHECK (projector->apply (q3));
+  BOOST_CHECK_EQUAL (projector->warmStarts (), 1);
+  BOOST_CHECK (projector->isSatisfied (q3));
+}
+
+BOOST_AUTO_TEST_CASE (batch)
+{
+  DevicePtr_t dev = createRobot();
+  JointPtr_t xyz = dev->getJointByName ("root_joint");
+  ConfigProjectorPtr_t projector =
+    ConfigProjector::create (dev, "test", 1e-4, 20);
+  matrix3_t rot; rot.setIdentity ();
+  vector3_t zero; zero.setZero();
+  PositionPtr_t position
+    (Position::create ("Position", dev, xyz, Transform3f (rot, zero),
+                       Transform3f(rot,vector3_t (1,1,1))));
+  projector->add (constraints::Implicit::create
+                  (position, ComparisonTypes_t (3, constraints::Equality)));
+  ConstraintSetPtr_t cs = ConstraintSet::create (dev, "batch");
+  cs->addConstraint (projector);
+
+  const size_type n = 5;
+  matrix_t qs (dev->configSize (), n);
+  for (size_type i = 0; i < n; ++i) {
+    qs.col (i) = dev->neutralConfiguration ();
+    qs.col (i).head<3> ().setConstant (- (value_type) i / n);
+  }
+  matrix_t serial (qs), parallel (qs);
+  ArrayXb success;
+  vector_t residuals;
+  BOOST_CHECK_THROW (cs->apply (parallel, success, residuals, 0),
+                     std::invalid_argument);
+  BOOST_CHECK (cs->apply (serial, success, residuals));
+  BOOST_CHECK_EQUAL (success.size (), n);
+  BOOST_CHECK_EQUAL (residuals.size (), n);
+  BOOST_CHECK (projector->apply (parallel, success, residuals, 3));
+  BOOST_CHECK (success.all ());
+  for (size_type i = 0; i < n; ++i) {
+    BOOST_CHECK (projector->isSatisfied (parallel.col (i)));
+    BOOST_CHECK ((serial.col (i) - parallel.col (i)).isZero (1e-10));
+  }
+}
+
+BOOST_AUTO_TEST_CASE (early_abort)
+{
+  DevicePtr_t dev = createRobot();
+  JointPtr_t xyz = dev->getJointByName ("root_joint");
+  ConfigProjectorPtr_t projector =
+    ConfigProjector::create (dev, "test", 1e-4, 20);
+  matrix3_t rot; rot.setIdentity ();
+  vector3_t zero; zero.setZero();
+  ComparisonTypes_t equality (3, constraints::Equality);
+  projector->add (constraints::Implicit::create
+                  (Position::create ("Position", dev, xyz,
+                                     Transform3f (rot, zero),
+                                     Transform3f (rot, vector3_t (1,1,1))),
+                   equality));
+  BOOST_CHECK_THROW (projector->earlyAbort (1), std::invalid_argument);
+  BOOST_CHECK_THROW (projector->earlyAbort (.1, 0), std::invalid_argument);
+  projector->earlyAbort (.1, 2);
+
+  // Feasible constraint
+  Configuration_t q (dev->neutralConfiguration ());
+  q.head<3> ().setZero ();
+  BOOST_CHECK (projector->apply (q));
+  BOOST_CHECK (projector->isSatisfied (q));
+  BOOST_CHECK (projector->lastIterations () < projector->maxIterations ());
+
+  // Contradictory constraints: the error stagnates.
+  projector->add (constraints::Implicit::create
+                  (Position::create ("Position2", dev, xyz,
+                                     Transform3f (rot, zero),
+                                     Transform3f (rot, zero)),
+                   equality));
+  q.head<3> ().setZero ();
+  BOOST_CHECK (!projector->apply (q));
+  BOOST_CHECK (projector->lastIterations () < projector->maxIterations ());
+}
+
+BOOST_AUTO_TEST_CASE (compress_workspace)
+{
+  DevicePtr_t dev = createRobot();
+  ConfigProjectorPtr_t projector =
+    ConfigProjector::create (dev, "test", 1e-4, 20);
+  vector_t v (vector_t::Random (dev->numberDof ()));
+  vector_t small (projector->numberFreeVariables ()),
+    normal (dev->numberDof ());
+  projector->compressVector (v, small);
+  BOOST_CHECK (projector->compressVector (v) == small);
+  normal.setZero ();
+  projector->uncompressVector (small, normal);
+  BOOST_CHECK (projector->uncompressVector (small) == normal);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
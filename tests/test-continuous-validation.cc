@@ -15,6 +15,8 @@
 // hpp-constraints. If not, see <http://www.gnu.org/licenses/>.
 
 #define BOOST_TEST_MODULE ContinuousValidation
+#include <cmath>
+
 #include <pinocchio/fwd.hpp>
 
 #include <boost/test/included/unit_test.hpp>
@@ -55,6 +57,8 @@ using hpp::core::ConfigValidationPtr_t;
 using hpp::core::continuousCollisionChecking::Dichotomy;
 using hpp::core::continuousCollisionChecking::Progressive;
 using hpp::core::pathValidation::createDiscretizedCollisionChecking;
+using hpp::core::pathValidation::createAdaptiveDiscretizedCollisionChecking;
+using hpp::core::pathValidation::DiscretizedPtr_t;
 using hpp::core::PathPtr_t;
 using hpp::core::PathValidationPtr_t;
 using hpp::core::PathValidationReportPtr_t;
@@ -148,6 +152,10 @@ BOOST_AUTO_TEST_CASE (continuous_validation_straight)
   PathValidationPtr_t progressive (Progressive::create (robot, 0.001));
   PathValidationPtr_t discretized (createDiscretizedCollisionChecking
                                    (robot, 0.05));
+  PathValidationPtr_t adaptive (createAdaptiveDiscretizedCollisionChecking
+                                (robot, 0.05));
+  DiscretizedPtr_t parallel (createDiscretizedCollisionChecking (robot, 0.05));
+  parallel->numberThreads (4);
   // create configuration validation instance
   ConfigValidationPtr_t configValidation (CollisionValidation::create (robot));
   ValidationReportPtr_t collisionReport;
@@ -169,10 +177,29 @@ BOOST_AUTO_TEST_CASE (continuous_validation_straight)
     PathValidationReportPtr_t report1;
     PathValidationReportPtr_t report2;
     PathValidationReportPtr_t report3;
+    PathValidationReportPtr_t report4;
+    PathValidationReportPtr_t report5;
     PathPtr_t path ((*sm) (q1, q2));
     PathPtr_t validPart;
     if (configValidation->validate (q1, collisionReport)) {
       bool res1 (discretized->validate (path, false, validPart, report1));
+      PathPtr_t adaptiveValidPart, parallelValidPart;
+      bool res4 (adaptive->validate (path, false, adaptiveValidPart, report4));
+      bool res5 (parallel->validate (path, false, parallelValidPart, report5));
+      hpp::core::value_type lastValidTime;
+      bool res6 (discretized->isValid (path, false, lastValidTime));
+#pragma omp critical
+      {
+        BOOST_CHECK_EQUAL (res1, res4);
+        BOOST_CHECK_SMALL (validPart->length () -
+                           adaptiveValidPart->length (), 1e-8);
+        BOOST_CHECK_EQUAL (res1, res5);
+        BOOST_CHECK_SMALL (validPart->length () -
+                           parallelValidPart->length (), 1e-8);
+        BOOST_CHECK_EQUAL (res1, res6);
+        BOOST_CHECK_SMALL (validPart->length () - std::fabs
+                           (lastValidTime - path->timeRange ().first), 1e-8);
+      }
       bool res2 (progressive->validate  (path, false, validPart, report2));
       bool res3 (dichotomy->validate (path, false, validPart, report3));
 
@@ -211,6 +238,23 @@ BOOST_AUTO_TEST_CASE (continuous_validation_straight)
     }
     if (configValidation->validate (q2, collisionReport)) {
       bool res1 (discretized->validate (path, true, validPart, report1));
+      PathPtr_t adaptiveValidPart, parallelValidPart;
+      bool res4 (adaptive->validate (path, true, adaptiveValidPart, report4));
+      bool res5 (parallel->validate (path, true, parallelValidPart, report5));
+      hpp::core::value_type lastValidTime;
+      bool res6 (discretized->isValid (path, true, lastValidTime));
+#pragma omp critical
+      {
+        BOOST_CHECK_EQUAL (res1, res4);
+        BOOST_CHECK_SMALL (validPart->length () -
+                           adaptiveValidPart->length (), 1e-8);
+        BOOST_CHECK_EQUAL (res1, res5);
+        BOOST_CHECK_SMALL (validPart->length () -
+                           parallelValidPart->length (), 1e-8);
+        BOOST_CHECK_EQUAL (res1, res6);
+        BOOST_CHECK_SMALL (validPart->length () - std::fabs
+                           (lastValidTime - path->timeRange ().second), 1e-8);
+      }
       bool res2 (progressive->validate  (path, true, validPart, report2));
       bool res3 (dichotomy->validate (path, true, validPart, report3));
 
@@ -384,6 +428,113 @@ template <typename SplineSteeringMethod> void test_spline_steering_method ()
   // delete problem
 }
 
+BOOST_AUTO_TEST_CASE (continuous_validation_parallel)
+{
+  #include "../tests/random-numbers.hh"
+
+  // Load robot model (ur5)
+  DevicePtr_t robot (Device::create ("ur5"));
+  loadModel (robot, 0, "", "anchor",
+             "package://example-robot-data/robots/ur_description/"
+             "urdf/ur5_joint_limited_robot.urdf",
+             "package://example-robot-data/robots/ur_description/"
+             "srdf/ur5_joint_limited_robot.srdf");
+  robot->numberDeviceData (4);
+  ProblemPtr_t problem = Problem::create(robot);
+  SteeringMethodPtr_t sm (Straight::create (*problem));
+
+  hpp::core::continuousValidation::ProgressivePtr_t sequential
+    (Progressive::create (robot, 0.001));
+  hpp::core::continuousValidation::ProgressivePtr_t parallel
+    (Progressive::create (robot, 0.001));
+  parallel->numberThreads (4);
+
+  std::vector <PathPtr_t> paths;
+  for (size_type i = 0; i < n1; ++i) {
+    Configuration_t q1 (m1.row (2 * i)), q2 (m1.row (2 * i + 1));
+    paths.push_back ((*sm) (q1, q2));
+  }
+  std::vector <PathPtr_t> validParts;
+  std::vector <PathValidationReportPtr_t> reports;
+  std::vector <bool> valid;
+
+  // Paths validated concurrently and body pairs split among threads give
+  // the same results as sequential validation.
+  for (int split = 0; split < 2; ++split) {
+    parallel->splitIntervalValidations (split == 1);
+    parallel->validatePaths (paths, false, validParts, reports, valid);
+    BOOST_REQUIRE_EQUAL (valid.size (), paths.size ());
+    for (std::size_t i = 0; i < paths.size (); ++i) {
+      PathPtr_t validPart;
+      PathValidationReportPtr_t report;
+      bool res (sequential->validate (paths [i], false, validPart, report));
+      BOOST_CHECK_EQUAL (valid [i], res);
+      BOOST_CHECK_CLOSE (validParts [i]->length (), validPart->length (),
+                         1e-6);
+    }
+  }
+
+  // Stopping at the first invalid path
+  parallel->splitIntervalValidations (false);
+  sequential->numberThreads (1);
+  std::size_t firstInvalid (paths.size ());
+  for (std::size_t i = 0; i < paths.size (); ++i) {
+    if (!valid [i]) {
+      firstInvalid = i;
+      break;
+    }
+  }
+  BOOST_CHECK_EQUAL (sequential->validatePaths (paths, false, validParts,
+                                                reports, valid, true),
+                     firstInvalid == paths.size ());
+  for (std::size_t i = firstInvalid + 1; i < paths.size (); ++i) {
+    BOOST_CHECK (!valid [i]);
+    BOOST_CHECK (!validParts [i]);
+  }
+  BOOST_CHECK (!parallel->validatePaths (paths, false, validParts, reports,
+                                         valid, true) ||
+               firstInvalid == paths.size ());
+}
+
+BOOST_AUTO_TEST_CASE (continuous_validation_dichotomy_parallel)
+{
+  #include "../tests/random-numbers.hh"
+
+  // Load robot model (ur5)
+  DevicePtr_t robot (Device::create ("ur5"));
+  loadModel (robot, 0, "", "anchor",
+             "package://example-robot-data/robots/ur_description/"
+             "urdf/ur5_joint_limited_robot.urdf",
+             "package://example-robot-data/robots/ur_description/"
+             "srdf/ur5_joint_limited_robot.srdf");
+  robot->numberDeviceData (4);
+  ProblemPtr_t problem = Problem::create(robot);
+  SteeringMethodPtr_t sm (Straight::create (*problem));
+
+  hpp::core::continuousValidation::DichotomyPtr_t sequential
+    (Dichotomy::create (robot, 0));
+  hpp::core::continuousValidation::DichotomyPtr_t parallel
+    (Dichotomy::create (robot, 0));
+  parallel->numberThreads (4);
+
+  // The levels of the breadth first search validated in parallel give the
+  // same results as sequential validation.
+  for (size_type i = 0; i < n1; ++i) {
+    Configuration_t q1 (m1.row (2 * i)), q2 (m1.row (2 * i + 1));
+    PathPtr_t path ((*sm) (q1, q2));
+    for (int reverse = 0; reverse < 2; ++reverse) {
+      PathPtr_t validPart1, validPart2;
+      PathValidationReportPtr_t report1, report2;
+      bool res1 (sequential->validate (path, reverse == 1, validPart1,
+                                       report1));
+      bool res2 (parallel->validate (path, reverse == 1, validPart2,
+                                     report2));
+      BOOST_CHECK_EQUAL (res1, res2);
+      BOOST_CHECK (validPart2->length () <= path->length () + 1e-8);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE (continuous_validation_spline)
 {
   test_spline_steering_method<hpp::core::steeringMethod::Spline<hpp::core::path::BernsteinBasis, 3> >();
@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2014 CNRS
+// Authors: Florent Lamiraux
+//
+// This file is part of hpp-core
+// hpp-core is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+//
+// hpp-core is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// hpp-core  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#define BOOST_TEST_MODULE distance_field
+
+#include <cstdio>
+
+#include <pinocchio/fwd.hpp>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <hpp/core/distance-field.hh>
+
+using hpp::core::DistanceField;
+using hpp::core::DistanceFieldPtr_t;
+using hpp::core::size_type;
+using hpp::core::value_type;
+using hpp::core::vector3_t;
+
+// Grid of 10 x 10 x 10 voxels of side 0.1 storing the exact distance to a
+// point obstacle at the center of the grid.
+DistanceFieldPtr_t pointObstacle ()
+{
+  DistanceFieldPtr_t field (DistanceField::create (vector3_t::Zero (), .1,
+                                                   10, 10, 10));
+  const vector3_t obstacle (.5, .5, .5);
+  for (size_type i = 0; i < 10; ++i)
+    for (size_type j = 0; j < 10; ++j)
+      for (size_type k = 0; k < 10; ++k) {
+        const vector3_t center (.1 * ((value_type) i + .5),
+                                .1 * ((value_type) j + .5),
+                                .1 * ((value_type) k + .5));
+        field->value (i, j, k, (float) (center - obstacle).norm ());
+      }
+  return field;
+}
+
+BOOST_AUTO_TEST_CASE (lower_bound)
+{
+  DistanceFieldPtr_t field (pointObstacle ());
+  const vector3_t obstacle (.5, .5, .5);
+  for (int n = 0; n < 1000; ++n) {
+    const vector3_t p (1.4 * vector3_t::Random ().cwiseAbs () -
+                       .2 * vector3_t::Ones ());
+    const value_type d ((p - obstacle).norm ());
+    const value_type bound (field->distanceLowerBound (p));
+    BOOST_CHECK (bound <= d + 1e-6);
+    // Inside the grid, the bound is within a voxel diagonal.
+    if ((p.array () >= 0).all () && (p.array () < 1).all ())
+      BOOST_CHECK (bound >= d - .1 * std::sqrt (3.) - 1e-6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE (save_load)
+{
+  DistanceFieldPtr_t field (pointObstacle ());
+  const std::string filename ("distance-field.sdf");
+  field->save (filename);
+  DistanceFieldPtr_t loaded (DistanceField::load (filename));
+  std::remove (filename.c_str ());
+  BOOST_CHECK_EQUAL (loaded->resolution (), field->resolution ());
+  BOOST_CHECK (loaded->origin () == field->origin ());
+  for (size_type a = 0; a < 3; ++a)
+    BOOST_CHECK_EQUAL (loaded->size (a), field->size (a));
+  BOOST_CHECK_EQUAL (loaded->value (3, 4, 5), field->value (3, 4, 5));
+  BOOST_CHECK_THROW (DistanceField::load ("no-such-file.sdf"),
+                     std::runtime_error);
+}
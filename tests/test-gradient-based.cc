@@ -137,4 +137,51 @@ BOOST_AUTO_TEST_CASE (BFGS)
   hppDout (info, (p3 - r3).norm ());
   hppDout (info, (p4 - r4).norm ());
 }
+
+// Optimize the circular path above with the dense and the sparse storage of
+// the Hessian of the cost and check that both give the same path.
+BOOST_AUTO_TEST_CASE (sparseQP)
+{
+  DevicePtr_t robot = createRobot ();
+  Configuration_t q0 (robot->configSize ());
+  Configuration_t q1 (robot->configSize ());
+  Configuration_t q2 (robot->configSize ());
+  value_type s = sqrt (2)/2;
+  q0 (0) = -1; q0 (1) = 0; q0 (2) = 1; q0 (3) = 0;
+  q1 (0) = 0; q1 (1) = 1; q1 (2) = s; q1 (3) = s;
+  q2 (0) = 1; q2 (1) = 0; q2 (2) = 1; q2 (3) = 0;
+
+  ProblemPtr_t problem = Problem::create(robot);
+  SteeringMethodPtr_t sm = problem->steeringMethod ();
+  PathVectorPtr_t path = PathVector::create (robot->configSize (),
+					     robot->numberDof ());
+  path->appendPath ((*sm) (q0, q1));
+  path->appendPath ((*sm) (q1, q2));
+  problem->setParameter ("SplineGradientBased/alphaInit",
+                        hpp::core::Parameter (1.));
+  problem->setParameter ("SplineGradientBased/costThreshold",
+                        hpp::core::Parameter (1e-6));
+
+  PathVectorPtr_t optimized[2];
+  for (int i = 0; i < 2; ++i) {
+    problem->setParameter ("SplineGradientBased/sparseQP",
+                           hpp::core::Parameter (i == 1));
+    PathOptimizerPtr_t pathOptimizer
+      (pathOptimization::SplineGradientBased<path::BernsteinBasis, 3>::create
+       (*problem));
+    optimized[i] = pathOptimizer->optimize (path);
+    BOOST_REQUIRE (optimized[i]);
+  }
+  BOOST_REQUIRE_EQUAL (optimized[0]->numberPaths (),
+                       optimized[1]->numberPaths ());
+  for (std::size_t i = 0; i < optimized[0]->numberPaths (); ++i) {
+    BOOST_CHECK ((optimized[0]->pathAtRank (i)->end () -
+                  optimized[1]->pathAtRank (i)->end ()).norm () < 1e-8);
+  }
+  Configuration_t q (robot->configSize ()), r (robot->configSize ());
+  bool success;
+  q = (*optimized[0]) (0.5 * optimized[0]->length (), success);
+  r = (*optimized[1]) (0.5 * optimized[1]->length (), success);
+  BOOST_CHECK ((q - r).norm () < 1e-8);
+}
 BOOST_AUTO_TEST_SUITE_END()
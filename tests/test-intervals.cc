@@ -17,7 +17,7 @@
 // <http://www.gnu.org/licenses/>.
 
 #define BOOST_TEST_MODULE intervals
-#include "continuous-validation/intervals.hh"
+#include <hpp/core/continuous-validation/intervals.hh>
 #include <boost/test/included/unit_test.hpp>
 
 using hpp::core::interval_t;
@@ -26,8 +26,8 @@ using hpp::core::continuousValidation::Intervals;
 bool checkIntervals (const Intervals& intervals)
 {
   if (intervals.list ().empty ()) return true;
-  std::list <interval_t>::const_iterator it = intervals.list ().begin ();
-  std::list <interval_t>::const_iterator it1 = it;
+  Intervals::Intervals_t::const_iterator it = intervals.list ().begin ();
+  Intervals::Intervals_t::const_iterator it1 = it;
 
   while (it1 != intervals.list ().end ()) {
     BOOST_CHECK (it1->first <= it1->second);
@@ -62,7 +62,7 @@ BOOST_AUTO_TEST_CASE (intervals_1)
   checkIntervals (intervals);
 
   BOOST_CHECK (intervals.list ().size () == 4);
-  std::list <interval_t>::const_iterator it = intervals.list ().begin ();
+  Intervals::Intervals_t::const_iterator it = intervals.list ().begin ();
   BOOST_CHECK_EQUAL (it->first, 0);
   BOOST_CHECK_EQUAL (it->second, 1);
   ++it;
@@ -76,6 +76,23 @@ BOOST_AUTO_TEST_CASE (intervals_1)
   BOOST_CHECK_EQUAL (it->second, 7);
 }
 
+BOOST_AUTO_TEST_CASE (intervals_containing)
+{
+  Intervals intervals;
+  intervals.unionInterval (interval_t (0, 1));
+  intervals.unionInterval (interval_t (2, 3));
+
+  interval_t interval (-1, -1);
+  BOOST_CHECK (intervals.containing (2.5, interval));
+  BOOST_CHECK_EQUAL (interval.first, 2);
+  BOOST_CHECK_EQUAL (interval.second, 3);
+
+  interval = interval_t (-1, -1);
+  BOOST_CHECK (!intervals.containing (1.5, interval));
+  BOOST_CHECK_EQUAL (interval.first, -1);
+  BOOST_CHECK_EQUAL (interval.second, -1);
+}
+
 BOOST_AUTO_TEST_CASE (intervals_2)
 {
   Intervals intervals;
@@ -101,7 +118,7 @@ BOOST_AUTO_TEST_CASE (intervals_2)
   checkIntervals (intervals);
 
   BOOST_CHECK (intervals.list ().size () == 4);
-  std::list <interval_t>::const_iterator it = intervals.list ().begin ();
+  Intervals::Intervals_t::const_iterator it = intervals.list ().begin ();
   BOOST_CHECK_EQUAL (it->first, 0);
   BOOST_CHECK_EQUAL (it->second, 1);
   ++it;
@@ -140,7 +157,7 @@ BOOST_AUTO_TEST_CASE (intervals_3)
   checkIntervals (intervals);
 
   BOOST_CHECK (intervals.list ().size () == 4);
-  std::list <interval_t>::const_iterator it = intervals.list ().begin ();
+  Intervals::Intervals_t::const_iterator it = intervals.list ().begin ();
   BOOST_CHECK_EQUAL (it->first, 0);
   BOOST_CHECK_EQUAL (it->second, 1);
   ++it;
@@ -179,7 +196,7 @@ BOOST_AUTO_TEST_CASE (intervals_4)
   checkIntervals (intervals);
 
   BOOST_CHECK (intervals.list ().size () == 4);
-  std::list <interval_t>::const_iterator it = intervals.list ().begin ();
+  Intervals::Intervals_t::const_iterator it = intervals.list ().begin ();
   BOOST_CHECK_EQUAL (it->first, 0);
   BOOST_CHECK_EQUAL (it->second, 1);
   ++it;
@@ -218,7 +235,7 @@ BOOST_AUTO_TEST_CASE (intervals_5)
   checkIntervals (intervals);
 
   BOOST_CHECK (intervals.list ().size () == 2);
-  std::list <interval_t>::const_iterator it = intervals.list ().begin ();
+  Intervals::Intervals_t::const_iterator it = intervals.list ().begin ();
   BOOST_CHECK_EQUAL (it->first, 0);
   BOOST_CHECK_EQUAL (it->second, 1);
   ++it;
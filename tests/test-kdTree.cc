@@ -16,175 +16,343 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with hpp-core.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <sstream>
-#include <ostream>
-#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <vector>
 
-//#include <Eigen/Core>
+#include <boost/bind.hpp>
+#include <boost/next_prior.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <hpp/util/debug.hh>
 
-#include <hpp/model/device.hh>
-
 #include <hpp/pinocchio/device.hh>
-#include <hpp/pinocchio/joint.hh>
-#include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/urdf/util.hh>
 #include <hpp/core/fwd.hh>
+#include <hpp/core/problem.hh>
 #include <hpp/core/roadmap.hh>
 #include <hpp/core/weighed-distance.hh>
-#include "hpp/core/basic-configuration-shooter.hh"
 #include <hpp/core/connected-component.hh>
 #include <hpp/core/node.hh>
 #include <hpp/core/steering-method/straight.hh>
 #include "../src/nearest-neighbor/basic.hh"
 #include "../src/nearest-neighbor/k-d-tree.hh"
-
+#include "../src/nearest-neighbor/concurrent.hh"
 
 #define BOOST_TEST_MODULE kdTree
 #include <boost/test/included/unit_test.hpp>
-#include <pinocchio/multibody/model.hpp>
-#include <pinocchio/multibody/geometry.hpp>
 
-using namespace hpp;
-using namespace core;
-using namespace pinocchio;
-using namespace std;
-using ::pinocchio::JointModelTranslation;
-using ::pinocchio::JointIndex;
-using ::pinocchio::JointModelSpherical;
-using ::pinocchio::JointModelRUBZ;
+using namespace hpp::core;
+using namespace hpp::pinocchio;
 
+using hpp::core::steeringMethod::Straight;
+using hpp::core::steeringMethod::StraightPtr_t;
 
 BOOST_AUTO_TEST_SUITE( test_hpp_core )
 
+DevicePtr_t createRobot ()
+{
+  std::string urdf ("<robot name='test'>"
+      "<link name='link1'/>"
+      "<link name='link2'/>"
+      "<link name='link3'/>"
+      "<joint name='rz' type='continuous'>"
+        "<parent link='link1'/>"
+        "<child  link='link2'/>"
+        "<limit effort='30' velocity='1.0'/>"
+      "</joint>"
+      "<joint name='tz' type='prismatic'>"
+        "<axis xyz='0 0 1'/>"
+        "<parent link='link2'/>"
+        "<child  link='link3'/>"
+        "<limit effort='30' velocity='1.0' lower='-3' upper='3'/>"
+      "</joint>"
+      "</robot>"
+      );
+
+  DevicePtr_t robot = Device::create ("test");
+  urdf::loadModelFromString (robot, 0, "", "planar", urdf, "");
+  return robot;
+}
+
+value_type random (value_type lower, value_type upper)
+{
+  return lower + (upper - lower) * std::rand () / (value_type) RAND_MAX;
+}
+
+ConfigurationPtr_t randomConfiguration (const DevicePtr_t& robot)
+{
+  ConfigurationPtr_t q (new Configuration_t (robot->neutralConfiguration ()));
+  // planar root joint
+  (*q) [0] = random (-3, 3); (*q) [1] = random (-3, 3);
+  value_type theta (random (-M_PI, M_PI));
+  (*q) [2] = std::cos (theta); (*q) [3] = std::sin (theta);
+  // continuous joint
+  theta = random (-M_PI, M_PI);
+  (*q) [4] = std::cos (theta); (*q) [5] = std::sin (theta);
+  // prismatic joint
+  (*q) [6] = random (-3, 3);
+  return q;
+}
+
 BOOST_AUTO_TEST_CASE (kdTree) {
-  // Build Device
- /* DevicePtr_t robot = Device::create("robot");
-  JointPtr_t transJoint = new JointTranslation <3> (Transform3f());
-  transJoint->isBounded (0, true);
-  transJoint->lowerBound(0,-3.);
-  transJoint->upperBound(0, 3.);
-  transJoint->isBounded (1, true);
-  transJoint->lowerBound(1,-3.);
-  transJoint->upperBound(1, 3.);
-  transJoint->isBounded (2, true);
-  transJoint->lowerBound(2,-3.);
-  transJoint->upperBound(2, 3.);
-  JointPtr_t so3Joint = new JointSO3(Transform3f());
-  JointPtr_t so2Joint = new jointRotation::UnBounded
-    (Transform3f (fcl::Vec3f (0, 0, 1)));
-  robot->rootJoint(transJoint);
-  transJoint->addChildJoint (so3Joint);
-  so3Joint->addChildJoint (so2Joint);
-*/
-  DevicePtr_t robot = Device::create("robot");
-  ModelPtr_t m = ModelPtr_t(new Model());
-  GeomModelPtr_t gm = GeomModelPtr_t(new GeomModel());
-  robot->setModel(m);
-  robot->setGeomModel(gm);
-  const std::string& name = robot->name ();
-  Transform3f mat; mat.setIdentity ();
-
-  JointModelTranslation::TangentVector_t max_effort_tr =
-    JointModelTranslation::TangentVector_t::Constant
-    (std::numeric_limits<double>::max());
-  JointModelTranslation::TangentVector_t max_velocity_tr =
-    JointModelTranslation::TangentVector_t::Constant
-    (std::numeric_limits<double>::max());
-  JointModelTranslation::ConfigVector_t lower_position_tr =
-    JointModelTranslation::ConfigVector_t::Constant(-3.);
-  JointModelTranslation::ConfigVector_t upper_position_tr =
-    JointModelTranslation::ConfigVector_t::Constant(3.);
-
-  JointModelSpherical::TangentVector_t max_effort_SO3 =
-    JointModelSpherical::TangentVector_t::Constant
-    (std::numeric_limits<double>::max());
-  JointModelSpherical::TangentVector_t max_velocity_SO3 =
-    JointModelSpherical::TangentVector_t::Constant
-    (std::numeric_limits<double>::max());
-  JointModelSpherical::ConfigVector_t lower_position_SO3 =
-    JointModelSpherical::ConfigVector_t::Constant(-1.01);
-  JointModelSpherical::ConfigVector_t upper_position_SO3 =
-    JointModelSpherical::ConfigVector_t::Constant(1.01);
-
-  JointModelRUBZ::TangentVector_t max_effort_SO2 =
-    JointModelRUBZ::TangentVector_t::Constant
-    (std::numeric_limits<double>::max());
-  JointModelRUBZ::TangentVector_t max_velocity_SO2 =
-    JointModelRUBZ::TangentVector_t::Constant
-    (std::numeric_limits<double>::max());
-  JointModelRUBZ::ConfigVector_t lower_position_SO2 =
-    JointModelRUBZ::ConfigVector_t::Constant(-1.01);
-  JointModelRUBZ::ConfigVector_t upper_position_SO2 =
-    JointModelRUBZ::ConfigVector_t::Constant(1.01);
-
-  JointIndex idJoint = 0;
-  idJoint = robot->model().addJoint(idJoint,JointModelTranslation(),
-				    mat,name + "_xyz",max_effort_tr,
-				    max_velocity_tr,lower_position_tr,
-				    upper_position_tr);
-  idJoint = robot->model().addJoint(idJoint,JointModelSpherical(),mat,
-				    name + "_SO3",max_effort_SO3,
-				    max_velocity_SO3,lower_position_SO3,
-				    upper_position_SO3);
-  idJoint = robot->model().addJoint(idJoint,JointModelRUBZ(),mat,
-				    name + "_SO2",max_effort_SO2,
-				    max_velocity_SO2,lower_position_SO2,
-				    upper_position_SO2);
-
-  robot->createData();
-  robot->createGeomData();
-
-
-  // Build Distance, nearestNeighbor, KDTree
-  ProblemPtr_t problem = Problem::create(robot);
-  WeighedDistancePtr_t distance = WeighedDistance::create(robot);
-  problem->distance (distance);
-  ConfigurationShooterPtr_t confShoot = problem->configurationShooter();
-  nearestNeighbor::KDTree kdTree(robot,distance,30);
-  nearestNeighbor::Basic basic (distance);
-  SteeringMethodPtr_t sm = steeringMethod::Straight::create (problem);
+  std::srand (0);
+  DevicePtr_t robot = createRobot ();
+  BOOST_REQUIRE_EQUAL (robot->configSize (), 7);
+
+  ProblemPtr_t problem = Problem::create (robot);
+  StraightPtr_t sm = Straight::create (*problem);
+  WeighedDistancePtr_t distance = WeighedDistance::createWithWeight
+    (robot, vector_t::Ones (robot->model ().njoints - 1));
 
-  // Add 4 connectedComponents with 2000 nodes each
-  ConfigurationPtr_t configuration;
-  NodePtr_t node;
-  NodePtr_t rootNode [4];
   RoadmapPtr_t roadmap = Roadmap::create (distance, robot);
-  roadmap->nearestNeighbor(&kdTree);
-  for ( int i=0 ; i<4 ; i++ ) {
-    configuration = confShoot->shoot();
-    rootNode [i] = roadmap->addNode (configuration);
-    for (int j=1 ; j<200 ; j++) {
-      configuration = confShoot->shoot();
-      PathPtr_t path = (*sm) (*(rootNode [i]->configuration ()),
-			      *configuration);
-      node = roadmap->addNodeAndEdges (rootNode [i], configuration, path);
-      basic.addNode (node);
+  nearestNeighbor::KDTree* kdTree
+    (new nearestNeighbor::KDTree (robot, distance, 8));
+  roadmap->nearestNeighbor (kdTree);
+  nearestNeighbor::Basic basic (distance);
+
+  // Build 4 connected components of 200 nodes each
+  const int nCC = 4;
+  NodePtr_t rootNode [nCC];
+  for (int i = 0; i < nCC; ++i) {
+    rootNode [i] = roadmap->addNode (randomConfiguration (robot));
+    for (int j = 1; j < 200; ++j) {
+      ConfigurationPtr_t q (randomConfiguration (robot));
+      PathPtr_t path = (*sm) (*(rootNode [i]->configuration ()), *q);
+      roadmap->addNodeAndEdges (rootNode [i], q, path);
     }
   }
+  BOOST_CHECK_EQUAL (kdTree->size (), 4 * 200);
+
+  for (int j = 0; j < 100; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    for (int i = 0; i < nCC; ++i) {
+      ConnectedComponentPtr_t cc (rootNode [i]->connectedComponent ());
+      value_type d1, d2;
+      NodePtr_t n1 = basic.search (*q, cc, d1);
+      NodePtr_t n2 = kdTree->search (*q, cc, d2);
+      BOOST_CHECK_EQUAL (n1, n2);
+      BOOST_CHECK_CLOSE (d1, d2, 1e-10);
+
+      Nodes_t k1 = basic.KnearestSearch (*q, cc, 10, d1);
+      Nodes_t k2 = kdTree->KnearestSearch (*q, cc, 10, d2);
+      BOOST_CHECK_EQUAL (k1.size (), 10);
+      BOOST_CHECK_EQUAL_COLLECTIONS (k1.begin (), k1.end (),
+                                     k2.begin (), k2.end ());
+      BOOST_CHECK_CLOSE (d1, d2, 1e-10);
+    }
+    value_type d1, d2;
+    Nodes_t k1 = basic.KnearestSearch (*q, roadmap, 5, d1);
+    Nodes_t k2 = kdTree->KnearestSearch (*q, roadmap, 5, d2);
+    BOOST_CHECK_EQUAL_COLLECTIONS (k1.begin (), k1.end (),
+                                   k2.begin (), k2.end ());
+  }
+
+  // Batch search
+  matrix_t queries (robot->configSize (), 50);
+  for (size_type j = 0; j < queries.cols (); ++j)
+    queries.col (j) = *randomConfiguration (robot);
+  vector_t distances1, distances2;
+  std::vector <Nodes_t> batch1 = basic.KnearestSearch (queries, roadmap, 7,
+                                                       distances1);
+  std::vector <Nodes_t> batch2 = kdTree->KnearestSearch (queries, roadmap, 7,
+                                                         distances2);
+  BOOST_REQUIRE_EQUAL (batch1.size (), 50);
+  BOOST_REQUIRE_EQUAL (batch2.size (), 50);
+  for (std::size_t j = 0; j < batch1.size (); ++j) {
+    value_type d;
+    Nodes_t k = basic.KnearestSearch (Configuration_t (queries.col (j)),
+                                      roadmap, 7, d);
+    BOOST_CHECK_EQUAL_COLLECTIONS (k.begin (), k.end (),
+                                   batch1 [j].begin (), batch1 [j].end ());
+    BOOST_CHECK_EQUAL_COLLECTIONS (k.begin (), k.end (),
+                                   batch2 [j].begin (), batch2 [j].end ());
+    BOOST_CHECK_CLOSE (d, distances1 [j], 1e-10);
+    BOOST_CHECK_CLOSE (d, distances2 [j], 1e-10);
+  }
+
+  // Merge connected components 0 and 1
+  PathPtr_t path = (*sm) (*(rootNode [0]->configuration ()),
+                          *(rootNode [1]->configuration ()));
+  roadmap->addEdges (rootNode [0], rootNode [1], path);
+  BOOST_CHECK_EQUAL (rootNode [0]->connectedComponent (),
+                     rootNode [1]->connectedComponent ());
+  BOOST_CHECK_EQUAL (roadmap->connectedComponents ().size (), 3);
+
+  for (int j = 0; j < 100; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    for (int i = 1; i < nCC; ++i) {
+      ConnectedComponentPtr_t cc (rootNode [i]->connectedComponent ());
+      value_type d1, d2;
+      NodePtr_t n1 = basic.search (*q, cc, d1);
+      NodePtr_t n2 = kdTree->search (*q, cc, d2);
+      BOOST_CHECK_EQUAL (n1, n2);
+      BOOST_CHECK_CLOSE (d1, d2, 1e-10);
+    }
+  }
+
+  // Nearest node in each connected component
+  for (int j = 0; j < 100; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    const ConnectedComponents_t& ccs (roadmap->connectedComponents ());
+    vector_t distances;
+    NodeVector_t nodes (kdTree->searchInConnectedComponents (*q, ccs,
+                                                             distances));
+    BOOST_REQUIRE_EQUAL (nodes.size (), ccs.size ());
+    std::size_t i = 0;
+    for (ConnectedComponents_t::const_iterator itcc (ccs.begin ());
+         itcc != ccs.end (); ++itcc, ++i) {
+      value_type d;
+      NodePtr_t n = basic.search (*q, *itcc, d);
+      BOOST_CHECK_EQUAL (n, nodes [i]);
+      BOOST_CHECK_CLOSE (d, distances [i], 1e-10);
+    }
+  }
+
+  // Radius search
+  for (int j = 0; j < 100; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    ConnectedComponentPtr_t cc (rootNode [j % nCC]->connectedComponent ());
+    value_type radius;
+    Nodes_t k = basic.KnearestSearch (*q, cc, 20, radius);
+    NodeVector_t b1 = basic.withinBall (*q, cc, radius);
+    NodeVector_t b2 = kdTree->withinBall (*q, cc, radius);
+    std::sort (b1.begin (), b1.end ());
+    std::sort (b2.begin (), b2.end ());
+    BOOST_CHECK_EQUAL_COLLECTIONS (b1.begin (), b1.end (),
+                                   b2.begin (), b2.end ());
+    NodeVector_t capped = kdTree->withinBall (*q, cc, radius, 5);
+    BOOST_CHECK_EQUAL_COLLECTIONS (capped.begin (), capped.end (),
+                                   k.begin (), boost::next (k.begin (), 5));
+  }
 
-  // search nearest node
-  value_type minDistance1;
-  value_type minDistance2;
-  NodePtr_t node1;
-  NodePtr_t node2;
-  for ( int j=0 ; j<200 ; j++ ) {
-    configuration = confShoot->shoot();
-    for ( int i=0 ; i<4 ; i++ ) {
-      minDistance1 = std::numeric_limits<value_type>::infinity ();
-      minDistance2 = std::numeric_limits<value_type>::infinity ();
-      node1 = basic.search (configuration, rootNode [i]->connectedComponent (),
-			    minDistance1);
-      node2 = roadmap->nearestNode (configuration,
-				    rootNode [i]->connectedComponent (),
-				    minDistance2);
-      BOOST_CHECK( node1 == node2 );
-      BOOST_CHECK( fabs (minDistance1 - minDistance2) < 1e-15 );
-      std::cout << displayConfig (*(node1->configuration ())) << std::endl;
-      std::cout << minDistance1 << "," << minDistance2 << ","
-		<< minDistance1 - minDistance2 << std::endl;
+  // Approximate search
+  kdTree->approximationFactor (1.5);
+  BOOST_CHECK_THROW (kdTree->approximationFactor (.5), std::invalid_argument);
+  for (int j = 0; j < 100; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    for (int i = 1; i < nCC; ++i) {
+      ConnectedComponentPtr_t cc (rootNode [i]->connectedComponent ());
+      value_type d1, d2;
+      basic.search (*q, cc, d1);
+      NodePtr_t n2 = kdTree->search (*q, cc, d2);
+      BOOST_CHECK_EQUAL (n2->connectedComponent (), cc);
+      BOOST_CHECK (d1 <= d2);
+      BOOST_CHECK (d2 <= 1.5 * d1 + 1e-10);
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE (kdTreeBalance) {
+  std::srand (2);
+  DevicePtr_t robot = createRobot ();
+  ProblemPtr_t problem = Problem::create (robot);
+  StraightPtr_t sm = Straight::create (*problem);
+  WeighedDistancePtr_t distance = WeighedDistance::createWithWeight
+    (robot, vector_t::Ones (robot->model ().njoints - 1));
+
+  RoadmapPtr_t roadmap = Roadmap::create (distance, robot);
+  nearestNeighbor::KDTree* kdTree
+    (new nearestNeighbor::KDTree (robot, distance, 4));
+  roadmap->nearestNeighbor (kdTree);
+  nearestNeighbor::Basic basic (distance);
+
+  // Grow the roadmap in one direction, as in a narrow passage.
+  NodePtr_t root = roadmap->addNode (randomConfiguration (robot));
+  for (int j = 1; j < 2000; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    (*q) [0] = -3 + 1e-3 * j; (*q) [1] = 1e-3 * (value_type) j * j;
+    PathPtr_t path = (*sm) (*(root->configuration ()), *q);
+    roadmap->addNodeAndEdges (root, q, path);
+  }
+  BOOST_CHECK_EQUAL (kdTree->size (), 2000);
+  // A balanced tree with leaves of at most 4 points has about 10 levels.
+  BOOST_CHECK_MESSAGE (kdTree->depth () < 30, "depth: " << kdTree->depth ());
+
+  for (int j = 0; j < 100; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    value_type d1, d2;
+    NodePtr_t n1 = basic.search (*q, root->connectedComponent (), d1);
+    NodePtr_t n2 = kdTree->search (*q, root->connectedComponent (), d2);
+    BOOST_CHECK_EQUAL (n1, n2);
+    BOOST_CHECK_CLOSE (d1, d2, 1e-10);
+  }
+}
+
+void searchInConnectedComponent (NearestNeighborPtr_t nn,
+                                 std::vector <ConfigurationPtr_t> queries,
+                                 ConnectedComponentPtr_t cc, bool* success)
+{
+  *success = true;
+  for (std::size_t i = 0; i < queries.size (); ++i) {
+    value_type d;
+    NodePtr_t n = nn->search (*queries [i], cc, d);
+    if (!n || n->connectedComponent () != cc) *success = false;
+  }
+}
+
+BOOST_AUTO_TEST_CASE (concurrentSearch) {
+  std::srand (3);
+  DevicePtr_t robot = createRobot ();
+  ProblemPtr_t problem = Problem::create (robot);
+  StraightPtr_t sm = Straight::create (*problem);
+  WeighedDistancePtr_t distance = WeighedDistance::createWithWeight
+    (robot, vector_t::Ones (robot->model ().njoints - 1));
+
+  RoadmapPtr_t roadmap = Roadmap::create (distance, robot);
+  NearestNeighborPtr_t nn (nearestNeighbor::createConcurrent
+                           (nearestNeighbor::createKDTree (robot, distance, 8)));
+  roadmap->nearestNeighbor (nn);
+
+  NodePtr_t root = roadmap->addNode (randomConfiguration (robot));
+  for (int j = 1; j < 500; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    roadmap->addNodeAndEdges (root, q, (*sm) (*root->configuration (), *q));
+  }
+  NodePtr_t other = roadmap->addNode (randomConfiguration (robot));
+
+  const std::size_t nThreads = 4;
+  bool success [nThreads];
+  boost::thread_group threads;
+  for (std::size_t i = 0; i < nThreads; ++i) {
+    std::vector <ConfigurationPtr_t> queries;
+    for (int j = 0; j < 500; ++j)
+      queries.push_back (randomConfiguration (robot));
+    threads.create_thread (boost::bind (&searchInConnectedComponent, nn,
+                                        queries, root->connectedComponent (),
+                                        &success [i]));
+  }
+  // Insert in another connected component while searching
+  for (int j = 0; j < 500; ++j) {
+    ConfigurationPtr_t q (randomConfiguration (robot));
+    value_type d;
+    nn->search (*q, other->connectedComponent (), d);
+    roadmap->addNodeAndEdges (other, q, (*sm) (*other->configuration (), *q));
+  }
+  threads.join_all ();
+  for (std::size_t i = 0; i < nThreads; ++i)
+    BOOST_CHECK (success [i]);
+}
+
+BOOST_AUTO_TEST_CASE (weighedDistance) {
+  std::srand (1);
+  DevicePtr_t robot = createRobot ();
+  vector_t weights (3); weights << 1, 2, 3;
+  WeighedDistancePtr_t distance = WeighedDistance::createWithWeight
+    (robot, weights);
+
+  ConfigurationPtr_t q (randomConfiguration (robot));
+  matrix_t configurations (robot->configSize (), 20);
+  for (size_type j = 0; j < configurations.cols (); ++j)
+    configurations.col (j) = *randomConfiguration (robot);
+
+  vector_t distances;
+  distance->compute (configurations, *q, distances);
+  BOOST_REQUIRE_EQUAL (distances.size (), 20);
+  for (size_type j = 0; j < configurations.cols (); ++j) {
+    const Configuration_t q1 (configurations.col (j));
+    BOOST_CHECK_CLOSE ((*distance) (q1, *q), distances [j], 1e-10);
+  }
+}
 BOOST_AUTO_TEST_SUITE_END()
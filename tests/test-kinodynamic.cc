@@ -659,4 +659,48 @@ BOOST_AUTO_TEST_CASE (kinodynamicOriented) {
   }
 }
 
+BOOST_AUTO_TEST_CASE (kinodynamicDistances) {
+  DevicePtr_t robot = unittest::makeDevice(unittest::HumanoidSimple);
+  robot->rootJoint()->lowerBound (0, -10);
+  robot->rootJoint()->lowerBound (1, -10);
+  robot->rootJoint()->lowerBound (2, -1);
+  robot->rootJoint()->upperBound (0,  10);
+  robot->rootJoint()->upperBound (1,  10);
+  robot->rootJoint()->upperBound (2,  1);
+  robot->setDimensionExtraConfigSpace(6);
+  const double vMax = 2;
+  const double aMax = 0.5;
+  for(size_type i = 0 ; i < 3 ; i++){
+    robot->extraConfigSpace ().lower(i) = -vMax;
+    robot->extraConfigSpace ().upper(i) = vMax;
+    robot->extraConfigSpace ().lower(i+3) = -aMax;
+    robot->extraConfigSpace ().upper(i+3) = aMax;
+  }
+  ProblemPtr_t p = Problem::create(robot);
+  p->setParameter(std::string("Kinodynamic/velocityBound"),Parameter(vMax));
+  p->setParameter(std::string("Kinodynamic/accelerationBound"),Parameter(aMax));
+  KinodynamicDistancePtr_t dist = KinodynamicDistance::createFromProblem(*p);
+  DistancePtr_t copy = dist->clone();
+
+  ConfigurationShooterPtr_t shooter = configurationShooter::Uniform::create(robot);
+  matrix_t configs (robot->configSize(), 50);
+  for(size_type i = 0 ; i < configs.cols() ; i++)
+    configs.col(i) = *shooter->shoot();
+  // identical configurations
+  configs.col(1) = configs.col(0);
+  Configuration_t q (configs.col(0));
+
+  vector_t distances, copyDistances;
+  dist->compute(configs, q, distances);
+  copy->compute(configs, q, copyDistances);
+  BOOST_REQUIRE_EQUAL(distances.size(), configs.cols());
+  BOOST_CHECK_EQUAL(distances[0], 0.);
+  BOOST_CHECK_EQUAL(distances[1], 0.);
+  for(size_type i = 0 ; i < configs.cols() ; i++){
+    BOOST_CHECK_CLOSE(distances[i], (*dist)(configs.col(i), q), 1e-9);
+    BOOST_CHECK_EQUAL(distances[i], copyDistances[i]);
+    BOOST_CHECK(dist->lowerBound(configs.col(i), q) <= distances[i] + 1e-9);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
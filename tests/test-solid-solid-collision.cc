@@ -31,6 +31,8 @@
 #include <pinocchio/multibody/geometry.hpp>
 
 #include <hpp/core/continuous-validation/solid-solid-collision.hh>
+#include <hpp/core/continuous-validation/velocity-bounds.hh>
+#include <hpp/core/straight-path.hh>
 
 using std::numeric_limits;
 using hpp::pinocchio::BodyPtr_t;
@@ -44,6 +46,7 @@ using hpp::pinocchio::ObjectVector_t;
 using hpp::core::continuousValidation::SolidSolidCollision;
 using hpp::core::continuousValidation::SolidSolidCollisionPtr_t;
 using hpp::core::continuousValidation::CoefficientVelocities_t;
+using hpp::core::continuousValidation::VelocityBounds;
 
 using namespace hpp::core;
 using namespace hpp::pinocchio;
@@ -104,4 +107,49 @@ BOOST_AUTO_TEST_CASE (solid_solid_collision_1)
   display(model, bpc->coefficients());
 }
 
+BOOST_AUTO_TEST_CASE (velocity_bounds)
+{
+  DevicePtr_t robot = createRobot();
+  JointPtr_t joint_a = robot->getJointByBodyName ("lleg5_body");
+  JointPtr_t joint_b = robot->getJointByBodyName ("rleg5_body");
+  SolidSolidCollisionPtr_t bpc = SolidSolidCollision::create
+    (joint_a, joint_b, 0.001);
+
+  Configuration_t q1 (robot->neutralConfiguration ()),
+    q2 (robot->neutralConfiguration ());
+  q2 [0] = 1;
+  PathPtr_t path (StraightPath::create (robot, q1, q2, 2));
+
+  VelocityBounds bounds;
+  bounds.path (path);
+  BOOST_CHECK_EQUAL (bounds.numberPieces (), 0);
+  vector_t Vb (bounds.bound (0));
+  const value_type V (bpc->computeMaximalVelocity (Vb));
+  BOOST_CHECK_CLOSE (bpc->computeMaximalVelocity (bounds, 0), V, 1e-8);
+  BOOST_CHECK_CLOSE (bounds.jointNorm (joint_a, 0),
+                     Vb.segment (joint_a->rankInVelocity (),
+                                 joint_a->numberDof ()).norm (), 1e-8);
+
+  // The bounds of the pieces are below the bound of the whole path.
+  bounds.setupPieces ();
+  BOOST_REQUIRE (bounds.numberPieces () > 0);
+  BOOST_CHECK_EQUAL (bounds.pieceBounds ().front (), 0);
+  BOOST_CHECK_EQUAL (bounds.pieceBounds ().back (), 2);
+  for (std::size_t i = 1; i <= bounds.numberPieces (); ++i)
+    BOOST_CHECK (bpc->computeMaximalVelocity (bounds, i) <= V + 1e-8);
+  // Norms of the whole path are kept.
+  BOOST_CHECK_CLOSE (bpc->computeMaximalVelocity (bounds, 0), V, 1e-8);
+
+  // The norms of all the joints computed at once are the same.
+  VelocityBounds shared (robot);
+  shared.path (path);
+  shared.setupPieces ();
+  for (std::size_t i = 0; i <= bounds.numberPieces (); ++i) {
+    BOOST_CHECK_CLOSE (shared.jointNorm (joint_b, i),
+                       bounds.jointNorm (joint_b, i), 1e-8);
+    BOOST_CHECK_CLOSE (bpc->computeMaximalVelocity (shared, i),
+                       bpc->computeMaximalVelocity (bounds, i), 1e-8);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
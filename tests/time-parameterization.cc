@@ -18,9 +18,17 @@
 #include <pinocchio/fwd.hpp>
 #include <boost/test/included/unit_test.hpp>
 
+#include <hpp/core/time-parameterization/piecewise-polynomial.hh>
 #include <hpp/core/time-parameterization/polynomial.hh>
+#include <hpp/core/path-optimization/toppra.hh>
+#include <hpp/core/path-sampler.hh>
+#include <hpp/core/path-vector.hh>
+#include <hpp/core/problem.hh>
+
+#include <pinocchio/multibody/model.hpp>
 
 #include <hpp/pinocchio/simple-device.hh>
+#include <hpp/pinocchio/urdf/util.hh>
 
 using namespace hpp::core;
 using namespace hpp::pinocchio;
@@ -125,3 +133,171 @@ BOOST_AUTO_TEST_CASE (degree5integration)
 }
 
 BOOST_AUTO_TEST_SUITE_END ()
+
+BOOST_AUTO_TEST_SUITE (piecewisePolynomial)
+
+BOOST_AUTO_TEST_CASE (quadratic)
+{
+  // s(t) = t^2 on [0, 1], s(t) = 1 + 2 (t - 1) on [1, 2]
+  matrix_t a (3, 2);
+  a << 0, 1,
+       0, 2,
+       1, 0;
+  vector_t t (3);
+  t << 0, 1, 2;
+  timeParameterization::PiecewisePolynomial P (a, t);
+
+  BOOST_CHECK_EQUAL(P.value( 0  ), 0);
+  BOOST_CHECK_EQUAL(P.value( 0.5), 0.25);
+  BOOST_CHECK_EQUAL(P.value( 1  ), 1);
+  BOOST_CHECK_EQUAL(P.value( 2  ), 3);
+
+  BOOST_CHECK_EQUAL(P.derivative(0.5, 1), 1);
+  BOOST_CHECK_EQUAL(P.derivative(1.5, 1), 2);
+  BOOST_CHECK_EQUAL(P.derivative(0.5, 2), 2);
+  BOOST_CHECK_EQUAL(P.derivative(1.5, 2), 0);
+
+  BOOST_CHECK_EQUAL(P.derivativeBound(0  , 0.5), 1);
+  BOOST_CHECK_EQUAL(P.derivativeBound(0.5, 2  ), 2);
+}
+
+BOOST_AUTO_TEST_CASE (cubic)
+{
+  // Two copies of the polynomial of test cubic2, on [0, 1] and [1, 2].
+  vector_t c (vector_t::Ones(4));
+  c[3] = -1;
+  matrix_t a (4, 2);
+  a.col(0) = c;
+  a.col(1) = c;
+  vector_t t (3);
+  t << 0, 1, 2;
+  timeParameterization::PiecewisePolynomial P (a, t);
+  timeParameterization::Polynomial Q (c);
+
+  for (int i = 0; i <= 10; ++i) {
+    const value_type dt = 0.1 * i;
+    BOOST_CHECK_CLOSE(P.value(dt    ), Q.value(dt), 1e-10);
+    BOOST_CHECK_CLOSE(P.value(dt + 1), Q.value(dt), 1e-10);
+    BOOST_CHECK_CLOSE(P.derivative(dt + 1, 1), Q.derivative(dt, 1), 1e-10);
+  }
+  BOOST_CHECK_EQUAL(P.derivativeBound(0  , 1  ), Q.derivativeBound(0, 1));
+  BOOST_CHECK_EQUAL(P.derivativeBound(0.5, 1.5), Q.derivativeBound(0, 1));
+  BOOST_CHECK_EQUAL(P.derivativeBound(1  , 1.2), Q.derivativeBound(0, 0.2));
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+BOOST_AUTO_TEST_SUITE (toppra)
+
+// Parameterize a straight path of a box moving in the plane and check that
+// the velocity limits are satisfied, and that a tighter acceleration limit
+// makes the motion slower.
+BOOST_AUTO_TEST_CASE (straightPath)
+{
+  std::string urdf ("<robot name='box'>"
+      "<link name='body'>"
+        "<collision>"
+          "<geometry>"
+            "<box size='1 1 1'/>"
+          "</geometry>"
+        "</collision>"
+      "</link>"
+      "</robot>"
+      );
+  DevicePtr_t robot = Device::create ("box");
+  urdf::loadModelFromString (robot, 0, "", "planar", urdf, "");
+  robot->model().velocityLimit.setOnes();
+  ProblemPtr_t problem = Problem::create(robot);
+
+  Configuration_t q0 (robot->neutralConfiguration ()),
+                  q1 (robot->neutralConfiguration ());
+  q1.head<2> ().setConstant (1);
+  PathVectorPtr_t path = PathVector::create (robot->configSize (),
+                                             robot->numberDof ());
+  path->appendPath ((*problem->steeringMethod ()) (q0, q1));
+
+  value_type T[2];
+  const value_type maxAcc[2] = { 2., 0.5 };
+  for (int k = 0; k < 2; ++k) {
+    problem->setParameter ("TOPPRA/maxAcceleration", Parameter (maxAcc[k]));
+    PathVectorPtr_t result = pathOptimization::TOPPRA::create (*problem)
+      ->optimize (path);
+    BOOST_REQUIRE (result);
+    T[k] = result->length ();
+    BOOST_CHECK (result->initial ().isApprox (q0));
+    BOOST_CHECK (result->end ().isApprox (q1));
+
+    vector_t v (robot->numberDof ());
+    for (int i = 0; i <= 100; ++i) {
+      result->derivative (v, T[k] * i / 100, 1);
+      BOOST_CHECK (v.cwiseAbs ().maxCoeff () <= 1 + 1e-6);
+    }
+    // The joints are at most at velocity 1 on a distance of 1.
+    BOOST_CHECK (T[k] > 1);
+  }
+  BOOST_CHECK (T[1] > T[0]);
+}
+
+// Sample a parameterized path with a PathSampler, forward and backward, and
+// compare with the evaluation of the path.
+BOOST_AUTO_TEST_CASE (sampler)
+{
+  std::string urdf ("<robot name='box'>"
+      "<link name='body'>"
+        "<collision>"
+          "<geometry>"
+            "<box size='1 1 1'/>"
+          "</geometry>"
+        "</collision>"
+      "</link>"
+      "</robot>"
+      );
+  DevicePtr_t robot = Device::create ("box");
+  urdf::loadModelFromString (robot, 0, "", "planar", urdf, "");
+  robot->model().velocityLimit.setOnes();
+  ProblemPtr_t problem = Problem::create(robot);
+
+  Configuration_t q0 (robot->neutralConfiguration ()),
+                  q1 (robot->neutralConfiguration ()),
+                  q2 (robot->neutralConfiguration ());
+  q1.head<2> ().setConstant (1);
+  q2 [0] = 2;
+  PathVectorPtr_t path = PathVector::create (robot->configSize (),
+                                             robot->numberDof ());
+  path->appendPath ((*problem->steeringMethod ()) (q0, q1));
+  path->appendPath ((*problem->steeringMethod ()) (q1, q2));
+  PathVectorPtr_t result = pathOptimization::TOPPRA::create (*problem)
+    ->optimize (path);
+  BOOST_REQUIRE (result);
+
+  PathSampler sampler (result);
+  BOOST_CHECK (sampler.numberKnots () >= 2);
+  BOOST_CHECK_EQUAL (sampler.timeRange ().first, result->timeRange ().first);
+  BOOST_CHECK_EQUAL (sampler.timeRange ().second,
+                     result->timeRange ().second);
+
+  const value_type T (result->length ());
+  Configuration_t q (robot->configSize ()), expected (robot->configSize ());
+  vector_t v (robot->numberDof ()), expectedV (robot->numberDof ());
+  for (int i = 0; i <= 100; ++i) {
+    const value_type t (T * i / 100);
+    BOOST_CHECK (sampler (t, q));
+    BOOST_CHECK (result->eval (expected, t));
+    BOOST_CHECK (q.isApprox (expected, 1e-8));
+    sampler.velocity (t, v);
+    result->derivative (expectedV, t, 1);
+    BOOST_CHECK (v.isApprox (expectedV, 1e-6) ||
+                 (v - expectedV).norm () < 1e-8);
+  }
+  for (int i = 100; i >= 0; i -= 7) {
+    const value_type t (T * i / 100);
+    BOOST_CHECK (sampler (t, q));
+    BOOST_CHECK (result->eval (expected, t));
+    BOOST_CHECK (q.isApprox (expected, 1e-8));
+  }
+  // Times outside of the time range are clamped.
+  BOOST_CHECK (sampler (T + 1, q));
+  BOOST_CHECK (q.isApprox (q2, 1e-8));
+}
+
+BOOST_AUTO_TEST_SUITE_END ()